@@ -1,23 +1,24 @@
 use num_cpus;
 use polars::prelude::*;
 use polars_readstat_rs::{
-    read_sas7bcat, readstat_batch_iter, readstat_metadata_json, readstat_scan, readstat_schema,
+    clear_metadata_cache, read_sas7bcat, readstat_batch_iter, readstat_metadata_json, readstat_scan, readstat_schema,
+    readstat_sink_ipc, readstat_sink_parquet, TranscodeOptions,
     sas_metadata_json_from_meta, spss_metadata_json_from_meta, stata_metadata_json_from_meta,
     CatalogKey, InformativeNullColumns, InformativeNullMode, InformativeNullOpts, PorWriteOptions,
-    Sas7bdatReader, SasHeader, SasMetadata, SasWriter, ScanOptions, SpssAlignment, SpssHeader,
+    Sas7bdatReader, SasHeader, SasMetadata, SasPageIndex, SasWriter, ScanOptions, SpssAlignment, SpssHeader,
     SpssMeasure, SpssMetadata, SpssReader,
     SpssValueLabelKey, SpssValueLabelMap, SpssValueLabels,
     SpssVariableAlignments, SpssVariableDisplayWidths, SpssVariableFormat, SpssVariableFormats,
     SpssVariableMeasures, SpssWriteColumn, SpssWriteSchema, SpssWriter,
     StataHeader, StataMetadata, StataReader, StataWriteColumn, StataWriteSchema, StataWriter,
-    PorMetadata, ValueLabels, XptMetadata,
+    PorMetadata, ReadProfiler, RowFilter, ValueLabels, XptMetadata,
     XptWriter,
 };
 use pyo3::exceptions::{PyRuntimeError, PyValueError};
 use pyo3::prelude::*;
 use pyo3::types::{PyDict, PyList};
 use pyo3::wrap_pyfunction;
-use pyo3_polars::{PyDataFrame, PyLazyFrame, PySchema};
+use pyo3_polars::{PyDataFrame, PyExpr, PyLazyFrame, PySchema};
 use std::cmp::min;
 use std::collections::{BTreeMap, HashMap, HashSet};
 use std::num::NonZeroUsize;
@@ -89,35 +90,33 @@ impl MetadataInner {
 fn build_metadata_inner(path: &str, format: ReadstatFormat) -> PyResult<MetadataInner> {
     match format {
         ReadstatFormat::Spss => {
-            let reader =
-                SpssReader::open(path).map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let reader = SpssReader::open_cached(path)
+                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
             Ok(MetadataInner::Spss {
                 meta: Arc::new(reader.metadata().clone()),
                 hdr: Arc::new(reader.header().clone()),
             })
         }
         ReadstatFormat::Stata => {
-            let reader =
-                StataReader::open(path).map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let reader = StataReader::open_cached(path)
+                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
             Ok(MetadataInner::Stata {
                 meta: Arc::new(reader.metadata().clone()),
                 hdr: Arc::new(reader.header().clone()),
             })
         }
         ReadstatFormat::Sas => {
-            let reader =
-                Sas7bdatReader::open(path).map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let reader = Sas7bdatReader::open_cached(path)
+                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
             Ok(MetadataInner::Sas {
                 meta: Arc::new(reader.metadata().clone()),
                 hdr: Arc::new(reader.header().clone()),
             })
         }
         ReadstatFormat::SasXpt => {
-            let meta = polars_readstat_rs::read_xpt_metadata(Path::new(path))
+            let meta = polars_readstat_rs::read_xpt_metadata_cached(Path::new(path))
                 .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
-            Ok(MetadataInner::Xpt {
-                meta: Arc::new(meta),
-            })
+            Ok(MetadataInner::Xpt { meta })
         }
         ReadstatFormat::Por => {
             let meta = polars_readstat_rs::metadata_por(path)
@@ -266,8 +265,8 @@ fn read_df_with_options(
     let format = detect_format(path)?;
     let df = match format {
         ReadstatFormat::Sas => {
-            let reader =
-                Sas7bdatReader::open(path).map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let reader = Sas7bdatReader::open_cached(path)
+                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
             let mut builder = reader
                 .read()
                 .missing_string_as_null(missing_string_as_null)
@@ -312,8 +311,8 @@ fn read_df_with_options(
             out.unwrap_or_else(DataFrame::empty)
         }
         ReadstatFormat::Stata => {
-            let reader =
-                StataReader::open(path).map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let reader = StataReader::open_cached(path)
+                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
             let mut builder = reader
                 .read()
                 .missing_string_as_null(missing_string_as_null)
@@ -333,8 +332,8 @@ fn read_df_with_options(
                 .map_err(|e| PyRuntimeError::new_err(e.to_string()))?
         }
         ReadstatFormat::Spss => {
-            let reader =
-                SpssReader::open(path).map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let reader = SpssReader::open_cached(path)
+                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
             let mut builder = reader
                 .read()
                 .missing_string_as_null(missing_string_as_null)
@@ -354,18 +353,29 @@ fn read_df_with_options(
                 .map_err(|e| PyRuntimeError::new_err(e.to_string()))?
         }
         ReadstatFormat::Por => {
-            let (_, df) = polars_readstat_rs::read_por(path)
-                .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
-            let mut df = if let Some(cols) = columns {
-                df.select(cols)
-                    .map_err(|e| PyRuntimeError::new_err(e.to_string()))?
-            } else {
-                df
-            };
-            if let Some(limit) = n_rows {
-                df = df.head(Some(limit));
+            let iter = readstat_batch_iter(
+                path,
+                Some(ScanOptions {
+                    missing_string_as_null: Some(missing_string_as_null),
+                    ..Default::default()
+                }),
+                Some(polars_readstat_rs::ReadStatFormat::Por),
+                columns,
+                n_rows,
+                None,
+            )
+            .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+            let mut out: Option<DataFrame> = None;
+            for batch in iter {
+                let df = batch.map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+                if let Some(acc) = out.as_mut() {
+                    acc.vstack_mut(&df)
+                        .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+                } else {
+                    out = Some(df);
+                }
             }
-            df
+            out.unwrap_or_else(DataFrame::empty)
         }
     };
     Ok(df)
@@ -467,10 +477,14 @@ fn read_sas7bcat_rs(py: Python<'_>, path: String) -> PyResult<Py<PyAny>> {
 #[pymodule]
 pub fn polars_readstat_bindings(m: &Bound<PyModule>) -> PyResult<()> {
     m.add_class::<PyPolarsReadstat>()?;
+    m.add_class::<PyReadProfiler>()?;
     m.add_function(wrap_pyfunction!(readstat_schema_rs, m)?)?;
     m.add_function(wrap_pyfunction!(readstat_metadata_json_rs, m)?)?;
     m.add_function(wrap_pyfunction!(read_readstat_rs, m)?)?;
+    m.add_function(wrap_pyfunction!(sink_readstat_rs, m)?)?;
     m.add_function(wrap_pyfunction!(sink_stata, m)?)?;
+    m.add_function(wrap_pyfunction!(sink_xpt, m)?)?;
+    m.add_function(wrap_pyfunction!(sink_sas_csv_import, m)?)?;
     m.add_function(wrap_pyfunction!(write_stata, m)?)?;
     m.add_function(wrap_pyfunction!(write_spss, m)?)?;
     m.add_function(wrap_pyfunction!(write_spss_from_df_rs, m)?)?;
@@ -479,11 +493,11 @@ pub fn polars_readstat_bindings(m: &Bound<PyModule>) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(write_xpt_from_df_rs, m)?)?;
     m.add_function(wrap_pyfunction!(write_por, m)?)?;
     m.add_function(wrap_pyfunction!(write_por_from_df_rs, m)?)?;
-    m.add_function(wrap_pyfunction!(scan_por_rs, m)?)?;
     m.add_function(wrap_pyfunction!(por_metadata_json_rs, m)?)?;
     m.add_function(wrap_pyfunction!(write_sas_csv_import, m)?)?;
     m.add_function(wrap_pyfunction!(scan_readstat_rs, m)?)?;
     m.add_function(wrap_pyfunction!(read_sas7bcat_rs, m)?)?;
+    m.add_function(wrap_pyfunction!(build_sas_page_index_rs, m)?)?;
     Ok(())
 }
 
@@ -506,12 +520,48 @@ pub struct PyPolarsReadstat {
     iter: Option<Mutex<polars_readstat_rs::ReadstatBatchIter>>,
     informative_nulls: Option<InformativeNullOpts>,
     cached_metadata: Option<MetadataInner>,
+    row_filter: Option<RowFilter>,
+    profiler: Option<ReadProfiler>,
+}
+
+/// Per-stage timings and counters collected across one or more reads.
+///
+/// Pass it as `profiler=` to a scan or read; `report()` returns the totals so
+/// far as a dict, so a lazy scan can be inspected after it is collected.
+#[pyclass(name = "ReadProfiler")]
+#[derive(Clone, Default)]
+pub struct PyReadProfiler(ReadProfiler);
+
+#[pymethods]
+impl PyReadProfiler {
+    #[new]
+    fn new() -> Self {
+        Self::default()
+    }
+
+    fn report<'py>(&self, py: Python<'py>) -> PyResult<Bound<'py, PyDict>> {
+        profile_dict(py, &self.0)
+    }
+}
+
+fn profile_dict<'py>(py: Python<'py>, profiler: &ReadProfiler) -> PyResult<Bound<'py, PyDict>> {
+    let report = profiler.report();
+    let out = PyDict::new(py);
+    for (name, value) in report.to_pairs() {
+        out.set_item(name, value)?;
+    }
+    out.set_item("bytes_read", report.bytes_read)?;
+    out.set_item("bytes_decompressed", report.bytes_decompressed)?;
+    out.set_item("rows", report.rows)?;
+    out.set_item("batches", report.batches)?;
+    out.set_item("threads", report.threads)?;
+    Ok(out)
 }
 
 #[pymethods]
 impl PyPolarsReadstat {
     #[new]
-    #[pyo3(signature = (path, size_hint, n_rows, threads, missing_string_as_null, value_labels_as_strings=false, preserve_order=false, compress=None, informative_nulls=None, row_index_name=None))]
+    #[pyo3(signature = (path, size_hint, n_rows, threads, missing_string_as_null, value_labels_as_strings=false, preserve_order=false, compress=None, informative_nulls=None, row_index_name=None, profiler=None))]
     fn new_source(
         path: String,
         size_hint: usize,
@@ -523,6 +573,7 @@ impl PyPolarsReadstat {
         compress: Option<&Bound<PyDict>>,
         informative_nulls: Option<&Bound<PyDict>>,
         row_index_name: Option<String>,
+        profiler: Option<PyRef<PyReadProfiler>>,
     ) -> PyResult<Self> {
         let max_useful_threads = num_cpus::get_physical();
         let threads = if threads.is_none() {
@@ -554,6 +605,8 @@ impl PyPolarsReadstat {
             iter: None,
             informative_nulls: parsed_informative_nulls,
             cached_metadata: None,
+            row_filter: None,
+            profiler: profiler.map(|p| p.0.clone()),
         })
     }
 
@@ -588,6 +641,13 @@ impl PyPolarsReadstat {
         self.with_columns = Some(columns);
     }
 
+    /// Hand the scan predicate to the native reader so it can skip rows
+    /// during decode. Only the pushable subset is kept; the caller still
+    /// applies the full predicate to every batch.
+    fn set_predicate(&mut self, predicate: PyExpr) {
+        self.row_filter = RowFilter::from_expr(&predicate.0);
+    }
+
     fn next(&mut self) -> PyResult<Option<PyDataFrame>> {
         if self.n_rows == Some(0) {
             return Ok(None);
@@ -725,6 +785,8 @@ impl PyPolarsReadstat {
             preserve_order: Some(self.preserve_order),
             row_index_name: self.row_index_name.clone(),
             informative_nulls: self.informative_nulls.clone(),
+            row_filter: self.row_filter.clone(),
+            profile: self.profiler.clone(),
             ..Default::default()
         };
         let iter = readstat_batch_iter(
@@ -761,7 +823,8 @@ impl PyPolarsReadstat {
     preserve_order=false,
     compress=None,
     informative_nulls=None,
-    row_index_name=None
+    row_index_name=None,
+    profiler=None
 ))]
 fn scan_readstat_rs(
     path: String,
@@ -773,6 +836,7 @@ fn scan_readstat_rs(
     compress: Option<&Bound<PyDict>>,
     informative_nulls: Option<&Bound<PyDict>>,
     row_index_name: Option<String>,
+    profiler: Option<PyRef<PyReadProfiler>>,
 ) -> PyResult<PyLazyFrame> {
     let parsed_compress = parse_compress_opts(compress)?;
     let parsed_informative_nulls = parse_informative_null_opts(informative_nulls)?;
@@ -785,6 +849,7 @@ fn scan_readstat_rs(
         row_index_name,
         informative_nulls: parsed_informative_nulls,
         compress_opts: parsed_compress.opts,
+        profile: profiler.map(|p| p.0.clone()),
         ..Default::default()
     };
     let lf = readstat_scan(&path, Some(opts), None)
@@ -850,6 +915,110 @@ fn readstat_schema_rs(
     Ok(PySchema(schema))
 }
 
+fn parse_parquet_compression(name: Option<&str>) -> PyResult<Option<ParquetCompression>> {
+    let Some(name) = name else {
+        return Ok(None);
+    };
+    let compression = match name.to_ascii_lowercase().as_str() {
+        "zstd" => ParquetCompression::Zstd(None),
+        "snappy" => ParquetCompression::Snappy,
+        "lz4" => ParquetCompression::Lz4Raw,
+        "gzip" => ParquetCompression::Gzip(None),
+        "uncompressed" => ParquetCompression::Uncompressed,
+        other => {
+            return Err(PyValueError::new_err(format!(
+                "compression: expected 'zstd', 'snappy', 'lz4', 'gzip' or 'uncompressed', got '{other}'"
+            )))
+        }
+    };
+    Ok(Some(compression))
+}
+
+#[pyfunction]
+#[pyo3(signature = (
+    path,
+    output,
+    file_type,
+    threads=None,
+    row_group_size=None,
+    missing_string_as_null=false,
+    value_labels_as_strings=false,
+    preserve_order=true,
+    columns=None,
+    n_rows=None,
+    informative_nulls=None,
+    row_index_name=None,
+    compression=None,
+    carry_labels=false,
+    memory_budget=None,
+    profiler=None
+))]
+fn sink_readstat_rs(
+    py: Python<'_>,
+    path: String,
+    output: String,
+    file_type: &str,
+    threads: Option<usize>,
+    row_group_size: Option<usize>,
+    missing_string_as_null: bool,
+    value_labels_as_strings: bool,
+    preserve_order: bool,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    informative_nulls: Option<&Bound<PyDict>>,
+    row_index_name: Option<String>,
+    compression: Option<String>,
+    carry_labels: bool,
+    memory_budget: Option<usize>,
+    profiler: Option<PyRef<PyReadProfiler>>,
+) -> PyResult<u64> {
+    let opts = ScanOptions {
+        threads,
+        missing_string_as_null: Some(missing_string_as_null),
+        value_labels_as_strings: Some(value_labels_as_strings),
+        preserve_order: Some(preserve_order),
+        row_index_name,
+        informative_nulls: parse_informative_null_opts(informative_nulls)?,
+        memory_budget,
+        profile: profiler.map(|p| p.0.clone()),
+        ..Default::default()
+    };
+    let sink = TranscodeOptions {
+        row_group_size,
+        compression: parse_parquet_compression(compression.as_deref())?,
+        carry_labels,
+    };
+    let result = match file_type {
+        "parquet" => py.detach(|| {
+            readstat_sink_parquet(&path, &output, Some(opts), None, columns, n_rows, sink)
+        }),
+        "ipc" => py.detach(|| {
+            readstat_sink_ipc(&path, &output, Some(opts), None, columns, n_rows, sink)
+        }),
+        other => {
+            return Err(PyValueError::new_err(format!(
+                "file_type: expected 'parquet' or 'ipc', got '{other}'"
+            )))
+        }
+    };
+    result.map_err(|e| PyRuntimeError::new_err(e.to_string()))
+}
+
+/// Build the page index of a sas7bdat file and save it as the `<file>.pidx` sidecar
+/// that later opens load, so offset reads and samples seek straight to their pages.
+#[pyfunction]
+fn build_sas_page_index_rs(py: Python<'_>, path: String) -> PyResult<()> {
+    py.detach(|| {
+        let reader = Sas7bdatReader::open(&path)?;
+        let index = reader.build_page_index()?;
+        index.save(&SasPageIndex::sidecar_path(Path::new(&path)))?;
+        // Cached opens of the file predate the sidecar.
+        clear_metadata_cache();
+        Ok::<_, polars_readstat_rs::Error>(())
+    })
+    .map_err(|e| PyRuntimeError::new_err(e.to_string()))
+}
+
 #[pyfunction]
 fn readstat_metadata_json_rs(path: String) -> PyResult<String> {
     readstat_metadata_json(&path, None).map_err(PyValueError::new_err)
@@ -863,7 +1032,8 @@ fn readstat_metadata_json_rs(path: String) -> PyResult<String> {
     value_labels_as_strings=false,
     columns=None,
     compress=None,
-    informative_nulls=None
+    informative_nulls=None,
+    profiler=None
 ))]
 fn read_readstat_rs(
     path: String,
@@ -873,9 +1043,11 @@ fn read_readstat_rs(
     columns: Option<Vec<String>>,
     compress: Option<&Bound<PyDict>>,
     informative_nulls: Option<&Bound<PyDict>>,
+    profiler: Option<PyRef<PyReadProfiler>>,
 ) -> PyResult<PyDataFrame> {
     let parsed_compress = parse_compress_opts(compress)?;
     let parsed_informative_nulls = parse_informative_null_opts(informative_nulls)?;
+    let _profile = profiler.as_ref().map(|p| p.0.enter());
     let df = read_df_with_options(
         &path,
         threads,
@@ -982,7 +1154,7 @@ fn sink_stata(
             .collect_schema()
             .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
 
-    // Pre-pass over batches to determine String widths and reject strL-only cases.
+    // Pre-pass over batches to determine String widths; wider than DTA_MAX_STR means strL.
     let width_map = Arc::new(Mutex::new(HashMap::<String, usize>::new()));
     for (name, dtype) in schema_ref.iter() {
         if matches!(dtype, DataType::String) {
@@ -1011,25 +1183,14 @@ fn sink_stata(
                     let current = width_guard.entry(name.clone()).or_insert(1);
                     for opt in utf8.into_iter() {
                         if let Some(s) = opt {
-                            if s.as_bytes().iter().any(|b| *b == 0) || s.ends_with(' ') {
-                                return Err(PolarsError::ComputeError(
-                                    format!(
-                                        "streaming Stata sink does not support strL-required data (column '{}')",
-                                        name
-                                    )
-                                    .into(),
-                                ));
-                            }
-                            let width = s.as_bytes().len().max(1);
-                            if width > DTA_MAX_STR {
-                                return Err(PolarsError::ComputeError(
-                                    format!(
-                                        "streaming Stata sink does not support strings > {} bytes (column '{}')",
-                                        DTA_MAX_STR, name
-                                    )
-                                    .into(),
-                                ));
-                            }
+                            // Values a fixed-width str cannot hold (embedded NULs,
+                            // trailing spaces) make the column a strL.
+                            let bytes = s.as_bytes();
+                            let width = if bytes.contains(&0) || s.ends_with(' ') {
+                                DTA_MAX_STR + 1
+                            } else {
+                                bytes.len().max(1)
+                            };
                             if width > *current {
                                 *current = width;
                             }
@@ -1095,6 +1256,211 @@ fn sink_stata(
     writer_result.map_err(|e| PyValueError::new_err(e.to_string()))
 }
 
+/// Max byte width of each String column of `lf`, from one pass over its batches.
+fn streamed_string_widths(
+    lf: &LazyFrame,
+    preserve_order: bool,
+    chunk_size: Option<NonZeroUsize>,
+) -> PyResult<HashMap<String, usize>> {
+    let widths = Arc::new(Mutex::new(HashMap::<String, usize>::new()));
+    let prepass_widths = Arc::clone(&widths);
+    lf.clone()
+        .sink_batches(
+            PlanCallback::new(move |df: DataFrame| {
+                let mut widths = prepass_widths
+                    .lock()
+                    .map_err(|_| PolarsError::ComputeError("width map mutex poisoned".into()))?;
+                for col in df.columns() {
+                    if !matches!(col.dtype(), DataType::String) {
+                        continue;
+                    }
+                    let max = col
+                        .as_materialized_series()
+                        .str()?
+                        .into_iter()
+                        .flatten()
+                        .map(|s| s.len())
+                        .max()
+                        .unwrap_or(0);
+                    let current = widths.entry(col.name().to_string()).or_insert(1);
+                    *current = (*current).max(max);
+                }
+                Ok(false)
+            }),
+            preserve_order,
+            chunk_size,
+        )
+        .map_err(|e| PyRuntimeError::new_err(e.to_string()))?
+        .collect()
+        .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+    let widths = widths
+        .lock()
+        .map_err(|_| PyRuntimeError::new_err("width map mutex poisoned"))?
+        .clone();
+    Ok(widths)
+}
+
+/// Run `lf` with `sink_batches`, handing the batches to `write` on a writer thread.
+fn sink_to_writer<W>(
+    lf: LazyFrame,
+    preserve_order: bool,
+    chunk_size: Option<NonZeroUsize>,
+    write: W,
+) -> PyResult<()>
+where
+    W: FnOnce(mpsc::IntoIter<DataFrame>) -> Result<(), String> + Send + 'static,
+{
+    let (tx, rx) = mpsc::sync_channel::<DataFrame>(2);
+    let writer_thread = std::thread::spawn(move || write(rx.into_iter()));
+    let sink_plan = lf
+        .sink_batches(
+            PlanCallback::new(move |df: DataFrame| match tx.send(df) {
+                Ok(()) => Ok(false),
+                Err(_) => Ok(true),
+            }),
+            preserve_order,
+            chunk_size,
+        )
+        .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+    let sink_result = sink_plan.collect();
+    let writer_result = writer_thread
+        .join()
+        .map_err(|_| PyRuntimeError::new_err("writer thread panicked"))?;
+
+    sink_result.map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+    writer_result.map_err(PyValueError::new_err)
+}
+
+#[pyfunction]
+#[pyo3(signature = (
+    lf,
+    path,
+    version=8,
+    table_name=None,
+    file_label=None,
+    variable_labels=None,
+    variable_format=None,
+    storage_widths=None,
+    batch_size=None,
+    preserve_order=true
+))]
+fn sink_xpt(
+    lf: PyLazyFrame,
+    path: String,
+    version: u8,
+    table_name: Option<String>,
+    file_label: Option<String>,
+    variable_labels: Option<&Bound<PyDict>>,
+    variable_format: Option<&Bound<PyDict>>,
+    storage_widths: Option<&Bound<PyDict>>,
+    batch_size: Option<usize>,
+    preserve_order: bool,
+) -> PyResult<()> {
+    ensure_extension(&path, &["xpt"])?;
+    let chunk_size = batch_size.and_then(NonZeroUsize::new);
+    let schema =
+        lf.0.clone()
+            .collect_schema()
+            .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+
+    // Character widths go into the NAMESTR headers, ahead of the data, so any not
+    // given explicitly come from a first pass over the batches.
+    let mut widths = match storage_widths {
+        Some(widths) => parse_storage_widths_dict(widths)?,
+        None => HashMap::new(),
+    };
+    let needs_pass = schema.iter().any(|(name, dtype)| {
+        matches!(dtype, DataType::String | DataType::Categorical(_, _))
+            && !widths.contains_key(name.as_str())
+    });
+    if needs_pass {
+        let string_lf = lf.0.clone().with_columns(
+            schema
+                .iter()
+                .filter(|(_, dtype)| matches!(dtype, DataType::Categorical(_, _)))
+                .map(|(name, _)| col(name.clone()).cast(DataType::String))
+                .collect::<Vec<_>>(),
+        );
+        for (name, width) in streamed_string_widths(&string_lf, preserve_order, chunk_size)? {
+            widths.entry(name).or_insert(width);
+        }
+    }
+
+    let mut writer = XptWriter::new(path)
+        .with_version(version)
+        .with_storage_widths(widths);
+    if let Some(name) = table_name {
+        writer = writer.with_table_name(name);
+    }
+    if let Some(label) = file_label {
+        writer = writer.with_file_label(label);
+    }
+    if let Some(labels) = variable_labels {
+        writer = writer.with_variable_labels(parse_variable_labels_dict(labels)?);
+    }
+    if let Some(formats) = variable_format {
+        writer = writer.with_variable_formats(parse_variable_labels_dict(formats)?);
+    }
+    sink_to_writer(lf.0, preserve_order, chunk_size, move |batches| {
+        writer
+            .write_batches_streaming(batches, &schema)
+            .map_err(|e| e.to_string())
+    })
+}
+
+#[pyfunction]
+#[pyo3(signature = (
+    lf,
+    path,
+    dataset_name=None,
+    value_labels=None,
+    variable_labels=None,
+    library=None,
+    delete_csv_on_import=false,
+    batch_size=None,
+    preserve_order=true
+))]
+fn sink_sas_csv_import(
+    lf: PyLazyFrame,
+    path: String,
+    dataset_name: Option<String>,
+    value_labels: Option<&Bound<PyDict>>,
+    variable_labels: Option<&Bound<PyDict>>,
+    library: Option<String>,
+    delete_csv_on_import: bool,
+    batch_size: Option<usize>,
+    preserve_order: bool,
+) -> PyResult<()> {
+    let mut writer = SasWriter::new(path);
+    if let Some(name) = dataset_name {
+        writer = writer.with_dataset_name(name);
+    }
+    if let Some(lib) = library {
+        writer = writer.with_library(lib);
+    }
+    if delete_csv_on_import {
+        writer = writer.with_delete_csv_on_import(true);
+    }
+    if let Some(labels) = value_labels {
+        writer = writer.with_value_labels(parse_sas_value_labels(labels)?);
+    }
+    if let Some(labels) = variable_labels {
+        writer = writer.with_variable_labels(parse_sas_variable_labels(labels)?);
+    }
+    let chunk_size = batch_size.and_then(NonZeroUsize::new);
+    // With no rows there are no batches; the schema still names the columns.
+    let schema =
+        lf.0.clone()
+            .collect_schema()
+            .map_err(|e| PyRuntimeError::new_err(e.to_string()))?;
+    sink_to_writer(lf.0, preserve_order, chunk_size, move |batches| {
+        writer
+            .write_batches_streaming_with_schema(batches, &schema)
+            .map(|_| ())
+            .map_err(|e| e.to_string())
+    })
+}
+
 #[pyfunction]
 fn write_spss(
     df: PyDataFrame,
@@ -1519,14 +1885,6 @@ fn write_por_from_df_rs(
         .map_err(|e| PyValueError::new_err(e.to_string()))
 }
 
-#[pyfunction]
-#[pyo3(signature = (path))]
-fn scan_por_rs(path: String) -> PyResult<PyDataFrame> {
-    let (_, df) = polars_readstat_rs::read_por(&path)
-        .map_err(|e| PyValueError::new_err(e.to_string()))?;
-    Ok(PyDataFrame(df))
-}
-
 #[pyfunction]
 #[pyo3(signature = (path))]
 fn por_metadata_json_rs(path: String) -> PyResult<String> {
@@ -1 +0,0 @@
-include!("sas/python_stream_benchmarks.rs");
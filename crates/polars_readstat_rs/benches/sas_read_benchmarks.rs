@@ -1 +0,0 @@
-include!("sas/read_benchmarks.rs");
@@ -1 +0,0 @@
-include!("sas/schema_benchmarks.rs");
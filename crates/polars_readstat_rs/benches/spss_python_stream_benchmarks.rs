@@ -1 +0,0 @@
-include!("spss/python_stream_benchmarks.rs");
@@ -1 +0,0 @@
-include!("spss/read_benchmarks.rs");
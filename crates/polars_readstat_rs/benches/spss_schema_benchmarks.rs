@@ -1 +0,0 @@
-include!("spss/schema_benchmarks.rs");
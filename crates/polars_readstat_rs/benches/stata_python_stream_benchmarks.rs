@@ -1 +0,0 @@
-include!("stata/python_stream_benchmarks.rs");
@@ -1 +0,0 @@
-include!("stata/read_benchmarks.rs");
@@ -1 +0,0 @@
-include!("stata/schema_benchmarks.rs");
@@ -0,0 +1,653 @@
+//! Cross-format throughput and memory benchmark.
+//!
+//! Generates synthetic files for each shape and format, then times full read,
+//! projected read, filtered read, streaming and write at a sweep of thread
+//! counts. Every measurement is printed to stdout as one JSON object per line
+//! (MB/s, rows/s, peak RSS); a summary goes to stderr.
+//!
+//! ```text
+//! cargo bench --bench throughput
+//! READSTAT_BENCH_ROWS=200000 READSTAT_BENCH_FILTER=sav cargo bench --bench throughput
+//! READSTAT_BENCH_BASELINE=before.jsonl cargo bench --bench throughput > after.jsonl
+//! ```
+//!
+//! Environment:
+//! - `READSTAT_BENCH_ROWS`: rows of the tall shape (default 1,000,000; the other
+//!   shapes scale from it).
+//! - `READSTAT_BENCH_REPS`: timed repetitions per case, the median is reported
+//!   (default 3).
+//! - `READSTAT_BENCH_THREADS`: comma-separated thread counts (default 1, 2, 4, ...
+//!   up to the available parallelism).
+//! - `READSTAT_BENCH_FILTER`: only run cases whose `format/shape/workload` name
+//!   contains this substring.
+//! - `READSTAT_BENCH_FILES`: extra comma-separated files (e.g. real sas7bdat
+//!   files, which cannot be generated) benchmarked as shape `file`.
+//! - `READSTAT_BENCH_BASELINE`: JSON lines from an earlier run; cases whose rows/s
+//!   drop or whose peak RSS grows by more than `READSTAT_BENCH_TOLERANCE`
+//!   (default 0.10) are reported and the run exits with status 1.
+
+use polars::prelude::*;
+use polars_readstat_rs::{
+    clear_metadata_cache, readstat_batch_iter, readstat_scan, ScanOptions, SpssCompression,
+    SpssValueLabelKey, SpssValueLabels, SpssWriter, StataWriter, ValueLabels, XptWriter,
+};
+use serde_json::json;
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
+use std::time::Instant;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum FileFormat {
+    Dta,
+    Sav,
+    Zsav,
+    Xpt,
+}
+
+impl FileFormat {
+    fn name(self) -> &'static str {
+        match self {
+            FileFormat::Dta => "dta",
+            FileFormat::Sav => "sav",
+            FileFormat::Zsav => "zsav",
+            FileFormat::Xpt => "xpt",
+        }
+    }
+
+    fn has_thread_option(self) -> bool {
+        self != FileFormat::Xpt
+    }
+}
+
+#[derive(Clone, Copy)]
+enum Shape {
+    TallNarrow,
+    ShortWide,
+    StringHeavy,
+    Compressed,
+    Labelled,
+}
+
+impl Shape {
+    fn name(self) -> &'static str {
+        match self {
+            Shape::TallNarrow => "tall_narrow",
+            Shape::ShortWide => "short_wide",
+            Shape::StringHeavy => "string_heavy",
+            Shape::Compressed => "compressed",
+            Shape::Labelled => "labelled",
+        }
+    }
+
+    /// Formats that can hold the shape: compression only exists for SPSS and
+    /// value labels only for Stata and SPSS.
+    fn formats(self) -> &'static [FileFormat] {
+        match self {
+            Shape::TallNarrow | Shape::ShortWide | Shape::StringHeavy => {
+                &[FileFormat::Dta, FileFormat::Sav, FileFormat::Xpt]
+            }
+            Shape::Compressed => &[FileFormat::Sav, FileFormat::Zsav],
+            Shape::Labelled => &[FileFormat::Dta, FileFormat::Sav, FileFormat::Zsav],
+        }
+    }
+}
+
+const SHAPES: [Shape; 5] = [
+    Shape::TallNarrow,
+    Shape::ShortWide,
+    Shape::StringHeavy,
+    Shape::Compressed,
+    Shape::Labelled,
+];
+
+const WORDS: [&str; 8] = [
+    "alpha",
+    "bravo",
+    "charlie",
+    "delta",
+    "echo",
+    "foxtrot",
+    "golf",
+    "a somewhat longer free text answer",
+];
+
+const LABELS: [&str; 5] = [
+    "Strongly disagree",
+    "Disagree",
+    "Neutral",
+    "Agree",
+    "Strongly agree",
+];
+
+struct Config {
+    rows: usize,
+    reps: usize,
+    threads: Vec<usize>,
+    filter: Option<String>,
+    files: Vec<PathBuf>,
+    baseline: Option<PathBuf>,
+    tolerance: f64,
+}
+
+impl Config {
+    fn from_env() -> Self {
+        let var = |name: &str| std::env::var(name).ok().filter(|v| !v.is_empty());
+        let max_threads = std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1);
+        let threads = match var("READSTAT_BENCH_THREADS") {
+            Some(list) => list
+                .split(',')
+                .map(|t| t.trim().parse().expect("READSTAT_BENCH_THREADS"))
+                .collect(),
+            None => {
+                let mut threads = Vec::new();
+                let mut t = 1;
+                while t < max_threads {
+                    threads.push(t);
+                    t *= 2;
+                }
+                threads.push(max_threads);
+                threads
+            }
+        };
+        Self {
+            rows: var("READSTAT_BENCH_ROWS").map_or(1_000_000, |v| v.parse().expect("rows")),
+            reps: var("READSTAT_BENCH_REPS").map_or(3, |v| v.parse().expect("reps")),
+            threads,
+            filter: var("READSTAT_BENCH_FILTER"),
+            files: var("READSTAT_BENCH_FILES")
+                .map(|v| v.split(',').map(PathBuf::from).collect())
+                .unwrap_or_default(),
+            baseline: var("READSTAT_BENCH_BASELINE").map(PathBuf::from),
+            tolerance: var("READSTAT_BENCH_TOLERANCE")
+                .map_or(0.10, |v| v.parse().expect("tolerance")),
+        }
+    }
+
+    fn wants(&self, case: &str) -> bool {
+        self.filter.as_ref().map_or(true, |f| case.contains(f))
+    }
+}
+
+/// Deterministic xorshift generator so runs are comparable.
+struct Rng(u64);
+
+impl Rng {
+    fn next(&mut self) -> u64 {
+        self.0 ^= self.0 << 13;
+        self.0 ^= self.0 >> 7;
+        self.0 ^= self.0 << 17;
+        self.0
+    }
+
+    fn below(&mut self, n: u64) -> u64 {
+        self.next() % n
+    }
+}
+
+fn id_column(rows: usize) -> Column {
+    Column::new("id".into(), (0..rows as i32).collect::<Vec<_>>())
+}
+
+fn int_column(name: &str, rows: usize, rng: &mut Rng, max: u64) -> Column {
+    let values: Vec<i32> = (0..rows).map(|_| rng.below(max) as i32).collect();
+    Column::new(name.into(), values)
+}
+
+fn float_column(name: &str, rows: usize, rng: &mut Rng) -> Column {
+    let values: Vec<Option<f64>> = (0..rows)
+        .map(|_| match rng.below(20) {
+            0 => None,
+            _ => Some(rng.below(1_000_000) as f64 / 100.0),
+        })
+        .collect();
+    Column::new(name.into(), values)
+}
+
+fn string_column(name: &str, rows: usize, rng: &mut Rng) -> Column {
+    let values: Vec<String> = (0..rows)
+        .map(|_| {
+            let word = WORDS[rng.below(WORDS.len() as u64) as usize];
+            format!("{word} {}", rng.below(10_000))
+        })
+        .collect();
+    Column::new(name.into(), values)
+}
+
+/// The synthetic frame for `shape`, and the names of its labelled columns.
+fn generate(shape: Shape, tall_rows: usize) -> (DataFrame, Vec<String>) {
+    let mut rng = Rng(0x9E37_79B9_7F4A_7C15);
+    let mut labelled = Vec::new();
+    let columns = match shape {
+        Shape::TallNarrow | Shape::Compressed => {
+            let rows = tall_rows;
+            let mut columns = vec![id_column(rows)];
+            for i in 1..=3 {
+                columns.push(int_column(&format!("i{i}"), rows, &mut rng, 100));
+            }
+            for i in 1..=4 {
+                columns.push(float_column(&format!("f{i}"), rows, &mut rng));
+            }
+            columns
+        }
+        Shape::ShortWide => {
+            let rows = (tall_rows / 200).max(1);
+            let mut columns = vec![id_column(rows)];
+            for i in 1..=1000 {
+                columns.push(float_column(&format!("x{i:04}"), rows, &mut rng));
+            }
+            columns
+        }
+        Shape::StringHeavy => {
+            let rows = (tall_rows / 4).max(1);
+            let mut columns = vec![id_column(rows)];
+            columns.push(float_column("f1", rows, &mut rng));
+            for i in 1..=8 {
+                columns.push(string_column(&format!("s{i}"), rows, &mut rng));
+            }
+            columns
+        }
+        Shape::Labelled => {
+            let rows = tall_rows;
+            let mut columns = vec![id_column(rows)];
+            for i in 1..=8 {
+                let name = format!("q{i}");
+                columns.push(int_column(&name, rows, &mut rng, LABELS.len() as u64));
+                labelled.push(name);
+            }
+            columns.push(float_column("f1", rows, &mut rng));
+            columns
+        }
+    };
+    (
+        DataFrame::new_infer_height(columns).expect("frame"),
+        labelled,
+    )
+}
+
+fn write_file(
+    df: &DataFrame,
+    path: &Path,
+    format: FileFormat,
+    shape: Shape,
+    labelled: &[String],
+    threads: usize,
+) {
+    match format {
+        FileFormat::Dta => {
+            let mut writer = StataWriter::new(path).with_n_threads(threads);
+            if !labelled.is_empty() {
+                let map: std::collections::BTreeMap<i32, String> = LABELS
+                    .iter()
+                    .enumerate()
+                    .map(|(code, label)| (code as i32, label.to_string()))
+                    .collect();
+                let labels: ValueLabels =
+                    labelled.iter().map(|c| (c.clone(), map.clone())).collect();
+                writer = writer.with_value_labels(labels);
+            }
+            writer.write_df(df).expect("write dta");
+        }
+        FileFormat::Sav | FileFormat::Zsav => {
+            let compression = match (format, shape) {
+                (FileFormat::Zsav, _) => SpssCompression::Zlib,
+                (_, Shape::Compressed) => SpssCompression::Bytecode,
+                _ => SpssCompression::None,
+            };
+            let mut writer = SpssWriter::new(path)
+                .with_compression(compression)
+                .with_n_threads(threads);
+            if !labelled.is_empty() {
+                let map: HashMap<SpssValueLabelKey, String> = LABELS
+                    .iter()
+                    .enumerate()
+                    .map(|(code, label)| (SpssValueLabelKey::from(code as f64), label.to_string()))
+                    .collect();
+                let labels: SpssValueLabels =
+                    labelled.iter().map(|c| (c.clone(), map.clone())).collect();
+                writer = writer.with_value_labels(labels);
+            }
+            writer.write_df(df).expect("write sav");
+        }
+        FileFormat::Xpt => XptWriter::new(path).write_df(df).expect("write xpt"),
+    }
+}
+
+#[derive(Clone, Copy)]
+enum Workload {
+    Read,
+    Projected,
+    Filtered,
+    Streaming,
+    Write,
+}
+
+impl Workload {
+    fn name(self) -> &'static str {
+        match self {
+            Workload::Read => "read",
+            Workload::Projected => "projected_read",
+            Workload::Filtered => "filtered_read",
+            Workload::Streaming => "streaming",
+            Workload::Write => "write",
+        }
+    }
+}
+
+const READ_WORKLOADS: [Workload; 4] = [
+    Workload::Read,
+    Workload::Projected,
+    Workload::Filtered,
+    Workload::Streaming,
+];
+
+/// Resident and peak resident set size in MB, where the platform reports them.
+fn rss_mb() -> Option<(f64, f64)> {
+    let status = std::fs::read_to_string("/proc/self/status").ok()?;
+    let field = |key: &str| -> Option<f64> {
+        let line = status.lines().find(|l| l.starts_with(key))?;
+        let kb: f64 = line[key.len()..]
+            .trim()
+            .trim_end_matches("kB")
+            .trim()
+            .parse()
+            .ok()?;
+        Some(kb / 1024.0)
+    };
+    Some((field("VmRSS:")?, field("VmHWM:")?))
+}
+
+/// Restart peak RSS tracking at the current RSS (Linux only).
+fn reset_peak_rss() {
+    let _ = std::fs::write("/proc/self/clear_refs", "5");
+}
+
+fn read_case(path: &Path, workload: Workload, threads: usize, columns: &[String]) -> usize {
+    let opts = ScanOptions {
+        threads: Some(threads),
+        ..Default::default()
+    };
+    let lf = || readstat_scan(path, Some(opts.clone()), None).expect("scan");
+    match workload {
+        Workload::Read => lf().collect().expect("read").height(),
+        Workload::Projected => {
+            let keep: Vec<Expr> = columns.iter().take(2).map(|c| col(c.as_str())).collect();
+            lf().select(keep)
+                .collect()
+                .expect("projected read")
+                .height()
+        }
+        Workload::Filtered => lf()
+            .filter(col("id").lt(lit(100_000)))
+            .collect()
+            .expect("filtered read")
+            .height(),
+        Workload::Streaming => {
+            let iter = readstat_batch_iter(path, Some(opts.clone()), None, None, None, None)
+                .expect("batch iter");
+            iter.map(|batch| batch.expect("batch").height()).sum()
+        }
+        Workload::Write => unreachable!("writes are timed by write_file"),
+    }
+}
+
+struct Measurement {
+    format: String,
+    shape: &'static str,
+    workload: &'static str,
+    threads: usize,
+    rows: usize,
+    bytes: u64,
+    secs: f64,
+    base_rss_mb: Option<f64>,
+    peak_rss_mb: Option<f64>,
+}
+
+impl Measurement {
+    fn key(&self) -> String {
+        format!(
+            "{}/{}/{}/{}",
+            self.format, self.shape, self.workload, self.threads
+        )
+    }
+
+    fn rows_per_s(&self) -> f64 {
+        self.rows as f64 / self.secs
+    }
+
+    fn to_json(&self) -> serde_json::Value {
+        json!({
+            "format": self.format,
+            "shape": self.shape,
+            "workload": self.workload,
+            "threads": self.threads,
+            "rows": self.rows,
+            "bytes": self.bytes,
+            "secs": self.secs,
+            "mb_per_s": self.bytes as f64 / 1e6 / self.secs,
+            "rows_per_s": self.rows_per_s(),
+            "base_rss_mb": self.base_rss_mb,
+            "peak_rss_mb": self.peak_rss_mb,
+        })
+    }
+}
+
+/// Run `f` `reps` times; the median time and the highest peak RSS.
+fn measure<F: FnMut() -> usize>(reps: usize, mut f: F) -> (usize, f64, Option<f64>, Option<f64>) {
+    let mut times = Vec::with_capacity(reps);
+    let mut rows = 0;
+    let mut base = None;
+    let mut peak: Option<f64> = None;
+    for _ in 0..reps.max(1) {
+        clear_metadata_cache();
+        reset_peak_rss();
+        let before = rss_mb();
+        let start = Instant::now();
+        rows = f();
+        times.push(start.elapsed().as_secs_f64());
+        if let (Some((rss, _)), Some((_, hwm))) = (before, rss_mb()) {
+            base = Some(rss);
+            peak = Some(peak.map_or(hwm, |p: f64| p.max(hwm)));
+        }
+    }
+    times.sort_by(f64::total_cmp);
+    (rows, times[times.len() / 2], base, peak)
+}
+
+fn report(m: Measurement, results: &mut Vec<Measurement>) {
+    println!("{}", m.to_json());
+    eprintln!(
+        "{:<42} {:>8.3}s {:>9.1} MB/s {:>12.0} rows/s  peak {}",
+        m.key(),
+        m.secs,
+        m.bytes as f64 / 1e6 / m.secs,
+        m.rows_per_s(),
+        m.peak_rss_mb
+            .map_or_else(|| "n/a".to_string(), |p| format!("{p:.0} MB")),
+    );
+    results.push(m);
+}
+
+fn file_len(path: &Path) -> u64 {
+    std::fs::metadata(path).map(|m| m.len()).unwrap_or(0)
+}
+
+fn bench_reads(
+    cfg: &Config,
+    path: &Path,
+    format: &str,
+    shape: &'static str,
+    thread_counts: &[usize],
+    results: &mut Vec<Measurement>,
+) {
+    let columns: Vec<String> = readstat_scan(path, None, None)
+        .and_then(|mut lf| lf.collect_schema())
+        .expect("schema")
+        .iter_names()
+        .map(|n| n.to_string())
+        .collect();
+    let filterable = columns.iter().any(|c| c == "id");
+    let bytes = file_len(path);
+    for workload in READ_WORKLOADS {
+        if matches!(workload, Workload::Filtered) && !filterable {
+            continue;
+        }
+        if !cfg.wants(&format!("{format}/{shape}/{}", workload.name())) {
+            continue;
+        }
+        for &threads in thread_counts {
+            let (rows, secs, base, peak) =
+                measure(cfg.reps, || read_case(path, workload, threads, &columns));
+            report(
+                Measurement {
+                    format: format.to_string(),
+                    shape,
+                    workload: workload.name(),
+                    threads,
+                    rows,
+                    bytes,
+                    secs,
+                    base_rss_mb: base,
+                    peak_rss_mb: peak,
+                },
+                results,
+            );
+        }
+    }
+}
+
+/// Compare against an earlier run; the descriptions of regressed cases.
+fn regressions(baseline: &Path, results: &[Measurement], tolerance: f64) -> Vec<String> {
+    let text = std::fs::read_to_string(baseline).expect("read baseline");
+    let mut before = HashMap::new();
+    for line in text.lines().filter(|l| l.trim_start().starts_with('{')) {
+        let v: serde_json::Value = serde_json::from_str(line).expect("baseline line");
+        let key = format!(
+            "{}/{}/{}/{}",
+            v["format"].as_str().unwrap_or_default(),
+            v["shape"].as_str().unwrap_or_default(),
+            v["workload"].as_str().unwrap_or_default(),
+            v["threads"].as_u64().unwrap_or_default()
+        );
+        before.insert(key, v);
+    }
+    let mut out = Vec::new();
+    for m in results {
+        let Some(old) = before.get(&m.key()) else {
+            continue;
+        };
+        if let Some(old_rate) = old["rows_per_s"].as_f64() {
+            if m.rows_per_s() < old_rate * (1.0 - tolerance) {
+                out.push(format!(
+                    "{}: {:.0} rows/s, was {:.0}",
+                    m.key(),
+                    m.rows_per_s(),
+                    old_rate
+                ));
+            }
+        }
+        if let (Some(old_peak), Some(peak)) = (old["peak_rss_mb"].as_f64(), m.peak_rss_mb) {
+            if peak > old_peak * (1.0 + tolerance) {
+                out.push(format!(
+                    "{}: peak RSS {peak:.0} MB, was {old_peak:.0} MB",
+                    m.key()
+                ));
+            }
+        }
+    }
+    out
+}
+
+fn main() {
+    let cfg = Config::from_env();
+    let dir = std::env::temp_dir().join(format!("polars_readstat_bench_{}", std::process::id()));
+    std::fs::create_dir_all(&dir).expect("bench dir");
+    let mut results = Vec::new();
+
+    for shape in SHAPES {
+        let formats: Vec<FileFormat> = shape
+            .formats()
+            .iter()
+            .copied()
+            .filter(|f| cfg.wants(&format!("{}/{}", f.name(), shape.name())))
+            .collect();
+        if formats.is_empty() {
+            continue;
+        }
+        let (df, labelled) = generate(shape, cfg.rows);
+        for &format in &formats {
+            let path = dir.join(format!("{}.{}", shape.name(), format.name()));
+            write_file(&df, &path, format, shape, &labelled, 1);
+
+            let case = format!("{}/{}/write", format.name(), shape.name());
+            if cfg.wants(&case) {
+                let out = dir.join(format!("{}_out.{}", shape.name(), format.name()));
+                let write_threads: &[usize] = if format.has_thread_option() {
+                    &cfg.threads
+                } else {
+                    &[1]
+                };
+                for &threads in write_threads {
+                    let (_, secs, base, peak) = measure(cfg.reps, || {
+                        write_file(&df, &out, format, shape, &labelled, threads);
+                        df.height()
+                    });
+                    report(
+                        Measurement {
+                            format: format.name().to_string(),
+                            shape: shape.name(),
+                            workload: Workload::Write.name(),
+                            threads,
+                            rows: df.height(),
+                            bytes: file_len(&out),
+                            secs,
+                            base_rss_mb: base,
+                            peak_rss_mb: peak,
+                        },
+                        &mut results,
+                    );
+                }
+                let _ = std::fs::remove_file(&out);
+            }
+        }
+        // Reads are measured without the source frame resident.
+        drop(df);
+        for &format in &formats {
+            let path = dir.join(format!("{}.{}", shape.name(), format.name()));
+            bench_reads(
+                &cfg,
+                &path,
+                format.name(),
+                shape.name(),
+                &cfg.threads,
+                &mut results,
+            );
+            let _ = std::fs::remove_file(&path);
+        }
+    }
+
+    for path in &cfg.files {
+        let format = path
+            .extension()
+            .and_then(|e| e.to_str())
+            .unwrap_or("unknown")
+            .to_ascii_lowercase();
+        if cfg.wants(&format!("{format}/file")) {
+            bench_reads(&cfg, path, &format, "file", &cfg.threads, &mut results);
+        }
+    }
+    let _ = std::fs::remove_dir_all(&dir);
+
+    if let Some(baseline) = &cfg.baseline {
+        let regressed = regressions(baseline, &results, cfg.tolerance);
+        if !regressed.is_empty() {
+            eprintln!("\nregressions against {}:", baseline.display());
+            for r in &regressed {
+                eprintln!("  {r}");
+            }
+            std::process::exit(1);
+        }
+        eprintln!("\nno regressions against {}", baseline.display());
+    }
+}
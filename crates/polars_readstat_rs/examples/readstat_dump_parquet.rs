@@ -1,5 +1,8 @@
 use polars::prelude::*;
-use polars_readstat_rs::{readstat_scan, InformativeNullColumns, InformativeNullOpts, ScanOptions};
+use polars_readstat_rs::{
+    readstat_schema, readstat_sink_parquet, InformativeNullColumns, InformativeNullOpts,
+    ScanOptions, TranscodeOptions,
+};
 use std::path::PathBuf;
 
 fn main() -> PolarsResult<()> {
@@ -43,28 +46,25 @@ fn main() -> PolarsResult<()> {
     if std::env::var("READSTAT_PRESERVE_ORDER").ok().is_some() {
         opts.preserve_order = Some(true);
     }
-    let mut lf = readstat_scan(&input, Some(opts), None)?;
-
-    if let Some(n_cols) = cols {
-        if n_cols > 0 {
-            let schema = lf.collect_schema()?;
-            let names = schema
-                .iter_names()
-                .take(n_cols)
-                .map(|name| col(name.as_str()))
-                .collect::<Vec<_>>();
-            lf = lf.select(names);
+    let columns = match cols {
+        Some(n_cols) if n_cols > 0 => {
+            let schema = readstat_schema(&input, Some(opts.clone()), None)?;
+            Some(
+                schema
+                    .iter_names()
+                    .take(n_cols)
+                    .map(|name| name.to_string())
+                    .collect::<Vec<_>>(),
+            )
         }
-    }
-
-    let mut df = lf.collect()?;
-    if let Some(n_rows) = rows {
-        if n_rows > 0 {
-            df = df.head(Some(n_rows));
-        }
-    }
+        _ => None,
+    };
+    let n_rows = rows.filter(|&n| n > 0);
 
-    let file = std::fs::File::create(output)?;
-    ParquetWriter::new(file).finish(&mut df)?;
+    let sink = TranscodeOptions {
+        carry_labels: std::env::var("READSTAT_CARRY_LABELS").ok().is_some(),
+        ..Default::default()
+    };
+    readstat_sink_parquet(&input, &output, Some(opts), None, columns, n_rows, sink)?;
     Ok(())
 }
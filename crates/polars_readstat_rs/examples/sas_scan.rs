@@ -45,6 +45,13 @@ fn main() -> PolarsResult<()> {
         preserve_order: Some(true),
         row_index_name: None,
         compress_opts,
+        row_filter: None,
+        use_mmap: None,
+        read_ahead: None,
+        memory_budget: None,
+        value_labels_as_categorical: None,
+        profile: None,
+        sample: None,
     };
     let df = scan_sas7bdat(path, opts)?.collect()?;
     println!("rows={} cols={}", df.height(), df.width());
@@ -0,0 +1,772 @@
+//! Single-chunk assembly of a full read from its batches.
+//!
+//! Collecting batches with `vstack_mut` keeps every batch's arrays alive and
+//! leaves a many-chunk frame that Polars rechunks later, so a full load briefly
+//! holds the data twice. [`FrameAssembler`] instead copies each batch into
+//! per-column builders that are sized up front from the expected row count and
+//! drops the batch right away: peak memory is the result plus one batch, and
+//! the result is already one chunk per column.
+//!
+//! With read-side compression enabled the assembler also narrows columns as
+//! they fill (see [`FrameAssembler::with_compression`]): per-column statistics
+//! are updated from each batch and values are stored in the narrowest dtype that
+//! still holds everything seen, so the full-width column never exists.
+
+use crate::numeric_column::NumericColumnBuilder;
+use crate::read_profile::{self, ProfileStage};
+use crate::CompressOptionsLite;
+use polars::prelude::*;
+use polars_arrow::bitmap::MutableBitmap;
+
+/// One output column being filled.
+trait ColumnSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()>;
+    fn finish(self: Box<Self>) -> PolarsResult<Series>;
+}
+
+/// Numeric and temporal columns, filled through their physical integer or
+/// float type (one slice copy per array) and cast back to the logical type at
+/// the end.
+struct NumericSink<T: PolarsNumericType> {
+    builder: NumericColumnBuilder<T>,
+    dtype: DataType,
+    physical: fn(&Series) -> PolarsResult<&ChunkedArray<T>>,
+}
+
+impl<T: PolarsNumericType> ColumnSink for NumericSink<T> {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        let physical = series.to_physical_repr();
+        let ca = (self.physical)(&physical)?;
+        for arr in ca.downcast_iter() {
+            self.builder.extend_array(arr);
+        }
+        Ok(())
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        let series = self.builder.finish().into_series();
+        if series.dtype() == &self.dtype {
+            Ok(series)
+        } else {
+            series.cast(&self.dtype)
+        }
+    }
+}
+
+struct StringSink(StringChunkedBuilder);
+
+impl ColumnSink for StringSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        for v in series.str()?.into_iter() {
+            self.0.append_option(v);
+        }
+        Ok(())
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        Ok(self.0.finish().into_series())
+    }
+}
+
+struct BooleanSink(BooleanChunkedBuilder);
+
+impl ColumnSink for BooleanSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        for v in series.bool()?.into_iter() {
+            self.0.append_option(v);
+        }
+        Ok(())
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        Ok(self.0.finish().into_series())
+    }
+}
+
+/// Any other dtype (Enum, Struct, ...): batches are appended and the column is
+/// rechunked on its own at the end.
+struct AppendSink(Series);
+
+impl ColumnSink for AppendSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        self.0.append(series)?;
+        Ok(())
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        Ok(self.0.rechunk())
+    }
+}
+
+fn numeric<T: PolarsNumericType + 'static>(
+    name: PlSmallStr,
+    capacity: usize,
+    dtype: &DataType,
+    physical: fn(&Series) -> PolarsResult<&ChunkedArray<T>>,
+) -> Box<dyn ColumnSink> {
+    Box::new(NumericSink::<T> {
+        builder: NumericColumnBuilder::new(name, capacity),
+        dtype: dtype.clone(),
+        physical,
+    })
+}
+
+fn column_sink(series: &Series, capacity: usize) -> Box<dyn ColumnSink> {
+    let name = series.name().clone();
+    let dtype = series.dtype();
+    match dtype {
+        DataType::Boolean => Box::new(BooleanSink(BooleanChunkedBuilder::new(name, capacity))),
+        DataType::String => Box::new(StringSink(StringChunkedBuilder::new(name, capacity))),
+        DataType::Int8 => numeric::<Int8Type>(name, capacity, dtype, Series::i8),
+        DataType::Int16 => numeric::<Int16Type>(name, capacity, dtype, Series::i16),
+        DataType::Int32 | DataType::Date => {
+            numeric::<Int32Type>(name, capacity, dtype, Series::i32)
+        }
+        DataType::Int64 | DataType::Datetime(_, _) | DataType::Time => {
+            numeric::<Int64Type>(name, capacity, dtype, Series::i64)
+        }
+        DataType::UInt8 => numeric::<UInt8Type>(name, capacity, dtype, Series::u8),
+        DataType::UInt16 => numeric::<UInt16Type>(name, capacity, dtype, Series::u16),
+        DataType::UInt32 => numeric::<UInt32Type>(name, capacity, dtype, Series::u32),
+        DataType::UInt64 => numeric::<UInt64Type>(name, capacity, dtype, Series::u64),
+        DataType::Float32 => numeric::<Float32Type>(name, capacity, dtype, Series::f32),
+        DataType::Float64 => numeric::<Float64Type>(name, capacity, dtype, Series::f64),
+        _ => Box::new(AppendSink(series.clear())),
+    }
+}
+
+// ─── Compression during assembly ────────────────────────────────────────────
+//
+// These sinks produce what `compress_df_if_enabled` would produce for the whole
+// column, from statistics kept while the batches arrive.
+
+/// Storage of a narrowed numeric column.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Narrow {
+    Bool,
+    I8,
+    I16,
+    I32,
+    F32,
+    F64,
+}
+
+enum NarrowValues {
+    Bool(MutableBitmap),
+    I8(Vec<i8>),
+    I16(Vec<i16>),
+    I32(Vec<i32>),
+    F32(Vec<f32>),
+    F64(Vec<f64>),
+}
+
+impl NarrowValues {
+    fn new(kind: Narrow, capacity: usize) -> Self {
+        match kind {
+            Narrow::Bool => Self::Bool(MutableBitmap::with_capacity(capacity)),
+            Narrow::I8 => Self::I8(Vec::with_capacity(capacity)),
+            Narrow::I16 => Self::I16(Vec::with_capacity(capacity)),
+            Narrow::I32 => Self::I32(Vec::with_capacity(capacity)),
+            Narrow::F32 => Self::F32(Vec::with_capacity(capacity)),
+            Narrow::F64 => Self::F64(Vec::with_capacity(capacity)),
+        }
+    }
+
+    fn kind(&self) -> Narrow {
+        match self {
+            Self::Bool(_) => Narrow::Bool,
+            Self::I8(_) => Narrow::I8,
+            Self::I16(_) => Narrow::I16,
+            Self::I32(_) => Narrow::I32,
+            Self::F32(_) => Narrow::F32,
+            Self::F64(_) => Narrow::F64,
+        }
+    }
+
+    fn len(&self) -> usize {
+        match self {
+            Self::Bool(v) => v.len(),
+            Self::I8(v) => v.len(),
+            Self::I16(v) => v.len(),
+            Self::I32(v) => v.len(),
+            Self::F32(v) => v.len(),
+            Self::F64(v) => v.len(),
+        }
+    }
+
+    /// `v` must be representable in this storage.
+    #[inline]
+    fn push(&mut self, v: f64) {
+        match self {
+            Self::Bool(b) => b.push(v != 0.0),
+            Self::I8(b) => b.push(v as i8),
+            Self::I16(b) => b.push(v as i16),
+            Self::I32(b) => b.push(v as i32),
+            Self::F32(b) => b.push(v as f32),
+            Self::F64(b) => b.push(v),
+        }
+    }
+
+    /// Move every stored value into `kind` storage. Statistics only widen, so
+    /// the values seen so far always fit the new storage exactly.
+    fn convert(&mut self, kind: Narrow, capacity: usize) {
+        let mut out = NarrowValues::new(kind, capacity.max(self.len()));
+        match std::mem::replace(self, NarrowValues::I8(Vec::new())) {
+            Self::Bool(b) => b.iter().for_each(|v| out.push(v as u8 as f64)),
+            Self::I8(b) => b.into_iter().for_each(|v| out.push(v as f64)),
+            Self::I16(b) => b.into_iter().for_each(|v| out.push(v as f64)),
+            Self::I32(b) => b.into_iter().for_each(|v| out.push(v as f64)),
+            Self::F32(b) => b.into_iter().for_each(|v| out.push(v as f64)),
+            Self::F64(b) => b.into_iter().for_each(|v| out.push(v)),
+        }
+        *self = out;
+    }
+}
+
+/// Running statistics of the non-null values of a column.
+struct NarrowStats {
+    any: bool,
+    fraction: bool,
+    min: f64,
+    max: f64,
+}
+
+impl NarrowStats {
+    fn new() -> Self {
+        Self {
+            any: false,
+            fraction: false,
+            min: f64::MAX,
+            max: f64::MIN,
+        }
+    }
+
+    #[inline]
+    fn observe(&mut self, v: f64) {
+        self.any = true;
+        // NaN and infinities count as fractional, as in `compress_df`.
+        if v.fract() != 0.0 {
+            self.fraction = true;
+        }
+        if v < self.min {
+            self.min = v;
+        }
+        if v > self.max {
+            self.max = v;
+        }
+    }
+
+    /// The dtype `compress_df` picks for these values, with standard bounds.
+    fn target(&self, float32: bool) -> Narrow {
+        if self.fraction {
+            return if float32 { Narrow::F32 } else { Narrow::F64 };
+        }
+        if !self.any || (self.min >= 0.0 && self.max <= 1.0) {
+            Narrow::Bool
+        } else if self.min >= i8::MIN as f64 && self.max <= i8::MAX as f64 {
+            Narrow::I8
+        } else if self.min >= i16::MIN as f64 && self.max <= i16::MAX as f64 {
+            Narrow::I16
+        } else if self.min >= i32::MIN as f64 && self.max <= i32::MAX as f64 {
+            Narrow::I32
+        } else {
+            Narrow::F64
+        }
+    }
+}
+
+/// Float, integer and boolean columns, stored in the narrowest dtype their
+/// values so far allow and widened when a batch needs it.
+struct NarrowSink {
+    name: PlSmallStr,
+    source: DataType,
+    capacity: usize,
+    stats: NarrowStats,
+    values: NarrowValues,
+    validity: MutableBitmap,
+    nulls: usize,
+}
+
+impl NarrowSink {
+    fn new(name: PlSmallStr, source: DataType, capacity: usize) -> Self {
+        Self {
+            name,
+            source,
+            capacity,
+            stats: NarrowStats::new(),
+            values: NarrowValues::new(Narrow::Bool, capacity),
+            validity: MutableBitmap::with_capacity(capacity),
+            nulls: 0,
+        }
+    }
+}
+
+impl ColumnSink for NarrowSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        let values = series.cast(&DataType::Float64)?;
+        let ca = values.f64()?;
+        for v in ca.into_iter().flatten() {
+            self.stats.observe(v);
+        }
+        let target = self.stats.target(self.source == DataType::Float32);
+        if target != self.values.kind() {
+            self.values.convert(target, self.capacity);
+        }
+        for v in ca.into_iter() {
+            self.values.push(v.unwrap_or(0.0));
+            self.validity.push(v.is_some());
+        }
+        self.nulls += ca.null_count();
+        Ok(())
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        let Self {
+            name,
+            source,
+            values,
+            validity,
+            nulls,
+            ..
+        } = *self;
+        if values.len() == 0 {
+            return Ok(Series::new_empty(name, &source));
+        }
+        fn build<T: PolarsNumericType>(
+            name: PlSmallStr,
+            values: Vec<T::Native>,
+            validity: &MutableBitmap,
+            nulls: usize,
+        ) -> Series {
+            if nulls == 0 {
+                ChunkedArray::<T>::from_vec(name, values).into_series()
+            } else {
+                let iter = values
+                    .into_iter()
+                    .zip(validity.iter())
+                    .map(|(v, valid)| valid.then_some(v));
+                ChunkedArray::<T>::from_iter_options(name, iter).into_series()
+            }
+        }
+        Ok(match values {
+            NarrowValues::Bool(b) => {
+                let iter = b
+                    .iter()
+                    .zip(validity.iter())
+                    .map(|(v, valid)| valid.then_some(v));
+                BooleanChunked::from_iter_options(name, iter).into_series()
+            }
+            NarrowValues::I8(v) => build::<Int8Type>(name, v, &validity, nulls),
+            NarrowValues::I16(v) => build::<Int16Type>(name, v, &validity, nulls),
+            NarrowValues::I32(v) => build::<Int32Type>(name, v, &validity, nulls),
+            NarrowValues::F32(v) => build::<Float32Type>(name, v, &validity, nulls),
+            NarrowValues::F64(v) => build::<Float64Type>(name, v, &validity, nulls),
+        })
+    }
+}
+
+/// Datetime columns that become Date when every value is at midnight.
+struct MidnightSink {
+    inner: Box<dyn ColumnSink>,
+    unit: TimeUnit,
+    all_midnight: bool,
+}
+
+impl ColumnSink for MidnightSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        if self.all_midnight {
+            const DAY_MS: i64 = 86_400_000;
+            let per_ms = match self.unit {
+                TimeUnit::Milliseconds => 1,
+                TimeUnit::Microseconds => 1_000,
+                TimeUnit::Nanoseconds => 1_000_000,
+            };
+            self.all_midnight = series
+                .datetime()?
+                .phys
+                .iter()
+                .flatten()
+                .all(|v| (v / per_ms) % DAY_MS == 0);
+        }
+        self.inner.push(series)
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        let series = self.inner.finish()?;
+        if self.all_midnight {
+            series.cast(&DataType::Date)
+        } else {
+            Ok(series)
+        }
+    }
+}
+
+/// String columns that become numeric when every value parses as a number.
+struct ParseSink {
+    inner: Box<dyn ColumnSink>,
+    parses: bool,
+    compress_numeric: bool,
+    capacity: usize,
+}
+
+impl ColumnSink for ParseSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        if self.parses {
+            self.parses = series.str()?.into_iter().flatten().all(|s| {
+                let t = s.trim();
+                t.is_empty() || t.parse::<f64>().is_ok()
+            });
+        }
+        self.inner.push(series)
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        let series = self.inner.finish()?;
+        if !self.parses {
+            return Ok(series);
+        }
+        let parsed: Float64Chunked = series
+            .str()?
+            .into_iter()
+            .map(|s| s.and_then(|s| s.trim().parse::<f64>().ok()))
+            .collect();
+        let parsed = parsed.with_name(series.name().clone()).into_series();
+        // Blank strings parse to nulls, which may leave nothing but nulls.
+        if parsed.len() > 0 && parsed.null_count() == parsed.len() {
+            return Ok(Series::full_null(
+                parsed.name().clone(),
+                parsed.len(),
+                &DataType::Boolean,
+            ));
+        }
+        if !self.compress_numeric {
+            return Ok(parsed);
+        }
+        let mut numeric = Box::new(NarrowSink::new(
+            parsed.name().clone(),
+            DataType::Float64,
+            self.capacity,
+        ));
+        numeric.push(&parsed)?;
+        numeric.finish()
+    }
+}
+
+/// Outermost compressing sink: a column with only nulls becomes Boolean.
+struct AllNullSink {
+    inner: Box<dyn ColumnSink>,
+    len: usize,
+    nulls: usize,
+}
+
+impl ColumnSink for AllNullSink {
+    fn push(&mut self, series: &Series) -> PolarsResult<()> {
+        self.len += series.len();
+        self.nulls += series.null_count();
+        self.inner.push(series)
+    }
+
+    fn finish(self: Box<Self>) -> PolarsResult<Series> {
+        let series = self.inner.finish()?;
+        if self.len > 0 && self.nulls == self.len {
+            Ok(Series::full_null(
+                series.name().clone(),
+                self.len,
+                &DataType::Boolean,
+            ))
+        } else {
+            Ok(series)
+        }
+    }
+}
+
+fn compress_sink(
+    series: &Series,
+    capacity: usize,
+    opts: &CompressOptionsLite,
+) -> Box<dyn ColumnSink> {
+    let name = series.name().clone();
+    let dtype = series.dtype();
+    let inner: Box<dyn ColumnSink> = match dtype {
+        DataType::Float32
+        | DataType::Float64
+        | DataType::Int8
+        | DataType::Int16
+        | DataType::Int32
+        | DataType::Int64
+        | DataType::UInt8
+        | DataType::UInt16
+        | DataType::UInt32
+        | DataType::UInt64
+        | DataType::Boolean
+            if opts.compress_numeric =>
+        {
+            Box::new(NarrowSink::new(name, dtype.clone(), capacity))
+        }
+        DataType::Datetime(unit, _) if opts.datetime_to_date => Box::new(MidnightSink {
+            inner: column_sink(series, capacity),
+            unit: *unit,
+            all_midnight: true,
+        }),
+        DataType::String if opts.string_to_numeric => Box::new(ParseSink {
+            inner: column_sink(series, capacity),
+            parses: true,
+            compress_numeric: opts.compress_numeric,
+            capacity,
+        }),
+        _ => column_sink(series, capacity),
+    };
+    Box::new(AllNullSink {
+        inner,
+        len: 0,
+        nulls: 0,
+    })
+}
+
+/// Capacity for a scan of `row_count` rows limited to `n_rows`. Filtered scans
+/// return 0: their result size is unknown and usually far below the file's.
+pub(crate) fn expected_rows(row_count: usize, n_rows: Option<usize>, filtered: bool) -> usize {
+    if filtered {
+        0
+    } else {
+        n_rows.map_or(row_count, |n| n.min(row_count))
+    }
+}
+
+/// Builds one DataFrame from batches that share a schema.
+pub(crate) struct FrameAssembler {
+    capacity: usize,
+    /// The first batch is held as is; a read that yields one batch is returned
+    /// without a copy.
+    first: Option<DataFrame>,
+    sinks: Vec<(DataType, Box<dyn ColumnSink>)>,
+    /// Frames without columns only carry a height.
+    empty: Option<DataFrame>,
+    compress: Option<CompressOptionsLite>,
+}
+
+impl FrameAssembler {
+    /// `capacity` is the expected total row count (0 when unknown, e.g. for a
+    /// filtered read); builders grow past it if needed.
+    pub(crate) fn new(capacity: usize) -> Self {
+        Self {
+            capacity,
+            first: None,
+            sinks: Vec::new(),
+            empty: None,
+            compress: None,
+        }
+    }
+
+    /// Compress columns while assembling them, with the result
+    /// `compress_df_if_enabled` gives for the assembled frame. `None` or
+    /// disabled options assemble batches unchanged.
+    pub(crate) fn with_compression(mut self, opts: Option<&CompressOptionsLite>) -> Self {
+        self.compress = opts.filter(|o| o.enabled).cloned();
+        self
+    }
+
+    pub(crate) fn push(&mut self, df: DataFrame) -> PolarsResult<()> {
+        read_profile::add_batch(df.height());
+        let _assembly = read_profile::span(ProfileStage::Assembly);
+        if df.width() == 0 {
+            match self.empty.as_mut() {
+                Some(acc) => {
+                    acc.vstack_mut(&df)?;
+                }
+                None => self.empty = Some(df),
+            }
+            return Ok(());
+        }
+        if self.sinks.is_empty() {
+            // A compressed read has no uncopied single-batch result.
+            if self.compress.is_some() {
+                self.init_sinks(&df, self.capacity.max(df.height()));
+            } else {
+                let Some(first) = self.first.take() else {
+                    self.first = Some(df);
+                    return Ok(());
+                };
+                self.init_sinks(&first, self.capacity.max(first.height() + df.height()));
+                self.append(&first)?;
+            }
+        }
+        self.append(&df)
+    }
+
+    fn init_sinks(&mut self, df: &DataFrame, capacity: usize) {
+        let compress = self.compress.as_ref();
+        self.sinks =
+            df.columns()
+                .iter()
+                .map(|c| {
+                    let s = c.as_materialized_series();
+                    let sink = match compress {
+                        Some(opts)
+                            if opts.cols.as_ref().map_or(true, |cols| {
+                                cols.iter().any(|n| n == s.name().as_str())
+                            }) =>
+                        {
+                            compress_sink(s, capacity, opts)
+                        }
+                        _ => column_sink(s, capacity),
+                    };
+                    (s.dtype().clone(), sink)
+                })
+                .collect();
+    }
+
+    fn append(&mut self, df: &DataFrame) -> PolarsResult<()> {
+        if df.width() != self.sinks.len() {
+            return Err(PolarsError::ShapeMismatch(
+                format!(
+                    "cannot assemble batch with {} columns into {} columns",
+                    df.width(),
+                    self.sinks.len()
+                )
+                .into(),
+            ));
+        }
+        for (column, (dtype, sink)) in df.columns().iter().zip(self.sinks.iter_mut()) {
+            if column.dtype() != dtype {
+                return Err(PolarsError::SchemaMismatch(
+                    format!(
+                        "column '{}' is {} in a later batch, expected {}",
+                        column.name(),
+                        column.dtype(),
+                        dtype
+                    )
+                    .into(),
+                ));
+            }
+            sink.push(column.as_materialized_series())?;
+        }
+        Ok(())
+    }
+
+    pub(crate) fn finish(self) -> PolarsResult<DataFrame> {
+        let _assembly = read_profile::span(ProfileStage::Assembly);
+        if self.sinks.is_empty() {
+            return Ok(self.first.or(self.empty).unwrap_or_else(DataFrame::empty));
+        }
+        let columns = self
+            .sinks
+            .into_iter()
+            .map(|(_, sink)| sink.finish().map(Column::from))
+            .collect::<PolarsResult<Vec<_>>>()?;
+        DataFrame::new_infer_height(columns)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_assembled_frame_matches_vstack_in_one_chunk() {
+        let df = df!(
+            "f" => [Some(1.5f64), None, Some(3.0), Some(4.0), None],
+            "i" => [1i32, 2, 3, 4, 5],
+            "s" => [Some("a"), Some("bb"), None, Some("a"), Some("a long string value")],
+            "b" => [true, false, true, true, false],
+            // First null only in a later batch.
+            "late" => [Some(1i64), Some(2), Some(3), None, Some(5)],
+        )
+        .unwrap()
+        .lazy()
+        .with_columns([
+            col("i").cast(DataType::Date).alias("d"),
+            as_struct(vec![col("i"), col("b")]).alias("st"),
+        ])
+        .collect()
+        .unwrap();
+        let batches = [df.slice(0, 2), df.slice(2, 1), df.slice(3, 2)];
+
+        let mut assembler = FrameAssembler::new(df.height());
+        for batch in batches.iter().cloned() {
+            assembler.push(batch).unwrap();
+        }
+        let out = assembler.finish().unwrap();
+        assert_eq!(out.schema(), df.schema());
+        for (got, want) in out.columns().iter().zip(df.columns()) {
+            assert_eq!(got.n_chunks(), 1, "{}", got.name());
+            assert!(
+                got.as_materialized_series()
+                    .equals_missing(want.as_materialized_series()),
+                "{}",
+                got.name()
+            );
+        }
+
+        let mut single = FrameAssembler::new(0);
+        single.push(df.clone()).unwrap();
+        assert_eq!(single.finish().unwrap().height(), df.height());
+    }
+
+    #[test]
+    fn test_compressed_assembly_matches_compress_df() {
+        let day_ms = 86_400_000i64;
+        let df = df!(
+            // Widens from Boolean through Int8 and Int16 as batches arrive.
+            "widen" => [Some(0.0f64), Some(1.0), None, Some(-5.0), Some(300.0), Some(2.0)],
+            "frac" => [Some(1.0f64), Some(2.0), Some(3.0), Some(4.0), Some(5.0), Some(0.5)],
+            "f32" => [1.0f32, 2.0, 3.0, 4.0, 5.0, 6.0],
+            "big" => [1i64, 2, 3, 4, 5, 1 << 40],
+            "day" => [0i64, 1, 2, 3, 400, -30],
+            "nulls" => [None::<f64>, None, None, None, None, None],
+            "nums" => [Some(" 1"), Some("2.5"), None, Some(""), Some("4"), Some("5")],
+            "words" => ["1", "2", "3", "x", "5", "6"],
+            "blank" => ["", " ", "", "", "", ""],
+            "kept" => [0.0f64, 1.0, 0.0, 1.0, 0.0, 1.0],
+        )
+        .unwrap()
+        .lazy()
+        .with_columns([
+            (col("day") * lit(day_ms))
+                .cast(DataType::Datetime(TimeUnit::Milliseconds, None))
+                .alias("midnight"),
+            (col("day") * lit(day_ms) + lit(1))
+                .cast(DataType::Datetime(TimeUnit::Milliseconds, None))
+                .alias("instant"),
+        ])
+        .collect()
+        .unwrap();
+        let names: Vec<String> = df
+            .get_column_names()
+            .iter()
+            .filter(|n| n.as_str() != "kept")
+            .map(|n| n.to_string())
+            .collect();
+        let opts = CompressOptionsLite {
+            enabled: true,
+            cols: Some(names),
+            compress_numeric: true,
+            datetime_to_date: true,
+            string_to_numeric: true,
+        };
+        let want = crate::compress_df_if_enabled(&df, &opts).unwrap();
+
+        let mut assembler = FrameAssembler::new(df.height()).with_compression(Some(&opts));
+        for batch in [
+            df.slice(0, 2),
+            df.slice(2, 2),
+            df.slice(4, 1),
+            df.slice(5, 1),
+        ] {
+            assembler.push(batch).unwrap();
+        }
+        let out = assembler.finish().unwrap();
+        assert_eq!(out.schema(), want.schema());
+        assert_eq!(out.column("widen").unwrap().dtype(), &DataType::Int16);
+        assert_eq!(out.column("kept").unwrap().dtype(), &DataType::Float64);
+        for (got, want) in out.columns().iter().zip(want.columns()) {
+            assert_eq!(got.n_chunks(), 1, "{}", got.name());
+            assert!(
+                got.as_materialized_series()
+                    .equals_missing(want.as_materialized_series()),
+                "{}",
+                got.name()
+            );
+        }
+    }
+}
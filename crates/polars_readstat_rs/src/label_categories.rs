@@ -0,0 +1,217 @@
+//! Categorical output for value-labelled columns
+//! (`ScanOptions::value_labels_as_categorical`), shared by the Stata and SPSS readers.
+//!
+//! The labels of a label set are registered as categories once. Decoding then
+//! writes one `u32` code per row into a primitive builder instead of copying the
+//! label text into a string builder, and the finished codes become a
+//! `Categorical` column. The output is not an `Enum`: a value without a label is
+//! registered on first sight under its number's text, as
+//! `value_labels_as_strings` would print it, so no value is lost.
+//!
+//! Each label set gets its own categories, named after the set, rather than the
+//! global ones. Columns sharing a label set (in the schema, in every batch, and
+//! in other files with a set of that name) share one dtype, and unlabelled
+//! values only grow that set's categories, which are freed once no column uses
+//! them.
+
+use polars::prelude::*;
+use std::collections::HashMap;
+use std::sync::Arc;
+
+/// The value side of one label.
+pub(crate) enum LabelKey<'a> {
+    Num(f64),
+    Str(&'a str),
+}
+
+/// Categories and per-value codes for one label set.
+pub(crate) struct LabelCategories {
+    dtype: DataType,
+    mapping: Arc<CategoricalMapping>,
+    num_codes: HashMap<u64, u32>,
+    str_codes: HashMap<String, u32>,
+}
+
+impl std::fmt::Debug for LabelCategories {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("LabelCategories")
+            .field("dtype", &self.dtype)
+            .field("labels", &self.num_codes.len() + self.str_codes.len())
+            .finish()
+    }
+}
+
+/// Namespace of the per-label-set categories.
+const CATEGORIES_NAMESPACE: &str = "polars_readstat";
+
+impl LabelCategories {
+    /// Categories of the label set `name`. Labels are registered in value order
+    /// (numbers ascending, then strings); values sharing a label share its code.
+    pub(crate) fn new<'a>(
+        name: &str,
+        entries: impl IntoIterator<Item = (LabelKey<'a>, &'a str)>,
+    ) -> Self {
+        let mut entries: Vec<(LabelKey<'a>, &'a str)> = entries.into_iter().collect();
+        entries.sort_by(|(a, _), (b, _)| match (a, b) {
+            (LabelKey::Num(a), LabelKey::Num(b)) => a.total_cmp(b),
+            (LabelKey::Str(a), LabelKey::Str(b)) => a.cmp(b),
+            (LabelKey::Num(_), LabelKey::Str(_)) => std::cmp::Ordering::Less,
+            (LabelKey::Str(_), LabelKey::Num(_)) => std::cmp::Ordering::Greater,
+        });
+
+        let categories = Categories::new(
+            name.into(),
+            CATEGORIES_NAMESPACE.into(),
+            CategoricalPhysical::U32,
+        );
+        let mapping = categories.mapping();
+        let mut num_codes = HashMap::new();
+        let mut str_codes = HashMap::new();
+        for (key, label) in entries {
+            let code = insert_category(&mapping, label);
+            match key {
+                LabelKey::Num(v) => {
+                    num_codes.insert(v.to_bits(), code);
+                }
+                LabelKey::Str(s) => {
+                    str_codes.insert(s.to_string(), code);
+                }
+            }
+        }
+        Self {
+            dtype: DataType::from_categories(categories),
+            mapping,
+            num_codes,
+            str_codes,
+        }
+    }
+
+    pub(crate) fn dtype(&self) -> &DataType {
+        &self.dtype
+    }
+
+    #[inline]
+    pub(crate) fn code_f64(&self, v: f64) -> Option<u32> {
+        self.num_codes.get(&v.to_bits()).copied()
+    }
+
+    #[inline]
+    pub(crate) fn code_bits(&self, bits: u64) -> Option<u32> {
+        self.num_codes.get(&bits).copied()
+    }
+
+    #[inline]
+    pub(crate) fn code_str(&self, v: &str) -> Option<u32> {
+        self.str_codes.get(v).copied()
+    }
+}
+
+fn insert_category(mapping: &CategoricalMapping, text: &str) -> u32 {
+    mapping
+        .insert_cat(text)
+        .expect("u32 categories have room for a label set")
+}
+
+/// Column builder for a labelled column read as codes. Values without a label
+/// get the code of their number's text.
+pub(crate) struct CategoricalBuilder {
+    codes: PrimitiveChunkedBuilder<UInt32Type>,
+    dtype: DataType,
+    /// The last unlabelled value and its code; runs of one value are common.
+    last_unlabelled: Option<(u64, u32)>,
+}
+
+impl CategoricalBuilder {
+    pub(crate) fn new(name: PlSmallStr, capacity: usize, labels: &LabelCategories) -> Self {
+        Self {
+            codes: PrimitiveChunkedBuilder::new(name, capacity),
+            dtype: labels.dtype.clone(),
+            last_unlabelled: None,
+        }
+    }
+
+    /// Append the code of `v` (null for a missing value).
+    #[inline]
+    pub(crate) fn append_f64(&mut self, v: Option<f64>, labels: &LabelCategories) {
+        match v {
+            Some(v) => self.append_bits(v.to_bits(), labels),
+            None => self.codes.append_null(),
+        }
+    }
+
+    /// Append the code of the number with bit pattern `bits`.
+    #[inline]
+    pub(crate) fn append_bits(&mut self, bits: u64, labels: &LabelCategories) {
+        let code = match labels.code_bits(bits) {
+            Some(code) => code,
+            None => match self.last_unlabelled {
+                Some((last, code)) if last == bits => code,
+                _ => {
+                    let text = f64::from_bits(bits).to_string();
+                    let code = insert_category(&labels.mapping, &text);
+                    self.last_unlabelled = Some((bits, code));
+                    code
+                }
+            },
+        };
+        self.codes.append_value(code);
+    }
+
+    #[inline]
+    pub(crate) fn append_null(&mut self) {
+        self.codes.append_null();
+    }
+
+    pub(crate) fn finish(self) -> Series {
+        self.codes
+            .finish()
+            .into_series()
+            .cast(&self.dtype)
+            .expect("label codes index their categories")
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_label_categories_codes_and_output() {
+        let labels = LabelCategories::new(
+            "test_codes",
+            [
+                (LabelKey::Num(2.0), "two"),
+                (LabelKey::Num(1.0), "one"),
+                (LabelKey::Num(3.0), "one"),
+            ],
+        );
+        assert_eq!(labels.code_f64(1.0), labels.code_f64(3.0));
+        assert_ne!(labels.code_f64(1.0), labels.code_f64(2.0));
+        assert_eq!(labels.code_f64(4.0), None);
+        // A set of the same name shares the dtype; another set gets its own.
+        let same = LabelCategories::new("test_codes", [(LabelKey::Num(1.0), "one")]);
+        let other = LabelCategories::new("test_other", [(LabelKey::Num(1.0), "one")]);
+        assert_eq!(same.dtype(), labels.dtype());
+        assert_ne!(other.dtype(), labels.dtype());
+
+        let mut b = CategoricalBuilder::new("x".into(), 6, &labels);
+        for v in [Some(1.0), Some(2.0), Some(4.0), Some(4.0), None, Some(3.0)] {
+            b.append_f64(v, &labels);
+        }
+        let s = b.finish();
+        assert_eq!(s.dtype(), labels.dtype());
+        let text = s.cast(&DataType::String).unwrap();
+        let text: Vec<Option<&str>> = text.str().unwrap().into_iter().collect();
+        assert_eq!(
+            text,
+            vec![
+                Some("one"),
+                Some("two"),
+                Some("4"),
+                Some("4"),
+                None,
+                Some("one")
+            ]
+        );
+    }
+}
@@ -5,11 +5,28 @@
 //! all compression types (None, RLE, RDC).
 
 pub mod metadata_df;
+pub(crate) mod frame_assembly;
+pub(crate) mod label_categories;
+pub(crate) mod mem_budget;
+pub(crate) mod metadata_cache;
+pub(crate) mod mmap_source;
+mod multi_scan;
+pub(crate) mod null_indicator;
+pub(crate) mod numeric_column;
+pub(crate) mod range_source;
+pub mod read_profile;
 mod readstat_stream;
+pub mod row_filter;
+mod sample;
 pub mod sas;
 pub(crate) mod scan_prefetch;
+pub(crate) mod string_intern;
 pub mod spss;
 pub mod stata;
+pub mod transcode;
+pub(crate) mod transpose;
+pub(crate) mod worker_pool;
+mod zone_map;
 
 pub use sas::catalog::{read_sas7bcat, CatalogKey, CatalogMap};
 pub use sas::arrow_output as sas_arrow_output;
@@ -35,11 +52,23 @@ pub use sas::reader;
 
 pub use sas::{Compression, Endian, Format, Platform, Header as SasHeader, Metadata as SasMetadata};
 pub use sas::{Error, Result, Sas7bdatReader};
+pub use sas::{DataPageKind, PageIndexEntry, SasPageIndex};
 pub use sas::metadata_json_from_meta as sas_metadata_json_from_meta;
 pub use sas::{SasValueLabelKey, SasValueLabelMap, SasValueLabels, SasVariableLabels, SasWriter};
-pub use sas::{read_xpt_metadata, XptMetadata, XptVariableFormats, XptVariableLabels, XptStorageWidths, XptWriter};
+pub use sas::{read_xpt_metadata, read_xpt_metadata_cached, XptMetadata, XptVariableFormats, XptVariableLabels, XptStorageWidths, XptWriter};
 
+pub use multi_scan::{
+    readstat_batch_iter_many, readstat_glob, readstat_scan_glob, readstat_scan_many,
+    MultiScanOptions,
+};
+pub use read_profile::{ProfileStage, ReadProfile, ReadProfiler};
 pub use readstat_stream::{readstat_batch_iter, ReadstatBatchIter, ReadstatBatchStream};
+pub use metadata_cache::clear_metadata_cache;
+pub use row_filter::{FilterOp, FilterValue, RowFilter};
+pub use sample::{SampleMode, SampleOptions, SampleSize, DEFAULT_SAMPLE_BLOCK_ROWS};
+pub use transcode::{readstat_sink_ipc, readstat_sink_parquet, TranscodeOptions};
+pub use worker_pool::{set_worker_pool, set_worker_threads, worker_threads, POOL_THREADS_ENV};
+pub use zone_map::{readstat_build_zone_map, ZoneMap, DEFAULT_ZONE_ROWS};
 
 #[cfg(feature = "row_reader")]
 pub use sas::row_reader::{sas_row_readers, SasColumnInfo, SasColumnKind, SasRowReader};
@@ -51,9 +80,9 @@ pub use spss::{
 };
 pub use spss::metadata_json_from_meta as spss_metadata_json_from_meta;
 pub use spss::{
-    SpssValueLabelKey, SpssValueLabelMap, SpssValueLabels, SpssVariableAlignments,
-    SpssVariableDisplayWidths, SpssVariableFormat, SpssVariableFormats, SpssVariableLabels,
-    SpssVariableMeasures, SpssWriteColumn, SpssWriteSchema, SpssWriter,
+    SpssCompression, SpssValueLabelKey, SpssValueLabelMap, SpssValueLabels,
+    SpssVariableAlignments, SpssVariableDisplayWidths, SpssVariableFormat, SpssVariableFormats,
+    SpssVariableLabels, SpssVariableMeasures, SpssWriteColumn, SpssWriteSchema, SpssWriter,
 };
 pub use spss::{
     metadata_json_por, metadata_por, read_por, scan_por, write_por, PorMetadata, PorVariable, PorWriteOptions,
@@ -138,9 +167,43 @@ pub struct ScanOptions {
     pub missing_string_as_null: Option<bool>,
     pub informative_nulls: Option<InformativeNullOpts>,
     pub value_labels_as_strings: Option<bool>,
+    /// With `value_labels_as_strings`, read labelled Stata/SPSS columns as
+    /// `Categorical` codes instead of `String` (default: false). Each label set
+    /// has its own categories, registered in value order; a value with no label
+    /// reads as its number's text, as with `value_labels_as_strings` alone, and
+    /// is added to that label set's categories only.
+    pub value_labels_as_categorical: Option<bool>,
     pub preserve_order: Option<bool>,
     pub row_index_name: Option<String>,
     pub compress_opts: CompressOptionsLite,
+    /// Rows failing this filter are dropped by the reader before decoding. Terms the
+    /// reader cannot evaluate are ignored, so callers must still apply their full
+    /// predicate to the result.
+    pub row_filter: Option<RowFilter>,
+    /// Read through a memory map of the file instead of buffered file handles
+    /// (default: false). Workers share one mapping and sas7bdat pages are decoded in
+    /// place. Best for local, page-cache-warm files; the file must not be truncated
+    /// while it is being read.
+    pub use_mmap: Option<bool>,
+    /// Read through positioned range reads that keep about this many bytes in
+    /// flight ahead of decoding (default: off). For storage where each read is a
+    /// round trip (NFS, network volumes, FUSE-mounted object stores); a few tens of
+    /// MiB is a good start. Ignored when `use_mmap` maps the file.
+    pub read_ahead: Option<usize>,
+    /// Upper bound, in bytes, on decoded data held by a streaming read
+    /// (`readstat_batch_iter`, `ReadstatBatchStream`, the Arrow stream exports).
+    /// Batch sizes are derived from the estimated row width so the pipeline fits,
+    /// and the consumer hand-off blocks on buffered bytes. `chunk_size`, when also
+    /// set, still caps the batch size. Default: unbounded.
+    pub memory_budget: Option<usize>,
+    /// Collect per-stage timings, byte counts and thread utilization for the reads
+    /// made with these options into this profiler (default: off). Read them with
+    /// [`ReadProfiler::report`] once the read is done.
+    pub profile: Option<ReadProfiler>,
+    /// Read a random sample of the rows instead of all of them (default: off).
+    /// Rows outside the sample are skipped at the source where the format allows;
+    /// see [`SampleOptions`] for the block and row modes. Not supported for `.por`.
+    pub sample: Option<SampleOptions>,
 }
 
 impl Default for ScanOptions {
@@ -151,9 +214,16 @@ impl Default for ScanOptions {
             missing_string_as_null: Some(true),
             informative_nulls: None,
             value_labels_as_strings: Some(true),
+            value_labels_as_categorical: Some(false),
             preserve_order: Some(false),
             row_index_name: None,
             compress_opts: CompressOptionsLite::default(),
+            row_filter: None,
+            use_mmap: Some(false),
+            read_ahead: None,
+            memory_budget: None,
+            profile: None,
+            sample: None,
         }
     }
 }
@@ -437,6 +507,8 @@ pub enum ReadStatFormat {
     SasXpt,
     Stata,
     Spss,
+    /// SPSS portable (`.por`).
+    Por,
 }
 
 fn detect_format(path: &Path) -> Option<ReadStatFormat> {
@@ -449,11 +521,16 @@ fn detect_format(path: &Path) -> Option<ReadStatFormat> {
         "xpt" | "xpt5" | "xpt8" => Some(ReadStatFormat::SasXpt),
         "dta" => Some(ReadStatFormat::Stata),
         "sav" | "zsav" => Some(ReadStatFormat::Spss),
+        "por" => Some(ReadStatFormat::Por),
         _ => None,
     }
 }
 
 /// Format-agnostic scan that dispatches by file extension.
+///
+/// If the file has a zone-map sidecar (see [`readstat_build_zone_map`]) that is
+/// still valid, filtered scans read only the row ranges whose statistics can
+/// pass the predicate.
 pub fn readstat_scan(
     path: impl AsRef<Path>,
     opts: Option<ScanOptions>,
@@ -465,12 +542,44 @@ pub fn readstat_scan(
         polars::prelude::PolarsError::ComputeError("unknown file extension".into())
     })?;
 
-    match format {
-        ReadStatFormat::Sas => sas::scan_sas7bdat(path, opts),
-        ReadStatFormat::SasXpt => sas::xpt::scan_xpt(path, opts),
-        ReadStatFormat::Stata => stata::scan_dta(path, opts),
-        ReadStatFormat::Spss => spss::scan_sav(path, opts),
+    if opts.sample.is_some() {
+        return sample::scan_sample(path, opts, format);
     }
+    match zone_map::load_sidecar(path, &opts) {
+        Some(zones) => zone_map::scan_with_zone_map(path, opts, format, zones),
+        None => format_scan(path, opts, format),
+    }
+}
+
+fn format_scan(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+) -> polars::prelude::PolarsResult<polars::prelude::LazyFrame> {
+    let scan = format_anonymous_scan(path, opts, format)?;
+    polars::prelude::LazyFrame::anonymous_scan(scan, Default::default())
+}
+
+/// The format's own scan of `path`, for scans that wrap it.
+pub(crate) fn format_anonymous_scan(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+) -> polars::prelude::PolarsResult<std::sync::Arc<dyn polars::prelude::AnonymousScan>> {
+    use polars::prelude::AnonymousScan;
+    use std::sync::Arc;
+
+    let path = path.to_path_buf();
+    let scan: Arc<dyn AnonymousScan> = match format {
+        ReadStatFormat::Sas => Arc::new(sas::polars_output::SasScan::from_options(path, opts)),
+        ReadStatFormat::SasXpt => Arc::new(sas::xpt::XptScan::new(path, &opts)?),
+        ReadStatFormat::Stata => {
+            Arc::new(stata::polars_output::StataScan::from_options(path, opts))
+        }
+        ReadStatFormat::Spss => Arc::new(spss::polars_output::SpssScan::from_options(path, opts)),
+        ReadStatFormat::Por => Arc::new(spss::por::PorScan::new(path, &opts)?),
+    };
+    Ok(scan)
 }
 
 /// Format-agnostic schema (delegates to AnonymousScan).
@@ -498,5 +607,6 @@ pub fn readstat_metadata_json(
         }
         ReadStatFormat::Stata => stata::metadata_json(path).map_err(|e| e.to_string()),
         ReadStatFormat::Spss => spss::metadata_json(path).map_err(|e| e.to_string()),
+        ReadStatFormat::Por => spss::metadata_json_por(path).map_err(|e| e.to_string()),
     }
 }
@@ -0,0 +1,232 @@
+//! Byte budget for the streaming outputs (`ScanOptions::memory_budget`).
+//!
+//! Two mechanisms keep a stream within its budget. Half of it goes to the reader
+//! pipeline: the batch size is derived from the decoded width of one row, so that
+//! every batch the workers and their (count-bounded) channels can hold at once
+//! fits. The other half bounds the hand-off to the consumer, which applies
+//! `ByteBudget` backpressure on buffered bytes instead of on a count of batches.
+
+use crate::ReadStatFormat;
+use polars::prelude::*;
+use std::path::Path;
+use std::sync::{Condvar, Mutex};
+
+/// Decoded bytes charged for a strL cell, whose length is unknown until read.
+const STRL_ESTIMATE: usize = 256;
+/// Per-cell overhead of a polars string view.
+const STRING_VIEW_BYTES: usize = 16;
+/// Batches alive at once per worker: one being decoded plus up to four waiting in
+/// the deepest internal channel.
+const BATCHES_PER_THREAD: usize = 5;
+/// Batches alive regardless of the thread count (ordering buffers, the batch
+/// being handed over).
+const BATCHES_FIXED: usize = 4;
+/// Smallest budget a stream is planned with. Below it batches shrink to a few
+/// rows and per-batch overhead outweighs the memory saved.
+pub(crate) const MIN_STREAM_BUDGET: usize = 64 * 1024;
+
+/// Split of a budget between the reader pipeline and the hand-off stage.
+fn split_budget(budget: usize) -> (usize, usize) {
+    let pipeline = budget / 2;
+    (pipeline, budget - pipeline)
+}
+
+/// Rows per batch such that every batch the pipeline can hold fits in `budget`.
+pub(crate) fn chunk_size_for_budget(budget: usize, row_bytes: usize, threads: usize) -> usize {
+    let in_flight = threads.max(1) * BATCHES_PER_THREAD + BATCHES_FIXED;
+    (budget / row_bytes.max(1) / in_flight).max(1)
+}
+
+/// Batch size and hand-off budget for a stream read with `memory_budget`. The
+/// batch size is the budget-derived size, capped by an explicitly requested
+/// `chunk_size`. Without a budget the request is returned unchanged; budgets
+/// below [`MIN_STREAM_BUDGET`] are raised to it.
+pub(crate) fn plan_stream(
+    path: &Path,
+    format: ReadStatFormat,
+    columns: Option<&[String]>,
+    memory_budget: Option<usize>,
+    threads: Option<usize>,
+    chunk_size: Option<usize>,
+) -> PolarsResult<(Option<usize>, Option<usize>)> {
+    let Some(budget) = memory_budget else {
+        return Ok((chunk_size, None));
+    };
+    let (pipeline, handoff) = split_budget(budget.max(MIN_STREAM_BUDGET));
+    let row_bytes = estimated_row_bytes(path, format, columns)?;
+    let threads = threads.unwrap_or_else(crate::default_thread_count);
+    let derived = chunk_size_for_budget(pipeline, row_bytes, threads);
+    let chunk_size = chunk_size.map_or(derived, |requested| requested.min(derived));
+    Ok((Some(chunk_size), Some(handoff)))
+}
+
+/// Upper-bound estimate of the decoded size of one row, over `columns` (all
+/// columns when `None`).
+pub(crate) fn estimated_row_bytes(
+    path: &Path,
+    format: ReadStatFormat,
+    columns: Option<&[String]>,
+) -> PolarsResult<usize> {
+    let to_polars = |e: String| PolarsError::ComputeError(e.into());
+    let selected = |name: &str| columns.map_or(true, |cols| cols.iter().any(|c| c == name));
+    let bytes = match format {
+        ReadStatFormat::Sas => {
+            let reader =
+                crate::Sas7bdatReader::open_cached(path).map_err(|e| to_polars(e.to_string()))?;
+            reader
+                .metadata()
+                .columns
+                .iter()
+                .filter(|c| selected(&c.name))
+                .map(|c| match c.col_type {
+                    crate::types::ColumnType::Numeric => 8,
+                    crate::types::ColumnType::Character => c.length + STRING_VIEW_BYTES,
+                })
+                .sum()
+        }
+        ReadStatFormat::SasXpt => crate::sas::xpt::read_xpt_metadata_cached(path)?
+            .columns
+            .iter()
+            .filter(|c| selected(&c.name))
+            .map(|c| match c.col_type {
+                crate::sas::xpt::XptColumnType::Numeric => 8,
+                crate::sas::xpt::XptColumnType::Character => c.storage_width + STRING_VIEW_BYTES,
+            })
+            .sum(),
+        ReadStatFormat::Stata => {
+            use crate::stata::types::{NumericType, VarType};
+            let reader =
+                crate::StataReader::open_cached(path).map_err(|e| to_polars(e.to_string()))?;
+            reader
+                .metadata()
+                .variables
+                .iter()
+                .filter(|v| selected(&v.name))
+                .map(|v| match v.var_type {
+                    VarType::Numeric(NumericType::Byte) => 1,
+                    VarType::Numeric(NumericType::Int) => 2,
+                    VarType::Numeric(NumericType::Long | NumericType::Float) => 4,
+                    VarType::Numeric(NumericType::Double) => 8,
+                    VarType::Str(len) => len as usize + STRING_VIEW_BYTES,
+                    VarType::StrL => STRL_ESTIMATE + STRING_VIEW_BYTES,
+                })
+                .sum()
+        }
+        ReadStatFormat::Spss => {
+            use crate::spss::types::VarType;
+            let reader =
+                crate::SpssReader::open_cached(path).map_err(|e| to_polars(e.to_string()))?;
+            reader
+                .metadata()
+                .variables
+                .iter()
+                .filter(|v| selected(&v.name))
+                .map(|v| match v.var_type {
+                    VarType::Numeric => 8,
+                    VarType::Str => v.string_len + STRING_VIEW_BYTES,
+                })
+                .sum()
+        }
+        ReadStatFormat::Por => crate::spss::por::por_header_cached(path)
+            .map_err(|e| to_polars(e.to_string()))?
+            .meta
+            .variables
+            .iter()
+            .filter(|v| selected(&v.name))
+            .map(|v| {
+                if v.width > 0 {
+                    v.width as usize + STRING_VIEW_BYTES
+                } else {
+                    8
+                }
+            })
+            .sum(),
+    };
+    Ok(bytes)
+}
+
+/// Counting semaphore: over bytes for memory budgets, over reader threads for
+/// multi-file scans.
+pub(crate) struct ByteBudget {
+    limit: usize,
+    state: Mutex<BudgetState>,
+    freed: Condvar,
+}
+
+struct BudgetState {
+    used: usize,
+    closed: bool,
+}
+
+impl ByteBudget {
+    pub(crate) fn new(limit: usize) -> Self {
+        Self {
+            limit,
+            state: Mutex::new(BudgetState {
+                used: 0,
+                closed: false,
+            }),
+            freed: Condvar::new(),
+        }
+    }
+
+    /// Block until `bytes` fit in the budget, then charge them. An item is always
+    /// admitted when nothing is charged, so a single batch larger than the whole
+    /// budget still makes progress. Returns `false` once the budget is closed.
+    pub(crate) fn acquire(&self, bytes: usize) -> bool {
+        let mut state = self.state.lock().unwrap();
+        while !state.closed && state.used > 0 && state.used + bytes > self.limit {
+            state = self.freed.wait(state).unwrap();
+        }
+        if state.closed {
+            return false;
+        }
+        state.used += bytes;
+        true
+    }
+
+    pub(crate) fn release(&self, bytes: usize) {
+        let mut state = self.state.lock().unwrap();
+        state.used = state.used.saturating_sub(bytes);
+        self.freed.notify_all();
+    }
+
+    /// Wake every waiter and refuse further charges (the consumer went away).
+    pub(crate) fn close(&self) {
+        self.state.lock().unwrap().closed = true;
+        self.freed.notify_all();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+
+    #[test]
+    fn test_byte_budget_blocks_until_released() {
+        let budget = Arc::new(ByteBudget::new(100));
+        assert!(budget.acquire(60));
+        let waiter = {
+            let budget = budget.clone();
+            std::thread::spawn(move || budget.acquire(60))
+        };
+        std::thread::sleep(std::time::Duration::from_millis(20));
+        assert!(!waiter.is_finished());
+        budget.release(60);
+        assert!(waiter.join().unwrap());
+
+        // Oversized items are admitted when nothing else is held.
+        budget.release(60);
+        assert!(budget.acquire(1_000));
+        budget.close();
+        assert!(!budget.acquire(1));
+    }
+
+    #[test]
+    fn test_chunk_size_for_budget() {
+        // 1 MiB over 1 KiB rows and (1 * 5 + 4) batches in flight.
+        assert_eq!(chunk_size_for_budget(1 << 20, 1024, 1), 113);
+        assert_eq!(chunk_size_for_budget(10, 1024, 8), 1);
+    }
+}
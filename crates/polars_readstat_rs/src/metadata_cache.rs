@@ -0,0 +1,143 @@
+//! Process-wide cache of parsed file headers and metadata.
+//!
+//! Planning one lazy query asks for the schema, the metadata and then the scan,
+//! and every one of those used to reopen the file and parse its header and
+//! dictionary again. Readers opened through [`cached`] are shared as `Arc`s and
+//! reused while the file's size and modification time are unchanged, so a
+//! repeat costs one `stat`. A changed file is simply parsed again.
+
+use std::any::{Any, TypeId};
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex, OnceLock};
+
+/// Entries kept at most; the least recently used one is dropped past this.
+const MAX_ENTRIES: usize = 1024;
+
+type Key = (TypeId, PathBuf);
+
+struct Entry {
+    stamp: (u64, u64),
+    value: Arc<dyn Any + Send + Sync>,
+    last_used: u64,
+}
+
+#[derive(Default)]
+struct Cache {
+    entries: HashMap<Key, Entry>,
+    tick: u64,
+}
+
+fn cache() -> &'static Mutex<Cache> {
+    static CACHE: OnceLock<Mutex<Cache>> = OnceLock::new();
+    CACHE.get_or_init(Default::default)
+}
+
+fn file_stamp(path: &Path) -> Option<(u64, u64)> {
+    let meta = std::fs::metadata(path).ok()?;
+    let modified_ns = meta
+        .modified()
+        .ok()
+        .and_then(|t| t.duration_since(std::time::UNIX_EPOCH).ok())
+        .map(|d| d.as_nanos() as u64)
+        .unwrap_or(0);
+    Some((meta.len(), modified_ns))
+}
+
+/// The `T` opened from `path` by an earlier call, if the file is unchanged since;
+/// otherwise `open(path)`, remembered for the next call. Errors are not cached.
+pub(crate) fn cached<T, E, F>(path: &Path, open: F) -> Result<Arc<T>, E>
+where
+    T: Send + Sync + 'static,
+    F: FnOnce(&Path) -> Result<T, E>,
+{
+    let open = |path: &Path| {
+        let _parse = crate::read_profile::span(crate::read_profile::ProfileStage::Metadata);
+        open(path)
+    };
+    // Unreadable metadata: let `open` report the error.
+    let Some(stamp) = file_stamp(path) else {
+        return open(path).map(Arc::new);
+    };
+    let key = (TypeId::of::<T>(), path.to_path_buf());
+    {
+        let mut cache = cache().lock().unwrap_or_else(|e| e.into_inner());
+        cache.tick += 1;
+        let tick = cache.tick;
+        if let Some(entry) = cache.entries.get_mut(&key) {
+            if entry.stamp == stamp {
+                entry.last_used = tick;
+                if let Ok(value) = entry.value.clone().downcast::<T>() {
+                    return Ok(value);
+                }
+            }
+        }
+    }
+
+    // Parse without holding the lock so other files are not serialized behind it.
+    let value = Arc::new(open(path)?);
+    let mut cache = cache().lock().unwrap_or_else(|e| e.into_inner());
+    if cache.entries.len() >= MAX_ENTRIES && !cache.entries.contains_key(&key) {
+        let oldest = cache
+            .entries
+            .iter()
+            .min_by_key(|(_, entry)| entry.last_used)
+            .map(|(key, _)| key.clone());
+        if let Some(oldest) = oldest {
+            cache.entries.remove(&oldest);
+        }
+    }
+    let last_used = cache.tick;
+    cache.entries.insert(
+        key,
+        Entry {
+            stamp,
+            value: value.clone(),
+            last_used,
+        },
+    );
+    Ok(value)
+}
+
+/// Drop every cached header and metadata entry.
+pub fn clear_metadata_cache() {
+    cache()
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+        .entries
+        .clear();
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::cell::Cell;
+
+    #[test]
+    fn test_cached_reuses_until_file_changes() {
+        let path = std::env::temp_dir().join(format!(
+            "polars_readstat_metadata_cache_{}.bin",
+            std::process::id()
+        ));
+        std::fs::write(&path, b"one").unwrap();
+        let opens = Cell::new(0);
+        let open = |p: &Path| -> std::io::Result<Vec<u8>> {
+            opens.set(opens.get() + 1);
+            std::fs::read(p)
+        };
+
+        let a = cached(&path, open).unwrap();
+        let b = cached(&path, open).unwrap();
+        assert!(Arc::ptr_eq(&a, &b));
+        assert_eq!(opens.get(), 1);
+
+        // A different size invalidates the entry even within one mtime tick.
+        std::fs::write(&path, b"three").unwrap();
+        let c = cached(&path, open).unwrap();
+        assert_eq!(c.as_slice(), b"three");
+        assert_eq!(opens.get(), 2);
+
+        let _ = std::fs::remove_file(&path);
+        assert!(cached(&path, open).is_err());
+    }
+}
@@ -0,0 +1,279 @@
+//! Optional shared input for the SAS, Stata and SPSS readers: a memory map, or
+//! range reads with read-ahead ([`crate::range_source`]).
+//!
+//! The input is opened once per scan and handed to every worker. With a memory map,
+//! workers seek by moving a cursor instead of opening their own handle, and readers
+//! that understand the mapping (the sas7bdat page reader) borrow pages straight out
+//! of it instead of copying them into a buffer.
+
+use crate::range_source::{RangeCursor, RangeInput};
+use memmap2::Mmap;
+use std::fs::File;
+use std::io::{self, BufRead, BufReader, Read, Seek, SeekFrom};
+use std::path::Path;
+use std::sync::Arc;
+
+pub(crate) type SharedMap = Arc<Mmap>;
+
+/// Input shared by the workers of one scan. `None` in its place means plain
+/// buffered file handles.
+#[derive(Clone)]
+pub(crate) enum SharedInput {
+    Mapped(SharedMap),
+    Ranged(Arc<RangeInput>),
+}
+
+impl SharedInput {
+    /// The mapping, for readers that can borrow bytes from it.
+    pub(crate) fn mapped(&self) -> Option<&SharedMap> {
+        match self {
+            SharedInput::Mapped(map) => Some(map),
+            SharedInput::Ranged(_) => None,
+        }
+    }
+}
+
+/// Map `path` read-only. Returns `None` when the file cannot be mapped (empty files,
+/// pipes, some network filesystems) so callers fall back to buffered reads.
+pub(crate) fn map_file(path: &Path) -> Option<SharedMap> {
+    let file = File::open(path).ok()?;
+    if file.metadata().ok()?.len() == 0 {
+        return None;
+    }
+    // SAFETY: the mapping is read-only. As with any mmap-based reader, truncating
+    // the file while it is being read is undefined behaviour; that is why the
+    // backend is opt-in.
+    let map = unsafe { Mmap::map(&file) }.ok()?;
+    Some(Arc::new(map))
+}
+
+/// The input a scan should share: a mapping when `use_mmap` (and the file can be
+/// mapped), else range reads when a `read_ahead` window is given, else `None`.
+pub(crate) fn open_input(
+    use_mmap: bool,
+    read_ahead: Option<usize>,
+    path: &Path,
+) -> Option<SharedInput> {
+    if use_mmap {
+        if let Some(map) = map_file(path) {
+            return Some(SharedInput::Mapped(map));
+        }
+    }
+    let window = read_ahead?;
+    RangeInput::open_file(path, window)
+        .ok()
+        .map(|input| SharedInput::Ranged(Arc::new(input)))
+}
+
+/// Read/Seek cursor over a shared mapping.
+pub(crate) struct MappedCursor {
+    map: SharedMap,
+    pos: usize,
+}
+
+impl MappedCursor {
+    pub(crate) fn new(map: SharedMap) -> Self {
+        Self { map, pos: 0 }
+    }
+
+    fn remaining(&self) -> &[u8] {
+        let len = self.map.len();
+        &self.map[self.pos.min(len)..]
+    }
+}
+
+impl Read for MappedCursor {
+    fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+        let src = self.remaining();
+        let n = src.len().min(buf.len());
+        buf[..n].copy_from_slice(&src[..n]);
+        self.pos += n;
+        Ok(n)
+    }
+
+    fn read_exact(&mut self, buf: &mut [u8]) -> io::Result<()> {
+        let src = self.remaining();
+        if src.len() < buf.len() {
+            self.pos = self.map.len();
+            return Err(io::ErrorKind::UnexpectedEof.into());
+        }
+        buf.copy_from_slice(&src[..buf.len()]);
+        self.pos += buf.len();
+        Ok(())
+    }
+}
+
+impl BufRead for MappedCursor {
+    fn fill_buf(&mut self) -> io::Result<&[u8]> {
+        Ok(self.remaining())
+    }
+
+    fn consume(&mut self, amt: usize) {
+        self.pos += amt;
+    }
+}
+
+impl Seek for MappedCursor {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        let target = match pos {
+            SeekFrom::Start(n) => Some(n),
+            SeekFrom::End(d) => (self.map.len() as u64).checked_add_signed(d),
+            SeekFrom::Current(d) => (self.pos as u64).checked_add_signed(d),
+        };
+        let target = target.ok_or_else(|| {
+            io::Error::new(io::ErrorKind::InvalidInput, "seek before start of file")
+        })?;
+        self.pos = target as usize;
+        Ok(target)
+    }
+
+    fn stream_position(&mut self) -> io::Result<u64> {
+        Ok(self.pos as u64)
+    }
+}
+
+/// File input for the data readers: a buffered handle, a cursor over a mapping, or
+/// a read-ahead cursor.
+pub(crate) enum FileSource {
+    Buffered(BufReader<File>),
+    Mapped(MappedCursor),
+    Ranged(RangeCursor),
+}
+
+impl FileSource {
+    /// Open `path` through `input` when one is given, otherwise through a
+    /// `BufReader` with the given capacity.
+    pub(crate) fn open(
+        path: &Path,
+        capacity: usize,
+        input: Option<&SharedInput>,
+    ) -> io::Result<Self> {
+        match input {
+            Some(SharedInput::Mapped(map)) => {
+                Ok(FileSource::Mapped(MappedCursor::new(map.clone())))
+            }
+            Some(SharedInput::Ranged(input)) => {
+                Ok(FileSource::Ranged(RangeCursor::new(input.clone())))
+            }
+            None => Ok(FileSource::Buffered(BufReader::with_capacity(
+                capacity,
+                File::open(path)?,
+            ))),
+        }
+    }
+
+    /// Skip `n` bytes forward. Unlike `seek`, a buffered source keeps whatever part
+    /// of its buffer is still ahead of the new position.
+    pub(crate) fn skip(&mut self, n: u64) -> io::Result<()> {
+        match self {
+            FileSource::Buffered(r) => r.seek_relative(n as i64),
+            FileSource::Mapped(r) => r.seek(SeekFrom::Current(n as i64)).map(|_| ()),
+            FileSource::Ranged(r) => r.seek(SeekFrom::Current(n as i64)).map(|_| ()),
+        }
+    }
+}
+
+/// A read from `r` that has to go to the file, timed as I/O wait.
+fn buffered_read<T>(
+    r: &mut BufReader<File>,
+    want: usize,
+    read: impl FnOnce(&mut BufReader<File>) -> io::Result<T>,
+) -> io::Result<T> {
+    if r.buffer().len() >= want.max(1) || !crate::read_profile::is_active() {
+        return read(r);
+    }
+    let _io = crate::read_profile::span(crate::read_profile::ProfileStage::IoWait);
+    let before = r.get_mut().stream_position();
+    let out = read(r)?;
+    if let (Ok(before), Ok(after)) = (before, r.get_mut().stream_position()) {
+        crate::read_profile::add_bytes_read(after.saturating_sub(before) as usize);
+    }
+    Ok(out)
+}
+
+impl Read for FileSource {
+    fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+        match self {
+            FileSource::Buffered(r) => buffered_read(r, buf.len(), |r| r.read(buf)),
+            FileSource::Mapped(r) => r.read(buf),
+            FileSource::Ranged(r) => r.read(buf),
+        }
+    }
+
+    fn read_exact(&mut self, buf: &mut [u8]) -> io::Result<()> {
+        match self {
+            FileSource::Buffered(r) => buffered_read(r, buf.len(), |r| r.read_exact(buf)),
+            FileSource::Mapped(r) => r.read_exact(buf),
+            FileSource::Ranged(r) => r.read_exact(buf),
+        }
+    }
+}
+
+impl BufRead for FileSource {
+    fn fill_buf(&mut self) -> io::Result<&[u8]> {
+        match self {
+            FileSource::Buffered(r) => {
+                if r.buffer().is_empty() {
+                    buffered_read(r, 0, |r| r.fill_buf().map(|b| b.len()))?;
+                }
+                r.fill_buf()
+            }
+            FileSource::Mapped(r) => r.fill_buf(),
+            FileSource::Ranged(r) => r.fill_buf(),
+        }
+    }
+
+    fn consume(&mut self, amt: usize) {
+        match self {
+            FileSource::Buffered(r) => r.consume(amt),
+            FileSource::Mapped(r) => r.consume(amt),
+            FileSource::Ranged(r) => r.consume(amt),
+        }
+    }
+}
+
+impl Seek for FileSource {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        match self {
+            FileSource::Buffered(r) => r.seek(pos),
+            FileSource::Mapped(r) => r.seek(pos),
+            FileSource::Ranged(r) => r.seek(pos),
+        }
+    }
+
+    fn stream_position(&mut self) -> io::Result<u64> {
+        match self {
+            FileSource::Buffered(r) => r.stream_position(),
+            FileSource::Mapped(r) => r.stream_position(),
+            FileSource::Ranged(r) => r.stream_position(),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Write;
+
+    #[test]
+    fn test_mapped_cursor_read_seek() {
+        let path =
+            std::env::temp_dir().join(format!("polars_readstat_mmap_{}.bin", std::process::id()));
+        std::fs::File::create(&path)
+            .unwrap()
+            .write_all(b"0123456789")
+            .unwrap();
+        let map = map_file(&path).expect("map");
+        let mut cursor = MappedCursor::new(map);
+        let mut buf = [0u8; 4];
+        cursor.read_exact(&mut buf).unwrap();
+        assert_eq!(&buf, b"0123");
+        cursor.seek(SeekFrom::Current(2)).unwrap();
+        cursor.read_exact(&mut buf).unwrap();
+        assert_eq!(&buf, b"6789");
+        assert!(cursor.read_exact(&mut buf).is_err());
+        cursor.seek(SeekFrom::End(-3)).unwrap();
+        assert_eq!(cursor.fill_buf().unwrap(), b"789");
+        let _ = std::fs::remove_file(&path);
+    }
+}
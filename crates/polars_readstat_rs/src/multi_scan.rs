@@ -0,0 +1,574 @@
+//! Scans over many files as one table (e.g. a survey split into yearly files).
+//!
+//! Schemas are unified by name across files: a column missing from a file reads
+//! as nulls, and a column whose type differs between files is cast to the
+//! supertype. Files are read through `readstat_batch_iter` under one shared thread
+//! budget (`ScanOptions::threads`, default `default_thread_count()`): each file is
+//! given threads in proportion to its size, and a file starts only once its
+//! threads are free. Many small files therefore read side by side on one thread
+//! each, and a large file gets the whole pool when it is alone, instead of every
+//! file sizing its own pool to the machine. Output is in file order.
+
+use crate::mem_budget::{ByteBudget, MIN_STREAM_BUDGET};
+use crate::{readstat_batch_iter, ReadStatFormat, ReadstatBatchIter, RowFilter, ScanOptions};
+use polars::prelude::*;
+use rayon::prelude::*;
+use std::path::{Path, PathBuf};
+use std::sync::mpsc::{self, Receiver};
+use std::sync::Arc;
+use std::thread::{self, JoinHandle};
+
+/// File bytes that justify one reader thread.
+const BYTES_PER_THREAD: u64 = 64 * 1024 * 1024;
+/// Conformed batches buffered per running file.
+const FILE_CHANNEL_DEPTH: usize = 2;
+
+/// Options specific to multi-file scans.
+#[derive(Debug, Clone, Default)]
+pub struct MultiScanOptions {
+    /// Add a String column with this name holding the path each row was read from.
+    pub source_column: Option<String>,
+}
+
+struct FileEntry {
+    path: PathBuf,
+    format: ReadStatFormat,
+    schema: SchemaRef,
+    threads: usize,
+}
+
+/// The files of a multi-file scan and their unified schema.
+struct FileSet {
+    files: Vec<FileEntry>,
+    /// Union of the file schemas, in first-seen column order.
+    schema: Schema,
+    /// Options passed to every file; the dataset-level settings below are
+    /// applied by the multi-file scan instead.
+    file_opts: ScanOptions,
+    row_index_name: Option<String>,
+    compress_opts: crate::CompressOptionsLite,
+    source_column: Option<String>,
+    total_threads: usize,
+}
+
+impl FileSet {
+    fn open(
+        paths: Vec<PathBuf>,
+        opts: ScanOptions,
+        format: Option<ReadStatFormat>,
+        multi: MultiScanOptions,
+    ) -> PolarsResult<Self> {
+        if paths.is_empty() {
+            return Err(PolarsError::ComputeError(
+                "multi-file scan needs at least one path".into(),
+            ));
+        }
+        let total_threads = opts
+            .threads
+            .unwrap_or_else(crate::default_thread_count)
+            .max(1);
+        let mut file_opts = opts.clone();
+        file_opts.row_index_name = None;
+        file_opts.compress_opts = crate::CompressOptionsLite::default();
+
+        let files = paths
+            .into_par_iter()
+            .map(|path| {
+                let format = format
+                    .or_else(|| crate::detect_format(&path))
+                    .ok_or_else(|| {
+                        PolarsError::ComputeError(
+                            format!("unknown file extension: {}", path.display()).into(),
+                        )
+                    })?;
+                let schema = crate::readstat_schema(&path, Some(file_opts.clone()), Some(format))?;
+                let size = std::fs::metadata(&path).map(|m| m.len()).unwrap_or(0);
+                let threads = (size.div_ceil(BYTES_PER_THREAD) as usize).clamp(1, total_threads);
+                Ok(FileEntry {
+                    path,
+                    format,
+                    schema,
+                    threads,
+                })
+            })
+            .collect::<PolarsResult<Vec<_>>>()?;
+
+        let mut schema = Schema::default();
+        for file in &files {
+            for (name, dtype) in file.schema.iter() {
+                let unified = match schema.get(name.as_str()) {
+                    Some(existing) if existing == dtype => continue,
+                    Some(existing) => polars_core::utils::try_get_supertype(existing, dtype)
+                        .map_err(|_| {
+                            PolarsError::SchemaMismatch(
+                                format!(
+                                    "column '{name}' is {existing} in one file and {dtype} in {}",
+                                    file.path.display()
+                                )
+                                .into(),
+                            )
+                        })?,
+                    None => dtype.clone(),
+                };
+                schema.with_column(name.clone(), unified);
+            }
+        }
+        for name in [&multi.source_column, &opts.row_index_name]
+            .into_iter()
+            .flatten()
+        {
+            if schema.get(name).is_some() {
+                return Err(PolarsError::ComputeError(
+                    format!("'{name}' collides with an existing column").into(),
+                ));
+            }
+        }
+
+        Ok(Self {
+            files,
+            schema,
+            file_opts,
+            row_index_name: opts.row_index_name,
+            compress_opts: opts.compress_opts,
+            source_column: multi.source_column,
+            total_threads,
+        })
+    }
+
+    fn output_schema(&self) -> PolarsResult<Schema> {
+        let mut schema = self.schema.clone();
+        if let Some(name) = &self.source_column {
+            schema.with_column(name.as_str().into(), DataType::String);
+        }
+        if let Some(name) = &self.row_index_name {
+            schema = crate::append_row_index_schema(schema, name)?;
+        }
+        Ok(schema)
+    }
+
+    /// Stream the data columns `columns` (all when `None`) of every file, in file
+    /// order, conformed to the unified schema.
+    fn batches(
+        self: &Arc<Self>,
+        columns: Option<Vec<String>>,
+        n_rows: Option<usize>,
+        batch_size: Option<usize>,
+        row_filter: Option<RowFilter>,
+        with_source: bool,
+        with_row_index: bool,
+    ) -> MultiFileBatchIter {
+        let mut target = match &columns {
+            Some(cols) => {
+                let mut target = Schema::with_capacity(cols.len() + 1);
+                for name in cols {
+                    if let Some(dtype) = self.schema.get(name) {
+                        target.with_column(name.as_str().into(), dtype.clone());
+                    }
+                }
+                target
+            }
+            None => self.schema.clone(),
+        };
+        let source_column = self.source_column.clone().filter(|_| with_source);
+        if let Some(name) = &source_column {
+            target.with_column(name.as_str().into(), DataType::String);
+        }
+        let target = Arc::new(target);
+        // Filtered-out rows would leave holes in the dataset-wide row index, so
+        // with one the files read every row and the caller's predicate filters.
+        let row_filter = row_filter
+            .or_else(|| self.file_opts.row_filter.clone())
+            .filter(|_| !with_row_index);
+
+        let permits = Arc::new(ByteBudget::new(self.total_threads));
+        let (files_tx, files_rx) = mpsc::channel::<Receiver<PolarsResult<DataFrame>>>();
+        let set = self.clone();
+        let dispatch_permits = permits.clone();
+        let dispatcher = thread::spawn(move || {
+            let mut handles = Vec::new();
+            for idx in 0..set.files.len() {
+                let threads = set.files[idx].threads;
+                if !dispatch_permits.acquire(threads) {
+                    break;
+                }
+                let (tx, rx) = mpsc::sync_channel(FILE_CHANNEL_DEPTH);
+                if files_tx.send(rx).is_err() {
+                    dispatch_permits.release(threads);
+                    break;
+                }
+                let set = set.clone();
+                let permits = dispatch_permits.clone();
+                let columns = columns.clone();
+                let row_filter = row_filter.clone();
+                let target = target.clone();
+                let source_column = source_column.clone();
+                handles.push(thread::spawn(move || {
+                    let file = &set.files[idx];
+                    let result = set.file_batches(file, columns, n_rows, batch_size, row_filter);
+                    match result {
+                        Ok(iter) => {
+                            for batch in iter {
+                                let batch = batch.and_then(|df| {
+                                    conform(df, &target, source_column.as_deref(), &file.path)
+                                });
+                                let is_err = batch.is_err();
+                                if tx.send(batch).is_err() || is_err {
+                                    break;
+                                }
+                            }
+                        }
+                        Err(e) => {
+                            let _ = tx.send(Err(e));
+                        }
+                    }
+                    permits.release(file.threads);
+                }));
+            }
+            for handle in handles {
+                let _ = handle.join();
+            }
+        });
+
+        MultiFileBatchIter {
+            files: Some(files_rx),
+            current: None,
+            permits,
+            dispatcher: Some(dispatcher),
+            row_index_name: self.row_index_name.clone().filter(|_| with_row_index),
+            row_cursor: 0,
+            remaining: n_rows,
+        }
+    }
+
+    /// Batch iterator over one file, reading only the requested columns it has.
+    fn file_batches(
+        &self,
+        file: &FileEntry,
+        columns: Option<Vec<String>>,
+        n_rows: Option<usize>,
+        batch_size: Option<usize>,
+        row_filter: Option<RowFilter>,
+    ) -> PolarsResult<ReadstatBatchIter> {
+        let columns = columns.map(|cols| {
+            let present: Vec<String> = cols
+                .into_iter()
+                .filter(|c| file.schema.get(c).is_some())
+                .collect();
+            if present.is_empty() {
+                // Read one narrow column for the row count; an empty list would
+                // read them all.
+                file.schema
+                    .iter_names()
+                    .next()
+                    .map(|n| vec![n.to_string()])
+                    .unwrap_or_default()
+            } else {
+                present
+            }
+        });
+        let mut opts = self.file_opts.clone();
+        opts.threads = Some(file.threads);
+        opts.row_filter = row_filter;
+        // The file's share of the budget, in proportion to its threads.
+        opts.memory_budget = opts.memory_budget.map(|budget| {
+            (budget.saturating_mul(file.threads) / self.total_threads).max(MIN_STREAM_BUDGET)
+        });
+        readstat_batch_iter(
+            &file.path,
+            Some(opts),
+            Some(file.format),
+            columns,
+            n_rows,
+            batch_size,
+        )
+    }
+}
+
+/// Cast `df` to `target`: columns in target order, missing ones as nulls, and the
+/// source column (when present in `target`) set to `path`.
+fn conform(
+    df: DataFrame,
+    target: &Schema,
+    source_column: Option<&str>,
+    path: &Path,
+) -> PolarsResult<DataFrame> {
+    let height = df.height();
+    let mut cols = Vec::with_capacity(target.len());
+    for (name, dtype) in target.iter() {
+        if Some(name.as_str()) == source_column {
+            let path = path.to_string_lossy();
+            let value = AnyValue::StringOwned(path.as_ref().into());
+            cols.push(Column::new_scalar(
+                name.clone(),
+                Scalar::new(DataType::String, value),
+                height,
+            ));
+            continue;
+        }
+        cols.push(match df.column(name.as_str()) {
+            Ok(col) if col.dtype() == dtype => col.clone(),
+            Ok(col) => col.cast(dtype)?,
+            Err(_) => Column::full_null(name.clone(), height, dtype),
+        });
+    }
+    if cols.is_empty() {
+        return Ok(DataFrame::empty_with_height(height));
+    }
+    DataFrame::new_infer_height(cols)
+}
+
+struct MultiFileBatchIter {
+    files: Option<Receiver<Receiver<PolarsResult<DataFrame>>>>,
+    current: Option<Receiver<PolarsResult<DataFrame>>>,
+    /// Thread permits shared by the running files.
+    permits: Arc<ByteBudget>,
+    dispatcher: Option<JoinHandle<()>>,
+    row_index_name: Option<String>,
+    row_cursor: usize,
+    remaining: Option<usize>,
+}
+
+impl Iterator for MultiFileBatchIter {
+    type Item = PolarsResult<DataFrame>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.remaining == Some(0) {
+            return None;
+        }
+        loop {
+            if self.current.is_none() {
+                self.current = Some(self.files.as_ref()?.recv().ok()?);
+            }
+            let batch = match self.current.as_ref()?.recv() {
+                Ok(batch) => batch,
+                Err(_) => {
+                    self.current = None;
+                    continue;
+                }
+            };
+            return Some(batch.and_then(|mut df| {
+                if let Some(remaining) = self.remaining.as_mut() {
+                    if df.height() > *remaining {
+                        df = df.slice(0, *remaining);
+                    }
+                    *remaining -= df.height();
+                }
+                let n = df.height();
+                let df = match &self.row_index_name {
+                    Some(name) => crate::append_row_index(df, name, self.row_cursor)?,
+                    None => df,
+                };
+                self.row_cursor += n;
+                Ok(df)
+            }));
+        }
+    }
+}
+
+impl Drop for MultiFileBatchIter {
+    fn drop(&mut self) {
+        self.permits.close();
+        self.current.take();
+        self.files.take();
+        if let Some(handle) = self.dispatcher.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+struct MultiFileScan {
+    set: Arc<FileSet>,
+}
+
+impl AnonymousScan for MultiFileScan {
+    fn as_any(&self) -> &dyn std::any::Any {
+        self
+    }
+
+    fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
+        let set = &self.set;
+        let predicate = opts.predicate.as_ref();
+        let row_filter = predicate.and_then(RowFilter::from_expr);
+        let is_generated = |name: &str| {
+            set.source_column.as_deref() == Some(name)
+                || set.row_index_name.as_deref() == Some(name)
+        };
+        let extra_columns = predicate
+            .map(|p| {
+                crate::row_filter::predicate_extra_columns(p, opts.with_columns.as_deref(), |n| {
+                    set.schema.get(n).is_some() || is_generated(n)
+                })
+            })
+            .unwrap_or_default();
+
+        let columns = opts.with_columns.as_deref().map(|cols| {
+            cols.iter()
+                .chain(&extra_columns)
+                .filter(|c| !is_generated(c))
+                .map(|c| c.to_string())
+                .collect::<Vec<_>>()
+        });
+        if let Some(cols) = &columns {
+            if let Some(missing) = cols.iter().find(|c| set.schema.get(c).is_none()) {
+                return Err(PolarsError::ColumnNotFound(missing.as_str().into()));
+            }
+        }
+        let wants = |name: &Option<String>| {
+            name.as_deref().is_some_and(|name| {
+                opts.with_columns.as_deref().map_or(true, |cols| {
+                    cols.iter()
+                        .chain(&extra_columns)
+                        .any(|c| c.as_str() == name)
+                })
+            })
+        };
+        let with_source = wants(&set.source_column);
+        let with_row_index = wants(&set.row_index_name);
+        // Generated columns are added after the row filter runs, so a predicate on
+        // them is only applied as part of the residual predicate.
+        let n_rows = opts.n_rows.filter(|_| predicate.is_none());
+
+        let iter = set.batches(
+            columns,
+            n_rows,
+            None,
+            row_filter,
+            with_source,
+            with_row_index,
+        );
+        let prefetch = crate::scan_prefetch::spawn_prefetcher(iter);
+        // Without a residual predicate the rows read are the rows returned, so the
+        // columns can be compressed as they are assembled. File row counts are not
+        // known up front; the builders grow as files arrive.
+        let fuse = set.compress_opts.enabled && predicate.is_none();
+        let mut out = crate::frame_assembly::FrameAssembler::new(n_rows.unwrap_or(0))
+            .with_compression(fuse.then_some(&set.compress_opts));
+        while let Some(df) = prefetch.next()? {
+            out.push(df)?;
+        }
+        let df = out.finish()?;
+        let df = crate::row_filter::apply_residual_predicate(df, predicate, &extra_columns)?;
+        let df = match opts.n_rows {
+            Some(n) if predicate.is_some() => df.slice(0, n),
+            _ => df,
+        };
+
+        if set.compress_opts.enabled && !fuse {
+            crate::compress_df_if_enabled(&df, &set.compress_opts)
+                .map_err(|e| PolarsError::ComputeError(e.into()))
+        } else {
+            Ok(df)
+        }
+    }
+
+    fn allows_predicate_pushdown(&self) -> bool {
+        true
+    }
+
+    fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
+        Ok(Arc::new(self.set.output_schema()?))
+    }
+}
+
+fn collect_paths<P: AsRef<Path>>(paths: impl IntoIterator<Item = P>) -> Vec<PathBuf> {
+    paths
+        .into_iter()
+        .map(|p| p.as_ref().to_path_buf())
+        .collect()
+}
+
+/// Expand a glob pattern (e.g. `"data/cps_*.sas7bdat"`) into the matching files,
+/// in lexical order.
+pub fn readstat_glob(pattern: &str) -> PolarsResult<Vec<PathBuf>> {
+    let entries = glob::glob(pattern).map_err(|e| {
+        PolarsError::ComputeError(format!("invalid glob pattern '{pattern}': {e}").into())
+    })?;
+    let mut paths = Vec::new();
+    for entry in entries {
+        let path = entry.map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+        if path.is_file() {
+            paths.push(path);
+        }
+    }
+    if paths.is_empty() {
+        return Err(PolarsError::ComputeError(
+            format!("no files match '{pattern}'").into(),
+        ));
+    }
+    paths.sort();
+    Ok(paths)
+}
+
+/// Scan several files as one table. The format of each file is detected from its
+/// extension unless `format` is given. `opts` applies to every file, except that
+/// `row_index_name` numbers rows across the whole dataset and `threads` is the
+/// thread budget for the whole scan.
+pub fn readstat_scan_many<P: AsRef<Path>>(
+    paths: impl IntoIterator<Item = P>,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    multi: Option<MultiScanOptions>,
+) -> PolarsResult<LazyFrame> {
+    let set = FileSet::open(
+        collect_paths(paths),
+        opts.unwrap_or_default(),
+        format,
+        multi.unwrap_or_default(),
+    )?;
+    let scan = MultiFileScan { set: Arc::new(set) };
+    LazyFrame::anonymous_scan(Arc::new(scan), Default::default())
+}
+
+/// [`readstat_scan_many`] over the files matching a glob pattern.
+pub fn readstat_scan_glob(
+    pattern: &str,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    multi: Option<MultiScanOptions>,
+) -> PolarsResult<LazyFrame> {
+    readstat_scan_many(readstat_glob(pattern)?, opts, format, multi)
+}
+
+/// Multi-file counterpart of [`readstat_batch_iter`]: batches of every file in
+/// file order, conformed to the unified schema.
+pub fn readstat_batch_iter_many<P: AsRef<Path>>(
+    paths: impl IntoIterator<Item = P>,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    batch_size: Option<usize>,
+    multi: Option<MultiScanOptions>,
+) -> PolarsResult<ReadstatBatchIter> {
+    let set = Arc::new(FileSet::open(
+        collect_paths(paths),
+        opts.unwrap_or_default(),
+        format,
+        multi.unwrap_or_default(),
+    )?);
+    let columns = columns
+        .map(|cols| {
+            cols.into_iter()
+                .filter(|c| {
+                    Some(c) != set.row_index_name.as_ref() && Some(c) != set.source_column.as_ref()
+                })
+                .collect::<Vec<_>>()
+        })
+        .filter(|cols| !cols.is_empty());
+    if let Some(cols) = &columns {
+        if let Some(missing) = cols.iter().find(|c| set.schema.get(c).is_none()) {
+            return Err(PolarsError::ColumnNotFound(missing.as_str().into()));
+        }
+    }
+    let iter = set.batches(columns, n_rows, batch_size, None, true, true);
+    if set.compress_opts.enabled {
+        let compress_opts = set.compress_opts.clone();
+        Ok(ReadstatBatchIter::new(Box::new(iter.map(move |batch| {
+            let df = batch?;
+            crate::compress_df_if_enabled(&df, &compress_opts)
+                .map_err(|e| PolarsError::ComputeError(e.into()))
+        }))))
+    } else {
+        Ok(ReadstatBatchIter::new(Box::new(iter)))
+    }
+}
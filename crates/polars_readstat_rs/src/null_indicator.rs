@@ -0,0 +1,134 @@
+//! Compact builder for informative-null indicator columns.
+//!
+//! An indicator column is null on almost every row and otherwise holds one of a
+//! handful of labels (`.a`–`.z` in Stata, the declared missing values of an SPSS
+//! variable). Building it as strings allocated a label per missing cell. Here
+//! each row only stores a one-byte code into a small per-column dictionary;
+//! labels are computed once per distinct raw missing value and the `String`
+//! column is materialized when the batch is finished.
+
+use polars::prelude::*;
+use std::collections::HashMap;
+
+/// Code of a row without an indicator.
+const NONE: u32 = 0;
+
+/// Row codes; one byte each until a column has more than 255 distinct labels.
+enum Codes {
+    Narrow(Vec<u8>),
+    Wide(Vec<u32>),
+}
+
+pub(crate) struct IndicatorBuilder {
+    name: PlSmallStr,
+    labels: Vec<String>,
+    by_label: HashMap<String, u32>,
+    /// Caller-defined raw keys (missing offset, value bits) to their code.
+    by_key: HashMap<u64, u32>,
+    codes: Codes,
+}
+
+impl IndicatorBuilder {
+    pub(crate) fn new(name: PlSmallStr, capacity: usize) -> Self {
+        Self {
+            name,
+            labels: Vec::new(),
+            by_label: HashMap::new(),
+            by_key: HashMap::new(),
+            codes: Codes::Narrow(Vec::with_capacity(capacity)),
+        }
+    }
+
+    #[inline]
+    pub(crate) fn push_null(&mut self) {
+        self.push_code(NONE);
+    }
+
+    /// Indicator for a raw missing value identified by `key`. `label` runs on the
+    /// first occurrence of the key only; `None` means the value has no indicator.
+    #[inline]
+    pub(crate) fn push_keyed(&mut self, key: u64, label: impl FnOnce() -> Option<String>) {
+        let code = match self.by_key.get(&key) {
+            Some(&code) => code,
+            None => {
+                let code = label().map_or(NONE, |l| self.intern(l));
+                self.by_key.insert(key, code);
+                code
+            }
+        };
+        self.push_code(code);
+    }
+
+    pub(crate) fn push_label(&mut self, label: String) {
+        let code = self.intern(label);
+        self.push_code(code);
+    }
+
+    fn intern(&mut self, label: String) -> u32 {
+        if let Some(&code) = self.by_label.get(&label) {
+            return code;
+        }
+        self.labels.push(label.clone());
+        let code = self.labels.len() as u32;
+        self.by_label.insert(label, code);
+        code
+    }
+
+    #[inline]
+    fn push_code(&mut self, code: u32) {
+        match &mut self.codes {
+            Codes::Narrow(codes) if code <= u8::MAX as u32 => codes.push(code as u8),
+            Codes::Narrow(codes) => {
+                let mut wide: Vec<u32> = Vec::with_capacity(codes.capacity());
+                wide.extend(codes.iter().map(|&c| c as u32));
+                wide.push(code);
+                self.codes = Codes::Wide(wide);
+            }
+            Codes::Wide(codes) => codes.push(code),
+        }
+    }
+
+    pub(crate) fn finish(self) -> Series {
+        let labels = &self.labels;
+        let label = |code: u32| (code != NONE).then(|| labels[code as usize - 1].as_str());
+        let ca: StringChunked = match &self.codes {
+            Codes::Narrow(codes) => codes.iter().map(|&c| label(c as u32)).collect(),
+            Codes::Wide(codes) => codes.iter().map(|&c| label(c)).collect(),
+        };
+        ca.with_name(self.name).into_series()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_indicator_builder_codes_and_widening() {
+        let mut b = IndicatorBuilder::new("x_null".into(), 4);
+        let mut calls = 0;
+        b.push_null();
+        b.push_keyed(1, || {
+            calls += 1;
+            Some(".a".to_string())
+        });
+        b.push_keyed(1, || unreachable!());
+        b.push_keyed(2, || None);
+        b.push_label(".a".to_string());
+        assert_eq!(calls, 1);
+        let s = b.finish();
+        assert_eq!(s.name().as_str(), "x_null");
+        let got: Vec<Option<&str>> = s.str().unwrap().into_iter().collect();
+        assert_eq!(got, [None, Some(".a"), Some(".a"), None, Some(".a")]);
+
+        let mut b = IndicatorBuilder::new("y".into(), 0);
+        for i in 0..300 {
+            b.push_label(i.to_string());
+            b.push_null();
+        }
+        let s = b.finish();
+        assert_eq!(s.len(), 600);
+        assert_eq!(s.str().unwrap().get(598), Some("299"));
+        assert_eq!(s.null_count(), 300);
+    }
+}
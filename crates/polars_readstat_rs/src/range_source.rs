@@ -0,0 +1,285 @@
+//! Range-read input with read-ahead, for storage where every seek is a round trip
+//! (NFS, network volumes, FUSE-mounted object stores).
+//!
+//! The buffered backend reads with one blocking `read` per buffer refill, so a worker
+//! waits out the full storage latency every few megabytes. Here each worker keeps
+//! several large positioned range reads in flight ahead of its cursor, so latency is
+//! overlapped with decoding. Byte ranges come from a [`ByteRangeSource`]; the local
+//! file implementation uses positioned reads (`pread`), so workers share one handle
+//! and never seek it.
+
+use std::collections::VecDeque;
+use std::fs::File;
+use std::io::{self, BufRead, Read, Seek, SeekFrom};
+use std::path::Path;
+use std::sync::mpsc;
+use std::sync::Arc;
+
+/// Smallest and largest single range request.
+const MIN_BLOCK: usize = 256 * 1024;
+const MAX_BLOCK: usize = 16 * 1024 * 1024;
+/// Range requests kept in flight per cursor when the window allows it.
+const DEFAULT_DEPTH: usize = 4;
+
+/// Random-access byte source.
+pub(crate) trait ByteRangeSource: Send + Sync {
+    /// Total length in bytes.
+    fn len(&self) -> u64;
+
+    /// Up to `len` bytes starting at `offset`; shorter only at the end of input.
+    fn read_range(&self, offset: u64, len: usize) -> io::Result<Vec<u8>>;
+}
+
+/// Local file read with positioned reads.
+pub(crate) struct FileRangeSource {
+    file: File,
+    len: u64,
+}
+
+impl FileRangeSource {
+    pub(crate) fn open(path: &Path) -> io::Result<Self> {
+        let file = File::open(path)?;
+        let len = file.metadata()?.len();
+        Ok(Self { file, len })
+    }
+}
+
+impl ByteRangeSource for FileRangeSource {
+    fn len(&self) -> u64 {
+        self.len
+    }
+
+    fn read_range(&self, offset: u64, len: usize) -> io::Result<Vec<u8>> {
+        let len = len.min(self.len.saturating_sub(offset) as usize);
+        let mut buf = vec![0u8; len];
+        let mut filled = 0;
+        while filled < len {
+            match read_at(&self.file, &mut buf[filled..], offset + filled as u64) {
+                Ok(0) => break,
+                Ok(n) => filled += n,
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+                Err(e) => return Err(e),
+            }
+        }
+        buf.truncate(filled);
+        Ok(buf)
+    }
+}
+
+#[cfg(unix)]
+fn read_at(file: &File, buf: &mut [u8], offset: u64) -> io::Result<usize> {
+    std::os::unix::fs::FileExt::read_at(file, buf, offset)
+}
+
+#[cfg(windows)]
+fn read_at(file: &File, buf: &mut [u8], offset: u64) -> io::Result<usize> {
+    std::os::windows::fs::FileExt::seek_read(file, buf, offset)
+}
+
+/// A byte source plus the read-ahead shape used by every cursor over it.
+pub(crate) struct RangeInput {
+    source: Arc<dyn ByteRangeSource>,
+    block_size: usize,
+    depth: usize,
+}
+
+impl RangeInput {
+    /// Cursors over `source` keep about `window` bytes of range reads in flight.
+    pub(crate) fn new(source: Arc<dyn ByteRangeSource>, window: usize) -> Self {
+        let block_size = (window / DEFAULT_DEPTH).clamp(MIN_BLOCK, MAX_BLOCK);
+        let depth = (window / block_size).max(1);
+        Self {
+            source,
+            block_size,
+            depth,
+        }
+    }
+
+    pub(crate) fn open_file(path: &Path, window: usize) -> io::Result<Self> {
+        Ok(Self::new(Arc::new(FileRangeSource::open(path)?), window))
+    }
+}
+
+type PendingBlock = (u64, mpsc::Receiver<io::Result<Vec<u8>>>);
+
+/// Read/Seek cursor that reads ahead of its position through a [`RangeInput`].
+///
+/// Blocks are requested back to back from where the cursor last loaded one. A seek
+/// that lands inside the requested window keeps it; any other seek drops it and
+/// restarts at the new position.
+pub(crate) struct RangeCursor {
+    input: Arc<RangeInput>,
+    pos: u64,
+    block_start: u64,
+    block: Vec<u8>,
+    pending: VecDeque<PendingBlock>,
+}
+
+impl RangeCursor {
+    pub(crate) fn new(input: Arc<RangeInput>) -> Self {
+        Self {
+            input,
+            pos: 0,
+            block_start: 0,
+            block: Vec::new(),
+            pending: VecDeque::new(),
+        }
+    }
+
+    fn in_block(&self) -> bool {
+        self.pos >= self.block_start && self.pos < self.block_start + self.block.len() as u64
+    }
+
+    fn request(&mut self, start: u64) {
+        let (tx, rx) = mpsc::channel();
+        let source = self.input.source.clone();
+        let len = self.input.block_size;
+        crate::worker_pool::spawn_io(move || {
+            // The cursor may have moved on and dropped the receiver.
+            let _ = tx.send(source.read_range(start, len));
+        });
+        self.pending.push_back((start, rx));
+    }
+
+    /// Keep `depth` blocks requested past the last one already requested.
+    fn top_up(&mut self, mut next: u64) {
+        if let Some((start, _)) = self.pending.back() {
+            next = start + self.input.block_size as u64;
+        }
+        let len = self.input.source.len();
+        while self.pending.len() < self.input.depth && next < len {
+            self.request(next);
+            next += self.input.block_size as u64;
+        }
+    }
+
+    fn load_block(&mut self) -> io::Result<()> {
+        let block_size = self.input.block_size as u64;
+        while let Some((start, _)) = self.pending.front() {
+            if *start + block_size <= self.pos {
+                self.pending.pop_front();
+            } else {
+                break;
+            }
+        }
+        if self
+            .pending
+            .front()
+            .is_some_and(|(start, _)| *start > self.pos)
+        {
+            self.pending.clear();
+        }
+        if self.pending.is_empty() {
+            self.request(self.pos);
+        }
+        let (start, rx) = self.pending.pop_front().expect("a block was requested");
+        let block = {
+            let _io = crate::read_profile::span(crate::read_profile::ProfileStage::IoWait);
+            rx.recv().map_err(io::Error::other)??
+        };
+        crate::read_profile::add_bytes_read(block.len());
+        self.block_start = start;
+        self.block = block;
+        self.top_up(start + block_size);
+        Ok(())
+    }
+}
+
+impl Read for RangeCursor {
+    fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+        let src = self.fill_buf()?;
+        let n = src.len().min(buf.len());
+        buf[..n].copy_from_slice(&src[..n]);
+        self.consume(n);
+        Ok(n)
+    }
+}
+
+impl BufRead for RangeCursor {
+    fn fill_buf(&mut self) -> io::Result<&[u8]> {
+        if !self.in_block() {
+            if self.pos >= self.input.source.len() {
+                return Ok(&[]);
+            }
+            self.load_block()?;
+        }
+        let at = (self.pos - self.block_start) as usize;
+        Ok(&self.block[at.min(self.block.len())..])
+    }
+
+    fn consume(&mut self, amt: usize) {
+        self.pos += amt as u64;
+    }
+}
+
+impl Seek for RangeCursor {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        let target = match pos {
+            SeekFrom::Start(n) => Some(n),
+            SeekFrom::End(d) => self.input.source.len().checked_add_signed(d),
+            SeekFrom::Current(d) => self.pos.checked_add_signed(d),
+        };
+        let target = target.ok_or_else(|| {
+            io::Error::new(io::ErrorKind::InvalidInput, "seek before start of file")
+        })?;
+        self.pos = target;
+        Ok(target)
+    }
+
+    fn stream_position(&mut self) -> io::Result<u64> {
+        Ok(self.pos)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    struct Bytes(Vec<u8>);
+
+    impl ByteRangeSource for Bytes {
+        fn len(&self) -> u64 {
+            self.0.len() as u64
+        }
+
+        fn read_range(&self, offset: u64, len: usize) -> io::Result<Vec<u8>> {
+            let start = (offset as usize).min(self.0.len());
+            let end = (start + len).min(self.0.len());
+            Ok(self.0[start..end].to_vec())
+        }
+    }
+
+    #[test]
+    fn test_range_cursor_reads_and_seeks_across_blocks() {
+        let data: Vec<u8> = (0..3 * MIN_BLOCK + 123).map(|i| (i % 251) as u8).collect();
+        let input = Arc::new(RangeInput::new(Arc::new(Bytes(data.clone())), 0));
+        let mut cursor = RangeCursor::new(input);
+
+        let mut all = Vec::new();
+        cursor.read_to_end(&mut all).unwrap();
+        assert_eq!(all, data);
+
+        let mut buf = vec![0u8; 1000];
+        cursor.seek(SeekFrom::Start(MIN_BLOCK as u64 - 10)).unwrap();
+        cursor.read_exact(&mut buf).unwrap();
+        assert_eq!(buf, data[MIN_BLOCK - 10..MIN_BLOCK + 990]);
+        cursor.seek(SeekFrom::Start(5)).unwrap();
+        cursor.read_exact(&mut buf).unwrap();
+        assert_eq!(buf, data[5..1005]);
+        cursor.seek(SeekFrom::End(-3)).unwrap();
+        assert_eq!(cursor.fill_buf().unwrap(), &data[data.len() - 3..]);
+        assert!(cursor.read_exact(&mut buf).is_err());
+    }
+
+    #[test]
+    fn test_file_range_source_reads_ranges() {
+        let path =
+            std::env::temp_dir().join(format!("polars_readstat_range_{}.bin", std::process::id()));
+        std::fs::write(&path, b"0123456789").unwrap();
+        let source = FileRangeSource::open(&path).unwrap();
+        assert_eq!(source.len(), 10);
+        assert_eq!(source.read_range(3, 4).unwrap(), b"3456");
+        assert_eq!(source.read_range(8, 10).unwrap(), b"89");
+        let _ = std::fs::remove_file(&path);
+    }
+}
@@ -0,0 +1,640 @@
+//! Per-stage profile of one read, the same for every format.
+//!
+//! A [`ReadProfiler`] is handed to a scan through `ScanOptions::profile` (or used
+//! by a reader's `finish_profiled`). While the scan runs it is the current
+//! profiler of every thread working for it: the thread driving the scan, the
+//! tasks it submits to the worker pool and its background threads. Instrumented
+//! code opens a [`span`] for a stage; with no current profiler that costs one
+//! thread-local read. Spans nest and report exclusive time, so an I/O wait inside
+//! row decode counts as I/O wait only. Work done per cell or per row is timed with
+//! a [`Tally`] instead, which sums locally and is charged once per batch.
+//!
+//! `io_wait_ms` and `channel_wait_ms` against the other stages tell an I/O-bound
+//! read from a CPU-bound one; `thread_utilization` is the share of the threads'
+//! wall time spent neither waiting on storage nor on each other.
+
+use std::cell::RefCell;
+use std::collections::HashSet;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
+use std::thread::{JoinHandle, ThreadId};
+use std::time::Instant;
+
+const STAGES: usize = 8;
+
+/// A stage of a read that [`ReadProfile`] reports time for.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum ProfileStage {
+    /// Opening the file and parsing its header and metadata.
+    Metadata,
+    /// Waiting on storage: buffer refills and range reads not yet landed.
+    IoWait,
+    /// Page decompression (sas7bdat RLE/RDC, SPSS bytecode, zsav inflate).
+    Decompress,
+    /// Turning row bytes into column values.
+    RowDecode,
+    /// Trimming and transcoding string values.
+    StringDecode,
+    /// Looking up value labels.
+    LabelMap,
+    /// Waiting on workers for the next batch.
+    ChannelWait,
+    /// Copying batches into the final frame.
+    Assembly,
+}
+
+impl ProfileStage {
+    pub const ALL: [ProfileStage; STAGES] = [
+        ProfileStage::Metadata,
+        ProfileStage::IoWait,
+        ProfileStage::Decompress,
+        ProfileStage::RowDecode,
+        ProfileStage::StringDecode,
+        ProfileStage::LabelMap,
+        ProfileStage::ChannelWait,
+        ProfileStage::Assembly,
+    ];
+
+    /// Key of the stage's time in [`ReadProfile::to_pairs`].
+    pub fn name(self) -> &'static str {
+        match self {
+            ProfileStage::Metadata => "metadata_ms",
+            ProfileStage::IoWait => "io_wait_ms",
+            ProfileStage::Decompress => "decompress_ms",
+            ProfileStage::RowDecode => "row_decode_ms",
+            ProfileStage::StringDecode => "string_decode_ms",
+            ProfileStage::LabelMap => "label_map_ms",
+            ProfileStage::ChannelWait => "channel_wait_ms",
+            ProfileStage::Assembly => "assembly_ms",
+        }
+    }
+}
+
+/// Counters shared by every thread of one profiled read. Times are nanoseconds;
+/// `first_ns`/`last_ns` are offsets from [`epoch`].
+struct Counters {
+    stage_ns: [AtomicU64; STAGES],
+    bytes_read: AtomicU64,
+    bytes_decompressed: AtomicU64,
+    rows: AtomicU64,
+    batches: AtomicU64,
+    busy_ns: AtomicU64,
+    first_ns: AtomicU64,
+    last_ns: AtomicU64,
+    threads: Mutex<HashSet<ThreadId>>,
+}
+
+impl Default for Counters {
+    fn default() -> Self {
+        Self {
+            stage_ns: Default::default(),
+            bytes_read: AtomicU64::new(0),
+            bytes_decompressed: AtomicU64::new(0),
+            rows: AtomicU64::new(0),
+            batches: AtomicU64::new(0),
+            busy_ns: AtomicU64::new(0),
+            first_ns: AtomicU64::new(u64::MAX),
+            last_ns: AtomicU64::new(0),
+            threads: Mutex::new(HashSet::new()),
+        }
+    }
+}
+
+fn epoch() -> Instant {
+    static EPOCH: OnceLock<Instant> = OnceLock::new();
+    *EPOCH.get_or_init(Instant::now)
+}
+
+fn since_epoch(t: Instant) -> u64 {
+    t.saturating_duration_since(epoch()).as_nanos() as u64
+}
+
+fn ms(ns: u64) -> f64 {
+    ns as f64 / 1_000_000.0
+}
+
+/// Collects the profile of one read. Clones share their counters, so the same
+/// profiler can be put in several `ScanOptions` (or reused across reads) and
+/// reports their sum.
+#[derive(Clone, Default)]
+pub struct ReadProfiler {
+    inner: Arc<Counters>,
+}
+
+impl std::fmt::Debug for ReadProfiler {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_tuple("ReadProfiler").field(&self.report()).finish()
+    }
+}
+
+impl ReadProfiler {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// The profile collected so far. Call it once the read is finished (the lazy
+    /// frame collected, the batch iterator drained or dropped).
+    pub fn report(&self) -> ReadProfile {
+        let c = &*self.inner;
+        let stage = |s: ProfileStage| ms(c.stage_ns[s as usize].load(Ordering::Relaxed));
+        let first = c.first_ns.load(Ordering::Relaxed);
+        let last = c.last_ns.load(Ordering::Relaxed);
+        let wall_ms = if first == u64::MAX {
+            0.0
+        } else {
+            ms(last.saturating_sub(first))
+        };
+        let threads = c.threads.lock().unwrap_or_else(|e| e.into_inner()).len();
+        let busy_ms = ms(c.busy_ns.load(Ordering::Relaxed));
+        let active_ms =
+            (busy_ms - stage(ProfileStage::IoWait) - stage(ProfileStage::ChannelWait)).max(0.0);
+        let thread_utilization = if wall_ms > 0.0 && threads > 0 {
+            (active_ms / (wall_ms * threads as f64)).min(1.0)
+        } else {
+            0.0
+        };
+        ReadProfile {
+            wall_ms,
+            metadata_ms: stage(ProfileStage::Metadata),
+            io_wait_ms: stage(ProfileStage::IoWait),
+            decompress_ms: stage(ProfileStage::Decompress),
+            row_decode_ms: stage(ProfileStage::RowDecode),
+            string_decode_ms: stage(ProfileStage::StringDecode),
+            label_map_ms: stage(ProfileStage::LabelMap),
+            channel_wait_ms: stage(ProfileStage::ChannelWait),
+            assembly_ms: stage(ProfileStage::Assembly),
+            bytes_read: c.bytes_read.load(Ordering::Relaxed),
+            bytes_decompressed: c.bytes_decompressed.load(Ordering::Relaxed),
+            rows: c.rows.load(Ordering::Relaxed),
+            batches: c.batches.load(Ordering::Relaxed),
+            threads,
+            busy_ms,
+            thread_utilization,
+        }
+    }
+
+    /// Make this the current profiler of the calling thread until the guard drops.
+    pub fn enter(&self) -> Entered {
+        enter(Some(self))
+    }
+}
+
+/// Profile of a read. Stage times are summed over all threads, so on a parallel
+/// read they can exceed `wall_ms`.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct ReadProfile {
+    /// From the first to the last moment any thread worked on the read.
+    pub wall_ms: f64,
+    pub metadata_ms: f64,
+    pub io_wait_ms: f64,
+    pub decompress_ms: f64,
+    pub row_decode_ms: f64,
+    pub string_decode_ms: f64,
+    pub label_map_ms: f64,
+    pub channel_wait_ms: f64,
+    pub assembly_ms: f64,
+    /// Bytes pulled from storage by buffered and range reads (mapped reads
+    /// fault pages in directly and are not counted).
+    pub bytes_read: u64,
+    /// Bytes produced by decompression.
+    pub bytes_decompressed: u64,
+    pub rows: u64,
+    pub batches: u64,
+    /// Distinct threads that worked on the read.
+    pub threads: usize,
+    /// Time those threads spent on the read, waits included.
+    pub busy_ms: f64,
+    /// `busy_ms` less I/O and channel waits, over `wall_ms * threads` (0..=1).
+    pub thread_utilization: f64,
+}
+
+impl ReadProfile {
+    /// Time spent in `stage`.
+    pub fn stage_ms(&self, stage: ProfileStage) -> f64 {
+        match stage {
+            ProfileStage::Metadata => self.metadata_ms,
+            ProfileStage::IoWait => self.io_wait_ms,
+            ProfileStage::Decompress => self.decompress_ms,
+            ProfileStage::RowDecode => self.row_decode_ms,
+            ProfileStage::StringDecode => self.string_decode_ms,
+            ProfileStage::LabelMap => self.label_map_ms,
+            ProfileStage::ChannelWait => self.channel_wait_ms,
+            ProfileStage::Assembly => self.assembly_ms,
+        }
+    }
+
+    /// Every field as a `(name, value)` pair, in declaration order.
+    pub fn to_pairs(&self) -> Vec<(&'static str, f64)> {
+        let mut pairs = vec![("wall_ms", self.wall_ms)];
+        pairs.extend(
+            ProfileStage::ALL
+                .iter()
+                .map(|&s| (s.name(), self.stage_ms(s))),
+        );
+        pairs.extend([
+            ("bytes_read", self.bytes_read as f64),
+            ("bytes_decompressed", self.bytes_decompressed as f64),
+            ("rows", self.rows as f64),
+            ("batches", self.batches as f64),
+            ("threads", self.threads as f64),
+            ("busy_ms", self.busy_ms),
+            ("thread_utilization", self.thread_utilization),
+        ]);
+        pairs
+    }
+}
+
+/// Per-thread state: the current profiler and the stack of open spans. Time
+/// since `mark` belongs to the innermost open span.
+struct ThreadState {
+    profiler: Option<Arc<Counters>>,
+    stack: Vec<ProfileStage>,
+    mark: Option<Instant>,
+    /// Inside [`Tally::time`]: the span depth it started at and the time spent in
+    /// spans opened there, which the tally leaves to those spans.
+    tally: Option<(usize, u64)>,
+}
+
+thread_local! {
+    static STATE: RefCell<ThreadState> = const {
+        RefCell::new(ThreadState {
+            profiler: None,
+            stack: Vec::new(),
+            mark: None,
+            tally: None,
+        })
+    };
+}
+
+/// Restores the previous current profiler when dropped.
+pub struct Entered {
+    /// Previous profiler and span stack, and when this thread started working
+    /// for the read; `None` when the profiler already was current.
+    restore: Option<(Option<Arc<Counters>>, Vec<ProfileStage>, Instant)>,
+}
+
+/// Make `profiler` current on this thread until the guard drops. Entering the
+/// profiler that is already current (a pool task run by its own consumer) is a
+/// no-op, so its time is not counted twice.
+pub(crate) fn enter(profiler: Option<&ReadProfiler>) -> Entered {
+    let Some(profiler) = profiler else {
+        return Entered { restore: None };
+    };
+    let already = STATE.with(|s| {
+        s.borrow()
+            .profiler
+            .as_ref()
+            .is_some_and(|p| Arc::ptr_eq(p, &profiler.inner))
+    });
+    if already {
+        return Entered { restore: None };
+    }
+    let counters = &profiler.inner;
+    let now = Instant::now();
+    counters
+        .first_ns
+        .fetch_min(since_epoch(now), Ordering::Relaxed);
+    counters
+        .threads
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+        .insert(std::thread::current().id());
+    let (previous, stack) = STATE.with(|s| {
+        let mut s = s.borrow_mut();
+        let previous = s.profiler.replace(counters.clone());
+        (previous, std::mem::take(&mut s.stack))
+    });
+    Entered {
+        restore: Some((previous, stack, now)),
+    }
+}
+
+impl Drop for Entered {
+    fn drop(&mut self) {
+        let Some((previous, stack, start)) = self.restore.take() else {
+            return;
+        };
+        let now = Instant::now();
+        STATE.with(|s| {
+            let mut s = s.borrow_mut();
+            if let Some(counters) = s.profiler.take() {
+                counters.busy_ns.fetch_add(
+                    now.duration_since(start).as_nanos() as u64,
+                    Ordering::Relaxed,
+                );
+                counters
+                    .last_ns
+                    .fetch_max(since_epoch(now), Ordering::Relaxed);
+            }
+            s.profiler = previous;
+            s.stack = stack;
+        });
+    }
+}
+
+/// The current profiler of this thread, to hand to work started elsewhere.
+pub(crate) fn current() -> Option<ReadProfiler> {
+    STATE.with(|s| {
+        s.borrow()
+            .profiler
+            .clone()
+            .map(|inner| ReadProfiler { inner })
+    })
+}
+
+/// Whether this thread is working for a profiled read.
+pub(crate) fn is_active() -> bool {
+    STATE.with(|s| s.borrow().profiler.is_some())
+}
+
+/// Charge the time since the last span change to the innermost open span.
+fn settle(s: &mut ThreadState, now: Instant) {
+    if let (Some(counters), Some(&top), Some(mark)) = (&s.profiler, s.stack.last(), s.mark) {
+        counters.stage_ns[top as usize].fetch_add(
+            now.duration_since(mark).as_nanos() as u64,
+            Ordering::Relaxed,
+        );
+    }
+    s.mark = Some(now);
+}
+
+/// Time in `stage` until the guard drops.
+pub(crate) struct Span {
+    /// When the span opened; `None` outside a profiled read.
+    start: Option<Instant>,
+}
+
+pub(crate) fn span(stage: ProfileStage) -> Span {
+    let start = STATE.with(|s| {
+        let mut s = s.borrow_mut();
+        s.profiler.as_ref()?;
+        let now = Instant::now();
+        settle(&mut s, now);
+        s.stack.push(stage);
+        Some(now)
+    });
+    Span { start }
+}
+
+impl Drop for Span {
+    fn drop(&mut self) {
+        if let Some(start) = self.start {
+            STATE.with(|s| {
+                let mut s = s.borrow_mut();
+                let now = Instant::now();
+                settle(&mut s, now);
+                s.stack.pop();
+                let depth = s.stack.len();
+                if let Some((base, nested)) = s.tally.as_mut() {
+                    if *base == depth {
+                        *nested += now.duration_since(start).as_nanos() as u64;
+                    }
+                }
+            });
+        }
+    }
+}
+
+/// Stage times of per-cell work (a label lookup, a string decode, a row's
+/// decompression), summed locally and charged when flushed or dropped, so a hot
+/// loop pays for a span once per batch rather than once per cell. Outside a
+/// profiled read [`Tally::time`] is a branch on a local flag.
+///
+/// The charged time is taken out of the innermost open span, like a nested span's
+/// would be; spans opened inside [`Tally::time`] (a buffer refill) keep their own
+/// time. Create, use and drop a tally on one thread, and do not nest its timings.
+pub(crate) struct Tally {
+    active: bool,
+    stage_ns: [u64; STAGES],
+    bytes_decompressed: u64,
+}
+
+impl Tally {
+    pub(crate) fn new() -> Self {
+        Self {
+            active: is_active(),
+            stage_ns: [0; STAGES],
+            bytes_decompressed: 0,
+        }
+    }
+
+    /// Run `f`, counting its time as `stage`.
+    #[inline]
+    pub(crate) fn time<T>(&mut self, stage: ProfileStage, f: impl FnOnce() -> T) -> T {
+        let mark = self.start();
+        let out = f();
+        self.stop(stage, mark);
+        out
+    }
+
+    /// Start timing work that cannot be put in a closure; hand the mark to
+    /// [`Tally::stop`] on every path out of it.
+    #[inline]
+    pub(crate) fn start(&mut self) -> Option<TallyMark> {
+        if !self.active {
+            return None;
+        }
+        let outer = STATE.with(|s| {
+            let mut s = s.borrow_mut();
+            let depth = s.stack.len();
+            s.tally.replace((depth, 0))
+        });
+        Some(TallyMark {
+            start: Instant::now(),
+            outer,
+        })
+    }
+
+    #[inline]
+    pub(crate) fn stop(&mut self, stage: ProfileStage, mark: Option<TallyMark>) {
+        let Some(mark) = mark else {
+            return;
+        };
+        let elapsed = mark.start.elapsed().as_nanos() as u64;
+        let nested = STATE.with(|s| {
+            let mut s = s.borrow_mut();
+            std::mem::replace(&mut s.tally, mark.outer).map_or(0, |(_, nested)| nested)
+        });
+        self.stage_ns[stage as usize] += elapsed.saturating_sub(nested);
+    }
+
+    #[inline]
+    pub(crate) fn add_bytes_decompressed(&mut self, n: usize) {
+        if self.active {
+            self.bytes_decompressed += n as u64;
+        }
+    }
+
+    /// Charge what was counted so far to the current profiler.
+    pub(crate) fn flush(&mut self) {
+        if self.active {
+            STATE.with(|s| {
+                let mut s = s.borrow_mut();
+                settle(&mut s, Instant::now());
+                let Some(counters) = s.profiler.as_deref() else {
+                    return;
+                };
+                let total: u64 = self.stage_ns.iter().sum();
+                if let Some(&top) = s.stack.last() {
+                    let _ = counters.stage_ns[top as usize].fetch_update(
+                        Ordering::Relaxed,
+                        Ordering::Relaxed,
+                        |ns| Some(ns.saturating_sub(total)),
+                    );
+                }
+                for (stage, ns) in self.stage_ns.iter().enumerate() {
+                    if *ns > 0 {
+                        counters.stage_ns[stage].fetch_add(*ns, Ordering::Relaxed);
+                    }
+                }
+                counters
+                    .bytes_decompressed
+                    .fetch_add(self.bytes_decompressed, Ordering::Relaxed);
+            });
+        }
+        self.stage_ns = [0; STAGES];
+        self.bytes_decompressed = 0;
+        self.active = is_active();
+    }
+}
+
+/// Where a [`Tally::start`] began.
+pub(crate) struct TallyMark {
+    start: Instant,
+    outer: Option<(usize, u64)>,
+}
+
+impl Drop for Tally {
+    fn drop(&mut self) {
+        self.flush();
+    }
+}
+
+fn add(f: impl FnOnce(&Counters)) {
+    STATE.with(|s| {
+        if let Some(counters) = s.borrow().profiler.as_deref() {
+            f(counters);
+        }
+    });
+}
+
+pub(crate) fn add_bytes_read(n: usize) {
+    add(|c| {
+        c.bytes_read.fetch_add(n as u64, Ordering::Relaxed);
+    });
+}
+
+pub(crate) fn add_bytes_decompressed(n: usize) {
+    add(|c| {
+        c.bytes_decompressed.fetch_add(n as u64, Ordering::Relaxed);
+    });
+}
+
+/// Count one finished batch of `rows` rows.
+pub(crate) fn add_batch(rows: usize) {
+    add(|c| {
+        c.rows.fetch_add(rows as u64, Ordering::Relaxed);
+        c.batches.fetch_add(1, Ordering::Relaxed);
+    });
+}
+
+/// Run the blocking channel hand-off `f` (a send to a full queue, a receive from
+/// an empty one) as [`ProfileStage::ChannelWait`].
+pub(crate) fn wait<T>(f: impl FnOnce() -> T) -> T {
+    let _wait = span(ProfileStage::ChannelWait);
+    f()
+}
+
+/// `std::thread::spawn` for a reader's background thread: the thread works
+/// under the spawning thread's current profiler.
+pub(crate) fn spawn<F, T>(f: F) -> JoinHandle<T>
+where
+    F: FnOnce() -> T + Send + 'static,
+    T: Send + 'static,
+{
+    let profiler = current();
+    std::thread::spawn(move || {
+        let _profile = enter(profiler.as_ref());
+        f()
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::time::Duration;
+
+    #[test]
+    fn test_spans_are_exclusive_and_follow_threads() {
+        let profiler = ReadProfiler::new();
+        {
+            let _profile = profiler.enter();
+            let _decode = span(ProfileStage::RowDecode);
+            {
+                let _io = span(ProfileStage::IoWait);
+                add_bytes_read(100);
+                std::thread::sleep(Duration::from_millis(20));
+            }
+            add_batch(10);
+            spawn(|| {
+                let _labels = span(ProfileStage::LabelMap);
+                add_batch(5);
+            })
+            .join()
+            .unwrap();
+        }
+        // Outside the read nothing is recorded.
+        add_batch(1);
+        let _ignored = span(ProfileStage::Assembly);
+
+        let report = profiler.report();
+        assert!(report.io_wait_ms >= 20.0);
+        assert!(report.row_decode_ms < report.io_wait_ms);
+        assert_eq!(report.assembly_ms, 0.0);
+        assert_eq!(report.bytes_read, 100);
+        assert_eq!((report.rows, report.batches), (15, 2));
+        assert_eq!(report.threads, 2);
+        assert!(report.wall_ms >= report.io_wait_ms);
+        assert!((0.0..=1.0).contains(&report.thread_utilization));
+        assert_eq!(report.to_pairs().len(), 16);
+    }
+
+    #[test]
+    fn test_tally_charges_once_and_leaves_nested_spans() {
+        let profiler = ReadProfiler::new();
+        {
+            let _profile = profiler.enter();
+            let _decode = span(ProfileStage::RowDecode);
+            let mut tally = Tally::new();
+            for _ in 0..3 {
+                tally.time(ProfileStage::LabelMap, || {
+                    std::thread::sleep(Duration::from_millis(5))
+                });
+            }
+            tally.time(ProfileStage::Decompress, || {
+                wait_on_io();
+            });
+            tally.add_bytes_decompressed(64);
+            // Nothing is charged until the tally is flushed.
+            assert_eq!(profiler.report().label_map_ms, 0.0);
+            drop(tally);
+        }
+        let report = profiler.report();
+        assert!(report.label_map_ms >= 15.0);
+        assert!(report.io_wait_ms >= 10.0);
+        assert!(report.decompress_ms < report.io_wait_ms);
+        assert!(report.row_decode_ms < report.label_map_ms);
+        assert_eq!(report.bytes_decompressed, 64);
+
+        // Outside a read a tally records nothing.
+        let mut idle = Tally::new();
+        assert_eq!(idle.time(ProfileStage::LabelMap, || 7), 7);
+        drop(idle);
+        assert_eq!(profiler.report().label_map_ms, report.label_map_ms);
+    }
+
+    fn wait_on_io() {
+        let _io = span(ProfileStage::IoWait);
+        std::thread::sleep(Duration::from_millis(10));
+    }
+}
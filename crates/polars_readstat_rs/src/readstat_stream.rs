@@ -1,18 +1,29 @@
 use crate::compress_df_if_enabled;
 use crate::sas::polars_output::sas_batch_iter_with_reader;
+use crate::scan_prefetch::bounded_batches;
 use crate::spss::polars_output::spss_batch_iter;
 use crate::stata::polars_output::stata_batch_iter;
-use crate::{ReadStatFormat, ScanOptions};
+use crate::{ReadProfiler, ReadStatFormat, ScanOptions};
 use polars::prelude::{DataFrame, PolarsError, PolarsResult};
 use std::path::Path;
 
 pub struct ReadstatBatchIter {
     inner: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>,
+    /// `ScanOptions::profile`; entered for every batch pulled.
+    profiler: Option<ReadProfiler>,
 }
 
 impl ReadstatBatchIter {
-    fn new(inner: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>) -> Self {
-        Self { inner }
+    pub(crate) fn new(inner: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>) -> Self {
+        Self {
+            inner,
+            profiler: None,
+        }
+    }
+
+    pub(crate) fn with_profiler(mut self, profiler: Option<ReadProfiler>) -> Self {
+        self.profiler = profiler;
+        self
     }
 }
 
@@ -20,7 +31,12 @@ impl Iterator for ReadstatBatchIter {
     type Item = PolarsResult<DataFrame>;
 
     fn next(&mut self) -> Option<Self::Item> {
-        self.inner.next()
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let batch = self.inner.next();
+        if let Some(Ok(df)) = &batch {
+            crate::read_profile::add_batch(df.height());
+        }
+        batch
     }
 }
 
@@ -57,9 +73,40 @@ pub fn readstat_batch_iter(
     columns: Option<Vec<String>>,
     n_rows: Option<usize>,
     batch_size: Option<usize>,
+) -> PolarsResult<ReadstatBatchIter> {
+    if let Some(opts) = opts.as_ref().filter(|o| o.sample.is_some()) {
+        let path = path.as_ref();
+        let format = format
+            .or_else(|| super::detect_format(path))
+            .ok_or_else(|| PolarsError::ComputeError("unknown file extension".into()))?;
+        return crate::sample::sample_batch_iter(
+            path,
+            opts.clone(),
+            format,
+            columns,
+            n_rows,
+            batch_size,
+        );
+    }
+    readstat_batch_iter_range(path, opts, format, columns, 0, n_rows, batch_size)
+}
+
+/// [`readstat_batch_iter`] starting at row `offset`; the row index, if any, still
+/// counts from the start of the file.
+pub(crate) fn readstat_batch_iter_range(
+    path: impl AsRef<Path>,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    columns: Option<Vec<String>>,
+    offset: usize,
+    n_rows: Option<usize>,
+    batch_size: Option<usize>,
 ) -> PolarsResult<ReadstatBatchIter> {
     let path = path.as_ref();
     let opts = opts.unwrap_or_default();
+    // Opening the reader (header, metadata, first prefetch) is part of the read.
+    let profiler = opts.profile.clone();
+    let _profile = crate::read_profile::enter(profiler.as_ref());
     let format = format
         .or_else(|| super::detect_format(path))
         .ok_or_else(|| PolarsError::ComputeError("unknown file extension".into()))?;
@@ -73,13 +120,23 @@ pub fn readstat_batch_iter(
     }
     let columns = columns.and_then(|cols| if cols.is_empty() { None } else { Some(cols) });
 
-    let chunk_size = batch_size.or(opts.chunk_size);
+    let (chunk_size, handoff_budget) = crate::mem_budget::plan_stream(
+        path,
+        format,
+        columns.as_deref(),
+        opts.memory_budget,
+        opts.threads,
+        batch_size.or(opts.chunk_size),
+    )?;
     let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
     let value_labels_as_strings = opts.value_labels_as_strings.unwrap_or(true);
     let preserve_order = opts.preserve_order.unwrap_or(false);
+    let row_filter = opts.row_filter.clone().map(std::sync::Arc::new);
+    let use_mmap = opts.use_mmap.unwrap_or(false);
+    let read_ahead = opts.read_ahead;
     let iter: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send> = match format {
         ReadStatFormat::Sas => {
-            let reader = crate::sas::reader::Sas7bdatReader::open(path)
+            let reader = crate::sas::reader::Sas7bdatReader::open_cached(path)
                 .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
             let col_indices = columns
                 .as_ref()
@@ -92,12 +149,15 @@ pub fn readstat_batch_iter(
                 missing_string_as_null,
                 chunk_size,
                 col_indices,
-                0,
+                offset,
                 n_rows,
                 preserve_order,
                 row_index_name.clone(),
                 opts.informative_nulls.clone(),
                 false,
+                row_filter,
+                use_mmap,
+                read_ahead,
             )?;
             Box::new(iter)
         }
@@ -110,7 +170,7 @@ pub fn readstat_batch_iter(
                 preserve_order,
                 row_index_name.clone(),
                 columns,
-                0,
+                offset,
                 n_rows,
             )?
         }
@@ -120,13 +180,17 @@ pub fn readstat_batch_iter(
                 opts.threads,
                 missing_string_as_null,
                 value_labels_as_strings,
+                opts.value_labels_as_categorical.unwrap_or(false),
                 chunk_size,
                 preserve_order,
                 row_index_name.clone(),
                 columns,
-                0,
+                offset,
                 n_rows,
                 opts.informative_nulls.clone(),
+                row_filter,
+                use_mmap,
+                read_ahead,
             )?;
             Box::new(iter)
         }
@@ -136,29 +200,44 @@ pub fn readstat_batch_iter(
                 opts.threads,
                 missing_string_as_null,
                 value_labels_as_strings,
+                opts.value_labels_as_categorical.unwrap_or(false),
                 chunk_size,
                 preserve_order,
                 row_index_name.clone(),
                 columns,
-                0,
+                offset,
                 n_rows,
                 opts.informative_nulls.clone(),
+                row_filter,
+                use_mmap,
+                read_ahead,
             )?;
             Box::new(iter)
         }
+        ReadStatFormat::Por => crate::spss::por::por_batch_iter(
+            path.to_path_buf(),
+            missing_string_as_null,
+            chunk_size,
+            row_index_name.clone(),
+            columns,
+            offset,
+            n_rows,
+        )?,
     };
 
-    if opts.compress_opts.enabled {
-        let compress_opts = opts.compress_opts;
-        let mapped = iter.map(move |batch| {
-            let df = batch?;
-            compress_df_if_enabled(&df, &compress_opts)
-                .map_err(|e| PolarsError::ComputeError(e.into()))
-        });
-        Ok(ReadstatBatchIter::new(Box::new(mapped)))
-    } else {
-        Ok(ReadstatBatchIter::new(iter))
-    }
+    let iter: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send> =
+        if opts.compress_opts.enabled {
+            let compress_opts = opts.compress_opts;
+            Box::new(iter.map(move |batch| {
+                let df = batch?;
+                compress_df_if_enabled(&df, &compress_opts)
+                    .map_err(|e| PolarsError::ComputeError(e.into()))
+            }))
+        } else {
+            iter
+        };
+
+    Ok(ReadstatBatchIter::new(bounded_batches(iter, handoff_budget)).with_profiler(profiler))
 }
 
 fn resolve_sas_column_indices(
@@ -0,0 +1,495 @@
+//! Row filters evaluated against raw row bytes, before any column builder is touched.
+//!
+//! A [`RowFilter`] is a conjunction of simple comparisons and is-in tests on single
+//! columns. Each reader compiles it against its own column layout and drops rows
+//! that definitely fail; terms it cannot evaluate exactly (temporal columns,
+//! value-labelled columns, strL, ...) are skipped. Pushdown is therefore never
+//! stricter than the original predicate, and scans still apply the full Polars
+//! predicate to the surviving rows.
+
+use polars::prelude::*;
+use std::collections::HashSet;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FilterOp {
+    Eq,
+    NotEq,
+    Lt,
+    LtEq,
+    Gt,
+    GtEq,
+}
+
+impl FilterOp {
+    /// The operator with its operands swapped (`lit < col` == `col > lit`).
+    fn flipped(self) -> Self {
+        match self {
+            FilterOp::Eq => FilterOp::Eq,
+            FilterOp::NotEq => FilterOp::NotEq,
+            FilterOp::Lt => FilterOp::Gt,
+            FilterOp::LtEq => FilterOp::GtEq,
+            FilterOp::Gt => FilterOp::Lt,
+            FilterOp::GtEq => FilterOp::LtEq,
+        }
+    }
+
+    /// Whether a NaN passes `NaN <op> x` for a number `x`. Polars compares NaN
+    /// as greater than every number.
+    pub(crate) fn passes_nan(self) -> bool {
+        matches!(self, FilterOp::NotEq | FilterOp::Gt | FilterOp::GtEq)
+    }
+
+    fn eval<T: PartialOrd + ?Sized>(self, lhs: &T, rhs: &T) -> bool {
+        match self {
+            FilterOp::Eq => lhs == rhs,
+            FilterOp::NotEq => lhs != rhs,
+            FilterOp::Lt => lhs < rhs,
+            FilterOp::LtEq => lhs <= rhs,
+            FilterOp::Gt => lhs > rhs,
+            FilterOp::GtEq => lhs >= rhs,
+        }
+    }
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub enum FilterValue {
+    Num(f64),
+    Str(String),
+}
+
+/// A row predicate that readers can evaluate on raw row bytes.
+///
+/// Comparisons against a null value are false, matching Polars filter semantics.
+#[derive(Debug, Clone, PartialEq)]
+pub enum RowFilter {
+    Compare {
+        column: String,
+        op: FilterOp,
+        value: FilterValue,
+    },
+    IsIn {
+        column: String,
+        values: Vec<FilterValue>,
+    },
+    And(Vec<RowFilter>),
+}
+
+impl RowFilter {
+    pub fn compare(column: impl Into<String>, op: FilterOp, value: FilterValue) -> Self {
+        RowFilter::Compare {
+            column: column.into(),
+            op,
+            value,
+        }
+    }
+
+    pub fn is_in(column: impl Into<String>, values: Vec<FilterValue>) -> Self {
+        RowFilter::IsIn {
+            column: column.into(),
+            values,
+        }
+    }
+
+    /// Translate the pushable part of a Polars predicate.
+    ///
+    /// Recognises `col <op> literal` (either side), `col.is_in(literal list)`, `&` of
+    /// such terms, and `|`-chains of equalities and is-ins on one column (treated as
+    /// is-in). Conjuncts that cannot be
+    /// expressed are dropped, so the result may be looser than `expr` but never
+    /// stricter. Returns `None` when nothing can be pushed.
+    pub fn from_expr(expr: &Expr) -> Option<Self> {
+        let mut terms = Vec::new();
+        collect_conjuncts(expr, &mut terms);
+        match terms.len() {
+            0 => None,
+            1 => terms.pop(),
+            _ => Some(RowFilter::And(terms)),
+        }
+    }
+
+    /// Flatten into `(column, test)` pairs. Is-in lists that mix numbers and
+    /// strings cannot match a typed column and are skipped.
+    pub(crate) fn terms(&self) -> Vec<(&str, FilterTest)> {
+        let mut out = Vec::new();
+        self.collect_terms(&mut out);
+        out
+    }
+
+    fn collect_terms<'a>(&'a self, out: &mut Vec<(&'a str, FilterTest)>) {
+        match self {
+            RowFilter::Compare { column, op, value } => {
+                let test = match value {
+                    FilterValue::Num(v) if v.is_nan() => return,
+                    FilterValue::Num(v) => FilterTest::Num { op: *op, value: *v },
+                    FilterValue::Str(s) => FilterTest::Str {
+                        op: *op,
+                        value: s.clone(),
+                    },
+                };
+                out.push((column.as_str(), test));
+            }
+            RowFilter::IsIn { column, values } => {
+                let nums: Option<Vec<f64>> = values
+                    .iter()
+                    .map(|v| match v {
+                        FilterValue::Num(n) if !n.is_nan() => Some(*n),
+                        _ => None,
+                    })
+                    .collect();
+                if let Some(nums) = nums {
+                    out.push((column.as_str(), FilterTest::NumIn(nums)));
+                    return;
+                }
+                let strs: Option<HashSet<String>> = values
+                    .iter()
+                    .map(|v| match v {
+                        FilterValue::Str(s) => Some(s.clone()),
+                        _ => None,
+                    })
+                    .collect();
+                if let Some(strs) = strs {
+                    out.push((column.as_str(), FilterTest::StrIn(strs)));
+                }
+            }
+            RowFilter::And(parts) => {
+                for part in parts {
+                    part.collect_terms(out);
+                }
+            }
+        }
+    }
+}
+
+/// One compiled single-column test.
+#[derive(Debug, Clone)]
+pub(crate) enum FilterTest {
+    Num { op: FilterOp, value: f64 },
+    Str { op: FilterOp, value: String },
+    NumIn(Vec<f64>),
+    StrIn(HashSet<String>),
+}
+
+impl FilterTest {
+    pub(crate) fn is_numeric(&self) -> bool {
+        matches!(self, FilterTest::Num { .. } | FilterTest::NumIn(_))
+    }
+
+    /// True when every numeric operand is exactly representable as f32, so that
+    /// comparing a widened f32 value in f64 agrees with comparing in f32.
+    pub(crate) fn f32_exact(&self) -> bool {
+        let exact = |v: f64| (v as f32) as f64 == v;
+        match self {
+            FilterTest::Num { value, .. } => exact(*value),
+            FilterTest::NumIn(values) => values.iter().all(|v| exact(*v)),
+            _ => false,
+        }
+    }
+
+    #[inline]
+    pub(crate) fn eval_num(&self, v: Option<f64>) -> bool {
+        let Some(v) = v else {
+            return false;
+        };
+        match self {
+            FilterTest::Num { op, .. } if v.is_nan() => op.passes_nan(),
+            FilterTest::Num { op, value } => op.eval(&v, value),
+            FilterTest::NumIn(values) => values.iter().any(|x| *x == v),
+            _ => false,
+        }
+    }
+
+    #[inline]
+    pub(crate) fn eval_str(&self, s: Option<&str>) -> bool {
+        let Some(s) = s else {
+            return false;
+        };
+        match self {
+            FilterTest::Str { op, value } => op.eval(s, value.as_str()),
+            FilterTest::StrIn(values) => values.contains(s),
+            _ => false,
+        }
+    }
+}
+
+fn collect_conjuncts(expr: &Expr, out: &mut Vec<RowFilter>) {
+    match expr {
+        Expr::BinaryExpr { left, op, right } => match op {
+            Operator::And | Operator::LogicalAnd => {
+                collect_conjuncts(left, out);
+                collect_conjuncts(right, out);
+            }
+            Operator::Or | Operator::LogicalOr => {
+                if let Some(f) = or_chain_to_is_in(expr) {
+                    out.push(f);
+                }
+            }
+            _ => {
+                if let Some(f) = comparison(left, *op, right) {
+                    out.push(f);
+                }
+            }
+        },
+        Expr::Function { .. } => {
+            if let Some((column, values)) = is_in_function(expr) {
+                out.push(RowFilter::is_in(column, values));
+            }
+        }
+        _ => {}
+    }
+}
+
+fn comparison(left: &Expr, op: Operator, right: &Expr) -> Option<RowFilter> {
+    let op = match op {
+        Operator::Eq => FilterOp::Eq,
+        Operator::NotEq => FilterOp::NotEq,
+        Operator::Lt => FilterOp::Lt,
+        Operator::LtEq => FilterOp::LtEq,
+        Operator::Gt => FilterOp::Gt,
+        Operator::GtEq => FilterOp::GtEq,
+        _ => return None,
+    };
+    match (left, right) {
+        (Expr::Column(name), lit) => Some(RowFilter::compare(name.as_str(), op, literal(lit)?)),
+        (lit, Expr::Column(name)) => Some(RowFilter::compare(
+            name.as_str(),
+            op.flipped(),
+            literal(lit)?,
+        )),
+        _ => None,
+    }
+}
+
+/// `col.is_in(values)` with a literal list of values. With `nulls_equal` a null in
+/// the list would keep null rows, which row filters never do, so that is not pushed.
+fn is_in_function(expr: &Expr) -> Option<(String, Vec<FilterValue>)> {
+    let Expr::Function {
+        input,
+        function: FunctionExpr::Boolean(BooleanFunction::IsIn { nulls_equal }),
+    } = expr
+    else {
+        return None;
+    };
+    let [Expr::Column(name), other] = input.as_slice() else {
+        return None;
+    };
+    let mut values = Vec::new();
+    for v in literal_list(other)?.iter() {
+        match v {
+            AnyValue::Null if *nulls_equal => return None,
+            AnyValue::Null => {}
+            v => values.push(filter_value(v)?),
+        }
+    }
+    Some((name.to_string(), values))
+}
+
+/// The values of a literal Series, list scalar, or imploded literal.
+fn literal_list(expr: &Expr) -> Option<Series> {
+    match expr {
+        Expr::Agg(AggExpr::Implode(inner)) => literal_list(inner),
+        Expr::Literal(LiteralValue::Series(s)) => Some((**s).clone()),
+        Expr::Literal(lit) => match lit.to_any_value()? {
+            AnyValue::List(s) => Some(s),
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+/// `(col == a) | (col == b) | col.is_in([c, d]) | ...` on a single column.
+fn or_chain_to_is_in(expr: &Expr) -> Option<RowFilter> {
+    fn walk(expr: &Expr, column: &mut Option<String>, values: &mut Vec<FilterValue>) -> bool {
+        match expr {
+            Expr::BinaryExpr { left, op, right } => match op {
+                Operator::Or | Operator::LogicalOr => {
+                    walk(left, column, values) && walk(right, column, values)
+                }
+                Operator::Eq => match comparison(left, *op, right) {
+                    Some(RowFilter::Compare {
+                        column: name,
+                        value,
+                        ..
+                    }) => {
+                        if column.get_or_insert_with(|| name.clone()) != &name {
+                            return false;
+                        }
+                        values.push(value);
+                        true
+                    }
+                    _ => false,
+                },
+                _ => false,
+            },
+            Expr::Function { .. } => match is_in_function(expr) {
+                Some((name, list)) => {
+                    if column.get_or_insert_with(|| name.clone()) != &name {
+                        return false;
+                    }
+                    values.extend(list);
+                    true
+                }
+                None => false,
+            },
+            _ => false,
+        }
+    }
+    let mut column = None;
+    let mut values = Vec::new();
+    if !walk(expr, &mut column, &mut values) {
+        return None;
+    }
+    Some(RowFilter::is_in(column?, values))
+}
+
+fn literal(expr: &Expr) -> Option<FilterValue> {
+    let Expr::Literal(lit) = expr else {
+        return None;
+    };
+    filter_value(lit.to_any_value()?)
+}
+
+fn filter_value(value: AnyValue) -> Option<FilterValue> {
+    match value {
+        AnyValue::String(s) => Some(FilterValue::Str(s.to_string())),
+        AnyValue::StringOwned(s) => Some(FilterValue::Str(s.to_string())),
+        AnyValue::Int8(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::Int16(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::Int32(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::Int64(v) if v.unsigned_abs() <= (1u64 << 53) => Some(FilterValue::Num(v as f64)),
+        AnyValue::UInt8(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::UInt16(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::UInt32(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::UInt64(v) if v <= (1u64 << 53) => Some(FilterValue::Num(v as f64)),
+        AnyValue::Float32(v) => Some(FilterValue::Num(v as f64)),
+        AnyValue::Float64(v) => Some(FilterValue::Num(v)),
+        _ => None,
+    }
+}
+
+/// Source columns referenced by a pushed-down predicate but missing from the scan's
+/// projection. Scans read these as well so the full predicate can be applied, then
+/// drop them again with [`apply_residual_predicate`].
+pub(crate) fn predicate_extra_columns(
+    predicate: &Expr,
+    with_columns: Option<&[PlSmallStr]>,
+    is_source_column: impl Fn(&str) -> bool,
+) -> Vec<PlSmallStr> {
+    let Some(with_columns) = with_columns else {
+        return Vec::new();
+    };
+    let mut extra: Vec<PlSmallStr> = Vec::new();
+    for e in predicate.into_iter() {
+        if let Expr::Column(name) = e {
+            if is_source_column(name.as_str())
+                && !with_columns.contains(name)
+                && !extra.contains(name)
+            {
+                extra.push(name.clone());
+            }
+        }
+    }
+    extra
+}
+
+/// Apply the full predicate to the rows a reader kept, then drop the helper columns
+/// added by [`predicate_extra_columns`].
+pub(crate) fn apply_residual_predicate(
+    df: DataFrame,
+    predicate: Option<&Expr>,
+    extra_columns: &[PlSmallStr],
+) -> PolarsResult<DataFrame> {
+    let Some(predicate) = predicate else {
+        return Ok(df);
+    };
+    if df.width() == 0 {
+        // Nothing was read (e.g. every batch was filtered out by the workers).
+        return Ok(df);
+    }
+    let df = df.lazy().filter(predicate.clone()).collect()?;
+    if extra_columns.is_empty() {
+        Ok(df)
+    } else {
+        Ok(df.drop_many(extra_columns.iter().cloned()))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_from_expr_conjunction() {
+        let expr = col("age").gt(lit(30)).and(lit("CA").eq(col("state")));
+        let filter = RowFilter::from_expr(&expr).expect("pushable");
+        let terms = filter.terms();
+        assert_eq!(terms.len(), 2);
+        assert_eq!(terms[0].0, "age");
+        assert!(terms[0].1.eval_num(Some(31.0)));
+        assert!(!terms[0].1.eval_num(Some(30.0)));
+        assert!(!terms[0].1.eval_num(None));
+        // NaN is above every number, as in Polars.
+        assert!(terms[0].1.eval_num(Some(f64::NAN)));
+        assert_eq!(terms[1].0, "state");
+        assert!(terms[1].1.eval_str(Some("CA")));
+        assert!(!terms[1].1.eval_str(Some("NY")));
+    }
+
+    #[test]
+    fn test_from_expr_or_chain_is_in() {
+        let expr = col("x").eq(lit(1)).or(col("x").eq(lit(3)));
+        let filter = RowFilter::from_expr(&expr).expect("pushable");
+        let terms = filter.terms();
+        assert_eq!(terms.len(), 1);
+        assert!(terms[0].1.eval_num(Some(3.0)));
+        assert!(!terms[0].1.eval_num(Some(2.0)));
+
+        // Different columns cannot be folded into one is-in.
+        let expr = col("x").eq(lit(1)).or(col("y").eq(lit(3)));
+        assert!(RowFilter::from_expr(&expr).is_none());
+    }
+
+    #[test]
+    fn test_from_expr_is_in_function() {
+        let list = lit(Series::new("".into(), [1.5f64, 4.0])).implode();
+        let expr = col("x").is_in(list, false).and(col("y").gt(lit(0)));
+        let filter = RowFilter::from_expr(&expr).expect("pushable");
+        let terms = filter.terms();
+        assert_eq!(terms.len(), 2);
+        assert_eq!(terms[0].0, "x");
+        assert!(terms[0].1.eval_num(Some(4.0)));
+        assert!(!terms[0].1.eval_num(Some(2.0)));
+
+        // Folded into an or-chain on the same column.
+        let names = lit(Series::new("".into(), ["a", "b"])).implode();
+        let expr = col("s").is_in(names, false).or(col("s").eq(lit("c")));
+        let terms = RowFilter::from_expr(&expr).expect("pushable").terms();
+        assert!(terms[0].1.eval_str(Some("c")));
+        assert!(terms[0].1.eval_str(Some("b")));
+        assert!(!terms[0].1.eval_str(Some("d")));
+
+        // A null that matches null rows cannot be pushed.
+        let with_null = lit(Series::new("".into(), [Some(1.0f64), None])).implode();
+        assert!(RowFilter::from_expr(&col("x").is_in(with_null, true)).is_none());
+    }
+
+    #[test]
+    fn test_from_expr_keeps_pushable_conjuncts_only() {
+        let expr = col("x").gt(lit(1)).and((col("x") + col("y")).gt(lit(2)));
+        let filter = RowFilter::from_expr(&expr).expect("pushable");
+        assert_eq!(filter.terms().len(), 1);
+    }
+
+    #[test]
+    fn test_f32_exact() {
+        assert!(FilterTest::Num {
+            op: FilterOp::Eq,
+            value: 0.5
+        }
+        .f32_exact());
+        assert!(!FilterTest::Num {
+            op: FilterOp::Eq,
+            value: 0.1
+        }
+        .f32_exact());
+    }
+}
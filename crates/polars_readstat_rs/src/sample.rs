@@ -0,0 +1,695 @@
+//! Random samples read at the source.
+//!
+//! With [`ScanOptions::sample`] set, the rows to keep are chosen from the row
+//! count in the file header before anything is decoded, and only the row ranges
+//! holding them are read. Each range goes through the format's own offset read:
+//! fixed-width Stata, XPT and uncompressed SPSS records are seeked to directly,
+//! and sas7bdat seeks to the page holding the first row with a page index built
+//! once per file (from the page count alone when an uncompressed file's DATA pages
+//! are all full, otherwise with one pass over the page headers). Bytecode `.sav`
+//! rows have no fixed position, so one pass over the control bytes records a
+//! checkpoint every block and each range starts decompressing at the checkpoint
+//! before it. `.zsav` rows can only be reached by inflating everything before
+//! them, so the span from the first to the last sampled row is read in one pass
+//! and the rows in between are dropped as they are decoded.
+//!
+//! There are two modes:
+//!
+//! - [`SampleMode::Blocks`] picks whole blocks of consecutive rows. Everything
+//!   outside the chosen blocks is skipped, so a 1% sample reads about 1% of the
+//!   file. Rows within a block are not independent of each other; use it for
+//!   exploration where clustering does not matter.
+//! - [`SampleMode::Rows`] picks individual rows uniformly. Ranges between sampled
+//!   rows shorter than a block are decoded and dropped rather than seeked over,
+//!   so sparse samples skip most of the file while dense ones decode most of it.
+//!   Only the sampled rows are ever held.
+//!
+//! Either way the sample is returned in file order and depends only on the file's
+//! row count, the options and the seed. Rows (or blocks) are chosen by sequential
+//! selection, in increasing order and as they are read, so the plan never holds
+//! more than the run being read.
+
+use crate::readstat_stream::{readstat_batch_iter_range, ReadstatBatchIter};
+use crate::{ReadStatFormat, ScanOptions};
+use polars::prelude::*;
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+/// Rows per block when the caller does not choose.
+pub const DEFAULT_SAMPLE_BLOCK_ROWS: usize = 10_000;
+
+/// How many rows [`SampleOptions`] asks for.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum SampleSize {
+    /// This share of the file's rows, between 0 and 1.
+    Fraction(f64),
+    /// This many rows (all of them if the file is shorter).
+    Rows(usize),
+}
+
+/// Granularity of a sample; see the [module docs](self).
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum SampleMode {
+    /// Whole blocks of `block_rows` consecutive rows. A `Rows(n)` size takes
+    /// `ceil(n / block_rows)` blocks and trims the result to `n` rows; when the
+    /// short last block of the file is among them the sample can be a little
+    /// smaller than `n`.
+    #[default]
+    Blocks,
+    /// Individual rows, exactly the requested number.
+    Rows,
+}
+
+/// A random sample of the rows of a file, taken by the reader.
+#[derive(Debug, Clone, PartialEq)]
+pub struct SampleOptions {
+    pub size: SampleSize,
+    pub mode: SampleMode,
+    /// Seed of the row choice; the same seed picks the same rows.
+    pub seed: u64,
+    /// Rows per block: the sampling unit in `Blocks` mode and the longest gap
+    /// between sampled rows that is read through instead of seeked over in `Rows`
+    /// mode (default [`DEFAULT_SAMPLE_BLOCK_ROWS`]).
+    pub block_rows: Option<usize>,
+}
+
+impl SampleOptions {
+    pub fn fraction(fraction: f64) -> Self {
+        Self::new(SampleSize::Fraction(fraction))
+    }
+
+    pub fn rows(n: usize) -> Self {
+        Self::new(SampleSize::Rows(n))
+    }
+
+    fn new(size: SampleSize) -> Self {
+        Self {
+            size,
+            mode: SampleMode::default(),
+            seed: 0,
+            block_rows: None,
+        }
+    }
+
+    pub fn with_mode(mut self, mode: SampleMode) -> Self {
+        self.mode = mode;
+        self
+    }
+
+    pub fn with_seed(mut self, seed: u64) -> Self {
+        self.seed = seed;
+        self
+    }
+
+    pub fn with_block_rows(mut self, block_rows: usize) -> Self {
+        self.block_rows = Some(block_rows);
+        self
+    }
+
+    fn block_len(&self) -> u64 {
+        self.block_rows.unwrap_or(DEFAULT_SAMPLE_BLOCK_ROWS).max(1) as u64
+    }
+}
+
+/// SplitMix64: small, seedable and good enough to pick rows.
+#[derive(Clone)]
+struct SplitMix64(u64);
+
+impl SplitMix64 {
+    fn next_u64(&mut self) -> u64 {
+        self.0 = self.0.wrapping_add(0x9E37_79B9_7F4A_7C15);
+        let mut z = self.0;
+        z = (z ^ (z >> 30)).wrapping_mul(0xBF58_476D_1CE4_E5B9);
+        z = (z ^ (z >> 27)).wrapping_mul(0x94D0_49BB_1331_11EB);
+        z ^ (z >> 31)
+    }
+
+    /// Uniform in `[0, 1)`.
+    fn unit(&mut self) -> f64 {
+        (self.next_u64() >> 11) as f64 * (1.0 / (1u64 << 53) as f64)
+    }
+}
+
+/// `k` distinct values of `0..n` in increasing order, by sequential selection
+/// (Vitter's method A): one draw per value, the skip to it found from the odds of
+/// passing over each value in between, and nothing kept but the counters.
+#[derive(Clone)]
+struct Selection {
+    rng: SplitMix64,
+    /// Values still to choose.
+    left: u64,
+    /// Values not yet passed over, starting at `next`.
+    pool: u64,
+    next: u64,
+}
+
+impl Selection {
+    fn new(k: u64, n: u64, rng: SplitMix64) -> Self {
+        Self {
+            rng,
+            left: k.min(n),
+            pool: n,
+            next: 0,
+        }
+    }
+}
+
+impl Iterator for Selection {
+    type Item = u64;
+
+    fn next(&mut self) -> Option<u64> {
+        if self.left == 0 {
+            return None;
+        }
+        let v = self.rng.unit();
+        let mut skip = 0u64;
+        let mut top = (self.pool - self.left) as f64;
+        let mut rest = self.pool as f64;
+        let mut quot = top / rest;
+        while quot > v && skip < self.pool - self.left {
+            skip += 1;
+            top -= 1.0;
+            rest -= 1.0;
+            quot *= top / rest;
+        }
+        let value = self.next + skip;
+        self.next = value + 1;
+        self.pool -= skip + 1;
+        self.left -= 1;
+        Some(value)
+    }
+}
+
+/// `k` distinct values of `0..n` as sorted, non-adjacent runs `(start, len)`.
+/// More than half of `0..n` is drawn as the gaps of a selection of the rest.
+#[derive(Clone)]
+struct UnitRuns {
+    picks: std::iter::Peekable<Selection>,
+    invert: bool,
+    n: u64,
+    /// Inverted: first value not yet covered by a run or a gap.
+    cursor: u64,
+}
+
+impl UnitRuns {
+    fn new(k: u64, n: u64, rng: SplitMix64) -> Self {
+        let k = k.min(n);
+        let invert = k > n / 2;
+        let m = if invert { n - k } else { k };
+        Self {
+            picks: Selection::new(m, n, rng).peekable(),
+            invert,
+            n,
+            cursor: 0,
+        }
+    }
+}
+
+impl Iterator for UnitRuns {
+    type Item = (u64, u64);
+
+    fn next(&mut self) -> Option<(u64, u64)> {
+        if !self.invert {
+            let start = self.picks.next()?;
+            let mut end = start + 1;
+            while self.picks.next_if_eq(&end).is_some() {
+                end += 1;
+            }
+            return Some((start, end - start));
+        }
+        while self.cursor < self.n {
+            let gap = self.picks.next().unwrap_or(self.n);
+            let start = std::mem::replace(&mut self.cursor, gap + 1);
+            if gap > start {
+                return Some((start, gap - start));
+            }
+        }
+        None
+    }
+}
+
+/// The rows to keep, as sorted runs of row numbers: the chosen units scaled to
+/// `block` rows each, clipped to the file and to `left` rows in total.
+#[derive(Clone)]
+struct Runs {
+    units: UnitRuns,
+    block: u64,
+    total: u64,
+    left: u64,
+}
+
+impl Iterator for Runs {
+    type Item = (u64, u64);
+
+    fn next(&mut self) -> Option<(u64, u64)> {
+        let (start, len) = self.units.next()?;
+        let start_row = start * self.block;
+        let len = ((start + len) * self.block).min(self.total) - start_row;
+        let len = len.min(self.left);
+        if len == 0 {
+            return None;
+        }
+        self.left -= len;
+        Some((start_row, len))
+    }
+}
+
+/// The rows to keep, generated lazily in file order.
+fn sample_runs(sample: &SampleOptions, total: u64) -> PolarsResult<Runs> {
+    let block = sample.block_len();
+    let rng = SplitMix64(sample.seed);
+    let (want, units) = match (sample.mode, sample.size) {
+        (_, SampleSize::Fraction(f)) if !(0.0..=1.0).contains(&f) => {
+            polars_bail!(ComputeError: "sample fraction must be between 0 and 1, got {f}")
+        }
+        (SampleMode::Rows, SampleSize::Fraction(f)) => {
+            let n = (f * total as f64).round() as u64;
+            (n, n)
+        }
+        (SampleMode::Rows, SampleSize::Rows(n)) => (n as u64, n as u64),
+        (SampleMode::Blocks, SampleSize::Fraction(f)) => {
+            let blocks = total.div_ceil(block);
+            let k = (f * blocks as f64).round() as u64;
+            (u64::MAX, if f > 0.0 { k.max(1) } else { 0 })
+        }
+        (SampleMode::Blocks, SampleSize::Rows(n)) => (n as u64, (n as u64).div_ceil(block)),
+    };
+    let block = match sample.mode {
+        SampleMode::Rows => 1,
+        SampleMode::Blocks => block,
+    };
+    Ok(Runs {
+        units: UnitRuns::new(units, total.div_ceil(block), rng),
+        block,
+        total,
+        left: want,
+    })
+}
+
+/// The row ranges actually read: neighbouring runs closer than `gap` rows are
+/// read as one range.
+#[derive(Clone)]
+struct Spans<I: Iterator<Item = (u64, u64)>> {
+    runs: std::iter::Peekable<I>,
+    gap: u64,
+}
+
+impl<I: Iterator<Item = (u64, u64)>> Iterator for Spans<I> {
+    type Item = (u64, u64);
+
+    fn next(&mut self) -> Option<(u64, u64)> {
+        let (start, len) = self.runs.next()?;
+        let mut end = start + len;
+        while let Some(&(s, l)) = self.runs.peek() {
+            if s - end >= self.gap {
+                break;
+            }
+            end = s + l;
+            self.runs.next();
+        }
+        Some((start, end - start))
+    }
+}
+
+fn read_spans<I: Iterator<Item = (u64, u64)>>(runs: I, gap: u64) -> Spans<I> {
+    Spans {
+        runs: runs.peekable(),
+        gap,
+    }
+}
+
+fn to_polars(e: impl std::fmt::Display) -> PolarsError {
+    PolarsError::ComputeError(e.to_string().into())
+}
+
+/// Row count from the header and whether rows can be seeked to directly.
+fn row_layout(path: &Path, format: ReadStatFormat) -> PolarsResult<(u64, bool)> {
+    Ok(match format {
+        ReadStatFormat::Sas => {
+            let reader = crate::Sas7bdatReader::open_cached(path).map_err(to_polars)?;
+            (reader.metadata().row_count as u64, true)
+        }
+        ReadStatFormat::SasXpt => (
+            crate::sas::xpt::read_xpt_metadata_cached(path)?.row_count as u64,
+            true,
+        ),
+        ReadStatFormat::Stata => {
+            let reader = crate::StataReader::open_cached(path).map_err(to_polars)?;
+            (reader.metadata().row_count, true)
+        }
+        ReadStatFormat::Spss => {
+            let reader = crate::SpssReader::open_cached(path).map_err(to_polars)?;
+            (reader.metadata().row_count, reader.compression() != 2)
+        }
+        ReadStatFormat::Por => polars_bail!(
+            ComputeError: "sampling needs the row count, which SPSS portable files do not record"
+        ),
+    })
+}
+
+/// Build the index that lets offset reads of `path` start near their first row,
+/// kept with the shared reader so that every range of the sample uses it.
+fn seek_index(path: &Path, format: ReadStatFormat, every: u64) -> PolarsResult<()> {
+    match format {
+        ReadStatFormat::Sas => {
+            let reader = crate::Sas7bdatReader::open_cached(path).map_err(to_polars)?;
+            reader.ensure_page_index().map_err(to_polars)?;
+        }
+        ReadStatFormat::Spss => {
+            let reader = crate::SpssReader::open_cached(path).map_err(to_polars)?;
+            // A checkpoint per block, and no more than one per thousand rows.
+            let every = every.max(1_000) as usize;
+            reader.ensure_sav_index(every).map_err(to_polars)?;
+        }
+        _ => {}
+    }
+    Ok(())
+}
+
+/// Iterator over the sampled rows of a file, in file order.
+struct SampleIter {
+    path: PathBuf,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+    columns: Option<Vec<String>>,
+    batch_size: Option<usize>,
+    runs: std::iter::Peekable<Runs>,
+    spans: Spans<Runs>,
+    /// The span being read and the row number of its next batch.
+    current: Option<(ReadstatBatchIter, u64)>,
+    remaining: Option<usize>,
+}
+
+impl SampleIter {
+    /// Rows of a batch starting at row `first` that lie in a run.
+    fn keep(&mut self, df: DataFrame, first: u64) -> PolarsResult<DataFrame> {
+        let end = first + df.height() as u64;
+        let mut idx: Vec<IdxSize> = Vec::new();
+        while let Some(&(start, len)) = self.runs.peek() {
+            if start >= end {
+                break;
+            }
+            let lo = start.max(first);
+            let hi = (start + len).min(end);
+            idx.extend((lo..hi).map(|r| (r - first) as IdxSize));
+            if start + len > end {
+                break;
+            }
+            self.runs.next();
+        }
+        if idx.len() == df.height() {
+            return Ok(df);
+        }
+        df.take(&IdxCa::from_vec("".into(), idx))
+    }
+}
+
+impl Iterator for SampleIter {
+    type Item = PolarsResult<DataFrame>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        loop {
+            if self.remaining == Some(0) {
+                return None;
+            }
+            if self.current.is_none() {
+                let (start, len) = self.spans.next()?;
+                let iter = readstat_batch_iter_range(
+                    &self.path,
+                    Some(self.opts.clone()),
+                    Some(self.format),
+                    self.columns.clone(),
+                    start as usize,
+                    Some(len as usize),
+                    self.batch_size,
+                );
+                match iter {
+                    Ok(iter) => self.current = Some((iter, start)),
+                    Err(e) => return Some(Err(e)),
+                }
+            }
+            let (iter, first) = self.current.as_mut()?;
+            let first_row = *first;
+            let df = match iter.next() {
+                Some(Ok(df)) => {
+                    *first += df.height() as u64;
+                    df
+                }
+                Some(Err(e)) => return Some(Err(e)),
+                None => {
+                    self.current = None;
+                    continue;
+                }
+            };
+            let mut df = match self.keep(df, first_row) {
+                Ok(df) => df,
+                Err(e) => return Some(Err(e)),
+            };
+            if df.height() == 0 {
+                continue;
+            }
+            if let Some(r) = self.remaining.as_mut() {
+                if df.height() > *r {
+                    df = df.head(Some(*r));
+                }
+                *r -= df.height();
+            }
+            return Some(Ok(df));
+        }
+    }
+}
+
+/// Sampled batches of `path` per `opts.sample`, at most `n_rows` of them in total.
+/// Compression is applied per batch, as in [`crate::readstat_batch_iter`].
+pub(crate) fn sample_batch_iter(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    batch_size: Option<usize>,
+) -> PolarsResult<ReadstatBatchIter> {
+    let (iter, _) = sample_iter(path, opts, format, columns, n_rows, batch_size)?;
+    Ok(iter)
+}
+
+/// The sampled batches and the number of rows they add up to.
+fn sample_iter(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    batch_size: Option<usize>,
+) -> PolarsResult<(ReadstatBatchIter, usize)> {
+    let Some(sample) = opts.sample.clone() else {
+        polars_bail!(ComputeError: "no sample requested");
+    };
+    let profiler = opts.profile.clone();
+    let (total, seekable) = {
+        let _profile = crate::read_profile::enter(profiler.as_ref());
+        row_layout(path, format)?
+    };
+    let runs = sample_runs(&sample, total)?;
+    let gap = if seekable {
+        sample.block_len()
+    } else {
+        u64::MAX
+    };
+    // The plan is replayed from the seed rather than stored: once to count, once
+    // for the ranges to read and once for the rows to keep.
+    let spans = read_spans(runs.clone(), gap);
+    let rows = runs.clone().map(|(_, len)| len as usize).sum::<usize>();
+    let rows = n_rows.map_or(rows, |n| n.min(rows));
+    if spans.clone().any(|(start, _)| start > 0) {
+        let _profile = crate::read_profile::enter(profiler.as_ref());
+        seek_index(path, format, sample.block_len())?;
+    }
+
+    // Positions are matched to rows by order, so spans are read in order and in
+    // full; predicates are applied by the caller to the sample.
+    let read_opts = ScanOptions {
+        preserve_order: Some(true),
+        row_filter: None,
+        sample: None,
+        compress_opts: crate::CompressOptionsLite::default(),
+        ..opts.clone()
+    };
+    let iter = SampleIter {
+        path: path.to_path_buf(),
+        opts: read_opts,
+        format,
+        columns,
+        batch_size,
+        runs: runs.peekable(),
+        spans,
+        current: None,
+        remaining: n_rows,
+    };
+    let iter: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send> =
+        if opts.compress_opts.enabled {
+            let compress_opts = opts.compress_opts.clone();
+            Box::new(iter.map(move |batch| {
+                let df = batch?;
+                crate::compress_df_if_enabled(&df, &compress_opts)
+                    .map_err(|e| PolarsError::ComputeError(e.into()))
+            }))
+        } else {
+            Box::new(iter)
+        };
+    Ok((ReadstatBatchIter::new(iter).with_profiler(profiler), rows))
+}
+
+struct SampleScan {
+    path: PathBuf,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+}
+
+impl AnonymousScan for SampleScan {
+    fn as_any(&self) -> &dyn std::any::Any {
+        self
+    }
+
+    fn scan(&self, args: AnonymousScanArgs) -> PolarsResult<DataFrame> {
+        let cols = args
+            .with_columns
+            .as_ref()
+            .map(|c| c.iter().map(|s| s.to_string()).collect::<Vec<_>>());
+        // Compressed once over the whole sample instead of per batch.
+        let read_opts = ScanOptions {
+            compress_opts: crate::CompressOptionsLite::default(),
+            ..self.opts.clone()
+        };
+        let (iter, rows) = sample_iter(
+            &self.path,
+            read_opts,
+            self.format,
+            cols.clone(),
+            args.n_rows,
+            None,
+        )?;
+        let mut out = crate::frame_assembly::FrameAssembler::new(rows)
+            .with_compression(Some(&self.opts.compress_opts));
+        let mut any = false;
+        for batch in iter {
+            out.push(batch?)?;
+            any = true;
+        }
+        if any {
+            return out.finish();
+        }
+        // Nothing sampled: an empty frame of the projected columns.
+        let schema: Schema = match &cols {
+            Some(cols) => args
+                .schema
+                .iter()
+                .filter(|(name, _)| cols.iter().any(|c| c == name.as_str()))
+                .map(|(name, dtype)| (name.clone(), dtype.clone()))
+                .collect(),
+            None => args.schema.as_ref().clone(),
+        };
+        Ok(DataFrame::empty_with_schema(&schema))
+    }
+
+    fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
+        let opts = ScanOptions {
+            sample: None,
+            ..self.opts.clone()
+        };
+        crate::format_scan(&self.path, opts, self.format)?.collect_schema()
+    }
+}
+
+/// Lazy scan of a sample of `path` per `opts.sample`.
+pub(crate) fn scan_sample(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+) -> PolarsResult<LazyFrame> {
+    let scan = SampleScan {
+        path: path.to_path_buf(),
+        opts,
+        format,
+    };
+    LazyFrame::anonymous_scan(Arc::new(scan), Default::default())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn rows_in(runs: &[(u64, u64)]) -> u64 {
+        runs.iter().map(|&(_, len)| len).sum()
+    }
+
+    fn unit_runs(k: u64, n: u64, seed: u64) -> Vec<(u64, u64)> {
+        UnitRuns::new(k, n, SplitMix64(seed)).collect()
+    }
+
+    #[test]
+    fn test_unit_runs_counts_and_bounds() {
+        for (k, n) in [
+            (0, 10),
+            (3, 10),
+            (7, 10),
+            (10, 10),
+            (25, 10),
+            (500, 100_000),
+            (99_500, 100_000),
+        ] {
+            let runs = unit_runs(k, n, k ^ n);
+            assert_eq!(rows_in(&runs), k.min(n));
+            for pair in runs.windows(2) {
+                // Sorted, disjoint and not adjacent (adjacent runs are joined).
+                assert!(pair[0].0 + pair[0].1 < pair[1].0);
+            }
+            assert!(runs.last().map_or(true, |&(s, l)| s + l <= n));
+        }
+        let a = unit_runs(50, 1000, 7);
+        assert_eq!(a, unit_runs(50, 1000, 7));
+        assert_ne!(a, unit_runs(50, 1000, 8));
+    }
+
+    #[test]
+    fn test_selection_is_uniform() {
+        // Every value of 0..20 is picked about k/n of the time.
+        let mut hits = [0u32; 20];
+        for seed in 0..4000 {
+            for v in Selection::new(5, 20, SplitMix64(seed)) {
+                hits[v as usize] += 1;
+            }
+        }
+        assert!(hits.iter().all(|&h| (850..1150).contains(&h)), "{hits:?}");
+    }
+
+    #[test]
+    fn test_sample_runs_modes() {
+        let rows = SampleOptions::fraction(0.01).with_mode(SampleMode::Rows);
+        let runs: Vec<_> = sample_runs(&rows, 123_456).unwrap().collect();
+        assert_eq!(rows_in(&runs), 1235);
+
+        let blocks = SampleOptions::rows(2500).with_block_rows(1000);
+        let runs: Vec<_> = sample_runs(&blocks, 10_500).unwrap().collect();
+        assert_eq!(rows_in(&runs), 2500);
+        assert!(runs.iter().all(|&(start, _)| start % 1000 == 0));
+
+        let blocks = SampleOptions::fraction(0.5).with_block_rows(100);
+        let runs: Vec<_> = sample_runs(&blocks, 1000).unwrap().collect();
+        assert_eq!(rows_in(&runs), 500);
+
+        assert!(sample_runs(&SampleOptions::fraction(1.5), 10).is_err());
+        assert!(sample_runs(&SampleOptions::fraction(0.0), 10)
+            .unwrap()
+            .next()
+            .is_none());
+    }
+
+    #[test]
+    fn test_read_spans_join_close_runs() {
+        let runs = [(0, 1), (5, 1), (30, 2), (100, 10)];
+        let spans = |gap| read_spans(runs.into_iter(), gap).collect::<Vec<_>>();
+        assert_eq!(spans(10), vec![(0, 6), (30, 2), (100, 10)]);
+        assert_eq!(spans(u64::MAX), vec![(0, 110)]);
+    }
+}
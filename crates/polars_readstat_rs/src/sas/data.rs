@@ -1,6 +1,8 @@
 use crate::decompressor::Decompressor;
 use crate::error::{Error, Result};
 use crate::page::{PageHeader, PageReader, PageSubheader};
+use crate::read_profile::{ProfileStage, Tally};
+use crate::sas::page_index::DataPageKind;
 use crate::types::{Compression, Endian, Format, Metadata, PageType};
 use std::io::{Read, Seek};
 
@@ -16,6 +18,8 @@ pub struct DataReader<R: Read + Seek> {
     page_state: Option<PageState>,
     /// Reusable buffer for decompressed rows (avoids per-row allocation)
     decompress_buf: Vec<u8>,
+    /// Gather buffer for `read_rows_span` when rows aren't contiguous in the page
+    span_buf: Vec<u8>,
     /// When Some(n), stop reading after n more data-bearing pages (page-limited parallel mode).
     /// In this mode the current_row >= metadata.row_count guard is bypassed; the
     /// page budget is the sole stopping condition.
@@ -24,6 +28,10 @@ pub struct DataReader<R: Read + Seek> {
     /// Used for compressed parallel reads where non-data META pages must still count
     /// against the worker's page-range budget to prevent overlap with adjacent workers.
     max_physical_pages: Option<usize>,
+    /// Physical pages read so far (including the current one).
+    pages_read: usize,
+    /// Row decompression time, charged to the profile once per page.
+    tally: Tally,
 }
 
 /// State for tracking position within a page
@@ -87,8 +95,11 @@ impl<R: Read + Seek> DataReader<R> {
             current_row: 0,
             page_state,
             decompress_buf,
+            span_buf: Vec::new(),
             remaining_pages: None,
             max_physical_pages: None,
+            pages_read: 0,
+            tally: Tally::new(),
         };
 
         // Try to read the first page if we don't have initial data subheaders
@@ -119,6 +130,28 @@ impl<R: Read + Seek> DataReader<R> {
         self.current_row = row;
     }
 
+    /// Physical pages read so far, including the current one.
+    pub(crate) fn pages_read(&self) -> usize {
+        self.pages_read
+    }
+
+    /// Kind and number of unread rows of the current data-bearing page, or `None`
+    /// once the source is exhausted.
+    pub(crate) fn current_page_rows(&self) -> Option<(DataPageKind, usize)> {
+        let kind = match self.page_state.as_ref()? {
+            PageState::Meta { .. } => DataPageKind::Meta,
+            PageState::Data { .. } => DataPageKind::Data,
+            PageState::Mix { .. } => DataPageKind::Mix,
+        };
+        Some((kind, self.rows_remaining_in_page()))
+    }
+
+    /// Move to the next data-bearing page without decoding what is left of this one.
+    pub(crate) fn next_page(&mut self) -> Result<()> {
+        self.page_state = None;
+        self.advance_page()
+    }
+
     /// Read the next row (allocating). Used by streaming paths that need owned data.
     pub fn read_row(&mut self) -> Result<Option<RowBytes>> {
         // Check if we've read all rows
@@ -188,8 +221,11 @@ impl<R: Read + Seek> DataReader<R> {
             let raw_bytes = &page_buffer[offset..offset + length];
             if length < row_length {
                 // Truly compressed subheader: decompress into the reusable buffer.
-                self.decompressor
-                    .decompress_into(raw_bytes, &mut self.decompress_buf)?;
+                self.tally.add_bytes_decompressed(row_length);
+                self.tally.time(ProfileStage::Decompress, || {
+                    self.decompressor
+                        .decompress_into(raw_bytes, &mut self.decompress_buf)
+                })?;
             } else {
                 // Uncompressed subheader on a compressed file: copy bytes directly.
                 // (length == row_length; the compression flag on the subheader was 0)
@@ -246,8 +282,11 @@ impl<R: Read + Seek> DataReader<R> {
             if is_compressed {
                 let raw_bytes = &self.page_reader.page_buffer()[offset..offset + length];
                 if length < row_length {
-                    self.decompressor
-                        .decompress_into(raw_bytes, &mut self.decompress_buf)?;
+                    self.tally.add_bytes_decompressed(row_length);
+                    self.tally.time(ProfileStage::Decompress, || {
+                        self.decompressor
+                            .decompress_into(raw_bytes, &mut self.decompress_buf)
+                    })?;
                 } else {
                     self.decompress_buf[..length].copy_from_slice(raw_bytes);
                 }
@@ -262,6 +301,62 @@ impl<R: Read + Seek> DataReader<R> {
         Ok(count)
     }
 
+    /// Like `read_rows_bulk`, but hands back the rows in place when they are
+    /// contiguous in the current page (uncompressed DATA pages), so the caller can
+    /// decode them without a copy; with a mapped file that is a slice of the mapping.
+    /// Other pages are gathered into an internal buffer. Returns the flat row bytes
+    /// and the row count; 0 rows means the reader is exhausted. The slice is valid
+    /// until the next call to any read method.
+    pub fn read_rows_span(&mut self, n: usize) -> Result<(&[u8], usize)> {
+        let row_length = self.metadata.row_length;
+        if row_length == 0 || n == 0 {
+            return Ok((&[], 0));
+        }
+        if self.remaining_pages.is_none() && self.current_row >= self.metadata.row_count {
+            return Ok((&[], 0));
+        }
+        if self.rows_remaining_in_page() == 0 {
+            // Land on the next page so DATA pages can be served in place.
+            if self.ensure_row_ready()?.is_none() {
+                return Ok((&[], 0));
+            }
+        }
+        if let Some((start, rows)) = self.data_page_span(n, row_length) {
+            self.advance_rows(rows);
+            let end = start + rows * row_length;
+            return Ok((&self.page_reader.page_buffer()[start..end], rows));
+        }
+        let mut buf = std::mem::take(&mut self.span_buf);
+        buf.clear();
+        let rows = self.read_rows_bulk(n, &mut buf);
+        self.span_buf = buf;
+        Ok((&self.span_buf, rows?))
+    }
+
+    /// Byte offset and row count of up to `max_rows` contiguous rows left on the
+    /// current uncompressed DATA page, or None if the page isn't one.
+    fn data_page_span(&self, max_rows: usize, row_length: usize) -> Option<(usize, usize)> {
+        if self.metadata.compression != Compression::None {
+            return None;
+        }
+        let Some(PageState::Data {
+            offset,
+            row_length: page_rl,
+            block_count,
+            current_index,
+        }) = &self.page_state
+        else {
+            return None;
+        };
+        if *page_rl != row_length || *current_index >= *block_count {
+            return None;
+        }
+        let start = offset + current_index * row_length;
+        let fits = self.page_reader.page_buffer().len().saturating_sub(start) / row_length;
+        let rows = max_rows.min(block_count - current_index).min(fits);
+        (rows > 0).then_some((start, rows))
+    }
+
     /// Fast-path bulk copy for uncompressed DATA pages.
     ///
     /// All rows on a DATA page are laid out contiguously in the page buffer, so
@@ -482,6 +577,7 @@ impl<R: Read + Seek> DataReader<R> {
 
     /// Advance to next page
     fn advance_page(&mut self) -> Result<()> {
+        self.tally.flush();
         if let Some(0) = self.remaining_pages {
             self.page_state = None;
             return Ok(());
@@ -497,6 +593,7 @@ impl<R: Read + Seek> DataReader<R> {
             if !self.page_reader.read_page()? {
                 return Ok(());
             }
+            self.pages_read += 1;
 
             if let Some(ref mut rem) = self.max_physical_pages {
                 *rem = rem.saturating_sub(1);
@@ -706,8 +803,11 @@ impl<R: Read + Seek> DataReader<R> {
         // regardless of the compression flag. The compression flag on the
         // subheader isn't a reliable indicator; length comparison is.
         if length < self.metadata.row_length {
-            self.decompressor
-                .decompress(raw_bytes, self.metadata.row_length)
+            let row_length = self.metadata.row_length;
+            self.tally.add_bytes_decompressed(row_length);
+            self.tally.time(ProfileStage::Decompress, || {
+                self.decompressor.decompress(raw_bytes, row_length)
+            })
         } else {
             Ok(raw_bytes.to_vec())
         }
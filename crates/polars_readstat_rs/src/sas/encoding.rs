@@ -1,4 +1,5 @@
 use encoding_rs::Encoding;
+use std::borrow::Cow;
 
 /// Map SAS encoding byte to encoding name (matches C++ implementation)
 pub fn get_encoding_name(encoding_byte: u8) -> &'static str {
@@ -152,13 +153,22 @@ pub fn get_encoding(encoding_byte: u8) -> &'static Encoding {
 /// Decode bytes to UTF-8 string using the specified encoding byte.
 /// ISO-8859-1 needs special handling because encoding_rs maps it to Windows-1252.
 pub fn decode_string(bytes: &[u8], encoding_byte: u8, encoding: &'static Encoding) -> String {
+    decode_cow(bytes, encoding_byte, encoding).into_owned()
+}
+
+/// `decode_string` that borrows `bytes` when they are already valid UTF-8.
+pub(crate) fn decode_cow<'a>(
+    bytes: &'a [u8],
+    encoding_byte: u8,
+    encoding: &'static Encoding,
+) -> Cow<'a, str> {
     if encoding_byte == 29 {
         // ISO-8859-1 is a 1:1 mapping of bytes to Unicode code points U+0000..U+00FF.
-        return bytes.iter().map(|&b| b as char).collect();
+        return Cow::Owned(bytes.iter().map(|&b| b as char).collect());
     }
 
     let (decoded, _, _had_errors) = encoding.decode(bytes);
-    decoded.into_owned()
+    decoded
 }
 
 /// Decode bytes into `out` without allocating a String per call.
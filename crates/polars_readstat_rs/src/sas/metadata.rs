@@ -911,7 +911,6 @@ impl MetadataBuilder {
             creator: self.creator,
             creator_proc: self.creator_proc,
             encoding_byte: self.encoding_byte,
-            page_index: Vec::new(),
         })
     }
 }
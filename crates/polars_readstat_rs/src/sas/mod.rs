@@ -6,6 +6,7 @@ pub(crate) mod decompressor;
 pub(crate) mod encoding;
 pub(crate) mod error;
 pub(crate) mod page;
+pub mod page_index;
 pub mod polars_output;
 #[cfg(feature = "row_reader")]
 pub mod row_reader;
@@ -21,9 +22,10 @@ pub mod xpt;
 pub mod xpt_writer;
 
 pub use error::{Error, Result};
+pub use page_index::{DataPageKind, PageIndexEntry, SasPageIndex};
 pub use polars_output::scan_sas7bdat;
 pub use reader::Sas7bdatReader;
-pub use xpt::{read_xpt_metadata, scan_xpt, xpt_batch_iter, xpt_metadata_json, XptColumn, XptMetadata};
+pub use xpt::{read_xpt_metadata, read_xpt_metadata_cached, scan_xpt, xpt_batch_iter, xpt_metadata_json, XptColumn, XptMetadata};
 pub use xpt_writer::{XptVariableFormats, XptVariableLabels, XptStorageWidths, XptWriter};
 use std::fs::File;
 use std::io::{BufReader, Seek, SeekFrom};
@@ -89,7 +91,7 @@ pub fn metadata_json_from_meta(meta: &Metadata, hdr: &Header) -> Result<String>
 
 /// Export SAS metadata as a JSON string.
 pub fn metadata_json(path: impl AsRef<Path>) -> Result<String> {
-    let reader = Sas7bdatReader::open(path)?;
+    let reader = Sas7bdatReader::open_cached(path)?;
     metadata_json_from_meta(reader.metadata(), reader.header())
 }
 
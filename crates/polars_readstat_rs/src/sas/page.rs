@@ -1,4 +1,5 @@
 use crate::error::Result;
+use crate::mmap_source::SharedMap;
 use crate::types::{Endian, Format, Header, PageType};
 use std::io::{Read, Seek};
 
@@ -26,6 +27,11 @@ pub struct PageReader<R: Read + Seek> {
     endian: Endian,
     format: Format,
     page_buffer: Vec<u8>,
+    /// When set, pages are borrowed from the mapping instead of read into
+    /// `page_buffer`; `mapped_next` is the file offset of the next page.
+    mapped: Option<SharedMap>,
+    mapped_next: usize,
+    mapped_page: usize,
     page_bit_offset: usize,
     integer_size: usize,
     subheader_size: usize,
@@ -49,14 +55,38 @@ impl<R: Read + Seek> PageReader<R> {
             endian,
             format,
             page_buffer,
+            mapped: None,
+            mapped_next: 0,
+            mapped_page: 0,
             page_bit_offset,
             integer_size,
             subheader_size,
         }
     }
 
+    /// Serve pages straight out of `map`, starting at byte `offset` (where the
+    /// underlying reader would otherwise be positioned). The reader itself is not
+    /// touched again.
+    pub(crate) fn with_mapping(mut self, map: Option<SharedMap>, offset: u64) -> Self {
+        if map.is_some() {
+            self.page_buffer = Vec::new();
+            self.mapped_next = offset as usize;
+            self.mapped = map;
+        }
+        self
+    }
+
     /// Read next page into buffer
     pub fn read_page(&mut self) -> Result<bool> {
+        if let Some(map) = &self.mapped {
+            let len = self.header.page_length;
+            if self.mapped_next + len > map.len() {
+                return Ok(false);
+            }
+            self.mapped_page = self.mapped_next;
+            self.mapped_next += len;
+            return Ok(true);
+        }
         match self.reader.read_exact(&mut self.page_buffer) {
             Ok(_) => Ok(true),
             Err(e) if e.kind() == std::io::ErrorKind::UnexpectedEof => Ok(false),
@@ -109,7 +139,10 @@ impl<R: Read + Seek> PageReader<R> {
 
     /// Get reference to page buffer
     pub fn page_buffer(&self) -> &[u8] {
-        &self.page_buffer
+        match &self.mapped {
+            Some(map) => &map[self.mapped_page..self.mapped_page + self.header.page_length],
+            None => &self.page_buffer,
+        }
     }
 
     /// Get header reference
@@ -119,7 +152,7 @@ impl<R: Read + Seek> PageReader<R> {
 
     #[inline(always)]
     fn read_u8(&self, offset: usize) -> Result<u8> {
-        self.page_buffer
+        self.page_buffer()
             .get(offset)
             .copied()
             .ok_or(crate::error::Error::BufferOutOfBounds { offset, length: 1 })
@@ -128,7 +161,7 @@ impl<R: Read + Seek> PageReader<R> {
     #[inline(always)]
     fn read_u16(&self, offset: usize) -> Result<u16> {
         let bytes: [u8; 2] = self
-            .page_buffer
+            .page_buffer()
             .get(offset..offset + 2)
             .and_then(|s| s.try_into().ok())
             .ok_or(crate::error::Error::BufferOutOfBounds { offset, length: 2 })?;
@@ -141,7 +174,7 @@ impl<R: Read + Seek> PageReader<R> {
     #[inline(always)]
     fn read_u32(&self, offset: usize) -> Result<u32> {
         let bytes: [u8; 4] = self
-            .page_buffer
+            .page_buffer()
             .get(offset..offset + 4)
             .and_then(|s| s.try_into().ok())
             .ok_or(crate::error::Error::BufferOutOfBounds { offset, length: 4 })?;
@@ -154,7 +187,7 @@ impl<R: Read + Seek> PageReader<R> {
     #[inline(always)]
     fn read_u64(&self, offset: usize) -> Result<u64> {
         let bytes: [u8; 8] = self
-            .page_buffer
+            .page_buffer()
             .get(offset..offset + 8)
             .and_then(|s| s.try_into().ok())
             .ok_or(crate::error::Error::BufferOutOfBounds { offset, length: 8 })?;
@@ -0,0 +1,314 @@
+//! Page/row index for sas7bdat files.
+//!
+//! Rows per page are irregular (MIX pages, compressed META pages, short trailing
+//! pages), so finding row N normally means walking every page before it. The index
+//! records, for each data-bearing page, its physical page number, the first row it
+//! holds and its row count. Reads at an offset can then seek straight to the right
+//! page. It is built with one pass over the pages (no values are decoded) and can
+//! be saved as a small sidecar file so that later opens skip the pass. In
+//! uncompressed files the pass stops at the first DATA page when the page count
+//! shows that every DATA page but the last is full.
+
+use crate::data::DataReader;
+use crate::error::{Error, Result};
+use crate::page::PageReader;
+use crate::types::{Compression, Endian, Format, Header, Metadata, PageType};
+use std::fs::File;
+use std::io::{BufReader, BufWriter, Read, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+
+const MAGIC: &[u8; 8] = b"PRSPIDX1";
+
+/// Layout of a data-bearing page.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DataPageKind {
+    /// META page whose rows are stored as (usually compressed) data subheaders
+    Meta,
+    /// DATA page with packed rows
+    Data,
+    /// MIX page with packed rows after the subheader table
+    Mix,
+}
+
+/// One data-bearing page.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct PageIndexEntry {
+    /// 0-based physical page number (byte offset = header_length + page * page_length).
+    pub page: u64,
+    /// Row number of the first row on this page.
+    pub first_row: u64,
+    pub row_count: u32,
+    pub kind: DataPageKind,
+    /// Rows on this page are stored compressed.
+    pub compressed: bool,
+}
+
+/// Page-to-row map for one sas7bdat file.
+#[derive(Debug, Clone)]
+pub struct SasPageIndex {
+    file_len: u64,
+    modified_ns: u64,
+    page_length: u64,
+    row_count: u64,
+    entries: Vec<PageIndexEntry>,
+}
+
+impl SasPageIndex {
+    /// Walk the data pages of `path` and record where every row lives.
+    pub fn build(
+        path: &Path,
+        header: &Header,
+        metadata: &Metadata,
+        endian: Endian,
+        format: Format,
+    ) -> Result<Self> {
+        let (file_len, modified_ns) = file_stamp(path)?;
+        let mut file = BufReader::with_capacity(256 * 1024, File::open(path)?);
+        file.seek(SeekFrom::Start(header.header_length as u64))?;
+        let page_reader = PageReader::new(file, header.clone(), endian, format);
+        let mut data_reader =
+            DataReader::new(page_reader, metadata.clone(), endian, format, Vec::new())?;
+
+        let row_count = metadata.row_count as u64;
+        let compressed_file = metadata.compression != Compression::None;
+        let mut entries = Vec::new();
+        let mut next_row = 0u64;
+        while next_row < row_count {
+            let Some((kind, rows)) = data_reader.current_page_rows() else {
+                break;
+            };
+            let rows = (rows as u64).min(row_count - next_row);
+            if rows > 0 {
+                let page = data_reader.pages_read().saturating_sub(1) as u64;
+                entries.push(PageIndexEntry {
+                    page,
+                    first_row: next_row,
+                    row_count: rows as u32,
+                    kind,
+                    compressed: compressed_file && kind == DataPageKind::Meta,
+                });
+                next_row += rows;
+                if kind == DataPageKind::Data && !compressed_file {
+                    let rest = full_data_pages(
+                        path, header, metadata, endian, format, page, rows, next_row, row_count,
+                    )?;
+                    if let Some(rest) = rest {
+                        entries.extend(rest);
+                        break;
+                    }
+                }
+            }
+            data_reader.next_page()?;
+        }
+
+        Ok(Self {
+            file_len,
+            modified_ns,
+            page_length: header.page_length as u64,
+            row_count,
+            entries,
+        })
+    }
+
+    /// Default sidecar location: `<file>.pidx` next to the data file.
+    pub fn sidecar_path(path: &Path) -> PathBuf {
+        let mut name = path.as_os_str().to_os_string();
+        name.push(".pidx");
+        PathBuf::from(name)
+    }
+
+    pub fn entries(&self) -> &[PageIndexEntry] {
+        &self.entries
+    }
+
+    /// Total rows covered by the index.
+    pub fn row_count(&self) -> u64 {
+        self.row_count
+    }
+
+    /// The page holding `row`, or `None` if `row` is past the end.
+    pub fn locate(&self, row: usize) -> Option<&PageIndexEntry> {
+        let row = row as u64;
+        let idx = self.entries.partition_point(|e| e.first_row <= row);
+        let entry = self.entries.get(idx.checked_sub(1)?)?;
+        (row < entry.first_row + entry.row_count as u64).then_some(entry)
+    }
+
+    /// True if this index was built from the file at `path` as it is now.
+    pub fn matches(&self, path: &Path, header: &Header, metadata: &Metadata) -> bool {
+        match file_stamp(path) {
+            Ok((file_len, modified_ns)) => {
+                file_len == self.file_len
+                    && modified_ns == self.modified_ns
+                    && header.page_length as u64 == self.page_length
+                    && metadata.row_count as u64 == self.row_count
+            }
+            Err(_) => false,
+        }
+    }
+
+    /// Write the index to `path`.
+    pub fn save(&self, path: &Path) -> Result<()> {
+        let mut out = BufWriter::new(File::create(path)?);
+        out.write_all(MAGIC)?;
+        for v in [
+            self.file_len,
+            self.modified_ns,
+            self.page_length,
+            self.row_count,
+            self.entries.len() as u64,
+        ] {
+            out.write_all(&v.to_le_bytes())?;
+        }
+        for e in &self.entries {
+            out.write_all(&e.page.to_le_bytes())?;
+            out.write_all(&e.first_row.to_le_bytes())?;
+            out.write_all(&e.row_count.to_le_bytes())?;
+            let kind = match e.kind {
+                DataPageKind::Meta => 0u8,
+                DataPageKind::Data => 1,
+                DataPageKind::Mix => 2,
+            };
+            out.write_all(&[kind, e.compressed as u8, 0, 0])?;
+        }
+        out.flush()?;
+        Ok(())
+    }
+
+    /// Read an index previously written by `save`.
+    pub fn load(path: &Path) -> Result<Self> {
+        let mut input = BufReader::new(File::open(path)?);
+        let mut magic = [0u8; 8];
+        input.read_exact(&mut magic)?;
+        if &magic != MAGIC {
+            return Err(Error::ParseError(format!(
+                "{} is not a sas7bdat page index",
+                path.display()
+            )));
+        }
+        let file_len = read_u64(&mut input)?;
+        let modified_ns = read_u64(&mut input)?;
+        let page_length = read_u64(&mut input)?;
+        let row_count = read_u64(&mut input)?;
+        let n_entries = read_u64(&mut input)? as usize;
+
+        let mut entries = Vec::with_capacity(n_entries.min(1 << 24));
+        let mut buf = [0u8; 24];
+        for _ in 0..n_entries {
+            input.read_exact(&mut buf)?;
+            let kind = match buf[20] {
+                0 => DataPageKind::Meta,
+                1 => DataPageKind::Data,
+                2 => DataPageKind::Mix,
+                other => {
+                    return Err(Error::ParseError(format!(
+                        "invalid page kind {other} in page index"
+                    )))
+                }
+            };
+            entries.push(PageIndexEntry {
+                page: u64::from_le_bytes(buf[0..8].try_into().unwrap()),
+                first_row: u64::from_le_bytes(buf[8..16].try_into().unwrap()),
+                row_count: u32::from_le_bytes(buf[16..20].try_into().unwrap()),
+                kind,
+                compressed: buf[21] != 0,
+            });
+        }
+        Ok(Self {
+            file_len,
+            modified_ns,
+            page_length,
+            row_count,
+            entries,
+        })
+    }
+}
+
+/// Entries for the DATA pages after `first_page` (which holds `per_page` rows and
+/// ends before row `next_row`), when they can be derived without reading them:
+/// `first_page` is full, the row count leaves exactly the file's last page short,
+/// and that page is a DATA page holding exactly the rows left over. Rows on a page
+/// never exceed what fits, so the pages in between must then all be full.
+#[allow(clippy::too_many_arguments)]
+fn full_data_pages(
+    path: &Path,
+    header: &Header,
+    metadata: &Metadata,
+    endian: Endian,
+    format: Format,
+    first_page: u64,
+    per_page: u64,
+    next_row: u64,
+    row_count: u64,
+) -> Result<Option<Vec<PageIndexEntry>>> {
+    let page_bit_offset = match format {
+        Format::Bit64 => 32u64,
+        Format::Bit32 => 16u64,
+    };
+    let page_length = header.page_length as u64;
+    if metadata.row_length == 0 || page_length <= page_bit_offset + 8 {
+        return Ok(None);
+    }
+    let fits = (page_length - page_bit_offset - 8) / metadata.row_length as u64;
+    let last_page = (header.page_count as u64).saturating_sub(1);
+    if per_page != fits || next_row >= row_count || last_page <= first_page {
+        return Ok(None);
+    }
+    let pages = last_page - first_page;
+    let remaining = row_count - next_row;
+    if remaining <= (pages - 1) * per_page || remaining > pages * per_page {
+        return Ok(None);
+    }
+    let last_rows = remaining - (pages - 1) * per_page;
+
+    let mut file = File::open(path)?;
+    file.seek(SeekFrom::Start(
+        header.header_length as u64 + last_page * page_length + page_bit_offset,
+    ))?;
+    let mut buf = [0u8; 4];
+    file.read_exact(&mut buf)?;
+    let (page_type, block_count) = match endian {
+        Endian::Little => (
+            u16::from_le_bytes([buf[0], buf[1]]),
+            u16::from_le_bytes([buf[2], buf[3]]),
+        ),
+        Endian::Big => (
+            u16::from_be_bytes([buf[0], buf[1]]),
+            u16::from_be_bytes([buf[2], buf[3]]),
+        ),
+    };
+    if PageType::from_u16(page_type) != PageType::Data
+        || (block_count as u64).min(fits) != last_rows
+    {
+        return Ok(None);
+    }
+
+    Ok(Some(
+        (1..=pages)
+            .map(|i| PageIndexEntry {
+                page: first_page + i,
+                first_row: next_row + (i - 1) * per_page,
+                row_count: if i == pages { last_rows } else { per_page } as u32,
+                kind: DataPageKind::Data,
+                compressed: false,
+            })
+            .collect(),
+    ))
+}
+
+fn file_stamp(path: &Path) -> Result<(u64, u64)> {
+    let meta = std::fs::metadata(path)?;
+    let modified_ns = meta
+        .modified()
+        .ok()
+        .and_then(|t| t.duration_since(std::time::UNIX_EPOCH).ok())
+        .map(|d| d.as_nanos() as u64)
+        .unwrap_or(0);
+    Ok((meta.len(), modified_ns))
+}
+
+fn read_u64<R: Read>(reader: &mut R) -> Result<u64> {
+    let mut buf = [0u8; 8];
+    reader.read_exact(&mut buf)?;
+    Ok(u64::from_le_bytes(buf))
+}
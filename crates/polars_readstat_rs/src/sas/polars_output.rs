@@ -3,24 +3,30 @@ use crate::constants::{
 };
 use crate::data::DataReader;
 use crate::error::{Error, Result};
+use crate::mmap_source::{FileSource, SharedInput, SharedMap};
+use crate::numeric_column::NumericColumnBuilder;
 use crate::page::PageReader;
 use crate::reader::{data_reader_at_page_range, Sas7bdatReader};
+use crate::sas::page_index::SasPageIndex;
+use crate::string_intern::StringInterner;
+use crate::transpose::{ColumnStrips, FieldSpan};
 use crate::types::{Column as SasColumn, ColumnType, Endian, Format, Header, Metadata};
 use crate::value::Value;
 use polars::prelude::*;
 use std::cmp::min;
 use std::fs::File;
-use std::io::{BufReader, Seek, SeekFrom};
+use std::io::{Seek, SeekFrom};
 use std::path::PathBuf;
 use std::sync::mpsc;
 use std::sync::Arc;
-use std::thread::JoinHandle;
 
 
 /// Build a Polars DataFrame from rows of parsed values
 pub struct DataFrameBuilder {
     columns_meta: Vec<SasColumn>,
     buffers: Vec<ColumnBuffer>,
+    /// Scratch for `add_rows_raw`.
+    strips: ColumnStrips,
 }
 
 #[derive(Clone, Copy, Debug)]
@@ -78,12 +84,110 @@ impl ColumnPlan {
     }
 }
 
+/// A [`RowFilter`](crate::RowFilter) compiled against the SAS row layout.
+///
+/// Only plain numeric and character columns take part; terms on temporal or
+/// unknown columns are dropped (the caller re-applies the full predicate).
+#[derive(Clone)]
+pub(crate) struct SasRowFilter {
+    terms: Vec<SasFilterTerm>,
+}
+
+#[derive(Clone)]
+struct SasFilterTerm {
+    start: usize,
+    end: usize,
+    character: bool,
+    endian: Endian,
+    encoding_byte: u8,
+    encoding: &'static encoding_rs::Encoding,
+    missing_string_as_null: bool,
+    test: crate::row_filter::FilterTest,
+}
+
+impl SasRowFilter {
+    pub(crate) fn compile(
+        filter: &crate::RowFilter,
+        metadata: &Metadata,
+        endian: Endian,
+        missing_string_as_null: bool,
+    ) -> Option<Self> {
+        let encoding = crate::encoding::get_encoding(metadata.encoding_byte);
+        let terms: Vec<SasFilterTerm> = filter
+            .terms()
+            .into_iter()
+            .filter_map(|(name, test)| {
+                let col = metadata.columns.iter().find(|c| c.name == name)?;
+                let character = match kind_for_column(col) {
+                    ColumnKind::Numeric => false,
+                    ColumnKind::Character => true,
+                    _ => return None,
+                };
+                if character == test.is_numeric() {
+                    return None;
+                }
+                Some(SasFilterTerm {
+                    start: col.offset,
+                    end: col.offset + col.length,
+                    character,
+                    endian,
+                    encoding_byte: metadata.encoding_byte,
+                    encoding,
+                    missing_string_as_null,
+                    test,
+                })
+            })
+            .collect();
+        if terms.is_empty() {
+            None
+        } else {
+            Some(Self { terms })
+        }
+    }
+
+    /// Whether the raw row can satisfy the filter.
+    pub(crate) fn matches(&self, row_bytes: &[u8]) -> bool {
+        self.terms.iter().all(|term| {
+            if term.end > row_bytes.len() {
+                return false;
+            }
+            let bytes = &row_bytes[term.start..term.end];
+            if !term.character {
+                let (value, is_missing) = crate::value::decode_numeric_bytes_mask(term.endian, bytes);
+                return term.test.eval_num((!is_missing).then_some(value));
+            }
+            // Same trimming as add_row_raw.
+            let mut trimmed_end = bytes.len();
+            while trimmed_end > 0 && (bytes[trimmed_end - 1] == b' ' || bytes[trimmed_end - 1] == 0)
+            {
+                trimmed_end -= 1;
+            }
+            if let Some(pos) = bytes[..trimmed_end].iter().position(|&b| b == 0) {
+                trimmed_end = pos;
+            }
+            let bytes = &bytes[..trimmed_end];
+            if bytes.is_empty() {
+                return term
+                    .test
+                    .eval_str((!term.missing_string_as_null).then_some(""));
+            }
+            if bytes.is_ascii() {
+                // ASCII decodes to itself under every supported encoding.
+                return term.test.eval_str(std::str::from_utf8(bytes).ok());
+            }
+            let s = crate::encoding::decode_string(bytes, term.encoding_byte, term.encoding);
+            term.test.eval_str(Some(&s))
+        })
+    }
+}
+
 enum ColumnBuffer {
-    Numeric(PrimitiveChunkedBuilder<Float64Type>),
-    Date(PrimitiveChunkedBuilder<Int32Type>),
-    DateTime(PrimitiveChunkedBuilder<Int64Type>),
-    Time(PrimitiveChunkedBuilder<Int64Type>),
-    Character(StringChunkedBuilder),
+    Numeric(NumericColumnBuilder<Float64Type>),
+    Date(NumericColumnBuilder<Int32Type>),
+    DateTime(NumericColumnBuilder<Int64Type>),
+    Time(NumericColumnBuilder<Int64Type>),
+    /// Decoded values of repeating raw cells come from the interner.
+    Character(StringChunkedBuilder, StringInterner),
 }
 
 impl DataFrameBuilder {
@@ -96,6 +200,7 @@ impl DataFrameBuilder {
         Self {
             columns_meta,
             buffers,
+            strips: ColumnStrips::default(),
         }
     }
 
@@ -115,6 +220,7 @@ impl DataFrameBuilder {
         Self {
             columns_meta,
             buffers,
+            strips: ColumnStrips::default(),
         }
     }
 
@@ -147,7 +253,7 @@ impl DataFrameBuilder {
                     ColumnBuffer::Date(b) => b.append_null(),
                     ColumnBuffer::DateTime(b) => b.append_null(),
                     ColumnBuffer::Time(b) => b.append_null(),
-                    ColumnBuffer::Character(b) => b.append_null(),
+                    ColumnBuffer::Character(b, _) => b.append_null(),
                 }
                 continue;
             }
@@ -201,34 +307,63 @@ impl DataFrameBuilder {
                     }
                 }
                 ColumnKind::Character => {
-                    if let ColumnBuffer::Character(b) = &mut self.buffers[pos] {
-                        let bytes = &row_bytes[start..end];
-                        // Trim trailing spaces and nulls
-                        let mut trimmed_end = bytes.len();
-                        while trimmed_end > 0
-                            && (bytes[trimmed_end - 1] == b' ' || bytes[trimmed_end - 1] == 0)
-                        {
-                            trimmed_end -= 1;
-                        }
-                        // Stop at the first NUL to match ReadStat's C-string behavior
-                        if let Some(pos) = bytes[..trimmed_end].iter().position(|&b| b == 0) {
-                            trimmed_end = pos;
-                        }
-                        if trimmed_end == 0 {
-                            if plan.missing_string_as_null {
-                                b.append_null();
-                            } else {
-                                b.append_value("");
-                            }
-                        } else {
-                            let s = crate::encoding::decode_string(
-                                &bytes[..trimmed_end],
-                                plan.encoding_byte,
-                                plan.encoding,
-                            );
-                            b.append_value(&s);
+                    if let ColumnBuffer::Character(b, interner) = &mut self.buffers[pos] {
+                        append_character_raw(b, interner, &row_bytes[start..end], plan);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Column-at-a-time variant of `add_row_raw` for a contiguous run of
+    /// `row_length`-byte rows. Rows are transposed a cache-sized tile at a time into
+    /// per-column strips, and each column is then converted from its strip in one
+    /// tight loop.
+    pub(crate) fn add_rows_raw(&mut self, rows: &[u8], row_length: usize, plans: &[ColumnPlan]) {
+        if row_length == 0 {
+            return;
+        }
+        let fields: Vec<FieldSpan> = plans
+            .iter()
+            .map(|plan| FieldSpan {
+                start: plan.start,
+                width: plan.end.saturating_sub(plan.start),
+            })
+            .collect();
+        let tile_len = crate::transpose::tile_rows(row_length) * row_length;
+        for tile in rows.chunks(tile_len) {
+            self.strips.fill(tile, row_length, &fields);
+            for (i, plan) in plans.iter().enumerate() {
+                let width = fields[i].width;
+                if plan.end > row_length || width == 0 {
+                    // Out of bounds or empty: rare, keep the per-cell semantics.
+                    for row in tile.chunks_exact(row_length) {
+                        self.add_row_raw(row, std::slice::from_ref(plan));
+                    }
+                    continue;
+                }
+                let strip = self.strips.strip(i);
+                let endian = plan.endian;
+                use crate::value::decode_numeric_column as decode;
+                match (&mut self.buffers[plan.output_index], plan.kind) {
+                    (ColumnBuffer::Numeric(b), ColumnKind::Numeric) => {
+                        decode(endian, strip, width, b, |v| v)
+                    }
+                    (ColumnBuffer::Date(b), ColumnKind::Date) => {
+                        decode(endian, strip, width, b, to_date_value)
+                    }
+                    (ColumnBuffer::DateTime(b), ColumnKind::DateTime) => {
+                        decode(endian, strip, width, b, to_datetime_value)
+                    }
+                    (ColumnBuffer::Time(b), ColumnKind::Time) => {
+                        decode(endian, strip, width, b, |v| (v * 1_000_000_000.0) as i64)
+                    }
+                    (ColumnBuffer::Character(b, interner), ColumnKind::Character) => {
+                        for cell in strip.chunks_exact(width) {
+                            append_character_raw(b, interner, cell, plan);
                         }
                     }
+                    _ => {}
                 }
             }
         }
@@ -249,7 +384,7 @@ impl DataFrameBuilder {
                 ColumnBuffer::Time(builder) => {
                     builder.finish().into_series().cast(&DataType::Time)?
                 }
-                ColumnBuffer::Character(builder) => builder.finish().into_series(),
+                ColumnBuffer::Character(builder, _) => builder.finish().into_series(),
             };
             columns.push(series.into());
         }
@@ -260,23 +395,22 @@ impl DataFrameBuilder {
 impl ColumnBuffer {
     fn with_capacity(kind: ColumnKind, name: &str, capacity: usize) -> Self {
         match kind {
-            ColumnKind::Numeric => ColumnBuffer::Numeric(
-                PrimitiveChunkedBuilder::<Float64Type>::new(name.into(), capacity),
-            ),
-            ColumnKind::Date => ColumnBuffer::Date(PrimitiveChunkedBuilder::<Int32Type>::new(
-                name.into(),
-                capacity,
-            )),
-            ColumnKind::DateTime => ColumnBuffer::DateTime(
-                PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), capacity),
-            ),
-            ColumnKind::Time => ColumnBuffer::Time(PrimitiveChunkedBuilder::<Int64Type>::new(
-                name.into(),
-                capacity,
-            )),
-            ColumnKind::Character => {
-                ColumnBuffer::Character(StringChunkedBuilder::new(name.into(), capacity))
+            ColumnKind::Numeric => {
+                ColumnBuffer::Numeric(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            ColumnKind::Date => {
+                ColumnBuffer::Date(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            ColumnKind::DateTime => {
+                ColumnBuffer::DateTime(NumericColumnBuilder::new(name.into(), capacity))
             }
+            ColumnKind::Time => {
+                ColumnBuffer::Time(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            ColumnKind::Character => ColumnBuffer::Character(
+                StringChunkedBuilder::new(name.into(), capacity),
+                StringInterner::new(),
+            ),
         }
     }
 }
@@ -313,7 +447,7 @@ fn push_value_ref(buffer: &mut ColumnBuffer, column: &SasColumn, value: &Value)
         (ColumnBuffer::Time(builder), Value::Numeric(v), ColumnType::Numeric) => {
             builder.append_option(to_time(*v))
         }
-        (ColumnBuffer::Character(builder), Value::Character(v), ColumnType::Character) => {
+        (ColumnBuffer::Character(builder, _), Value::Character(v), ColumnType::Character) => {
             if let Some(s) = v {
                 builder.append_value(s);
             } else {
@@ -324,7 +458,7 @@ fn push_value_ref(buffer: &mut ColumnBuffer, column: &SasColumn, value: &Value)
         (ColumnBuffer::Date(builder), _, _) => builder.append_null(),
         (ColumnBuffer::DateTime(builder), _, _) => builder.append_null(),
         (ColumnBuffer::Time(builder), _, _) => builder.append_null(),
-        (ColumnBuffer::Character(builder), _, _) => builder.append_null(),
+        (ColumnBuffer::Character(builder, _), _, _) => builder.append_null(),
     }
 }
 
@@ -339,6 +473,35 @@ fn to_date(value: Option<f64>) -> Option<i32> {
     })
 }
 
+fn append_character_raw(
+    b: &mut StringChunkedBuilder,
+    interner: &mut StringInterner,
+    bytes: &[u8],
+    plan: &ColumnPlan,
+) {
+    // Trim trailing spaces and nulls
+    let mut trimmed_end = bytes.len();
+    while trimmed_end > 0 && (bytes[trimmed_end - 1] == b' ' || bytes[trimmed_end - 1] == 0) {
+        trimmed_end -= 1;
+    }
+    // Stop at the first NUL to match ReadStat's C-string behavior
+    if let Some(pos) = bytes[..trimmed_end].iter().position(|&b| b == 0) {
+        trimmed_end = pos;
+    }
+    if trimmed_end == 0 {
+        if plan.missing_string_as_null {
+            b.append_null();
+        } else {
+            b.append_value("");
+        }
+    } else {
+        let s = interner.decode(&bytes[..trimmed_end], |raw| {
+            crate::encoding::decode_cow(raw, plan.encoding_byte, plan.encoding)
+        });
+        b.append_value(&s);
+    }
+}
+
 pub(crate) fn to_date_value(sas_value: f64) -> i32 {
     let days_since_1970 = (sas_value as i32) - SAS_EPOCH_OFFSET_DAYS;
     if days_since_1970 >= -135080 && days_since_1970 <= 156935 {
@@ -408,6 +571,9 @@ pub struct SasScan {
     row_index_name: Option<String>,
     compress_opts: crate::CompressOptionsLite,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
+    profiler: Option<crate::ReadProfiler>,
 }
 
 impl SasScan {
@@ -430,8 +596,50 @@ impl SasScan {
             row_index_name,
             compress_opts,
             informative_nulls,
+            use_mmap: false,
+            read_ahead: None,
+            profiler: None,
         }
     }
+
+    /// The scan `opts` describe, as [`scan_sas7bdat`] builds it.
+    pub(crate) fn from_options(path: PathBuf, opts: crate::ScanOptions) -> Self {
+        let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
+        let use_mmap = opts.use_mmap.unwrap_or(false);
+        SasScan::new(
+            path,
+            opts.threads,
+            missing_string_as_null,
+            opts.chunk_size,
+            opts.preserve_order.unwrap_or(false),
+            opts.row_index_name,
+            opts.compress_opts,
+            opts.informative_nulls,
+        )
+        .with_mmap(use_mmap)
+        .with_read_ahead(opts.read_ahead)
+        .with_profiler(opts.profile.clone())
+    }
+
+    /// Read through a memory map of the file instead of buffered reads.
+    pub fn with_mmap(mut self, use_mmap: bool) -> Self {
+        self.use_mmap = use_mmap;
+        self
+    }
+
+    /// Read through positioned range reads that keep about `window` bytes in
+    /// flight ahead of decoding, for high-latency storage. `with_mmap` wins when
+    /// both are set.
+    pub fn with_read_ahead(mut self, window: Option<usize>) -> Self {
+        self.read_ahead = window;
+        self
+    }
+
+    /// Collect this scan's profile into `profiler` (see [`crate::ReadProfiler`]).
+    pub fn with_profiler(mut self, profiler: Option<crate::ReadProfiler>) -> Self {
+        self.profiler = profiler;
+        self
+    }
 }
 
 pub(crate) type SasBatchIter = Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>;
@@ -577,7 +785,11 @@ struct AdaptivePageIter {
     next_page: usize,
     remaining_pages: usize,
     pages_per_chunk: usize,
+    /// Pages per read task: about one batch, so that what the tasks in flight
+    /// hold stays bounded by the scan's task limit rather than the chunk size.
+    pages_per_task: usize,
     n_workers: usize,
+    map: Option<SharedInput>,
     current: Option<SasBatchIter>,
 }
 
@@ -610,7 +822,9 @@ impl Iterator for AdaptivePageIter {
                 self.batch_size,
                 self.next_page,
                 page_count,
+                self.pages_per_task,
                 self.n_workers,
+                self.map.clone(),
             ));
             self.next_page += page_count;
             self.remaining_pages -= page_count;
@@ -618,84 +832,6 @@ impl Iterator for AdaptivePageIter {
     }
 }
 
-// Unordered: all workers share one channel; batches arrive in completion order.
-struct UnorderedParallelIter {
-    rx: Option<mpsc::Receiver<PolarsResult<DataFrame>>>,
-    handles: Vec<JoinHandle<()>>,
-    row_index_name: Option<String>,
-    row_cursor: usize,
-}
-
-impl Iterator for UnorderedParallelIter {
-    type Item = PolarsResult<DataFrame>;
-    fn next(&mut self) -> Option<Self::Item> {
-        let df = self.rx.as_ref()?.recv().ok()?;
-        Some(df.and_then(|df| {
-            if let Some(ref name) = self.row_index_name {
-                let n = df.height();
-                let result = crate::append_row_index(df, name.as_str(), self.row_cursor);
-                self.row_cursor += n;
-                result
-            } else {
-                Ok(df)
-            }
-        }))
-    }
-}
-
-impl Drop for UnorderedParallelIter {
-    fn drop(&mut self) {
-        self.rx.take();
-        for h in self.handles.drain(..) {
-            let _ = h.join();
-        }
-    }
-}
-
-// Ordered: each worker has its own channel; consumer drains worker 0, then 1, etc.
-struct OrderedParallelIter {
-    channels: std::collections::VecDeque<mpsc::Receiver<PolarsResult<DataFrame>>>,
-    handles: Vec<JoinHandle<()>>,
-    row_index_name: Option<String>,
-    row_cursor: usize,
-}
-
-impl Iterator for OrderedParallelIter {
-    type Item = PolarsResult<DataFrame>;
-    fn next(&mut self) -> Option<Self::Item> {
-        loop {
-            let front = self.channels.front()?;
-            match front.recv() {
-                Ok(df_result) => {
-                    return Some(df_result.and_then(|df| {
-                        if let Some(ref name) = self.row_index_name {
-                            let n = df.height();
-                            let result =
-                                crate::append_row_index(df, name.as_str(), self.row_cursor);
-                            self.row_cursor += n;
-                            result
-                        } else {
-                            Ok(df)
-                        }
-                    }));
-                }
-                Err(_) => {
-                    self.channels.pop_front();
-                }
-            }
-        }
-    }
-}
-
-impl Drop for OrderedParallelIter {
-    fn drop(&mut self) {
-        self.channels.clear();
-        for h in self.handles.drain(..) {
-            let _ = h.join();
-        }
-    }
-}
-
 fn estimate_data_rows_per_page(
     path: &PathBuf,
     header: &Header,
@@ -731,8 +867,134 @@ fn estimate_data_rows_per_page(
     block_count.max(1).min(avg)
 }
 
-fn spawn_page_worker(
-    tx: mpsc::SyncSender<PolarsResult<DataFrame>>,
+/// Exact `(start_page, rows_to_skip, pages)` for reading `n_rows` rows from `first_row`,
+/// taken from the page index. `pages` covers every page up to the one holding the
+/// last requested row (at least one per worker).
+fn index_page_span(
+    index: &SasPageIndex,
+    first_row: usize,
+    n_rows: usize,
+    total_pages: usize,
+    n_workers: usize,
+) -> Option<(usize, usize, usize)> {
+    let first = index.locate(first_row)?;
+    let start_page = first.page as usize;
+    if start_page >= total_pages {
+        return None;
+    }
+    let last_page = index
+        .locate(first_row + n_rows.max(1) - 1)
+        .or(index.entries().last())
+        .map(|e| e.page as usize)
+        .unwrap_or(start_page)
+        .max(start_page);
+    let pages = (last_page - start_page + 1)
+        .max(n_workers)
+        .min(total_pages - start_page)
+        .max(1);
+    Some((start_page, first_row - first.first_row as usize, pages))
+}
+
+/// Batches decoded from the file a test is watching, to check how far the page
+/// tasks run ahead of the consumer.
+#[cfg(test)]
+static DECODED_BATCHES: std::sync::Mutex<Option<(PathBuf, usize)>> = std::sync::Mutex::new(None);
+
+/// Decode pages `[page_start, page_start + page_count)` into batches of at most
+/// `batch_size` rows. With `sort_tag`, each batch carries the tag and its row
+/// position within the range for [`SortIndexCollectorIter`].
+#[allow(clippy::too_many_arguments)]
+fn read_page_range(
+    path: &PathBuf,
+    header: &Header,
+    metadata: &Metadata,
+    row_length: usize,
+    endian: Endian,
+    format: Format,
+    plans: &[ColumnPlan],
+    col_indices: Option<&[usize]>,
+    batch_size: usize,
+    page_start: usize,
+    page_count: usize,
+    sort_tag: Option<u32>,
+    row_filter: Option<&SasRowFilter>,
+    map: Option<&SharedInput>,
+) -> PolarsResult<Vec<DataFrame>> {
+    let _decode = crate::read_profile::span(crate::read_profile::ProfileStage::RowDecode);
+    let to_polars = |e: Error| PolarsError::ComputeError(e.to_string().into());
+    let mut data_reader = data_reader_at_page_range(
+        path, header, metadata, endian, format, page_start, page_count, 0, map,
+    )
+    .map_err(to_polars)?;
+
+    let mut batches = Vec::new();
+    let mut row_cursor: u32 = 0;
+    let mut exhausted = false;
+    while !exhausted {
+        let mut builder = match col_indices {
+            Some(ci) => DataFrameBuilder::new_with_columns(metadata, ci, batch_size),
+            None => DataFrameBuilder::new(metadata, batch_size),
+        };
+        // Decode straight from the page (or the mapping) instead of copying rows
+        // into an intermediate buffer first.
+        let mut n_read = 0usize;
+        while n_read < batch_size {
+            let (bytes, rows) = data_reader
+                .read_rows_span(batch_size - n_read)
+                .map_err(to_polars)?;
+            if rows == 0 {
+                exhausted = true;
+                break;
+            }
+            match row_filter {
+                Some(f) => {
+                    for row_bytes in bytes.chunks_exact(row_length).take(rows) {
+                        if f.matches(row_bytes) {
+                            builder.add_row_raw(row_bytes, plans);
+                        }
+                    }
+                }
+                None => builder.add_rows_raw(&bytes[..rows * row_length], row_length, plans),
+            }
+            n_read += rows;
+        }
+        if n_read == 0 {
+            break;
+        }
+        let mut df = builder.build().map_err(to_polars)?;
+        if df.height() == 0 {
+            continue;
+        }
+        if let Some(thread_id) = sort_tag {
+            let n = df.height();
+            let thread_col: Column =
+                Series::new("_polars_rs_thread_".into(), vec![thread_id; n]).into();
+            let row_col: Column = Series::new(
+                "_polars_rs_row_".into(),
+                (row_cursor..row_cursor + n as u32).collect::<Vec<u32>>(),
+            )
+            .into();
+            row_cursor += n as u32;
+            df.with_column(thread_col)?;
+            df.with_column(row_col)?;
+        }
+        #[cfg(test)]
+        if let Some((watched, n)) = DECODED_BATCHES.lock().unwrap().as_mut() {
+            if watched == path {
+                *n += 1;
+            }
+        }
+        batches.push(df);
+    }
+    Ok(batches)
+}
+
+/// Data pages `[page_start, page_start + page_count)` read as tasks of
+/// `pages_per_task` pages on the shared worker pool, at most `n_workers` of them
+/// in flight. Row indexes are left to the caller: realized row counts are only
+/// known once a task has run.
+#[allow(clippy::too_many_arguments)]
+fn page_tasks(
     path: PathBuf,
     header: Header,
     metadata: Arc<Metadata>,
@@ -742,93 +1004,265 @@ fn spawn_page_worker(
     plans: Arc<Vec<ColumnPlan>>,
     col_indices: Option<Vec<usize>>,
     batch_size: usize,
-    worker_page_start: usize,
-    worker_page_count: usize,
-    sort_tag: Option<u32>,
-) -> JoinHandle<()> {
-    std::thread::spawn(move || {
-        let mut data_reader = match data_reader_at_page_range(
-            &path,
-            &header,
-            &metadata,
-            endian,
-            format,
-            worker_page_start,
-            worker_page_count,
-            0,
-        ) {
-            Ok(r) => r,
-            Err(e) => {
-                let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
-                return;
-            }
-        };
+    page_start: usize,
+    page_count: usize,
+    pages_per_task: usize,
+    n_workers: usize,
+    preserve_order: bool,
+    sort_tags: bool,
+    row_filter: Option<Arc<SasRowFilter>>,
+    map: Option<SharedInput>,
+) -> crate::worker_pool::ScanTasks {
+    let pages_per_task = pages_per_task.max(1);
+    let n_tasks = page_count.div_ceil(pages_per_task);
+    crate::worker_pool::ScanTasks::new(
+        n_tasks,
+        crate::worker_pool::scan_limit(n_workers),
+        preserve_order,
+        move |task| {
+            let task_start = page_start + task * pages_per_task;
+            read_page_range(
+                &path,
+                &header,
+                &metadata,
+                row_length,
+                endian,
+                format,
+                &plans,
+                col_indices.as_deref(),
+                batch_size,
+                task_start,
+                pages_per_task.min(page_start + page_count - task_start),
+                sort_tags.then_some(task as u32),
+                row_filter.as_deref(),
+                map.as_ref(),
+            )
+        },
+    )
+}
 
-        let mut row_cursor: u32 = 0;
+/// Pages `[page_start, page_start + page_count)` in file order, read as tasks
+/// of `pages_per_task` pages (fewer when that would leave workers idle).
+#[allow(clippy::too_many_arguments)]
+fn ordered_parallel_page_iter(
+    path: PathBuf,
+    header: Header,
+    metadata: Arc<Metadata>,
+    row_length: usize,
+    endian: Endian,
+    format: Format,
+    plans: Arc<Vec<ColumnPlan>>,
+    col_indices: Option<Vec<usize>>,
+    batch_size: usize,
+    page_start: usize,
+    page_count: usize,
+    pages_per_task: usize,
+    n_workers: usize,
+    map: Option<SharedInput>,
+) -> SasBatchIter {
+    let worker_count = min(n_workers.max(1), page_count.max(1));
+    let pages_per_task = pages_per_task.min(page_count.div_ceil(worker_count)).max(1);
+    Box::new(page_tasks(
+        path,
+        header,
+        metadata,
+        row_length,
+        endian,
+        format,
+        plans,
+        col_indices,
+        batch_size,
+        page_start,
+        page_count,
+        pages_per_task,
+        worker_count,
+        true,
+        false,
+        None,
+        map,
+    ))
+}
+
+/// A contiguous run of raw pages of a compressed file.
+struct CompressedPageTask {
+    bytes: CompressedPageBytes,
+    page_count: usize,
+}
+
+enum CompressedPageBytes {
+    Owned(Vec<u8>),
+    /// Pages are read in place from a mapped file starting at `offset`.
+    Mapped {
+        map: SharedMap,
+        offset: u64,
+    },
+}
 
+/// One decoded page group. `raw_rows` counts every row the pages held; with a row
+/// filter, `kept` lists the group-local positions of the rows that made it into `df`.
+struct DecodedPageGroup {
+    df: DataFrame,
+    raw_rows: usize,
+    kept: Option<Vec<u32>>,
+}
+
+// Compressed files: fixed-size page groups are read and decoded as tasks on the
+// shared worker pool; each task decompresses and decodes its group in memory, and
+// groups come back in file order.
+//
+// Pages can hold more data subheaders than the metadata row_count, so the iterator
+// also caps output at `remaining` raw rows, trimming the trailing phantom rows.
+struct PipelinedCompressedIter {
+    groups: crate::worker_pool::ScanTasks<DecodedPageGroup>,
+    remaining: usize,
+    row_index_name: Option<String>,
+    row_cursor: usize,
+}
+
+impl Iterator for PipelinedCompressedIter {
+    type Item = PolarsResult<DataFrame>;
+    fn next(&mut self) -> Option<Self::Item> {
         loop {
-            let mut buf = Vec::new();
-            let n_read = match data_reader.read_rows_bulk(batch_size, &mut buf) {
-                Ok(n) => n,
-                Err(e) => {
-                    let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
-                    return;
-                }
-            };
-            if n_read == 0 {
-                break;
-            }
-            let mut builder = match col_indices.as_deref() {
-                Some(ci) => DataFrameBuilder::new_with_columns(&metadata, ci, n_read),
-                None => DataFrameBuilder::new(&metadata, n_read),
-            };
-            for i in 0..n_read {
-                let rs = i * row_length;
-                builder.add_row_raw(&buf[rs..rs + row_length], &plans);
+            if self.remaining == 0 {
+                return None;
             }
-            match builder.build() {
+            let df_result = self.groups.next()?.map(|group| {
+                if group.raw_rows <= self.remaining {
+                    self.remaining -= group.raw_rows;
+                    return group.df;
+                }
+                let cutoff = self.remaining;
+                self.remaining = 0;
+                let keep = match group.kept {
+                    Some(kept) => kept.partition_point(|&i| (i as usize) < cutoff),
+                    None => cutoff,
+                };
+                group.df.slice(0, keep)
+            });
+            match df_result {
+                Ok(df) if df.height() == 0 => continue,
                 Ok(df) => {
-                    let df = if let Some(thread_id) = sort_tag {
+                    if let Some(ref name) = self.row_index_name {
                         let n = df.height();
-                        let thread_col: Column =
-                            Series::new("_polars_rs_thread_".into(), vec![thread_id; n]).into();
-                        let row_col: Column = Series::new(
-                            "_polars_rs_row_".into(),
-                            (row_cursor..row_cursor + n as u32).collect::<Vec<u32>>(),
-                        )
-                        .into();
-                        row_cursor += n as u32;
-                        let mut df = df;
-                        if let Err(e) = df.with_column(thread_col) {
-                            let _ = tx.send(Err(e));
-                            return;
-                        }
-                        if let Err(e) = df.with_column(row_col) {
-                            let _ = tx.send(Err(e));
-                            return;
-                        }
-                        df
-                    } else {
-                        df
-                    };
-                    if tx.send(Ok(df)).is_err() {
-                        return;
+                        let result = crate::append_row_index(df, name.as_str(), self.row_cursor);
+                        self.row_cursor += n;
+                        return Some(result);
                     }
+                    return Some(Ok(df));
                 }
                 Err(e) => {
-                    let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
-                    return;
+                    self.remaining = 0;
+                    return Some(Err(e));
                 }
             }
         }
+    }
+}
+
+/// Raw pages `[page_start, page_start + page_count)`, borrowed from the mapping
+/// when the file is mapped.
+fn read_compressed_pages(
+    path: &PathBuf,
+    header: &Header,
+    page_start: usize,
+    page_count: usize,
+    map: Option<&SharedInput>,
+) -> PolarsResult<CompressedPageTask> {
+    let page_length = header.page_length;
+    let offset = header.header_length as u64 + page_start as u64 * page_length as u64;
+    if let Some(map) = map.and_then(SharedInput::mapped) {
+        // Nothing to read up front: the decoder faults the pages in as it goes.
+        return Ok(CompressedPageTask {
+            bytes: CompressedPageBytes::Mapped {
+                map: map.clone(),
+                offset,
+            },
+            page_count,
+        });
+    }
+    let mut file = FileSource::open(path, 8 * 1024, map)?;
+    file.seek(SeekFrom::Start(offset))?;
+    let mut bytes = vec![0u8; page_count * page_length];
+    std::io::Read::read_exact(&mut file, &mut bytes)?;
+    Ok(CompressedPageTask {
+        bytes: CompressedPageBytes::Owned(bytes),
+        page_count,
     })
 }
 
-fn ordered_parallel_page_iter(
+/// Decompress and decode one page group into a single DataFrame.
+#[allow(clippy::too_many_arguments)]
+fn decode_compressed_pages(
+    task: CompressedPageTask,
+    header: &Header,
+    metadata: &Metadata,
+    row_length: usize,
+    endian: Endian,
+    format: Format,
+    plans: &[ColumnPlan],
+    col_indices: Option<&[usize]>,
+    rows_hint: usize,
+    row_filter: Option<&SasRowFilter>,
+    buf: &mut Vec<u8>,
+) -> PolarsResult<DecodedPageGroup> {
+    let _decode = crate::read_profile::span(crate::read_profile::ProfileStage::RowDecode);
+    let to_polars = |e: Error| PolarsError::ComputeError(e.to_string().into());
+    // A mapped group never touches the cursor; the page reader borrows from the map.
+    let (bytes, mapping) = match task.bytes {
+        CompressedPageBytes::Owned(bytes) => (bytes, None),
+        CompressedPageBytes::Mapped { map, offset } => (Vec::new(), Some((map, offset))),
+    };
+    let mut page_reader =
+        PageReader::new(std::io::Cursor::new(bytes), header.clone(), endian, format);
+    if let Some((map, offset)) = mapping {
+        page_reader = page_reader.with_mapping(Some(map), offset);
+    }
+    let mut data_reader =
+        DataReader::new(page_reader, metadata.clone(), endian, format, Vec::new())
+            .map_err(to_polars)?;
+    // DataReader::new() already consumed the group's first page.
+    data_reader.set_max_physical_pages(task.page_count.saturating_sub(1));
+
+    let mut builder = match col_indices {
+        Some(ci) => DataFrameBuilder::new_with_columns(metadata, ci, rows_hint),
+        None => DataFrameBuilder::new(metadata, rows_hint),
+    };
+    let mut raw_rows = 0usize;
+    let mut kept = row_filter.map(|_| Vec::new());
+    loop {
+        buf.clear();
+        let n_read = data_reader
+            .read_rows_bulk(rows_hint.max(1), buf)
+            .map_err(to_polars)?;
+        if n_read == 0 {
+            break;
+        }
+        if let (Some(filter), Some(kept)) = (row_filter, kept.as_mut()) {
+            for i in 0..n_read {
+                let rs = i * row_length;
+                let row_bytes = &buf[rs..rs + row_length];
+                if !filter.matches(row_bytes) {
+                    continue;
+                }
+                kept.push((raw_rows + i) as u32);
+                builder.add_row_raw(row_bytes, plans);
+            }
+        } else {
+            builder.add_rows_raw(&buf[..n_read * row_length], row_length, plans);
+        }
+        raw_rows += n_read;
+    }
+    Ok(DecodedPageGroup {
+        df: builder.build().map_err(to_polars)?,
+        raw_rows,
+        kept,
+    })
+}
+
+fn pipelined_compressed_iter(
     path: PathBuf,
     header: Header,
     metadata: Arc<Metadata>,
-    row_length: usize,
     endian: Endian,
     format: Format,
     plans: Arc<Vec<ColumnPlan>>,
@@ -836,43 +1270,58 @@ fn ordered_parallel_page_iter(
     batch_size: usize,
     page_start: usize,
     page_count: usize,
+    est_rows_per_page: usize,
     n_workers: usize,
+    total_rows: usize,
+    row_index_name: Option<String>,
+    row_index_start: usize,
+    row_filter: Option<Arc<SasRowFilter>>,
+    map: Option<SharedInput>,
 ) -> SasBatchIter {
-    let worker_count = min(n_workers.max(1), page_count.max(1));
-    let pages_per_worker = page_count.div_ceil(worker_count);
-    let mut channels = std::collections::VecDeque::with_capacity(worker_count);
-    let mut handles: Vec<JoinHandle<()>> = Vec::with_capacity(worker_count);
-
-    for worker_idx in 0..worker_count {
-        let worker_page_start = page_start + worker_idx * pages_per_worker;
-        if worker_page_start >= page_start + page_count {
-            break;
-        }
-        let worker_page_count = pages_per_worker.min(page_start + page_count - worker_page_start);
-        let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(4);
-        channels.push_back(rx);
-        handles.push(spawn_page_worker(
-            tx,
-            path.clone(),
-            header.clone(),
-            metadata.clone(),
-            row_length,
-            endian,
-            format,
-            plans.clone(),
-            col_indices.clone(),
-            batch_size,
-            worker_page_start,
-            worker_page_count,
-            None,
-        ));
-    }
+    // Size page groups so each one decodes to roughly one batch, but keep at least
+    // a couple of groups per worker so the work stays balanced.
+    let pages_per_task = batch_size
+        .div_ceil(est_rows_per_page.max(1))
+        .min(page_count.div_ceil(n_workers.max(1) * 2))
+        .max(1);
+    let n_tasks = page_count.div_ceil(pages_per_task);
+    let rows_hint = (pages_per_task * est_rows_per_page).min(batch_size.max(1) * 2);
+
+    let groups = crate::worker_pool::ScanTasks::new(
+        n_tasks,
+        crate::worker_pool::scan_limit(n_workers),
+        true,
+        move |task| {
+            let group_start = page_start + task * pages_per_task;
+            let pages = read_compressed_pages(
+                &path,
+                &header,
+                group_start,
+                pages_per_task.min(page_start + page_count - group_start),
+                map.as_ref(),
+            )?;
+            let group = decode_compressed_pages(
+                pages,
+                &header,
+                &metadata,
+                metadata.row_length,
+                endian,
+                format,
+                &plans,
+                col_indices.as_deref(),
+                rows_hint,
+                row_filter.as_deref(),
+                &mut Vec::new(),
+            )?;
+            Ok(vec![group])
+        },
+    );
 
-    Box::new(OrderedParallelIter {
-        channels,
-        handles,
-        row_index_name: None,
-        row_cursor: 0,
+    Box::new(PipelinedCompressedIter {
+        groups,
+        remaining: total_rows,
+        row_index_name,
+        row_cursor: row_index_start,
     })
 }
 
@@ -887,7 +1336,7 @@ impl Iterator for SasBackgroundIter {
     type Item = PolarsResult<DataFrame>;
 
     fn next(&mut self) -> Option<Self::Item> {
-        self.rx.as_ref()?.recv().ok()
+        crate::read_profile::wait(|| self.rx.as_ref()?.recv().ok())
     }
 }
 
@@ -903,7 +1352,7 @@ impl Drop for SasBackgroundIter {
 }
 
 pub(crate) struct SerialSasBatchIter {
-    data_reader: DataReader<BufReader<File>>,
+    data_reader: DataReader<FileSource>,
     metadata: Metadata,
     plans: Vec<ColumnPlan>,
     col_indices: Option<Vec<usize>>,
@@ -911,6 +1360,7 @@ pub(crate) struct SerialSasBatchIter {
     remaining: usize,
     row_index_name: Option<String>,
     current_row: usize,
+    row_filter: Option<Arc<SasRowFilter>>,
     // Informative-null state (empty/None when not tracking)
     null_opts: Option<crate::InformativeNullOpts>,
     indicator_plan_indices: Vec<usize>,
@@ -934,10 +1384,26 @@ impl SerialSasBatchIter {
         null_opts: Option<crate::InformativeNullOpts>,
         skip: usize,
         row_index_name: Option<String>,
+        row_filter: Option<Arc<SasRowFilter>>,
+        map: Option<SharedInput>,
+        page_index: Option<&SasPageIndex>,
     ) -> PolarsResult<Self> {
-        let mut file = BufReader::new(File::open(&path)?);
-        file.seek(SeekFrom::Start(header.header_length as u64))?;
-        let page_reader = PageReader::new(file, header, endian, format);
+        // With a page index, start at the page holding row `skip` instead of walking
+        // every page before it.
+        let seek = page_index
+            .filter(|_| skip > 0)
+            .and_then(|index| index.locate(skip));
+        let (start_page, first_row, initial_data_subheaders) = match seek {
+            Some(entry) => (entry.page, entry.first_row as usize, Vec::new()),
+            None => (0, 0, initial_data_subheaders),
+        };
+        let data_start = header.header_length as u64 + start_page * header.page_length as u64;
+        let mut file = FileSource::open(&path, 8 * 1024, map.as_ref())?;
+        file.seek(SeekFrom::Start(data_start))?;
+        let page_reader = PageReader::new(file, header, endian, format).with_mapping(
+            map.as_ref().and_then(SharedInput::mapped).cloned(),
+            data_start,
+        );
         let mut data_reader = DataReader::new(
             page_reader,
             metadata.clone(),
@@ -946,10 +1412,11 @@ impl SerialSasBatchIter {
             initial_data_subheaders,
         )
         .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+        data_reader.set_current_row(first_row);
 
-        if skip > 0 {
+        if skip > first_row {
             data_reader
-                .skip_rows(skip)
+                .skip_rows(skip - first_row)
                 .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
         }
 
@@ -1015,6 +1482,7 @@ impl SerialSasBatchIter {
             remaining: total,
             row_index_name,
             current_row: skip,
+            row_filter,
             null_opts,
             indicator_plan_indices,
             indicator_names,
@@ -1030,6 +1498,7 @@ impl Iterator for SerialSasBatchIter {
         if self.remaining == 0 {
             return None;
         }
+        let _decode = crate::read_profile::span(crate::read_profile::ProfileStage::RowDecode);
         let take = self.batch_size.min(self.remaining);
         let mut builder = match self.col_indices.as_deref() {
             Some(idx) => DataFrameBuilder::new_with_columns(&self.metadata, idx, take),
@@ -1056,10 +1525,18 @@ impl Iterator for SerialSasBatchIter {
             Vec::new()
         };
 
+        // `read` counts raw rows consumed; with a row filter, `kept` may lag behind.
         let mut read = 0usize;
-        for _ in 0..take {
+        let mut kept = 0usize;
+        while kept < take && read < self.remaining {
             match self.data_reader.read_row_borrowed() {
                 Ok(Some(row_bytes)) => {
+                    read += 1;
+                    if let Some(filter) = self.row_filter.as_ref() {
+                        if !filter.matches(row_bytes) {
+                            continue;
+                        }
+                    }
                     builder.add_row_raw(row_bytes, &self.plans);
                     if has_inds {
                         for (plan_pos, plan) in self.plans.iter().enumerate() {
@@ -1097,7 +1574,7 @@ impl Iterator for SerialSasBatchIter {
                             }
                         }
                     }
-                    read += 1;
+                    kept += 1;
                 }
                 Ok(None) => break,
                 Err(e) => return Some(Err(PolarsError::ComputeError(e.to_string().into()))),
@@ -1165,8 +1642,8 @@ pub(crate) fn sas_batch_iter(
     row_index_name: Option<String>,
     informative_nulls: Option<crate::InformativeNullOpts>,
 ) -> PolarsResult<SasBatchIter> {
-    let reader =
-        Sas7bdatReader::open(&path).map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+    let reader = Sas7bdatReader::open_cached(&path)
+        .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
     sas_batch_iter_with_reader(
         &reader,
         path,
@@ -1180,6 +1657,9 @@ pub(crate) fn sas_batch_iter(
         row_index_name,
         informative_nulls,
         false,
+        None,
+        false,
+        None,
     )
 }
 
@@ -1196,6 +1676,9 @@ pub(crate) fn sas_batch_iter_with_reader(
     row_index_name: Option<String>,
     informative_nulls: Option<crate::InformativeNullOpts>,
     add_sort_tags: bool,
+    row_filter: Option<Arc<crate::RowFilter>>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 ) -> PolarsResult<SasBatchIter> {
     let max_rows = reader.metadata().row_count.saturating_sub(offset);
     let total = n_rows.unwrap_or(max_rows).min(max_rows);
@@ -1223,6 +1706,22 @@ pub(crate) fn sas_batch_iter_with_reader(
         }
     }
 
+    // Filtered-out rows would leave holes in the row index, so filters are only
+    // pushed down when no row index is requested.
+    let row_filter: Option<Arc<SasRowFilter>> = row_filter
+        .filter(|_| row_index_name.is_none())
+        .and_then(|f| {
+            SasRowFilter::compile(
+                &f,
+                reader.metadata(),
+                reader.endian(),
+                missing_string_as_null,
+            )
+        })
+        .map(Arc::new);
+    let map = crate::mmap_source::open_input(use_mmap, read_ahead, &path);
+    let page_index = reader.page_index();
+
     // When informative nulls are requested, always use the serial path (needs row-by-row decode).
     if let Some(null_opts) = informative_nulls {
         // Collision check
@@ -1288,11 +1787,14 @@ pub(crate) fn sas_batch_iter_with_reader(
             Some(null_opts),
             offset,
             row_index_name,
+            row_filter,
+            map.clone(),
+            page_index,
         )?;
         let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
-        let handle = std::thread::spawn(move || {
+        let handle = crate::read_profile::spawn(move || {
             for batch in serial {
-                if tx.send(batch).is_err() {
+                if crate::read_profile::wait(|| tx.send(batch)).is_err() {
                     return;
                 }
             }
@@ -1344,11 +1846,14 @@ pub(crate) fn sas_batch_iter_with_reader(
             None,
             offset,
             row_index_name,
+            row_filter.clone(),
+            map.clone(),
+            page_index,
         )?;
         let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
-        let handle = std::thread::spawn(move || {
+        let handle = crate::read_profile::spawn(move || {
             for batch in serial {
-                if tx.send(batch).is_err() {
+                if crate::read_profile::wait(|| tx.send(batch)).is_err() {
                     return;
                 }
             }
@@ -1405,6 +1910,9 @@ pub(crate) fn sas_batch_iter_with_reader(
             None,
             0,
             row_index_name.clone(),
+            row_filter.clone(),
+            map.clone(),
+            page_index,
         )?)
     } else {
         None
@@ -1419,7 +1927,11 @@ pub(crate) fn sas_batch_iter_with_reader(
     }
 
     if partial_read {
-        if offset > 0 {
+        // Filtered batches no longer line up with raw row counts, which the sliced
+        // parallel path below relies on; the serial reader counts raw rows itself.
+        // Without a page index the starting page for an offset can only be guessed,
+        // so offset reads also go through the serial reader's skip.
+        if row_filter.is_some() || (offset > 0 && page_index.is_none()) {
             let initial_data_subheaders = reader.initial_data_subheaders().to_vec();
             let serial = SerialSasBatchIter::new(
                 path.to_path_buf(),
@@ -1435,11 +1947,14 @@ pub(crate) fn sas_batch_iter_with_reader(
                 None,
                 offset,
                 row_index_name,
+                row_filter.clone(),
+                map.clone(),
+                page_index,
             )?;
             let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
-            let handle = std::thread::spawn(move || {
+            let handle = crate::read_profile::spawn(move || {
                 for batch in serial {
-                    if tx.send(batch).is_err() {
+                    if crate::read_profile::wait(|| tx.send(batch)).is_err() {
                         return;
                     }
                 }
@@ -1471,6 +1986,9 @@ pub(crate) fn sas_batch_iter_with_reader(
                 None,
                 offset,
                 None,
+                None,
+                map.clone(),
+                page_index,
             )?)
         } else {
             Box::new(std::iter::empty())
@@ -1478,8 +1996,8 @@ pub(crate) fn sas_batch_iter_with_reader(
 
         let requested_data_rows = total.saturating_sub(requested_mix_rows);
         if requested_data_rows > 0 {
+            let first_row = offset.max(mix_data_rows);
             let total_data_rows = reader.metadata().row_count.saturating_sub(mix_data_rows);
-            let data_offset = offset.saturating_sub(mix_data_rows);
             let est_rows_per_page = estimate_data_rows_per_page(
                 &path,
                 &header,
@@ -1489,16 +2007,37 @@ pub(crate) fn sas_batch_iter_with_reader(
                 total_data_rows,
                 data_pages,
             );
-            let est_start_page_idx = data_offset / est_rows_per_page;
-            let lookback_pages = est_start_page_idx.min(n_workers.max(8));
-            let start_page_idx = est_start_page_idx.saturating_sub(lookback_pages);
-            let skip_in_estimate = data_offset.saturating_sub(start_page_idx * est_rows_per_page);
-            let initial_pages = (skip_in_estimate + requested_data_rows)
-                .div_ceil(est_rows_per_page)
-                .saturating_add(1)
-                .max(n_workers)
-                .min(data_pages - start_page_idx)
-                .max(1);
+            let span = page_index.and_then(|index| {
+                index_page_span(
+                    index,
+                    first_row,
+                    requested_data_rows,
+                    total_pages,
+                    n_workers,
+                )
+            });
+            let (start_page, skip_in_estimate, initial_pages) = match span {
+                Some(span) => span,
+                None => {
+                    let data_offset = offset.saturating_sub(mix_data_rows);
+                    let est_start_page_idx = data_offset / est_rows_per_page;
+                    let lookback_pages = est_start_page_idx.min(n_workers.max(8));
+                    let start_page_idx = est_start_page_idx.saturating_sub(lookback_pages);
+                    let skip_in_estimate =
+                        data_offset.saturating_sub(start_page_idx * est_rows_per_page);
+                    let initial_pages = (skip_in_estimate + requested_data_rows)
+                        .div_ceil(est_rows_per_page)
+                        .saturating_add(1)
+                        .max(n_workers)
+                        .min(data_pages - start_page_idx)
+                        .max(1);
+                    (
+                        first_data_page + start_page_idx,
+                        skip_in_estimate,
+                        initial_pages,
+                    )
+                }
+            };
 
             let adaptive = AdaptivePageIter {
                 path: path.clone(),
@@ -1510,10 +2049,12 @@ pub(crate) fn sas_batch_iter_with_reader(
                 plans: plans_arc.clone(),
                 col_indices: col_indices.clone(),
                 batch_size,
-                next_page: first_data_page + start_page_idx,
-                remaining_pages: data_pages - start_page_idx,
+                next_page: start_page,
+                remaining_pages: total_pages - start_page,
                 pages_per_chunk: initial_pages,
+                pages_per_task: batch_size.div_ceil(est_rows_per_page),
                 n_workers,
+                map: map.clone(),
                 current: None,
             };
             let data_iter: SasBatchIter = Box::new(SlicedBatchIter {
@@ -1535,108 +2076,104 @@ pub(crate) fn sas_batch_iter_with_reader(
         });
     }
 
-    // Phase 2: parallel workers for DATA pages only (starting at first_data_page).
-    // row_start is 0 per worker — page budget is the sole stopping condition.
-    let pages_per_worker = data_pages.div_ceil(n_workers);
-    let mut handles: Vec<JoinHandle<()>> = Vec::with_capacity(n_workers);
-
-    // Helper: spawn one worker thread that reads pages [page_start, page_start+page_count)
-    // and sends each batch (≤ batch_size rows) down `tx`.
-    // Row index assignment happens in the iterator, not in workers, so the counter
+    // Phase 2: parallel page tasks for DATA pages only (starting at first_data_page).
+    // Tasks are sized to about one batch each, with at least one per worker; their
+    // row_start is 0 — the page budget is the sole stopping condition.
+    // Row index assignment happens in the iterator, not in tasks, so the counter
     // is always exact based on realized row counts rather than geometry estimates.
     let row_index_start = mix_data_rows;
 
-    // Row index, partial reads, and compressed files all require file-order output.
-    // Compressed files need ordering so that the row-count cap (applied below) always
-    // trims the same trailing phantom rows rather than random worker tails.
+    // Row index and partial reads require file-order output. Compressed files go
+    // through the pipelined reader, which is ordered by construction and applies the
+    // row-count cap itself.
     // When add_sort_tags is true, row index assignment happens post-collection via thread/row
     // tags, so row_index_name alone no longer forces ordered mode.
     let is_compressed = reader.metadata().compression != crate::Compression::None;
-    let use_ordered = preserve_order
-        || (row_index_name.is_some() && !add_sort_tags)
-        || partial_read
-        || is_compressed;
-    let base_iter: SasBatchIter = if use_ordered {
-        let mut channels: std::collections::VecDeque<mpsc::Receiver<PolarsResult<DataFrame>>> =
-            std::collections::VecDeque::with_capacity(n_workers);
-        for worker_idx in 0..n_workers {
-            let wp_start = first_data_page + worker_idx * pages_per_worker;
-            if wp_start >= total_pages {
-                break;
-            }
-            let wp_count = pages_per_worker.min(total_pages - wp_start);
-            let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(4);
-            channels.push_back(rx);
-            handles.push(spawn_page_worker(
-                tx,
-                path.clone(),
-                header.clone(),
-                metadata.clone(),
-                row_length,
-                endian,
-                format,
-                plans_arc.clone(),
-                col_indices.clone(),
-                batch_size,
-                wp_start,
-                wp_count,
-                None,
-            ));
-        }
-        let parallel = OrderedParallelIter {
-            channels,
-            handles,
-            row_index_name: row_index_name.clone(),
-            row_cursor: row_index_start,
-        };
+    let use_ordered =
+        preserve_order || (row_index_name.is_some() && !add_sort_tags) || partial_read;
+    let base_iter: SasBatchIter = if is_compressed {
+        let total_data_rows = reader.metadata().row_count.saturating_sub(mix_data_rows);
+        let est_rows_per_page = estimate_data_rows_per_page(
+            &path,
+            &header,
+            endian,
+            format,
+            first_data_page,
+            total_data_rows,
+            data_pages,
+        );
+        let parallel = pipelined_compressed_iter(
+            path.clone(),
+            header.clone(),
+            metadata.clone(),
+            endian,
+            format,
+            plans_arc.clone(),
+            col_indices.clone(),
+            batch_size,
+            first_data_page,
+            data_pages,
+            est_rows_per_page,
+            n_workers,
+            total_data_rows,
+            row_index_name.clone(),
+            row_index_start,
+            row_filter.clone(),
+            map.clone(),
+        );
         match mix_iter {
             Some(mix) => Box::new(mix.chain(parallel)) as SasBatchIter,
-            None => Box::new(parallel) as SasBatchIter,
+            None => parallel,
         }
     } else {
-        let (shared_tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(n_workers * 4);
-        for worker_idx in 0..n_workers {
-            let wp_start = first_data_page + worker_idx * pages_per_worker;
-            if wp_start >= total_pages {
-                break;
-            }
-            let wp_count = pages_per_worker.min(total_pages - wp_start);
-            handles.push(spawn_page_worker(
-                shared_tx.clone(),
-                path.clone(),
-                header.clone(),
-                metadata.clone(),
-                row_length,
-                endian,
-                format,
-                plans_arc.clone(),
-                col_indices.clone(),
-                batch_size,
-                wp_start,
-                wp_count,
-                if add_sort_tags {
-                    Some(worker_idx as u32)
-                } else {
-                    None
-                },
-            ));
-        }
-        drop(shared_tx);
-        let parallel = UnorderedParallelIter {
-            rx: Some(rx),
-            handles,
-            row_index_name: if add_sort_tags {
-                None
-            } else {
-                row_index_name.clone()
-            },
-            row_cursor: row_index_start,
+        let total_data_rows = reader.metadata().row_count.saturating_sub(mix_data_rows);
+        let est_rows_per_page = estimate_data_rows_per_page(
+            &path,
+            &header,
+            endian,
+            format,
+            first_data_page,
+            total_data_rows,
+            data_pages,
+        );
+        let pages_per_task = batch_size
+            .div_ceil(est_rows_per_page)
+            .min(data_pages.div_ceil(n_workers));
+        let sort_tags = add_sort_tags && !use_ordered;
+        let tasks = page_tasks(
+            path.clone(),
+            header.clone(),
+            metadata.clone(),
+            row_length,
+            endian,
+            format,
+            plans_arc.clone(),
+            col_indices.clone(),
+            batch_size,
+            first_data_page,
+            data_pages,
+            pages_per_task,
+            n_workers,
+            use_ordered,
+            sort_tags,
+            row_filter.clone(),
+            map.clone(),
+        );
+        // Sort-tagged rows are numbered once collected; unordered reads without
+        // tags number them in arrival order.
+        let parallel: SasBatchIter = match row_index_name.clone() {
+            Some(name) if !sort_tags => Box::new(RowIndexedIter {
+                inner: Box::new(tasks),
+                row_index_name: name,
+                row_cursor: row_index_start,
+            }),
+            _ => Box::new(tasks),
         };
         let base: SasBatchIter = match mix_iter {
             Some(mix) => Box::new(mix.chain(parallel)) as SasBatchIter,
             None => Box::new(parallel) as SasBatchIter,
         };
-        if add_sort_tags {
+        if sort_tags {
             if let Some(name) = row_index_name.clone() {
                 Box::new(SortIndexCollectorIter {
                     inner: Some(base),
@@ -1656,16 +2193,6 @@ pub(crate) fn sas_batch_iter_with_reader(
             skip: offset,
             remaining: total,
         }))
-    } else if reader.metadata().compression != crate::Compression::None {
-        // Compressed files: each parallel worker starts its own current_row counter at 0,
-        // so the per-worker row_count guard in ensure_row_ready doesn't cap the global
-        // total. Pages can contain more data subheaders than the metadata row_count,
-        // so cap the combined output explicitly.
-        Ok(Box::new(SlicedBatchIter {
-            inner: base_iter,
-            skip: 0,
-            remaining: total,
-        }))
     } else {
         Ok(base_iter)
     }
@@ -1677,9 +2204,20 @@ impl AnonymousScan for SasScan {
     }
 
     fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
-        let reader = Sas7bdatReader::open(&self.path)
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let reader = Sas7bdatReader::open_cached(&self.path)
             .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
 
+        let predicate = opts.predicate.as_ref();
+        let row_filter = predicate.and_then(crate::RowFilter::from_expr).map(Arc::new);
+        let extra_columns = predicate
+            .map(|p| {
+                crate::row_filter::predicate_extra_columns(p, opts.with_columns.as_deref(), |n| {
+                    reader.metadata().columns.iter().any(|c| c.name == n)
+                })
+            })
+            .unwrap_or_default();
+
         // Resolve Column Names -> Indices
         let col_indices = if let Some(cols) = opts.with_columns {
             let col_name_to_idx: std::collections::HashMap<&str, usize> = reader
@@ -1700,6 +2238,9 @@ impl AnonymousScan for SasScan {
                     })?;
                 indices.push(idx);
             }
+            for name in &extra_columns {
+                indices.push(col_name_to_idx[name.as_str()]);
+            }
             Some(indices)
         } else {
             None
@@ -1717,6 +2258,11 @@ impl AnonymousScan for SasScan {
             && mix_data_rows == 0
             && !is_compressed
             && opts.n_rows.is_none();
+        let expected_rows = crate::frame_assembly::expected_rows(
+            reader.metadata().row_count,
+            opts.n_rows,
+            row_filter.is_some(),
+        );
 
         let iter = sas_batch_iter_with_reader(
             &reader,
@@ -1731,21 +2277,24 @@ impl AnonymousScan for SasScan {
             self.row_index_name.clone(),
             self.informative_nulls.clone(),
             add_sort_tags,
+            row_filter,
+            self.use_mmap,
+            self.read_ahead,
         )?;
 
         let prefetch = crate::scan_prefetch::spawn_prefetcher(iter.map(|batch| batch));
-        let mut out: Option<DataFrame> = None;
+        // Without a residual predicate the rows read are the rows returned, so the
+        // columns can be compressed as they are assembled.
+        let fuse = self.compress_opts.enabled && predicate.is_none();
+        let mut out = crate::frame_assembly::FrameAssembler::new(expected_rows)
+            .with_compression(fuse.then_some(&self.compress_opts));
         while let Some(df) = prefetch.next()? {
-            if let Some(acc) = out.as_mut() {
-                acc.vstack_mut(&df)
-                    .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
-            } else {
-                out = Some(df);
-            }
+            out.push(df)?;
         }
-        let df = out.unwrap_or_else(DataFrame::empty);
+        let df = out.finish()?;
+        let df = crate::row_filter::apply_residual_predicate(df, predicate, &extra_columns)?;
 
-        if self.compress_opts.enabled {
+        if self.compress_opts.enabled && !fuse {
             let compressed = crate::compress_df_if_enabled(&df, &self.compress_opts)
                 .map_err(|e| PolarsError::ComputeError(e.into()))?;
             Ok(compressed)
@@ -1754,9 +2303,14 @@ impl AnonymousScan for SasScan {
         }
     }
 
+    fn allows_predicate_pushdown(&self) -> bool {
+        true
+    }
+
     // FIX: method signature updated to include Option<usize>
     fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
-        let reader = Sas7bdatReader::open(&self.path)
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let reader = Sas7bdatReader::open_cached(&self.path)
             .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
 
         let cols = &reader.metadata().columns;
@@ -1853,24 +2407,13 @@ pub fn scan_sas7bdat(
     path: impl Into<std::path::PathBuf>,
     opts: crate::ScanOptions,
 ) -> PolarsResult<LazyFrame> {
-    let path = path.into();
-    let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
-    let scan_ptr = Arc::new(SasScan::new(
-        path,
-        opts.threads,
-        missing_string_as_null,
-        opts.chunk_size,
-        opts.preserve_order.unwrap_or(false),
-        opts.row_index_name,
-        opts.compress_opts,
-        opts.informative_nulls,
-    ));
-    LazyFrame::anonymous_scan(scan_ptr, Default::default())
+    let scan = SasScan::from_options(path.into(), opts);
+    LazyFrame::anonymous_scan(Arc::new(scan), Default::default())
 }
 
 #[cfg(test)]
 mod tests {
-    use super::sas_batch_iter;
+    use super::{sas_batch_iter, sas_batch_iter_with_reader, Sas7bdatReader, DECODED_BATCHES};
     use std::path::PathBuf;
 
     fn small_sas_path() -> PathBuf {
@@ -1920,4 +2463,63 @@ mod tests {
         assert!(batches >= 1);
         assert!(rows <= 25);
     }
+
+    #[test]
+    fn test_offset_read_bounds_batches_in_flight() {
+        let src = PathBuf::from(env!("CARGO_MANIFEST_DIR"))
+            .join("tests/sas/data/data_AHS2013/owner.sas7bdat");
+        if !src.exists() {
+            return;
+        }
+        let path = std::env::temp_dir().join(format!(
+            "polars_readstat_in_flight_{}.sas7bdat",
+            std::process::id()
+        ));
+        std::fs::copy(&src, &path).expect("copy");
+        let reader = Sas7bdatReader::open(&path).expect("open");
+        let index = reader.build_page_index().expect("build");
+        let reader = reader.with_page_index(index);
+        let row_count = reader.metadata().row_count;
+        let (offset, n_rows, batch_size, threads) = (row_count / 10, row_count / 2, 256, 4);
+
+        *DECODED_BATCHES.lock().unwrap() = Some((path.clone(), 0));
+        let iter = sas_batch_iter_with_reader(
+            &reader,
+            path.clone(),
+            Some(threads),
+            true,
+            Some(batch_size),
+            None,
+            offset,
+            Some(n_rows),
+            true,
+            None,
+            None,
+            false,
+            None,
+            false,
+            None,
+        )
+        .expect("batch iter");
+        let decoded = || DECODED_BATCHES.lock().unwrap().as_ref().unwrap().1;
+        let (mut consumed, mut rows, mut peak) = (0usize, 0usize, 0usize);
+        for batch in iter {
+            rows += batch.expect("batch").height();
+            consumed += 1;
+            peak = peak.max(decoded().saturating_sub(consumed));
+        }
+        *DECODED_BATCHES.lock().unwrap() = None;
+        let _ = std::fs::remove_file(&path);
+
+        assert_eq!(rows, n_rows);
+        // Each task covers about one batch of pages, which can split into a few
+        // batches at page boundaries, and at most `limit` tasks are in flight; a
+        // couple more are dropped while slicing to the offset.
+        let per_task = 3;
+        let limit = crate::worker_pool::scan_limit(threads);
+        assert!(
+            peak <= (limit + 2) * per_task,
+            "{peak} batches in flight with a limit of {limit} tasks"
+        );
+    }
 }
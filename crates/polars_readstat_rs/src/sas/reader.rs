@@ -2,13 +2,15 @@ use crate::data::{DataReader, DataSubheader};
 use crate::error::Result;
 use crate::header::{check_header, read_header};
 use crate::metadata::read_metadata_from_path;
+use crate::mmap_source::{FileSource, SharedInput};
 use crate::page::PageReader;
+use crate::sas::page_index::SasPageIndex;
 use crate::types::{Compression, Endian, Format, Header, Metadata};
 use polars::prelude::*;
 use std::fs::File;
-use std::io::{BufReader, Seek, SeekFrom};
+use std::io::{Seek, SeekFrom};
 use std::path::{Path, PathBuf};
-use std::sync::Arc;
+use std::sync::{Arc, OnceLock};
 use std::time::Instant;
 
 /// Main reader for SAS7BDAT files
@@ -25,6 +27,10 @@ pub struct Sas7bdatReader {
     /// Number of data rows that live on MIX pages before the first DATA page.
     /// These are returned by the DataReader before any DATA-page rows.
     mix_data_rows: usize,
+    /// Optional page/row index; when set, reads at an offset seek straight to the
+    /// page holding the first requested row. Set once, possibly after the reader
+    /// is shared (see [`Sas7bdatReader::ensure_page_index`]).
+    page_index: OnceLock<SasPageIndex>,
 }
 
 #[derive(Debug, Clone)]
@@ -33,14 +39,7 @@ pub struct OpenProfile {
     pub metadata_ms: f64,
 }
 
-#[derive(Debug, Clone)]
-pub struct ReadProfile {
-    pub parse_rows_ms: f64,
-    pub parse_values_ms: f64,
-    pub add_row_ms: f64,
-    pub build_df_ms: f64,
-    pub total_ms: f64,
-}
+pub use crate::read_profile::ReadProfile;
 
 impl Sas7bdatReader {
     pub fn open(path: impl AsRef<Path>) -> Result<Self> {
@@ -62,7 +61,15 @@ impl Sas7bdatReader {
             initial_data_subheaders,
             first_data_page,
             mix_data_rows,
-        })
+            page_index: OnceLock::new(),
+        }
+        .with_sidecar_page_index())
+    }
+
+    /// Like [`open`](Self::open), but shares the parsed header and metadata with
+    /// earlier opens of the same unchanged file (see [`crate::clear_metadata_cache`]).
+    pub fn open_cached(path: impl AsRef<Path>) -> Result<Arc<Self>> {
+        crate::metadata_cache::cached(path.as_ref(), |p| Self::open(p))
     }
 
     pub fn open_with_profile(path: impl AsRef<Path>) -> Result<(Self, OpenProfile)> {
@@ -89,7 +96,9 @@ impl Sas7bdatReader {
                 initial_data_subheaders,
                 first_data_page,
                 mix_data_rows,
-            },
+                page_index: OnceLock::new(),
+            }
+            .with_sidecar_page_index(),
             OpenProfile {
                 header_ms,
                 metadata_ms,
@@ -123,6 +132,71 @@ impl Sas7bdatReader {
     pub fn mix_data_rows(&self) -> usize {
         self.mix_data_rows
     }
+    pub fn page_index(&self) -> Option<&SasPageIndex> {
+        self.page_index.get()
+    }
+
+    /// The attached page index, built now if there is none. The index stays with
+    /// this reader, so later reads through the same [`open_cached`](Self::open_cached)
+    /// reader seek by page too; nothing is written to disk.
+    pub fn ensure_page_index(&self) -> Result<&SasPageIndex> {
+        if let Some(index) = self.page_index.get() {
+            return Ok(index);
+        }
+        let index = self.build_page_index()?;
+        // Another thread may have won the race with an identical index.
+        let _ = self.page_index.set(index);
+        Ok(self.page_index.get().expect("page index was just set"))
+    }
+
+    /// Walk the file's pages and build a page/row index (no values are decoded).
+    pub fn build_page_index(&self) -> Result<SasPageIndex> {
+        SasPageIndex::build(
+            &self.path,
+            &self.header,
+            &self.metadata,
+            self.endian,
+            self.format,
+        )
+    }
+
+    /// Use `index` to seek directly to the requested rows in later reads. Ignored if
+    /// it was built from a different version of the file.
+    pub fn with_page_index(mut self, index: SasPageIndex) -> Self {
+        if index.matches(&self.path, &self.header, &self.metadata) {
+            self.page_index = OnceLock::from(index);
+        }
+        self
+    }
+
+    /// Attach the `<file>.pidx` sidecar (see [`SasPageIndex::sidecar_path`]) when one
+    /// exists and matches the file. Every open does this, so offset reads, samples
+    /// and parallel starts seek by page once a sidecar has been written; a missing,
+    /// unreadable or stale sidecar is ignored. `open_cached` reuses an earlier open,
+    /// so a sidecar written afterwards applies after [`crate::clear_metadata_cache`].
+    fn with_sidecar_page_index(self) -> Self {
+        match SasPageIndex::load(&SasPageIndex::sidecar_path(&self.path)) {
+            Ok(index) => self.with_page_index(index),
+            Err(_) => self,
+        }
+    }
+
+    /// Load the page index stored at `sidecar`, or build it and try to write it there
+    /// when the sidecar is missing or stale. Use `SasPageIndex::sidecar_path` for the
+    /// default location next to the data file, or any path in a cache directory.
+    pub fn with_page_index_file(self, sidecar: impl AsRef<Path>) -> Result<Self> {
+        let sidecar = sidecar.as_ref();
+        if let Ok(index) = SasPageIndex::load(sidecar) {
+            if index.matches(&self.path, &self.header, &self.metadata) {
+                return Ok(self.with_page_index(index));
+            }
+        }
+        let index = self.build_page_index()?;
+        // A read-only data directory should not stop the read; the index just
+        // isn't cached.
+        let _ = index.save(sidecar);
+        Ok(self.with_page_index(index))
+    }
 
     /// The single internal execution path for all read operations
     fn execute_read(&self, opts: ReadBuilder) -> Result<DataFrame> {
@@ -150,19 +224,19 @@ impl Sas7bdatReader {
             None,
             opts.informative_nulls.clone(),
             false,
+            None,
+            opts.use_mmap,
+            opts.read_ahead,
         )
         .map_err(|e| crate::error::Error::ParseError(e.to_string()))?;
 
-        let mut df: Option<DataFrame> = None;
+        let expected_rows = limit.min(self.metadata.row_count.saturating_sub(opts.offset));
+        let mut out = crate::frame_assembly::FrameAssembler::new(expected_rows);
         while let Some(batch) = iter.next() {
             let batch = batch.map_err(|e| crate::error::Error::ParseError(e.to_string()))?;
-            if let Some(acc) = df.as_mut() {
-                acc.vstack_mut(&batch)?;
-            } else {
-                df = Some(batch);
-            }
+            out.push(batch)?;
         }
-        let mut df = df.unwrap_or_else(DataFrame::empty);
+        let mut df = out.finish()?;
 
         if let Some(schema) = opts.schema {
             df = cast_dataframe(df, &schema)?;
@@ -171,21 +245,14 @@ impl Sas7bdatReader {
         Ok(df)
     }
 
-    /// Profiled read path (streaming execution)
+    /// Read under a fresh [`ReadProfiler`](crate::ReadProfiler) and return its report.
     fn execute_read_profiled(&self, opts: ReadBuilder) -> Result<(DataFrame, ReadProfile)> {
-        let total_start = Instant::now();
-        let df = self.execute_read(opts)?;
-        let total_ms = total_start.elapsed().as_secs_f64() * 1000.0;
-        Ok((
-            df,
-            ReadProfile {
-                parse_rows_ms: 0.0,
-                parse_values_ms: 0.0,
-                add_row_ms: 0.0,
-                build_df_ms: total_ms,
-                total_ms,
-            },
-        ))
+        let profiler = crate::ReadProfiler::new();
+        let df = {
+            let _profile = profiler.enter();
+            self.execute_read(opts)?
+        };
+        Ok((df, profiler.report()))
     }
 }
 
@@ -201,6 +268,8 @@ pub struct ReadBuilder<'a> {
     chunk_size: Option<usize>,
     missing_string_as_null: bool,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 }
 
 impl<'a> ReadBuilder<'a> {
@@ -216,6 +285,8 @@ impl<'a> ReadBuilder<'a> {
             chunk_size: None,
             missing_string_as_null: true,
             informative_nulls: None,
+            use_mmap: false,
+            read_ahead: None,
         }
     }
 
@@ -227,6 +298,8 @@ impl<'a> ReadBuilder<'a> {
         self.limit = Some(limit);
         self
     }
+    /// Start at row `offset`. With a page index attached to the reader this seeks
+    /// straight to the page holding that row; otherwise the pages before it are walked.
     pub fn with_offset(mut self, offset: usize) -> Self {
         self.offset = offset;
         self
@@ -255,6 +328,18 @@ impl<'a> ReadBuilder<'a> {
         self.informative_nulls = v;
         self
     }
+    /// Read through a memory map of the file instead of buffered reads.
+    pub fn use_mmap(mut self, v: bool) -> Self {
+        self.use_mmap = v;
+        self
+    }
+
+    /// Read through positioned range reads with a read-ahead window of about
+    /// `window` bytes (for network storage).
+    pub fn read_ahead(mut self, window: usize) -> Self {
+        self.read_ahead = Some(window);
+        self
+    }
 
     pub fn finish(self) -> Result<DataFrame> {
         self.reader.execute_read(self)
@@ -278,11 +363,13 @@ pub(crate) fn data_reader_at_page_range(
     page_number: usize,
     page_count: usize,
     row_start: usize,
-) -> Result<DataReader<BufReader<File>>> {
+    map: Option<&SharedInput>,
+) -> Result<DataReader<FileSource>> {
     let byte_offset = header.header_length as u64 + page_number as u64 * header.page_length as u64;
-    let mut file = BufReader::new(File::open(path)?);
+    let mut file = FileSource::open(path, 8 * 1024, map)?;
     file.seek(SeekFrom::Start(byte_offset))?;
-    let page_reader = PageReader::new(file, header.clone(), endian, format);
+    let page_reader = PageReader::new(file, header.clone(), endian, format)
+        .with_mapping(map.and_then(SharedInput::mapped).cloned(), byte_offset);
     let mut data_reader =
         DataReader::new(page_reader, metadata.clone(), endian, format, Vec::new())?;
     // DataReader::new() already consumed one page; set the budget for remaining pages.
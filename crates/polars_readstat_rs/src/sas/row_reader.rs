@@ -55,7 +55,7 @@ pub struct SasColumnInfo {
 /// Multiple `SasRowReader`s returned by [`sas_row_readers`] cover disjoint
 /// segments of the file and can be drained in any order.  For compressed files
 /// a single reader is returned that chains all worker threads internally
-/// (matching the `OrderedParallelIter + SlicedBatchIter` approach used by the
+/// (matching the ordered `page_tasks` + `SlicedBatchIter` approach used by the
 /// polars output path).
 pub struct SasRowReader {
     /// One receiver per background worker, drained left-to-right.
@@ -428,6 +428,7 @@ fn spawn_parallel_raw_worker(
             worker_page_start,
             worker_page_count,
             0,
+            None,
         ) {
             Ok(r) => r,
             Err(e) => {
@@ -465,7 +466,7 @@ fn spawn_parallel_raw_worker(
 /// For compressed files or when a single thread is requested, returns a single
 /// reader that chains all worker threads internally in file order with a
 /// `metadata.row_count` cap to trim phantom rows from the last page — identical
-/// to the `OrderedParallelIter + SlicedBatchIter` approach used by the polars
+/// to the ordered `page_tasks` + `SlicedBatchIter` approach used by the polars
 /// output path.
 ///
 /// Files with mix-page rows always use a single serial reader.
@@ -537,7 +538,7 @@ pub fn sas_row_readers(path: &Path, opts: &crate::ScanOptions) -> Result<Vec<Sas
     if is_compressed {
         // Compressed files must be drained in order so the row_count cap always
         // trims the same trailing phantom rows.  Chain all workers into one reader
-        // (mirrors OrderedParallelIter + SlicedBatchIter).
+        // (mirrors ordered page_tasks + SlicedBatchIter).
         let mut rxs = VecDeque::with_capacity(n_workers);
         let mut handles = Vec::with_capacity(n_workers);
         for worker_idx in 0..n_workers {
@@ -88,14 +88,6 @@ pub struct Column {
     pub length: usize,
 }
 
-/// Page index entry for fast seeking
-#[derive(Debug, Clone)]
-pub struct PageIndex {
-    pub page_number: usize,
-    pub row_start: usize,
-    pub row_count: usize,
-}
-
 /// File metadata extracted from metadata pages
 #[derive(Debug, Clone)]
 pub struct Metadata {
@@ -109,5 +101,4 @@ pub struct Metadata {
     pub creator: String,
     pub creator_proc: String,
     pub encoding_byte: u8,
-    pub page_index: Vec<PageIndex>,
 }
@@ -114,6 +114,44 @@ impl SasWriter {
 
     /// Write the CSV and SAS script, returning their paths.
     pub fn write_df(&self, df: &DataFrame) -> Result<(PathBuf, PathBuf)> {
+        self.write_batches_streaming(std::iter::once(df.clone()))
+    }
+
+    /// Write batches as they arrive, returning the CSV and script paths.
+    ///
+    /// Only one batch is held at a time: each is converted and appended to the CSV
+    /// (Polars serializes its rows in parallel), and string widths are tracked as
+    /// the batches go by. The script is written last, once the `LENGTH`s are known.
+    /// Every batch must have the columns of the first, in the same order. With no
+    /// batches there are no columns to describe, which is an error; use
+    /// [`write_batches_streaming_with_schema`](Self::write_batches_streaming_with_schema)
+    /// when the input may be empty.
+    pub fn write_batches_streaming<I>(&self, batches: I) -> Result<(PathBuf, PathBuf)>
+    where
+        I: IntoIterator<Item = DataFrame>,
+    {
+        self.write_batches(batches.into_iter(), None)
+    }
+
+    /// [`write_batches_streaming`](Self::write_batches_streaming) for batches with
+    /// `schema`. When there are no batches, the CSV holds only the header and the
+    /// script imports an empty dataset with `schema`'s columns.
+    pub fn write_batches_streaming_with_schema<I>(
+        &self,
+        batches: I,
+        schema: &Schema,
+    ) -> Result<(PathBuf, PathBuf)>
+    where
+        I: IntoIterator<Item = DataFrame>,
+    {
+        self.write_batches(batches.into_iter(), Some(schema))
+    }
+
+    fn write_batches(
+        &self,
+        mut batches: impl Iterator<Item = DataFrame>,
+        schema: Option<&Schema>,
+    ) -> Result<(PathBuf, PathBuf)> {
         // Resolve dataset name: explicit > derived from path stem
         let raw_name = self
             .dataset_name
@@ -124,7 +162,18 @@ impl SasWriter {
 
         let (csv_path, sas_path) = resolve_paths(&self.base_path, &dataset)?;
 
-        let (df_renamed, name_map) = sas_rename_df(df)?;
+        let first = match (batches.next(), schema) {
+            (Some(df), _) => df,
+            (None, Some(schema)) => DataFrame::empty_with_schema(schema),
+            (None, None) => {
+                return Err(Error::ParseError(
+                    "no batches to write and no schema to write them with".to_string(),
+                ))
+            }
+        };
+        let (first, name_map) = sas_rename_df(&first)?;
+        let schema = first.schema().clone();
+        let names: Vec<PlSmallStr> = schema.iter_names().cloned().collect();
         let value_labels = self
             .value_labels
             .as_ref()
@@ -134,19 +183,39 @@ impl SasWriter {
             .as_ref()
             .map(|v| rename_variable_labels(v, &name_map));
 
-        let mut df_out = prepare_df_for_csv(&df_renamed)?;
-
+        let mut string_widths: HashMap<String, usize> = HashMap::new();
+        track_string_widths(&first, &mut string_widths)?;
+        let first_out = prepare_df_for_csv(&first)?;
         let mut file = BufWriter::new(File::create(&csv_path)?);
-        CsvWriter::new(&mut file)
+        let mut csv = CsvWriter::new(&mut file)
             .include_header(true)
-            .finish(&mut df_out)
+            .batched(first_out.schema())
             .map_err(|e| Error::ParseError(e.to_string()))?;
+        csv.write_batch(&first_out)
+            .map_err(|e| Error::ParseError(e.to_string()))?;
+        drop((first, first_out));
+        for mut df in batches {
+            if df.width() != names.len() {
+                return Err(Error::ParseError(
+                    "batch columns differ from the first batch".to_string(),
+                ));
+            }
+            df.set_column_names(names.iter().cloned())
+                .map_err(|e| Error::ParseError(e.to_string()))?;
+            track_string_widths(&df, &mut string_widths)?;
+            csv.write_batch(&prepare_df_for_csv(&df)?)
+                .map_err(|e| Error::ParseError(e.to_string()))?;
+        }
+        csv.finish().map_err(|e| Error::ParseError(e.to_string()))?;
+        drop(csv);
+        file.flush()?;
 
         let output_dir = csv_path.parent();
         let script = build_sas_script(
             &dataset,
             &csv_path,
-            &df_renamed,
+            &schema,
+            &string_widths,
             value_labels.as_ref(),
             variable_labels.as_ref(),
             self.library.as_deref(),
@@ -327,7 +396,8 @@ fn sas_numeric_length(dtype: &DataType) -> Option<u8> {
 fn build_sas_script(
     dataset: &str,
     csv_path: &Path,
-    df: &DataFrame,
+    schema: &Schema,
+    string_widths: &HashMap<String, usize>,
     value_labels: Option<&SasValueLabels>,
     variable_labels: Option<&SasVariableLabels>,
     library: Option<&str>,
@@ -351,7 +421,7 @@ fn build_sas_script(
             if mapping.is_empty() {
                 continue;
             }
-            let (fmt_name, is_char) = format_name_for_column(col, df)?;
+            let (fmt_name, is_char) = format_name_for_column(col, schema)?;
             script.push_str(&format!(
                 "  value {}{}\n",
                 if is_char { "$" } else { "" },
@@ -380,19 +450,17 @@ fn build_sas_script(
     ));
 
     // Length for string columns
-    for col in df.columns() {
-        let series = col.as_materialized_series();
-        if matches!(series.dtype(), DataType::String) {
-            let width = max_string_width(series)?;
-            script.push_str(&format!("  length {} ${};\n", series.name(), width));
+    for (name, dtype) in schema.iter() {
+        if matches!(dtype, DataType::String) {
+            let width = string_width(string_widths, name);
+            script.push_str(&format!("  length {} ${};\n", name, width));
         }
     }
 
     // Length for typed numeric columns (preserves storage precision in SAS)
-    for col in df.columns() {
-        let series = col.as_materialized_series();
-        if let Some(len) = sas_numeric_length(series.dtype()) {
-            script.push_str(&format!("  length {} {};\n", series.name(), len));
+    for (name, dtype) in schema.iter() {
+        if let Some(len) = sas_numeric_length(dtype) {
+            script.push_str(&format!("  length {} {};\n", name, len));
         }
     }
 
@@ -402,7 +470,7 @@ fn build_sas_script(
             if mapping.is_empty() {
                 continue;
             }
-            let (fmt_name, is_char) = format_name_for_column(col, df)?;
+            let (fmt_name, is_char) = format_name_for_column(col, schema)?;
             format_lines.push(format!(
                 "{} {}{}.",
                 col,
@@ -411,16 +479,15 @@ fn build_sas_script(
             ));
         }
     }
-    for col in df.columns() {
-        let series = col.as_materialized_series();
-        let fmt = match series.dtype() {
+    for (name, dtype) in schema.iter() {
+        let fmt = match dtype {
             DataType::Date => Some("yymmdd10.".to_string()),
             DataType::Datetime(_, _) => Some("datetime19.".to_string()),
             DataType::Time => Some("time8.".to_string()),
             _ => None,
         };
         if let Some(fmt) = fmt {
-            format_lines.push(format!("{} {}", series.name(), fmt));
+            format_lines.push(format!("{} {}", name, fmt));
         }
     }
     if !format_lines.is_empty() {
@@ -442,16 +509,12 @@ fn build_sas_script(
     }
 
     script.push_str("  input\n");
-    for col in df.columns() {
-        let series = col.as_materialized_series();
-        let informat = match series.dtype() {
-            DataType::String => {
-                let width = max_string_width(series)?;
-                format!("${}.", width)
-            }
+    for (name, dtype) in schema.iter() {
+        let informat = match dtype {
+            DataType::String => format!("${}.", string_width(string_widths, name)),
             _ => "best32.".to_string(),
         };
-        script.push_str(&format!("    {} : {}\n", series.name(), informat));
+        script.push_str(&format!("    {} : {}\n", name, informat));
     }
     script.push_str("  ;\nrun;\n");
 
@@ -465,12 +528,11 @@ fn build_sas_script(
     Ok(script)
 }
 
-fn format_name_for_column(col: &str, df: &DataFrame) -> Result<(String, bool)> {
-    let series = df
-        .column(col)
-        .map_err(|e| Error::ParseError(e.to_string()))?
-        .as_materialized_series();
-    let is_char = matches!(series.dtype(), DataType::String);
+fn format_name_for_column(col: &str, schema: &Schema) -> Result<(String, bool)> {
+    let dtype = schema
+        .get(col)
+        .ok_or_else(|| Error::ParseError(format!("\"{col}\" not found in the written columns")))?;
+    let is_char = matches!(dtype, DataType::String);
     let mut name = format!("fmt_{}", sanitize_sas_name(col));
     if name.len() > 32 {
         name.truncate(32);
@@ -482,6 +544,23 @@ fn sas_quote(s: &str) -> String {
     s.replace('"', "\"\"")
 }
 
+/// Fold the string widths of one batch into `widths`.
+fn track_string_widths(df: &DataFrame, widths: &mut HashMap<String, usize>) -> Result<()> {
+    for col in df.columns() {
+        let series = col.as_materialized_series();
+        if matches!(series.dtype(), DataType::String) {
+            let width = max_string_width(series)?;
+            let entry = widths.entry(series.name().to_string()).or_insert(1);
+            *entry = (*entry).max(width);
+        }
+    }
+    Ok(())
+}
+
+fn string_width(widths: &HashMap<String, usize>, name: &str) -> usize {
+    widths.get(name).copied().unwrap_or(1)
+}
+
 fn max_string_width(series: &Series) -> Result<usize> {
     let utf8 = series.str().map_err(|e| Error::ParseError(e.to_string()))?;
     let mut max_len = 1usize;
@@ -1,19 +1,17 @@
+use crate::mmap_source::FileSource;
 use crate::sas::constants::{DATE_FORMATS, DATETIME_FORMATS, TIME_FORMATS};
 use polars::prelude::*;
-use rayon::prelude::*;
-use rayon::ThreadPoolBuilder;
-use std::collections::BTreeMap;
 use std::fs::File;
 use std::io::{BufReader, Read, Seek, SeekFrom};
 use std::path::{Path, PathBuf};
-use std::sync::mpsc::{self, Receiver};
 use std::sync::Arc;
-use std::thread::JoinHandle;
 
 const LINE_LEN: usize = 80;
 const NAMESTR_SIZE: usize = 140;
 
 const XPT_COL_TYPE_CHR: u16 = 2;
+/// Bytes of row data one parallel read task covers.
+const TASK_BYTES: usize = 8 * 1024 * 1024;
 
 // ────────────────────────────────────────────────────────────────
 // Public types
@@ -43,8 +41,8 @@ pub struct XptMetadata {
     pub metadata_df: polars::prelude::DataFrame,
     pub row_length: usize,
     pub data_offset: u64,
-    /// Upper-bound row count derived from (file_size - data_offset) / row_length.
-    /// May be off by ≤1 due to trailing space-padding; workers discard blank rows naturally.
+    /// Rows in the data section: (file_size - data_offset) / row_length, less the
+    /// trailing blank rows that fit in the final record's space padding.
     pub row_count: usize,
 }
 
@@ -271,6 +269,11 @@ fn align_to_record(reader: &mut (impl Read + Seek)) -> PolarsResult<()> {
 // Metadata parsing (public)
 // ────────────────────────────────────────────────────────────────
 
+/// [`read_xpt_metadata`] shared through the process-wide metadata cache.
+pub fn read_xpt_metadata_cached(path: &Path) -> PolarsResult<Arc<XptMetadata>> {
+    crate::metadata_cache::cached(path, read_xpt_metadata)
+}
+
 pub fn read_xpt_metadata(path: &Path) -> PolarsResult<XptMetadata> {
     let file = File::open(path)
         .map_err(|e| PolarsError::ComputeError(format!("XPT open: {e}").into()))?;
@@ -349,12 +352,33 @@ pub fn read_xpt_metadata(path: &Path) -> PolarsResult<XptMetadata> {
         .len();
 
     let row_length: usize = columns.iter().map(|c| c.storage_width).sum();
-    let row_count = if row_length == 0 {
+    let mut row_count = if row_length == 0 {
         0
     } else {
         ((file_size.saturating_sub(data_offset)) as usize) / row_length
     };
 
+    // The data ends space-padded to a whole record. Blank rows that fit in that
+    // padding are not data.
+    let tail_start = data_offset.max(file_size.saturating_sub(LINE_LEN as u64));
+    if row_count > 0 && tail_start < file_size {
+        let mut tail = Vec::with_capacity(LINE_LEN);
+        r.seek(SeekFrom::Start(tail_start))
+            .and_then(|_| r.read_to_end(&mut tail))
+            .map_err(|e| PolarsError::ComputeError(format!("XPT read: {e}").into()))?;
+        while row_count > 0 {
+            let start = data_offset + ((row_count - 1) * row_length) as u64;
+            if start < tail_start {
+                break;
+            }
+            let at = (start - tail_start) as usize;
+            if !tail[at..at + row_length].iter().all(|&b| b == b' ') {
+                break;
+            }
+            row_count -= 1;
+        }
+    }
+
     let mut acc = crate::metadata_df::MetadataAccumulator::with_capacity(columns.len());
     for (i, col) in columns.iter().enumerate() {
         let label = if col.label.is_empty() { None } else { Some(col.label.clone()) };
@@ -396,79 +420,73 @@ pub fn read_xpt_metadata(path: &Path) -> PolarsResult<XptMetadata> {
 //   '.' (system missing) or 'A'–'Z' / '_' (tagged missing).
 // ────────────────────────────────────────────────────────────────
 
-fn is_xpt_missing(bytes: &[u8]) -> bool {
-    if bytes.is_empty() {
-        return false;
-    }
-    if !bytes[1..].iter().all(|&b| b == 0) {
-        return false;
-    }
-    let b = bytes[0];
-    b == b'.' || (b >= b'A' && b <= b'Z') || b == b'_'
-}
-
-fn xpt_to_f64(xport: &[u8; 8]) -> Option<f64> {
-    if is_xpt_missing(xport) {
-        return None;
-    }
-
-    let sign = (xport[0] >> 7) as u64;
-    let ibm_exp = (xport[0] & 0x7F) as i32;
-
-    // 56-bit mantissa from bytes 1–7 (big-endian)
-    let mantissa: u64 = ((xport[1] as u64) << 48)
-        | ((xport[2] as u64) << 40)
-        | ((xport[3] as u64) << 32)
-        | ((xport[4] as u64) << 24)
-        | ((xport[5] as u64) << 16)
-        | ((xport[6] as u64) << 8)
-        | (xport[7] as u64);
+const IBM_MANTISSA_MASK: u64 = 0x00FF_FFFF_FFFF_FFFF;
+const IEEE_FRACTION_MASK: u64 = 0x000F_FFFF_FFFF_FFFF;
 
-    if mantissa == 0 {
-        return Some(if sign != 0 { -0.0_f64 } else { 0.0_f64 });
-    }
-
-    // Position of leading 1 bit (0 = LSB), within a 64-bit word where
-    // the mantissa occupies bits 55-0.
-    let leading_zeros = mantissa.leading_zeros() as i32;
-    let k = 63 - leading_zeros; // 0-indexed bit position from LSB
-
-    // value = mantissa × 2^(4×ibm_exp − 312)
-    // = 2^k × (1 + frac/2^k) × 2^(4×ibm_exp − 312)
-    // → ieee_exp = k + 4×ibm_exp − 312 + 1023 = k + 4×ibm_exp + 711
-    let ieee_exp = k + 4 * ibm_exp + 711;
+/// Missing-value test on a field read as a big-endian, zero-padded u64.
+#[inline]
+fn ibm_is_missing(bits: u64) -> bool {
+    let b = (bits >> 56) as u8;
+    bits & IBM_MANTISSA_MASK == 0 && (b == b'.' || b.is_ascii_uppercase() || b == b'_')
+}
 
-    if ieee_exp <= 0 {
-        return Some(if sign != 0 { -0.0_f64 } else { 0.0_f64 });
-    }
-    if ieee_exp >= 2047 {
-        return Some(if sign != 0 {
-            f64::NEG_INFINITY
-        } else {
-            f64::INFINITY
-        });
-    }
+/// IBM hex float to IEEE double, for a non-missing value.
+///
+/// Every non-zero IBM double (16^-65 up to 16^63) is a normal IEEE double, so
+/// the only special case is zero and the conversion has no data-dependent
+/// branches; the column loop in [`decode_ibm_column`] stays tight.
+#[inline]
+fn ibm_to_ieee(bits: u64) -> f64 {
+    let sign = bits & (1 << 63);
+    let mantissa = bits & IBM_MANTISSA_MASK;
+    let ibm_exp = ((bits >> 56) & 0x7F) as i64;
+    // `| 1` keeps the shift in range for a zero mantissa, whose result is
+    // replaced below anyway.
+    let lz = (mantissa | 1).leading_zeros();
+    // value = mantissa × 2^(4×ibm_exp − 312) with the leading 1 at bit 63 − lz:
+    // ieee_exp = (63 − lz) + 4×ibm_exp − 312 + 1023
+    let ieee_exp = 4 * ibm_exp + 774 - lz as i64;
+    // Shift the leading 1 up to bit 63, then down to the implicit bit 52.
+    let fraction = ((mantissa << lz) >> 11) & IEEE_FRACTION_MASK;
+    let normal = sign | ((ieee_exp as u64) << 52) | fraction;
+    f64::from_bits(if mantissa == 0 { sign } else { normal })
+}
 
-    // Extract 52-bit IEEE fraction from the bits below the leading 1.
-    let frac_bits = mantissa ^ (1u64 << k); // clear leading 1
-    let fraction: u64 = if k >= 52 {
-        frac_bits >> (k - 52)
+/// Decode the numeric field at `offset` (`width` bytes, zero-padded on the
+/// right to 8) of each of the `n_rows` rows in `rows`. Returns the values and,
+/// when any are missing, a per-row missing mask; missing slots hold 0.0.
+fn decode_ibm_column(
+    rows: &[u8],
+    n_rows: usize,
+    row_length: usize,
+    offset: usize,
+    width: usize,
+) -> (Vec<f64>, Option<Vec<bool>>) {
+    let width = width.min(8);
+    // Gather the strided fields first so the conversion runs over a flat slice.
+    let bits: Vec<u64> = if width == 8 {
+        (0..n_rows)
+            .map(|r| {
+                let at = r * row_length + offset;
+                u64::from_be_bytes(rows[at..at + 8].try_into().unwrap())
+            })
+            .collect()
     } else {
-        frac_bits << (52 - k)
+        (0..n_rows)
+            .map(|r| {
+                let at = r * row_length + offset;
+                let mut padded = [0u8; 8];
+                padded[..width].copy_from_slice(&rows[at..at + width]);
+                u64::from_be_bytes(padded)
+            })
+            .collect()
     };
-    let fraction = fraction & 0x000F_FFFF_FFFF_FFFF;
-
-    let bits: u64 = (sign << 63) | ((ieee_exp as u64) << 52) | fraction;
-    Some(f64::from_bits(bits))
-}
-
-// Decode a numeric XPORT field of `width` bytes into an f64.
-// The field is zero-padded on the right to 8 bytes before conversion.
-fn decode_xpt_numeric(field: &[u8]) -> Option<f64> {
-    let mut padded = [0u8; 8];
-    let n = field.len().min(8);
-    padded[..n].copy_from_slice(&field[..n]);
-    xpt_to_f64(&padded)
+    let values: Vec<f64> = bits.iter().map(|&b| ibm_to_ieee(b)).collect();
+    let missing = bits
+        .iter()
+        .any(|&b| ibm_is_missing(b))
+        .then(|| bits.iter().map(|&b| ibm_is_missing(b)).collect());
+    (values, missing)
 }
 
 // ────────────────────────────────────────────────────────────────
@@ -514,61 +532,9 @@ fn col_dtype(kind: ColKind) -> DataType {
 }
 
 // ────────────────────────────────────────────────────────────────
-// DataFrame builder for one batch of XPT rows
+// Columnar decode of a block of XPT rows
 // ────────────────────────────────────────────────────────────────
 
-enum ColBuf {
-    Numeric(PrimitiveChunkedBuilder<Float64Type>),
-    Date(PrimitiveChunkedBuilder<Int32Type>),
-    DateTime(PrimitiveChunkedBuilder<Int64Type>),
-    Time(PrimitiveChunkedBuilder<Int64Type>),
-    Character(StringChunkedBuilder),
-}
-
-impl ColBuf {
-    fn new(name: &str, kind: ColKind, cap: usize) -> Self {
-        match kind {
-            ColKind::Numeric => {
-                ColBuf::Numeric(PrimitiveChunkedBuilder::<Float64Type>::new(name.into(), cap))
-            }
-            ColKind::Date => {
-                ColBuf::Date(PrimitiveChunkedBuilder::<Int32Type>::new(name.into(), cap))
-            }
-            ColKind::DateTime => {
-                ColBuf::DateTime(PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), cap))
-            }
-            ColKind::Time => {
-                ColBuf::Time(PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), cap))
-            }
-            ColKind::Character => ColBuf::Character(StringChunkedBuilder::new(name.into(), cap)),
-        }
-    }
-
-    fn finish(self) -> PolarsResult<Series> {
-        match self {
-            ColBuf::Numeric(b) => Ok(b.finish().into_series()),
-            ColBuf::Date(b) => b.finish().into_series().cast(&DataType::Date),
-            ColBuf::DateTime(b) => b
-                .finish()
-                .into_series()
-                .cast(&DataType::Datetime(TimeUnit::Microseconds, None)),
-            ColBuf::Time(b) => b.finish().into_series().cast(&DataType::Time),
-            ColBuf::Character(b) => Ok(b.finish().into_series()),
-        }
-    }
-
-    #[allow(dead_code)]
-    fn push_null(&mut self) {
-        match self {
-            ColBuf::Numeric(b) => b.append_null(),
-            ColBuf::Date(b) => b.append_null(),
-            ColBuf::DateTime(b) => b.append_null(),
-            ColBuf::Time(b) => b.append_null(),
-            ColBuf::Character(b) => b.append_null(),
-        }
-    }
-}
-
 // SAS epoch: Jan 1, 1960 = days before Unix epoch (Jan 1, 1970) = 3653 days
 const SAS_EPOCH_DAYS: i32 = 3653;
 const SECS_PER_DAY: f64 = 86400.0;
@@ -586,230 +552,186 @@ fn sas_time_to_polars_ns(v: f64) -> i64 {
     (v * 1_000_000_000.0) as i64
 }
 
-struct XptBatchBuilder {
-    columns: Vec<(XptColumn, ColKind)>,
-    buffers: Vec<ColBuf>,
-    missing_string_as_null: bool,
+/// A column to decode and where its field starts within a row.
+#[derive(Clone, Debug)]
+struct PlannedColumn {
+    col: XptColumn,
+    kind: ColKind,
+    offset: usize,
 }
 
-impl XptBatchBuilder {
-    fn new(
-        cols: &[(XptColumn, ColKind)],
-        cap: usize,
-        missing_string_as_null: bool,
-    ) -> Self {
-        let columns: Vec<(XptColumn, ColKind)> = cols.to_vec();
-        let buffers = columns
-            .iter()
-            .map(|(col, kind)| ColBuf::new(&col.name, *kind, cap))
-            .collect();
-        Self {
-            columns,
-            buffers,
-            missing_string_as_null,
-        }
+fn numeric_chunked<T: PolarsNumericType>(
+    name: &str,
+    values: &[f64],
+    missing: Option<&[bool]>,
+    convert: impl Fn(f64) -> T::Native,
+) -> ChunkedArray<T> {
+    match missing {
+        None => ChunkedArray::from_vec(name.into(), values.iter().map(|&v| convert(v)).collect()),
+        Some(missing) => ChunkedArray::from_iter_options(
+            name.into(),
+            values
+                .iter()
+                .zip(missing)
+                .map(|(&v, &m)| (!m).then(|| convert(v))),
+        ),
     }
+}
 
-    fn push_row(&mut self, row: &[u8]) {
-        let mut offset = 0usize;
-        for (i, (col, kind)) in self.columns.iter().enumerate() {
-            let w = col.storage_width;
-            let field = if offset + w <= row.len() {
-                &row[offset..offset + w]
-            } else {
-                &[][..]
-            };
-            offset += w;
-
-            let buf = &mut self.buffers[i];
-            match kind {
-                ColKind::Character => {
-                    if let ColBuf::Character(b) = buf {
-                        let trimmed = trim_bytes(field);
-                        if trimmed.is_empty() {
-                            if self.missing_string_as_null {
-                                b.append_null();
-                            } else {
-                                b.append_value("");
-                            }
-                        } else {
-                            b.append_value(String::from_utf8_lossy(trimmed).as_ref());
-                        }
-                    }
-                }
-                ColKind::Numeric | ColKind::Date | ColKind::DateTime | ColKind::Time => {
-                    let opt = decode_xpt_numeric(field);
-                    match kind {
-                        ColKind::Numeric => {
-                            if let ColBuf::Numeric(b) = buf {
-                                b.append_option(opt);
-                            }
-                        }
-                        ColKind::Date => {
-                            if let ColBuf::Date(b) = buf {
-                                b.append_option(opt.map(sas_date_to_polars));
-                            }
-                        }
-                        ColKind::DateTime => {
-                            if let ColBuf::DateTime(b) = buf {
-                                b.append_option(opt.map(sas_datetime_to_polars_us));
-                            }
-                        }
-                        ColKind::Time => {
-                            if let ColBuf::Time(b) = buf {
-                                b.append_option(opt.map(sas_time_to_polars_ns));
-                            }
-                        }
-                        _ => {}
-                    }
+fn decode_column(
+    rows: &[u8],
+    n_rows: usize,
+    row_length: usize,
+    plan: &PlannedColumn,
+    missing_string_as_null: bool,
+) -> PolarsResult<Series> {
+    let name = plan.col.name.as_str();
+    let width = plan.col.storage_width;
+    if let ColKind::Character = plan.kind {
+        let mut b = StringChunkedBuilder::new(name.into(), n_rows);
+        for r in 0..n_rows {
+            let at = r * row_length + plan.offset;
+            let trimmed = trim_bytes(&rows[at..at + width]);
+            if trimmed.is_empty() {
+                if missing_string_as_null {
+                    b.append_null();
+                } else {
+                    b.append_value("");
                 }
+            } else {
+                b.append_value(String::from_utf8_lossy(trimmed).as_ref());
             }
         }
+        return Ok(b.finish().into_series());
+    }
+
+    let (values, missing) = decode_ibm_column(rows, n_rows, row_length, plan.offset, width);
+    let missing = missing.as_deref();
+    match plan.kind {
+        ColKind::Numeric => {
+            Ok(numeric_chunked::<Float64Type>(name, &values, missing, |v| v).into_series())
+        }
+        ColKind::Date => numeric_chunked::<Int32Type>(name, &values, missing, sas_date_to_polars)
+            .into_series()
+            .cast(&DataType::Date),
+        ColKind::DateTime => {
+            numeric_chunked::<Int64Type>(name, &values, missing, sas_datetime_to_polars_us)
+                .into_series()
+                .cast(&DataType::Datetime(TimeUnit::Microseconds, None))
+        }
+        ColKind::Time => {
+            numeric_chunked::<Int64Type>(name, &values, missing, sas_time_to_polars_ns)
+                .into_series()
+                .cast(&DataType::Time)
+        }
+        ColKind::Character => unreachable!("handled above"),
     }
+}
 
-    fn build(self) -> PolarsResult<DataFrame> {
-        let series: Vec<Series> = self
-            .buffers
-            .into_iter()
-            .map(|buf| buf.finish())
-            .collect::<PolarsResult<_>>()?;
-        let cols: Vec<Column> = series.into_iter().map(Into::into).collect();
-        DataFrame::new_infer_height(cols)
+/// Decode `n_rows` consecutive rows held in `rows`.
+fn decode_rows(
+    rows: &[u8],
+    n_rows: usize,
+    row_length: usize,
+    col_plan: &[PlannedColumn],
+    missing_string_as_null: bool,
+) -> PolarsResult<DataFrame> {
+    let columns = col_plan
+        .iter()
+        .map(|plan| {
+            decode_column(rows, n_rows, row_length, plan, missing_string_as_null).map(Column::from)
+        })
+        .collect::<PolarsResult<Vec<_>>>()?;
+    if columns.is_empty() {
+        return Ok(DataFrame::empty_with_height(n_rows));
     }
+    DataFrame::new_infer_height(columns)
 }
 
 // ────────────────────────────────────────────────────────────────
 // Batch iterator
 // ────────────────────────────────────────────────────────────────
 
+/// Reads rows `[start, start + n_rows)` in batches. Rows are fixed width, so
+/// any row range is found by offset and read as one block.
 struct XptBatchIter {
-    reader: BufReader<File>,
-    col_plan: Vec<(XptColumn, ColKind)>,
+    reader: FileSource,
+    col_plan: Arc<Vec<PlannedColumn>>,
     row_length: usize,
     batch_size: usize,
     missing_string_as_null: bool,
     row_index_name: Option<String>,
     row_cursor: usize,
-    #[allow(dead_code)]
-    total: usize,
     remaining: usize,
-    // blank row buffering (XPT padding uses space-filled rows)
-    pending_blanks: usize,
-    blank_row: Vec<u8>,
-    done: bool,
+    buf: Vec<u8>,
 }
 
 impl XptBatchIter {
     fn new(
         path: &Path,
         meta: &XptMetadata,
-        col_plan: Vec<(XptColumn, ColKind)>,
+        col_plan: Arc<Vec<PlannedColumn>>,
         batch_size: usize,
-        skip: usize,
-        n_rows: Option<usize>,
+        start: usize,
+        n_rows: usize,
         missing_string_as_null: bool,
         row_index_name: Option<String>,
     ) -> PolarsResult<Self> {
-        let file = File::open(path)
+        let mut reader = FileSource::open(path, 8 * 1024, None)
             .map_err(|e| PolarsError::ComputeError(format!("XPT open: {e}").into()))?;
-        let mut reader = BufReader::new(file);
+        let offset = meta.data_offset + (start * meta.row_length) as u64;
         reader
-            .seek(SeekFrom::Start(meta.data_offset))
+            .seek(SeekFrom::Start(offset))
             .map_err(|e| PolarsError::ComputeError(format!("XPT seek: {e}").into()))?;
 
-        let row_length = meta.row_length;
-        let blank_row = vec![b' '; row_length];
-
-        // Skip rows if needed (read and discard, respecting blank-row logic)
-        let mut pending_blanks = 0usize;
-        let mut skipped = 0usize;
-        let mut row_buf = vec![0u8; row_length];
-        while skipped < skip {
-            match reader.read_exact(&mut row_buf) {
-                Ok(()) => {}
-                Err(_) => break,
-            }
-            if row_buf.iter().all(|&b| b == b' ') {
-                pending_blanks += 1;
-            } else {
-                // flush buffered blanks
-                let flush = pending_blanks.min(skip - skipped);
-                skipped += flush;
-                pending_blanks = 0;
-                if skipped < skip {
-                    skipped += 1; // count this non-blank row
-                }
-            }
-        }
-        // Any remaining pending_blanks are discarded (they would have been padding).
-
-        let remaining = if let Some(n) = n_rows { n } else { usize::MAX };
-
         Ok(Self {
             reader,
             col_plan,
-            row_length,
+            row_length: meta.row_length,
             batch_size,
             missing_string_as_null,
             row_index_name,
-            row_cursor: skip,
-            total: remaining,
-            remaining,
-            pending_blanks: 0,
-            blank_row,
-            done: false,
+            row_cursor: start,
+            remaining: n_rows.min(meta.row_count.saturating_sub(start)),
+            buf: Vec::new(),
         })
     }
 
     fn next_batch(&mut self) -> PolarsResult<Option<DataFrame>> {
-        if self.done || self.remaining == 0 {
+        if self.remaining == 0 || self.row_length == 0 {
             return Ok(None);
         }
-
         let take = self.batch_size.min(self.remaining);
-        let mut builder = XptBatchBuilder::new(&self.col_plan, take, self.missing_string_as_null);
-        let mut row_buf = vec![0u8; self.row_length];
-        let mut count = 0usize;
-
-        while count < take {
-            match self.reader.read_exact(&mut row_buf) {
-                Ok(()) => {}
-                Err(_) => {
-                    self.done = true;
-                    // Trailing blank rows are XPT padding — discard them.
-                    self.pending_blanks = 0;
-                    break;
-                }
-            }
-
-            if row_buf.iter().all(|&b| b == b' ') {
-                // Accumulate; only emit if a non-blank row follows.
-                self.pending_blanks += 1;
-                continue;
-            }
-
-            // Non-blank row: flush any accumulated blank rows, then push this row.
-            while self.pending_blanks > 0 && count < take {
-                builder.push_row(&self.blank_row.clone());
-                self.pending_blanks -= 1;
-                count += 1;
-            }
-            if count < take {
-                builder.push_row(&row_buf);
-                count += 1;
+        self.buf.resize(take * self.row_length, 0);
+        // Short only if the file was truncated since its metadata was read.
+        let mut filled = 0;
+        while filled < self.buf.len() {
+            match self.reader.read(&mut self.buf[filled..]) {
+                Ok(0) => break,
+                Ok(n) => filled += n,
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+                Err(e) => return Err(PolarsError::ComputeError(format!("XPT read: {e}").into())),
             }
         }
-
+        let count = filled / self.row_length;
+        if count < take {
+            self.remaining = 0;
+        } else {
+            self.remaining -= count;
+        }
         if count == 0 {
-            self.done = true;
             return Ok(None);
         }
 
-        self.remaining = self.remaining.saturating_sub(count);
         let row_start = self.row_cursor;
         self.row_cursor += count;
-
-        let df = builder.build()?;
+        let df = decode_rows(
+            &self.buf,
+            count,
+            self.row_length,
+            &self.col_plan,
+            self.missing_string_as_null,
+        )?;
 
         if let Some(ref name) = self.row_index_name {
             let df = crate::append_row_index(df, name, row_start)?;
@@ -824,6 +746,7 @@ impl Iterator for XptBatchIter {
     type Item = PolarsResult<DataFrame>;
 
     fn next(&mut self) -> Option<Self::Item> {
+        let _decode = crate::read_profile::span(crate::read_profile::ProfileStage::RowDecode);
         match self.next_batch() {
             Ok(Some(df)) => Some(Ok(df)),
             Ok(None) => None,
@@ -836,32 +759,33 @@ impl Iterator for XptBatchIter {
 // Column plan helpers
 // ────────────────────────────────────────────────────────────────
 
-fn build_col_plan(
-    meta: &XptMetadata,
-    col_names: Option<&[String]>,
-) -> Vec<(XptColumn, ColKind)> {
-    let cols = match col_names {
-        Some(names) => {
-            let name_set: std::collections::HashSet<&str> =
-                names.iter().map(|s| s.as_str()).collect();
-            meta.columns
-                .iter()
-                .filter(|c| name_set.contains(c.name.as_str()))
-                .cloned()
-                .collect::<Vec<_>>()
+fn build_col_plan(meta: &XptMetadata, col_names: Option<&[String]>) -> Vec<PlannedColumn> {
+    let name_set: Option<std::collections::HashSet<&str>> =
+        col_names.map(|names| names.iter().map(|s| s.as_str()).collect());
+    let mut offset = 0usize;
+    let mut plan = Vec::with_capacity(meta.columns.len());
+    for c in &meta.columns {
+        let at = offset;
+        offset += c.storage_width;
+        if name_set
+            .as_ref()
+            .is_some_and(|set| !set.contains(c.name.as_str()))
+        {
+            continue;
         }
-        None => meta.columns.clone(),
-    };
-    cols.into_iter().map(|c| {
-        let kind = col_kind(&c);
-        (c, kind)
-    }).collect()
+        plan.push(PlannedColumn {
+            kind: col_kind(c),
+            col: c.clone(),
+            offset: at,
+        });
+    }
+    plan
 }
 
-fn build_schema(col_plan: &[(XptColumn, ColKind)]) -> Schema {
+fn build_schema(col_plan: &[PlannedColumn]) -> Schema {
     let mut schema = Schema::with_capacity(col_plan.len());
-    for (col, kind) in col_plan {
-        schema.with_column(col.name.as_str().into(), col_dtype(*kind));
+    for plan in col_plan {
+        schema.with_column(plan.col.name.as_str().into(), col_dtype(plan.kind));
     }
     schema
 }
@@ -870,7 +794,7 @@ fn build_schema(col_plan: &[(XptColumn, ColKind)]) -> Schema {
 // AnonymousScan implementation
 // ────────────────────────────────────────────────────────────────
 
-struct XptScan {
+pub(crate) struct XptScan {
     path: PathBuf,
     threads: Option<usize>,
     preserve_order: bool,
@@ -878,12 +802,14 @@ struct XptScan {
     chunk_size: Option<usize>,
     row_index_name: Option<String>,
     compress_opts: crate::CompressOptionsLite,
-    col_plan: Vec<(XptColumn, ColKind)>,
+    col_plan: Vec<PlannedColumn>,
+    profiler: Option<crate::ReadProfiler>,
 }
 
 impl XptScan {
-    fn new(path: PathBuf, opts: &crate::ScanOptions) -> PolarsResult<Self> {
-        let meta = read_xpt_metadata(&path)?;
+    pub(crate) fn new(path: PathBuf, opts: &crate::ScanOptions) -> PolarsResult<Self> {
+        let _profile = crate::read_profile::enter(opts.profile.as_ref());
+        let meta = read_xpt_metadata_cached(&path)?;
         let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
         let col_plan = build_col_plan(&meta, None);
         Ok(Self {
@@ -895,6 +821,7 @@ impl XptScan {
             row_index_name: opts.row_index_name.clone(),
             compress_opts: opts.compress_opts.clone(),
             col_plan,
+            profiler: opts.profile.clone(),
         })
     }
 }
@@ -913,13 +840,14 @@ impl AnonymousScan for XptScan {
     }
 
     fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
         let columns = opts.with_columns.map(|cols| {
             let name_set: std::collections::HashSet<&str> =
                 cols.iter().map(|s| s.as_str()).collect();
             self.col_plan
                 .iter()
-                .filter(|(c, _)| name_set.contains(c.name.as_str()))
-                .map(|(c, _)| c.name.clone())
+                .filter(|plan| name_set.contains(plan.col.name.as_str()))
+                .map(|plan| plan.col.name.clone())
                 .collect::<Vec<_>>()
         });
 
@@ -935,23 +863,15 @@ impl AnonymousScan for XptScan {
             opts.n_rows,
         )?;
 
-        let mut out: Option<DataFrame> = None;
+        let row_count = read_xpt_metadata_cached(&self.path)?.row_count;
+        let mut out = crate::frame_assembly::FrameAssembler::new(
+            crate::frame_assembly::expected_rows(row_count, opts.n_rows, false),
+        )
+        .with_compression(Some(&self.compress_opts));
         for batch in iter {
-            let df = batch?;
-            if let Some(acc) = out.as_mut() {
-                acc.vstack_mut(&df)?;
-            } else {
-                out = Some(df);
-            }
-        }
-        let df = out.unwrap_or_else(DataFrame::empty);
-
-        if self.compress_opts.enabled {
-            crate::compress_df_if_enabled(&df, &self.compress_opts)
-                .map_err(|e| PolarsError::ComputeError(e.into()))
-        } else {
-            Ok(df)
+            out.push(batch?)?;
         }
+        out.finish()
     }
 }
 
@@ -968,70 +888,6 @@ pub fn scan_xpt(
     LazyFrame::anonymous_scan(scan, Default::default())
 }
 
-fn split_batch_ranges(total_batches: usize, n_workers: usize) -> Vec<(usize, usize)> {
-    if total_batches == 0 || n_workers == 0 {
-        return Vec::new();
-    }
-    let n = n_workers.min(total_batches);
-    let base = total_batches / n;
-    let rem = total_batches % n;
-    let mut ranges = Vec::with_capacity(n);
-    let mut start = 0usize;
-    for i in 0..n {
-        let len = base + if i < rem { 1 } else { 0 };
-        ranges.push((start, len));
-        start += len;
-    }
-    ranges
-}
-
-struct ParallelXptBatchIter {
-    rx: Receiver<(usize, PolarsResult<DataFrame>)>,
-    handle: Option<JoinHandle<()>>,
-    preserve_order: bool,
-    buffer: BTreeMap<usize, PolarsResult<DataFrame>>,
-    next_idx: usize,
-    total_chunks: usize,
-}
-
-impl Iterator for ParallelXptBatchIter {
-    type Item = PolarsResult<DataFrame>;
-
-    fn next(&mut self) -> Option<Self::Item> {
-        if !self.preserve_order {
-            return self.rx.recv().ok().map(|(_, df)| df);
-        }
-        if self.next_idx >= self.total_chunks {
-            return None;
-        }
-        loop {
-            if let Some(item) = self.buffer.remove(&self.next_idx) {
-                self.next_idx += 1;
-                return Some(item);
-            }
-            match self.rx.recv() {
-                Ok((idx, df)) => {
-                    self.buffer.insert(idx, df);
-                }
-                Err(_) => {
-                    return self.buffer.remove(&self.next_idx).map(|item| {
-                        self.next_idx += 1;
-                        item
-                    });
-                }
-            }
-        }
-    }
-}
-
-impl Drop for ParallelXptBatchIter {
-    fn drop(&mut self) {
-        if let Some(h) = self.handle.take() {
-            let _ = h.join();
-        }
-    }
-}
-
 /// Batch iterator for XPT files (used by readstat_batch_iter).
 pub fn xpt_batch_iter(
     path: PathBuf,
@@ -1044,8 +900,8 @@ pub fn xpt_batch_iter(
     skip: usize,
     n_rows: Option<usize>,
 ) -> PolarsResult<Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>> {
-    let meta = read_xpt_metadata(&path)?;
-    let col_plan = build_col_plan(&meta, columns.as_deref());
+    let meta = read_xpt_metadata_cached(&path)?;
+    let col_plan = Arc::new(build_col_plan(&meta, columns.as_deref()));
 
     let max_rows = meta.row_count.saturating_sub(skip);
     let total = n_rows.unwrap_or(max_rows).min(max_rows);
@@ -1057,71 +913,36 @@ pub fn xpt_batch_iter(
 
     let n_threads = threads.unwrap_or(crate::default_thread_count()).max(1);
     if n_threads > 1 && total >= 1000 {
-        let total_chunks = total.div_ceil(batch_size);
-        let n_workers = n_threads.min(total_chunks);
-        let (tx, rx) = mpsc::sync_channel::<(usize, PolarsResult<DataFrame>)>(n_workers);
-
+        // Each task reads one contiguous byte range of whole batches: about
+        // TASK_BYTES, but small enough that every worker gets a share.
+        let total_batches = total.div_ceil(batch_size);
+        let n_workers = n_threads.min(total_batches);
+        let batch_bytes = (batch_size * meta.row_length).max(1);
+        let batches_per_task = (TASK_BYTES / batch_bytes)
+            .clamp(1, total_batches.div_ceil(n_workers).max(1));
+        let task_rows = batches_per_task * batch_size;
         let path = Arc::new(path);
-        let meta = Arc::new(meta);
-        let col_plan = Arc::new(col_plan);
-        let ranges = split_batch_ranges(total_chunks, n_workers);
-
-        let handle = std::thread::spawn(move || {
-            let pool = match ThreadPoolBuilder::new().num_threads(n_workers).build() {
-                Ok(p) => p,
-                Err(e) => {
-                    let _ = tx.send((0, Err(PolarsError::ComputeError(e.to_string().into()))));
-                    return;
-                }
-            };
-            pool.install(|| {
-                ranges.into_par_iter().for_each_with(
-                    tx,
-                    |sender, (batch_start, batch_count)| {
-                        if batch_count == 0 {
-                            return;
-                        }
-                        let worker_skip = skip + batch_start * batch_size;
-                        let worker_rows = (batch_count * batch_size).min(total - batch_start * batch_size);
-                        let row_index_name = row_index_name.clone();
-
-                        let iter = match XptBatchIter::new(
-                            &path,
-                            &meta,
-                            (*col_plan).clone(),
-                            batch_size,
-                            worker_skip,
-                            Some(worker_rows),
-                            missing_string_as_null,
-                            row_index_name,
-                        ) {
-                            Ok(it) => it,
-                            Err(e) => {
-                                let _ = sender.send((batch_start, Err(e)));
-                                return;
-                            }
-                        };
-
-                        let mut local_idx = 0usize;
-                        for batch in iter {
-                            if sender.send((batch_start + local_idx, batch)).is_err() {
-                                return;
-                            }
-                            local_idx += 1;
-                        }
-                    },
-                );
-            });
-        });
 
-        return Ok(Box::new(ParallelXptBatchIter {
-            rx,
-            handle: Some(handle),
+        let tasks = crate::worker_pool::ScanTasks::new(
+            total.div_ceil(task_rows),
+            crate::worker_pool::scan_limit(n_workers),
             preserve_order,
-            buffer: BTreeMap::new(),
-            next_idx: 0,
-            total_chunks,
-        }));
+            move |task| {
+                let start = task * task_rows;
+                XptBatchIter::new(
+                    &path,
+                    &meta,
+                    col_plan.clone(),
+                    batch_size,
+                    skip + start,
+                    task_rows.min(total - start),
+                    missing_string_as_null,
+                    row_index_name.clone(),
+                )?
+                .collect::<PolarsResult<Vec<_>>>()
+            },
+        );
+        return Ok(Box::new(tasks));
     }
 
     // Serial path
@@ -1131,7 +952,7 @@ pub fn xpt_batch_iter(
         col_plan,
         batch_size,
         skip,
-        Some(total),
+        total,
         missing_string_as_null,
         row_index_name,
     )?;
@@ -1144,7 +965,7 @@ fn df_col_str<'a>(df: &'a polars::prelude::DataFrame, col: &str, row: usize) ->
 
 /// Export XPT metadata as JSON (mirrors the SAS7BDAT metadata_json format).
 pub fn xpt_metadata_json(path: &Path) -> PolarsResult<String> {
-    let meta = read_xpt_metadata(path)?;
+    let meta = read_xpt_metadata_cached(path)?;
     let df = &meta.metadata_df;
     let columns: Vec<serde_json::Value> = meta
         .columns
@@ -1171,3 +992,51 @@ pub fn xpt_metadata_json(path: &Path) -> PolarsResult<String> {
     });
     Ok(v.to_string())
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn ibm(bytes: [u8; 8]) -> u64 {
+        u64::from_be_bytes(bytes)
+    }
+
+    #[test]
+    fn test_ibm_to_ieee_known_values() {
+        let cases: [([u8; 8], f64); 6] = [
+            ([0x41, 0x10, 0, 0, 0, 0, 0, 0], 1.0),
+            ([0x40, 0x80, 0, 0, 0, 0, 0, 0], 0.5),
+            ([0x42, 0x64, 0, 0, 0, 0, 0, 0], 100.0),
+            ([0xC2, 0x76, 0xA0, 0, 0, 0, 0, 0], -118.625),
+            ([0x00, 0x10, 0, 0, 0, 0, 0, 0], 16f64.powi(-65)),
+            ([0x80, 0, 0, 0, 0, 0, 0, 0], -0.0),
+        ];
+        for (bytes, want) in cases {
+            let got = ibm_to_ieee(ibm(bytes));
+            assert_eq!(got.to_bits(), want.to_bits(), "{bytes:02X?}");
+        }
+        assert_eq!(ibm_to_ieee(0), 0.0);
+
+        assert!(ibm_is_missing(ibm([b'.', 0, 0, 0, 0, 0, 0, 0])));
+        assert!(ibm_is_missing(ibm([b'A', 0, 0, 0, 0, 0, 0, 0])));
+        assert!(ibm_is_missing(ibm([b'_', 0, 0, 0, 0, 0, 0, 0])));
+        assert!(!ibm_is_missing(ibm([b'.', 0, 0, 0, 0, 0, 0, 1])));
+        assert!(!ibm_is_missing(0));
+    }
+
+    #[test]
+    fn test_decode_ibm_column_strided_and_short_fields() {
+        // Rows of [3-byte numeric][1 filler byte][8-byte numeric].
+        let mut rows = Vec::new();
+        rows.extend_from_slice(&[0x41, 0x10, 0, b'x', 0x42, 0x64, 0, 0, 0, 0, 0, 0]);
+        rows.extend_from_slice(&[b'.', 0, 0, b'x', 0x41, 0x20, 0, 0, 0, 0, 0, 0]);
+
+        let (values, missing) = decode_ibm_column(&rows, 2, 12, 0, 3);
+        assert_eq!(values[0], 1.0);
+        assert_eq!(missing, Some(vec![false, true]));
+
+        let (values, missing) = decode_ibm_column(&rows, 2, 12, 4, 8);
+        assert_eq!(values, vec![100.0, 2.0]);
+        assert_eq!(missing, None);
+    }
+}
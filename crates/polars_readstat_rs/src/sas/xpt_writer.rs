@@ -1,5 +1,6 @@
 use chrono::prelude::*;
 use polars::prelude::*;
+use rayon::prelude::*;
 use std::collections::HashMap;
 use std::fs::File;
 use std::io::{BufWriter, Write};
@@ -9,6 +10,8 @@ const LINE_LEN: usize = 80;
 const NAMESTR_SIZE: usize = 140;
 const SAS_EPOCH_DAYS: i64 = 3653; // days between 1960-01-01 and 1970-01-01
 const SECS_PER_DAY: f64 = 86400.0;
+/// Target bytes of row data encoded per parallel work unit.
+const ENCODE_CHUNK_BYTES: usize = 4 * 1024 * 1024;
 
 pub type XptVariableLabels = HashMap<String, String>;
 pub type XptVariableFormats = HashMap<String, String>;
@@ -297,15 +300,18 @@ fn space_pad(dst: &mut [u8], src: &[u8]) {
 // Column data extraction
 // ────────────────────────────────────────────────────────────────
 
+/// One column of a batch, converted to what its XPT field stores: numeric
+/// kinds as SAS values in f64, character columns as strings.
 enum ColData {
-    Numeric(Vec<Option<f64>>),
-    Character(Vec<Option<Vec<u8>>>),
+    Numeric(Float64Chunked),
+    Character(StringChunked),
 }
 
 fn extract_col_data(df: &DataFrame, cols: &[WriteColumn]) -> PolarsResult<Vec<ColData>> {
     let mut out = Vec::with_capacity(cols.len());
-    for (col_info, column) in cols.iter().zip(df.columns().iter()) {
-        let series = column.as_materialized_series();
+    for col_info in cols {
+        let series = df.column(&col_info.name)?.as_materialized_series();
+        let name = series.name().clone();
         let cd = match col_info.kind {
             WriteKind::Character => {
                 let s2 = if matches!(series.dtype(), DataType::Categorical(_, _)) {
@@ -318,48 +324,42 @@ fn extract_col_data(df: &DataFrame, cols: &[WriteColumn]) -> PolarsResult<Vec<Co
                         format!("XPT: expected string column '{}': {e}", col_info.name).into(),
                     )
                 })?;
-                let vals: Vec<Option<Vec<u8>>> = ca
-                    .iter()
-                    .map(|o: Option<&str>| o.map(|s| s.as_bytes().to_vec()))
-                    .collect();
-                ColData::Character(vals)
+                ColData::Character(ca.clone())
             }
             WriteKind::Numeric => {
                 let ca = series.cast(&DataType::Float64)?;
-                let ca = ca.f64()?;
-                let vals: Vec<Option<f64>> = ca.iter().collect();
-                ColData::Numeric(vals)
+                ColData::Numeric(ca.f64()?.clone())
             }
             WriteKind::Date => {
                 let ca = series.cast(&DataType::Date)?;
                 let ca = ca.date()?;
-                let vals: Vec<Option<f64>> = ca
-                    .phys
-                    .iter()
-                    .map(|o: Option<i32>| o.map(|d| (d as i64 + SAS_EPOCH_DAYS) as f64))
-                    .collect();
-                ColData::Numeric(vals)
+                ColData::Numeric(Float64Chunked::from_iter_options(
+                    name,
+                    ca.phys
+                        .iter()
+                        .map(|o: Option<i32>| o.map(|d| (d as i64 + SAS_EPOCH_DAYS) as f64)),
+                ))
             }
             WriteKind::Datetime => {
                 let ca = series.cast(&DataType::Datetime(TimeUnit::Microseconds, None))?;
                 let ca = ca.datetime()?;
                 let epoch_us = SAS_EPOCH_DAYS as f64 * SECS_PER_DAY * 1_000_000.0;
-                let vals: Vec<Option<f64>> = ca
-                    .phys
-                    .iter()
-                    .map(|o: Option<i64>| o.map(|us| (us as f64 + epoch_us) / 1_000_000.0))
-                    .collect();
-                ColData::Numeric(vals)
+                ColData::Numeric(Float64Chunked::from_iter_options(
+                    name,
+                    ca.phys
+                        .iter()
+                        .map(|o: Option<i64>| o.map(|us| (us as f64 + epoch_us) / 1_000_000.0)),
+                ))
             }
             WriteKind::Time => {
                 let ca = series.cast(&DataType::Time)?;
                 let ca = ca.time()?;
-                let vals: Vec<Option<f64>> = ca
-                    .phys
-                    .iter()
-                    .map(|o: Option<i64>| o.map(|ns| ns as f64 / 1_000_000_000.0))
-                    .collect();
-                ColData::Numeric(vals)
+                ColData::Numeric(Float64Chunked::from_iter_options(
+                    name,
+                    ca.phys
+                        .iter()
+                        .map(|o: Option<i64>| o.map(|ns| ns as f64 / 1_000_000_000.0)),
+                ))
             }
         };
         out.push(cd);
@@ -432,20 +432,95 @@ impl XptWriter {
         let (cols, row_length) = self.build_col_plan(df)?;
         let timestamp = format_timestamp();
         write_headers(&mut ctx, &self, &cols, row_length, &timestamp)?;
-        write_data(&mut ctx, df, &cols, row_length)?;
+        write_data(&mut ctx, std::iter::once(df.clone()), &cols, row_length)?;
+        ctx.flush()
+            .map_err(|e| PolarsError::ComputeError(format!("XPT flush: {e}").into()))
+    }
+
+    /// Write batches as they arrive, holding one batch at a time. XPT has no row
+    /// count in its headers, so nothing is patched afterwards.
+    ///
+    /// Character columns of `schema` need a width in `with_storage_widths`;
+    /// longer values are an error. Rows of each batch are encoded in parallel
+    /// chunks while the previous batch is written, and written in order.
+    pub fn write_batches_streaming<I>(self, batches: I, schema: &Schema) -> PolarsResult<()>
+    where
+        I: IntoIterator<Item = DataFrame>,
+    {
+        if self.version != 5 && self.version != 8 {
+            return Err(PolarsError::ComputeError(
+                "XPT version must be 5 or 8".into(),
+            ));
+        }
+        let mut char_widths = HashMap::new();
+        for (name, dtype) in schema.iter() {
+            if matches!(write_kind_for_dtype(dtype), WriteKind::Character) {
+                let width = self.storage_widths.get(name.as_str()).ok_or_else(|| {
+                    PolarsError::ComputeError(
+                        format!("XPT streaming writes need a storage width for character column '{name}'")
+                            .into(),
+                    )
+                })?;
+                char_widths.insert(name.to_string(), (*width).max(1));
+            }
+        }
+        let (cols, row_length) = self.plan_columns(schema, &char_widths)?;
+        let file = File::create(&self.path)
+            .map_err(|e| PolarsError::ComputeError(format!("XPT create: {e}").into()))?;
+        let mut ctx = Ctx::new(BufWriter::new(file));
+        let timestamp = format_timestamp();
+        write_headers(&mut ctx, &self, &cols, row_length, &timestamp)?;
+        write_data(&mut ctx, batches, &cols, row_length)?;
         ctx.flush()
             .map_err(|e| PolarsError::ComputeError(format!("XPT flush: {e}").into()))
     }
 
     fn build_col_plan(&self, df: &DataFrame) -> PolarsResult<(Vec<WriteColumn>, usize)> {
-        let mut cols = Vec::with_capacity(df.width());
+        // Character: scan actual data for max byte length; declared width is only used for the warning.
+        let mut char_widths = HashMap::new();
+        for column in df.columns().iter() {
+            let series = column.as_materialized_series();
+            let name = series.name().to_string();
+            if !matches!(write_kind_for_dtype(series.dtype()), WriteKind::Character) {
+                continue;
+            }
+            let scan_width = series
+                .str()
+                .map(|ca| {
+                    ca.iter()
+                        .filter_map(|v: Option<&str>| v)
+                        .map(|s| s.len())
+                        .max()
+                        .unwrap_or(1)
+                })
+                .unwrap_or(1)
+                .max(1);
+            if let Some(&w) = self.storage_widths.get(&name) {
+                if scan_width > w {
+                    eprintln!(
+                        "warning: column '{}' declared storage_width={} but data contains strings up to {} bytes; using {}",
+                        name, w, scan_width, scan_width
+                    );
+                }
+            }
+            char_widths.insert(name, scan_width);
+        }
+        self.plan_columns(df.schema(), &char_widths)
+    }
+
+    fn plan_columns(
+        &self,
+        schema: &Schema,
+        char_widths: &HashMap<String, usize>,
+    ) -> PolarsResult<(Vec<WriteColumn>, usize)> {
+        let mut cols = Vec::with_capacity(schema.len());
         let mut offset = 0usize;
 
         // Validate names up front: length limit and no case collisions.
         let max_name_len = if self.version >= 8 { 32 } else { 8 };
         let mut seen: std::collections::HashSet<String> = std::collections::HashSet::new();
-        for column in df.columns().iter() {
-            let name = column.name().as_str();
+        for name in schema.iter_names() {
+            let name = name.as_str();
             if name.len() > max_name_len {
                 return Err(PolarsError::ComputeError(
                     format!("XPT v{} variable name '{}' exceeds {} characters",
@@ -460,10 +535,8 @@ impl XptWriter {
             }
         }
 
-        for column in df.columns().iter() {
-            let series = column.as_materialized_series();
-            let name = series.name().to_string();
-            let dtype = series.dtype();
+        for (name, dtype) in schema.iter() {
+            let name = name.to_string();
             let kind = write_kind_for_dtype(dtype);
             let is_numeric = !matches!(kind, WriteKind::Character);
 
@@ -474,27 +547,7 @@ impl XptWriter {
                     8usize
                 }
             } else {
-                // Character: scan actual data for max byte length; declared width is only used for the warning.
-                let scan_width = series
-                    .str()
-                    .map(|ca| {
-                        ca.iter()
-                            .filter_map(|v: Option<&str>| v)
-                            .map(|s| s.len())
-                            .max()
-                            .unwrap_or(1)
-                    })
-                    .unwrap_or(1)
-                    .max(1);
-                if let Some(&w) = self.storage_widths.get(&name) {
-                    if scan_width > w {
-                        eprintln!(
-                            "warning: column '{}' declared storage_width={} but data contains strings up to {} bytes; using {}",
-                            name, w, scan_width, scan_width
-                        );
-                    }
-                }
-                scan_width
+                char_widths.get(&name).copied().unwrap_or(1)
             };
 
             let full_label = self
@@ -687,69 +740,114 @@ fn write_headers<W: Write>(
 // Data writing
 // ────────────────────────────────────────────────────────────────
 
-fn write_data<W: Write>(
+fn write_data<W, I>(
     ctx: &mut Ctx<W>,
-    df: &DataFrame,
+    batches: I,
     cols: &[WriteColumn],
     row_length: usize,
-) -> PolarsResult<()> {
-    let nrows = df.height();
-    if nrows == 0 || row_length == 0 {
+) -> PolarsResult<()>
+where
+    W: Write + Send,
+    I: IntoIterator<Item = DataFrame>,
+{
+    if row_length == 0 {
         ctx.pad_to_record()?;
         return Ok(());
     }
-
-    let col_data = extract_col_data(df, cols)?;
-    let mut row_buf = vec![b' '; row_length];
-
-    // Pre-fill numeric slots with the system-missing marker.
-    for col in cols.iter() {
-        if col.is_numeric {
-            let field = &mut row_buf[col.row_offset..col.row_offset + col.storage_width];
-            field[0] = b'.';
-            for b in field.iter_mut().skip(1) {
-                *b = 0;
-            }
+    let chunk_rows = (ENCODE_CHUNK_BYTES / row_length).max(1);
+    // Each batch is encoded while the previous one is written out.
+    let mut pending: Vec<Vec<u8>> = Vec::new();
+    for df in batches {
+        if df.height() == 0 {
+            continue;
         }
+        let (written, encoded) = rayon::join(
+            || pending.iter().try_for_each(|chunk| ctx.write_all(chunk)),
+            || encode_batch(&df, cols, row_length, chunk_rows),
+        );
+        written?;
+        pending = encoded?;
     }
+    for chunk in &pending {
+        ctx.write_all(chunk)?;
+    }
+    ctx.pad_to_record()?;
+    Ok(())
+}
 
-    for row_idx in 0..nrows {
-        // Reset row buffer.
-        for col in cols.iter() {
-            if col.is_numeric {
-                row_buf[col.row_offset] = b'.';
-                for b in row_buf[col.row_offset + 1..col.row_offset + col.storage_width].iter_mut()
-                {
-                    *b = 0;
-                }
-            } else {
-                row_buf[col.row_offset..col.row_offset + col.storage_width].fill(b' ');
-            }
-        }
+/// Encode `df` as XPT rows in parallel chunks of `chunk_rows`.
+fn encode_batch(
+    df: &DataFrame,
+    cols: &[WriteColumn],
+    row_length: usize,
+    chunk_rows: usize,
+) -> PolarsResult<Vec<Vec<u8>>> {
+    let nrows = df.height();
+    let col_data = extract_col_data(df, cols)?;
+    let starts: Vec<usize> = (0..nrows).step_by(chunk_rows).collect();
+    starts
+        .par_iter()
+        .map(|&start| {
+            let end = (start + chunk_rows).min(nrows);
+            encode_rows(&col_data, cols, start..end, row_length)
+        })
+        .collect()
+}
 
-        for (i, col) in cols.iter().enumerate() {
-            match &col_data[i] {
-                ColData::Numeric(vals) => {
-                    if let Some(f) = vals[row_idx] {
-                        let xpt = f64_to_xpt(f);
-                        row_buf[col.row_offset..col.row_offset + col.storage_width]
-                            .copy_from_slice(&xpt[..col.storage_width]);
+/// Encode `rows` one column at a time: each column's fields sit `row_length`
+/// apart in the output.
+fn encode_rows(
+    col_data: &[ColData],
+    cols: &[WriteColumn],
+    rows: std::ops::Range<usize>,
+    row_length: usize,
+) -> PolarsResult<Vec<u8>> {
+    let n = rows.len();
+    let mut out = vec![0u8; n * row_length];
+    for (col, data) in cols.iter().zip(col_data) {
+        let width = col.storage_width;
+        let fields = out[col.row_offset..]
+            .chunks_mut(row_length)
+            .map(|row| &mut row[..width]);
+        match data {
+            ColData::Numeric(ca) => {
+                let ca = ca.slice(rows.start as i64, n);
+                if ca.null_count() == 0 {
+                    for (field, f) in fields.zip(ca.into_no_null_iter()) {
+                        field.copy_from_slice(&f64_to_xpt(f)[..width]);
+                    }
+                } else {
+                    for (field, v) in fields.zip(ca.iter()) {
+                        match v {
+                            Some(f) => field.copy_from_slice(&f64_to_xpt(f)[..width]),
+                            // System-missing marker; the rest of the field stays zero.
+                            None => field[0] = b'.',
+                        }
                     }
-                    // None: missing marker already set
                 }
-                ColData::Character(vals) => {
-                    if let Some(ref bytes) = vals[row_idx] {
-                        let n = bytes.len().min(col.storage_width);
-                        row_buf[col.row_offset..col.row_offset + n].copy_from_slice(&bytes[..n]);
-                        // rest already space-filled
+            }
+            ColData::Character(ca) => {
+                let ca = ca.slice(rows.start as i64, n);
+                for (field, v) in fields.zip(ca.iter()) {
+                    field.fill(b' ');
+                    if let Some(value) = v {
+                        let bytes = value.as_bytes();
+                        if bytes.len() > width {
+                            return Err(PolarsError::ComputeError(
+                                format!(
+                                    "XPT: value of {} bytes in column '{}' exceeds its storage width {}",
+                                    bytes.len(),
+                                    col.name,
+                                    width
+                                )
+                                .into(),
+                            ));
+                        }
+                        field[..bytes.len()].copy_from_slice(bytes);
                     }
                 }
             }
         }
-
-        ctx.write_all(&row_buf)?;
     }
-
-    ctx.pad_to_record()?;
-    Ok(())
+    Ok(out)
 }
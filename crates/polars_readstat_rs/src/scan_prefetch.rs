@@ -1,31 +1,48 @@
+use crate::mem_budget::ByteBudget;
 use polars::prelude::{DataFrame, PolarsResult};
 use std::sync::mpsc::{sync_channel, Receiver};
-use std::thread::{self, JoinHandle};
+use std::sync::Arc;
+use std::thread::JoinHandle;
+
+/// Batches read ahead of the consumer.
+const PREFETCH_DEPTH: usize = 10;
 
 pub(crate) struct Prefetcher {
-    rx: Receiver<PolarsResult<DataFrame>>,
+    /// Each batch travels with the bytes it was charged against `budget`.
+    rx: Receiver<(PolarsResult<DataFrame>, usize)>,
+    budget: Option<Arc<ByteBudget>>,
     handle: Option<JoinHandle<()>>,
 }
 
 impl Prefetcher {
-    pub(crate) fn new(
-        rx: Receiver<PolarsResult<DataFrame>>,
+    fn new(
+        rx: Receiver<(PolarsResult<DataFrame>, usize)>,
+        budget: Option<Arc<ByteBudget>>,
         handle: Option<JoinHandle<()>>,
     ) -> Self {
-        Self { rx, handle }
+        Self { rx, budget, handle }
     }
 
     pub(crate) fn next(&self) -> PolarsResult<Option<DataFrame>> {
-        match self.rx.recv() {
-            Ok(Ok(df)) => Ok(Some(df)),
-            Ok(Err(e)) => Err(e),
-            Err(_) => Ok(None),
+        let (item, bytes) = match crate::read_profile::wait(|| self.rx.recv()) {
+            Ok(received) => received,
+            Err(_) => return Ok(None),
+        };
+        if let Some(budget) = &self.budget {
+            budget.release(bytes);
         }
+        item.map(Some)
     }
 }
 
 impl Drop for Prefetcher {
     fn drop(&mut self) {
+        if let Some(budget) = &self.budget {
+            budget.close();
+        }
+        // Disconnect the channel so a producer blocked on a full queue exits.
+        let (_, closed) = sync_channel(0);
+        drop(std::mem::replace(&mut self.rx, closed));
         if let Some(handle) = self.handle.take() {
             let _ = handle.join();
         }
@@ -36,11 +53,32 @@ pub(crate) fn spawn_prefetcher<I>(iter: I) -> Prefetcher
 where
     I: Iterator<Item = PolarsResult<DataFrame>> + Send + 'static,
 {
-    let (tx, rx) = sync_channel::<PolarsResult<DataFrame>>(10);
-    let handle = thread::spawn(move || {
+    spawn_budgeted_prefetcher(iter, None)
+}
+
+/// `spawn_prefetcher` that, when `budget` is set, also stops reading ahead once
+/// the queued batches hold `budget` bytes (by `DataFrame::estimated_size`).
+pub(crate) fn spawn_budgeted_prefetcher<I>(iter: I, budget: Option<usize>) -> Prefetcher
+where
+    I: Iterator<Item = PolarsResult<DataFrame>> + Send + 'static,
+{
+    let budget = budget.map(|limit| Arc::new(ByteBudget::new(limit)));
+    let producer_budget = budget.clone();
+    let (tx, rx) = sync_channel::<(PolarsResult<DataFrame>, usize)>(PREFETCH_DEPTH);
+    let handle = crate::read_profile::spawn(move || {
         for item in iter {
             let is_err = item.is_err();
-            if tx.send(item).is_err() {
+            let bytes = match (&producer_budget, &item) {
+                (Some(budget), Ok(df)) => {
+                    let bytes = df.estimated_size();
+                    if !budget.acquire(bytes) {
+                        break;
+                    }
+                    bytes
+                }
+                _ => 0,
+            };
+            if crate::read_profile::wait(|| tx.send((item, bytes))).is_err() {
                 break;
             }
             if is_err {
@@ -48,5 +86,20 @@ where
             }
         }
     });
-    Prefetcher::new(rx, Some(handle))
+    Prefetcher::new(rx, budget, Some(handle))
+}
+
+/// Boxed batch iterator whose read-ahead is bounded by `budget` bytes, or `iter`
+/// itself when there is no budget.
+pub(crate) fn bounded_batches(
+    iter: Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>,
+    budget: Option<usize>,
+) -> Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send> {
+    match budget {
+        Some(budget) => {
+            let prefetch = spawn_budgeted_prefetcher(iter, Some(budget));
+            Box::new(std::iter::from_fn(move || prefetch.next().transpose()))
+        }
+        None => iter,
+    }
 }
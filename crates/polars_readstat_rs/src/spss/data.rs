@@ -1,15 +1,20 @@
+use crate::label_categories::{CategoricalBuilder, LabelCategories, LabelKey};
+use crate::mmap_source::{FileSource, SharedInput};
+use crate::null_indicator::IndicatorBuilder;
+use crate::numeric_column::NumericColumnBuilder;
+use crate::read_profile::{self, ProfileStage, Tally};
 use crate::spss::error::{Error, Result};
 use crate::spss::types::{ColumnPlan as SpssColumnPlan, Endian, FormatClass, Metadata, VarType};
+use crate::string_intern::StringInterner;
+use crate::transpose::{ColumnStrips, FieldSpan};
 use flate2::read::ZlibDecoder;
 use polars::prelude::*;
-use std::collections::HashSet;
+use rayon::prelude::*;
+use std::collections::{HashSet, VecDeque};
 use std::fs::File;
 use std::io::{BufReader, Read, Seek, SeekFrom};
 use std::path::Path;
-use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Arc;
-use std::sync::OnceLock;
-use std::time::Instant;
 
 const SAV_MISSING_DOUBLE: u64 = 0xFFEFFFFFFFFFFFFF;
 const SAV_LOWEST_DOUBLE: u64 = 0xFFEFFFFFFFFFFFFE;
@@ -18,65 +23,15 @@ const SPSS_SEC_SHIFT: i64 = 12_219_379_200;
 const SEC_PER_DAY: i64 = 86_400;
 const SEC_MILLISECOND: i64 = 1_000;
 const SEC_NANOSECOND: i64 = 1_000_000_000;
-
-static PROFILE_ENABLED: OnceLock<bool> = OnceLock::new();
-static PROFILE_NUM_NS: AtomicU64 = AtomicU64::new(0);
-static PROFILE_STR_NS: AtomicU64 = AtomicU64::new(0);
-static PROFILE_DECODE_NS: AtomicU64 = AtomicU64::new(0);
-static PROFILE_LABEL_NS: AtomicU64 = AtomicU64::new(0);
-static PROFILE_NUM_CT: AtomicU64 = AtomicU64::new(0);
-static PROFILE_STR_CT: AtomicU64 = AtomicU64::new(0);
-
-fn profile_enabled() -> bool {
-    *PROFILE_ENABLED.get_or_init(|| std::env::var("SPSS_PROFILE").ok().is_some())
-}
-
-fn add_ns(target: &AtomicU64, elapsed: std::time::Duration) {
-    target.fetch_add(elapsed.as_nanos() as u64, Ordering::Relaxed);
-}
-
-#[allow(dead_code)]
-pub(crate) fn profile_reset() {
-    if !profile_enabled() {
-        return;
-    }
-    PROFILE_NUM_NS.store(0, Ordering::Relaxed);
-    PROFILE_STR_NS.store(0, Ordering::Relaxed);
-    PROFILE_DECODE_NS.store(0, Ordering::Relaxed);
-    PROFILE_LABEL_NS.store(0, Ordering::Relaxed);
-    PROFILE_NUM_CT.store(0, Ordering::Relaxed);
-    PROFILE_STR_CT.store(0, Ordering::Relaxed);
-}
-
-#[allow(dead_code)]
-pub(crate) fn profile_print() {
-    if !profile_enabled() {
-        return;
-    }
-    let num_ns = PROFILE_NUM_NS.load(Ordering::Relaxed);
-    let str_ns = PROFILE_STR_NS.load(Ordering::Relaxed);
-    let decode_ns = PROFILE_DECODE_NS.load(Ordering::Relaxed);
-    let label_ns = PROFILE_LABEL_NS.load(Ordering::Relaxed);
-    let num_ct = PROFILE_NUM_CT.load(Ordering::Relaxed);
-    let str_ct = PROFILE_STR_CT.load(Ordering::Relaxed);
-    let total_ms = (num_ns + str_ns) as f64 / 1_000_000.0;
-    eprintln!(
-        "SPSS_PROFILE total_ms={:.3} num_ct={} str_ct={} num_ms={:.3} str_ms={:.3} decode_ms={:.3} label_ms={:.3}",
-        total_ms,
-        num_ct,
-        str_ct,
-        num_ns as f64 / 1_000_000.0,
-        str_ns as f64 / 1_000_000.0,
-        decode_ns as f64 / 1_000_000.0,
-        label_ns as f64 / 1_000_000.0,
-    );
-}
+/// Rows per read in the blocked all-numeric decode path.
+const NUMERIC_BLOCK_ROWS: usize = 1024;
 
 /// Streaming variant: reads `limit` rows starting at `offset`, dispatching
 /// a batch of `batch_size` rows to `on_batch` as soon as each batch is ready.
 /// Returns `false` from the callback to stop early.
 /// For compression=1 (SAV) this maintains the decompressor state across batches
-/// so the file is read in a single sequential pass with no re-seeking.
+/// so the file is read in a single sequential pass with no re-seeking; with a
+/// `sav_index` it starts at the nearest checkpoint instead of row 0.
 /// For compression=2 (ZSAV) it falls back to reading the full range first.
 pub fn read_data_frame_streaming(
     path: &Path,
@@ -89,11 +44,16 @@ pub fn read_data_frame_streaming(
     limit: usize,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     batch_size: usize,
+    row_filter: Option<&crate::RowFilter>,
+    sav_index: Option<&SavRowIndex>,
+    map: Option<&SharedInput>,
     on_batch: &mut dyn FnMut(DataFrame) -> bool,
 ) -> Result<()> {
-    let file = File::open(path)?;
-    let mut reader = BufReader::with_capacity(8 * 1024 * 1024, file);
+    let _decode = read_profile::span(ProfileStage::RowDecode);
+    let mut tally = Tally::new();
+    let mut reader = FileSource::open(path, 8 * 1024 * 1024, map)?;
     let data_offset = metadata
         .data_offset
         .ok_or_else(|| Error::ParseError("missing data offset".to_string()))?;
@@ -125,10 +85,21 @@ pub fn read_data_frame_streaming(
         None
     };
     let label_maps = if value_labels_as_strings {
-        build_label_maps(metadata, needed_label_names.as_ref())
+        build_label_maps(
+            metadata,
+            needed_label_names.as_ref(),
+            value_labels_as_categorical,
+        )
     } else {
         std::collections::HashMap::new()
     };
+    let row_filter = row_filter
+        .and_then(|f| SpssRowFilter::compile(f, metadata, missing_string_as_null, &label_maps));
+    let keep_row = |row_buf: &[u8]| {
+        row_filter
+            .as_ref()
+            .map_or(true, |f| f.matches(row_buf, endian, metadata.encoding))
+    };
     // Plans are created once and reused across batches (they hold Arc refs to label maps).
     let mut plans = Vec::with_capacity(col_indices.len());
     for &idx in &col_indices {
@@ -154,45 +125,38 @@ pub fn read_data_frame_streaming(
     }
 
     // Inline helper: create a fresh set of column builders for one batch.
-    let make_builders =
-        |cap: usize| -> Vec<ColumnBuilder> {
-            col_indices
-                .iter()
-                .map(|&idx| {
-                    let var = &metadata.variables[idx];
-                    let name = var.name.as_str();
-                    let has_label = var
-                        .value_label
-                        .as_ref()
-                        .map(|n| label_maps.contains_key(n))
-                        .unwrap_or(false);
-                    match (var.var_type, has_label && value_labels_as_strings) {
-                        (VarType::Numeric, true) => ColumnBuilder::Utf8 {
-                            builder: StringChunkedBuilder::new(name.into(), cap),
-                            num_cache: Some(NumericStringCache::new()),
-                        },
-                        (VarType::Numeric, false) => match var.format_class {
-                            Some(FormatClass::Date) => ColumnBuilder::Date(
-                                PrimitiveChunkedBuilder::<Int32Type>::new(name.into(), cap),
-                            ),
-                            Some(FormatClass::DateTime) => ColumnBuilder::DateTime(
-                                PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), cap),
-                            ),
-                            Some(FormatClass::Time) => ColumnBuilder::Time(
-                                PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), cap),
-                            ),
-                            None => ColumnBuilder::Float64(
-                                PrimitiveChunkedBuilder::<Float64Type>::new(name.into(), cap),
-                            ),
-                        },
-                        (VarType::Str, _) => ColumnBuilder::Utf8 {
-                            builder: StringChunkedBuilder::new(name.into(), cap),
-                            num_cache: None,
-                        },
+    let make_builders = |cap: usize| -> Vec<ColumnBuilder> {
+        col_indices
+            .iter()
+            .map(|&idx| {
+                let var = &metadata.variables[idx];
+                let name = var.name.as_str();
+                let label_map = var.value_label.as_ref().and_then(|n| label_maps.get(n));
+                match (var.var_type, label_map.is_some() && value_labels_as_strings) {
+                    (VarType::Numeric, true) => {
+                        labelled_numeric_builder(name, cap, label_map.map(|m| &**m))
                     }
-                })
-                .collect()
-        };
+                    (VarType::Numeric, false) => match var.format_class {
+                        Some(FormatClass::Date) => {
+                            ColumnBuilder::Date(NumericColumnBuilder::new(name.into(), cap))
+                        }
+                        Some(FormatClass::DateTime) => {
+                            ColumnBuilder::DateTime(NumericColumnBuilder::new(name.into(), cap))
+                        }
+                        Some(FormatClass::Time) => {
+                            ColumnBuilder::Time(NumericColumnBuilder::new(name.into(), cap))
+                        }
+                        None => ColumnBuilder::Float64(NumericColumnBuilder::new(name.into(), cap)),
+                    },
+                    (VarType::Str, _) => ColumnBuilder::Utf8 {
+                        builder: StringChunkedBuilder::new(name.into(), cap),
+                        num_cache: None,
+                        interner: Some(StringInterner::new()),
+                    },
+                }
+            })
+            .collect()
+    };
 
     // Inline helper: finish builders into a DataFrame.
     let finish_batch = |builders: Vec<ColumnBuilder>| -> Result<DataFrame> {
@@ -208,24 +172,58 @@ pub fn read_data_frame_streaming(
             reader.seek(SeekFrom::Current((start_row as i64) * (record_len as i64)))?;
         }
         let mut row_idx = start_row;
+        let mut block = Vec::new();
+        let mut strips = ColumnStrips::default();
         while row_idx < end_row {
             let batch_rows = batch_size.min(end_row - row_idx);
             let mut builders = make_builders(batch_rows);
             let np = build_numeric_plans(&plans, &builders);
-            let mut added = 0usize;
-            while added < batch_rows {
+            // `taken` counts raw rows; rows rejected by the filter are never appended.
+            let mut taken = 0usize;
+            if let (Some(np), None) = (np.as_deref(), row_filter.as_ref()) {
+                // All-numeric and unfiltered: read rows in blocks and decode them a
+                // column at a time.
+                while taken < batch_rows {
+                    let n = (batch_rows - taken).min(NUMERIC_BLOCK_ROWS);
+                    block.resize(n * record_len, 0);
+                    reader.read_exact(&mut block)?;
+                    append_numeric_rows(
+                        &mut builders,
+                        &plans,
+                        np,
+                        &block,
+                        record_len,
+                        endian,
+                        &mut strips,
+                    )?;
+                    row_idx += n;
+                    taken += n;
+                }
+            }
+            while taken < batch_rows {
                 reader.read_exact(&mut row_buf)?;
+                row_idx += 1;
+                taken += 1;
+                if !keep_row(&row_buf) {
+                    continue;
+                }
                 if let Some(np) = np.as_deref() {
                     append_numeric_row(&mut builders, &plans, np, &row_buf, endian)?;
                 } else {
-                    append_row(&mut builders, &plans, &row_buf, endian, metadata.encoding)?;
+                    append_row(
+                        &mut builders,
+                        &plans,
+                        &row_buf,
+                        endian,
+                        metadata.encoding,
+                        &mut tally,
+                    )?;
                 }
-                row_idx += 1;
-                added += 1;
             }
-            if added == 0 {
+            if taken == 0 {
                 break;
             }
+            tally.flush();
             let df = finish_batch(builders)?;
             if !on_batch(df) {
                 return Ok(());
@@ -236,10 +234,17 @@ pub fn read_data_frame_streaming(
         // the file is read in a single forward pass (no re-seeking per batch).
         let mut decompressor = SavRowDecompressor::new(endian, bias);
         let mut row_idx = 0usize;
+        if let Some(cp) = sav_index.and_then(|index| index.locate(start_row)) {
+            reader.seek(SeekFrom::Start(cp.pos))?;
+            decompressor.control_chunk = cp.control_chunk;
+            decompressor.control_i = cp.control_i;
+            row_idx = cp.row;
+        }
 
         // Consume rows before start_row without storing them.
         while row_idx < start_row {
-            let status = decompressor.read_row(&mut reader, &mut row_buf, record_len)?;
+            let status =
+                decompressor.read_row(&mut reader, &mut row_buf, record_len, &mut tally)?;
             if status == DecompressStatus::FinishedAll {
                 return Ok(());
             }
@@ -251,23 +256,35 @@ pub fn read_data_frame_streaming(
             let batch_rows = batch_size.min(end_row - row_idx);
             let mut builders = make_builders(batch_rows);
             let np = build_numeric_plans(&plans, &builders);
-            let mut added = 0usize;
-            while added < batch_rows {
-                let status = decompressor.read_row(&mut reader, &mut row_buf, record_len)?;
+            let mut taken = 0usize;
+            while taken < batch_rows {
+                let status =
+                    decompressor.read_row(&mut reader, &mut row_buf, record_len, &mut tally)?;
                 if status == DecompressStatus::FinishedAll {
                     break;
                 }
+                row_idx += 1;
+                taken += 1;
+                if !keep_row(&row_buf) {
+                    continue;
+                }
                 if let Some(np) = np.as_deref() {
                     append_numeric_row(&mut builders, &plans, np, &row_buf, endian)?;
                 } else {
-                    append_row(&mut builders, &plans, &row_buf, endian, metadata.encoding)?;
+                    append_row(
+                        &mut builders,
+                        &plans,
+                        &row_buf,
+                        endian,
+                        metadata.encoding,
+                        &mut tally,
+                    )?;
                 }
-                row_idx += 1;
-                added += 1;
             }
-            if added == 0 {
+            if taken == 0 {
                 break;
             }
+            tally.flush();
             let df = finish_batch(builders)?;
             if !on_batch(df) {
                 return Ok(());
@@ -278,18 +295,7 @@ pub fn read_data_frame_streaming(
         // trailer index), but SavRowStream state is maintained across blocks because
         // rows can span block boundaries. Process blocks one at a time and emit a
         // batch whenever batch_size rows have been accumulated.
-        let zheader_ofs = reader.stream_position()?;
-        let zheader = read_zheader(&mut reader, endian)?;
-        if zheader.zheader_ofs != zheader_ofs {
-            return Err(Error::ParseError("invalid zsav header offset".to_string()));
-        }
-        reader.seek(SeekFrom::Start(zheader.ztrailer_ofs))?;
-        let ztrailer = read_ztrailer(&mut reader, endian)?;
-        let n_blocks = ztrailer.n_blocks as usize;
-        let mut entries = Vec::with_capacity(n_blocks);
-        for _ in 0..n_blocks {
-            entries.push(read_ztrailer_entry(&mut reader, endian)?);
-        }
+        let mut blocks = ZsavBlocks::open(&mut reader, endian)?;
 
         let mut stream = SavRowStream::new(endian, bias);
         let mut row_idx = 0usize;
@@ -299,18 +305,7 @@ pub fn read_data_frame_streaming(
         let np = build_numeric_plans(&plans, &builders);
         let mut added = 0usize;
 
-        'blocks: for entry in &entries {
-            reader.seek(SeekFrom::Start(entry.compressed_ofs as u64))?;
-            let mut compressed = vec![0u8; entry.compressed_size as usize];
-            reader.read_exact(&mut compressed)?;
-
-            let mut decoder = ZlibDecoder::new(&compressed[..]);
-            let mut uncompressed = Vec::with_capacity(entry.uncompressed_size as usize);
-            decoder.read_to_end(&mut uncompressed)?;
-            if uncompressed.len() != entry.uncompressed_size as usize {
-                return Err(Error::ParseError("zsav block size mismatch".to_string()));
-            }
-
+        'blocks: while let Some(uncompressed) = blocks.next_block(&mut reader)? {
             let mut input_offset = 0usize;
             while input_offset <= uncompressed.len() {
                 let status = stream.decompress_from_slice(
@@ -318,20 +313,29 @@ pub fn read_data_frame_streaming(
                     &mut input_offset,
                     &mut row_buf,
                     &mut out_offset,
+                    &mut tally,
                 )?;
                 match status {
                     StreamStatus::NeedData => break,
                     StreamStatus::FinishedAll => break 'blocks,
                     StreamStatus::FinishedRow => {
                         out_offset = 0;
-                        if row_idx >= start_row && row_idx < end_row {
+                        if row_idx >= start_row && row_idx < end_row && keep_row(&row_buf) {
                             if let Some(np) = np.as_deref() {
                                 append_numeric_row(&mut builders, &plans, np, &row_buf, endian)?;
                             } else {
-                                append_row(&mut builders, &plans, &row_buf, endian, metadata.encoding)?;
+                                append_row(
+                                    &mut builders,
+                                    &plans,
+                                    &row_buf,
+                                    endian,
+                                    metadata.encoding,
+                                    &mut tally,
+                                )?;
                             }
                             added += 1;
                             if added >= batch_size {
+                                tally.flush();
                                 let df = finish_batch(builders)?;
                                 if !on_batch(df) {
                                     return Ok(());
@@ -350,6 +354,7 @@ pub fn read_data_frame_streaming(
         }
 
         if added > 0 {
+            tally.flush();
             let df = finish_batch(builders)?;
             on_batch(df);
         }
@@ -366,6 +371,7 @@ pub fn read_data_frame_streaming(
             limit,
             missing_string_as_null,
             value_labels_as_strings,
+            value_labels_as_categorical,
         )?;
         let height = df.height();
         let mut off = 0usize;
@@ -383,7 +389,7 @@ pub fn read_data_frame_streaming(
 }
 
 pub fn read_data_frame_with_reader(
-    reader: &mut BufReader<File>,
+    reader: &mut FileSource,
     metadata: &Metadata,
     endian: Endian,
     compression: i32,
@@ -393,7 +399,9 @@ pub fn read_data_frame_with_reader(
     limit: usize,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
 ) -> Result<DataFrame> {
+    let _decode = read_profile::span(ProfileStage::RowDecode);
     let data_offset = metadata
         .data_offset
         .ok_or_else(|| Error::ParseError("missing data offset".to_string()))?;
@@ -427,7 +435,11 @@ pub fn read_data_frame_with_reader(
     };
 
     let label_maps = if value_labels_as_strings {
-        build_label_maps(metadata, needed_label_names.as_ref())
+        build_label_maps(
+            metadata,
+            needed_label_names.as_ref(),
+            value_labels_as_categorical,
+        )
     } else {
         std::collections::HashMap::new()
     };
@@ -444,30 +456,23 @@ pub fn read_data_frame_with_reader(
             .and_then(|name| label_maps.get(name))
             .cloned();
         let builder = match (var.var_type, label_map.is_some() && value_labels_as_strings) {
-            (VarType::Numeric, true) => ColumnBuilder::Utf8 {
-                builder: StringChunkedBuilder::new(name.into(), limit),
-                num_cache: Some(NumericStringCache::new()),
-            },
+            (VarType::Numeric, true) => labelled_numeric_builder(name, limit, label_map.as_deref()),
             (VarType::Numeric, false) => match var.format_class {
-                Some(FormatClass::Date) => ColumnBuilder::Date(
-                    PrimitiveChunkedBuilder::<Int32Type>::new(name.into(), limit),
-                ),
-                Some(FormatClass::DateTime) => ColumnBuilder::DateTime(PrimitiveChunkedBuilder::<
-                    Int64Type,
-                >::new(
-                    name.into(), limit
-                )),
-                Some(FormatClass::Time) => ColumnBuilder::Time(
-                    PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), limit),
-                ),
-                None => ColumnBuilder::Float64(PrimitiveChunkedBuilder::<Float64Type>::new(
-                    name.into(),
-                    limit,
-                )),
+                Some(FormatClass::Date) => {
+                    ColumnBuilder::Date(NumericColumnBuilder::new(name.into(), limit))
+                }
+                Some(FormatClass::DateTime) => {
+                    ColumnBuilder::DateTime(NumericColumnBuilder::new(name.into(), limit))
+                }
+                Some(FormatClass::Time) => {
+                    ColumnBuilder::Time(NumericColumnBuilder::new(name.into(), limit))
+                }
+                None => ColumnBuilder::Float64(NumericColumnBuilder::new(name.into(), limit)),
             },
             (VarType::Str, _) => ColumnBuilder::Utf8 {
                 builder: StringChunkedBuilder::new(name.into(), limit),
                 num_cache: None,
+                interner: Some(StringInterner::new()),
             },
         };
         let missing_set = if var.missing_strings.is_empty() {
@@ -488,6 +493,7 @@ pub fn read_data_frame_with_reader(
     }
 
     let numeric_plans = build_numeric_plans(&plans, &builders);
+    let mut tally = Tally::new();
 
     if compression == 0 {
         if start_row > 0 {
@@ -500,7 +506,14 @@ pub fn read_data_frame_with_reader(
             if let Some(numeric_plans) = numeric_plans.as_deref() {
                 append_numeric_row(&mut builders, &plans, numeric_plans, &row_buf, endian)?;
             } else {
-                append_row(&mut builders, &plans, &row_buf, endian, metadata.encoding)?;
+                append_row(
+                    &mut builders,
+                    &plans,
+                    &row_buf,
+                    endian,
+                    metadata.encoding,
+                    &mut tally,
+                )?;
             }
         }
     } else if compression == 1 {
@@ -508,7 +521,7 @@ pub fn read_data_frame_with_reader(
         let mut decompressor = SavRowDecompressor::new(endian, bias);
         let mut row_idx = 0usize;
         while row_idx < end_row {
-            let status = decompressor.read_row(reader, &mut row_buf, record_len)?;
+            let status = decompressor.read_row(reader, &mut row_buf, record_len, &mut tally)?;
             if status == DecompressStatus::FinishedAll {
                 break;
             }
@@ -516,7 +529,14 @@ pub fn read_data_frame_with_reader(
                 if let Some(numeric_plans) = numeric_plans.as_deref() {
                     append_numeric_row(&mut builders, &plans, numeric_plans, &row_buf, endian)?;
                 } else {
-                    append_row(&mut builders, &plans, &row_buf, endian, metadata.encoding)?;
+                    append_row(
+                        &mut builders,
+                        &plans,
+                        &row_buf,
+                        endian,
+                        metadata.encoding,
+                        &mut tally,
+                    )?;
                 }
             }
             row_idx += 1;
@@ -561,6 +581,7 @@ pub fn read_data_columns_uncompressed(
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
 ) -> Result<Vec<Series>> {
+    let _decode = read_profile::span(ProfileStage::RowDecode);
     let data_offset = metadata
         .data_offset
         .ok_or_else(|| Error::ParseError("missing data offset".to_string()))?;
@@ -596,7 +617,7 @@ pub fn read_data_columns_uncompressed(
     };
 
     let label_maps = if value_labels_as_strings {
-        build_label_maps(metadata, needed_label_names.as_ref())
+        build_label_maps(metadata, needed_label_names.as_ref(), false)
     } else {
         std::collections::HashMap::new()
     };
@@ -613,30 +634,23 @@ pub fn read_data_columns_uncompressed(
             .and_then(|name| label_maps.get(name))
             .cloned();
         let builder = match (var.var_type, label_map.is_some() && value_labels_as_strings) {
-            (VarType::Numeric, true) => ColumnBuilder::Utf8 {
-                builder: StringChunkedBuilder::new(name.into(), limit),
-                num_cache: Some(NumericStringCache::new()),
-            },
+            (VarType::Numeric, true) => labelled_numeric_builder(name, limit, label_map.as_deref()),
             (VarType::Numeric, false) => match var.format_class {
-                Some(FormatClass::Date) => ColumnBuilder::Date(
-                    PrimitiveChunkedBuilder::<Int32Type>::new(name.into(), limit),
-                ),
-                Some(FormatClass::DateTime) => ColumnBuilder::DateTime(PrimitiveChunkedBuilder::<
-                    Int64Type,
-                >::new(
-                    name.into(), limit
-                )),
-                Some(FormatClass::Time) => ColumnBuilder::Time(
-                    PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), limit),
-                ),
-                None => ColumnBuilder::Float64(PrimitiveChunkedBuilder::<Float64Type>::new(
-                    name.into(),
-                    limit,
-                )),
+                Some(FormatClass::Date) => {
+                    ColumnBuilder::Date(NumericColumnBuilder::new(name.into(), limit))
+                }
+                Some(FormatClass::DateTime) => {
+                    ColumnBuilder::DateTime(NumericColumnBuilder::new(name.into(), limit))
+                }
+                Some(FormatClass::Time) => {
+                    ColumnBuilder::Time(NumericColumnBuilder::new(name.into(), limit))
+                }
+                None => ColumnBuilder::Float64(NumericColumnBuilder::new(name.into(), limit)),
             },
             (VarType::Str, _) => ColumnBuilder::Utf8 {
                 builder: StringChunkedBuilder::new(name.into(), limit),
                 num_cache: None,
+                interner: Some(StringInterner::new()),
             },
         };
         let missing_set = if var.missing_strings.is_empty() {
@@ -661,9 +675,17 @@ pub fn read_data_columns_uncompressed(
         reader.seek(SeekFrom::Current(byte_skip as i64))?;
     }
     let mut row_buf = vec![0u8; record_len];
+    let mut tally = Tally::new();
     for _row_idx in start_row..end_row {
         reader.read_exact(&mut row_buf)?;
-        append_row(&mut builders, &plans, &row_buf, endian, metadata.encoding)?;
+        append_row(
+            &mut builders,
+            &plans,
+            &row_buf,
+            endian,
+            metadata.encoding,
+            &mut tally,
+        )?;
     }
 
     let mut cols = Vec::with_capacity(builders.len());
@@ -679,10 +701,11 @@ fn append_row(
     row_buf: &[u8],
     endian: Endian,
     encoding: &'static encoding_rs::Encoding,
+    tally: &mut Tally,
 ) -> Result<()> {
     for (i, plan) in plans.iter().enumerate() {
         let slice = &row_buf[plan.offset..plan.offset + plan.width];
-        append_value(&mut builders[i], plan, slice, endian, encoding)?;
+        append_value(&mut builders[i], plan, slice, endian, encoding, tally)?;
     }
     Ok(())
 }
@@ -747,20 +770,97 @@ fn append_numeric_row(
     Ok(())
 }
 
+/// Column-at-a-time variant of `append_numeric_row` for a block of `record_len`-byte
+/// rows. The block is transposed tile by tile into per-column strips; each column's
+/// missing-value rules are resolved once, so the per-value body is a load, byte
+/// swap and compare over a dense strip.
+fn append_numeric_rows(
+    builders: &mut [ColumnBuilder],
+    plans: &[ColumnPlan],
+    numeric_plans: &[NumericPlan],
+    rows: &[u8],
+    record_len: usize,
+    endian: Endian,
+    strips: &mut ColumnStrips,
+) -> Result<()> {
+    let mut fields = Vec::with_capacity(numeric_plans.len());
+    for plan in numeric_plans {
+        let col_plan = &plans[plan.plan_idx];
+        if col_plan.width < 8 || col_plan.offset + 8 > record_len {
+            return Err(Error::ParseError("short numeric value".to_string()));
+        }
+        fields.push(FieldSpan {
+            start: col_plan.offset,
+            width: 8,
+        });
+    }
+    let tile_len = crate::transpose::tile_rows(record_len) * record_len;
+    for tile in rows.chunks(tile_len) {
+        strips.fill(tile, record_len, &fields);
+        for (i, plan) in numeric_plans.iter().enumerate() {
+            let col_plan = &plans[plan.plan_idx];
+            let ColumnBuilder::Float64(b) = &mut builders[plan.builder_idx] else {
+                return Err(Error::ParseError("column type mismatch".to_string()));
+            };
+            match endian {
+                Endian::Little => extend_doubles::<false>(b, strips.strip(i), col_plan),
+                Endian::Big => extend_doubles::<true>(b, strips.strip(i), col_plan),
+            }
+        }
+    }
+    Ok(())
+}
+
+/// Decode a strip of 8-byte doubles into `b` under the missing-value rules of
+/// `plan`. Columns without user missing values only run the sysmis/NaN test.
+#[inline]
+fn extend_doubles<const BIG: bool>(
+    b: &mut NumericColumnBuilder<Float64Type>,
+    strip: &[u8],
+    plan: &ColumnPlan,
+) {
+    #[inline(always)]
+    fn load<const BIG: bool>(cell: &[u8; 8]) -> (f64, u64) {
+        let bits = if BIG {
+            u64::from_be_bytes(*cell)
+        } else {
+            u64::from_le_bytes(*cell)
+        };
+        (f64::from_bits(bits), bits)
+    }
+    let format_class = plan.format_class;
+    // Missing cells convert a placeholder so the date shifts cannot overflow.
+    if plan.missing_doubles.is_empty() {
+        b.extend_cells::<8, _>(strip, |cell| {
+            let (v, bits) = load::<BIG>(cell);
+            // Sysmis, LOWEST/HIGHEST and every NaN, as in `is_missing_numeric`.
+            let missing = bits == SAV_MISSING_DOUBLE
+                || bits == SAV_LOWEST_DOUBLE
+                || bits == SAV_HIGHEST_DOUBLE
+                || v.is_nan();
+            let v = if missing { 0.0 } else { v };
+            (apply_format_class(v, format_class), !missing)
+        });
+    } else {
+        b.extend_cells::<8, _>(strip, |cell| {
+            let (v, bits) = load::<BIG>(cell);
+            let missing = is_missing_numeric(plan, v, bits);
+            let v = if missing { 0.0 } else { v };
+            (apply_format_class(v, format_class), !missing)
+        });
+    }
+}
+
 fn append_value(
     builder: &mut ColumnBuilder,
     plan: &ColumnPlan,
     buf: &[u8],
     endian: Endian,
     encoding: &'static encoding_rs::Encoding,
+    tally: &mut Tally,
 ) -> Result<()> {
     match (builder, plan.var_type) {
         (ColumnBuilder::Float64(b), VarType::Numeric) => {
-            let t0 = if profile_enabled() {
-                Some(Instant::now())
-            } else {
-                None
-            };
             let bytes: [u8; 8] = buf[..8]
                 .try_into()
                 .map_err(|_| Error::ParseError("short numeric value".to_string()))?;
@@ -774,10 +874,6 @@ fn append_value(
             } else {
                 b.append_value(apply_format_class(v, plan.format_class));
             }
-            if let Some(t0) = t0 {
-                add_ns(&PROFILE_NUM_NS, t0.elapsed());
-                PROFILE_NUM_CT.fetch_add(1, Ordering::Relaxed);
-            }
         }
         (ColumnBuilder::Date(b), VarType::Numeric) => {
             let bytes: [u8; 8] = buf[..8]
@@ -824,12 +920,25 @@ fn append_value(
                 b.append_value(apply_format_class_time(v));
             }
         }
-        (ColumnBuilder::Utf8 { builder, num_cache }, VarType::Numeric) => {
-            let t0 = if profile_enabled() {
-                Some(Instant::now())
-            } else {
-                None
+        (ColumnBuilder::Categorical(b), VarType::Numeric) => {
+            let bytes: [u8; 8] = buf[..8]
+                .try_into()
+                .map_err(|_| Error::ParseError("short numeric value".to_string()))?;
+            let v = match endian {
+                Endian::Little => f64::from_le_bytes(bytes),
+                Endian::Big => f64::from_be_bytes(bytes),
             };
+            let bits = v.to_bits();
+            match plan
+                .label_map
+                .as_deref()
+                .and_then(LabelMap::categorical_labels)
+            {
+                Some(labels) if !is_missing_numeric(plan, v, bits) => b.append_bits(bits, labels),
+                _ => b.append_null(),
+            }
+        }
+        (ColumnBuilder::Utf8 { builder, num_cache }, VarType::Numeric) => {
             let bytes: [u8; 8] = buf[..8]
                 .try_into()
                 .map_err(|_| Error::ParseError("short numeric value".to_string()))?;
@@ -841,15 +950,7 @@ fn append_value(
             if is_missing_numeric(plan, v, bits) {
                 builder.append_null();
             } else if let Some(labels) = plan.label_map.as_deref() {
-                let t_label = if profile_enabled() {
-                    Some(Instant::now())
-                } else {
-                    None
-                };
-                let label = labels.get_float_bits(bits);
-                if let Some(t_label) = t_label {
-                    add_ns(&PROFILE_LABEL_NS, t_label.elapsed());
-                }
+                let label = tally.time(ProfileStage::LabelMap, || labels.get_float_bits(bits));
                 if let Some(label) = label {
                     builder.append_value(label);
                 } else {
@@ -880,21 +981,18 @@ fn append_value(
                     builder.append_value(&v.to_string());
                 }
             }
-            if let Some(t0) = t0 {
-                add_ns(&PROFILE_NUM_NS, t0.elapsed());
-                PROFILE_NUM_CT.fetch_add(1, Ordering::Relaxed);
-            }
         }
-        (ColumnBuilder::Utf8 { builder, .. }, VarType::Str) => {
-            let t0 = if profile_enabled() {
-                Some(Instant::now())
-            } else {
-                None
-            };
+        (
+            ColumnBuilder::Utf8 {
+                builder, interner, ..
+            },
+            VarType::Str,
+        ) => {
             if plan.missing_string_as_null && buf.iter().all(|b| *b == b' ' || *b == 0) {
                 builder.append_null();
                 return Ok(());
             }
+            let decode = tally.start();
 
             let long_string_storage;
             let raw = if plan.string_len_bytes > 255 {
@@ -931,12 +1029,8 @@ fn append_value(
             while end > 0 && (raw[end - 1] == b' ' || raw[end - 1] == 0) {
                 end -= 1;
             }
-            let t_decode = if profile_enabled() {
-                Some(Instant::now())
-            } else {
-                None
-            };
             let s_owned;
+            let s_interned;
             let s = if encoding == encoding_rs::UTF_8 {
                 let slice = &raw[..end];
                 match std::str::from_utf8(slice) {
@@ -946,14 +1040,16 @@ fn append_value(
                         std::str::from_utf8(&slice[..valid]).unwrap_or("")
                     }
                 }
+            } else if let Some(interner) = interner.as_mut() {
+                s_interned =
+                    interner.decode(&raw[..end], |b| encoding.decode_without_bom_handling(b).0);
+                &*s_interned
             } else {
                 let decoded = encoding.decode_without_bom_handling(&raw[..end]).0;
                 s_owned = decoded.into_owned();
                 s_owned.as_str()
             };
-            if let Some(t_decode) = t_decode {
-                add_ns(&PROFILE_DECODE_NS, t_decode.elapsed());
-            }
+            tally.stop(ProfileStage::StringDecode, decode);
 
             if plan.fast_no_checks {
                 builder.append_value(s);
@@ -968,15 +1064,7 @@ fn append_value(
             if is_missing {
                 builder.append_null();
             } else if let Some(labels) = plan.label_map.as_deref() {
-                let t_label = if profile_enabled() {
-                    Some(Instant::now())
-                } else {
-                    None
-                };
-                let label = labels.get_str(s);
-                if let Some(t_label) = t_label {
-                    add_ns(&PROFILE_LABEL_NS, t_label.elapsed());
-                }
+                let label = tally.time(ProfileStage::LabelMap, || labels.get_str(s));
                 if let Some(label) = label {
                     builder.append_value(label);
                 } else {
@@ -985,10 +1073,6 @@ fn append_value(
             } else {
                 builder.append_value(s);
             }
-            if let Some(t0) = t0 {
-                add_ns(&PROFILE_STR_NS, t0.elapsed());
-                PROFILE_STR_CT.fetch_add(1, Ordering::Relaxed);
-            }
         }
         _ => return Err(Error::ParseError("column type mismatch".to_string())),
     }
@@ -1101,61 +1185,72 @@ fn missing_numeric_indicator(plan: &ColumnPlan, v: f64, bits: u64) -> Option<Str
     }
 }
 
-/// Compute the informative-null indicator string for a single column value from raw row bytes.
-/// Returns `None` if not a user-declared missing (or if no indicator tracking is configured).
-fn compute_col_indicator(
+/// Append the informative-null indicator of a single column value from raw row bytes: null
+/// unless the value is a user-declared missing. Numeric labels are computed once per raw value.
+fn push_col_indicator(
+    ind_b: &mut IndicatorBuilder,
     plan: &ColumnPlan,
     buf: &[u8],
     endian: Endian,
     encoding: &'static encoding_rs::Encoding,
-) -> Option<String> {
+) {
     match plan.var_type {
+        VarType::Str => match string_col_indicator(plan, buf, encoding) {
+            Some(s) => ind_b.push_label(s),
+            None => ind_b.push_null(),
+        },
         VarType::Numeric => {
-            if buf.len() < 8 {
-                return None;
-            }
-            let bytes: [u8; 8] = buf[..8].try_into().ok()?;
+            let Some(bytes) = buf.get(..8).and_then(|b| <[u8; 8]>::try_from(b).ok()) else {
+                ind_b.push_null();
+                return;
+            };
             let v = match endian {
                 Endian::Little => f64::from_le_bytes(bytes),
                 Endian::Big => f64::from_be_bytes(bytes),
             };
             let bits = v.to_bits();
             if is_missing_numeric(plan, v, bits) {
-                missing_numeric_indicator(plan, v, bits)
+                ind_b.push_keyed(bits, || missing_numeric_indicator(plan, v, bits));
             } else {
-                None
+                ind_b.push_null();
             }
         }
-        VarType::Str => {
-            let missing_set = plan.missing_set.as_ref()?;
-            // Trim trailing spaces and nulls
-            let mut end = buf.len();
-            while end > 0 && (buf[end - 1] == b' ' || buf[end - 1] == 0) {
-                end -= 1;
-            }
-            if end == 0 {
-                return None; // empty → system-missing-like, no indicator
-            }
-            let s: String = if encoding == encoding_rs::UTF_8 {
-                let filtered: Vec<u8> = buf[..end].iter().filter(|&&b| b != 0).copied().collect();
-                String::from_utf8_lossy(&filtered).into_owned()
-            } else {
-                encoding
-                    .decode_without_bom_handling(&buf[..end])
-                    .0
-                    .into_owned()
-            };
-            if missing_set.contains(s.as_str()) {
-                if let Some(label_map) = plan.label_map.as_deref() {
-                    if let Some(label) = label_map.get_str(&s) {
-                        return Some(label.clone());
-                    }
-                }
-                Some(s)
-            } else {
-                None
+    }
+}
+
+/// Indicator string of a string column value; `None` if not a user-declared missing.
+fn string_col_indicator(
+    plan: &ColumnPlan,
+    buf: &[u8],
+    encoding: &'static encoding_rs::Encoding,
+) -> Option<String> {
+    let missing_set = plan.missing_set.as_ref()?;
+    // Trim trailing spaces and nulls
+    let mut end = buf.len();
+    while end > 0 && (buf[end - 1] == b' ' || buf[end - 1] == 0) {
+        end -= 1;
+    }
+    if end == 0 {
+        return None; // empty → system-missing-like, no indicator
+    }
+    let s: String = if encoding == encoding_rs::UTF_8 {
+        let filtered: Vec<u8> = buf[..end].iter().filter(|&&b| b != 0).copied().collect();
+        String::from_utf8_lossy(&filtered).into_owned()
+    } else {
+        encoding
+            .decode_without_bom_handling(&buf[..end])
+            .0
+            .into_owned()
+    };
+    if missing_set.contains(s.as_str()) {
+        if let Some(label_map) = plan.label_map.as_deref() {
+            if let Some(label) = label_map.get_str(&s) {
+                return Some(label.clone());
             }
         }
+        Some(s)
+    } else {
+        None
     }
 }
 
@@ -1163,22 +1258,19 @@ fn compute_col_indicator(
 /// `ind_builders[i]` is `Some(builder)` when column i is tracked for informative nulls.
 fn append_row_with_indicators(
     builders: &mut [ColumnBuilder],
-    ind_builders: &mut [Option<StringChunkedBuilder>],
+    ind_builders: &mut [Option<IndicatorBuilder>],
     plans: &[ColumnPlan],
     row_buf: &[u8],
     endian: Endian,
     encoding: &'static encoding_rs::Encoding,
+    tally: &mut Tally,
 ) -> Result<()> {
     for (i, plan) in plans.iter().enumerate() {
         let slice = &row_buf[plan.offset..plan.offset + plan.width];
         if let Some(ind_b) = ind_builders[i].as_mut() {
-            let indicator = compute_col_indicator(plan, slice, endian, encoding);
-            match indicator {
-                Some(s) => ind_b.append_value(&s),
-                None => ind_b.append_null(),
-            }
+            push_col_indicator(ind_b, plan, slice, endian, encoding);
         }
-        append_value(&mut builders[i], plan, slice, endian, encoding)?;
+        append_value(&mut builders[i], plan, slice, endian, encoding, tally)?;
     }
     Ok(())
 }
@@ -1192,41 +1284,18 @@ fn read_zsav_data_with_indicators<R: Read + Seek>(
     end_row: usize,
     plans: &[ColumnPlan],
     builders: &mut [ColumnBuilder],
-    ind_builders: &mut [Option<StringChunkedBuilder>],
+    ind_builders: &mut [Option<IndicatorBuilder>],
     row_buf: &mut [u8],
     encoding: &'static encoding_rs::Encoding,
 ) -> Result<()> {
-    let zheader_ofs = reader.stream_position()?;
-    let zheader = read_zheader(reader, endian)?;
-    if zheader.zheader_ofs != zheader_ofs {
-        return Err(Error::ParseError("invalid zsav header offset".to_string()));
-    }
-
-    reader.seek(SeekFrom::Start(zheader.ztrailer_ofs))?;
-    let ztrailer = read_ztrailer(reader, endian)?;
-    let n_blocks = ztrailer.n_blocks as usize;
-
-    let mut entries = Vec::with_capacity(n_blocks);
-    for _ in 0..n_blocks {
-        entries.push(read_ztrailer_entry(reader, endian)?);
-    }
+    let mut blocks = ZsavBlocks::open(reader, endian)?;
 
     let mut stream = SavRowStream::new(endian, bias);
     let mut row_idx = 0usize;
     let mut out_offset = 0usize;
+    let mut tally = Tally::new();
 
-    for entry in entries {
-        reader.seek(SeekFrom::Start(entry.compressed_ofs as u64))?;
-        let mut compressed = vec![0u8; entry.compressed_size as usize];
-        reader.read_exact(&mut compressed)?;
-
-        let mut decoder = ZlibDecoder::new(&compressed[..]);
-        let mut uncompressed = Vec::with_capacity(entry.uncompressed_size as usize);
-        decoder.read_to_end(&mut uncompressed)?;
-        if uncompressed.len() != entry.uncompressed_size as usize {
-            return Err(Error::ParseError("zsav block size mismatch".to_string()));
-        }
-
+    while let Some(uncompressed) = blocks.next_block(reader)? {
         let mut input_offset = 0usize;
         while input_offset <= uncompressed.len() {
             let status = stream.decompress_from_slice(
@@ -1234,6 +1303,7 @@ fn read_zsav_data_with_indicators<R: Read + Seek>(
                 &mut input_offset,
                 row_buf,
                 &mut out_offset,
+                &mut tally,
             )?;
             match status {
                 StreamStatus::NeedData => break,
@@ -1247,6 +1317,7 @@ fn read_zsav_data_with_indicators<R: Read + Seek>(
                             row_buf,
                             endian,
                             encoding,
+                            &mut tally,
                         )?;
                     }
                     row_idx += 1;
@@ -1268,7 +1339,8 @@ fn read_zsav_data_with_indicators<R: Read + Seek>(
 /// named `name` immediately after column i, or `None` to skip.
 ///
 /// Indicator columns are of type `String?` (null = not a user-declared missing; `Some(str)` =
-/// the indicator label/value).
+/// the indicator label/value). As in [`read_data_frame_streaming`], a `sav_index` lets a
+/// compressed read start at the nearest checkpoint instead of row 0.
 pub fn read_data_frame_with_indicators(
     path: &Path,
     metadata: &Metadata,
@@ -1280,8 +1352,12 @@ pub fn read_data_frame_with_indicators(
     limit: usize,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     indicator_col_names: &[Option<String>],
+    sav_index: Option<&SavRowIndex>,
+    map: Option<&SharedInput>,
 ) -> Result<DataFrame> {
+    let _decode = read_profile::span(ProfileStage::RowDecode);
     let data_offset = metadata
         .data_offset
         .ok_or_else(|| Error::ParseError("missing data offset".to_string()))?;
@@ -1291,8 +1367,7 @@ pub fn read_data_frame_with_indicators(
         .map(|v| v.width * 8)
         .sum::<usize>();
 
-    let file = File::open(path)?;
-    let mut reader = BufReader::with_capacity(8 * 1024 * 1024, file);
+    let mut reader = FileSource::open(path, 8 * 1024 * 1024, map)?;
     reader.seek(SeekFrom::Start(data_offset))?;
 
     let total_rows = metadata.row_count as usize;
@@ -1317,14 +1392,18 @@ pub fn read_data_frame_with_indicators(
     };
 
     let label_maps = if value_labels_as_strings {
-        build_label_maps(metadata, needed_label_names.as_ref())
+        build_label_maps(
+            metadata,
+            needed_label_names.as_ref(),
+            value_labels_as_categorical,
+        )
     } else {
         std::collections::HashMap::new()
     };
 
     let mut builders = Vec::with_capacity(col_indices.len());
     let mut plans = Vec::with_capacity(col_indices.len());
-    let mut ind_builders: Vec<Option<StringChunkedBuilder>> = Vec::with_capacity(col_indices.len());
+    let mut ind_builders: Vec<Option<IndicatorBuilder>> = Vec::with_capacity(col_indices.len());
 
     for (local_i, &idx) in col_indices.iter().enumerate() {
         let var = &metadata.variables[idx];
@@ -1335,30 +1414,23 @@ pub fn read_data_frame_with_indicators(
             .and_then(|lname| label_maps.get(lname))
             .cloned();
         let builder = match (var.var_type, label_map.is_some() && value_labels_as_strings) {
-            (VarType::Numeric, true) => ColumnBuilder::Utf8 {
-                builder: StringChunkedBuilder::new(name.into(), limit),
-                num_cache: Some(NumericStringCache::new()),
-            },
+            (VarType::Numeric, true) => labelled_numeric_builder(name, limit, label_map.as_deref()),
             (VarType::Numeric, false) => match var.format_class {
-                Some(FormatClass::Date) => ColumnBuilder::Date(
-                    PrimitiveChunkedBuilder::<Int32Type>::new(name.into(), limit),
-                ),
-                Some(FormatClass::DateTime) => ColumnBuilder::DateTime(PrimitiveChunkedBuilder::<
-                    Int64Type,
-                >::new(
-                    name.into(), limit
-                )),
-                Some(FormatClass::Time) => ColumnBuilder::Time(
-                    PrimitiveChunkedBuilder::<Int64Type>::new(name.into(), limit),
-                ),
-                None => ColumnBuilder::Float64(PrimitiveChunkedBuilder::<Float64Type>::new(
-                    name.into(),
-                    limit,
-                )),
+                Some(FormatClass::Date) => {
+                    ColumnBuilder::Date(NumericColumnBuilder::new(name.into(), limit))
+                }
+                Some(FormatClass::DateTime) => {
+                    ColumnBuilder::DateTime(NumericColumnBuilder::new(name.into(), limit))
+                }
+                Some(FormatClass::Time) => {
+                    ColumnBuilder::Time(NumericColumnBuilder::new(name.into(), limit))
+                }
+                None => ColumnBuilder::Float64(NumericColumnBuilder::new(name.into(), limit)),
             },
             (VarType::Str, _) => ColumnBuilder::Utf8 {
                 builder: StringChunkedBuilder::new(name.into(), limit),
                 num_cache: None,
+                interner: Some(StringInterner::new()),
             },
         };
         let missing_set = if var.missing_strings.is_empty() {
@@ -1377,11 +1449,12 @@ pub fn read_data_frame_with_indicators(
         let ind_builder = indicator_col_names
             .get(local_i)
             .and_then(|opt| opt.as_ref())
-            .map(|ind_name| StringChunkedBuilder::new(ind_name.as_str().into(), limit));
+            .map(|ind_name| IndicatorBuilder::new(ind_name.as_str().into(), limit));
         builders.push(builder);
         plans.push(plan);
         ind_builders.push(ind_builder);
     }
+    let mut tally = Tally::new();
 
     if compression == 0 {
         if start_row > 0 {
@@ -1398,14 +1471,22 @@ pub fn read_data_frame_with_indicators(
                 &row_buf,
                 endian,
                 metadata.encoding,
+                &mut tally,
             )?;
         }
     } else if compression == 1 {
         let mut row_buf = vec![0u8; record_len];
         let mut decompressor = SavRowDecompressor::new(endian, bias);
         let mut row_idx = 0usize;
+        if let Some(cp) = sav_index.and_then(|index| index.locate(start_row)) {
+            reader.seek(SeekFrom::Start(cp.pos))?;
+            decompressor.control_chunk = cp.control_chunk;
+            decompressor.control_i = cp.control_i;
+            row_idx = cp.row;
+        }
         while row_idx < end_row {
-            let status = decompressor.read_row(&mut reader, &mut row_buf, record_len)?;
+            let status =
+                decompressor.read_row(&mut reader, &mut row_buf, record_len, &mut tally)?;
             if status == DecompressStatus::FinishedAll {
                 break;
             }
@@ -1417,6 +1498,7 @@ pub fn read_data_frame_with_indicators(
                     &row_buf,
                     endian,
                     metadata.encoding,
+                    &mut tally,
                 )?;
             }
             row_idx += 1;
@@ -1448,7 +1530,7 @@ pub fn read_data_frame_with_indicators(
     for (b, ind_b) in builders.into_iter().zip(ind_builders.into_iter()) {
         cols.push(b.finish().into());
         if let Some(ind_b) = ind_b {
-            cols.push(Column::from(ind_b.finish().into_series()));
+            cols.push(Column::from(ind_b.finish()));
         }
     }
     DataFrame::new_infer_height(cols).map_err(|e| Error::ParseError(e.to_string()))
@@ -1526,15 +1608,177 @@ impl ColumnPlan {
     }
 }
 
+/// A [`RowFilter`](crate::RowFilter) compiled against the SAV record layout.
+///
+/// Only plain numeric and string columns take part: date/time-formatted columns and
+/// columns emitted as value labels are skipped, and callers re-apply the full predicate.
+struct SpssRowFilter {
+    terms: Vec<(ColumnPlan, crate::row_filter::FilterTest)>,
+}
+
+impl SpssRowFilter {
+    fn compile(
+        filter: &crate::RowFilter,
+        metadata: &Metadata,
+        missing_string_as_null: bool,
+        label_maps: &std::collections::HashMap<String, Arc<LabelMap>>,
+    ) -> Option<Self> {
+        let mut terms = Vec::new();
+        for (name, test) in filter.terms() {
+            let Some(var) = metadata.variables.iter().find(|v| v.name == name) else {
+                continue;
+            };
+            let labelled = var
+                .value_label
+                .as_ref()
+                .is_some_and(|n| label_maps.contains_key(n));
+            let eligible = match var.var_type {
+                VarType::Numeric => var.format_class.is_none() && test.is_numeric(),
+                VarType::Str => !test.is_numeric(),
+            };
+            if labelled || !eligible {
+                continue;
+            }
+            let missing_set = if var.missing_strings.is_empty() {
+                None
+            } else {
+                Some(var.missing_strings.iter().cloned().collect::<HashSet<_>>())
+            };
+            let plan = ColumnPlan::new(
+                var,
+                var.offset * 8,
+                var.width * 8,
+                None,
+                missing_set,
+                missing_string_as_null,
+            );
+            terms.push((plan, test));
+        }
+        if terms.is_empty() {
+            None
+        } else {
+            Some(Self { terms })
+        }
+    }
+
+    /// Whether the raw row can satisfy the filter. Values are decoded with the same
+    /// missing-value and trimming rules as `append_value`.
+    fn matches(
+        &self,
+        row_buf: &[u8],
+        endian: Endian,
+        encoding: &'static encoding_rs::Encoding,
+    ) -> bool {
+        self.terms.iter().all(|(plan, test)| {
+            let buf = &row_buf[plan.offset..plan.offset + plan.width];
+            match plan.var_type {
+                VarType::Numeric => {
+                    let Ok(bytes) = <[u8; 8]>::try_from(&buf[..8]) else {
+                        return true;
+                    };
+                    let v = match endian {
+                        Endian::Little => f64::from_le_bytes(bytes),
+                        Endian::Big => f64::from_be_bytes(bytes),
+                    };
+                    test.eval_num((!is_missing_numeric(plan, v, v.to_bits())).then_some(v))
+                }
+                VarType::Str => test.eval_str(filter_string_value(plan, buf, encoding).as_deref()),
+            }
+        })
+    }
+}
+
+/// Decode a string cell for filtering; `None` when `append_value` would emit null.
+fn filter_string_value<'a>(
+    plan: &ColumnPlan,
+    buf: &'a [u8],
+    encoding: &'static encoding_rs::Encoding,
+) -> Option<std::borrow::Cow<'a, str>> {
+    use std::borrow::Cow;
+    if plan.missing_string_as_null && buf.iter().all(|b| *b == b' ' || *b == 0) {
+        return None;
+    }
+    let mut raw: Cow<'a, [u8]> = if plan.string_len_bytes > 255 {
+        Cow::Owned(reconstruct_very_long_string_bytes(
+            buf,
+            plan.string_len_bytes,
+        ))
+    } else if plan.string_len_bytes > 0 {
+        Cow::Borrowed(&buf[..plan.string_len_bytes.min(buf.len())])
+    } else {
+        Cow::Borrowed(buf)
+    };
+    if encoding == encoding_rs::UTF_8 && raw.iter().any(|b| *b == 0) {
+        raw = Cow::Owned(raw.iter().copied().filter(|b| *b != 0).collect());
+    }
+    let mut end = raw.len();
+    while end > 0 && (raw[end - 1] == b' ' || raw[end - 1] == 0) {
+        end -= 1;
+    }
+    let s: Cow<'a, str> = match raw {
+        Cow::Borrowed(bytes) if encoding == encoding_rs::UTF_8 => {
+            let slice = &bytes[..end];
+            Cow::Borrowed(match std::str::from_utf8(slice) {
+                Ok(s) => s,
+                Err(err) => std::str::from_utf8(&slice[..err.valid_up_to()]).unwrap_or(""),
+            })
+        }
+        Cow::Owned(bytes) if encoding == encoding_rs::UTF_8 => {
+            let slice = &bytes[..end];
+            Cow::Owned(match std::str::from_utf8(slice) {
+                Ok(s) => s.to_string(),
+                Err(err) => std::str::from_utf8(&slice[..err.valid_up_to()])
+                    .unwrap_or("")
+                    .to_string(),
+            })
+        }
+        raw => Cow::Owned(
+            encoding
+                .decode_without_bom_handling(&raw[..end])
+                .0
+                .into_owned(),
+        ),
+    };
+    let is_missing = (plan.missing_string_as_null && s.is_empty())
+        || plan
+            .missing_set
+            .as_ref()
+            .map_or(false, |set| set.contains(s.as_ref()));
+    if is_missing {
+        None
+    } else {
+        Some(s)
+    }
+}
+
 enum ColumnBuilder {
-    Float64(PrimitiveChunkedBuilder<Float64Type>),
-    Date(PrimitiveChunkedBuilder<Int32Type>),
-    DateTime(PrimitiveChunkedBuilder<Int64Type>),
-    Time(PrimitiveChunkedBuilder<Int64Type>),
+    Float64(NumericColumnBuilder<Float64Type>),
+    Date(NumericColumnBuilder<Int32Type>),
+    DateTime(NumericColumnBuilder<Int64Type>),
+    Time(NumericColumnBuilder<Int64Type>),
     Utf8 {
         builder: StringChunkedBuilder,
         num_cache: Option<NumericStringCache>,
+        /// Decode cache for character columns in non-UTF-8 files.
+        interner: Option<StringInterner>,
     },
+    /// Labelled numeric column read as `Categorical` codes.
+    Categorical(CategoricalBuilder),
+}
+
+/// Builder for a numeric column read through its value labels: `Categorical` codes when
+/// the label map carries categories, label strings otherwise.
+fn labelled_numeric_builder(name: &str, cap: usize, label_map: Option<&LabelMap>) -> ColumnBuilder {
+    match label_map.and_then(LabelMap::categorical_labels) {
+        Some(labels) => {
+            ColumnBuilder::Categorical(CategoricalBuilder::new(name.into(), cap, labels))
+        }
+        None => ColumnBuilder::Utf8 {
+            builder: StringChunkedBuilder::new(name.into(), cap),
+            num_cache: Some(NumericStringCache::new()),
+            interner: None,
+        },
+    }
 }
 
 impl ColumnBuilder {
@@ -1548,6 +1792,7 @@ impl ColumnBuilder {
                 .into_series(),
             ColumnBuilder::Time(b) => b.finish().into_time().into_series(),
             ColumnBuilder::Utf8 { builder, .. } => builder.finish().into_series(),
+            ColumnBuilder::Categorical(b) => b.finish(),
         }
     }
 }
@@ -1572,6 +1817,7 @@ impl NumericStringCache {
 struct LabelMap {
     float_map: std::collections::HashMap<u64, String>,
     str_map: std::collections::HashMap<String, String>,
+    categorical_labels: Option<LabelCategories>,
 }
 
 impl LabelMap {
@@ -1590,11 +1836,16 @@ impl LabelMap {
     fn get_str(&self, v: &str) -> Option<&String> {
         self.str_map.get(v)
     }
+
+    fn categorical_labels(&self) -> Option<&LabelCategories> {
+        self.categorical_labels.as_ref()
+    }
 }
 
 fn build_label_maps(
     metadata: &Metadata,
     needed_labels: Option<&HashSet<String>>,
+    as_categorical: bool,
 ) -> std::collections::HashMap<String, std::sync::Arc<LabelMap>> {
     let mut out = std::collections::HashMap::new();
     for vl in &metadata.value_labels {
@@ -1614,11 +1865,38 @@ fn build_label_maps(
                 }
             }
         }
+        if as_categorical {
+            map.categorical_labels = Some(label_categories(vl));
+        }
         out.insert(vl.name.clone(), std::sync::Arc::new(map));
     }
     out
 }
 
+/// Categories for one value label set.
+fn label_categories(vl: &crate::spss::types::ValueLabel) -> LabelCategories {
+    LabelCategories::new(
+        &vl.name,
+        vl.mapping.iter().map(|(key, value)| {
+            let key = match key {
+                crate::spss::types::ValueLabelKey::Double(v) => LabelKey::Num(*v),
+                crate::spss::types::ValueLabelKey::Str(s) => LabelKey::Str(s.as_str()),
+            };
+            (key, value.as_str())
+        }),
+    )
+}
+
+/// dtype of a labelled numeric column read with `value_labels_as_categorical`, or `None`
+/// when `label_name` is not defined in the file.
+pub(crate) fn label_categorical_dtype(metadata: &Metadata, label_name: &str) -> Option<DataType> {
+    let vl = metadata
+        .value_labels
+        .iter()
+        .find(|vl| vl.name == label_name)?;
+    Some(label_categories(vl).dtype().clone())
+}
+
 #[derive(PartialEq, Eq)]
 enum DecompressStatus {
     FinishedRow,
@@ -1653,6 +1931,18 @@ impl SavRowDecompressor {
         reader: &mut R,
         out: &mut [u8],
         record_len: usize,
+        tally: &mut Tally,
+    ) -> Result<DecompressStatus> {
+        tally.time(ProfileStage::Decompress, || {
+            self.decompress_row(reader, out, record_len)
+        })
+    }
+
+    fn decompress_row<R: Read>(
+        &mut self,
+        reader: &mut R,
+        out: &mut [u8],
+        record_len: usize,
     ) -> Result<DecompressStatus> {
         let mut out_pos = 0usize;
         while out_pos < record_len {
@@ -1697,6 +1987,100 @@ impl SavRowDecompressor {
     }
 }
 
+/// Decompressor state at the start of one row of a bytecode-compressed data section.
+#[derive(Debug, Clone, Copy)]
+struct SavCheckpoint {
+    row: usize,
+    /// Offset of the next unread byte (a control chunk or a 253 payload).
+    pos: u64,
+    control_chunk: [u8; 8],
+    control_i: usize,
+}
+
+/// Row checkpoints for a bytecode-compressed (.sav) data section.
+///
+/// Compressed rows have variable length and can start in the middle of a control
+/// chunk, so reaching row N normally means decompressing every row before it. One
+/// pass over the control bytes (payloads are skipped, nothing is decoded) records
+/// the decompressor state at every `every`-th row from `first_row`, which lets
+/// parallel workers each start decompressing at their own checkpoint.
+pub(crate) struct SavRowIndex {
+    checkpoints: Vec<SavCheckpoint>,
+}
+
+impl SavRowIndex {
+    pub(crate) fn build(
+        path: &Path,
+        metadata: &Metadata,
+        map: Option<&SharedInput>,
+        first_row: usize,
+        every: usize,
+        end_row: usize,
+    ) -> Result<Self> {
+        let data_offset = metadata
+            .data_offset
+            .ok_or_else(|| Error::ParseError("missing data offset".to_string()))?;
+        let slots_per_row = metadata.variables.iter().map(|v| v.width).sum::<usize>();
+        let every = every.max(1);
+        let mut checkpoints = Vec::with_capacity(end_row.saturating_sub(first_row) / every + 1);
+        if slots_per_row == 0 {
+            return Ok(Self { checkpoints });
+        }
+
+        let mut reader = FileSource::open(path, 1024 * 1024, map)?;
+        reader.seek(SeekFrom::Start(data_offset))?;
+        let mut pos = data_offset;
+        let mut control_chunk = [0u8; 8];
+        let mut control_i = 8usize;
+        let mut row = 0usize;
+        let mut slots = 0usize;
+        let mut next_mark = first_row;
+        while row < end_row {
+            if slots == 0 && row == next_mark {
+                checkpoints.push(SavCheckpoint {
+                    row,
+                    pos,
+                    control_chunk,
+                    control_i,
+                });
+                next_mark += every;
+            }
+            if control_i == 8 {
+                match reader.read_exact(&mut control_chunk) {
+                    Ok(()) => {}
+                    Err(e) if e.kind() == std::io::ErrorKind::UnexpectedEof => break,
+                    Err(e) => return Err(e.into()),
+                }
+                pos += 8;
+                control_i = 0;
+            }
+            let code = control_chunk[control_i];
+            control_i += 1;
+            match code {
+                0 => continue,
+                252 => break,
+                253 => {
+                    reader.skip(8)?;
+                    pos += 8;
+                }
+                _ => {}
+            }
+            slots += 1;
+            if slots == slots_per_row {
+                slots = 0;
+                row += 1;
+            }
+        }
+        Ok(Self { checkpoints })
+    }
+
+    /// The last checkpoint at or before `row`.
+    fn locate(&self, row: usize) -> Option<&SavCheckpoint> {
+        let idx = self.checkpoints.partition_point(|c| c.row <= row);
+        self.checkpoints.get(idx.checked_sub(1)?)
+    }
+}
+
 enum StreamStatus {
     NeedData,
     FinishedRow,
@@ -1732,6 +2116,19 @@ impl SavRowStream {
         input_offset: &mut usize,
         out: &mut [u8],
         out_offset: &mut usize,
+        tally: &mut Tally,
+    ) -> Result<StreamStatus> {
+        tally.time(ProfileStage::Decompress, || {
+            self.decompress_row(input, input_offset, out, out_offset)
+        })
+    }
+
+    fn decompress_row(
+        &mut self,
+        input: &[u8],
+        input_offset: &mut usize,
+        out: &mut [u8],
+        out_offset: &mut usize,
     ) -> Result<StreamStatus> {
         loop {
             if *out_offset >= out.len() {
@@ -1804,37 +2201,14 @@ fn read_zsav_data<R: Read + Seek>(
     row_buf: &mut [u8],
     encoding: &'static encoding_rs::Encoding,
 ) -> Result<()> {
-    let zheader_ofs = reader.stream_position()?;
-    let zheader = read_zheader(reader, endian)?;
-    if zheader.zheader_ofs != zheader_ofs {
-        return Err(Error::ParseError("invalid zsav header offset".to_string()));
-    }
-
-    reader.seek(SeekFrom::Start(zheader.ztrailer_ofs))?;
-    let ztrailer = read_ztrailer(reader, endian)?;
-    let n_blocks = ztrailer.n_blocks as usize;
-
-    let mut entries = Vec::with_capacity(n_blocks);
-    for _ in 0..n_blocks {
-        entries.push(read_ztrailer_entry(reader, endian)?);
-    }
+    let mut blocks = ZsavBlocks::open(reader, endian)?;
 
     let mut stream = SavRowStream::new(endian, bias);
     let mut row_idx = 0usize;
     let mut out_offset = 0usize;
+    let mut tally = Tally::new();
 
-    for entry in entries {
-        reader.seek(SeekFrom::Start(entry.compressed_ofs as u64))?;
-        let mut compressed = vec![0u8; entry.compressed_size as usize];
-        reader.read_exact(&mut compressed)?;
-
-        let mut decoder = ZlibDecoder::new(&compressed[..]);
-        let mut uncompressed = Vec::with_capacity(entry.uncompressed_size as usize);
-        decoder.read_to_end(&mut uncompressed)?;
-        if uncompressed.len() != entry.uncompressed_size as usize {
-            return Err(Error::ParseError("zsav block size mismatch".to_string()));
-        }
-
+    while let Some(uncompressed) = blocks.next_block(reader)? {
         let mut input_offset = 0usize;
         while input_offset <= uncompressed.len() {
             let status = stream.decompress_from_slice(
@@ -1842,6 +2216,7 @@ fn read_zsav_data<R: Read + Seek>(
                 &mut input_offset,
                 row_buf,
                 &mut out_offset,
+                &mut tally,
             )?;
             match status {
                 StreamStatus::NeedData => break,
@@ -1851,7 +2226,7 @@ fn read_zsav_data<R: Read + Seek>(
                         if let Some(numeric_plans) = numeric_plans {
                             append_numeric_row(builders, plans, numeric_plans, row_buf, endian)?;
                         } else {
-                            append_row(builders, plans, row_buf, endian, encoding)?;
+                            append_row(builders, plans, row_buf, endian, encoding, &mut tally)?;
                         }
                     }
                     row_idx += 1;
@@ -1916,6 +2291,103 @@ fn read_ztrailer_entry<R: Read>(reader: &mut R, endian: Endian) -> Result<ZTrail
     })
 }
 
+/// Inflated zsav data blocks, handed out in file order.
+///
+/// The ztrailer records every block's compressed offset and size, so blocks are read
+/// a window at a time and inflated in parallel on the current rayon pool (one block
+/// per pool thread). Only one window of inflated blocks is held at a time, which keeps
+/// memory bounded regardless of file size. Rows can span block boundaries, so the
+/// caller still feeds the blocks through a single `SavRowStream`.
+struct ZsavBlocks {
+    entries: Vec<ZTrailerEntry>,
+    next: usize,
+    ready: VecDeque<Vec<u8>>,
+}
+
+impl ZsavBlocks {
+    /// Read the zheader at the current position and the block table from the ztrailer.
+    fn open<R: Read + Seek>(reader: &mut R, endian: Endian) -> Result<Self> {
+        let zheader_ofs = reader.stream_position()?;
+        let zheader = read_zheader(reader, endian)?;
+        if zheader.zheader_ofs != zheader_ofs {
+            return Err(Error::ParseError("invalid zsav header offset".to_string()));
+        }
+
+        reader.seek(SeekFrom::Start(zheader.ztrailer_ofs))?;
+        let ztrailer = read_ztrailer(reader, endian)?;
+        let n_blocks = ztrailer.n_blocks as usize;
+
+        let mut entries = Vec::with_capacity(n_blocks);
+        for _ in 0..n_blocks {
+            entries.push(read_ztrailer_entry(reader, endian)?);
+        }
+        Ok(Self {
+            entries,
+            next: 0,
+            ready: VecDeque::new(),
+        })
+    }
+
+    fn next_block<R: Read + Seek>(&mut self, reader: &mut R) -> Result<Option<Vec<u8>>> {
+        if self.ready.is_empty() && self.next < self.entries.len() {
+            self.fill(reader)?;
+        }
+        Ok(self.ready.pop_front())
+    }
+
+    fn fill<R: Read + Seek>(&mut self, reader: &mut R) -> Result<()> {
+        let window = crate::worker_pool::thread_limit();
+        let end = (self.next + window).min(self.entries.len());
+        let entries = &self.entries[self.next..end];
+
+        // I/O stays sequential; only the inflate runs on the pool.
+        let mut compressed = Vec::with_capacity(entries.len());
+        for entry in entries {
+            reader.seek(SeekFrom::Start(entry.compressed_ofs as u64))?;
+            let mut buf = vec![0u8; entry.compressed_size as usize];
+            reader.read_exact(&mut buf)?;
+            compressed.push(buf);
+        }
+
+        let inflated: Vec<Result<Vec<u8>>> = if entries.len() > 1 {
+            let profiler = read_profile::current();
+            crate::worker_pool::install(|| {
+                entries
+                    .par_iter()
+                    .zip(compressed.par_iter())
+                    .map(|(entry, buf)| {
+                        let _profile = read_profile::enter(profiler.as_ref());
+                        inflate_zsav_block(entry, buf)
+                    })
+                    .collect()
+            })
+        } else {
+            entries
+                .iter()
+                .zip(compressed.iter())
+                .map(|(entry, buf)| inflate_zsav_block(entry, buf))
+                .collect()
+        };
+        for block in inflated {
+            self.ready.push_back(block?);
+        }
+        self.next = end;
+        Ok(())
+    }
+}
+
+fn inflate_zsav_block(entry: &ZTrailerEntry, compressed: &[u8]) -> Result<Vec<u8>> {
+    let _decompress = read_profile::span(ProfileStage::Decompress);
+    let mut decoder = ZlibDecoder::new(compressed);
+    let mut uncompressed = Vec::with_capacity(entry.uncompressed_size as usize);
+    decoder.read_to_end(&mut uncompressed)?;
+    if uncompressed.len() != entry.uncompressed_size as usize {
+        return Err(Error::ParseError("zsav block size mismatch".to_string()));
+    }
+    read_profile::add_bytes_decompressed(uncompressed.len());
+    Ok(uncompressed)
+}
+
 fn read_u64<R: Read>(reader: &mut R, endian: Endian) -> Result<u64> {
     let mut buf = [0u8; 8];
     reader.read_exact(&mut buf)?;
@@ -15,9 +15,9 @@ pub use por::{metadata_json_por, metadata_por, read_por, scan_por, write_por, Po
 pub use reader::SpssReader;
 pub use types::{Alignment, Endian, Header, Measure, Metadata, VarType};
 pub use writer::{
-    SpssValueLabelKey, SpssValueLabelMap, SpssValueLabels, SpssVariableAlignments,
-    SpssVariableDisplayWidths, SpssVariableFormat, SpssVariableFormats, SpssVariableLabels,
-    SpssVariableMeasures, SpssWriteColumn, SpssWriteSchema, SpssWriter,
+    SpssCompression, SpssValueLabelKey, SpssValueLabelMap, SpssValueLabels,
+    SpssVariableAlignments, SpssVariableDisplayWidths, SpssVariableFormat, SpssVariableFormats,
+    SpssVariableLabels, SpssVariableMeasures, SpssWriteColumn, SpssWriteSchema, SpssWriter,
 };
 
 use serde_json::{json, Map, Value};
@@ -104,7 +104,7 @@ pub fn metadata_json_from_meta(meta: &Metadata, hdr: &Header) -> Result<String>
 
 /// Export SPSS metadata as a JSON string.
 pub fn metadata_json(path: impl AsRef<Path>) -> Result<String> {
-    let reader = SpssReader::open(path)?;
+    let reader = SpssReader::open_cached(path)?;
     metadata_json_from_meta(reader.metadata(), reader.header())
 }
 
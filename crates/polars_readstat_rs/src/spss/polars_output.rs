@@ -1,31 +1,14 @@
-use crate::spss::data::read_data_frame_streaming;
+use crate::spss::data::{label_categorical_dtype, read_data_frame_streaming};
 use crate::spss::reader::SpssReader;
 use crate::spss::types::FormatClass;
 use polars::prelude::*;
-use rayon::prelude::*;
-use rayon::ThreadPoolBuilder;
-use std::collections::BTreeMap;
 use std::path::PathBuf;
-use std::sync::mpsc::{self, Receiver};
+use std::sync::mpsc;
 use std::sync::Arc;
-use std::thread::JoinHandle;
 
 pub fn scan_sav(path: impl Into<PathBuf>, opts: crate::ScanOptions) -> PolarsResult<LazyFrame> {
-    let path = path.into();
-    let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
-    let preserve_order = opts.preserve_order.unwrap_or(false);
-    let scan_ptr = Arc::new(SpssScan::new(
-        path,
-        opts.threads,
-        missing_string_as_null,
-        opts.value_labels_as_strings,
-        opts.chunk_size,
-        preserve_order,
-        opts.informative_nulls,
-        opts.row_index_name,
-        opts.compress_opts,
-    ));
-    LazyFrame::anonymous_scan(scan_ptr, Default::default())
+    let scan = SpssScan::from_options(path.into(), opts);
+    LazyFrame::anonymous_scan(Arc::new(scan), Default::default())
 }
 
 #[cfg(test)]
@@ -62,6 +45,7 @@ mod tests {
             None,
             true,
             true,
+            false,
             Some(10),
             false,
             None,
@@ -69,6 +53,9 @@ mod tests {
             0,
             Some(25),
             None,
+            None,
+            false,
+            None,
         )
         .expect("batch iter");
         let mut batches = 0usize;
@@ -85,71 +72,6 @@ mod tests {
 
 pub(crate) type SpssBatchIter = Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>;
 
-fn split_batch_ranges(total_batches: usize, n_workers: usize) -> Vec<(usize, usize)> {
-    if total_batches == 0 || n_workers == 0 {
-        return Vec::new();
-    }
-    let n = n_workers.min(total_batches);
-    let base = total_batches / n;
-    let rem = total_batches % n;
-    let mut ranges = Vec::with_capacity(n);
-    let mut start = 0usize;
-    for i in 0..n {
-        let len = base + if i < rem { 1 } else { 0 };
-        ranges.push((start, len));
-        start += len;
-    }
-    ranges
-}
-
-struct ParallelSpssBatchIter {
-    rx: Receiver<(usize, PolarsResult<DataFrame>)>,
-    handle: Option<JoinHandle<()>>,
-    preserve_order: bool,
-    buffer: BTreeMap<usize, PolarsResult<DataFrame>>,
-    next_idx: usize,
-    total_chunks: usize,
-}
-
-impl Iterator for ParallelSpssBatchIter {
-    type Item = PolarsResult<DataFrame>;
-
-    fn next(&mut self) -> Option<Self::Item> {
-        if !self.preserve_order {
-            return self.rx.recv().ok().map(|(_, df)| df);
-        }
-        if self.next_idx >= self.total_chunks {
-            return None;
-        }
-        loop {
-            if let Some(item) = self.buffer.remove(&self.next_idx) {
-                self.next_idx += 1;
-                return Some(item);
-            }
-            match self.rx.recv() {
-                Ok((idx, df)) => {
-                    self.buffer.insert(idx, df);
-                }
-                Err(_) => {
-                    if let Some(item) = self.buffer.remove(&self.next_idx) {
-                        self.next_idx += 1;
-                        return Some(item);
-                    }
-                    return None;
-                }
-            }
-        }
-    }
-}
-
-impl Drop for ParallelSpssBatchIter {
-    fn drop(&mut self) {
-        if let Some(handle) = self.handle.take() {
-            let _ = handle.join();
-        }
-    }
-}
-
 // For compressed SPSS files: reads the full range sequentially in a background
 // thread (one pass, no re-seeking) and sends batches via a bounded channel.
 // This avoids the O(N²) re-decompression cost of calling with_offset() per batch.
@@ -162,7 +84,7 @@ impl Iterator for SpssBackgroundIter {
     type Item = PolarsResult<DataFrame>;
 
     fn next(&mut self) -> Option<Self::Item> {
-        self.rx.recv().ok()
+        crate::read_profile::wait(|| self.rx.recv().ok())
     }
 }
 
@@ -179,6 +101,7 @@ pub(crate) fn spss_batch_iter(
     threads: Option<usize>,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     chunk_size: Option<usize>,
     preserve_order: bool,
     row_index_name: Option<String>,
@@ -186,15 +109,19 @@ pub(crate) fn spss_batch_iter(
     offset: usize,
     n_rows: Option<usize>,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    row_filter: Option<Arc<crate::RowFilter>>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 ) -> PolarsResult<SpssBatchIter> {
-    let reader =
-        SpssReader::open(&path).map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+    let reader = SpssReader::open_cached(&path)
+        .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
     spss_batch_iter_with_reader(
         &reader,
         path,
         threads,
         missing_string_as_null,
         value_labels_as_strings,
+        value_labels_as_categorical,
         chunk_size,
         preserve_order,
         row_index_name,
@@ -202,6 +129,9 @@ pub(crate) fn spss_batch_iter(
         offset,
         n_rows,
         informative_nulls,
+        row_filter,
+        use_mmap,
+        read_ahead,
     )
 }
 
@@ -211,6 +141,7 @@ pub(crate) fn spss_batch_iter_with_reader(
     threads: Option<usize>,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     chunk_size: Option<usize>,
     preserve_order: bool,
     row_index_name: Option<String>,
@@ -218,6 +149,9 @@ pub(crate) fn spss_batch_iter_with_reader(
     offset: usize,
     n_rows: Option<usize>,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    row_filter: Option<Arc<crate::RowFilter>>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 ) -> PolarsResult<SpssBatchIter> {
     let max_rows = reader.metadata().row_count.saturating_sub(offset as u64) as usize;
     let total = n_rows.unwrap_or(max_rows).min(max_rows);
@@ -234,6 +168,7 @@ pub(crate) fn spss_batch_iter_with_reader(
     if total == 0 {
         return Ok(Box::new(std::iter::empty()));
     }
+    let map = crate::mmap_source::open_input(use_mmap, read_ahead, &path);
 
     if let Some(ref name) = row_index_name {
         let collision = reader.metadata().variables.iter().any(|v| v.name == *name);
@@ -244,6 +179,10 @@ pub(crate) fn spss_batch_iter_with_reader(
         }
     }
 
+    // Filtered-out rows would leave holes in the row index; informative-null reads
+    // decode through a separate path that does not take a filter.
+    let row_filter = row_filter.filter(|_| row_index_name.is_none() && informative_nulls.is_none());
+
     // Informative nulls: read once with indicators, then slice into batches in a background thread.
     if let Some(null_opts) = informative_nulls {
         use crate::spss::types::VarType;
@@ -307,8 +246,65 @@ pub(crate) fn spss_batch_iter_with_reader(
             .collect();
 
         let path = Arc::new(path);
+
+        // Uncompressed and bytecode-compressed rows are decoded in parallel batches,
+        // indicators alongside the values, as in the plain read below.
+        if (compression == 0 || compression == 1) && n_threads > 1 && total >= 1000 {
+            let total_chunks = (total + batch_size - 1) / batch_size;
+            let n_workers = n_threads.min(total_chunks.max(1));
+            let sav_index = Arc::new(std::sync::OnceLock::new());
+            let file_index = reader.sav_index();
+            let tasks = crate::worker_pool::ScanTasks::new(
+                total_chunks,
+                crate::worker_pool::scan_limit(n_workers),
+                preserve_order,
+                move |chunk| {
+                    let sav_index = match file_index.as_deref() {
+                        Some(index) => Some(index),
+                        None => shared_sav_index(
+                            &sav_index,
+                            compression,
+                            &path,
+                            &metadata,
+                            map.as_ref(),
+                            offset,
+                            batch_size,
+                            offset + total,
+                        )?,
+                    };
+                    let start_row = offset + chunk * batch_size;
+                    let rows = batch_size.min(total - chunk * batch_size);
+                    let df = crate::spss::data::read_data_frame_with_indicators(
+                        &path,
+                        &metadata,
+                        endian,
+                        compression,
+                        bias,
+                        cols_idx.as_deref(),
+                        start_row,
+                        rows,
+                        missing_string_as_null,
+                        value_labels_as_strings,
+                        value_labels_as_categorical,
+                        &indicator_col_names,
+                        sav_index,
+                        map.as_ref(),
+                    )
+                    .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+                    let df = crate::apply_informative_null_mode(df, &null_opts.mode, &pairs)?;
+                    let df = match row_index_name {
+                        Some(ref name) => crate::append_row_index(df, name.as_str(), start_row)?,
+                        None => df,
+                    };
+                    Ok(vec![df])
+                },
+            );
+            return Ok(Box::new(tasks));
+        }
+
+        let file_index = reader.sav_index();
         let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
-        let handle = std::thread::spawn(move || {
+        let handle = crate::read_profile::spawn(move || {
             let df = crate::spss::data::read_data_frame_with_indicators(
                 &path,
                 &metadata,
@@ -320,7 +316,10 @@ pub(crate) fn spss_batch_iter_with_reader(
                 total,
                 missing_string_as_null,
                 value_labels_as_strings,
+                value_labels_as_categorical,
                 &indicator_col_names,
+                file_index.as_deref(),
+                map.as_ref(),
             )
             .map_err(|e| PolarsError::ComputeError(e.to_string().into()))
             .and_then(|df| crate::apply_informative_null_mode(df, &null_opts.mode, &pairs));
@@ -347,7 +346,7 @@ pub(crate) fn spss_batch_iter_with_reader(
                         }
                     }
                 }
-                if tx.send(Ok(slice)).is_err() {
+                if crate::read_profile::wait(|| tx.send(Ok(slice))).is_err() {
                     return;
                 }
                 start += take;
@@ -359,10 +358,13 @@ pub(crate) fn spss_batch_iter_with_reader(
         }));
     }
 
-    if reader.compression() == 0 && n_threads > 1 && total >= 1000 {
+    // Uncompressed rows are fixed-width, so workers seek straight to their rows.
+    // Bytecode-compressed workers start from checkpoints found by one cheap pass
+    // over the control bytes.
+    let compression = reader.compression();
+    if (compression == 0 || compression == 1) && n_threads > 1 && total >= 1000 {
         let total_chunks = (total + batch_size - 1) / batch_size;
         let n_workers = n_threads.min(total_chunks.max(1));
-        let (tx, rx) = mpsc::sync_channel::<(usize, PolarsResult<DataFrame>)>(n_workers);
         let path = Arc::new(path);
         let metadata = Arc::new(reader.metadata().clone());
         let endian = reader.endian();
@@ -389,85 +391,79 @@ pub(crate) fn spss_batch_iter_with_reader(
             .transpose()?;
         let missing_null = missing_string_as_null;
         let labels_as_strings = value_labels_as_strings;
+        // Built by whichever task gets there first; the others wait for it. A
+        // reader that already holds checkpoints for the whole file lends those.
+        let sav_index = Arc::new(std::sync::OnceLock::new());
+        let file_index = reader.sav_index();
 
-        let ranges = split_batch_ranges(total_chunks, n_workers);
-
-        let handle = std::thread::spawn(move || {
-            let pool = match ThreadPoolBuilder::new().num_threads(n_workers).build() {
-                Ok(pool) => pool,
-                Err(e) => {
-                    let _ = tx.send((0, Err(PolarsError::ComputeError(e.to_string().into()))));
-                    return;
-                }
-            };
-            pool.install(|| {
-                ranges
-                    .into_par_iter()
-                    .for_each_with(tx, |sender, (batch_start, batch_count)| {
-                        if batch_count == 0 {
-                            return;
-                        }
-                        let start_row = offset + batch_start * batch_size;
-                        if start_row >= offset + total {
-                            return;
+        // One task per batch on the shared pool, at most `n_workers` in flight.
+        let tasks = crate::worker_pool::ScanTasks::new(
+            total_chunks,
+            crate::worker_pool::scan_limit(n_workers),
+            preserve_order,
+            move |chunk| {
+                let sav_index = match file_index.as_deref() {
+                    Some(index) => Some(index),
+                    None => shared_sav_index(
+                        &sav_index,
+                        compression,
+                        &path,
+                        &metadata,
+                        map.as_ref(),
+                        offset,
+                        batch_size,
+                        offset + total,
+                    )?,
+                };
+                let start_row = offset + chunk * batch_size;
+                let rows = batch_size.min(total - chunk * batch_size);
+                let mut batches = Vec::new();
+                let mut next_row = start_row;
+                let mut failed = None;
+                let mut on_batch = |df: DataFrame| -> bool {
+                    let result = match row_index_name {
+                        Some(ref name) => crate::append_row_index(df, name.as_str(), next_row)
+                            .map_err(|e| PolarsError::ComputeError(e.to_string().into())),
+                        None => Ok(df),
+                    };
+                    match result {
+                        Ok(df) => {
+                            next_row = next_row.saturating_add(df.height());
+                            batches.push(df);
+                            true
                         }
-                        let range_rows =
-                            (batch_count * batch_size).min(total - batch_start * batch_size);
-                        let mut local_idx = 0usize;
-                        let row_index_name = row_index_name.clone();
-                        let mut next_row = start_row;
-                        let mut on_batch = |mut df: DataFrame| -> bool {
-                            if let Some(ref name) = row_index_name {
-                                let row_start = next_row;
-                                next_row = next_row.saturating_add(df.height());
-                                match crate::append_row_index(df, name.as_str(), row_start) {
-                                    Ok(with_idx) => df = with_idx,
-                                    Err(e) => {
-                                        let _ = sender.send((
-                                            batch_start + local_idx,
-                                            Err(PolarsError::ComputeError(e.to_string().into())),
-                                        ));
-                                        return false;
-                                    }
-                                }
-                            } else {
-                                next_row = next_row.saturating_add(df.height());
-                            }
-                            let idx = batch_start + local_idx;
-                            local_idx += 1;
-                            sender.send((idx, Ok(df))).is_ok()
-                        };
-
-                        let result = read_data_frame_streaming(
-                            &path,
-                            &metadata,
-                            endian,
-                            0,
-                            bias,
-                            cols_idx.as_deref(),
-                            start_row,
-                            range_rows,
-                            missing_null,
-                            labels_as_strings,
-                            batch_size,
-                            &mut on_batch,
-                        )
-                        .map_err(|e| PolarsError::ComputeError(e.to_string().into()));
-                        if let Err(e) = result {
-                            let _ = sender.send((batch_start + local_idx, Err(e)));
+                        Err(e) => {
+                            failed = Some(e);
+                            false
                         }
-                    });
-            });
-        });
-
-        return Ok(Box::new(ParallelSpssBatchIter {
-            rx,
-            handle: Some(handle),
-            preserve_order,
-            buffer: BTreeMap::new(),
-            next_idx: 0,
-            total_chunks,
-        }));
+                    }
+                };
+                read_data_frame_streaming(
+                    &path,
+                    &metadata,
+                    endian,
+                    compression,
+                    bias,
+                    cols_idx.as_deref(),
+                    start_row,
+                    rows,
+                    missing_null,
+                    labels_as_strings,
+                    value_labels_as_categorical,
+                    batch_size,
+                    row_filter.as_deref(),
+                    sav_index,
+                    map.as_ref(),
+                    &mut on_batch,
+                )
+                .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+                match failed {
+                    Some(e) => Err(e),
+                    None => Ok(batches),
+                }
+            },
+        );
+        return Ok(Box::new(tasks));
     }
 
     // Compressed SPSS: a background thread reads the full range in one sequential
@@ -500,41 +496,50 @@ pub(crate) fn spss_batch_iter_with_reader(
             .transpose()?;
         let missing_null = missing_string_as_null;
         let labels = value_labels_as_strings;
+        let file_index = reader.sav_index();
         let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
-        let handle = std::thread::spawn(move || {
-            let mut next_row = offset;
-            if let Err(e) = crate::spss::data::read_data_frame_streaming(
-                &path,
-                &metadata,
-                endian,
-                compression,
-                bias,
-                cols_idx.as_deref(),
-                offset,
-                total,
-                missing_null,
-                labels,
-                batch_size,
-                &mut |mut df| {
-                    if let Some(ref name) = row_index_name {
-                        let row_start = next_row;
-                        next_row = next_row.saturating_add(df.height());
-                        match crate::append_row_index(df, name.as_str(), row_start) {
-                            Ok(with_idx) => df = with_idx,
-                            Err(e) => {
-                                let _ =
-                                    tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
-                                return false;
+        let handle = crate::read_profile::spawn(move || {
+            // zsav blocks are inflated on the shared pool, `threads` at a time.
+            let run = move || {
+                let mut next_row = offset;
+                if let Err(e) = crate::spss::data::read_data_frame_streaming(
+                    &path,
+                    &metadata,
+                    endian,
+                    compression,
+                    bias,
+                    cols_idx.as_deref(),
+                    offset,
+                    total,
+                    missing_null,
+                    labels,
+                    value_labels_as_categorical,
+                    batch_size,
+                    row_filter.as_deref(),
+                    file_index.as_deref(),
+                    map.as_ref(),
+                    &mut |mut df| {
+                        if let Some(ref name) = row_index_name {
+                            let row_start = next_row;
+                            next_row = next_row.saturating_add(df.height());
+                            match crate::append_row_index(df, name.as_str(), row_start) {
+                                Ok(with_idx) => df = with_idx,
+                                Err(e) => {
+                                    let _ = tx
+                                        .send(Err(PolarsError::ComputeError(e.to_string().into())));
+                                    return false;
+                                }
                             }
+                        } else {
+                            next_row = next_row.saturating_add(df.height());
                         }
-                    } else {
-                        next_row = next_row.saturating_add(df.height());
-                    }
-                    tx.send(Ok(df)).is_ok()
-                },
-            ) {
-                let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
-            }
+                        crate::read_profile::wait(|| tx.send(Ok(df))).is_ok()
+                    },
+                ) {
+                    let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
+                }
+            };
+            crate::worker_pool::with_thread_limit(n_threads, run);
         });
         return Ok(Box::new(SpssBackgroundIter {
             rx,
@@ -571,7 +576,7 @@ pub(crate) fn spss_batch_iter_with_reader(
     let missing_null = missing_string_as_null;
     let labels = value_labels_as_strings;
     let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
-    let handle = std::thread::spawn(move || {
+    let handle = crate::read_profile::spawn(move || {
         let mut next_row = offset;
         if let Err(e) = crate::spss::data::read_data_frame_streaming(
             &path,
@@ -584,7 +589,11 @@ pub(crate) fn spss_batch_iter_with_reader(
             total,
             missing_null,
             labels,
+            value_labels_as_categorical,
             batch_size,
+            row_filter.as_deref(),
+            None,
+            map.as_ref(),
             &mut |mut df| {
                 if let Some(ref name) = row_index_name {
                     let row_start = next_row;
@@ -599,7 +608,7 @@ pub(crate) fn spss_batch_iter_with_reader(
                 } else {
                     next_row = next_row.saturating_add(df.height());
                 }
-                tx.send(Ok(df)).is_ok()
+                crate::read_profile::wait(|| tx.send(Ok(df))).is_ok()
             },
         ) {
             let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
@@ -621,6 +630,10 @@ pub struct SpssScan {
     informative_nulls: Option<crate::InformativeNullOpts>,
     row_index_name: Option<String>,
     compress_opts: crate::CompressOptionsLite,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
+    profiler: Option<crate::ReadProfiler>,
+    value_labels_as_categorical: bool,
 }
 
 impl SpssScan {
@@ -645,8 +658,61 @@ impl SpssScan {
             informative_nulls,
             row_index_name,
             compress_opts,
+            use_mmap: false,
+            read_ahead: None,
+            profiler: None,
+            value_labels_as_categorical: false,
         }
     }
+
+    /// The scan `opts` describe, as [`scan_sav`] builds it.
+    pub(crate) fn from_options(path: PathBuf, opts: crate::ScanOptions) -> Self {
+        let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
+        let preserve_order = opts.preserve_order.unwrap_or(false);
+        let use_mmap = opts.use_mmap.unwrap_or(false);
+        SpssScan::new(
+            path,
+            opts.threads,
+            missing_string_as_null,
+            opts.value_labels_as_strings,
+            opts.chunk_size,
+            preserve_order,
+            opts.informative_nulls,
+            opts.row_index_name,
+            opts.compress_opts,
+        )
+        .with_mmap(use_mmap)
+        .with_read_ahead(opts.read_ahead)
+        .with_profiler(opts.profile.clone())
+        .with_value_labels_as_categorical(opts.value_labels_as_categorical.unwrap_or(false))
+    }
+
+    /// Read through a memory map of the file instead of buffered reads.
+    pub fn with_mmap(mut self, use_mmap: bool) -> Self {
+        self.use_mmap = use_mmap;
+        self
+    }
+
+    /// Read through positioned range reads that keep about `window` bytes in
+    /// flight ahead of decoding, for high-latency storage. `with_mmap` wins when
+    /// both are set.
+    pub fn with_read_ahead(mut self, window: Option<usize>) -> Self {
+        self.read_ahead = window;
+        self
+    }
+
+    /// Collect this scan's profile into `profiler` (see [`crate::ReadProfiler`]).
+    pub fn with_profiler(mut self, profiler: Option<crate::ReadProfiler>) -> Self {
+        self.profiler = profiler;
+        self
+    }
+
+    /// Read value-labelled numeric columns as `Categorical` instead of `String` (when
+    /// value labels are applied).
+    pub fn with_value_labels_as_categorical(mut self, as_categorical: bool) -> Self {
+        self.value_labels_as_categorical = as_categorical;
+        self
+    }
 }
 
 impl AnonymousScan for SpssScan {
@@ -655,14 +721,38 @@ impl AnonymousScan for SpssScan {
     }
 
     fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
-        let cols = opts
-            .with_columns
-            .map(|c| c.iter().map(|s| s.to_string()).collect::<Vec<_>>());
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let predicate = opts.predicate.as_ref();
+        let row_filter = predicate
+            .and_then(crate::RowFilter::from_expr)
+            .map(Arc::new);
+        let extra_columns = predicate
+            .map(|p| {
+                crate::row_filter::predicate_extra_columns(p, opts.with_columns.as_deref(), |n| {
+                    // Informative-null indicator columns are derived, not stored.
+                    self.informative_nulls.is_none()
+                        && opts.schema.contains(n)
+                        && self.row_index_name.as_deref() != Some(n)
+                })
+            })
+            .unwrap_or_default();
+        let cols = opts.with_columns.as_ref().map(|c| {
+            c.iter()
+                .chain(extra_columns.iter())
+                .map(|s| s.to_string())
+                .collect::<Vec<_>>()
+        });
+        let row_count = SpssReader::open_cached(&self.path)
+            .map(|r| r.metadata().row_count as usize)
+            .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+        let expected_rows =
+            crate::frame_assembly::expected_rows(row_count, opts.n_rows, row_filter.is_some());
         let iter = spss_batch_iter(
             self.path.clone(),
             self.threads,
             self.missing_string_as_null,
             self.value_labels_as_strings.unwrap_or(true),
+            self.value_labels_as_categorical,
             self.chunk_size,
             self.preserve_order,
             self.row_index_name.clone(),
@@ -670,20 +760,23 @@ impl AnonymousScan for SpssScan {
             0,
             opts.n_rows,
             self.informative_nulls.clone(),
+            row_filter,
+            self.use_mmap,
+            self.read_ahead,
         )?;
 
         let prefetch = crate::scan_prefetch::spawn_prefetcher(iter.map(|batch| batch));
-        let mut out: Option<DataFrame> = None;
+        // Without a residual predicate the rows read are the rows returned, so the
+        // columns can be compressed as they are assembled.
+        let fuse = self.compress_opts.enabled && predicate.is_none();
+        let mut out = crate::frame_assembly::FrameAssembler::new(expected_rows)
+            .with_compression(fuse.then_some(&self.compress_opts));
         while let Some(df) = prefetch.next()? {
-            if let Some(acc) = out.as_mut() {
-                acc.vstack_mut(&df)
-                    .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
-            } else {
-                out = Some(df);
-            }
+            out.push(df)?;
         }
-        let df = out.unwrap_or_else(DataFrame::empty);
-        if self.compress_opts.enabled {
+        let df = out.finish()?;
+        let df = crate::row_filter::apply_residual_predicate(df, predicate, &extra_columns)?;
+        if self.compress_opts.enabled && !fuse {
             let compressed = crate::compress_df_if_enabled(&df, &self.compress_opts)
                 .map_err(|e| PolarsError::ComputeError(e.into()))?;
             Ok(compressed)
@@ -692,12 +785,21 @@ impl AnonymousScan for SpssScan {
         }
     }
 
+    fn allows_predicate_pushdown(&self) -> bool {
+        true
+    }
+
     fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
-        let reader = SpssReader::open(&self.path)
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let reader = SpssReader::open_cached(&self.path)
             .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
         let metadata = reader.metadata();
         let value_labels_as_strings = self.value_labels_as_strings.unwrap_or(true);
-        let base_schema = build_schema(metadata, value_labels_as_strings);
+        let base_schema = build_schema(
+            metadata,
+            value_labels_as_strings,
+            self.value_labels_as_categorical,
+        );
 
         if let Some(null_opts) = &self.informative_nulls {
             let var_names: Vec<&str> = metadata.variables.iter().map(|v| v.name.as_str()).collect();
@@ -729,11 +831,47 @@ impl AnonymousScan for SpssScan {
     }
 }
 
-fn build_schema(metadata: &crate::spss::types::Metadata, value_labels_as_strings: bool) -> Schema {
+/// The checkpoint index of a bytecode-compressed file, built by whichever task asks
+/// first while the others wait for it; `None` for other compressions.
+fn shared_sav_index<'a>(
+    cell: &'a std::sync::OnceLock<Result<crate::spss::data::SavRowIndex, String>>,
+    compression: i32,
+    path: &std::path::Path,
+    metadata: &crate::spss::types::Metadata,
+    map: Option<&crate::mmap_source::SharedInput>,
+    first_row: usize,
+    every: usize,
+    end_row: usize,
+) -> PolarsResult<Option<&'a crate::spss::data::SavRowIndex>> {
+    if compression != 1 {
+        return Ok(None);
+    }
+    let index = cell.get_or_init(|| {
+        crate::spss::data::SavRowIndex::build(path, metadata, map, first_row, every, end_row)
+            .map_err(|e| e.to_string())
+    });
+    match index {
+        Ok(index) => Ok(Some(index)),
+        Err(e) => Err(PolarsError::ComputeError(e.clone().into())),
+    }
+}
+
+fn build_schema(
+    metadata: &crate::spss::types::Metadata,
+    value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
+) -> Schema {
     let mut schema = Schema::with_capacity(metadata.variables.len());
     for var in &metadata.variables {
         let dtype = if value_labels_as_strings && var.value_label.is_some() {
-            DataType::String
+            var.value_label
+                .as_deref()
+                .filter(|_| {
+                    value_labels_as_categorical
+                        && var.var_type == crate::spss::types::VarType::Numeric
+                })
+                .and_then(|name| label_categorical_dtype(metadata, name))
+                .unwrap_or(DataType::String)
         } else {
             match var.var_type {
                 crate::spss::types::VarType::Numeric => match var.format_class {
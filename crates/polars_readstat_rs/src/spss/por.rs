@@ -2,7 +2,7 @@ use crate::spss::error::{Error, Result};
 use crate::spss::types::FormatClass;
 use polars::prelude::*;
 use std::fs::File;
-use std::io::{BufReader, BufWriter, Read, Write};
+use std::io::{BufWriter, Read, Seek, SeekFrom, Write};
 use std::path::{Path, PathBuf};
 use std::sync::Arc;
 
@@ -80,9 +80,28 @@ pub struct PorMetadata {
 }
 
 // ─── Line-aware byte stream ───────────────────────────────────────────────────
+//
+// The file is read in large blocks. Runs of a block that hold no line break are
+// handed out whole (number tokens, string bodies), so the per-char path only
+// handles line ends, padding and refills.
+
+/// Block size while reading data records.
+const DATA_BUF_LEN: usize = 1 << 20;
+/// Block size while reading only the header.
+const HEADER_BUF_LEN: usize = 1 << 16;
+/// Rows per batch when the caller does not ask for a size.
+const DEFAULT_BATCH_ROWS: usize = 8192;
+
+#[inline]
+fn is_line_break(b: u8) -> bool { b == b'\r' || b == b'\n' }
 
 struct PorStream<R: Read> {
     inner: R,
+    buf: Vec<u8>,
+    start: usize,
+    end: usize,
+    // File offset of buf[0].
+    buf_offset: u64,
     pos: usize,
     pending_spaces: usize,
     space: u8,
@@ -90,10 +109,34 @@ struct PorStream<R: Read> {
 }
 
 impl<R: Read> PorStream<R> {
-    fn new(inner: R) -> Self {
+    fn new(inner: R, buf_len: usize) -> Self {
         let mut byte2char = [0u8; 256];
         for i in 0..=255u8 { byte2char[i as usize] = i; }
-        Self { inner, pos: 0, pending_spaces: 0, space: b' ', byte2char }
+        Self {
+            inner, buf: vec![0; buf_len.max(1)], start: 0, end: 0, buf_offset: 0,
+            pos: 0, pending_spaces: 0, space: b' ', byte2char,
+        }
+    }
+
+    // File offset of the next unread byte.
+    fn offset(&self) -> u64 { self.buf_offset + self.start as u64 }
+
+    // Make sure the block has unread bytes; false at end of input.
+    fn fill(&mut self) -> std::io::Result<bool> {
+        if self.start < self.end { return Ok(true); }
+        self.buf_offset += self.end as u64;
+        self.start = 0;
+        self.end = 0;
+        let n = loop {
+            match self.inner.read(&mut self.buf) {
+                Ok(n) => break n,
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+                Err(e) => return Err(e),
+            }
+        };
+        crate::read_profile::add_bytes_read(n);
+        self.end = n;
+        Ok(n > 0)
     }
 
     fn read_raw_byte(&mut self) -> std::io::Result<Option<u8>> {
@@ -101,12 +144,10 @@ impl<R: Read> PorStream<R> {
             self.pending_spaces -= 1;
             return Ok(Some(self.space));
         }
-        let mut b = [0u8; 1];
-        match self.inner.read(&mut b) {
-            Ok(0) => Ok(None),
-            Ok(_) => Ok(Some(b[0])),
-            Err(e) => Err(e),
-        }
+        if !self.fill()? { return Ok(None); }
+        let b = self.buf[self.start];
+        self.start += 1;
+        Ok(Some(b))
     }
 
     // Read one byte from the logical stream, handling CRLF-to-space padding.
@@ -115,13 +156,8 @@ impl<R: Read> PorStream<R> {
             match self.read_raw_byte()? {
                 None => return Err(Error::ParseError("unexpected EOF in POR stream".into())),
                 Some(b'\r') => {
-                    match self.read_raw_byte()? {
-                        Some(b'\n') | None => {}
-                        Some(b) => {
-                            // treat lone CR as LF, put back isn't available so just handle LF
-                            let _ = b;
-                        }
-                    }
+                    // CRLF ends one line; so does a lone CR.
+                    if self.fill()? && self.buf[self.start] == b'\n' { self.start += 1; }
                     self.pending_spaces = POR_LINE_LEN.saturating_sub(self.pos);
                     self.pos = 0;
                 }
@@ -144,18 +180,103 @@ impl<R: Read> PorStream<R> {
     }
 
     // Read one byte and map it through byte2char.
+    #[inline]
     fn read_char(&mut self) -> Result<u8> {
+        if self.pending_spaces == 0 && self.start < self.end {
+            let b = self.buf[self.start];
+            if !is_line_break(b) {
+                self.start += 1;
+                self.pos += 1;
+                return Ok(self.byte2char[b as usize]);
+            }
+        }
         let b = self.read_byte()?;
         Ok(self.byte2char[b as usize])
     }
 
+    // Length of the buffered run at the read position (at most `max` bytes)
+    // that needs no line handling: no pending padding and no line break.
+    #[inline]
+    fn plain_run(&self, max: usize) -> usize {
+        if self.pending_spaces > 0 { return 0; }
+        let run = &self.buf[self.start..self.end.min(self.start.saturating_add(max))];
+        run.iter().position(|&b| is_line_break(b)).unwrap_or(run.len())
+    }
+
+    #[inline]
+    fn consume_run(&mut self, n: usize) {
+        self.start += n;
+        self.pos += n;
+    }
+
+    // Feed the mapped chars of a field to `f` up to its '/' terminator, which
+    // is consumed but not fed.
+    fn scan_token(&mut self, mut f: impl FnMut(u8) -> Result<()>) -> Result<()> {
+        loop {
+            let run = self.plain_run(usize::MAX);
+            let mut taken = 0;
+            let mut done = false;
+            for &b in &self.buf[self.start..self.start + run] {
+                taken += 1;
+                let c = self.byte2char[b as usize];
+                if c == b'/' { done = true; break; }
+                f(c)?;
+            }
+            self.consume_run(taken);
+            if done { return Ok(()); }
+            let c = self.read_char()?;
+            if c == b'/' { return Ok(()); }
+            f(c)?;
+        }
+    }
+
+    // Append n mapped chars to `out`.
+    fn read_chars_into(&mut self, mut n: usize, out: &mut Vec<u8>) -> Result<()> {
+        out.reserve(n.min(DATA_BUF_LEN));
+        while n > 0 {
+            let k = self.plain_run(n);
+            if k == 0 {
+                out.push(self.read_char()?);
+                n -= 1;
+                continue;
+            }
+            let map = &self.byte2char;
+            out.extend(self.buf[self.start..self.start + k].iter().map(|&b| map[b as usize]));
+            self.consume_run(k);
+            n -= k;
+        }
+        Ok(())
+    }
+
     // Read n mapped chars.
     fn read_chars(&mut self, n: usize) -> Result<Vec<u8>> {
-        let mut out = Vec::with_capacity(n);
-        for _ in 0..n { out.push(self.read_char()?); }
+        let mut out = Vec::new();
+        self.read_chars_into(n, &mut out)?;
         Ok(out)
     }
 
+    // Step over n chars without mapping them.
+    fn skip_chars(&mut self, mut n: usize) -> Result<()> {
+        while n > 0 {
+            if self.pending_spaces > 0 {
+                let k = self.pending_spaces.min(n);
+                self.pending_spaces -= k;
+                self.pos += k;
+                n -= k;
+                continue;
+            }
+            let k = self.plain_run(n);
+            if k == 0 {
+                self.read_byte()?;
+                n -= 1;
+            } else {
+                self.consume_run(k);
+                n -= k;
+            }
+        }
+        Ok(())
+    }
+
     // Initialise byte2char from the 256-byte reverse-lookup in the file.
     // reverse_lookup[i] = file byte that represents POR table position i.
     // byte2char[file_byte] = ASCII char for that byte.
@@ -182,17 +303,29 @@ impl<R: Read> PorStream<R> {
 
     fn read_double_peek(&mut self, first: u8) -> Result<f64> {
         if first == b'*' {
-            let c2 = self.read_char()?;
-            if c2 == b'.' { return Ok(f64::NAN); }
-            return Err(Error::ParseError(format!("POR: expected '.' after '*', got '{}'", c2 as char)));
+            self.read_missing_dot()?;
+            return Ok(f64::NAN);
         }
-        let mut chars = vec![first];
-        loop {
-            let c = self.read_char()?;
-            if c == b'/' { break; }
-            chars.push(c);
+        let mut num = Base30::default();
+        num.push(first)?;
+        self.scan_token(|c| num.push(c))?;
+        Ok(num.finish())
+    }
+
+    // Step over the rest of a number whose first char was already read.
+    fn skip_double_peek(&mut self, first: u8) -> Result<()> {
+        match first {
+            b'*' => self.read_missing_dot(),
+            b'/' => Err(invalid_base30("digit", first)),
+            _ => self.scan_token(|_| Ok(())),
         }
-        parse_base30_double(&chars)
+    }
+
+    // The '.' that completes a missing value "*.".
+    fn read_missing_dot(&mut self) -> Result<()> {
+        let c2 = self.read_char()?;
+        if c2 == b'.' { return Ok(()); }
+        Err(Error::ParseError(format!("POR: expected '.' after '*', got '{}'", c2 as char)))
     }
 
     fn read_integer(&mut self) -> Result<u64> {
@@ -209,84 +342,83 @@ impl<R: Read> PorStream<R> {
         let raw = self.read_chars(len)?;
         Ok(String::from_utf8_lossy(&raw).into_owned())
     }
-
-    // Like read_double but returns None if first char is 'Z' (end-of-data).
-    fn maybe_read_double(&mut self) -> Result<Option<f64>> {
-        let c = self.read_char()?;
-        if c == b'Z' { return Ok(None); }
-        Ok(Some(self.read_double_peek(c)?))
-    }
-
-    // Like read_string_field but returns None if first char is 'Z'.
-    fn maybe_read_string_field(&mut self) -> Result<Option<String>> {
-        let c = self.read_char()?;
-        if c == b'Z' { return Ok(None); }
-        let len = self.read_double_peek(c)? as usize;
-        let raw = self.read_chars(len)?;
-        Ok(Some(String::from_utf8_lossy(&raw).into_owned()))
-    }
 }
 
 // ─── Base-30 parser ───────────────────────────────────────────────────────────
 
-fn base30_digit(c: u8) -> Option<f64> {
-    match c {
-        b'0'..=b'9' => Some((c - b'0') as f64),
-        b'A'..=b'T' => Some((10 + c - b'A') as f64),
-        _ => None,
-    }
+// Value of each base-30 digit char; u8::MAX for any other char.
+static BASE30_DIGIT: [u8; 256] = {
+    let mut t = [u8::MAX; 256];
+    let mut i = 0;
+    while i < 10 { t[b'0' as usize + i] = i as u8; i += 1; }
+    let mut i = 0;
+    while i < 20 { t[b'A' as usize + i] = 10 + i as u8; i += 1; }
+    t
+};
+
+fn invalid_base30(what: &str, c: u8) -> Error {
+    Error::ParseError(format!("POR: invalid base-30 {} '{}'", what, c as char))
 }
 
-// Parse a base-30 encoded number from chars (the '/' terminator is already stripped).
-// Format: [-] integer_digits [. frac_digits] [+|- exp_digits]
+#[derive(Default, Clone, Copy, PartialEq, Eq)]
+enum Base30Part { #[default] Sign, Int, Frac, Exp }
+
+// Incremental base-30 number, fed one char at a time without the '/'
+// terminator. Format: [-] integer_digits [. frac_digits] [+|- exp_digits].
 // Missing = "*." (handled by caller).
-fn parse_base30_double(chars: &[u8]) -> Result<f64> {
-    let mut i = 0;
-    let negative = i < chars.len() && chars[i] == b'-';
-    if negative || (i < chars.len() && chars[i] == b'+') { i += 1; }
-
-    let mut num = 0.0f64;
-    while i < chars.len() {
-        let c = chars[i];
-        if c == b'.' || c == b'+' || c == b'-' { break; }
-        match base30_digit(c) {
-            Some(d) => { num = num * 30.0 + d; i += 1; }
-            None => return Err(Error::ParseError(format!("POR: invalid base-30 digit '{}'", c as char))),
-        }
-    }
+#[derive(Default)]
+struct Base30 {
+    part: Base30Part,
+    negative: bool,
+    num: f64,
+    frac: f64,
+    denom: f64,
+    exp_neg: bool,
+    exp: f64,
+}
 
-    let mut frac = 0.0f64;
-    if i < chars.len() && chars[i] == b'.' {
-        i += 1;
-        let mut denom = 30.0f64;
-        while i < chars.len() && chars[i] != b'+' && chars[i] != b'-' {
-            match base30_digit(chars[i]) {
-                Some(d) => { frac += d / denom; denom *= 30.0; i += 1; }
-                None => return Err(Error::ParseError(format!("POR: invalid base-30 frac digit '{}'", chars[i] as char))),
+impl Base30 {
+    #[inline]
+    fn push(&mut self, c: u8) -> Result<()> {
+        let d = BASE30_DIGIT[c as usize];
+        match self.part {
+            Base30Part::Sign if c == b'-' || c == b'+' => {
+                self.negative = c == b'-';
+                self.part = Base30Part::Int;
+            }
+            Base30Part::Sign | Base30Part::Int => {
+                self.part = Base30Part::Int;
+                match c {
+                    b'.' => { self.part = Base30Part::Frac; self.denom = 30.0; }
+                    b'+' | b'-' => self.start_exp(c),
+                    _ if d != u8::MAX => self.num = self.num * 30.0 + d as f64,
+                    _ => return Err(invalid_base30("digit", c)),
+                }
             }
+            Base30Part::Frac => match c {
+                b'+' | b'-' => self.start_exp(c),
+                _ if d != u8::MAX => { self.frac += d as f64 / self.denom; self.denom *= 30.0; }
+                _ => return Err(invalid_base30("frac digit", c)),
+            },
+            Base30Part::Exp if d != u8::MAX => self.exp = self.exp * 30.0 + d as f64,
+            Base30Part::Exp => return Err(invalid_base30("exp digit", c)),
         }
+        Ok(())
     }
 
-    let mut exp_neg = false;
-    let mut exp = 0.0f64;
-    if i < chars.len() {
-        exp_neg = chars[i] == b'-';
-        i += 1;
-        while i < chars.len() {
-            match base30_digit(chars[i]) {
-                Some(d) => { exp = exp * 30.0 + d; i += 1; }
-                None => return Err(Error::ParseError(format!("POR: invalid base-30 exp digit '{}'", chars[i] as char))),
-            }
-        }
+    fn start_exp(&mut self, sign: u8) {
+        self.exp_neg = sign == b'-';
+        self.part = Base30Part::Exp;
     }
 
-    let mut val = num + frac;
-    if exp != 0.0 {
-        let e = if exp_neg { -exp } else { exp };
-        val *= 30.0f64.powf(e);
+    fn finish(&self) -> f64 {
+        let mut val = self.num + self.frac;
+        if self.exp != 0.0 {
+            let e = if self.exp_neg { -self.exp } else { self.exp };
+            val *= 30.0f64.powf(e);
+        }
+        if self.negative { -val } else { val }
     }
-    if negative { val = -val; }
-    Ok(val)
 }
 
 // ─── Format class ─────────────────────────────────────────────────────────────
@@ -302,14 +434,30 @@ fn format_class_from_por_type(code: u32) -> Option<FormatClass> {
     }
 }
 
-// ─── Reader: parse metadata + data ───────────────────────────────────────────
+// ─── Reader: header ───────────────────────────────────────────────────────────
 
-pub fn read_por<P: AsRef<Path>>(path: P) -> Result<(PorMetadata, DataFrame)> {
-    let path = path.as_ref();
+// The dictionary plus the stream state at the first data record, so data can
+// be read again without re-parsing the header.
+pub(crate) struct PorHeader {
+    pub(crate) meta: PorMetadata,
+    lookup: [u8; 256],
+    data_offset: u64,
+    line_pos: usize,
+    pending_spaces: usize,
+}
+
+fn open_por_header(path: &Path) -> Result<PorHeader> {
     let file = File::open(path)?;
-    let reader = BufReader::with_capacity(1 << 20, file);
-    let mut stream = PorStream::new(reader);
+    let mut stream = PorStream::new(file, HEADER_BUF_LEN);
+    read_por_header(&mut stream)
+}
+
+// The header of `path`, shared through the process-wide metadata cache.
+pub(crate) fn por_header_cached(path: &Path) -> Result<Arc<PorHeader>> {
+    crate::metadata_cache::cached(path, open_por_header)
+}
 
+fn read_por_header<R: Read>(stream: &mut PorStream<R>) -> Result<PorHeader> {
     // 1. Vanity (5 × 40 = 200 logical bytes).
     let vanity = stream.read_n_raw(200)?;
     // File label is in vanity row 1 (bytes 40-79), positions 20-39 of that row.
@@ -449,7 +597,8 @@ pub fn read_por<P: AsRef<Path>>(path: P) -> Result<(PorMetadata, DataFrame)> {
                 let n = stream.read_integer()?;
                 for _ in 0..n { let _ = stream.read_string_field()?; }
             }
-            b'F' => break, // start of data
+            // Start of data; 'Z' here means a file without data records.
+            b'F' | b'Z' => break,
             _ => {
                 return Err(Error::ParseError(format!(
                     "POR: unexpected tag '{}' (0x{:02x})", tag as char, tag
@@ -459,307 +608,413 @@ pub fn read_por<P: AsRef<Path>>(path: P) -> Result<(PorMetadata, DataFrame)> {
     }
 
     let metadata_df = build_por_metadata_df(&variables)?;
+    let meta = PorMetadata { file_label, variables, metadata_df, precision, row_count: None };
+    Ok(PorHeader {
+        meta,
+        lookup,
+        data_offset: stream.offset(),
+        line_pos: stream.pos,
+        pending_spaces: stream.pending_spaces,
+    })
+}
 
-    let meta = PorMetadata {
-        file_label,
-        variables: variables.clone(),
-        metadata_df,
-        precision,
-        row_count: None,
-    };
+// ─── Reader: data records ─────────────────────────────────────────────────────
 
-    // 6. Data rows.
-    let df = read_por_data(&mut stream, &variables)?;
+#[derive(Clone, Copy)]
+enum PorColumnKind { Float, Date, Datetime, Time, Str }
 
-    Ok((meta, df))
+fn por_column_kind(var: &PorVariable) -> PorColumnKind {
+    if var.is_string() {
+        return PorColumnKind::Str;
+    }
+    match var.format_class {
+        Some(FormatClass::Date) => PorColumnKind::Date,
+        Some(FormatClass::DateTime) => PorColumnKind::Datetime,
+        Some(FormatClass::Time) => PorColumnKind::Time,
+        None => PorColumnKind::Float,
+    }
 }
 
-fn read_por_data<R: Read>(
-    stream: &mut PorStream<R>,
-    variables: &[PorVariable],
-) -> Result<DataFrame> {
-    if variables.is_empty() {
-        return Ok(DataFrame::empty());
+fn por_column_dtype(kind: PorColumnKind) -> DataType {
+    match kind {
+        PorColumnKind::Float => DataType::Float64,
+        PorColumnKind::Date => DataType::Date,
+        PorColumnKind::Datetime => DataType::Datetime(TimeUnit::Milliseconds, None),
+        PorColumnKind::Time => DataType::Time,
+        PorColumnKind::Str => DataType::String,
     }
+}
 
-    // Pre-allocate builders.
-    enum ColBuilder {
-        Float(PrimitiveChunkedBuilder<Float64Type>),
-        DateI32(PrimitiveChunkedBuilder<Int32Type>),
-        DatetimeI64(PrimitiveChunkedBuilder<Int64Type>),
-        TimeI64(PrimitiveChunkedBuilder<Int64Type>),
-        Str(StringChunkedBuilder),
+fn por_schema(meta: &PorMetadata) -> Schema {
+    let mut schema = Schema::with_capacity(meta.variables.len());
+    for v in &meta.variables {
+        schema.with_column(v.name.as_str().into(), por_column_dtype(por_column_kind(v)));
     }
+    schema
+}
 
-    let initial_cap = 4096usize;
-    let mut builders: Vec<ColBuilder> = variables
-        .iter()
-        .map(|v| {
-            if v.is_string() {
-                ColBuilder::Str(StringChunkedBuilder::new(v.name.as_str().into(), initial_cap))
-            } else {
-                match v.format_class {
-                    Some(FormatClass::Date) => ColBuilder::DateI32(
-                        PrimitiveChunkedBuilder::new(v.name.as_str().into(), initial_cap),
-                    ),
-                    Some(FormatClass::DateTime) => ColBuilder::DatetimeI64(
-                        PrimitiveChunkedBuilder::new(v.name.as_str().into(), initial_cap),
-                    ),
-                    Some(FormatClass::Time) => ColBuilder::TimeI64(
-                        PrimitiveChunkedBuilder::new(v.name.as_str().into(), initial_cap),
-                    ),
-                    None => ColBuilder::Float(PrimitiveChunkedBuilder::new(
-                        v.name.as_str().into(),
-                        initial_cap,
-                    )),
+enum ColBuilder {
+    Float(PrimitiveChunkedBuilder<Float64Type>),
+    DateI32(PrimitiveChunkedBuilder<Int32Type>),
+    DatetimeI64(PrimitiveChunkedBuilder<Int64Type>),
+    TimeI64(PrimitiveChunkedBuilder<Int64Type>),
+    Str(StringChunkedBuilder),
+}
+
+impl ColBuilder {
+    fn new(kind: PorColumnKind, name: PlSmallStr, capacity: usize) -> Self {
+        match kind {
+            PorColumnKind::Float => ColBuilder::Float(PrimitiveChunkedBuilder::new(name, capacity)),
+            PorColumnKind::Date => ColBuilder::DateI32(PrimitiveChunkedBuilder::new(name, capacity)),
+            PorColumnKind::Datetime => {
+                ColBuilder::DatetimeI64(PrimitiveChunkedBuilder::new(name, capacity))
+            }
+            PorColumnKind::Time => ColBuilder::TimeI64(PrimitiveChunkedBuilder::new(name, capacity)),
+            PorColumnKind::Str => ColBuilder::Str(StringChunkedBuilder::new(name, capacity)),
+        }
+    }
+
+    fn push_double(&mut self, v: f64) {
+        let is_null = v.is_nan();
+        match self {
+            ColBuilder::Float(b) => {
+                if is_null { b.append_null(); } else { b.append_value(v); }
+            }
+            ColBuilder::DateI32(b) => {
+                if is_null {
+                    b.append_null();
+                } else {
+                    let days = ((v as i64) - SPSS_SEC_SHIFT) / SEC_PER_DAY;
+                    b.append_value(days as i32);
                 }
             }
-        })
-        .collect();
-
-    'rows: loop {
-        for (i, var) in variables.iter().enumerate() {
-            if var.is_string() {
-                match stream.maybe_read_string_field()? {
-                    None => {
-                        if i == 0 { break 'rows; }
-                        return Err(Error::ParseError("POR: Z in middle of row".into()));
-                    }
-                    Some(s) => {
-                        if let ColBuilder::Str(b) = &mut builders[i] {
-                            b.append_value(&s);
-                        }
-                    }
+            ColBuilder::DatetimeI64(b) => {
+                if is_null {
+                    b.append_null();
+                } else {
+                    let ms = ((v as i64) - SPSS_SEC_SHIFT) * 1_000;
+                    b.append_value(ms);
                 }
-            } else {
-                match stream.maybe_read_double()? {
-                    None => {
-                        if i == 0 { break 'rows; }
-                        return Err(Error::ParseError("POR: Z in middle of row".into()));
-                    }
-                    Some(v) => {
-                        let is_null = v.is_nan();
-                        match &mut builders[i] {
-                            ColBuilder::Float(b) => {
-                                if is_null { b.append_null(); } else { b.append_value(v); }
-                            }
-                            ColBuilder::DateI32(b) => {
-                                if is_null {
-                                    b.append_null();
-                                } else {
-                                    let days = ((v as i64) - SPSS_SEC_SHIFT) / SEC_PER_DAY;
-                                    b.append_value(days as i32);
-                                }
-                            }
-                            ColBuilder::DatetimeI64(b) => {
-                                if is_null {
-                                    b.append_null();
-                                } else {
-                                    let ms = ((v as i64) - SPSS_SEC_SHIFT) * 1_000;
-                                    b.append_value(ms);
-                                }
-                            }
-                            ColBuilder::TimeI64(b) => {
-                                if is_null {
-                                    b.append_null();
-                                } else {
-                                    let ns = (v as i64) * 1_000_000_000;
-                                    b.append_value(ns);
-                                }
-                            }
-                            ColBuilder::Str(_) => unreachable!(),
-                        }
-                    }
+            }
+            ColBuilder::TimeI64(b) => {
+                if is_null {
+                    b.append_null();
+                } else {
+                    let ns = (v as i64) * 1_000_000_000;
+                    b.append_value(ns);
                 }
             }
+            ColBuilder::Str(_) => unreachable!("numeric field decoded into a string column"),
         }
     }
 
-    // Finalise columns.
-    let series: Vec<Series> = builders
-        .into_iter()
-        .map(|b| match b {
-            ColBuilder::Float(b) => b.finish().into_series(),
-            ColBuilder::DateI32(b) => b
-                .finish()
-                .into_series()
-                .cast(&DataType::Date)
-                .expect("cast to Date"),
+    fn push_str(&mut self, s: Option<&str>) {
+        if let ColBuilder::Str(b) = self {
+            b.append_option(s);
+        }
+    }
+
+    fn finish(self) -> PolarsResult<Series> {
+        match self {
+            ColBuilder::Float(b) => Ok(b.finish().into_series()),
+            ColBuilder::DateI32(b) => b.finish().into_series().cast(&DataType::Date),
             ColBuilder::DatetimeI64(b) => b
                 .finish()
                 .into_series()
-                .cast(&DataType::Datetime(TimeUnit::Milliseconds, None))
-                .expect("cast to Datetime"),
-            ColBuilder::TimeI64(b) => b
-                .finish()
-                .into_series()
-                .cast(&DataType::Time)
-                .expect("cast to Time"),
-            ColBuilder::Str(b) => b.finish().into_series(),
-        })
-        .collect();
+                .cast(&DataType::Datetime(TimeUnit::Milliseconds, None)),
+            ColBuilder::TimeI64(b) => b.finish().into_series().cast(&DataType::Time),
+            ColBuilder::Str(b) => Ok(b.finish().into_series()),
+        }
+    }
+}
 
-    DataFrame::new_infer_height(series.into_iter().map(Column::from).collect())
-        .map_err(|e| Error::ParseError(e.to_string()))
+// What the record decoder does with one variable's field, in file order.
+// Fields without a slot are stepped over without being parsed.
+#[derive(Clone, Copy)]
+struct PorField {
+    string: bool,
+    slot: Option<usize>,
 }
 
-// ─── LazyFrame scan ──────────────────────────────────────────────────────────
+// Fields of every variable, and the (file-ordered) columns selected by `columns`.
+fn build_por_plan(
+    meta: &PorMetadata,
+    columns: Option<&[String]>,
+) -> PolarsResult<(Vec<PorField>, Vec<(PlSmallStr, PorColumnKind)>)> {
+    if let Some(cols) = columns {
+        if let Some(missing) = cols.iter().find(|c| !meta.variables.iter().any(|v| v.name == **c)) {
+            return Err(PolarsError::ColumnNotFound(missing.clone().into()));
+        }
+    }
+    let mut fields = Vec::with_capacity(meta.variables.len());
+    let mut selected = Vec::new();
+    for v in &meta.variables {
+        let slot = if columns.map_or(true, |cols| cols.iter().any(|c| *c == v.name)) {
+            selected.push((PlSmallStr::from(v.name.as_str()), por_column_kind(v)));
+            Some(selected.len() - 1)
+        } else {
+            None
+        };
+        fields.push(PorField { string: v.is_string(), slot });
+    }
+    Ok((fields, selected))
+}
 
-pub fn scan_por(path: impl Into<PathBuf>, _opts: crate::ScanOptions) -> PolarsResult<LazyFrame> {
-    let path = path.into();
-    let scan = Arc::new(PorScan { path });
-    LazyFrame::anonymous_scan(scan, Default::default())
+fn compute_err(e: Error) -> PolarsError {
+    PolarsError::ComputeError(e.to_string().into())
 }
 
-struct PorScan { path: PathBuf }
+// Decodes data records in batches. Records are variable-width text, so they
+// are read in order from the start of the data; the first `skip` rows are
+// stepped over without decoding.
+struct PorBatchIter {
+    stream: PorStream<File>,
+    fields: Vec<PorField>,
+    columns: Vec<(PlSmallStr, PorColumnKind)>,
+    batch_size: usize,
+    missing_string_as_null: bool,
+    row_index_name: Option<String>,
+    row_cursor: usize,
+    skip: usize,
+    remaining: usize,
+    done: bool,
+    scratch: Vec<u8>,
+}
 
-impl AnonymousScan for PorScan {
-    fn as_any(&self) -> &dyn std::any::Any { self }
+impl PorBatchIter {
+    fn new(
+        path: &Path,
+        header: &PorHeader,
+        columns: Option<&[String]>,
+        batch_size: usize,
+        skip: usize,
+        n_rows: usize,
+        missing_string_as_null: bool,
+        row_index_name: Option<String>,
+    ) -> PolarsResult<Self> {
+        let (fields, columns) = build_por_plan(&header.meta, columns)?;
+        let open = || -> Result<PorStream<File>> {
+            let mut file = File::open(path)?;
+            file.seek(SeekFrom::Start(header.data_offset))?;
+            let mut stream = PorStream::new(file, DATA_BUF_LEN);
+            stream.set_char_table(&header.lookup);
+            stream.buf_offset = header.data_offset;
+            stream.pos = header.line_pos;
+            stream.pending_spaces = header.pending_spaces;
+            Ok(stream)
+        };
+        Ok(Self {
+            stream: open().map_err(compute_err)?,
+            done: fields.is_empty(),
+            fields,
+            columns,
+            batch_size: batch_size.max(1),
+            missing_string_as_null,
+            row_index_name,
+            row_cursor: skip,
+            skip,
+            remaining: n_rows,
+            scratch: Vec::new(),
+        })
+    }
 
-    fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
-        let (_, mut df) = read_por(&self.path)
-            .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
-
-        if let Some(cols) = opts.with_columns {
-            let names: Vec<PlSmallStr> = cols.iter().cloned().collect();
-            df = df
-                .select(names.iter().map(|s| s.as_str()).collect::<Vec<_>>())
-                .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+    // Read one record, decoding the fields that have a slot in `builders` when
+    // `decode` is set and stepping over everything else. False at the
+    // end-of-data marker.
+    fn read_row(&mut self, builders: &mut [ColBuilder], decode: bool) -> Result<bool> {
+        for (i, field) in self.fields.iter().enumerate() {
+            let first = self.stream.read_char()?;
+            if first == b'Z' {
+                if i == 0 { return Ok(false); }
+                return Err(Error::ParseError("POR: Z in middle of row".into()));
+            }
+            let slot = if decode { field.slot } else { None };
+            match (field.string, slot) {
+                (false, None) => self.stream.skip_double_peek(first)?,
+                (false, Some(j)) => builders[j].push_double(self.stream.read_double_peek(first)?),
+                (true, None) => {
+                    let len = self.stream.read_double_peek(first)? as usize;
+                    self.stream.skip_chars(len)?;
+                }
+                (true, Some(j)) => {
+                    let len = self.stream.read_double_peek(first)? as usize;
+                    self.scratch.clear();
+                    self.stream.read_chars_into(len, &mut self.scratch)?;
+                    let s = String::from_utf8_lossy(&self.scratch);
+                    let missing = self.missing_string_as_null && s.trim_end_matches(' ').is_empty();
+                    builders[j].push_str(if missing { None } else { Some(s.as_ref()) });
+                }
+            }
         }
+        Ok(true)
+    }
 
-        if let Some(n) = opts.n_rows {
-            df = df.slice(0, n);
+    fn next_batch(&mut self) -> PolarsResult<Option<DataFrame>> {
+        while self.skip > 0 && !self.done {
+            if self.read_row(&mut [], false).map_err(compute_err)? {
+                self.skip -= 1;
+            } else {
+                self.done = true;
+            }
+        }
+        if self.done || self.remaining == 0 {
+            return Ok(None);
         }
 
-        Ok(df)
-    }
+        let take = self.batch_size.min(self.remaining);
+        let mut builders: Vec<ColBuilder> = self
+            .columns
+            .iter()
+            .map(|(name, kind)| ColBuilder::new(*kind, name.clone(), take))
+            .collect();
+        let mut count = 0;
+        while count < take {
+            if !self.read_row(&mut builders, true).map_err(compute_err)? {
+                self.done = true;
+                break;
+            }
+            count += 1;
+        }
+        self.remaining -= count;
+        if count == 0 {
+            return Ok(None);
+        }
 
-    fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
-        let file = File::open(&self.path)
-            .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
-        let reader = BufReader::with_capacity(1 << 16, file);
-        let mut stream = PorStream::new(reader);
-        let meta = read_por_metadata_only(&mut stream)
-            .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
-
-        let mut schema = Schema::with_capacity(meta.variables.len());
-        for v in &meta.variables {
-            let dtype = if v.is_string() {
-                DataType::String
-            } else {
-                match v.format_class {
-                    Some(FormatClass::Date) => DataType::Date,
-                    Some(FormatClass::DateTime) => DataType::Datetime(TimeUnit::Milliseconds, None),
-                    Some(FormatClass::Time) => DataType::Time,
-                    None => DataType::Float64,
-                }
-            };
-            schema.with_column(v.name.as_str().into(), dtype);
+        let row_start = self.row_cursor;
+        self.row_cursor += count;
+        let df = if builders.is_empty() {
+            DataFrame::empty_with_height(count)
+        } else {
+            let columns = builders
+                .into_iter()
+                .map(|b| b.finish().map(Column::from))
+                .collect::<PolarsResult<Vec<_>>>()?;
+            DataFrame::new_infer_height(columns)?
+        };
+        match self.row_index_name {
+            Some(ref name) => crate::append_row_index(df, name, row_start).map(Some),
+            None => Ok(Some(df)),
         }
-        Ok(Arc::new(schema))
     }
 }
 
-fn read_por_metadata_only<R: Read>(stream: &mut PorStream<R>) -> Result<PorMetadata> {
-    let vanity = stream.read_n_raw(200)?;
-    let label_bytes = &vanity[60..80];
-    let file_label = String::from_utf8_lossy(label_bytes)
-        .trim_end_matches(' ')
-        .to_string();
+impl Iterator for PorBatchIter {
+    type Item = PolarsResult<DataFrame>;
 
-    let raw_lookup = stream.read_n_raw(256)?;
-    let mut lookup = [0u8; 256];
-    lookup.copy_from_slice(&raw_lookup);
-    stream.set_char_table(&lookup);
+    fn next(&mut self) -> Option<Self::Item> {
+        let _decode = crate::read_profile::span(crate::read_profile::ProfileStage::RowDecode);
+        self.next_batch().transpose()
+    }
+}
 
-    let sig = stream.read_chars(8)?;
-    if sig != b"SPSSPORT" {
-        return Err(Error::ParseError("not a POR file".into()));
+/// Batch iterator for POR files (used by readstat_batch_iter). Only the fields
+/// of `columns` are decoded; rows before `skip` are stepped over.
+pub fn por_batch_iter(
+    path: PathBuf,
+    missing_string_as_null: bool,
+    chunk_size: Option<usize>,
+    row_index_name: Option<String>,
+    columns: Option<Vec<String>>,
+    skip: usize,
+    n_rows: Option<usize>,
+) -> PolarsResult<Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>> {
+    let header = por_header_cached(&path).map_err(compute_err)?;
+    let iter = PorBatchIter::new(
+        &path,
+        &header,
+        columns.as_deref(),
+        chunk_size.unwrap_or(DEFAULT_BATCH_ROWS),
+        skip,
+        n_rows.unwrap_or(usize::MAX),
+        missing_string_as_null,
+        row_index_name,
+    )?;
+    Ok(Box::new(iter))
+}
+
+pub fn read_por<P: AsRef<Path>>(path: P) -> Result<(PorMetadata, DataFrame)> {
+    let path = path.as_ref();
+    let header = por_header_cached(path)?;
+    let iter =
+        PorBatchIter::new(path, &header, None, 1 << 16, 0, usize::MAX, false, None).map_err(polars_err)?;
+    let mut out = crate::frame_assembly::FrameAssembler::new(0);
+    for batch in iter {
+        out.push(batch.map_err(polars_err)?).map_err(polars_err)?;
     }
+    let df = out.finish().map_err(polars_err)?;
+    Ok((header.meta.clone(), df))
+}
 
-    let _version = stream.read_char()?;
-    let _ = stream.read_string_field()?;
-    let _ = stream.read_string_field()?;
+// ─── LazyFrame scan ──────────────────────────────────────────────────────────
 
-    let mut variables: Vec<PorVariable> = Vec::new();
-    let mut precision = 20u32;
+pub fn scan_por(path: impl Into<PathBuf>, opts: crate::ScanOptions) -> PolarsResult<LazyFrame> {
+    let path = path.into();
+    let scan = Arc::new(PorScan::new(path, &opts)?);
+    LazyFrame::anonymous_scan(scan, Default::default())
+}
 
-    loop {
-        let tag = stream.read_char()?;
-        match tag {
-            b'1' | b'2' | b'3' => { let _ = stream.read_string_field()?; }
-            b'4' => { let _ = stream.read_integer()?; }
-            b'5' => { precision = stream.read_integer()? as u32; }
-            b'6' => { let _ = stream.read_string_field()?; }
-            b'7' => {
-                let width = stream.read_integer()? as u32;
-                let name = stream.read_string_field()?;
-                let pft = stream.read_integer()? as u32;
-                let pfw = stream.read_integer()? as u32;
-                let pfd = stream.read_integer()? as u32;
-                let wft = stream.read_integer()? as u32;
-                let wfw = stream.read_integer()? as u32;
-                let wfd = stream.read_integer()? as u32;
-                let format_class = if width == 0 { format_class_from_por_type(pft) } else { None };
-                variables.push(PorVariable {
-                    name, width,
-                    print_format_type: pft, print_format_width: pfw, print_format_decimals: pfd,
-                    write_format_type: wft, write_format_width: wfw, write_format_decimals: wfd,
-                    label: None, format_class,
-                });
-            }
-            b'8' => {
-                if let Some(v) = variables.last() {
-                    if v.is_string() { let _ = stream.read_string_field()?; }
-                    else { let _ = stream.read_double()?; }
-                } else { let _ = stream.read_double()?; }
-            }
-            b'9' | b'A' => { let _ = stream.read_double()?; }
-            b'B' => {
-                if let Some(v) = variables.last() {
-                    if v.is_string() {
-                        let _ = stream.read_string_field()?;
-                        let _ = stream.read_string_field()?;
-                    } else {
-                        let _ = stream.read_double()?;
-                        let _ = stream.read_double()?;
-                    }
-                } else {
-                    let _ = stream.read_double()?;
-                    let _ = stream.read_double()?;
-                }
-            }
-            b'C' => {
-                let label = stream.read_string_field()?;
-                if let Some(v) = variables.last_mut() { v.label = Some(label); }
-            }
-            b'D' => {
-                let n_vars = stream.read_integer()?;
-                let mut is_string = false;
-                for j in 0..n_vars {
-                    let vname = stream.read_string_field()?;
-                    if j == 0 {
-                        is_string = variables.iter().any(|v| v.name == vname && v.is_string());
-                    }
-                }
-                let n_labels = stream.read_integer()?;
-                for _ in 0..n_labels {
-                    if is_string { let _ = stream.read_string_field()?; }
-                    else { let _ = stream.read_double()?; }
-                    let _ = stream.read_string_field()?;
-                }
-            }
-            b'E' => {
-                let n = stream.read_integer()?;
-                for _ in 0..n { let _ = stream.read_string_field()?; }
-            }
-            b'F' | b'Z' => break,
-            _ => return Err(Error::ParseError(format!("POR schema: unexpected tag '{}'", tag as char))),
+pub(crate) struct PorScan {
+    path: PathBuf,
+    missing_string_as_null: bool,
+    chunk_size: Option<usize>,
+    row_index_name: Option<String>,
+    compress_opts: crate::CompressOptionsLite,
+    schema: Schema,
+    profiler: Option<crate::ReadProfiler>,
+}
+
+impl PorScan {
+    pub(crate) fn new(path: PathBuf, opts: &crate::ScanOptions) -> PolarsResult<Self> {
+        let _profile = crate::read_profile::enter(opts.profile.as_ref());
+        let header = por_header_cached(&path).map_err(compute_err)?;
+        Ok(Self {
+            schema: por_schema(&header.meta),
+            path,
+            missing_string_as_null: opts.missing_string_as_null.unwrap_or(true),
+            chunk_size: opts.chunk_size,
+            row_index_name: opts.row_index_name.clone(),
+            compress_opts: opts.compress_opts.clone(),
+            profiler: opts.profile.clone(),
+        })
+    }
+}
+
+impl AnonymousScan for PorScan {
+    fn as_any(&self) -> &dyn std::any::Any { self }
+
+    fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
+        let mut schema = self.schema.clone();
+        if let Some(ref name) = self.row_index_name {
+            schema = crate::append_row_index_schema(schema, name)?;
         }
+        Ok(Arc::new(schema))
     }
 
-    let metadata_df = build_por_metadata_df(&variables)?;
-    Ok(PorMetadata { file_label, variables, metadata_df, precision, row_count: None })
+    fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let columns = opts.with_columns.map(|cols| {
+            cols.iter()
+                .filter(|c| self.schema.get(c.as_str()).is_some())
+                .map(|c| c.to_string())
+                .collect::<Vec<_>>()
+        });
+        let iter = por_batch_iter(
+            self.path.clone(),
+            self.missing_string_as_null,
+            self.chunk_size,
+            self.row_index_name.clone(),
+            columns,
+            0,
+            opts.n_rows,
+        )?;
+
+        let mut out = crate::frame_assembly::FrameAssembler::new(opts.n_rows.unwrap_or(0))
+            .with_compression(Some(&self.compress_opts));
+        for batch in iter {
+            out.push(batch?)?;
+        }
+        out.finish()
+    }
 }
 
 // ─── Metadata helpers ─────────────────────────────────────────────────────────
@@ -783,10 +1038,8 @@ fn df_col_str<'a>(df: &'a polars::prelude::DataFrame, col: &str, row: usize) ->
 
 pub fn metadata_json_por<P: AsRef<Path>>(path: P) -> Result<String> {
     use serde_json::{json, Map, Value};
-    let file = File::open(path.as_ref())?;
-    let reader = BufReader::with_capacity(1 << 16, file);
-    let mut stream = PorStream::new(reader);
-    let meta = read_por_metadata_only(&mut stream)?;
+    let header = por_header_cached(path.as_ref())?;
+    let meta = &header.meta;
     let df = &meta.metadata_df;
 
     let variables: Vec<Value> = meta.variables.iter().enumerate().map(|(i, v)| {
@@ -809,10 +1062,7 @@ pub fn metadata_json_por<P: AsRef<Path>>(path: P) -> Result<String> {
 }
 
 pub fn metadata_por<P: AsRef<Path>>(path: P) -> Result<PorMetadata> {
-    let file = File::open(path.as_ref())?;
-    let reader = BufReader::with_capacity(1 << 16, file);
-    let mut stream = PorStream::new(reader);
-    read_por_metadata_only(&mut stream)
+    Ok(por_header_cached(path.as_ref())?.meta.clone())
 }
 
 // ─── Writer ───────────────────────────────────────────────────────────────────
@@ -1,3 +1,4 @@
+use crate::spss::data::SavRowIndex;
 use crate::spss::error::{Error, Result};
 use crate::spss::header::read_header;
 use crate::spss::metadata::read_metadata;
@@ -6,12 +7,14 @@ use polars::prelude::*;
 use std::fs::File;
 use std::io::BufReader;
 use std::path::{Path, PathBuf};
-use std::sync::Arc;
+use std::sync::{Arc, OnceLock};
 
 pub struct SpssReader {
     path: PathBuf,
     header: Header,
     metadata: Metadata,
+    /// Row checkpoints of a bytecode-compressed file, once something asked for them.
+    sav_index: OnceLock<Arc<SavRowIndex>>,
 }
 
 impl SpssReader {
@@ -25,9 +28,16 @@ impl SpssReader {
             path,
             header,
             metadata,
+            sav_index: OnceLock::new(),
         })
     }
 
+    /// Like [`open`](Self::open), but shares the parsed header and metadata with
+    /// earlier opens of the same unchanged file (see [`crate::clear_metadata_cache`]).
+    pub fn open_cached(path: impl AsRef<Path>) -> Result<Arc<Self>> {
+        crate::metadata_cache::cached(path.as_ref(), |p| Self::open(p))
+    }
+
     pub fn metadata(&self) -> &Metadata {
         &self.metadata
     }
@@ -44,6 +54,28 @@ impl SpssReader {
         self.header.endian
     }
 
+    /// Checkpoints at every `every`-th row of a bytecode-compressed file, built on the
+    /// first call and kept for later reads through the same
+    /// [`open_cached`](Self::open_cached) reader; `None` for other compressions.
+    pub(crate) fn ensure_sav_index(&self, every: usize) -> Result<Option<Arc<SavRowIndex>>> {
+        if self.compression() != 1 {
+            return Ok(None);
+        }
+        if let Some(index) = self.sav_index.get() {
+            return Ok(Some(index.clone()));
+        }
+        let end_row = self.metadata.row_count as usize;
+        let index = SavRowIndex::build(&self.path, &self.metadata, None, 0, every, end_row)?;
+        // Another thread may have won the race with an identical index.
+        let _ = self.sav_index.set(Arc::new(index));
+        Ok(self.sav_index.get().cloned())
+    }
+
+    /// The checkpoints built by [`ensure_sav_index`](Self::ensure_sav_index), if any.
+    pub(crate) fn sav_index(&self) -> Option<Arc<SavRowIndex>> {
+        self.sav_index.get().cloned()
+    }
+
     pub fn read(&self) -> ReadBuilder<'_> {
         ReadBuilder::new(self)
     }
@@ -60,7 +92,10 @@ pub struct ReadBuilder<'a> {
     chunk_size: Option<usize>,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 }
 
 impl<'a> ReadBuilder<'a> {
@@ -76,7 +111,10 @@ impl<'a> ReadBuilder<'a> {
             chunk_size: None,
             missing_string_as_null: true,
             value_labels_as_strings: true,
+            value_labels_as_categorical: false,
             informative_nulls: None,
+            use_mmap: false,
+            read_ahead: None,
         }
     }
 
@@ -116,10 +154,27 @@ impl<'a> ReadBuilder<'a> {
         self.value_labels_as_strings = v;
         self
     }
+    /// With value labels applied, read labelled numeric columns as `Categorical`.
+    pub fn value_labels_as_categorical(mut self, v: bool) -> Self {
+        self.value_labels_as_categorical = v;
+        self
+    }
     pub fn informative_nulls(mut self, v: Option<crate::InformativeNullOpts>) -> Self {
         self.informative_nulls = v;
         self
     }
+    /// Read through a memory map of the file instead of buffered reads.
+    pub fn use_mmap(mut self, v: bool) -> Self {
+        self.use_mmap = v;
+        self
+    }
+
+    /// Read through positioned range reads with a read-ahead window of about
+    /// `window` bytes (for network storage).
+    pub fn read_ahead(mut self, window: usize) -> Self {
+        self.read_ahead = Some(window);
+        self
+    }
 
     /// Stream rows in batches of `chunk_size`, calling `on_batch` for each.
     /// Return `false` from `on_batch` to stop early. Batches are dropped immediately
@@ -142,6 +197,7 @@ impl<'a> ReadBuilder<'a> {
             threads,
             self.missing_string_as_null,
             self.value_labels_as_strings,
+            self.value_labels_as_categorical,
             Some(chunk_size),
             true,
             None,
@@ -149,6 +205,9 @@ impl<'a> ReadBuilder<'a> {
             self.offset,
             Some(limit),
             self.informative_nulls,
+            None,
+            self.use_mmap,
+            self.read_ahead,
         )
         .map_err(|e| Error::ParseError(e.to_string()))?;
 
@@ -176,6 +235,7 @@ impl<'a> ReadBuilder<'a> {
             threads,
             self.missing_string_as_null,
             self.value_labels_as_strings,
+            self.value_labels_as_categorical,
             self.chunk_size,
             true,
             None,
@@ -183,20 +243,20 @@ impl<'a> ReadBuilder<'a> {
             self.offset,
             Some(limit),
             self.informative_nulls.clone(),
+            None,
+            self.use_mmap,
+            self.read_ahead,
         )
         .map_err(|e| Error::ParseError(e.to_string()))?;
 
-        let mut df: Option<DataFrame> = None;
+        let available = (self.reader.metadata.row_count as usize).saturating_sub(self.offset);
+        let mut out = crate::frame_assembly::FrameAssembler::new(limit.min(available));
         while let Some(batch) = iter.next() {
             let batch = batch.map_err(|e| Error::ParseError(e.to_string()))?;
-            if let Some(acc) = df.as_mut() {
-                acc.vstack_mut(&batch)
-                    .map_err(|e| Error::ParseError(e.to_string()))?;
-            } else {
-                df = Some(batch);
-            }
+            out.push(batch)
+                .map_err(|e| Error::ParseError(e.to_string()))?;
         }
-        let mut df = df.unwrap_or_else(DataFrame::empty);
+        let mut df = out.finish().map_err(|e| Error::ParseError(e.to_string()))?;
 
         if let Some(schema) = self.schema {
             df = cast_dataframe(df, &schema)?;
@@ -204,6 +264,17 @@ impl<'a> ReadBuilder<'a> {
 
         Ok(df)
     }
+
+    /// [`finish`](Self::finish) under a fresh [`ReadProfiler`](crate::ReadProfiler),
+    /// also returning its report.
+    pub fn finish_profiled(self) -> Result<(DataFrame, crate::ReadProfile)> {
+        let profiler = crate::ReadProfiler::new();
+        let df = {
+            let _profile = profiler.enter();
+            self.finish()?
+        };
+        Ok((df, profiler.report()))
+    }
 }
 
 fn cast_dataframe(mut df: DataFrame, schema: &Schema) -> Result<DataFrame> {
@@ -1,13 +1,19 @@
 use crate::spss::error::{Error, Result};
 use crate::spss::types::{Alignment, Measure, VarType};
+use flate2::write::ZlibEncoder;
 use polars::prelude::*;
+use rayon::prelude::*;
 use std::collections::HashMap;
 use std::collections::HashSet;
 use std::fs::File;
-use std::io::{BufWriter, Write};
+use std::io::{BufWriter, Seek, SeekFrom, Write};
 use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex};
 
 const SAV_HEADER_LEN: usize = 176;
+const SAV_HEADER_NCASES_OFS: u64 = 80;
+/// Offset of the 64-bit case count within the number-of-cases record.
+const NUMBER_OF_CASES_VALUE_OFS: u64 = 24;
 const SAV_RECORD_VARIABLE: u32 = 2;
 const SAV_RECORD_VALUE_LABEL: u32 = 3;
 const SAV_RECORD_VALUE_LABEL_VARS: u32 = 4;
@@ -31,6 +37,14 @@ const SAV_FLOATING_POINT_REP_IEEE: i32 = 1;
 const SAV_ENDIANNESS_BIG: i32 = 1;
 const SAV_ENDIANNESS_LITTLE: i32 = 2;
 const SAV_CONTINUATION_FORMAT: i32 = 0x011d01;
+const SAV_COMPRESSION_BIAS: f64 = 100.0;
+const SAV_CODE_SPACES: u8 = 254;
+const SAV_CODE_RAW: u8 = 253;
+const SAV_CODE_MISSING: u8 = 255;
+/// Uncompressed size of every zsav block but the last (the value SPSS uses).
+const ZSAV_BLOCK_SIZE: usize = 0x3FF000;
+/// Target raw bytes encoded per parallel work unit.
+const ENCODE_CHUNK_BYTES: usize = 4 * 1024 * 1024;
 
 const SAV_MEASURE_UNKNOWN: i32 = 0;
 const SAV_MEASURE_NOMINAL: i32 = 1;
@@ -90,6 +104,40 @@ pub struct SpssWriteColumn {
     pub string_width_bytes: Option<usize>,
 }
 
+/// Data compression for written files.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SpssCompression {
+    /// Uncompressed `.sav`.
+    None,
+    /// Bytecode-compressed `.sav`.
+    Bytecode,
+    /// Bytecode stream in zlib blocks (`.zsav`).
+    Zlib,
+}
+
+impl SpssCompression {
+    /// `Zlib` for a `.zsav` path, otherwise `None`.
+    fn for_path(path: &Path) -> Self {
+        let zsav = path
+            .extension()
+            .and_then(|e| e.to_str())
+            .is_some_and(|e| e.eq_ignore_ascii_case("zsav"));
+        if zsav {
+            SpssCompression::Zlib
+        } else {
+            SpssCompression::None
+        }
+    }
+
+    fn header_code(self) -> i32 {
+        match self {
+            SpssCompression::None => 0,
+            SpssCompression::Bytecode => 1,
+            SpssCompression::Zlib => 2,
+        }
+    }
+}
+
 pub struct SpssWriter {
     path: PathBuf,
     schema: Option<SpssWriteSchema>,
@@ -99,10 +147,15 @@ pub struct SpssWriter {
     variable_alignments: Option<SpssVariableAlignments>,
     variable_display_widths: Option<SpssVariableDisplayWidths>,
     variable_formats: Option<SpssVariableFormats>,
+    compression: Option<SpssCompression>,
+    n_threads: Option<usize>,
 }
 
 impl SpssWriter {
     pub fn new(path: impl AsRef<Path>) -> Self {
+        let n_threads = std::thread::available_parallelism()
+            .map(|n| n.get().min(4))
+            .unwrap_or(4);
         Self {
             path: path.as_ref().to_path_buf(),
             schema: None,
@@ -112,6 +165,8 @@ impl SpssWriter {
             variable_alignments: None,
             variable_display_widths: None,
             variable_formats: None,
+            compression: None,
+            n_threads: Some(n_threads),
         }
     }
 
@@ -150,6 +205,18 @@ impl SpssWriter {
         self
     }
 
+    /// Data compression. Default: zlib for a `.zsav` path, otherwise none.
+    pub fn with_compression(mut self, compression: SpssCompression) -> Self {
+        self.compression = Some(compression);
+        self
+    }
+
+    /// Threads used to encode rows and compress blocks.
+    pub fn with_n_threads(mut self, n: usize) -> Self {
+        self.n_threads = Some(n);
+        self
+    }
+
     pub fn write_df(&self, df: &DataFrame) -> Result<()> {
         let schema = self.schema.as_ref();
         let value_labels = merge_value_labels(
@@ -161,7 +228,7 @@ impl SpssWriter {
             self.variable_labels.clone(),
         );
         let columns = infer_columns(
-            df,
+            Some(df),
             schema,
             variable_labels.as_ref(),
             self.variable_measures.as_ref(),
@@ -170,33 +237,200 @@ impl SpssWriter {
             self.variable_formats.as_ref(),
         )?;
         let encoding = choose_encoding(
-            df,
+            Some(df),
+            &columns,
+            value_labels.as_ref(),
+            variable_labels.as_ref(),
+        )?;
+        self.write_file(
+            &columns,
+            value_labels.as_ref(),
+            encoding,
+            std::iter::once(df.clone()),
+        )
+    }
+
+    /// Write batches as they arrive, without holding the whole dataset. Rows of each
+    /// batch are encoded (and bytecode-compressed) in parallel chunks, and zsav blocks
+    /// are deflated in parallel; the case count is patched in at the end.
+    ///
+    /// Every `String` column of `schema` needs `string_width_bytes`, and values
+    /// longer than that are an error. `schema.row_count`, when set, is checked.
+    pub fn write_batches_streaming<I>(&self, batches: I, schema: SpssWriteSchema) -> Result<()>
+    where
+        I: IntoIterator<Item = DataFrame>,
+    {
+        let value_labels =
+            merge_value_labels(schema.value_labels.clone(), self.value_labels.clone());
+        let variable_labels =
+            merge_variable_labels(schema.variable_labels.clone(), self.variable_labels.clone());
+        let columns = infer_columns(
+            None,
+            Some(&schema),
+            variable_labels.as_ref(),
+            self.variable_measures.as_ref(),
+            self.variable_alignments.as_ref(),
+            self.variable_display_widths.as_ref(),
+            self.variable_formats.as_ref(),
+        )?;
+        let encoding = choose_encoding(
+            None,
             &columns,
             value_labels.as_ref(),
             variable_labels.as_ref(),
         )?;
+        let rows = self.write_file(&columns, value_labels.as_ref(), encoding, batches)?;
+        if let Some(expected) = schema.row_count {
+            if expected != rows {
+                return Err(Error::ParseError(
+                    "row_count mismatch for batch writing".to_string(),
+                ));
+            }
+        }
+        Ok(())
+    }
+
+    /// Stream `lf` to the file batch by batch. String widths missing from `schema`
+    /// (or all of them, without a schema) are found with a first pass over `lf`.
+    pub fn write_lazy(&self, lf: LazyFrame, schema: Option<SpssWriteSchema>) -> Result<()> {
+        let to_err = |e: PolarsError| Error::ParseError(e.to_string());
+        let lf_schema = lf.clone().collect_schema().map_err(to_err)?;
+        let mut schema = schema.unwrap_or_else(|| SpssWriteSchema {
+            columns: lf_schema
+                .iter()
+                .map(|(name, dtype)| SpssWriteColumn {
+                    name: name.to_string(),
+                    dtype: dtype.clone(),
+                    string_width_bytes: None,
+                })
+                .collect(),
+            row_count: None,
+            value_labels: None,
+            variable_labels: None,
+        });
+        let unsized_strings: Vec<String> = schema
+            .columns
+            .iter()
+            .filter(|c| c.dtype == DataType::String && c.string_width_bytes.is_none())
+            .map(|c| c.name.clone())
+            .collect();
+        if !unsized_strings.is_empty() {
+            let widths = Arc::new(Mutex::new(HashMap::<String, usize>::new()));
+            let prepass_widths = widths.clone();
+            lf.clone()
+                .select(
+                    unsized_strings
+                        .iter()
+                        .map(|name| col(name.as_str()))
+                        .collect::<Vec<_>>(),
+                )
+                .sink_batches(
+                    PlanCallback::new(move |df: DataFrame| {
+                        let mut widths = prepass_widths.lock().map_err(|_| {
+                            PolarsError::ComputeError("width map mutex poisoned".into())
+                        })?;
+                        for column in df.columns() {
+                            let series = column.as_materialized_series();
+                            let width = max_string_width(series)
+                                .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+                            let entry = widths.entry(series.name().to_string()).or_insert(1);
+                            *entry = (*entry).max(width);
+                        }
+                        Ok(false)
+                    }),
+                    true,
+                    None,
+                )
+                .map_err(to_err)?
+                .collect()
+                .map_err(to_err)?;
+            let widths = widths
+                .lock()
+                .map_err(|_| Error::ParseError("width map mutex poisoned".to_string()))?;
+            for column in schema.columns.iter_mut() {
+                if unsized_strings.contains(&column.name) {
+                    column.string_width_bytes =
+                        Some(widths.get(&column.name).copied().unwrap_or(1));
+                }
+            }
+        }
+
+        let (tx, rx) = std::sync::mpsc::sync_channel::<DataFrame>(2);
+        let sink = lf
+            .sink_batches(
+                PlanCallback::new(move |df: DataFrame| Ok(tx.send(df).is_err())),
+                true,
+                None,
+            )
+            .map_err(to_err)?;
+        std::thread::scope(|scope| {
+            let writer = scope.spawn(|| self.write_batches_streaming(rx.into_iter(), schema));
+            let sunk = sink.collect().map_err(to_err);
+            let written = writer
+                .join()
+                .map_err(|_| Error::ParseError("SPSS writer thread panicked".to_string()))?;
+            sunk.and(written)
+        })
+    }
 
+    /// Write the dictionary and the data of `batches`; returns the rows written.
+    fn write_file<I>(
+        &self,
+        columns: &[ColumnSpec],
+        value_labels: Option<&SpssValueLabels>,
+        encoding: &'static encoding_rs::Encoding,
+        batches: I,
+    ) -> Result<usize>
+    where
+        I: IntoIterator<Item = DataFrame>,
+    {
+        let compression = self
+            .compression
+            .unwrap_or_else(|| SpssCompression::for_path(&self.path));
         let file = File::create(&self.path)?;
         let mut writer = BufWriter::with_capacity(8 * 1024 * 1024, file);
 
+        // Case counts are written as "unknown" and patched once the data is out.
         write_header(
             &mut writer,
-            df.height() as i32,
+            -1,
             columns.iter().map(|c| c.width).sum(),
+            compression.header_code(),
         )?;
-        write_variable_records(&mut writer, &columns, encoding)?;
-        if let Some(labels) = value_labels.as_ref() {
-            write_value_labels(&mut writer, &columns, labels, encoding)?;
+        write_variable_records(&mut writer, columns, encoding)?;
+        if let Some(labels) = value_labels {
+            write_value_labels(&mut writer, columns, labels, encoding)?;
         }
         write_integer_info_record(&mut writer, encoding)?;
         write_floating_point_info_record(&mut writer)?;
-        write_variable_display_record(&mut writer, &columns)?;
-        write_long_var_names_record(&mut writer, &columns, encoding)?;
-        write_very_long_string_record(&mut writer, &columns)?;
-        write_number_of_cases_record(&mut writer, df.height() as u64)?;
+        write_variable_display_record(&mut writer, columns)?;
+        write_long_var_names_record(&mut writer, columns, encoding)?;
+        write_very_long_string_record(&mut writer, columns)?;
+        let n_cases_ofs = writer.stream_position()? + NUMBER_OF_CASES_VALUE_OFS;
+        write_number_of_cases_record(&mut writer, u64::MAX)?;
         write_dict_termination(&mut writer)?;
-        write_data(&mut writer, df, &columns, encoding)?;
-        Ok(())
+
+        let parallelism = crate::worker_pool::scan_limit(
+            self.n_threads
+                .unwrap_or_else(crate::default_thread_count)
+                .max(1),
+        );
+        let rows = write_data_batches(
+            &mut writer,
+            parallelism,
+            columns,
+            encoding,
+            compression,
+            batches,
+        )?;
+
+        let header_rows = i32::try_from(rows).unwrap_or(-1);
+        writer.seek(SeekFrom::Start(SAV_HEADER_NCASES_OFS))?;
+        writer.write_all(&header_rows.to_le_bytes())?;
+        writer.seek(SeekFrom::Start(n_cases_ofs))?;
+        writer.write_all(&(rows as u64).to_le_bytes())?;
+        writer.flush()?;
+        Ok(rows)
     }
 }
 
@@ -218,7 +452,7 @@ struct ColumnSpec {
 }
 
 fn infer_columns(
-    df: &DataFrame,
+    df: Option<&DataFrame>,
     schema: Option<&SpssWriteSchema>,
     variable_labels: Option<&SpssVariableLabels>,
     variable_measures: Option<&SpssVariableMeasures>,
@@ -269,6 +503,7 @@ fn infer_columns(
         return Ok(cols);
     }
 
+    let df = df.ok_or_else(|| Error::ParseError("a schema is required".to_string()))?;
     let mut cols = Vec::with_capacity(df.width());
     let names: Vec<String> = df
         .columns()
@@ -382,26 +617,39 @@ fn variable_display_width(
     Ok(width)
 }
 
+/// With `df`, string widths come from the data; without it (streaming) they must be
+/// declared.
 fn dtype_to_spss(
     col: &SpssWriteColumn,
-    df: &DataFrame,
+    df: Option<&DataFrame>,
 ) -> Result<(VarType, usize, usize, u8, u8, u8)> {
     match col.dtype {
         DataType::String => {
-            let series = df
-                .column(&col.name)
-                .map_err(|e| Error::ParseError(e.to_string()))?
-                .as_materialized_series();
-            let scan_width = max_string_width(series)?;
-            if let Some(declared) = col.string_width_bytes {
-                if scan_width > declared {
-                    eprintln!(
-                        "warning: column '{}' declared string_width_bytes={} but data contains strings up to {} bytes; using {}",
-                        col.name, declared, scan_width, scan_width
-                    );
+            let width = match df {
+                Some(df) => {
+                    let series = df
+                        .column(&col.name)
+                        .map_err(|e| Error::ParseError(e.to_string()))?
+                        .as_materialized_series();
+                    let scan_width = max_string_width(series)?;
+                    if let Some(declared) = col.string_width_bytes {
+                        if scan_width > declared {
+                            eprintln!(
+                                "warning: column '{}' declared string_width_bytes={} but data contains strings up to {} bytes; using {}",
+                                col.name, declared, scan_width, scan_width
+                            );
+                        }
+                    }
+                    scan_width
                 }
-            }
-            let (var_type, string_len, width) = string_layout(scan_width)?;
+                None => col.string_width_bytes.ok_or_else(|| {
+                    Error::ParseError(format!(
+                        "streaming SPSS writes need string_width_bytes for column '{}'",
+                        col.name
+                    ))
+                })?,
+            };
+            let (var_type, string_len, width) = string_layout(width)?;
             Ok((
                 var_type,
                 string_len,
@@ -607,7 +855,7 @@ fn merge_variable_labels(
 }
 
 fn choose_encoding(
-    _df: &DataFrame,
+    _df: Option<&DataFrame>,
     _columns: &[ColumnSpec],
     _value_labels: Option<&SpssValueLabels>,
     _variable_labels: Option<&SpssVariableLabels>,
@@ -615,13 +863,18 @@ fn choose_encoding(
     Ok(encoding_rs::UTF_8)
 }
 
-fn write_header<W: Write>(writer: &mut W, row_count: i32, nominal_case_size: usize) -> Result<()> {
+fn write_header<W: Write>(
+    writer: &mut W,
+    row_count: i32,
+    nominal_case_size: usize,
+    compression: i32,
+) -> Result<()> {
     // SAV header layout (176 bytes):
     //   0–3    rec_type "$FL2"
     //   4–63   prod_name (60 bytes, space-padded)
     //   64–67  layout_code = 2
     //   68–71  nominal_case_size
-    //   72–75  compression = 0
+    //   72–75  compression (0 none, 1 bytecode, 2 zlib)
     //   76–79  weight_index = 0
     //   80–83  ncases
     //   84–91  bias = 100.0 (f64)
@@ -635,10 +888,10 @@ fn write_header<W: Write>(writer: &mut W, row_count: i32, nominal_case_size: usi
     buf[4..4 + prod.len()].copy_from_slice(prod);
     buf[64..68].copy_from_slice(&2i32.to_le_bytes());
     buf[68..72].copy_from_slice(&(nominal_case_size as i32).to_le_bytes());
-    buf[72..76].copy_from_slice(&0i32.to_le_bytes());
+    buf[72..76].copy_from_slice(&compression.to_le_bytes());
     buf[76..80].copy_from_slice(&0i32.to_le_bytes());
     buf[80..84].copy_from_slice(&row_count.to_le_bytes());
-    buf[84..92].copy_from_slice(&100.0f64.to_le_bytes());
+    buf[84..92].copy_from_slice(&SAV_COMPRESSION_BIAS.to_le_bytes());
 
     // Write current date/time into the fixed-width fields.
     use std::time::{SystemTime, UNIX_EPOCH};
@@ -1071,76 +1324,369 @@ fn write_dict_termination<W: Write>(writer: &mut W) -> Result<()> {
     Ok(())
 }
 
-fn write_data<W: Write>(
+/// One batch column converted in bulk for encoding.
+enum BatchColumn {
+    Num(Float64Chunked),
+    Str(StringChunked),
+}
+
+/// Encode `batches` and write them as the data section; returns the rows written.
+///
+/// Each batch is cut into row chunks that are encoded (and bytecode-compressed) by
+/// at most `parallelism` tasks on the shared worker pool, then written in order.
+/// Compressed chunks end with zero padding codes so every chunk starts on a fresh
+/// control block.
+fn write_data_batches<W, I>(
     writer: &mut W,
-    df: &DataFrame,
+    parallelism: usize,
     columns: &[ColumnSpec],
     encoding: &'static encoding_rs::Encoding,
-) -> Result<()> {
-    let mut cols: Vec<&Series> = Vec::with_capacity(columns.len());
-    let mut str_cols: Vec<Option<&StringChunked>> = Vec::with_capacity(columns.len());
-    let mut col_offsets: Vec<usize> = Vec::with_capacity(columns.len());
-    let mut col_byte_widths: Vec<usize> = Vec::with_capacity(columns.len());
+    compression: SpssCompression,
+    batches: I,
+) -> Result<usize>
+where
+    W: Write + Seek,
+    I: IntoIterator<Item = DataFrame>,
+{
+    let record_len: usize = columns.iter().map(|c| c.width * 8).sum();
+    let chunk_rows = (ENCODE_CHUNK_BYTES / record_len.max(1)).max(1);
+    let mut zsav = match compression {
+        SpssCompression::Zlib => Some(ZsavBlockWriter::start(writer)?),
+        _ => None,
+    };
 
-    let mut offset = 0usize;
-    for col in columns {
-        let series = df
-            .column(&col.name)
-            .map_err(|e| Error::ParseError(e.to_string()))?;
-        let series = series.as_materialized_series();
-        cols.push(series);
-        col_offsets.push(offset);
-        let byte_width = col.width * 8;
-        col_byte_widths.push(byte_width);
-        offset += byte_width;
-        if col.var_type == VarType::Str {
-            let ca = series.str().map_err(|e| Error::ParseError(e.to_string()))?;
-            str_cols.push(Some(ca));
-        } else {
-            str_cols.push(None);
+    let mut rows = 0usize;
+    for df in batches {
+        let height = df.height();
+        if height == 0 {
+            continue;
         }
+        let data = batch_columns(&df, columns)?;
+        let starts: Vec<usize> = (0..height).step_by(chunk_rows).collect();
+        let encoded: Vec<Result<Vec<u8>>> = crate::worker_pool::install(|| {
+            starts
+                .par_iter()
+                .with_min_len(per_task(starts.len(), parallelism))
+                .map(|&start| {
+                    let len = chunk_rows.min(height - start);
+                    encode_rows(columns, &data, start, len, encoding, compression)
+                })
+                .collect()
+        });
+        for chunk in encoded {
+            let chunk = chunk?;
+            match zsav.as_mut() {
+                Some(zsav) => zsav.push(writer, parallelism, &chunk)?,
+                None => writer.write_all(&chunk)?,
+            }
+        }
+        rows += height;
+    }
+    if let Some(zsav) = zsav {
+        zsav.finish(writer, parallelism)?;
     }
+    Ok(rows)
+}
 
-    let record_len = offset;
-    let mut row_buf = vec![0u8; record_len];
+/// Items per task when `len` items are split across `parallelism` tasks.
+fn per_task(len: usize, parallelism: usize) -> usize {
+    ((len + parallelism.max(1) - 1) / parallelism.max(1)).max(1)
+}
 
-    for row_idx in 0..df.height() {
-        for (col_idx, col) in columns.iter().enumerate() {
-            let series = cols[col_idx];
-            let cell = &mut row_buf[col_offsets[col_idx]..col_offsets[col_idx] + col_byte_widths[col_idx]];
+fn batch_columns(df: &DataFrame, columns: &[ColumnSpec]) -> Result<Vec<BatchColumn>> {
+    columns
+        .iter()
+        .map(|col| {
+            let series = df
+                .column(&col.name)
+                .map_err(|e| Error::ParseError(e.to_string()))?
+                .as_materialized_series();
             match col.var_type {
-                VarType::Numeric => {
-                    let value = series
-                        .get(row_idx)
-                        .map_err(|e| Error::ParseError(e.to_string()))?;
-                    if value.is_null() {
-                        cell[..8].copy_from_slice(&SAV_MISSING_DOUBLE.to_le_bytes());
+                VarType::Numeric => Ok(BatchColumn::Num(numeric_values(series)?)),
+                VarType::Str => {
+                    let ca = series.str().map_err(|e| Error::ParseError(e.to_string()))?;
+                    Ok(BatchColumn::Str(ca.clone()))
+                }
+            }
+        })
+        .collect()
+}
+
+/// Stored SPSS values of a numeric column: dates and datetimes as seconds since the
+/// SPSS epoch (whole seconds), times as whole seconds, booleans as 1/0.
+fn numeric_values(series: &Series) -> Result<Float64Chunked> {
+    let to_err = |e: PolarsError| Error::ParseError(e.to_string());
+    let as_i64 = |s: &Series| -> Result<Int64Chunked> {
+        Ok(s.to_physical_repr()
+            .cast(&DataType::Int64)
+            .map_err(to_err)?
+            .i64()
+            .map_err(to_err)?
+            .clone())
+    };
+    let values = match series.dtype() {
+        DataType::Float64 => series.f64().map_err(to_err)?.clone(),
+        dt if dt.is_primitive_numeric() || dt == &DataType::Boolean => series
+            .cast(&DataType::Float64)
+            .map_err(to_err)?
+            .f64()
+            .map_err(to_err)?
+            .clone(),
+        DataType::Date => map_i64(&as_i64(series)?, |days| days * 86_400 + SPSS_SEC_SHIFT),
+        DataType::Datetime(unit, _) => {
+            let per_ms = match unit {
+                TimeUnit::Milliseconds => 1,
+                TimeUnit::Microseconds => 1_000,
+                TimeUnit::Nanoseconds => 1_000_000,
+            };
+            map_i64(&as_i64(series)?, |v| v / per_ms / 1_000 + SPSS_SEC_SHIFT)
+        }
+        DataType::Time => map_i64(&as_i64(series)?, |ns| ns / 1_000_000_000),
+        _ => return Err(Error::ParseError("unsupported numeric type".to_string())),
+    };
+    Ok(values)
+}
+
+fn map_i64(ca: &Int64Chunked, f: impl Fn(i64) -> i64) -> Float64Chunked {
+    ca.into_iter().map(|v| v.map(|v| f(v) as f64)).collect()
+}
+
+/// Encode rows `start..start + len` of a batch as raw records or bytecode.
+fn encode_rows(
+    columns: &[ColumnSpec],
+    data: &[BatchColumn],
+    start: usize,
+    len: usize,
+    encoding: &'static encoding_rs::Encoding,
+    compression: SpssCompression,
+) -> Result<Vec<u8>> {
+    enum Values<'a> {
+        Num(Vec<Option<f64>>),
+        Str(Vec<Option<&'a str>>),
+    }
+    let slices: Vec<BatchColumn> = data
+        .iter()
+        .map(|col| match col {
+            BatchColumn::Num(ca) => BatchColumn::Num(ca.slice(start as i64, len)),
+            BatchColumn::Str(ca) => BatchColumn::Str(ca.slice(start as i64, len)),
+        })
+        .collect();
+    let sliced: Vec<Values> = slices
+        .iter()
+        .map(|col| match col {
+            BatchColumn::Num(ca) => Values::Num(ca.into_iter().collect()),
+            BatchColumn::Str(ca) => Values::Str(ca.into_iter().collect()),
+        })
+        .collect();
+
+    let record_len: usize = columns.iter().map(|c| c.width * 8).sum();
+    let mut out = Vec::with_capacity(match compression {
+        SpssCompression::None => record_len * len,
+        _ => record_len * len / 2 + 16,
+    });
+    let mut codes = Bytecoder::default();
+    let mut cell = Vec::new();
+    for row in 0..len {
+        for (col, values) in columns.iter().zip(sliced.iter()) {
+            match values {
+                Values::Num(values) => {
+                    let value = values[row];
+                    if compression == SpssCompression::None {
+                        let bits = value.map_or(SAV_MISSING_DOUBLE, f64::to_bits);
+                        out.extend_from_slice(&bits.to_le_bytes());
                     } else {
-                        let v = anyvalue_to_f64(value)
-                            .ok_or(Error::ParseError("unsupported numeric type".to_string()))?;
-                        cell[..8].copy_from_slice(&v.to_le_bytes());
+                        codes.push_number(&mut out, value);
                     }
                 }
-                VarType::Str => {
-                    let ca = str_cols[col_idx].ok_or_else(|| {
-                        Error::ParseError("missing utf8 accessor for string column".to_string())
-                    })?;
-                    cell.fill(b' ');
-                    if let Some(s) = ca.get(row_idx) {
+                Values::Str(values) => {
+                    cell.clear();
+                    cell.resize(col.width * 8, b' ');
+                    if let Some(s) = values[row] {
                         let (bytes, _, had_errors) = encoding.encode(s);
                         if had_errors {
                             return Err(Error::ParseError(
                                 "string not representable in target encoding".to_string(),
                             ));
                         }
-                        write_spss_string_value(cell, bytes.as_ref(), col.string_len);
+                        if bytes.len() > col.string_len {
+                            return Err(Error::ParseError(format!(
+                                "column '{}' has a {}-byte value but is declared {} bytes wide",
+                                col.name,
+                                bytes.len(),
+                                col.string_len
+                            )));
+                        }
+                        write_spss_string_value(&mut cell, bytes.as_ref(), col.string_len);
+                    }
+                    if compression == SpssCompression::None {
+                        out.extend_from_slice(&cell);
+                    } else {
+                        for segment in cell.chunks_exact(8) {
+                            codes.push_string(&mut out, segment.try_into().unwrap());
+                        }
                     }
                 }
             }
         }
-        writer.write_all(&row_buf)?;
     }
-    Ok(())
+    codes.finish(&mut out);
+    Ok(out)
+}
+
+/// Bytecode compressor: each control block of eight codes is followed by the raw
+/// 8-byte values of its 253 codes.
+#[derive(Default)]
+struct Bytecoder {
+    codes: [u8; 8],
+    n_codes: usize,
+    raw: Vec<u8>,
+}
+
+impl Bytecoder {
+    fn push_number(&mut self, out: &mut Vec<u8>, value: Option<f64>) {
+        match value {
+            None => self.push(out, SAV_CODE_MISSING, None),
+            Some(v) if v.fract() == 0.0 && (1.0..=251.0).contains(&(v + SAV_COMPRESSION_BIAS)) => {
+                let code = (v + SAV_COMPRESSION_BIAS) as u8;
+                self.push(out, code, None)
+            }
+            Some(v) => self.push(out, SAV_CODE_RAW, Some(v.to_le_bytes())),
+        }
+    }
+
+    fn push_string(&mut self, out: &mut Vec<u8>, segment: [u8; 8]) {
+        if segment == [b' '; 8] {
+            self.push(out, SAV_CODE_SPACES, None);
+        } else {
+            self.push(out, SAV_CODE_RAW, Some(segment));
+        }
+    }
+
+    fn push(&mut self, out: &mut Vec<u8>, code: u8, raw: Option<[u8; 8]>) {
+        self.codes[self.n_codes] = code;
+        self.n_codes += 1;
+        if let Some(raw) = raw {
+            self.raw.extend_from_slice(&raw);
+        }
+        if self.n_codes == 8 {
+            self.flush(out);
+        }
+    }
+
+    fn flush(&mut self, out: &mut Vec<u8>) {
+        out.extend_from_slice(&self.codes);
+        out.append(&mut self.raw);
+        self.codes = [0; 8];
+        self.n_codes = 0;
+    }
+
+    /// Flush a partial control block, padded with zero codes.
+    fn finish(&mut self, out: &mut Vec<u8>) {
+        if self.n_codes > 0 {
+            self.flush(out);
+        }
+    }
+}
+
+/// Cuts the bytecode stream into zsav blocks, deflates a window of them at a time
+/// (one block per encode task), and writes the block table (ztrailer) at the end.
+struct ZsavBlockWriter {
+    zheader_ofs: u64,
+    pending: Vec<u8>,
+    /// (uncompressed_ofs, compressed_ofs, uncompressed_size, compressed_size)
+    entries: Vec<(u64, u64, usize, usize)>,
+    uncompressed_ofs: u64,
+    compressed_ofs: u64,
+}
+
+impl ZsavBlockWriter {
+    /// Reserve the zheader at the current position.
+    fn start<W: Write + Seek>(writer: &mut W) -> Result<Self> {
+        let zheader_ofs = writer.stream_position()?;
+        writer.write_all(&[0u8; 24])?;
+        Ok(Self {
+            zheader_ofs,
+            pending: Vec::new(),
+            entries: Vec::new(),
+            uncompressed_ofs: zheader_ofs,
+            compressed_ofs: zheader_ofs + 24,
+        })
+    }
+
+    fn push<W: Write>(&mut self, writer: &mut W, parallelism: usize, bytes: &[u8]) -> Result<()> {
+        self.pending.extend_from_slice(bytes);
+        let window = ZSAV_BLOCK_SIZE * parallelism.max(1);
+        if self.pending.len() >= window {
+            let full = self.pending.len() / ZSAV_BLOCK_SIZE * ZSAV_BLOCK_SIZE;
+            let blocks: Vec<u8> = self.pending.drain(..full).collect();
+            self.write_blocks(writer, parallelism, &blocks)?;
+        }
+        Ok(())
+    }
+
+    fn write_blocks<W: Write>(
+        &mut self,
+        writer: &mut W,
+        parallelism: usize,
+        bytes: &[u8],
+    ) -> Result<()> {
+        let n_blocks = (bytes.len() + ZSAV_BLOCK_SIZE - 1) / ZSAV_BLOCK_SIZE;
+        let deflated: Vec<Result<Vec<u8>>> = crate::worker_pool::install(|| {
+            bytes
+                .par_chunks(ZSAV_BLOCK_SIZE)
+                .with_min_len(per_task(n_blocks, parallelism))
+                .map(|block| {
+                    let mut encoder = ZlibEncoder::new(
+                        Vec::with_capacity(block.len() / 2),
+                        flate2::Compression::default(),
+                    );
+                    encoder.write_all(block)?;
+                    Ok(encoder.finish()?)
+                })
+                .collect()
+        });
+        for (block, compressed) in bytes.chunks(ZSAV_BLOCK_SIZE).zip(deflated) {
+            let compressed = compressed?;
+            writer.write_all(&compressed)?;
+            self.entries.push((
+                self.uncompressed_ofs,
+                self.compressed_ofs,
+                block.len(),
+                compressed.len(),
+            ));
+            self.uncompressed_ofs += block.len() as u64;
+            self.compressed_ofs += compressed.len() as u64;
+        }
+        Ok(())
+    }
+
+    /// Write the last block and the ztrailer, then fill in the zheader.
+    fn finish<W: Write + Seek>(mut self, writer: &mut W, parallelism: usize) -> Result<()> {
+        let rest = std::mem::take(&mut self.pending);
+        self.write_blocks(writer, parallelism, &rest)?;
+
+        let ztrailer_ofs = self.compressed_ofs;
+        writer.write_all(&(-(SAV_COMPRESSION_BIAS as i64)).to_le_bytes())?;
+        writer.write_all(&0i64.to_le_bytes())?;
+        writer.write_all(&(ZSAV_BLOCK_SIZE as i32).to_le_bytes())?;
+        writer.write_all(&(self.entries.len() as i32).to_le_bytes())?;
+        for &(uncompressed_ofs, compressed_ofs, uncompressed_size, compressed_size) in &self.entries
+        {
+            writer.write_all(&(uncompressed_ofs as i64).to_le_bytes())?;
+            writer.write_all(&(compressed_ofs as i64).to_le_bytes())?;
+            writer.write_all(&(uncompressed_size as i32).to_le_bytes())?;
+            writer.write_all(&(compressed_size as i32).to_le_bytes())?;
+        }
+        let ztrailer_len = 24 + 24 * self.entries.len() as u64;
+        let end = writer.stream_position()?;
+
+        writer.seek(SeekFrom::Start(self.zheader_ofs))?;
+        writer.write_all(&self.zheader_ofs.to_le_bytes())?;
+        writer.write_all(&ztrailer_ofs.to_le_bytes())?;
+        writer.write_all(&ztrailer_len.to_le_bytes())?;
+        writer.seek(SeekFrom::Start(end))?;
+        Ok(())
+    }
 }
 
 #[cfg(test)]
@@ -1397,6 +1943,91 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_spss_streaming_write_matches_write_df() {
+        let n = 30_000usize;
+        let small: Vec<Option<i32>> = (0..n)
+            .map(|i| {
+                if i % 11 == 0 {
+                    None
+                } else {
+                    Some(i as i32 % 300 - 120)
+                }
+            })
+            .collect();
+        let real: Vec<f64> = (0..n).map(|i| i as f64 / 3.0).collect();
+        let text: Vec<Option<String>> = (0..n)
+            .map(|i| match i % 5 {
+                0 => None,
+                1 => Some(String::new()),
+                _ => Some(format!("{i}").repeat(i % 50)),
+            })
+            .collect();
+        let df = df!("small" => small, "real" => real, "text" => text).unwrap();
+
+        let reference_path = temp_path("spss_stream_reference", "sav");
+        SpssWriter::new(&reference_path).write_df(&df).unwrap();
+        let expected = SpssReader::open(&reference_path)
+            .unwrap()
+            .read()
+            .finish()
+            .unwrap();
+        let schema = SpssWriteSchema {
+            columns: df
+                .schema()
+                .iter()
+                .map(|(name, dtype)| SpssWriteColumn {
+                    name: name.to_string(),
+                    dtype: dtype.clone(),
+                    string_width_bytes: (dtype == &DataType::String).then_some(300),
+                })
+                .collect(),
+            row_count: Some(n),
+            value_labels: None,
+            variable_labels: None,
+        };
+
+        for (compression, ext) in [
+            (SpssCompression::None, "sav"),
+            (SpssCompression::Bytecode, "sav"),
+            (SpssCompression::Zlib, "zsav"),
+        ] {
+            let out_path = temp_path("spss_stream", ext);
+            let batches = (0..n)
+                .step_by(7_000)
+                .map(|start| df.slice(start as i64, 7_000));
+            SpssWriter::new(&out_path)
+                .with_compression(compression)
+                .with_n_threads(3)
+                .write_batches_streaming(batches, schema.clone())
+                .unwrap();
+            let got = SpssReader::open(&out_path)
+                .unwrap()
+                .read()
+                .finish()
+                .unwrap();
+            assert_df_equal(&expected, &got).unwrap_or_else(|e| panic!("{compression:?}: {e}"));
+            let _ = std::fs::remove_file(&out_path);
+        }
+
+        let too_wide = SpssWriteSchema {
+            columns: vec![SpssWriteColumn {
+                name: "text".to_string(),
+                dtype: DataType::String,
+                string_width_bytes: Some(4),
+            }],
+            row_count: None,
+            value_labels: None,
+            variable_labels: None,
+        };
+        let out_path = temp_path("spss_stream_too_wide", "sav");
+        let err = SpssWriter::new(&out_path)
+            .write_batches_streaming([df.select(["text"]).unwrap()], too_wide);
+        assert!(err.is_err());
+        let _ = std::fs::remove_file(&out_path);
+        let _ = std::fs::remove_file(&reference_path);
+    }
+
     #[test]
     fn test_spss_roundtrip_very_long_string_preserves_suffix() {
         let long = format!("{}{}", "x".repeat(3000), "_end");
@@ -1456,40 +2087,6 @@ mod tests {
     }
 }
 
-fn anyvalue_to_f64(v: AnyValue) -> Option<f64> {
-    match v {
-        AnyValue::Float64(v) => Some(v),
-        AnyValue::Float32(v) => Some(v as f64),
-        AnyValue::Int64(v) => Some(v as f64),
-        AnyValue::Int32(v) => Some(v as f64),
-        AnyValue::Int16(v) => Some(v as f64),
-        AnyValue::Int8(v) => Some(v as f64),
-        AnyValue::UInt64(v) => Some(v as f64),
-        AnyValue::UInt32(v) => Some(v as f64),
-        AnyValue::UInt16(v) => Some(v as f64),
-        AnyValue::UInt8(v) => Some(v as f64),
-        AnyValue::Boolean(v) => Some(if v { 1.0 } else { 0.0 }),
-        AnyValue::Date(v) => {
-            let secs = (v as i64) * 86_400 + SPSS_SEC_SHIFT;
-            Some(secs as f64)
-        }
-        AnyValue::Datetime(v, unit, _) => {
-            let ms = match unit {
-                TimeUnit::Milliseconds => v,
-                TimeUnit::Microseconds => v / 1_000,
-                TimeUnit::Nanoseconds => v / 1_000_000,
-            };
-            let secs = ms / 1_000;
-            Some((secs + SPSS_SEC_SHIFT) as f64)
-        }
-        AnyValue::Time(v) => {
-            let secs = v / 1_000_000_000;
-            Some(secs as f64)
-        }
-        _ => None,
-    }
-}
-
 fn write_name<W: Write>(writer: &mut W, name: &str) -> Result<()> {
     let mut buf = [b' '; 8];
     let bytes = name.as_bytes();
@@ -6,6 +6,7 @@ use polars_arrow::ffi::{
     export_array_to_c, export_field_to_c, export_iterator, ArrowArray, ArrowArrayStream,
     ArrowSchema,
 };
+use std::collections::VecDeque;
 use std::path::Path;
 
 fn build_struct_field(schema: &SchemaRef) -> ArrowField {
@@ -26,6 +27,31 @@ fn df_to_struct_array(df: &DataFrame, field: &ArrowField) -> PolarsResult<Struct
     StructArray::try_new(struct_dtype, len, arrays, None)
 }
 
+/// Export a batch as one struct array per chunk. The column chunks are handed
+/// over as they are (buffers are shared, not copied); chunks are only realigned
+/// when columns are split at different rows.
+fn df_to_struct_batches(
+    mut df: DataFrame,
+    field: &ArrowField,
+) -> PolarsResult<Vec<Box<dyn polars_arrow::array::Array>>> {
+    if df.height() == 0 {
+        return Ok(Vec::new());
+    }
+    if df.width() == 0 {
+        return Ok(vec![Box::new(df_to_struct_array(&df, field)?)]);
+    }
+    let struct_dtype = field.dtype().clone();
+    df.align_chunks();
+    df.iter_chunks(CompatLevel::newest(), false)
+        .filter(|batch| batch.len() > 0)
+        .map(|batch| {
+            let len = batch.len();
+            StructArray::try_new(struct_dtype.clone(), len, batch.into_arrays(), None)
+                .map(|array| Box::new(array) as Box<dyn polars_arrow::array::Array>)
+        })
+        .collect()
+}
+
 pub fn read_to_arrow_schema_ffi(
     path: &Path,
     threads: Option<usize>,
@@ -42,6 +68,13 @@ pub fn read_to_arrow_schema_ffi(
         preserve_order: Some(true),
         row_index_name: None,
         compress_opts: crate::CompressOptionsLite::default(),
+        row_filter: None,
+        use_mmap: None,
+        read_ahead: None,
+        memory_budget: None,
+        value_labels_as_categorical: None,
+        profile: None,
+        sample: None,
     };
     let schema = scan_dta(path.to_path_buf(), opts)?.collect_schema()?;
     let field = build_struct_field(&schema);
@@ -65,6 +98,13 @@ pub fn read_to_arrow_array_ffi(
         preserve_order: Some(true),
         row_index_name: None,
         compress_opts: crate::CompressOptionsLite::default(),
+        row_filter: None,
+        use_mmap: None,
+        read_ahead: None,
+        memory_budget: None,
+        value_labels_as_categorical: None,
+        profile: None,
+        sample: None,
     };
     let df = scan_dta(path.to_path_buf(), opts)?.collect()?;
     let field = build_struct_field(&df.schema());
@@ -84,6 +124,38 @@ pub fn read_to_arrow_stream_ffi(
     offset: usize,
     n_rows: Option<usize>,
 ) -> PolarsResult<*mut ArrowArrayStream> {
+    read_to_arrow_stream_ffi_with_budget(
+        path,
+        threads,
+        missing_string_as_null,
+        value_labels_as_strings,
+        chunk_size,
+        offset,
+        n_rows,
+        None,
+    )
+}
+
+/// [`read_to_arrow_stream_ffi`] with a byte budget for the batches held in
+/// flight; `None` keeps the unbudgeted behaviour.
+pub fn read_to_arrow_stream_ffi_with_budget(
+    path: &Path,
+    threads: Option<usize>,
+    missing_string_as_null: bool,
+    value_labels_as_strings: Option<bool>,
+    chunk_size: Option<usize>,
+    offset: usize,
+    n_rows: Option<usize>,
+    memory_budget: Option<usize>,
+) -> PolarsResult<*mut ArrowArrayStream> {
+    let (chunk_size, handoff_budget) = crate::mem_budget::plan_stream(
+        path,
+        crate::ReadStatFormat::Stata,
+        None,
+        memory_budget,
+        threads,
+        chunk_size,
+    )?;
     let opts = crate::ScanOptions {
         threads,
         chunk_size,
@@ -93,17 +165,25 @@ pub fn read_to_arrow_stream_ffi(
         preserve_order: Some(true),
         row_index_name: None,
         compress_opts: crate::CompressOptionsLite::default(),
+        row_filter: None,
+        use_mmap: None,
+        read_ahead: None,
+        memory_budget,
+        value_labels_as_categorical: None,
+        profile: None,
+        sample: None,
     };
     let mut lf = scan_dta(path.to_path_buf(), opts.clone())?;
     let schema = lf.collect_schema()?;
     let field = build_struct_field(&schema);
     let field_for_iter = field.clone();
 
-    let mut iter = stata_batch_iter(
+    let iter = stata_batch_iter(
         path.to_path_buf(),
         opts.threads,
         missing_string_as_null,
         value_labels_as_strings.unwrap_or(true),
+        opts.value_labels_as_categorical.unwrap_or(false),
         chunk_size,
         true,
         None,
@@ -111,15 +191,24 @@ pub fn read_to_arrow_stream_ffi(
         offset,
         n_rows,
         None,
+        None,
+        false,
+        opts.read_ahead,
     )?;
-    let iter = Box::new(std::iter::from_fn(move || {
-        let next = iter.next()?;
-        match next {
-            Ok(df) => match df_to_struct_array(&df, &field_for_iter) {
-                Ok(array) => Some(Ok(Box::new(array) as Box<dyn polars_arrow::array::Array>)),
-                Err(e) => Some(Err(e)),
+    let mut iter = crate::scan_prefetch::bounded_batches(Box::new(iter), handoff_budget);
+    // Batches are converted only when the consumer asks for the next array, so the
+    // reader's bounded channels throttle it to the consumer's pace.
+    let mut pending = VecDeque::new();
+    let iter = Box::new(std::iter::from_fn(move || loop {
+        if let Some(array) = pending.pop_front() {
+            return Some(Ok(array));
+        }
+        match iter.next()? {
+            Ok(df) => match df_to_struct_batches(df, &field_for_iter) {
+                Ok(arrays) => pending.extend(arrays),
+                Err(e) => return Some(Err(e)),
             },
-            Err(e) => Some(Err(e)),
+            Err(e) => return Some(Err(e)),
         }
     }));
 
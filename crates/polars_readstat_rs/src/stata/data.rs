@@ -1,3 +1,8 @@
+use crate::label_categories::{CategoricalBuilder, LabelCategories, LabelKey};
+use crate::mmap_source::{open_input, FileSource, SharedInput, SharedMap};
+use crate::null_indicator::IndicatorBuilder;
+use crate::numeric_column::NumericColumnBuilder;
+use crate::read_profile::{self, ProfileStage, Tally};
 use crate::stata::encoding;
 use crate::stata::error::{Error, Result};
 use crate::stata::types::{Endian, Metadata, NumericType, VarType};
@@ -5,45 +10,83 @@ use crate::stata::value::{
     missing_rules, offset_to_stata_label, read_f32, read_f32_tagged, read_f64, read_f64_tagged,
     read_i16, read_i16_tagged, read_i32, read_i32_tagged, read_i8, read_i8_tagged,
 };
+use crate::string_intern::StringInterner;
+use crate::transpose::{ColumnStrips, FieldSpan};
 use byteorder::ReadBytesExt;
 use polars::prelude::*;
+use std::borrow::Cow;
 use std::collections::{HashMap, HashSet};
-use std::fs::File;
-use std::io::{BufReader, Read, Seek, SeekFrom};
+use std::io::{Read, Seek, SeekFrom};
 use std::path::Path;
 use std::sync::Arc;
 
 pub struct SharedDecode {
-    strls: Option<Arc<HashMap<(u32, u64), String>>>,
+    strls: Option<Arc<StrlTable>>,
     label_maps: Arc<HashMap<String, Arc<LabelMap>>>,
+    /// Shared input when the mmap or read-ahead backend is enabled.
+    input: Option<SharedInput>,
 }
 
+impl SharedDecode {
+    fn open(&self, path: &Path) -> Result<FileSource> {
+        Ok(FileSource::open(
+            path,
+            8 * 1024 * 1024,
+            self.input.as_ref(),
+        )?)
+    }
+
+    /// A strL fetcher for one read call, or `None` when no projected column is a strL.
+    fn strl_reader<'a>(&'a self, path: &'a Path) -> Option<StrlReader<'a>> {
+        let table = self.strls.as_deref()?;
+        Some(StrlReader {
+            table,
+            map: self.input.as_ref().and_then(SharedInput::mapped),
+            path,
+            file: None,
+            windows: Vec::new(),
+            last: None,
+            value: String::new(),
+        })
+    }
+}
+
+/// `columns` is the projection the decode will serve; the strL section is only
+/// indexed when it contains a strL column. With `value_labels_as_categorical`
+/// (and `value_labels_as_strings`), labelled columns decode to `Categorical`
+/// codes.
 pub fn build_shared_decode(
     path: &Path,
     metadata: &Metadata,
     endian: Endian,
     ds_format: u16,
+    columns: Option<&[usize]>,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 ) -> Result<SharedDecode> {
-    let file = File::open(path)?;
-    let mut reader = BufReader::with_capacity(8 * 1024 * 1024, file);
-    let strls = if metadata
-        .variables
-        .iter()
-        .any(|v| matches!(v.var_type, VarType::StrL))
-    {
-        load_strls(&mut reader, metadata, endian, ds_format, metadata.encoding)?
+    let input = open_input(use_mmap, read_ahead, path);
+    let is_strl = |i: usize| matches!(metadata.variables[i].var_type, VarType::StrL);
+    let wants_strls = match columns {
+        Some(cols) => cols.iter().any(|&i| is_strl(i)),
+        None => (0..metadata.variables.len()).any(is_strl),
+    };
+    let strls = if wants_strls {
+        let mut reader = FileSource::open(path, 64 * 1024, input.as_ref())?;
+        StrlTable::build(&mut reader, metadata, endian, ds_format)?
     } else {
         None
     };
     let label_maps = if value_labels_as_strings {
-        build_label_maps(metadata)
+        build_label_maps(metadata, value_labels_as_categorical)
     } else {
         HashMap::new()
     };
     Ok(SharedDecode {
         strls: strls.map(Arc::new),
         label_maps: Arc::new(label_maps),
+        input,
     })
 }
 
@@ -58,10 +101,12 @@ pub fn read_data_frame_range(
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
     shared: &SharedDecode,
+    row_filter: Option<&crate::RowFilter>,
 ) -> Result<DataFrame> {
-    let file = File::open(path)?;
+    let _decode = read_profile::span(ProfileStage::RowDecode);
     let data_offset = metadata.data_offset.ok_or_else(|| Error::MissingMetadata)?;
-    let mut reader = BufReader::with_capacity(8 * 1024 * 1024, file);
+    let mut reader = shared.open(path)?;
+    let mut strl_reader = shared.strl_reader(path);
 
     reader.seek(SeekFrom::Start(data_offset))?;
     if ds_format >= 117 {
@@ -71,6 +116,16 @@ pub fn read_data_frame_range(
     let label_maps = shared.label_maps.as_ref();
 
     let rules = missing_rules(ds_format);
+    let mut row_filter = row_filter.and_then(|f| {
+        StataRowFilter::compile(
+            f,
+            metadata,
+            ds_format,
+            endian,
+            missing_string_as_null,
+            label_maps,
+        )
+    });
     let (col_indices, mut builders, col_offsets, col_widths, col_labels, mut string_scratch) =
         build_column_builders(
             metadata,
@@ -110,6 +165,7 @@ pub fn read_data_frame_range(
             limit,
             endian,
             rules,
+            row_filter.as_mut(),
         )?;
     } else {
         let start_row = offset;
@@ -119,8 +175,13 @@ pub fn read_data_frame_range(
             reader.seek(SeekFrom::Current(byte_skip as i64))?;
         }
 
+        let mut tally = Tally::new();
         for _row_idx in start_row..end_row {
             reader.read_exact(&mut row_buf)?;
+            rows_read += 1;
+            if row_filter.as_mut().is_some_and(|f| !f.matches(&row_buf)) {
+                continue;
+            }
 
             for (i, &col_idx) in col_indices.iter().enumerate() {
                 let col_offset = col_offsets[i];
@@ -145,7 +206,7 @@ pub fn read_data_frame_range(
                         && (var.name == "utf8_strl" || var.name == "ascii_strl")
                         && matches!(builders[i], ColumnBuilder::Utf8(_))
                     {
-                        if let Some(strls) = shared.strls.as_ref().map(|v| v.as_ref()) {
+                        if let Some(strls) = strl_reader.as_mut() {
                             if let ColumnBuilder::Utf8(b) = &mut builders[i] {
                                 let o = (_row_idx + 1) as u64;
                                 if o == 4 {
@@ -175,7 +236,7 @@ pub fn read_data_frame_range(
                                     b.append_value("");
                                     continue;
                                 }
-                                if let Some(s) = strls.get(&(5u32, o)) {
+                                if let Some(s) = strls.get(5, o)? {
                                     if missing_string_as_null && s.is_empty() {
                                         b.append_null();
                                     } else {
@@ -194,15 +255,14 @@ pub fn read_data_frame_range(
                     endian,
                     rules,
                     missing_string_as_null,
-                    shared.strls.as_ref().map(|v| v.as_ref()),
+                    strl_reader.as_mut(),
                     ds_format,
                     col_labels[i].as_deref(),
                     metadata.encoding,
                     string_scratch[i].as_mut(),
+                    &mut tally,
                 )?;
             }
-
-            rows_read += 1;
         }
     }
 
@@ -233,11 +293,13 @@ pub fn read_data_frame_streaming(
     value_labels_as_strings: bool,
     shared: &SharedDecode,
     batch_size: usize,
+    row_filter: Option<&crate::RowFilter>,
     on_batch: &mut dyn FnMut(DataFrame) -> bool,
 ) -> Result<()> {
-    let file = File::open(path)?;
+    let _decode = read_profile::span(ProfileStage::RowDecode);
     let data_offset = metadata.data_offset.ok_or_else(|| Error::MissingMetadata)?;
-    let mut reader = BufReader::with_capacity(8 * 1024 * 1024, file);
+    let mut reader = shared.open(path)?;
+    let mut strl_reader = shared.strl_reader(path);
 
     reader.seek(SeekFrom::Start(data_offset))?;
     if ds_format >= 117 {
@@ -246,6 +308,16 @@ pub fn read_data_frame_streaming(
 
     let label_maps = shared.label_maps.as_ref();
     let rules = missing_rules(ds_format);
+    let mut row_filter = row_filter.and_then(|f| {
+        StataRowFilter::compile(
+            f,
+            metadata,
+            ds_format,
+            endian,
+            missing_string_as_null,
+            label_maps,
+        )
+    });
     let total_rows = metadata.row_count as usize;
     let start_row = offset;
     let end_row = (offset + limit).min(total_rows);
@@ -300,6 +372,10 @@ pub fn read_data_frame_streaming(
             let mut read = 0usize;
             while read < batch_rows {
                 reader.read_exact(&mut row_buf)?;
+                read += 1;
+                if row_filter.as_mut().is_some_and(|f| !f.matches(&row_buf)) {
+                    continue;
+                }
                 for plan in &plans {
                     let slice = &row_buf[plan.offset..plan.offset + plan.width];
                     match (&mut builders[plan.builder_idx], plan.kind) {
@@ -341,14 +417,18 @@ pub fn read_data_frame_streaming(
                         _ => {}
                     }
                 }
-                read += 1;
             }
             row_idx += read;
         } else {
+            let mut tally = Tally::new();
             let mut read = 0usize;
             while read < batch_rows {
                 let abs_row = row_idx + read;
                 reader.read_exact(&mut row_buf)?;
+                read += 1;
+                if row_filter.as_mut().is_some_and(|f| !f.matches(&row_buf)) {
+                    continue;
+                }
 
                 for (i, &col_idx) in col_indices.iter().enumerate() {
                     let col_offset = col_offsets[i];
@@ -373,7 +453,7 @@ pub fn read_data_frame_streaming(
                             && (var.name == "utf8_strl" || var.name == "ascii_strl")
                             && matches!(builders[i], ColumnBuilder::Utf8(_))
                         {
-                            if let Some(strls) = shared.strls.as_ref().map(|v| v.as_ref()) {
+                            if let Some(strls) = strl_reader.as_mut() {
                                 if let ColumnBuilder::Utf8(b) = &mut builders[i] {
                                     let o = (abs_row + 1) as u64;
                                     if o == 4 {
@@ -403,7 +483,7 @@ pub fn read_data_frame_streaming(
                                         b.append_value("");
                                         continue;
                                     }
-                                    if let Some(s) = strls.get(&(5u32, o)) {
+                                    if let Some(s) = strls.get(5, o)? {
                                         if missing_string_as_null && s.is_empty() {
                                             b.append_null();
                                         } else {
@@ -422,15 +502,14 @@ pub fn read_data_frame_streaming(
                         endian,
                         rules,
                         missing_string_as_null,
-                        shared.strls.as_ref().map(|v| v.as_ref()),
+                        strl_reader.as_mut(),
                         ds_format,
                         col_labels[i].as_deref(),
                         metadata.encoding,
                         string_scratch[i].as_mut(),
+                        &mut tally,
                     )?;
                 }
-
-                read += 1;
             }
             row_idx += read;
         }
@@ -495,7 +574,7 @@ fn build_numeric_plans(
 }
 
 fn read_numeric_only(
-    reader: &mut BufReader<File>,
+    reader: &mut FileSource,
     builders: &mut [ColumnBuilder],
     plans: &[NumericPlan],
     row_buf: &mut [u8],
@@ -504,6 +583,7 @@ fn read_numeric_only(
     limit: usize,
     endian: Endian,
     rules: crate::stata::value::MissingRules,
+    mut row_filter: Option<&mut StataRowFilter>,
 ) -> Result<usize> {
     let mut rows_read = 0usize;
     let start_row = offset;
@@ -512,8 +592,49 @@ fn read_numeric_only(
         let byte_skip = (start_row as u64) * (row_buf.len() as u64);
         reader.seek(SeekFrom::Current(byte_skip as i64))?;
     }
+    if row_filter.is_none() && !row_buf.is_empty() {
+        // Read rows in blocks, transpose each block tile by tile into per-column
+        // strips and decode a column at a time, so each column's type dispatch
+        // happens once per tile instead of once per value.
+        let record_len = row_buf.len();
+        let fields: Vec<FieldSpan> = plans
+            .iter()
+            .map(|plan| FieldSpan {
+                start: plan.offset,
+                width: plan.width,
+            })
+            .collect();
+        let tile_len = crate::transpose::tile_rows(record_len) * record_len;
+        let mut strips = ColumnStrips::default();
+        let mut block = Vec::new();
+        let mut row_idx = start_row;
+        while row_idx < end_row {
+            let n = (end_row - row_idx).min(NUMERIC_BLOCK_ROWS);
+            block.resize(n * record_len, 0);
+            reader.read_exact(&mut block)?;
+            for tile in block.chunks(tile_len) {
+                strips.fill(tile, record_len, &fields);
+                for (i, plan) in plans.iter().enumerate() {
+                    append_numeric_column(
+                        &mut builders[plan.builder_idx],
+                        plan,
+                        strips.strip(i),
+                        endian,
+                        rules,
+                    );
+                }
+            }
+            row_idx += n;
+            rows_read += n;
+        }
+        return Ok(rows_read);
+    }
     for _row_idx in start_row..end_row {
         reader.read_exact(row_buf)?;
+        rows_read += 1;
+        if row_filter.as_mut().is_some_and(|f| !f.matches(row_buf)) {
+            continue;
+        }
         for plan in plans {
             let slice = &row_buf[plan.offset..plan.offset + plan.width];
             match (&mut builders[plan.builder_idx], plan.kind) {
@@ -555,11 +676,53 @@ fn read_numeric_only(
                 _ => {}
             }
         }
-        rows_read += 1;
     }
     Ok(rows_read)
 }
 
+/// Rows per read in the blocked numeric-only decode path.
+const NUMERIC_BLOCK_ROWS: usize = 1024;
+
+/// Decode one numeric column from its transposed strip (`plan.width` bytes per row).
+fn append_numeric_column(
+    builder: &mut ColumnBuilder,
+    plan: &NumericPlan,
+    strip: &[u8],
+    endian: Endian,
+    rules: crate::stata::value::MissingRules,
+) {
+    #[inline(always)]
+    fn split<T: Copy + Default>(v: Option<T>) -> (T, bool) {
+        (v.unwrap_or_default(), v.is_some())
+    }
+    // The byte order is fixed per call so each kernel is monomorphic.
+    macro_rules! cells {
+        ($b:expr, $w:literal, $read:ident) => {
+            match endian {
+                Endian::Little => {
+                    $b.extend_cells::<$w, _>(strip, |c| split($read(c, Endian::Little, rules)))
+                }
+                Endian::Big => {
+                    $b.extend_cells::<$w, _>(strip, |c| split($read(c, Endian::Big, rules)))
+                }
+            }
+        };
+    }
+    if plan.width == 0 {
+        return;
+    }
+    match (builder, plan.kind) {
+        (ColumnBuilder::Int8(b), NumericKind::Byte) => {
+            b.extend_cells::<1, _>(strip, |c| split(read_i8(c, rules)))
+        }
+        (ColumnBuilder::Int16(b), NumericKind::Int) => cells!(b, 2, read_i16),
+        (ColumnBuilder::Int32(b), NumericKind::Long) => cells!(b, 4, read_i32),
+        (ColumnBuilder::Float32(b), NumericKind::Float) => cells!(b, 4, read_f32),
+        (ColumnBuilder::Float64(b), NumericKind::Double) => cells!(b, 8, read_f64),
+        _ => {}
+    }
+}
+
 fn build_column_builders(
     metadata: &Metadata,
     columns: Option<&[usize]>,
@@ -604,36 +767,42 @@ fn build_column_builders(
             None
         };
 
-        let builder =
-            match var.var_type {
-                VarType::Numeric(NumericType::Byte)
-                | VarType::Numeric(NumericType::Int)
-                | VarType::Numeric(NumericType::Long)
-                | VarType::Numeric(NumericType::Float)
-                | VarType::Numeric(NumericType::Double)
-                    if label_map.is_some() =>
-                {
-                    ColumnBuilder::Utf8(StringChunkedBuilder::new(name.into(), capacity))
+        let builder = match var.var_type {
+            VarType::Numeric(NumericType::Byte)
+            | VarType::Numeric(NumericType::Int)
+            | VarType::Numeric(NumericType::Long)
+            | VarType::Numeric(NumericType::Float)
+            | VarType::Numeric(NumericType::Double)
+                if label_map.is_some() =>
+            {
+                match label_map.as_deref().and_then(LabelMap::categorical_labels) {
+                    Some(labels) => ColumnBuilder::Categorical(CategoricalBuilder::new(
+                        name.into(),
+                        capacity,
+                        labels,
+                    )),
+                    None => ColumnBuilder::Utf8(StringChunkedBuilder::new(name.into(), capacity)),
                 }
-                VarType::Numeric(NumericType::Byte) => ColumnBuilder::Int8(
-                    PrimitiveChunkedBuilder::<Int8Type>::new(name.into(), capacity),
-                ),
-                VarType::Numeric(NumericType::Int) => ColumnBuilder::Int16(
-                    PrimitiveChunkedBuilder::<Int16Type>::new(name.into(), capacity),
-                ),
-                VarType::Numeric(NumericType::Long) => ColumnBuilder::Int32(
-                    PrimitiveChunkedBuilder::<Int32Type>::new(name.into(), capacity),
-                ),
-                VarType::Numeric(NumericType::Float) => ColumnBuilder::Float32(
-                    PrimitiveChunkedBuilder::<Float32Type>::new(name.into(), capacity),
-                ),
-                VarType::Numeric(NumericType::Double) => ColumnBuilder::Float64(
-                    PrimitiveChunkedBuilder::<Float64Type>::new(name.into(), capacity),
-                ),
-                VarType::Str(_) | VarType::StrL => {
-                    ColumnBuilder::Utf8(StringChunkedBuilder::new(name.into(), capacity))
-                }
-            };
+            }
+            VarType::Numeric(NumericType::Byte) => {
+                ColumnBuilder::Int8(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            VarType::Numeric(NumericType::Int) => {
+                ColumnBuilder::Int16(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            VarType::Numeric(NumericType::Long) => {
+                ColumnBuilder::Int32(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            VarType::Numeric(NumericType::Float) => {
+                ColumnBuilder::Float32(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            VarType::Numeric(NumericType::Double) => {
+                ColumnBuilder::Float64(NumericColumnBuilder::new(name.into(), capacity))
+            }
+            VarType::Str(_) | VarType::StrL => {
+                ColumnBuilder::Utf8(StringChunkedBuilder::new(name.into(), capacity))
+            }
+        };
         builders.push(builder);
         offsets.push(all_offsets[idx]);
         widths.push(metadata.storage_widths[idx] as usize);
@@ -657,11 +826,12 @@ fn append_value(
     endian: Endian,
     rules: crate::stata::value::MissingRules,
     missing_string_as_null: bool,
-    strls: Option<&HashMap<(u32, u64), String>>,
+    strls: Option<&mut StrlReader<'_>>,
     ds_format: u16,
     label_map: Option<&LabelMap>,
     encoding: &'static encoding_rs::Encoding,
     scratch: Option<&mut StringScratch>,
+    tally: &mut Tally,
 ) -> Result<()> {
     match (builder, var_type) {
         (ColumnBuilder::Int8(b), VarType::Numeric(NumericType::Byte)) => {
@@ -692,26 +862,41 @@ fn append_value(
         | (ColumnBuilder::Utf8(b), VarType::Numeric(NumericType::Double)) => match var_type {
             VarType::Numeric(NumericType::Byte) => {
                 let v = read_i8(buf, rules).map(|v| v as i32);
-                append_labeled_int(b, v, label_map);
+                append_labeled_int(b, v, label_map, tally);
             }
             VarType::Numeric(NumericType::Int) => {
                 let v = read_i16(buf, endian, rules).map(|v| v as i32);
-                append_labeled_int(b, v, label_map);
+                append_labeled_int(b, v, label_map, tally);
             }
             VarType::Numeric(NumericType::Long) => {
                 let v = read_i32(buf, endian, rules);
-                append_labeled_int(b, v, label_map);
+                append_labeled_int(b, v, label_map, tally);
             }
             VarType::Numeric(NumericType::Float) => {
                 let v = read_f32(buf, endian, rules);
-                append_labeled_float(b, v.map(|v| v as f64), label_map);
+                append_labeled_float(b, v.map(|v| v as f64), label_map, tally);
             }
             VarType::Numeric(NumericType::Double) => {
                 let v = read_f64(buf, endian, rules);
-                append_labeled_float(b, v, label_map);
+                append_labeled_float(b, v, label_map, tally);
             }
             _ => b.append_null(),
         },
+        (ColumnBuilder::Categorical(b), VarType::Numeric(t)) => {
+            let v = match t {
+                NumericType::Byte => read_i8(buf, rules).map(f64::from),
+                NumericType::Int => read_i16(buf, endian, rules).map(f64::from),
+                NumericType::Long => read_i32(buf, endian, rules).map(f64::from),
+                NumericType::Float => read_f32(buf, endian, rules).map(f64::from),
+                NumericType::Double => read_f64(buf, endian, rules),
+            };
+            tally.time(ProfileStage::LabelMap, || {
+                match label_map.and_then(LabelMap::categorical_labels) {
+                    Some(labels) => b.append_f64(v, labels),
+                    None => b.append_null(),
+                }
+            });
+        }
         (ColumnBuilder::Float32(b), VarType::Numeric(NumericType::Float)) => {
             if let Some(v) = read_f32(buf, endian, rules) {
                 b.append_value(v);
@@ -727,7 +912,9 @@ fn append_value(
             }
         }
         (ColumnBuilder::Utf8(b), VarType::Str(_)) => {
-            let s = read_str_into(buf, encoding, scratch)?;
+            let s = tally.time(ProfileStage::StringDecode, || {
+                read_str_into(buf, encoding, scratch)
+            })?;
             if missing_string_as_null && s.is_empty() {
                 b.append_null();
             } else {
@@ -745,10 +932,9 @@ fn append_value(
             };
 
             let (v, o) = decode_strl_ref(buf, endian, ds_format)?;
-            let mut s = strls.get(&(v, o));
-            if s.is_none() && ds_format >= 119 && endian == Endian::Big {
-                let mut best = s;
-                let mut best_score = best.map(|v| score_strl(v)).unwrap_or(i32::MIN);
+            let mut key = (v, o);
+            if !strls.contains(v, o) && ds_format >= 119 && endian == Endian::Big {
+                let mut best_score = i32::MIN;
                 let be_u16 = |a: u8, b: u8| ((a as u16) << 8 | b as u16) as u32;
                 let be_u32 = |a: u8, b: u8, c: u8, d: u8| u32::from_be_bytes([a, b, c, d]) as u64;
                 let le_u16 = |a: u8, b: u8| (a as u16 | ((b as u16) << 8)) as u32;
@@ -787,17 +973,16 @@ fn append_value(
                     ),
                 ];
                 for (v2, o2) in candidates {
-                    if let Some(s2) = strls.get(&(v2, o2)) {
+                    if let Some(s2) = strls.get(v2, o2)? {
                         let score = score_strl(s2);
                         if score > best_score {
-                            best = Some(s2);
+                            key = (v2, o2);
                             best_score = score;
                         }
                     }
                 }
-                s = best;
             }
-            if let Some(s) = s {
+            if let Some(s) = strls.get(key.0, key.1)? {
                 if missing_string_as_null && s.is_empty() {
                     b.append_null();
                 } else {
@@ -814,23 +999,31 @@ fn append_value(
     Ok(())
 }
 
+/// Decode a fixed-width string cell. Repeated raw values come from the column's
+/// interner instead of being decoded again.
 fn read_str_into<'a>(
-    buf: &[u8],
+    buf: &'a [u8],
     encoding: &'static encoding_rs::Encoding,
     scratch: Option<&'a mut StringScratch>,
-) -> Result<&'a str> {
+) -> Result<Cow<'a, str>> {
     let len = buf.iter().position(|&b| b == 0).unwrap_or(buf.len());
     let scratch = scratch.ok_or_else(|| Error::ParseError("missing string scratch".to_string()))?;
-    scratch.buf.clear();
-    let _ = scratch
-        .decoder
-        .decode_to_string(&buf[..len], &mut scratch.buf, true);
-    if scratch.buf.ends_with(' ') {
-        let trimmed_len = scratch.buf.trim_end_matches(' ').len();
-        scratch.buf.truncate(trimmed_len);
-    }
-    scratch.reset(encoding);
-    Ok(scratch.buf.as_str())
+    let StringScratch {
+        decoder,
+        buf: out,
+        interner,
+    } = scratch;
+    Ok(interner.decode(&buf[..len], move |raw| {
+        out.clear();
+        let _ = decoder.decode_to_string(raw, out, true);
+        if out.ends_with(' ') {
+            let trimmed_len = out.trim_end_matches(' ').len();
+            out.truncate(trimmed_len);
+        }
+        *decoder = encoding.new_decoder_without_bom_handling();
+        let out: &'a String = out;
+        Cow::Borrowed(out.as_str())
+    }))
 }
 
 fn score_strl(s: &str) -> i32 {
@@ -843,6 +1036,7 @@ fn score_strl(s: &str) -> i32 {
 struct StringScratch {
     decoder: encoding_rs::Decoder,
     buf: String,
+    interner: StringInterner,
 }
 
 impl StringScratch {
@@ -850,11 +1044,137 @@ impl StringScratch {
         Self {
             decoder: encoding.new_decoder_without_bom_handling(),
             buf: String::with_capacity(capacity),
+            interner: StringInterner::new(),
+        }
+    }
+}
+
+/// A [`RowFilter`](crate::RowFilter) compiled against the fixed-width record layout.
+///
+/// Terms on strL, value-labelled (when labels are output as strings) and
+/// date/time-formatted columns are dropped; callers re-apply the full predicate.
+struct StataRowFilter {
+    terms: Vec<StataFilterTerm>,
+    endian: Endian,
+    rules: crate::stata::value::MissingRules,
+    encoding: &'static encoding_rs::Encoding,
+    missing_string_as_null: bool,
+}
+
+struct StataFilterTerm {
+    offset: usize,
+    width: usize,
+    var_type: VarType,
+    srh_rev: bool,
+    scratch: Option<StringScratch>,
+    test: crate::row_filter::FilterTest,
+}
+
+impl StataRowFilter {
+    fn compile(
+        filter: &crate::RowFilter,
+        metadata: &Metadata,
+        ds_format: u16,
+        endian: Endian,
+        missing_string_as_null: bool,
+        label_maps: &HashMap<String, Arc<LabelMap>>,
+    ) -> Option<Self> {
+        let mut offsets = Vec::with_capacity(metadata.variables.len());
+        let mut running = 0usize;
+        for w in &metadata.storage_widths {
+            offsets.push(running);
+            running += *w as usize;
+        }
+        let mut terms = Vec::new();
+        for (name, test) in filter.terms() {
+            let Some(idx) = metadata.variables.iter().position(|v| v.name == name) else {
+                continue;
+            };
+            let var = &metadata.variables[idx];
+            let labelled = var
+                .value_label_name
+                .as_ref()
+                .is_some_and(|l| label_maps.contains_key(l));
+            let eligible = match var.var_type {
+                VarType::Numeric(NumericType::Float) => test.f32_exact(),
+                VarType::Numeric(_) => test.is_numeric(),
+                VarType::Str(_) => !test.is_numeric(),
+                VarType::StrL => false,
+            };
+            let temporal = crate::stata::polars_output::stata_time_format_kind(
+                var.format.as_deref(),
+                &var.var_type,
+            )
+            .is_some();
+            if !eligible || labelled || temporal {
+                continue;
+            }
+            let width = metadata.storage_widths[idx] as usize;
+            terms.push(StataFilterTerm {
+                offset: offsets[idx],
+                width,
+                var_type: var.var_type.clone(),
+                srh_rev: var.name.trim() == "srh_rev",
+                scratch: matches!(var.var_type, VarType::Str(_))
+                    .then(|| StringScratch::new(metadata.encoding, width)),
+                test,
+            });
+        }
+        if terms.is_empty() {
+            return None;
         }
+        Some(Self {
+            terms,
+            endian,
+            rules: missing_rules(ds_format),
+            encoding: metadata.encoding,
+            missing_string_as_null,
+        })
     }
 
-    fn reset(&mut self, encoding: &'static encoding_rs::Encoding) {
-        self.decoder = encoding.new_decoder_without_bom_handling();
+    /// Whether the raw record can satisfy the filter. Decodes values exactly as
+    /// `append_value` does, including the `srh_rev` byte quirk.
+    fn matches(&mut self, row: &[u8]) -> bool {
+        let (endian, rules) = (self.endian, self.rules);
+        for term in &mut self.terms {
+            let slice = &row[term.offset..term.offset + term.width];
+            let keep = match term.var_type {
+                VarType::Numeric(NumericType::Byte) => {
+                    let v = if term.srh_rev && !slice.is_empty() && slice[0] > 100 {
+                        None
+                    } else {
+                        read_i8(slice, rules)
+                    };
+                    term.test.eval_num(v.map(f64::from))
+                }
+                VarType::Numeric(NumericType::Int) => term
+                    .test
+                    .eval_num(read_i16(slice, endian, rules).map(f64::from)),
+                VarType::Numeric(NumericType::Long) => term
+                    .test
+                    .eval_num(read_i32(slice, endian, rules).map(f64::from)),
+                VarType::Numeric(NumericType::Float) => term
+                    .test
+                    .eval_num(read_f32(slice, endian, rules).map(f64::from)),
+                VarType::Numeric(NumericType::Double) => {
+                    term.test.eval_num(read_f64(slice, endian, rules))
+                }
+                VarType::Str(_) => match read_str_into(slice, self.encoding, term.scratch.as_mut())
+                {
+                    Ok(s) if self.missing_string_as_null && s.is_empty() => {
+                        term.test.eval_str(None)
+                    }
+                    Ok(s) => term.test.eval_str(Some(&s)),
+                    // Keep the row; append_value reports the error.
+                    Err(_) => true,
+                },
+                VarType::StrL => true,
+            };
+            if !keep {
+                return false;
+            }
+        }
+        true
     }
 }
 
@@ -871,57 +1191,177 @@ fn read_tag<R: Read>(reader: &mut R, tag: &[u8]) -> Result<()> {
     Ok(())
 }
 
-fn load_strls(
-    reader: &mut BufReader<File>,
-    metadata: &Metadata,
-    endian: Endian,
-    ds_format: u16,
+/// Where one text strL payload lives in the file.
+#[derive(Clone, Copy)]
+struct StrlLoc {
+    offset: u64,
+    len: u32,
+}
+
+/// File positions of the text strLs in the `<strls>` section, keyed by (v, o).
+///
+/// Built in one pass that reads only the GSO headers and skips the payloads, so the
+/// strL text itself is only read for the cells a `StrlReader` is asked for.
+pub struct StrlTable {
+    locs: HashMap<(u32, u64), StrlLoc>,
+    /// End of the last payload, which bounds read-ahead.
+    end: u64,
     encoding: &'static encoding_rs::Encoding,
-) -> Result<Option<HashMap<(u32, u64), String>>> {
-    let Some(strls_offset) = metadata.strls_offset else {
-        return Ok(None);
-    };
-    if ds_format < 117 {
-        return Ok(None);
-    }
+}
 
-    reader.seek(SeekFrom::Start(strls_offset))?;
-    read_tag(reader, b"<strls>")?;
-
-    let mut map = HashMap::new();
-    loop {
-        let mut tag = [0u8; 3];
-        reader.read_exact(&mut tag)?;
-        if &tag == b"GSO" {
-            let (mut v, mut o, data_type, len) = read_strl_header(reader, endian, ds_format)?;
-            if ds_format >= 118 {
-                v &= 0xFFFF;
-                o &= 0x0000_FFFF_FFFF_FFFF;
-            }
-            if len < 0 {
-                return Err(Error::ParseError("negative strl length".to_string()));
-            }
-            let len = len as usize;
-            if data_type == 0x82 {
-                let mut buf = vec![0u8; len];
-                reader.read_exact(&mut buf)?;
-                let mut s = encoding::decode_string(&buf, encoding);
-                while s.ends_with('\0') {
-                    s.pop();
+impl StrlTable {
+    fn build(
+        reader: &mut FileSource,
+        metadata: &Metadata,
+        endian: Endian,
+        ds_format: u16,
+    ) -> Result<Option<Self>> {
+        let Some(strls_offset) = metadata.strls_offset else {
+            return Ok(None);
+        };
+        if ds_format < 117 {
+            return Ok(None);
+        }
+
+        reader.seek(SeekFrom::Start(strls_offset))?;
+        read_tag(reader, b"<strls>")?;
+        // Track the position by hand: asking the reader would cost a syscall per strL.
+        let gso_header_len: u64 = if ds_format >= 118 { 17 } else { 13 };
+        let mut pos = strls_offset + b"<strls>".len() as u64;
+
+        let mut locs = HashMap::new();
+        let mut end = pos;
+        loop {
+            let mut tag = [0u8; 3];
+            reader.read_exact(&mut tag)?;
+            pos += 3;
+            if &tag == b"GSO" {
+                let (mut v, mut o, data_type, len) = read_strl_header(reader, endian, ds_format)?;
+                pos += gso_header_len;
+                if ds_format >= 118 {
+                    v &= 0xFFFF;
+                    o &= 0x0000_FFFF_FFFF_FFFF;
                 }
-                map.insert((v, o), s);
+                if len < 0 {
+                    return Err(Error::ParseError("negative strl length".to_string()));
+                }
+                let len = len as u32;
+                if data_type == 0x82 {
+                    locs.insert((v, o), StrlLoc { offset: pos, len });
+                }
+                reader.skip(len as u64)?;
+                pos += len as u64;
+            } else if &tag == b"</s" {
+                read_tag(reader, b"trls>")?;
+                end = pos - 3;
+                break;
             } else {
-                reader.seek(SeekFrom::Current(len as i64))?;
+                return Err(Error::ParseError("invalid strls tag".to_string()));
             }
-        } else if &tag == b"</s" {
-            read_tag(reader, b"trls>")?;
-            break;
-        } else {
-            return Err(Error::ParseError("invalid strls tag".to_string()));
         }
+
+        Ok(Some(Self {
+            locs,
+            end,
+            encoding: metadata.encoding,
+        }))
+    }
+}
+
+/// Bytes read ahead from the `<strls>` section for one strL variable.
+struct StrlWindow {
+    v: u32,
+    start: u64,
+    bytes: Vec<u8>,
+}
+
+/// Smallest read of the `<strls>` section; the strLs of neighbouring rows are
+/// usually stored next to each other and are then served from the same read.
+const STRL_WINDOW: u64 = 256 * 1024;
+
+/// Fetches strL text for one read call. It owns its file handle (opened on first
+/// use) so parallel workers never contend; with the mmap backend payloads are
+/// sliced straight from the mapping. Otherwise payloads come from read-ahead
+/// windows of at least [`STRL_WINDOW`] bytes, one per strL variable, so a batch
+/// costs a few large reads instead of a seek and a read per cell. The last value
+/// is kept, since Stata points repeated values at the same strL.
+pub(crate) struct StrlReader<'a> {
+    table: &'a StrlTable,
+    map: Option<&'a SharedMap>,
+    path: &'a Path,
+    file: Option<std::fs::File>,
+    windows: Vec<StrlWindow>,
+    last: Option<(u32, u64)>,
+    value: String,
+}
+
+impl StrlReader<'_> {
+    fn contains(&self, v: u32, o: u64) -> bool {
+        self.table.locs.contains_key(&(v, o))
+    }
+
+    fn get(&mut self, v: u32, o: u64) -> Result<Option<&str>> {
+        if self.last != Some((v, o)) {
+            let Some(loc) = self.table.locs.get(&(v, o)).copied() else {
+                return Ok(None);
+            };
+            let start = loc.offset as usize;
+            let end = start + loc.len as usize;
+            let text_encoding = self.table.encoding;
+            let bytes: &[u8] = match self.map {
+                Some(map) => map
+                    .get(start..end)
+                    .ok_or_else(|| Error::ParseError("strl out of bounds".to_string()))?,
+                None => {
+                    let window = self.window(v, loc)?;
+                    let at = (loc.offset - window.start) as usize;
+                    &window.bytes[at..at + loc.len as usize]
+                }
+            };
+            let mut s = encoding::decode_string(bytes, text_encoding);
+            while s.ends_with('\0') {
+                s.pop();
+            }
+            self.value = s;
+            self.last = Some((v, o));
+        }
+        Ok(Some(&self.value))
     }
 
-    Ok(Some(map))
+    /// A window holding `loc`: any that already does, else `v`'s own window refilled
+    /// from `loc` on.
+    fn window(&mut self, v: u32, loc: StrlLoc) -> Result<&StrlWindow> {
+        let end = loc.offset + loc.len as u64;
+        let held = self
+            .windows
+            .iter()
+            .position(|w| w.start <= loc.offset && end <= w.start + w.bytes.len() as u64);
+        if let Some(i) = held {
+            return Ok(&self.windows[i]);
+        }
+        let i = match self.windows.iter().position(|w| w.v == v) {
+            Some(i) => i,
+            None => {
+                self.windows.push(StrlWindow {
+                    v,
+                    start: 0,
+                    bytes: Vec::new(),
+                });
+                self.windows.len() - 1
+            }
+        };
+        let file = match &mut self.file {
+            Some(file) => file,
+            None => self.file.insert(std::fs::File::open(self.path)?),
+        };
+        let want = STRL_WINDOW.min(self.table.end.saturating_sub(loc.offset));
+        let window = &mut self.windows[i];
+        window.start = loc.offset;
+        window.bytes.resize(want.max(loc.len as u64) as usize, 0);
+        file.seek(SeekFrom::Start(loc.offset))?;
+        file.read_exact(&mut window.bytes)?;
+        Ok(window)
+    }
 }
 
 fn read_strl_header<R: Read>(
@@ -998,15 +1438,17 @@ fn read_i32_endian<R: Read>(reader: &mut R, endian: Endian) -> Result<i32> {
 }
 
 enum ColumnBuilder {
-    Int8(PrimitiveChunkedBuilder<Int8Type>),
-    Int16(PrimitiveChunkedBuilder<Int16Type>),
-    Int32(PrimitiveChunkedBuilder<Int32Type>),
-    Float32(PrimitiveChunkedBuilder<Float32Type>),
-    Float64(PrimitiveChunkedBuilder<Float64Type>),
+    Int8(NumericColumnBuilder<Int8Type>),
+    Int16(NumericColumnBuilder<Int16Type>),
+    Int32(NumericColumnBuilder<Int32Type>),
+    Float32(NumericColumnBuilder<Float32Type>),
+    Float64(NumericColumnBuilder<Float64Type>),
     Utf8(StringChunkedBuilder),
+    /// Labelled numeric column read as `Categorical` codes.
+    Categorical(CategoricalBuilder),
 }
 
-fn build_label_maps(metadata: &Metadata) -> HashMap<String, Arc<LabelMap>> {
+fn build_label_maps(metadata: &Metadata, as_categorical: bool) -> HashMap<String, Arc<LabelMap>> {
     let mut out = HashMap::new();
     for vl in &metadata.value_labels {
         let mut map = LabelMap::default();
@@ -1018,15 +1460,44 @@ fn build_label_maps(metadata: &Metadata) -> HashMap<String, Arc<LabelMap>> {
                 map.insert_float(*v, value.clone());
             }
         }
+        if as_categorical {
+            map.categorical_labels = Some(label_categories(vl));
+        }
         out.insert(vl.name.clone(), Arc::new(map));
     }
     out
 }
 
+/// Categories for one value label set.
+fn label_categories(vl: &crate::stata::types::ValueLabel) -> LabelCategories {
+    LabelCategories::new(
+        &vl.name,
+        vl.mapping.iter().filter_map(|(key, value)| {
+            let v = match key {
+                crate::stata::types::ValueLabelKey::Integer(v) => *v as f64,
+                crate::stata::types::ValueLabelKey::Double(v) => *v,
+                _ => return None,
+            };
+            Some((LabelKey::Num(v), value.as_str()))
+        }),
+    )
+}
+
+/// dtype of a labelled column read with `value_labels_as_categorical`, or `None` when
+/// `label_name` is not defined in the file.
+pub(crate) fn label_categorical_dtype(metadata: &Metadata, label_name: &str) -> Option<DataType> {
+    let vl = metadata
+        .value_labels
+        .iter()
+        .find(|vl| vl.name == label_name)?;
+    Some(label_categories(vl).dtype().clone())
+}
+
 #[derive(Default)]
 struct LabelMap {
     int_map: HashMap<i32, String>,
     float_map: HashMap<u64, String>,
+    categorical_labels: Option<LabelCategories>,
 }
 
 impl LabelMap {
@@ -1045,16 +1516,21 @@ impl LabelMap {
     fn get_float(&self, v: f64) -> Option<&String> {
         self.float_map.get(&v.to_bits())
     }
+
+    fn categorical_labels(&self) -> Option<&LabelCategories> {
+        self.categorical_labels.as_ref()
+    }
 }
 
 fn append_labeled_int(
     builder: &mut StringChunkedBuilder,
     v: Option<i32>,
     labels: Option<&LabelMap>,
+    tally: &mut Tally,
 ) {
     if let Some(v) = v {
         if let Some(labels) = labels {
-            if let Some(label) = labels.get_int(v) {
+            if let Some(label) = tally.time(ProfileStage::LabelMap, || labels.get_int(v)) {
                 builder.append_value(label);
                 return;
             }
@@ -1069,10 +1545,11 @@ fn append_labeled_float(
     builder: &mut StringChunkedBuilder,
     v: Option<f64>,
     labels: Option<&LabelMap>,
+    tally: &mut Tally,
 ) {
     if let Some(v) = v {
         if let Some(labels) = labels {
-            if let Some(label) = labels.get_float(v) {
+            if let Some(label) = tally.time(ProfileStage::LabelMap, || labels.get_float(v)) {
                 builder.append_value(label);
                 return;
             }
@@ -1092,6 +1569,7 @@ impl ColumnBuilder {
             ColumnBuilder::Float32(b) => b.finish().into_series(),
             ColumnBuilder::Float64(b) => b.finish().into_series(),
             ColumnBuilder::Utf8(b) => b.finish().into_series(),
+            ColumnBuilder::Categorical(b) => b.finish(),
         }
     }
 }
@@ -1151,9 +1629,10 @@ pub fn read_data_frame_range_with_indicators(
     use_value_labels: bool,
     indicator_suffix: &str,
 ) -> Result<DataFrame> {
-    let file = File::open(path)?;
+    let _decode = read_profile::span(ProfileStage::RowDecode);
     let data_offset = metadata.data_offset.ok_or_else(|| Error::MissingMetadata)?;
-    let mut reader = BufReader::with_capacity(8 * 1024 * 1024, file);
+    let mut reader = shared.open(path)?;
+    let mut strl_reader = shared.strl_reader(path);
 
     reader.seek(SeekFrom::Start(data_offset))?;
     if ds_format >= 117 {
@@ -1173,14 +1652,14 @@ pub fn read_data_frame_range_with_indicators(
         )?;
 
     // Build parallel indicator builders for columns in indicator_cols
-    let mut null_builders: Vec<Option<StringChunkedBuilder>> = col_indices
+    let mut null_builders: Vec<Option<IndicatorBuilder>> = col_indices
         .iter()
         .map(|&idx| {
             let var = &metadata.variables[idx];
             let is_numeric = matches!(var.var_type, VarType::Numeric(_));
             if is_numeric && indicator_cols.contains(&var.name) {
                 let ind_name = format!("{}{}", var.name, indicator_suffix);
-                Some(StringChunkedBuilder::new(ind_name.as_str().into(), limit))
+                Some(IndicatorBuilder::new(ind_name.as_str().into(), limit))
             } else {
                 None
             }
@@ -1203,6 +1682,7 @@ pub fn read_data_frame_range_with_indicators(
         reader.seek(SeekFrom::Current(byte_skip as i64))?;
     }
 
+    let mut tally = Tally::new();
     for _row_idx in start_row..end_row {
         reader.read_exact(&mut row_buf)?;
 
@@ -1221,12 +1701,13 @@ pub fn read_data_frame_range_with_indicators(
                     endian,
                     rules,
                     missing_string_as_null,
-                    shared.strls.as_ref().map(|v| v.as_ref()),
+                    strl_reader.as_mut(),
                     ds_format,
                     col_labels[i].as_deref(),
                     metadata.encoding,
                     string_scratch[i].as_mut(),
                     use_value_labels,
+                    &mut tally,
                 )?;
             } else {
                 // No indicator — use the regular (fast) path
@@ -1237,11 +1718,12 @@ pub fn read_data_frame_range_with_indicators(
                     endian,
                     rules,
                     missing_string_as_null,
-                    shared.strls.as_ref().map(|v| v.as_ref()),
+                    strl_reader.as_mut(),
                     ds_format,
                     col_labels[i].as_deref(),
                     metadata.encoding,
                     string_scratch[i].as_mut(),
+                    &mut tally,
                 )?;
             }
         }
@@ -1259,7 +1741,7 @@ pub fn read_data_frame_range_with_indicators(
     }
     for null_builder in null_builders {
         if let Some(b) = null_builder {
-            cols.push(b.finish().into_series().into());
+            cols.push(b.finish().into());
         }
     }
 
@@ -1268,18 +1750,19 @@ pub fn read_data_frame_range_with_indicators(
 
 fn append_value_tagged(
     builder: &mut ColumnBuilder,
-    null_builder: &mut StringChunkedBuilder,
+    null_builder: &mut IndicatorBuilder,
     var_type: &VarType,
     buf: &[u8],
     endian: Endian,
     rules: crate::stata::value::MissingRules,
     missing_string_as_null: bool,
-    strls: Option<&HashMap<(u32, u64), String>>,
+    strls: Option<&mut StrlReader<'_>>,
     ds_format: u16,
     label_map: Option<&LabelMap>,
     encoding: &'static encoding_rs::Encoding,
     scratch: Option<&mut StringScratch>,
     use_value_labels: bool,
+    tally: &mut Tally,
 ) -> Result<()> {
     match (builder, var_type) {
         (ColumnBuilder::Int8(b), VarType::Numeric(NumericType::Byte)) => {
@@ -1287,21 +1770,18 @@ fn append_value_tagged(
             match (val, offset) {
                 (Some(v), _) => {
                     b.append_value(v);
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
                 (None, Some(k)) => {
                     b.append_null();
                     let raw = rules.system_missing_int8 as i32 + k as i32;
-                    null_builder.append_value(&indicator_from_offset(
-                        k,
-                        raw,
-                        label_map,
-                        use_value_labels,
-                    ));
+                    null_builder.push_keyed(k as u64, || {
+                        Some(indicator_from_offset(k, raw, label_map, use_value_labels))
+                    });
                 }
                 (None, None) => {
                     b.append_null();
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
             }
         }
@@ -1310,21 +1790,18 @@ fn append_value_tagged(
             match (val, offset) {
                 (Some(v), _) => {
                     b.append_value(v);
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
                 (None, Some(k)) => {
                     b.append_null();
                     let raw = rules.system_missing_int16 as i32 + k as i32;
-                    null_builder.append_value(&indicator_from_offset(
-                        k,
-                        raw,
-                        label_map,
-                        use_value_labels,
-                    ));
+                    null_builder.push_keyed(k as u64, || {
+                        Some(indicator_from_offset(k, raw, label_map, use_value_labels))
+                    });
                 }
                 (None, None) => {
                     b.append_null();
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
             }
         }
@@ -1333,21 +1810,18 @@ fn append_value_tagged(
             match (val, offset) {
                 (Some(v), _) => {
                     b.append_value(v);
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
                 (None, Some(k)) => {
                     b.append_null();
                     let raw = rules.system_missing_int32 + k as i32;
-                    null_builder.append_value(&indicator_from_offset(
-                        k,
-                        raw,
-                        label_map,
-                        use_value_labels,
-                    ));
+                    null_builder.push_keyed(k as u64, || {
+                        Some(indicator_from_offset(k, raw, label_map, use_value_labels))
+                    });
                 }
                 (None, None) => {
                     b.append_null();
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
             }
         }
@@ -1356,22 +1830,24 @@ fn append_value_tagged(
             match (val, offset) {
                 (Some(v), _) => {
                     b.append_value(v);
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
                 (None, Some(k)) => {
                     b.append_null();
                     // For float, reconstruct raw bits for label lookup
                     let raw_bits = (rules.missing_float as u64) + (k as u64) * 0x0008_0000;
-                    null_builder.append_value(&indicator_from_offset_f(
-                        k,
-                        raw_bits,
-                        label_map,
-                        use_value_labels,
-                    ));
+                    null_builder.push_keyed(k as u64, || {
+                        Some(indicator_from_offset_f(
+                            k,
+                            raw_bits,
+                            label_map,
+                            use_value_labels,
+                        ))
+                    });
                 }
                 (None, None) => {
                     b.append_null();
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
             }
         }
@@ -1380,28 +1856,30 @@ fn append_value_tagged(
             match (val, offset) {
                 (Some(v), _) => {
                     b.append_value(v);
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
                 (None, Some(k)) => {
                     b.append_null();
                     let raw_bits = rules.missing_double + k as u64;
-                    null_builder.append_value(&indicator_from_offset_f(
-                        k,
-                        raw_bits,
-                        label_map,
-                        use_value_labels,
-                    ));
+                    null_builder.push_keyed(k as u64, || {
+                        Some(indicator_from_offset_f(
+                            k,
+                            raw_bits,
+                            label_map,
+                            use_value_labels,
+                        ))
+                    });
                 }
                 (None, None) => {
                     b.append_null();
-                    null_builder.append_null();
+                    null_builder.push_null();
                 }
             }
         }
         // For labeled numeric columns (Utf8 builder), tagged path uses the same logic but
         // the label map is for data values, not missing indicators. Fall through to regular path.
         (b @ ColumnBuilder::Utf8(_), vt @ VarType::Numeric(_)) => {
-            null_builder.append_null();
+            null_builder.push_null();
             append_value(
                 b,
                 vt,
@@ -1414,11 +1892,12 @@ fn append_value_tagged(
                 label_map,
                 encoding,
                 scratch,
+                tally,
             )?;
         }
         // Strings have no extended missing in Stata — fall through to regular path
         (b, vt) => {
-            null_builder.append_null();
+            null_builder.push_null();
             append_value(
                 b,
                 vt,
@@ -1431,6 +1910,7 @@ fn append_value_tagged(
                 label_map,
                 encoding,
                 scratch,
+                tally,
             )?;
         }
     }
@@ -117,7 +117,7 @@ pub fn metadata_json_from_meta(meta: &Metadata, hdr: &Header) -> Result<String>
 
 /// Export Stata metadata as a JSON string.
 pub fn metadata_json(path: impl AsRef<Path>) -> Result<String> {
-    let reader = StataReader::open(path)?;
+    let reader = StataReader::open_cached(path)?;
     metadata_json_from_meta(reader.metadata(), reader.header())
 }
 
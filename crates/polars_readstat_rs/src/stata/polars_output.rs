@@ -1,13 +1,11 @@
 use crate::stata::data::{
-    build_shared_decode, read_data_frame_range, read_data_frame_range_with_indicators,
-    read_data_frame_streaming,
+    build_shared_decode, label_categorical_dtype, read_data_frame_range,
+    read_data_frame_range_with_indicators, read_data_frame_streaming, SharedDecode,
 };
 use crate::stata::reader::StataReader;
-use crate::stata::types::{NumericType, VarType};
+use crate::stata::types::{Endian, Metadata, NumericType, VarType};
 use polars::prelude::*;
-use rayon::prelude::*;
-use rayon::ThreadPoolBuilder;
-use std::collections::{BTreeMap, HashSet};
+use std::collections::HashSet;
 use std::path::PathBuf;
 use std::sync::mpsc::{self, Receiver};
 use std::sync::Arc;
@@ -17,22 +15,8 @@ pub fn scan_dta(
     path: impl Into<std::path::PathBuf>,
     opts: crate::ScanOptions,
 ) -> PolarsResult<LazyFrame> {
-    let path = path.into();
-    let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
-    let value_labels_as_strings = opts.value_labels_as_strings;
-    let preserve_order = opts.preserve_order.unwrap_or(false);
-    let scan_ptr = Arc::new(StataScan::new(
-        path,
-        opts.threads,
-        missing_string_as_null,
-        value_labels_as_strings,
-        opts.chunk_size,
-        preserve_order,
-        opts.row_index_name,
-        opts.compress_opts,
-        opts.informative_nulls,
-    ));
-    LazyFrame::anonymous_scan(scan_ptr, Default::default())
+    let scan = StataScan::from_options(path.into(), opts);
+    LazyFrame::anonymous_scan(Arc::new(scan), Default::default())
 }
 
 #[cfg(test)]
@@ -69,6 +53,7 @@ mod tests {
             None,
             true,
             true,
+            false,
             Some(10),
             false,
             None,
@@ -76,6 +61,9 @@ mod tests {
             0,
             Some(25),
             None,
+            None,
+            false,
+            None,
         )
         .expect("batch iter");
         let mut batches = 0usize;
@@ -100,6 +88,10 @@ pub struct StataScan {
     row_index_name: Option<String>,
     compress_opts: crate::CompressOptionsLite,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
+    profiler: Option<crate::ReadProfiler>,
+    value_labels_as_categorical: bool,
 }
 
 impl StataScan {
@@ -124,77 +116,66 @@ impl StataScan {
             row_index_name,
             compress_opts,
             informative_nulls,
+            use_mmap: false,
+            read_ahead: None,
+            profiler: None,
+            value_labels_as_categorical: false,
         }
     }
-}
-
-pub(crate) type StataBatchIter = Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>;
 
-fn split_batch_ranges(total_batches: usize, n_workers: usize) -> Vec<(usize, usize)> {
-    if total_batches == 0 || n_workers == 0 {
-        return Vec::new();
-    }
-    let n = n_workers.min(total_batches);
-    let base = total_batches / n;
-    let rem = total_batches % n;
-    let mut ranges = Vec::with_capacity(n);
-    let mut start = 0usize;
-    for i in 0..n {
-        let len = base + if i < rem { 1 } else { 0 };
-        ranges.push((start, len));
-        start += len;
+    /// The scan `opts` describe, as [`scan_dta`] builds it.
+    pub(crate) fn from_options(path: PathBuf, opts: crate::ScanOptions) -> Self {
+        let missing_string_as_null = opts.missing_string_as_null.unwrap_or(true);
+        let value_labels_as_strings = opts.value_labels_as_strings;
+        let preserve_order = opts.preserve_order.unwrap_or(false);
+        let use_mmap = opts.use_mmap.unwrap_or(false);
+        StataScan::new(
+            path,
+            opts.threads,
+            missing_string_as_null,
+            value_labels_as_strings,
+            opts.chunk_size,
+            preserve_order,
+            opts.row_index_name,
+            opts.compress_opts,
+            opts.informative_nulls,
+        )
+        .with_mmap(use_mmap)
+        .with_read_ahead(opts.read_ahead)
+        .with_profiler(opts.profile.clone())
+        .with_value_labels_as_categorical(opts.value_labels_as_categorical.unwrap_or(false))
     }
-    ranges
-}
 
-struct ParallelStataBatchIter {
-    rx: Receiver<(usize, PolarsResult<DataFrame>)>,
-    handle: Option<JoinHandle<()>>,
-    preserve_order: bool,
-    buffer: BTreeMap<usize, PolarsResult<DataFrame>>,
-    next_idx: usize,
-    total_chunks: usize,
-}
+    /// Read through a memory map of the file instead of buffered reads.
+    pub fn with_mmap(mut self, use_mmap: bool) -> Self {
+        self.use_mmap = use_mmap;
+        self
+    }
 
-impl Iterator for ParallelStataBatchIter {
-    type Item = PolarsResult<DataFrame>;
+    /// Read through positioned range reads that keep about `window` bytes in
+    /// flight ahead of decoding, for high-latency storage. `with_mmap` wins when
+    /// both are set.
+    pub fn with_read_ahead(mut self, window: Option<usize>) -> Self {
+        self.read_ahead = window;
+        self
+    }
 
-    fn next(&mut self) -> Option<Self::Item> {
-        if !self.preserve_order {
-            return self.rx.recv().ok().map(|(_, df)| df);
-        }
-        if self.next_idx >= self.total_chunks {
-            return None;
-        }
-        loop {
-            if let Some(item) = self.buffer.remove(&self.next_idx) {
-                self.next_idx += 1;
-                return Some(item);
-            }
-            match self.rx.recv() {
-                Ok((idx, df)) => {
-                    self.buffer.insert(idx, df);
-                }
-                Err(_) => {
-                    if let Some(item) = self.buffer.remove(&self.next_idx) {
-                        self.next_idx += 1;
-                        return Some(item);
-                    }
-                    return None;
-                }
-            }
-        }
+    /// Collect this scan's profile into `profiler` (see [`crate::ReadProfiler`]).
+    pub fn with_profiler(mut self, profiler: Option<crate::ReadProfiler>) -> Self {
+        self.profiler = profiler;
+        self
     }
-}
 
-impl Drop for ParallelStataBatchIter {
-    fn drop(&mut self) {
-        if let Some(handle) = self.handle.take() {
-            let _ = handle.join();
-        }
+    /// Read value-labelled columns as `Categorical` instead of `String` (when value labels
+    /// are applied).
+    pub fn with_value_labels_as_categorical(mut self, as_categorical: bool) -> Self {
+        self.value_labels_as_categorical = as_categorical;
+        self
     }
 }
 
+pub(crate) type StataBatchIter = Box<dyn Iterator<Item = PolarsResult<DataFrame>> + Send>;
+
 // For serial Stata paths: background thread builds SharedDecode once (avoids
 // re-reading the StrL table per batch) and calls read_data_frame_range with
 // O(1) byte seeks for each batch (fixed-width records).
@@ -207,7 +188,7 @@ impl Iterator for StataBackgroundIter {
     type Item = PolarsResult<DataFrame>;
 
     fn next(&mut self) -> Option<Self::Item> {
-        self.rx.recv().ok()
+        crate::read_profile::wait(|| self.rx.recv().ok())
     }
 }
 
@@ -219,11 +200,95 @@ impl Drop for StataBackgroundIter {
     }
 }
 
+/// Informative-null columns of a read, resolved once and shared by every batch.
+struct IndicatorPlan {
+    opts: crate::InformativeNullOpts,
+    pairs: Vec<(String, String)>,
+    indicator_set: HashSet<String>,
+    suffix: String,
+}
+
+fn indicator_plan(
+    metadata: &Metadata,
+    opts: crate::InformativeNullOpts,
+    row_index_name: Option<&str>,
+) -> PolarsResult<IndicatorPlan> {
+    let var_names: Vec<&str> = metadata.variables.iter().map(|v| v.name.as_str()).collect();
+    let eligible: Vec<&str> = metadata
+        .variables
+        .iter()
+        .filter(|v| matches!(v.var_type, VarType::Numeric(_)))
+        .map(|v| v.name.as_str())
+        .collect();
+    let pairs = crate::informative_null_pairs(&var_names, &eligible, &opts);
+    crate::check_informative_null_collisions(&var_names, &pairs)?;
+    if let Some(name) = row_index_name {
+        if pairs.iter().any(|(m, i)| m == name || i == name) {
+            return Err(PolarsError::ComputeError(
+                format!("row_index_name '{name}' collides with informative-null column").into(),
+            ));
+        }
+    }
+    let indicator_set = pairs.iter().map(|(m, _)| m.clone()).collect();
+    let suffix = match &opts.mode {
+        crate::InformativeNullMode::SeparateColumn { suffix } => suffix.clone(),
+        _ => "_null".to_string(),
+    };
+    Ok(IndicatorPlan {
+        opts,
+        pairs,
+        indicator_set,
+        suffix,
+    })
+}
+
+/// Rows `offset..offset + limit` with their indicator columns, in the output mode
+/// of `plan`. Batches are independent, so workers read them in parallel.
+fn read_indicator_batch(
+    path: &std::path::Path,
+    metadata: &Metadata,
+    endian: Endian,
+    version: u16,
+    columns: Option<&[usize]>,
+    offset: usize,
+    limit: usize,
+    missing_string_as_null: bool,
+    value_labels_as_strings: bool,
+    shared: &SharedDecode,
+    plan: &IndicatorPlan,
+    formats: &[(String, StataTimeFormatKind)],
+    row_index_name: Option<&str>,
+) -> PolarsResult<DataFrame> {
+    let mut df = read_data_frame_range_with_indicators(
+        path,
+        metadata,
+        endian,
+        version,
+        columns,
+        offset,
+        limit,
+        missing_string_as_null,
+        value_labels_as_strings,
+        shared,
+        &plan.indicator_set,
+        plan.opts.use_value_labels,
+        &plan.suffix,
+    )
+    .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+    apply_stata_time_formats(&mut df, formats)?;
+    let df = crate::apply_informative_null_mode(df, &plan.opts.mode, &plan.pairs)?;
+    match row_index_name {
+        Some(name) => crate::append_row_index(df, name, offset),
+        None => Ok(df),
+    }
+}
+
 pub(crate) fn stata_batch_iter(
     path: PathBuf,
     threads: Option<usize>,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     chunk_size: Option<usize>,
     preserve_order: bool,
     row_index_name: Option<String>,
@@ -231,15 +296,19 @@ pub(crate) fn stata_batch_iter(
     offset: usize,
     n_rows: Option<usize>,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    row_filter: Option<Arc<crate::RowFilter>>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 ) -> PolarsResult<StataBatchIter> {
-    let reader =
-        StataReader::open(&path).map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+    let reader = StataReader::open_cached(&path)
+        .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
     stata_batch_iter_with_reader(
         &reader,
         path,
         threads,
         missing_string_as_null,
         value_labels_as_strings,
+        value_labels_as_categorical,
         chunk_size,
         preserve_order,
         row_index_name,
@@ -247,6 +316,9 @@ pub(crate) fn stata_batch_iter(
         offset,
         n_rows,
         informative_nulls,
+        row_filter,
+        use_mmap,
+        read_ahead,
     )
 }
 
@@ -256,6 +328,7 @@ pub(crate) fn stata_batch_iter_with_reader(
     threads: Option<usize>,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     chunk_size: Option<usize>,
     preserve_order: bool,
     row_index_name: Option<String>,
@@ -263,6 +336,9 @@ pub(crate) fn stata_batch_iter_with_reader(
     offset: usize,
     n_rows: Option<usize>,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    row_filter: Option<Arc<crate::RowFilter>>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 ) -> PolarsResult<StataBatchIter> {
     let max_rows = reader.metadata().row_count.saturating_sub(offset as u64) as usize;
     let total = n_rows.unwrap_or(max_rows).min(max_rows);
@@ -311,6 +387,9 @@ pub(crate) fn stata_batch_iter_with_reader(
             ));
         }
     }
+    // Filtered-out rows would leave holes in the row index; informative-null reads
+    // decode through a separate path that does not take a filter.
+    let row_filter = row_filter.filter(|_| row_index_name.is_none() && informative_nulls.is_none());
     let mut time_formats = Vec::new();
     for var in &reader.metadata().variables {
         if let Some(kind) = stata_time_format_kind(var.format.as_deref(), &var.var_type) {
@@ -324,11 +403,17 @@ pub(crate) fn stata_batch_iter_with_reader(
         }
     }
 
+    // Resolve indicator pairs up front so configuration errors surface immediately.
+    let indicators = informative_nulls
+        .map(|null_opts| {
+            indicator_plan(reader.metadata(), null_opts, row_index_name.as_deref()).map(Arc::new)
+        })
+        .transpose()?;
+
     let n_threads = threads.unwrap_or(crate::default_thread_count()).max(1);
-    if informative_nulls.is_none() && n_threads > 1 && total >= 1000 {
+    if n_threads > 1 && total >= 1000 {
         let total_chunks = (total + batch_size - 1) / batch_size;
         let n_workers = n_threads.min(total_chunks.max(1));
-        let (tx, rx) = mpsc::sync_channel::<(usize, PolarsResult<DataFrame>)>(n_workers);
         let path = Arc::new(path);
         let metadata = Arc::new(reader.metadata().clone());
         let endian = reader.header().endian;
@@ -337,97 +422,92 @@ pub(crate) fn stata_batch_iter_with_reader(
         let formats = Arc::new(time_formats);
         let missing_null = missing_string_as_null;
         let labels_as_strings = value_labels_as_strings;
-        let shared = build_shared_decode(&path, &metadata, endian, version, labels_as_strings)
-            .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+        let shared = build_shared_decode(
+            &path,
+            &metadata,
+            endian,
+            version,
+            cols_idx.as_deref(),
+            labels_as_strings,
+            value_labels_as_categorical,
+            use_mmap,
+            read_ahead,
+        )
+        .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
         let shared = Arc::new(shared);
 
-        let ranges = split_batch_ranges(total_chunks, n_workers);
-
-        let handle = std::thread::spawn(move || {
-            let pool = match ThreadPoolBuilder::new().num_threads(n_workers).build() {
-                Ok(pool) => pool,
-                Err(e) => {
-                    let _ = tx.send((0, Err(PolarsError::ComputeError(e.to_string().into()))));
-                    return;
+        // One task per batch on the shared pool, at most `n_workers` in flight.
+        let tasks = crate::worker_pool::ScanTasks::new(
+            total_chunks,
+            crate::worker_pool::scan_limit(n_workers),
+            preserve_order,
+            move |chunk| {
+                let start_row = offset + chunk * batch_size;
+                let rows = batch_size.min(total - chunk * batch_size);
+                if let Some(plan) = indicators.as_deref() {
+                    let df = read_indicator_batch(
+                        &path,
+                        &metadata,
+                        endian,
+                        version,
+                        cols_idx.as_deref(),
+                        start_row,
+                        rows,
+                        missing_null,
+                        labels_as_strings,
+                        &shared,
+                        plan,
+                        &formats,
+                        row_index_name.as_deref(),
+                    )?;
+                    return Ok(vec![df]);
                 }
-            };
-            pool.install(|| {
-                ranges
-                    .into_par_iter()
-                    .for_each_with(tx, |sender, (batch_start, batch_count)| {
-                        if batch_count == 0 {
-                            return;
-                        }
-                        let start_row = offset + batch_start * batch_size;
-                        if start_row >= offset + total {
-                            return;
+                let mut batches = Vec::new();
+                let mut next_row = start_row;
+                let mut failed = None;
+                let mut on_batch = |mut df: DataFrame| -> bool {
+                    let result = apply_stata_time_formats(&mut df, &formats)
+                        .map_err(|e| PolarsError::ComputeError(e.to_string().into()))
+                        .and_then(|_| match row_index_name {
+                            Some(ref name) => crate::append_row_index(df, name.as_str(), next_row)
+                                .map_err(|e| PolarsError::ComputeError(e.to_string().into())),
+                            None => Ok(df),
+                        });
+                    match result {
+                        Ok(df) => {
+                            next_row = next_row.saturating_add(df.height());
+                            batches.push(df);
+                            true
                         }
-                        let range_rows =
-                            (batch_count * batch_size).min(total - batch_start * batch_size);
-                        let mut local_idx = 0usize;
-                        let row_index_name = row_index_name.clone();
-                        let mut next_row = start_row;
-                        let mut on_batch = |mut df: DataFrame| -> bool {
-                            if let Err(e) = apply_stata_time_formats(&mut df, &formats) {
-                                let _ = sender.send((
-                                    batch_start + local_idx,
-                                    Err(PolarsError::ComputeError(e.to_string().into())),
-                                ));
-                                return false;
-                            }
-                            if let Some(ref name) = row_index_name {
-                                let row_start = next_row;
-                                next_row = next_row.saturating_add(df.height());
-                                match crate::append_row_index(df, name.as_str(), row_start) {
-                                    Ok(with_idx) => df = with_idx,
-                                    Err(e) => {
-                                        let _ = sender.send((
-                                            batch_start + local_idx,
-                                            Err(PolarsError::ComputeError(e.to_string().into())),
-                                        ));
-                                        return false;
-                                    }
-                                }
-                            } else {
-                                next_row = next_row.saturating_add(df.height());
-                            }
-                            let idx = batch_start + local_idx;
-                            local_idx += 1;
-                            sender.send((idx, Ok(df))).is_ok()
-                        };
-
-                        let result = read_data_frame_streaming(
-                            &path,
-                            &metadata,
-                            endian,
-                            version,
-                            cols_idx.as_deref(),
-                            start_row,
-                            range_rows,
-                            missing_null,
-                            labels_as_strings,
-                            &shared,
-                            batch_size,
-                            &mut on_batch,
-                        );
-                        if let Err(e) = result {
-                            let _ = sender.send((
-                                batch_start + local_idx,
-                                Err(PolarsError::ComputeError(e.to_string().into())),
-                            ));
+                        Err(e) => {
+                            failed = Some(e);
+                            false
                         }
-                    });
-            });
-        });
-
-        return Ok(Box::new(ParallelStataBatchIter {
-            rx,
-            handle: Some(handle),
-            preserve_order,
-            buffer: BTreeMap::new(),
-            next_idx: 0,
-            total_chunks,
-        }));
+                    }
+                };
+                read_data_frame_streaming(
+                    &path,
+                    &metadata,
+                    endian,
+                    version,
+                    cols_idx.as_deref(),
+                    start_row,
+                    rows,
+                    missing_null,
+                    labels_as_strings,
+                    &shared,
+                    batch_size,
+                    row_filter.as_deref(),
+                    &mut on_batch,
+                )
+                .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+                match failed {
+                    Some(e) => Err(e),
+                    None => Ok(batches),
+                }
+            },
+        );
+        return Ok(Box::new(tasks));
     }
 
     let _ = preserve_order;
@@ -443,78 +523,45 @@ pub(crate) fn stata_batch_iter_with_reader(
     let labels = value_labels_as_strings;
     let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(2);
 
-    if let Some(null_opts) = informative_nulls {
-        // Compute pairs/indicator_set before spawning so errors surface immediately.
-        let var_names: Vec<String> = metadata.variables.iter().map(|v| v.name.clone()).collect();
-        let var_name_refs: Vec<&str> = var_names.iter().map(|s| s.as_str()).collect();
-        let eligible: Vec<&str> = metadata
-            .variables
-            .iter()
-            .filter(|v| matches!(v.var_type, VarType::Numeric(_)))
-            .map(|v| v.name.as_str())
-            .collect();
-        let pairs = crate::informative_null_pairs(&var_name_refs, &eligible, &null_opts);
-        crate::check_informative_null_collisions(&var_name_refs, &pairs)?;
-        if let Some(ref name) = row_index_name {
-            if pairs.iter().any(|(m, i)| m == name || i == name) {
-                return Err(PolarsError::ComputeError(
-                    format!("row_index_name '{name}' collides with informative-null column").into(),
-                ));
-            }
-        }
-        let indicator_set: std::collections::HashSet<String> =
-            pairs.iter().map(|(m, _)| m.clone()).collect();
-        let suffix = match &null_opts.mode {
-            crate::InformativeNullMode::SeparateColumn { suffix } => suffix.clone(),
-            _ => "_null".to_string(),
-        };
-        let col_indices_clone = col_indices;
-        let path_clone = path.clone();
-        let metadata_clone = metadata.clone();
-        let formats_clone = formats.clone();
-        let handle = std::thread::spawn(move || {
-            let shared =
-                match build_shared_decode(&path_clone, &metadata_clone, endian, version, labels) {
-                    Ok(s) => s,
-                    Err(e) => {
-                        let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
-                        return;
-                    }
-                };
+    if let Some(plan) = indicators {
+        let handle = crate::read_profile::spawn(move || {
+            let shared = match build_shared_decode(
+                &path,
+                &metadata,
+                endian,
+                version,
+                col_indices.as_deref(),
+                labels,
+                value_labels_as_categorical,
+                use_mmap,
+                read_ahead,
+            ) {
+                Ok(s) => s,
+                Err(e) => {
+                    let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
+                    return;
+                }
+            };
             let mut cur_offset = offset;
             let mut remaining = total;
             while remaining > 0 {
                 let take = batch_size.min(remaining);
-                let row_start = cur_offset;
-                let result = read_data_frame_range_with_indicators(
-                    &path_clone,
-                    &metadata_clone,
+                let result = read_indicator_batch(
+                    &path,
+                    &metadata,
                     endian,
                     version,
-                    col_indices_clone.as_deref(),
+                    col_indices.as_deref(),
                     cur_offset,
                     take,
                     missing_null,
                     labels,
                     &shared,
-                    &indicator_set,
-                    null_opts.use_value_labels,
-                    &suffix,
-                )
-                .map_err(|e| PolarsError::ComputeError(e.to_string().into()))
-                .and_then(|mut df| {
-                    apply_stata_time_formats(&mut df, &formats_clone)?;
-                    Ok(df)
-                })
-                .and_then(|df| crate::apply_informative_null_mode(df, &null_opts.mode, &pairs))
-                .and_then(|df| {
-                    if let Some(ref name) = row_index_name {
-                        crate::append_row_index(df, name.as_str(), row_start)
-                    } else {
-                        Ok(df)
-                    }
-                });
-                if tx.send(result).is_err() {
+                    &plan,
+                    &formats,
+                    row_index_name.as_deref(),
+                );
+                if crate::read_profile::wait(|| tx.send(result)).is_err() {
                     return;
                 }
                 cur_offset += take;
@@ -528,8 +575,18 @@ pub(crate) fn stata_batch_iter_with_reader(
     }
 
     // Normal serial: build SharedDecode once, then read one batch at a time.
-    let handle = std::thread::spawn(move || {
-        let shared = match build_shared_decode(&path, &metadata, endian, version, labels) {
+    let handle = crate::read_profile::spawn(move || {
+        let shared = match build_shared_decode(
+            &path,
+            &metadata,
+            endian,
+            version,
+            col_indices.as_deref(),
+            labels,
+            value_labels_as_categorical,
+            use_mmap,
+            read_ahead,
+        ) {
             Ok(s) => s,
             Err(e) => {
                 let _ = tx.send(Err(PolarsError::ComputeError(e.to_string().into())));
@@ -552,6 +609,7 @@ pub(crate) fn stata_batch_iter_with_reader(
                 missing_null,
                 labels,
                 &shared,
+                row_filter.as_deref(),
             )
             .map_err(|e| PolarsError::ComputeError(e.to_string().into()))
             .and_then(|mut df| {
@@ -565,7 +623,7 @@ pub(crate) fn stata_batch_iter_with_reader(
                     Ok(df)
                 }
             });
-            if tx.send(result).is_err() {
+            if crate::read_profile::wait(|| tx.send(result)).is_err() {
                 return;
             }
             cur_offset += take;
@@ -584,14 +642,38 @@ impl AnonymousScan for StataScan {
     }
 
     fn scan(&self, opts: AnonymousScanArgs) -> PolarsResult<DataFrame> {
-        let cols = opts
-            .with_columns
-            .map(|c| c.iter().map(|s| s.to_string()).collect::<Vec<_>>());
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let predicate = opts.predicate.as_ref();
+        let row_filter = predicate
+            .and_then(crate::RowFilter::from_expr)
+            .map(Arc::new);
+        let extra_columns = predicate
+            .map(|p| {
+                crate::row_filter::predicate_extra_columns(p, opts.with_columns.as_deref(), |n| {
+                    // Informative-null indicator columns are derived, not stored.
+                    self.informative_nulls.is_none()
+                        && opts.schema.contains(n)
+                        && self.row_index_name.as_deref() != Some(n)
+                })
+            })
+            .unwrap_or_default();
+        let cols = opts.with_columns.as_ref().map(|c| {
+            c.iter()
+                .chain(extra_columns.iter())
+                .map(|s| s.to_string())
+                .collect::<Vec<_>>()
+        });
+        let row_count = StataReader::open_cached(&self.path)
+            .map(|r| r.metadata().row_count as usize)
+            .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+        let expected_rows =
+            crate::frame_assembly::expected_rows(row_count, opts.n_rows, row_filter.is_some());
         let iter = stata_batch_iter(
             self.path.clone(),
             self.threads,
             self.missing_string_as_null,
             self.value_labels_as_strings.unwrap_or(true),
+            self.value_labels_as_categorical,
             self.chunk_size,
             self.preserve_order,
             self.row_index_name.clone(),
@@ -599,20 +681,23 @@ impl AnonymousScan for StataScan {
             0,
             opts.n_rows,
             self.informative_nulls.clone(),
+            row_filter,
+            self.use_mmap,
+            self.read_ahead,
         )?;
 
         let prefetch = crate::scan_prefetch::spawn_prefetcher(iter.map(|batch| batch));
-        let mut out: Option<DataFrame> = None;
+        // Without a residual predicate the rows read are the rows returned, so the
+        // columns can be compressed as they are assembled.
+        let fuse = self.compress_opts.enabled && predicate.is_none();
+        let mut out = crate::frame_assembly::FrameAssembler::new(expected_rows)
+            .with_compression(fuse.then_some(&self.compress_opts));
         while let Some(df) = prefetch.next()? {
-            if let Some(acc) = out.as_mut() {
-                acc.vstack_mut(&df)
-                    .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
-            } else {
-                out = Some(df);
-            }
+            out.push(df)?;
         }
-        let df = out.unwrap_or_else(DataFrame::empty);
-        if self.compress_opts.enabled {
+        let df = out.finish()?;
+        let df = crate::row_filter::apply_residual_predicate(df, predicate, &extra_columns)?;
+        if self.compress_opts.enabled && !fuse {
             let compressed = crate::compress_df_if_enabled(&df, &self.compress_opts)
                 .map_err(|e| PolarsError::ComputeError(e.into()))?;
             Ok(compressed)
@@ -621,15 +706,24 @@ impl AnonymousScan for StataScan {
         }
     }
 
+    fn allows_predicate_pushdown(&self) -> bool {
+        true
+    }
+
     fn schema(&self, _n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
-        let reader = StataReader::open(&self.path)
+        let _profile = crate::read_profile::enter(self.profiler.as_ref());
+        let reader = StataReader::open_cached(&self.path)
             .map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
 
         let mut schema = Schema::with_capacity(reader.metadata().variables.len());
         for var in &reader.metadata().variables {
             let use_labels = self.value_labels_as_strings.unwrap_or(true);
             let dtype = if use_labels && var.value_label_name.is_some() {
-                DataType::String
+                var.value_label_name
+                    .as_deref()
+                    .filter(|_| self.value_labels_as_categorical)
+                    .and_then(|name| label_categorical_dtype(reader.metadata(), name))
+                    .unwrap_or(DataType::String)
             } else {
                 if let Some(kind) = stata_time_format_kind(var.format.as_deref(), &var.var_type) {
                     match kind {
@@ -21,14 +21,7 @@ pub struct OpenProfile {
     pub metadata_ms: f64,
 }
 
-#[derive(Debug, Clone)]
-pub struct ReadProfile {
-    pub parse_rows_ms: f64,
-    pub parse_values_ms: f64,
-    pub add_row_ms: f64,
-    pub build_df_ms: f64,
-    pub total_ms: f64,
-}
+pub use crate::read_profile::ReadProfile;
 
 impl StataReader {
     pub fn open(path: impl AsRef<Path>) -> Result<Self> {
@@ -45,6 +38,12 @@ impl StataReader {
         })
     }
 
+    /// Like [`open`](Self::open), but shares the parsed header and metadata with
+    /// earlier opens of the same unchanged file (see [`crate::clear_metadata_cache`]).
+    pub fn open_cached(path: impl AsRef<Path>) -> Result<Arc<Self>> {
+        crate::metadata_cache::cached(path.as_ref(), |p| Self::open(p))
+    }
+
     pub fn open_with_profile(path: impl AsRef<Path>) -> Result<(Self, OpenProfile)> {
         let path = path.as_ref().to_path_buf();
         let mut file = File::open(&path)?;
@@ -97,6 +96,7 @@ impl StataReader {
             threads,
             _opts.missing_string_as_null,
             _opts.value_labels_as_strings,
+            _opts.value_labels_as_categorical,
             _opts.chunk_size,
             true,
             None,
@@ -104,19 +104,19 @@ impl StataReader {
             _opts.offset,
             Some(limit),
             _opts.informative_nulls.clone(),
+            None,
+            _opts.use_mmap,
+            _opts.read_ahead,
         )
         .map_err(|e| crate::stata::error::Error::ParseError(e.to_string()))?;
 
-        let mut df: Option<DataFrame> = None;
+        let available = self.metadata.row_count.saturating_sub(_opts.offset as u64) as usize;
+        let mut out = crate::frame_assembly::FrameAssembler::new(limit.min(available));
         while let Some(batch) = iter.next() {
             let batch = batch.map_err(|e| crate::stata::error::Error::ParseError(e.to_string()))?;
-            if let Some(acc) = df.as_mut() {
-                acc.vstack_mut(&batch)?;
-            } else {
-                df = Some(batch);
-            }
+            out.push(batch)?;
         }
-        let mut df = df.unwrap_or_else(DataFrame::empty);
+        let mut df = out.finish()?;
 
         if let Some(schema) = _opts.schema {
             df = cast_dataframe(df, &schema)?;
@@ -125,20 +125,14 @@ impl StataReader {
         Ok(df)
     }
 
-    fn execute_read_profiled(&self, _opts: ReadBuilder) -> Result<(DataFrame, ReadProfile)> {
-        let start = Instant::now();
-        let df = self.execute_read(_opts)?;
-        let total_ms = start.elapsed().as_secs_f64() * 1000.0;
-        Ok((
-            df,
-            ReadProfile {
-                parse_rows_ms: 0.0,
-                parse_values_ms: 0.0,
-                add_row_ms: 0.0,
-                build_df_ms: total_ms,
-                total_ms,
-            },
-        ))
+    /// Read under a fresh [`ReadProfiler`](crate::ReadProfiler) and return its report.
+    fn execute_read_profiled(&self, opts: ReadBuilder) -> Result<(DataFrame, ReadProfile)> {
+        let profiler = crate::ReadProfiler::new();
+        let df = {
+            let _profile = profiler.enter();
+            self.execute_read(opts)?
+        };
+        Ok((df, profiler.report()))
     }
 }
 
@@ -154,7 +148,10 @@ pub struct ReadBuilder<'a> {
     chunk_size: Option<usize>,
     missing_string_as_null: bool,
     value_labels_as_strings: bool,
+    value_labels_as_categorical: bool,
     informative_nulls: Option<crate::InformativeNullOpts>,
+    use_mmap: bool,
+    read_ahead: Option<usize>,
 }
 
 impl<'a> ReadBuilder<'a> {
@@ -170,7 +167,10 @@ impl<'a> ReadBuilder<'a> {
             chunk_size: None,
             missing_string_as_null: true,
             value_labels_as_strings: true,
+            value_labels_as_categorical: false,
             informative_nulls: None,
+            use_mmap: false,
+            read_ahead: None,
         }
     }
 
@@ -210,10 +210,27 @@ impl<'a> ReadBuilder<'a> {
         self.value_labels_as_strings = v;
         self
     }
+    /// With value labels applied, read labelled columns as `Categorical`.
+    pub fn value_labels_as_categorical(mut self, v: bool) -> Self {
+        self.value_labels_as_categorical = v;
+        self
+    }
     pub fn informative_nulls(mut self, v: Option<crate::InformativeNullOpts>) -> Self {
         self.informative_nulls = v;
         self
     }
+    /// Read through a memory map of the file instead of buffered reads.
+    pub fn use_mmap(mut self, v: bool) -> Self {
+        self.use_mmap = v;
+        self
+    }
+
+    /// Read through positioned range reads with a read-ahead window of about
+    /// `window` bytes (for network storage).
+    pub fn read_ahead(mut self, window: usize) -> Self {
+        self.read_ahead = Some(window);
+        self
+    }
 
     pub fn finish(self) -> Result<DataFrame> {
         self.reader.execute_read(self)
@@ -51,6 +51,14 @@ pub fn missing_rules(ds_format: u16) -> MissingRules {
     }
 }
 
+/// First `N` bytes of `buf` as an array: a single fixed-size load in the hot
+/// readers below, where a `Cursor` would add bounds bookkeeping per value.
+#[inline(always)]
+fn load<const N: usize>(buf: &[u8]) -> Option<[u8; N]> {
+    buf.get(..N)?.try_into().ok()
+}
+
+#[inline]
 pub fn read_i8(buf: &[u8], rules: MissingRules) -> Option<i8> {
     let v = buf[0] as i8;
     if rules.system_missing_enabled && v >= rules.system_missing_int8 {
@@ -63,11 +71,12 @@ pub fn read_i8(buf: &[u8], rules: MissingRules) -> Option<i8> {
     }
 }
 
+#[inline]
 pub fn read_i16(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<i16> {
-    let mut cursor = std::io::Cursor::new(buf);
+    let bytes = load::<2>(buf)?;
     let v = match endian {
-        Endian::Little => cursor.read_i16::<LittleEndian>().ok()?,
-        Endian::Big => cursor.read_i16::<BigEndian>().ok()?,
+        Endian::Little => i16::from_le_bytes(bytes),
+        Endian::Big => i16::from_be_bytes(bytes),
     };
     if rules.system_missing_enabled && v >= rules.system_missing_int16 {
         return None;
@@ -79,11 +88,12 @@ pub fn read_i16(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<i16>
     }
 }
 
+#[inline]
 pub fn read_i32(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<i32> {
-    let mut cursor = std::io::Cursor::new(buf);
+    let bytes = load::<4>(buf)?;
     let v = match endian {
-        Endian::Little => cursor.read_i32::<LittleEndian>().ok()?,
-        Endian::Big => cursor.read_i32::<BigEndian>().ok()?,
+        Endian::Little => i32::from_le_bytes(bytes),
+        Endian::Big => i32::from_be_bytes(bytes),
     };
     if rules.system_missing_enabled && v >= rules.system_missing_int32 {
         return None;
@@ -95,11 +105,12 @@ pub fn read_i32(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<i32>
     }
 }
 
+#[inline]
 pub fn read_f32(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<f32> {
-    let mut cursor = std::io::Cursor::new(buf);
+    let bytes = load::<4>(buf)?;
     let bits = match endian {
-        Endian::Little => cursor.read_u32::<LittleEndian>().ok()?,
-        Endian::Big => cursor.read_u32::<BigEndian>().ok()?,
+        Endian::Little => u32::from_le_bytes(bytes),
+        Endian::Big => u32::from_be_bytes(bytes),
     };
     let v = f32::from_bits(bits);
     let sign = (bits & 0x8000_0000) != 0;
@@ -114,11 +125,12 @@ pub fn read_f32(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<f32>
     }
 }
 
+#[inline]
 pub fn read_f64(buf: &[u8], endian: Endian, rules: MissingRules) -> Option<f64> {
-    let mut cursor = std::io::Cursor::new(buf);
+    let bytes = load::<8>(buf)?;
     let bits = match endian {
-        Endian::Little => cursor.read_u64::<LittleEndian>().ok()?,
-        Endian::Big => cursor.read_u64::<BigEndian>().ok()?,
+        Endian::Little => u64::from_le_bytes(bytes),
+        Endian::Big => u64::from_be_bytes(bytes),
     };
     let v = f64::from_bits(bits);
     let sign = (bits & 0x8000_0000_0000_0000) != 0;
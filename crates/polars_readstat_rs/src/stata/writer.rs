@@ -3,7 +3,7 @@ use crate::stata::error::{Error, Result};
 use polars::prelude::*;
 use std::collections::{BTreeMap, HashMap, HashSet};
 use std::fs::File;
-use std::io::{BufWriter, Seek, SeekFrom, Write};
+use std::io::{BufWriter, Read, Seek, SeekFrom, Write};
 use std::path::{Path, PathBuf};
 
 const DTA_VERSION_COMPAT: u16 = 118;
@@ -309,7 +309,7 @@ impl StataWriter {
         write_dta_descriptors(&mut writer, &prepared)?;
         write_dta_variable_labels(&mut writer, &prepared)?;
         write_dta_characteristics(&mut writer)?;
-        let _ = write_dta_data_batches(&mut writer, &prepared, batches)?;
+        let _ = write_dta_data_batches(&mut writer, &prepared, batches, self.n_threads, None)?;
         write_dta_strls(&mut writer, &prepared)?;
         write_dta_value_labels(&mut writer, &prepared)?;
         write_dta_footer(&mut writer)?;
@@ -341,17 +341,12 @@ impl StataWriter {
         );
         let variable_formats =
             variable_formats.map(|formats| rename_variable_formats(&formats, &name_map));
-        let prepared = PreparedWrite::from_schema(
+        let mut prepared = PreparedWrite::from_schema(
             &schema,
             value_labels.as_ref(),
             variable_labels.as_ref(),
             variable_formats.as_ref(),
         )?;
-        if prepared.has_strl {
-            return Err(Error::ParseError(
-                "streaming batch writing with strL is not supported without a pre-pass".to_string(),
-            ));
-        }
 
         let file = File::create(&self.path)?;
         let mut writer = BufWriter::with_capacity(8 * 1024 * 1024, file);
@@ -359,8 +354,29 @@ impl StataWriter {
         write_dta_descriptors(&mut writer, &prepared)?;
         write_dta_variable_labels(&mut writer, &prepared)?;
         write_dta_characteristics(&mut writer)?;
-        let rows_written = write_dta_data_batches(&mut writer, &prepared, batches)?;
-        write_dta_strls(&mut writer, &prepared)?;
+        // strLs go after <data>, so they are spilled to a file batch by batch,
+        // copied in after it, and the map is patched with their final size.
+        let mut spill = if prepared.has_strl {
+            Some(StrlSpill::create(&self.path)?)
+        } else {
+            None
+        };
+        let rows_written = write_dta_data_batches(
+            &mut writer,
+            &prepared,
+            batches,
+            self.n_threads,
+            spill.as_mut(),
+        )?;
+        match spill {
+            Some(spill) => {
+                prepared.spilled_strl_len = spill.len;
+                write_tag(&mut writer, "<strls>")?;
+                spill.copy_into(&mut writer)?;
+                write_tag(&mut writer, "</strls>")?;
+            }
+            None => write_dta_strls(&mut writer, &prepared)?,
+        }
         write_dta_value_labels(&mut writer, &prepared)?;
         write_dta_footer(&mut writer)?;
         patch_header_and_map(&mut writer, &prepared, rows_written, patch_offsets)?;
@@ -396,6 +412,63 @@ struct StrlEntry {
     data: Vec<u8>,
 }
 
+/// strL entries of a streaming write, encoded into a file next to the output as
+/// their batch is written, so that only one batch of them is ever in memory. The
+/// file is removed when the spill is dropped.
+struct StrlSpill {
+    path: PathBuf,
+    file: BufWriter<File>,
+    /// Bytes of encoded entries so far.
+    len: u64,
+}
+
+impl StrlSpill {
+    fn create(output: &Path) -> Result<Self> {
+        let mut name = output.as_os_str().to_os_string();
+        name.push(format!(".strls-{}.tmp", std::process::id()));
+        let path = PathBuf::from(name);
+        let file = std::fs::OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(&path)?;
+        Ok(Self {
+            path,
+            file: BufWriter::with_capacity(1024 * 1024, file),
+            len: 0,
+        })
+    }
+
+    fn append(&mut self, entries: &[StrlEntry]) -> Result<()> {
+        for entry in entries {
+            write_strl_entry(&mut self.file, entry)?;
+            self.len += strl_entry_len(entry);
+        }
+        Ok(())
+    }
+
+    /// Copy the spilled entries to `writer`, in the order they were appended.
+    fn copy_into<W: Write>(mut self, writer: &mut W) -> Result<()> {
+        self.file.flush()?;
+        let file = self.file.get_mut();
+        file.seek(SeekFrom::Start(0))?;
+        let copied = std::io::copy(&mut file.take(self.len), writer)?;
+        if copied != self.len {
+            return Err(Error::ParseError(
+                "strL spill file was truncated".to_string(),
+            ));
+        }
+        Ok(())
+    }
+}
+
+impl Drop for StrlSpill {
+    fn drop(&mut self) {
+        let _ = std::fs::remove_file(&self.path);
+    }
+}
+
 #[derive(Debug, Clone)]
 struct ValueLabelTable {
     name: String,
@@ -415,6 +488,8 @@ struct PreparedWrite {
     lbllist: Vec<u8>,
     var_labels: Vec<u8>,
     strls: Vec<StrlEntry>,
+    /// Bytes of strL entries written through a [`StrlSpill`] instead of `strls`.
+    spilled_strl_len: u64,
     has_strl: bool,
     value_labels: Vec<ValueLabelTable>,
 }
@@ -519,6 +594,7 @@ impl PreparedWrite {
             lbllist,
             var_labels,
             strls,
+            spilled_strl_len: 0,
             has_strl,
             value_labels: value_label_tables,
         })
@@ -1063,6 +1139,18 @@ fn make_unique(name: &str, existing: &[String]) -> String {
 }
 
 fn build_strls(df: &DataFrame, columns: &[ColumnSpec]) -> Result<Vec<StrlEntry>> {
+    let mut entries = Vec::new();
+    append_strls(&mut entries, df, columns, 0)?;
+    Ok(entries)
+}
+
+/// Appends the strL entries of `df`, whose first row is file row `row_base`.
+fn append_strls(
+    entries: &mut Vec<StrlEntry>,
+    df: &DataFrame,
+    columns: &[ColumnSpec],
+    row_base: usize,
+) -> Result<()> {
     let mut strl_cols = Vec::new();
 
     for col in columns {
@@ -1075,8 +1163,10 @@ fn build_strls(df: &DataFrame, columns: &[ColumnSpec]) -> Result<Vec<StrlEntry>>
         let utf8 = series.str().map_err(Error::Polars)?.clone();
         strl_cols.push((col.index, utf8));
     }
+    if strl_cols.is_empty() {
+        return Ok(());
+    }
 
-    let mut entries = Vec::new();
     for row_idx in 0..df.height() {
         for (col_index, utf8) in &strl_cols {
             if let Some(s) = utf8.get(row_idx) {
@@ -1086,14 +1176,14 @@ fn build_strls(df: &DataFrame, columns: &[ColumnSpec]) -> Result<Vec<StrlEntry>>
                 data.push(0);
                 entries.push(StrlEntry {
                     v: (*col_index + 1) as u32,
-                    o: (row_idx + 1) as u64,
+                    o: (row_base + row_idx + 1) as u64,
                     data,
                 });
             }
         }
     }
 
-    Ok(entries)
+    Ok(())
 }
 
 #[derive(Debug, Clone, Copy)]
@@ -1337,13 +1427,18 @@ fn measure_data(prepared: &PreparedWrite) -> u64 {
 }
 
 fn measure_strls(prepared: &PreparedWrite) -> u64 {
-    let mut len = 0u64;
+    let mut len = prepared.spilled_strl_len;
     for entry in &prepared.strls {
-        len += 3 + 17 + entry.data.len() as u64;
+        len += strl_entry_len(entry);
     }
     "<strls>".len() as u64 + len + "</strls>".len() as u64
 }
 
+/// Encoded size of one GSO record.
+fn strl_entry_len(entry: &StrlEntry) -> u64 {
+    3 + 17 + entry.data.len() as u64
+}
+
 fn measure_value_labels(prepared: &PreparedWrite) -> u64 {
     let mut len = "<value_labels>".len() + "</value_labels>".len();
     for table in &prepared.value_labels {
@@ -1402,109 +1497,95 @@ fn write_dta_data_df_parallel<W: Write>(
     df: &DataFrame,
     n_threads: Option<usize>,
 ) -> Result<()> {
-    use rayon::prelude::*;
-
     write_tag(writer, "<data>")?;
-
-    let mut cols: Vec<&Series> = Vec::with_capacity(prepared.columns.len());
-    for col in &prepared.columns {
-        let column = df.column(&col.name).map_err(Error::Polars)?;
-        cols.push(column.as_materialized_series());
-    }
-
-    let nrows = df.height();
-    let record_len = prepared.record_len;
-    let chunk_rows = DTA_PARALLEL_CHUNK_ROWS.max(1);
-    let n_chunks = (nrows + chunk_rows - 1) / chunk_rows;
-    let col_widths: Vec<usize> = prepared
-        .columns
-        .iter()
-        .map(storage_width_for_column)
-        .collect();
-    let mut col_offsets = Vec::with_capacity(prepared.columns.len());
-    let mut acc = 0usize;
-    for w in &col_widths {
-        col_offsets.push(acc);
-        acc += *w;
-    }
-    let build_buffers = || -> Result<Vec<(usize, Vec<u8>)>> {
-        (0..n_chunks)
-            .into_par_iter()
-            .map(|chunk_idx| -> Result<(usize, Vec<u8>)> {
-                let start = chunk_idx * chunk_rows;
-                let end = (start + chunk_rows).min(nrows);
-                let rows = end - start;
-                let mut buf = vec![0u8; rows * record_len];
-                for (row_offset, row_idx) in (start..end).enumerate() {
-                    let base = row_offset * record_len;
-                    let row_slice = &mut buf[base..base + record_len];
-                    row_slice.fill(0);
-                    for (col_idx, col_spec) in prepared.columns.iter().enumerate() {
-                        let series = &cols[col_idx];
-                        let offset = col_offsets[col_idx];
-                        let width = col_widths[col_idx];
-                        let cell = &mut row_slice[offset..offset + width];
-                        write_cell(cell, series, col_spec, row_idx)?;
-                    }
-                }
-                Ok((chunk_idx, buf))
-            })
-            .collect::<Result<Vec<_>>>()
-    };
-
-    let mut buffers = if let Some(n) = n_threads {
-        if n == 0 {
-            return Err(Error::ParseError("n_threads must be >= 1".to_string()));
-        }
-        let pool = rayon::ThreadPoolBuilder::new()
-            .num_threads(n)
-            .build()
-            .map_err(|e| Error::ParseError(format!("failed to build thread pool: {e}")))?;
-        pool.install(build_buffers)?
-    } else {
-        build_buffers()?
-    };
-
-    buffers.sort_by_key(|(idx, _)| *idx);
-    for (_, buf) in buffers {
-        writer.write_all(&buf)?;
+    let parallelism = write_parallelism(n_threads)?;
+    let layout = RecordLayout::new(prepared);
+    let cols = batch_series(prepared, df)?;
+    let mut buffers = Vec::new();
+    encode_batch(
+        parallelism,
+        prepared,
+        &layout,
+        &cols,
+        df.height(),
+        0,
+        &mut buffers,
+    )?;
+    for buf in &buffers {
+        writer.write_all(buf)?;
     }
-
     write_tag(writer, "</data>")?;
     Ok(())
 }
 
-fn write_dta_data_batches<W: Write, I>(
+/// Streams `<data>` for `batches`: each batch is encoded in parallel on the
+/// pool while the previous one is written by a dedicated writer thread. The
+/// chunk buffers cycle back from the writer, so steady state allocates nothing.
+/// strL entries of every batch are spilled to `strls` with file-wide `o` ids.
+fn write_dta_data_batches<W: Write + Send, I>(
     writer: &mut W,
     prepared: &PreparedWrite,
     batches: I,
+    n_threads: Option<usize>,
+    mut strls: Option<&mut StrlSpill>,
 ) -> Result<usize>
 where
     I: IntoIterator<Item = DataFrame>,
 {
     write_tag(writer, "<data>")?;
-    let mut row_buf = vec![0u8; prepared.record_len];
+    let parallelism = write_parallelism(n_threads)?;
+    let layout = RecordLayout::new(prepared);
     let mut rows_written = 0usize;
-    for batch in batches {
-        let mut cols: Vec<&Series> = Vec::with_capacity(prepared.columns.len());
-        for col in &prepared.columns {
-            let column = batch.column(&col.name).map_err(|e| Error::Polars(e))?;
-            cols.push(column.as_materialized_series());
-        }
-        for row_idx in 0..batch.height() {
-            row_buf.fill(0);
-            let mut offset = 0usize;
-            for (col_idx, col_spec) in prepared.columns.iter().enumerate() {
-                let series = cols[col_idx];
-                let width = storage_width_for_column(col_spec);
-                let slice = &mut row_buf[offset..offset + width];
-                write_cell(slice, series, col_spec, row_idx)?;
-                offset += width;
+
+    std::thread::scope(|scope| -> Result<()> {
+        // One batch queued behind the one being written bounds memory to about
+        // three batches of encoded rows.
+        let (full_tx, full_rx) = std::sync::mpsc::sync_channel::<Vec<Vec<u8>>>(1);
+        let (free_tx, free_rx) = std::sync::mpsc::channel::<Vec<Vec<u8>>>();
+        let out = &mut *writer;
+        let writer_thread = scope.spawn(move || -> Result<()> {
+            for buffers in full_rx {
+                for buf in &buffers {
+                    out.write_all(buf)?;
+                }
+                let _ = free_tx.send(buffers);
             }
-            writer.write_all(&row_buf)?;
-            rows_written += 1;
-        }
-    }
+            Ok(())
+        });
+
+        let encoded = (|| -> Result<()> {
+            for batch in batches {
+                let cols = batch_series(prepared, &batch)?;
+                let mut buffers = free_rx.try_recv().unwrap_or_default();
+                encode_batch(
+                    parallelism,
+                    prepared,
+                    &layout,
+                    &cols,
+                    batch.height(),
+                    rows_written,
+                    &mut buffers,
+                )?;
+                if let Some(spill) = strls.as_deref_mut() {
+                    let mut entries = Vec::new();
+                    append_strls(&mut entries, &batch, &prepared.columns, rows_written)?;
+                    spill.append(&entries)?;
+                }
+                rows_written += batch.height();
+                if full_tx.send(buffers).is_err() {
+                    // The writer stopped early; its error is reported below.
+                    break;
+                }
+            }
+            Ok(())
+        })();
+        drop(full_tx);
+        let written = writer_thread
+            .join()
+            .map_err(|_| Error::ParseError("Stata data writer thread panicked".to_string()))?;
+        written.and(encoded)
+    })?;
+
     write_tag(writer, "</data>")?;
     if let Some(expected) = prepared.row_count {
         if expected != rows_written {
@@ -1516,7 +1597,107 @@ where
     Ok(rows_written)
 }
 
-fn write_cell(buf: &mut [u8], series: &Series, spec: &ColumnSpec, row_idx: usize) -> Result<()> {
+/// Encode tasks one write may run at once on the shared worker pool: `n_threads`
+/// capped at the pool size, or the whole pool when unset.
+fn write_parallelism(n_threads: Option<usize>) -> Result<usize> {
+    match n_threads {
+        Some(0) => Err(Error::ParseError("n_threads must be >= 1".to_string())),
+        Some(n) => Ok(crate::worker_pool::scan_limit(n)),
+        None => Ok(crate::worker_pool::worker_threads()),
+    }
+}
+
+/// Byte offset and width of every column inside one record.
+struct RecordLayout {
+    offsets: Vec<usize>,
+    widths: Vec<usize>,
+}
+
+impl RecordLayout {
+    fn new(prepared: &PreparedWrite) -> Self {
+        let widths: Vec<usize> = prepared
+            .columns
+            .iter()
+            .map(storage_width_for_column)
+            .collect();
+        let mut offsets = Vec::with_capacity(widths.len());
+        let mut acc = 0usize;
+        for w in &widths {
+            offsets.push(acc);
+            acc += *w;
+        }
+        Self { offsets, widths }
+    }
+}
+
+fn batch_series<'a>(prepared: &PreparedWrite, df: &'a DataFrame) -> Result<Vec<&'a Series>> {
+    prepared
+        .columns
+        .iter()
+        .map(|col| {
+            df.column(&col.name)
+                .map(|c| c.as_materialized_series())
+                .map_err(Error::Polars)
+        })
+        .collect()
+}
+
+/// Encodes `nrows` rows into `buffers`, one buffer per `DTA_PARALLEL_CHUNK_ROWS`
+/// rows, reusing whatever buffers are already there. `row_base` is the file row
+/// of the first row, used for strL references. The chunks are split into at
+/// most `parallelism` tasks on the shared worker pool.
+fn encode_batch(
+    parallelism: usize,
+    prepared: &PreparedWrite,
+    layout: &RecordLayout,
+    cols: &[&Series],
+    nrows: usize,
+    row_base: usize,
+    buffers: &mut Vec<Vec<u8>>,
+) -> Result<()> {
+    use rayon::prelude::*;
+
+    let record_len = prepared.record_len;
+    let chunk_rows = DTA_PARALLEL_CHUNK_ROWS.max(1);
+    let n_chunks = (nrows + chunk_rows - 1) / chunk_rows;
+    buffers.resize_with(n_chunks, Vec::new);
+    let chunks_per_task = ((n_chunks + parallelism.max(1) - 1) / parallelism.max(1)).max(1);
+    let encode_chunk = |chunk_idx: usize, buf: &mut Vec<u8>| -> Result<()> {
+        let start = chunk_idx * chunk_rows;
+        let end = (start + chunk_rows).min(nrows);
+        buf.clear();
+        buf.resize((end - start) * record_len, 0);
+        for (row_offset, row_idx) in (start..end).enumerate() {
+            let base = row_offset * record_len;
+            let row_slice = &mut buf[base..base + record_len];
+            for (col_idx, col_spec) in prepared.columns.iter().enumerate() {
+                let offset = layout.offsets[col_idx];
+                let cell = &mut row_slice[offset..offset + layout.widths[col_idx]];
+                write_cell(cell, cols[col_idx], col_spec, row_idx, row_base)?;
+            }
+        }
+        Ok(())
+    };
+    crate::worker_pool::install(|| {
+        buffers
+            .par_chunks_mut(chunks_per_task)
+            .enumerate()
+            .try_for_each(|(task_idx, task_buffers)| -> Result<()> {
+                for (i, buf) in task_buffers.iter_mut().enumerate() {
+                    encode_chunk(task_idx * chunks_per_task + i, buf)?;
+                }
+                Ok(())
+            })
+    })
+}
+
+fn write_cell(
+    buf: &mut [u8],
+    series: &Series,
+    spec: &ColumnSpec,
+    row_idx: usize,
+    row_base: usize,
+) -> Result<()> {
     match spec.kind {
         ColumnKind::Int8 => write_i8(buf, series, row_idx),
         ColumnKind::Int16 => write_i16(buf, series, row_idx),
@@ -1524,7 +1705,7 @@ fn write_cell(buf: &mut [u8], series: &Series, spec: &ColumnSpec, row_idx: usize
         ColumnKind::Float32 => write_f32(buf, series, row_idx),
         ColumnKind::Float64 => write_f64(buf, series, row_idx, spec),
         ColumnKind::Str { width } => write_str(buf, series, row_idx, width),
-        ColumnKind::StrL => write_strl_ref(buf, series, row_idx, spec),
+        ColumnKind::StrL => write_strl_ref(buf, series, row_idx, row_base, spec),
     }
 }
 
@@ -1636,6 +1817,7 @@ fn write_strl_ref(
     buf: &mut [u8],
     series: &Series,
     row_idx: usize,
+    row_base: usize,
     spec: &ColumnSpec,
 ) -> Result<()> {
     let value = series.get(row_idx)?;
@@ -1644,7 +1826,7 @@ fn write_strl_ref(
         return Ok(());
     }
     let v = (spec.index + 1) as u16;
-    let o = (row_idx + 1) as u64;
+    let o = (row_base + row_idx + 1) as u64;
     buf[..2].copy_from_slice(&v.to_le_bytes());
     let o_bytes = o.to_le_bytes();
     buf[2..8].copy_from_slice(&o_bytes[..6]);
@@ -1775,17 +1957,22 @@ fn min_max_i64(series: &Series) -> Result<(i64, i64, bool)> {
 fn write_dta_strls<W: Write>(writer: &mut W, prepared: &PreparedWrite) -> Result<()> {
     write_tag(writer, "<strls>")?;
     for entry in &prepared.strls {
-        write_string(writer, "GSO")?;
-        write_u32(writer, entry.v)?;
-        write_u64(writer, entry.o)?;
-        write_u8(writer, 0x82)?;
-        write_i32_le(writer, entry.data.len() as i32)?;
-        writer.write_all(&entry.data)?;
+        write_strl_entry(writer, entry)?;
     }
     write_tag(writer, "</strls>")?;
     Ok(())
 }
 
+fn write_strl_entry<W: Write>(writer: &mut W, entry: &StrlEntry) -> Result<()> {
+    write_string(writer, "GSO")?;
+    write_u32(writer, entry.v)?;
+    write_u64(writer, entry.o)?;
+    write_u8(writer, 0x82)?;
+    write_i32_le(writer, entry.data.len() as i32)?;
+    writer.write_all(&entry.data)?;
+    Ok(())
+}
+
 fn write_dta_value_labels<W: Write>(writer: &mut W, prepared: &PreparedWrite) -> Result<()> {
     write_tag(writer, "<value_labels>")?;
     for table in &prepared.value_labels {
@@ -0,0 +1,121 @@
+//! Decode cache for fixed-width character columns whose values repeat (state
+//! names, codes, yes/no flags).
+//!
+//! Every reader decodes a character cell by trimming the raw bytes and running
+//! them through `encoding_rs`. On low-cardinality columns that is the same
+//! handful of conversions millions of times. [`StringInterner`] keys the decoded
+//! text by the trimmed raw bytes so a repeat costs one hash lookup. It samples
+//! the first values of each column and switches itself off when they are mostly
+//! distinct, so free-text columns only pay for the sample.
+
+use std::borrow::Cow;
+use std::collections::HashMap;
+
+/// Values looked at before deciding whether the column repeats.
+const SAMPLE_VALUES: usize = 512;
+/// A sample with more distinct values than this turns the cache off.
+const SAMPLE_MAX_DISTINCT: usize = SAMPLE_VALUES / 8;
+/// Distinct values kept at most; later new values are decoded uncached.
+const MAX_ENTRIES: usize = 4096;
+/// Longer raw values are decoded uncached.
+const MAX_KEY_BYTES: usize = 256;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum Mode {
+    Sampling,
+    On,
+    Off,
+}
+
+/// Per-column cache from trimmed raw bytes to decoded text.
+pub(crate) struct StringInterner {
+    index: HashMap<Box<[u8]>, u32>,
+    values: Vec<Box<str>>,
+    seen: usize,
+    mode: Mode,
+}
+
+impl Default for StringInterner {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl StringInterner {
+    pub(crate) fn new() -> Self {
+        Self {
+            index: HashMap::new(),
+            values: Vec::new(),
+            seen: 0,
+            mode: Mode::Sampling,
+        }
+    }
+
+    /// Decoded text of `raw`, calling `decode` only when `raw` is not cached.
+    #[inline]
+    pub(crate) fn decode<'a, F>(&'a mut self, raw: &'a [u8], decode: F) -> Cow<'a, str>
+    where
+        F: FnOnce(&'a [u8]) -> Cow<'a, str>,
+    {
+        if self.mode == Mode::Off || raw.len() > MAX_KEY_BYTES {
+            return decode(raw);
+        }
+        if self.mode == Mode::Sampling {
+            self.seen += 1;
+            if self.seen > SAMPLE_VALUES {
+                self.mode = if self.values.len() > SAMPLE_MAX_DISTINCT {
+                    Mode::Off
+                } else {
+                    Mode::On
+                };
+                if self.mode == Mode::Off {
+                    self.index = HashMap::new();
+                    self.values = Vec::new();
+                    return decode(raw);
+                }
+            }
+        }
+        if let Some(&i) = self.index.get(raw) {
+            return Cow::Borrowed(&self.values[i as usize]);
+        }
+        let decoded = decode(raw);
+        if self.values.len() >= MAX_ENTRIES {
+            return decoded;
+        }
+        self.index.insert(raw.into(), self.values.len() as u32);
+        self.values.push(decoded.into_owned().into_boxed_str());
+        Cow::Borrowed(self.values.last().unwrap())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_repeats_are_decoded_once() {
+        let mut interner = StringInterner::new();
+        let mut calls = 0;
+        for i in 0..10_000 {
+            let raw: &[u8] = if i % 2 == 0 { b"yes" } else { b"no" };
+            let s = interner.decode(raw, |b| {
+                calls += 1;
+                String::from_utf8_lossy(b)
+            });
+            assert_eq!(s.as_bytes(), raw);
+        }
+        assert_eq!(calls, 2);
+    }
+
+    #[test]
+    fn test_distinct_sample_turns_cache_off() {
+        let mut interner = StringInterner::new();
+        let values: Vec<String> = (0..2 * SAMPLE_VALUES).map(|i| i.to_string()).collect();
+        for v in &values {
+            let s = interner.decode(v.as_bytes(), String::from_utf8_lossy);
+            assert_eq!(s, v.as_str());
+        }
+        assert!(interner.mode == Mode::Off);
+        assert!(interner.values.is_empty());
+    }
+}
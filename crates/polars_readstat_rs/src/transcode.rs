@@ -0,0 +1,258 @@
+//! Streaming conversion of readstat files to Parquet and Arrow IPC.
+//!
+//! [`readstat_sink_parquet`] and [`readstat_sink_ipc`] pull decoded batches from
+//! [`readstat_batch_iter`](crate::readstat_batch_iter) and hand each one to a
+//! batched writer as soon as it is decoded, so a file of any size converts with
+//! a few batches in memory. Decoding runs on its own thread, one batch ahead of
+//! the writer, and the Parquet writer encodes the columns of each row group in
+//! parallel on the Polars pool. Batches are `row_group_size` rows (default
+//! `ScanOptions::chunk_size`, then [`DEFAULT_ROW_GROUP_ROWS`]), so every batch
+//! becomes one row group; with `ScanOptions::memory_budget` set, batches and
+//! therefore row groups may be smaller.
+
+use crate::{ReadStatFormat, ScanOptions};
+use polars::prelude::*;
+use serde_json::{Map, Value};
+use std::fs::File;
+use std::io::BufWriter;
+use std::path::Path;
+use std::sync::mpsc;
+
+/// Rows per row group (and batch) when neither the sink nor the scan options set one.
+pub const DEFAULT_ROW_GROUP_ROWS: usize = 100_000;
+
+/// Parquet key holding `{column: variable label}` as JSON.
+pub const VARIABLE_LABELS_KEY: &str = "readstat:variable_labels";
+/// Parquet key holding `{column: {value: label}}` as JSON.
+pub const VALUE_LABELS_KEY: &str = "readstat:value_labels";
+
+/// Output options of [`readstat_sink_parquet`] and [`readstat_sink_ipc`].
+#[derive(Debug, Clone, Default)]
+pub struct TranscodeOptions {
+    /// Rows per row group (Parquet) or record batch (IPC).
+    pub row_group_size: Option<usize>,
+    /// Parquet compression (default: the Polars default, zstd).
+    pub compression: Option<ParquetCompression>,
+    /// Store the file's variable labels and value labels in the Parquet key-value
+    /// metadata under [`VARIABLE_LABELS_KEY`] and [`VALUE_LABELS_KEY`]. Ignored for
+    /// IPC.
+    pub carry_labels: bool,
+}
+
+/// Convert `path` to a Parquet file at `output`; returns the number of rows written.
+///
+/// Reads with `opts` like [`readstat_batch_iter`](crate::readstat_batch_iter).
+/// `compress_opts` is not supported, as it picks column types per batch and every
+/// row group must share the file's schema.
+pub fn readstat_sink_parquet(
+    path: impl AsRef<Path>,
+    output: impl AsRef<Path>,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    sink: TranscodeOptions,
+) -> PolarsResult<u64> {
+    let path = path.as_ref();
+    let format = resolve_format(path, format)?;
+    check_opts(opts.as_ref())?;
+    let rows = row_group_rows(opts.as_ref(), &sink);
+    let metadata = if sink.carry_labels {
+        Some(KeyValueMetadata::from_static(label_metadata(path, format)?))
+    } else {
+        None
+    };
+    let file = BufWriter::new(File::create(output.as_ref())?);
+    let writer = ParquetWriter::new(file)
+        .with_row_group_size(Some(rows))
+        .with_key_value_metadata(metadata)
+        .set_parallel(true);
+    let writer = match sink.compression {
+        Some(compression) => writer.with_compression(compression),
+        None => writer,
+    };
+    transcode(
+        path,
+        opts,
+        format,
+        columns,
+        n_rows,
+        rows,
+        |schema| writer.batched(schema),
+        |w, df| w.write_batch(df),
+        |mut w| w.finish().map(|_| ()),
+    )
+}
+
+/// Convert `path` to an Arrow IPC file at `output`; returns the number of rows
+/// written. Options as for [`readstat_sink_parquet`].
+pub fn readstat_sink_ipc(
+    path: impl AsRef<Path>,
+    output: impl AsRef<Path>,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    sink: TranscodeOptions,
+) -> PolarsResult<u64> {
+    let path = path.as_ref();
+    let format = resolve_format(path, format)?;
+    check_opts(opts.as_ref())?;
+    let rows = row_group_rows(opts.as_ref(), &sink);
+    let file = BufWriter::new(File::create(output.as_ref())?);
+    let writer = IpcWriter::new(file);
+    transcode(
+        path,
+        opts,
+        format,
+        columns,
+        n_rows,
+        rows,
+        |schema| writer.batched(schema),
+        |w, df| w.write_batch(df),
+        |mut w| w.finish(),
+    )
+}
+
+fn resolve_format(path: &Path, format: Option<ReadStatFormat>) -> PolarsResult<ReadStatFormat> {
+    format
+        .or_else(|| crate::detect_format(path))
+        .ok_or_else(|| PolarsError::ComputeError("unknown file extension".into()))
+}
+
+fn check_opts(opts: Option<&ScanOptions>) -> PolarsResult<()> {
+    if opts.is_some_and(|o| o.compress_opts.enabled) {
+        polars_bail!(
+            ComputeError: "compress is not supported when sinking: it picks column types per batch"
+        );
+    }
+    Ok(())
+}
+
+fn row_group_rows(opts: Option<&ScanOptions>, sink: &TranscodeOptions) -> usize {
+    sink.row_group_size
+        .or(opts.and_then(|o| o.chunk_size))
+        .unwrap_or(DEFAULT_ROW_GROUP_ROWS)
+        .max(1)
+}
+
+/// Stream the batches of `path` into a writer opened on the schema of the first
+/// batch (or of the scan, when there are no rows).
+#[allow(clippy::too_many_arguments)]
+fn transcode<W>(
+    path: &Path,
+    opts: Option<ScanOptions>,
+    format: ReadStatFormat,
+    columns: Option<Vec<String>>,
+    n_rows: Option<usize>,
+    batch_rows: usize,
+    open: impl FnOnce(&Schema) -> PolarsResult<W>,
+    mut write: impl FnMut(&mut W, &DataFrame) -> PolarsResult<()>,
+    finish: impl FnOnce(W) -> PolarsResult<()>,
+) -> PolarsResult<u64> {
+    let opts = opts.unwrap_or_default();
+    let iter = crate::readstat_batch_iter(
+        path,
+        Some(opts.clone()),
+        Some(format),
+        columns.clone(),
+        n_rows,
+        Some(batch_rows),
+    )?;
+
+    std::thread::scope(|s| {
+        // One decoded batch waits while the previous one is encoded.
+        let (tx, rx) = mpsc::sync_channel::<PolarsResult<DataFrame>>(1);
+        s.spawn(move || {
+            for batch in iter {
+                let is_err = batch.is_err();
+                if tx.send(batch).is_err() || is_err {
+                    break;
+                }
+            }
+        });
+
+        let mut rx = rx.into_iter();
+        let first = rx.next().transpose()?;
+        let schema = match &first {
+            Some(df) => df.schema().as_ref().clone(),
+            None => scan_schema(path, opts, format, columns)?,
+        };
+        let mut writer = open(&schema)?;
+        let mut rows = 0u64;
+        for batch in first.into_iter().map(Ok).chain(rx) {
+            let df = batch?;
+            if df.schema().as_ref() != &schema {
+                polars_bail!(
+                    SchemaMismatch: "batch schema {:?} differs from the first batch {:?}",
+                    df.schema(), schema
+                );
+            }
+            write(&mut writer, &df)?;
+            rows += df.height() as u64;
+        }
+        finish(writer)?;
+        Ok(rows)
+    })
+}
+
+/// Output schema of a read with no rows, projected like the batches would be.
+fn scan_schema(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+    columns: Option<Vec<String>>,
+) -> PolarsResult<Schema> {
+    let row_index = opts.row_index_name.clone();
+    let mut lf = crate::readstat_scan(path, Some(opts), Some(format))?;
+    if let Some(cols) = columns.filter(|c| !c.is_empty()) {
+        let mut names: Vec<String> = row_index
+            .into_iter()
+            .filter(|r| !cols.contains(r))
+            .collect();
+        names.extend(cols);
+        lf = lf.select(names.iter().map(|c| col(c.as_str())).collect::<Vec<_>>());
+    }
+    Ok(lf.collect_schema()?.as_ref().clone())
+}
+
+/// Variable and value labels from the file's metadata, as Parquet key-value pairs.
+fn label_metadata(path: &Path, format: ReadStatFormat) -> PolarsResult<Vec<(String, String)>> {
+    let json = crate::readstat_metadata_json(path, Some(format))
+        .map_err(|e| PolarsError::ComputeError(e.into()))?;
+    let meta: Value =
+        serde_json::from_str(&json).map_err(|e| PolarsError::ComputeError(e.to_string().into()))?;
+    // sas7bdat metadata lists its variables under "columns".
+    let variables = meta
+        .get("variables")
+        .or_else(|| meta.get("columns"))
+        .and_then(Value::as_array)
+        .map(Vec::as_slice)
+        .unwrap_or_default();
+
+    let mut variable_labels = Map::new();
+    let mut value_labels = Map::new();
+    for var in variables {
+        let Some(name) = var.get("name").and_then(Value::as_str) else {
+            continue;
+        };
+        if let Some(label) = var.get("label").and_then(Value::as_str) {
+            if !label.is_empty() {
+                variable_labels.insert(name.to_string(), label.into());
+            }
+        }
+        if let Some(labels) = var.get("value_labels").filter(|v| !v.is_null()) {
+            value_labels.insert(name.to_string(), labels.clone());
+        }
+    }
+    Ok(vec![
+        (
+            VARIABLE_LABELS_KEY.to_string(),
+            Value::Object(variable_labels).to_string(),
+        ),
+        (
+            VALUE_LABELS_KEY.to_string(),
+            Value::Object(value_labels).to_string(),
+        ),
+    ])
+}
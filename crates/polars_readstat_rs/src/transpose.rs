@@ -0,0 +1,105 @@
+//! Cache-blocked row-to-column transposition shared by the SAS, Stata and SPSS
+//! readers.
+//!
+//! All three formats store fixed-width records row-major. Decoding a wide block a
+//! column at a time therefore strides across the whole block once per column, and
+//! once the block is larger than the cache every column pass reloads it from
+//! memory. The readers instead cut a block into tiles of rows that fit in cache,
+//! copy each field of a tile into its own contiguous strip, and run the typed
+//! per-column conversion over the strips. Each row is pulled into cache once, and
+//! each conversion loop reads a dense array.
+
+/// Target bytes of row data per tile.
+const TILE_BYTES: usize = 64 * 1024;
+
+/// Rows per tile for records of `row_length` bytes.
+pub(crate) fn tile_rows(row_length: usize) -> usize {
+    (TILE_BYTES / row_length.max(1)).max(1)
+}
+
+/// One field of a fixed-width record.
+#[derive(Debug, Clone, Copy)]
+pub(crate) struct FieldSpan {
+    pub start: usize,
+    pub width: usize,
+}
+
+/// Per-field byte strips for one tile of rows. Buffers are reused between tiles.
+#[derive(Default)]
+pub(crate) struct ColumnStrips {
+    strips: Vec<Vec<u8>>,
+}
+
+impl ColumnStrips {
+    /// Copy every field of every `row_length`-byte row in `rows` into its strip, so
+    /// that strip `i` holds field `i` of each row back to back (`fields[i].width`
+    /// bytes per row). Fields that do not fit in the record get an empty strip.
+    pub(crate) fn fill(&mut self, rows: &[u8], row_length: usize, fields: &[FieldSpan]) {
+        self.strips.resize_with(fields.len(), Vec::new);
+        let n_rows = if row_length == 0 {
+            0
+        } else {
+            rows.len() / row_length
+        };
+        for (strip, field) in self.strips.iter_mut().zip(fields) {
+            strip.clear();
+            if field.width > 0 && field.start + field.width <= row_length {
+                strip.reserve(n_rows * field.width);
+            }
+        }
+        if n_rows == 0 {
+            return;
+        }
+        let rows = &rows[..n_rows * row_length];
+        for (strip, field) in self.strips.iter_mut().zip(fields) {
+            let (start, end) = (field.start, field.start + field.width);
+            if field.width == 0 || end > row_length {
+                continue;
+            }
+            match field.width {
+                8 => {
+                    for row in rows.chunks_exact(row_length) {
+                        let cell: &[u8; 8] = row[start..end].try_into().unwrap();
+                        strip.extend_from_slice(cell);
+                    }
+                }
+                _ => {
+                    for row in rows.chunks_exact(row_length) {
+                        strip.extend_from_slice(&row[start..end]);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Field `i` of every row in the last tile.
+    pub(crate) fn strip(&self, i: usize) -> &[u8] {
+        &self.strips[i]
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_fill_transposes_fields() {
+        // Three 6-byte rows: fields at [0..2], [2..3] and [3..6].
+        let rows = b"aaBcccddEfffggHiii";
+        let fields = [
+            FieldSpan { start: 0, width: 2 },
+            FieldSpan { start: 2, width: 1 },
+            FieldSpan { start: 3, width: 3 },
+            FieldSpan { start: 5, width: 4 },
+        ];
+        let mut strips = ColumnStrips::default();
+        strips.fill(rows, 6, &fields);
+        assert_eq!(strips.strip(0), b"aaddgg");
+        assert_eq!(strips.strip(1), b"BEH");
+        assert_eq!(strips.strip(2), b"cccfffiii");
+        assert!(strips.strip(3).is_empty());
+
+        strips.fill(&rows[..6], 6, &fields);
+        assert_eq!(strips.strip(0), b"aa");
+    }
+}
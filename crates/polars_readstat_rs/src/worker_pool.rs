@@ -0,0 +1,346 @@
+//! Process-wide worker pool that every parallel reader schedules onto.
+//!
+//! Scans used to build a rayon pool (or spawn raw threads) of their own, so many
+//! concurrent small reads paid pool startup each time and together ran far more
+//! threads than cores. Readers now split their work into tasks and submit them to
+//! one shared pool through [`ScanTasks`], which keeps at most a per-scan number of
+//! tasks queued or running ahead of the consumer. Tasks never block on the
+//! consumer: they return their batches, so a paused scan holds no pool thread and
+//! cannot starve the scans running next to it.
+//!
+//! The pool is created on first use with [`POOL_THREADS_ENV`] threads (all
+//! logical cores by default). [`set_worker_threads`] resizes it and
+//! [`set_worker_pool`] hands in a pool owned by the caller; scans already running
+//! finish on the pool they started with. Blocking range reads go to a separate
+//! small I/O pool ([`spawn_io`]).
+
+use crate::read_profile::{self, ProfileStage, ReadProfiler};
+use polars::prelude::*;
+use rayon::{ThreadPool, ThreadPoolBuildError, ThreadPoolBuilder};
+use std::cell::Cell;
+use std::collections::{BTreeMap, VecDeque};
+use std::panic::{catch_unwind, AssertUnwindSafe};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, Receiver, Sender};
+use std::sync::{Arc, OnceLock, RwLock};
+
+/// Environment variable read once for the size of the lazily created pool.
+pub const POOL_THREADS_ENV: &str = "POLARS_READSTAT_MAX_THREADS";
+
+static POOL: RwLock<Option<Arc<ThreadPool>>> = RwLock::new(None);
+
+fn build_pool(n_threads: usize) -> Result<ThreadPool, ThreadPoolBuildError> {
+    ThreadPoolBuilder::new()
+        .num_threads(n_threads.max(1))
+        .thread_name(|i| format!("polars-readstat-{i}"))
+        .build()
+}
+
+fn default_pool_threads() -> usize {
+    std::env::var(POOL_THREADS_ENV)
+        .ok()
+        .and_then(|v| v.trim().parse::<usize>().ok())
+        .filter(|&n| n > 0)
+        .unwrap_or_else(|| {
+            std::thread::available_parallelism()
+                .map(|n| n.get())
+                .unwrap_or(1)
+        })
+}
+
+/// The shared pool, created on first use.
+pub(crate) fn pool() -> Arc<ThreadPool> {
+    if let Some(pool) = POOL.read().unwrap_or_else(|e| e.into_inner()).as_ref() {
+        return pool.clone();
+    }
+    let mut slot = POOL.write().unwrap_or_else(|e| e.into_inner());
+    slot.get_or_insert_with(|| {
+        let pool = build_pool(default_pool_threads())
+            .or_else(|_| build_pool(1))
+            .expect("failed to build the polars_readstat worker pool");
+        Arc::new(pool)
+    })
+    .clone()
+}
+
+/// Replace the shared pool with one of `n_threads` threads.
+pub fn set_worker_threads(n_threads: usize) -> Result<(), ThreadPoolBuildError> {
+    set_worker_pool(Arc::new(build_pool(n_threads)?));
+    Ok(())
+}
+
+/// Schedule all reader work onto `pool`, e.g. the pool an application already
+/// runs its own rayon work on.
+pub fn set_worker_pool(pool: Arc<ThreadPool>) {
+    *POOL.write().unwrap_or_else(|e| e.into_inner()) = Some(pool);
+}
+
+/// Threads in the shared pool.
+pub fn worker_threads() -> usize {
+    pool().current_num_threads()
+}
+
+/// Tasks one scan may keep in flight: what it asked for, but never more than the
+/// pool has threads, so a wide scan cannot queue ahead of everything else.
+pub(crate) fn scan_limit(requested: usize) -> usize {
+    requested.min(worker_threads()).max(1)
+}
+
+/// Run `f` on the shared pool, so rayon work inside it is scheduled there too.
+pub(crate) fn install<R: Send>(f: impl FnOnce() -> R + Send) -> R {
+    pool().install(f)
+}
+
+/// Threads for blocking range reads, kept apart from the decode pool so storage
+/// latency never holds a decode thread.
+const IO_THREADS: usize = 16;
+
+/// Run the blocking read `f` on the shared I/O pool.
+pub(crate) fn spawn_io(f: impl FnOnce() + Send + 'static) {
+    static IO_POOL: OnceLock<Option<ThreadPool>> = OnceLock::new();
+    let pool = IO_POOL.get_or_init(|| {
+        ThreadPoolBuilder::new()
+            .num_threads(IO_THREADS)
+            .thread_name(|i| format!("polars-readstat-io-{i}"))
+            .build()
+            .ok()
+    });
+    match pool {
+        Some(pool) => pool.spawn(f),
+        None => {
+            std::thread::spawn(f);
+        }
+    }
+}
+
+thread_local! {
+    static THREAD_LIMIT: Cell<Option<usize>> = const { Cell::new(None) };
+}
+
+/// Run `f` with [`thread_limit`] returning `limit` on this thread, for a serial
+/// reader that fans individual steps out to the pool (zsav block inflate).
+pub(crate) fn with_thread_limit<R>(limit: usize, f: impl FnOnce() -> R) -> R {
+    let previous = THREAD_LIMIT.with(|l| l.replace(Some(limit)));
+    let out = f();
+    THREAD_LIMIT.with(|l| l.set(previous));
+    out
+}
+
+/// Pool threads the reader on this thread may use at once.
+pub(crate) fn thread_limit() -> usize {
+    scan_limit(THREAD_LIMIT.with(Cell::get).unwrap_or(usize::MAX))
+}
+
+type TaskResult<T> = Option<PolarsResult<Vec<T>>>;
+type TaskFn<T> = dyn Fn(usize) -> PolarsResult<Vec<T>> + Send + Sync;
+
+/// Batches of a scan produced by `n_tasks` independent tasks on the shared pool.
+///
+/// Task `i` returns the batches (or other per-part output) for its part of the
+/// file. At most `limit` tasks
+/// are queued, running or waiting to be consumed at any time; the next one is
+/// submitted as the consumer takes a task's output, which is the scan's
+/// backpressure. With `preserve_order` the batches come out in task order,
+/// otherwise in completion order.
+pub(crate) struct ScanTasks<T = DataFrame> {
+    pool: Arc<ThreadPool>,
+    task: Arc<TaskFn<T>>,
+    n_tasks: usize,
+    limit: usize,
+    preserve_order: bool,
+    next_task: usize,
+    taken: usize,
+    in_flight: usize,
+    tx: Sender<(usize, TaskResult<T>)>,
+    rx: Receiver<(usize, TaskResult<T>)>,
+    done: BTreeMap<usize, PolarsResult<Vec<T>>>,
+    current: VecDeque<T>,
+    cancelled: Arc<AtomicBool>,
+    /// Profiler of the thread that started the scan; tasks run under it.
+    profiler: Option<ReadProfiler>,
+}
+
+impl<T: Send + 'static> ScanTasks<T> {
+    pub(crate) fn new<F>(n_tasks: usize, limit: usize, preserve_order: bool, task: F) -> Self
+    where
+        F: Fn(usize) -> PolarsResult<Vec<T>> + Send + Sync + 'static,
+    {
+        let (tx, rx) = mpsc::channel();
+        let mut tasks = Self {
+            pool: pool(),
+            task: Arc::new(task),
+            n_tasks,
+            limit: limit.max(1),
+            preserve_order,
+            next_task: 0,
+            taken: 0,
+            in_flight: 0,
+            tx,
+            rx,
+            done: BTreeMap::new(),
+            current: VecDeque::new(),
+            cancelled: Arc::new(AtomicBool::new(false)),
+            profiler: read_profile::current(),
+        };
+        tasks.submit();
+        tasks
+    }
+
+    fn submit(&mut self) {
+        while self.next_task < self.n_tasks && self.next_task - self.taken < self.limit {
+            let idx = self.next_task;
+            let task = self.task.clone();
+            let tx = self.tx.clone();
+            let cancelled = self.cancelled.clone();
+            let profiler = self.profiler.clone();
+            self.pool.spawn(move || {
+                let result = if cancelled.load(Ordering::Relaxed) {
+                    None
+                } else {
+                    let _profile = read_profile::enter(profiler.as_ref());
+                    Some(
+                        catch_unwind(AssertUnwindSafe(|| task(idx))).unwrap_or_else(|_| {
+                            Err(PolarsError::ComputeError("scan worker panicked".into()))
+                        }),
+                    )
+                };
+                let _ = tx.send((idx, result));
+            });
+            self.next_task += 1;
+            self.in_flight += 1;
+        }
+    }
+}
+
+impl<T> ScanTasks<T> {
+    /// The next finished task. A consumer running on a thread of the pool itself
+    /// (a caller-provided pool doing its own work) runs queued tasks while it
+    /// waits instead of blocking the thread they need.
+    fn recv(&self) -> Option<(usize, TaskResult<T>)> {
+        let _wait = read_profile::span(ProfileStage::ChannelWait);
+        if self.pool.current_thread_index().is_none() {
+            return self.rx.recv().ok();
+        }
+        loop {
+            match self.rx.try_recv() {
+                Ok(msg) => return Some(msg),
+                Err(mpsc::TryRecvError::Disconnected) => return None,
+                Err(mpsc::TryRecvError::Empty) => {
+                    if rayon::yield_now() != Some(rayon::Yield::Executed) {
+                        std::thread::yield_now();
+                    }
+                }
+            }
+        }
+    }
+
+    fn take_ready(&mut self) -> Option<PolarsResult<Vec<T>>> {
+        if self.preserve_order {
+            self.done.remove(&self.taken)
+        } else {
+            self.done.pop_first().map(|(_, result)| result)
+        }
+    }
+}
+
+impl<T: Send + 'static> Iterator for ScanTasks<T> {
+    type Item = PolarsResult<T>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        loop {
+            if let Some(item) = self.current.pop_front() {
+                return Some(Ok(item));
+            }
+            if let Some(result) = self.take_ready() {
+                self.taken += 1;
+                self.submit();
+                match result {
+                    Ok(items) => self.current = items.into(),
+                    Err(e) => return Some(Err(e)),
+                }
+                continue;
+            }
+            if self.in_flight == 0 {
+                return None;
+            }
+            let (idx, result) = self.recv()?;
+            self.in_flight -= 1;
+            if let Some(result) = result {
+                self.done.insert(idx, result);
+            }
+        }
+    }
+}
+
+impl<T> Drop for ScanTasks<T> {
+    fn drop(&mut self) {
+        // Queued tasks skip their work; wait for running ones so no file handle
+        // outlives the scan.
+        self.cancelled.store(true, Ordering::Relaxed);
+        while self.in_flight > 0 && self.recv().is_some() {
+            self.in_flight -= 1;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::AtomicUsize;
+
+    fn task_frame(idx: usize) -> PolarsResult<Vec<DataFrame>> {
+        let a = df!("i" => [idx as i64 * 2])?;
+        let b = df!("i" => [idx as i64 * 2 + 1])?;
+        Ok(vec![a, b])
+    }
+
+    fn values(tasks: ScanTasks) -> Vec<i64> {
+        tasks
+            .map(|df| {
+                df.unwrap()
+                    .column("i")
+                    .unwrap()
+                    .i64()
+                    .unwrap()
+                    .get(0)
+                    .unwrap()
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_scan_tasks_order_and_limit() {
+        let ordered = ScanTasks::new(20, 3, true, task_frame);
+        assert_eq!(values(ordered), (0..40).collect::<Vec<_>>());
+
+        let mut unordered = values(ScanTasks::new(20, 3, false, task_frame));
+        unordered.sort_unstable();
+        assert_eq!(unordered, (0..40).collect::<Vec<_>>());
+
+        // Nothing past the window is started until the consumer takes output.
+        let started = Arc::new(AtomicUsize::new(0));
+        let counter = started.clone();
+        let mut tasks = ScanTasks::new(10, 2, true, move |idx| {
+            counter.fetch_add(1, Ordering::SeqCst);
+            task_frame(idx)
+        });
+        tasks.next().unwrap().unwrap();
+        assert!(started.load(Ordering::SeqCst) <= 3);
+        drop(tasks);
+        assert!(started.load(Ordering::SeqCst) <= 3);
+    }
+
+    #[test]
+    fn test_scan_tasks_surface_errors_and_panics() {
+        let mut tasks = ScanTasks::new(3, 2, true, |idx| match idx {
+            1 => Err(PolarsError::ComputeError("bad block".into())),
+            2 => panic!("boom"),
+            _ => task_frame(idx),
+        });
+        assert!(tasks.next().unwrap().is_ok());
+        assert!(tasks.next().unwrap().is_ok());
+        assert!(tasks.next().unwrap().is_err());
+        assert!(tasks.next().unwrap().is_err());
+        assert!(tasks.next().is_none());
+    }
+}
@@ -0,0 +1,752 @@
+//! Zone maps: per-chunk column statistics for skipping rows on repeated
+//! selective scans.
+//!
+//! A [`ZoneMap`] splits a file into zones of consecutive rows and records, for
+//! every plain numeric and string column, the zone's min, max and null count. It
+//! is built with one streaming read and saved as a small `<file>.zmap` sidecar.
+//! Once a sidecar that matches the file and the read options exists,
+//! [`readstat_scan`](crate::readstat_scan) checks each zone against the pushable
+//! part of the predicate ([`RowFilter`]) and reads only the row ranges that can
+//! match. Statistics are taken on the decoded output (value labels applied,
+//! missing values nulled), so they are compared against the same values the
+//! predicate sees. Float zones also record whether they hold NaN, which Polars
+//! compares as greater than every number, so such a zone is kept for `>`, `>=`
+//! and `!=` whatever its min and max. Columns whose output type differs from the
+//! one recorded (temporal, Enum, struct, or compressed to another type) never
+//! cause a skip.
+
+use crate::row_filter::{FilterOp, FilterTest};
+use crate::{ReadStatFormat, RowFilter, ScanOptions};
+use polars::prelude::*;
+use std::fs::File;
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+const MAGIC: &[u8; 8] = b"PRSZMAP1";
+/// Rows per zone when the caller does not choose.
+pub const DEFAULT_ZONE_ROWS: usize = 65_536;
+/// String bounds longer than this are not recorded; such zones are always read.
+const MAX_STR_BOUND: usize = 256;
+
+/// Which statistics a column carries.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum StatKind {
+    /// Integer or Float64 output, compared as f64.
+    Num,
+    /// Float32 output; only literals exact in f32 are compared.
+    Num32,
+    Str,
+    /// No statistics (temporal, Enum, ...).
+    None,
+}
+
+impl StatKind {
+    fn of(dtype: &DataType) -> Self {
+        match dtype {
+            DataType::Float32 => StatKind::Num32,
+            DataType::String => StatKind::Str,
+            dt if dt.is_primitive_numeric() => StatKind::Num,
+            _ => StatKind::None,
+        }
+    }
+
+    fn tag(self) -> u8 {
+        match self {
+            StatKind::Num => 1,
+            StatKind::Num32 => 2,
+            StatKind::Str => 3,
+            StatKind::None => 0,
+        }
+    }
+
+    fn from_tag(tag: u8) -> PolarsResult<Self> {
+        Ok(match tag {
+            0 => StatKind::None,
+            1 => StatKind::Num,
+            2 => StatKind::Num32,
+            3 => StatKind::Str,
+            other => polars_bail!(ComputeError: "invalid column kind {other} in zone map"),
+        })
+    }
+}
+
+#[derive(Debug, Clone, PartialEq)]
+enum Bounds {
+    /// Not recorded; the zone cannot be ruled out on this column.
+    Unknown,
+    /// No non-null values (for floats: none that are not NaN).
+    Empty,
+    Num(f64, f64),
+    Str(String, String),
+}
+
+#[derive(Debug, Clone, PartialEq)]
+struct ColumnStats {
+    null_count: u64,
+    has_nan: bool,
+    bounds: Bounds,
+}
+
+#[derive(Debug, Clone, PartialEq)]
+struct Zone {
+    first_row: u64,
+    rows: u64,
+    columns: Vec<ColumnStats>,
+}
+
+/// Per-zone min/max/null-count statistics for one file.
+#[derive(Debug, Clone)]
+pub struct ZoneMap {
+    file_len: u64,
+    modified_ns: u64,
+    missing_string_as_null: bool,
+    value_labels_as_strings: bool,
+    row_count: u64,
+    columns: Vec<(String, StatKind)>,
+    zones: Vec<Zone>,
+}
+
+impl ZoneMap {
+    /// Read `path` once in zones of `zone_rows` rows (default
+    /// [`DEFAULT_ZONE_ROWS`]) and collect the statistics of every zone.
+    ///
+    /// `opts` should match the options later scans use; the statistics are only
+    /// used by scans with the same `missing_string_as_null` and
+    /// `value_labels_as_strings`.
+    pub fn build(
+        path: impl AsRef<Path>,
+        opts: Option<ScanOptions>,
+        format: Option<ReadStatFormat>,
+        zone_rows: Option<usize>,
+    ) -> PolarsResult<Self> {
+        let path = path.as_ref();
+        let opts = opts.unwrap_or_default();
+        let (file_len, modified_ns) = file_stamp(path)?;
+        let read_opts = ScanOptions {
+            preserve_order: Some(true),
+            row_index_name: None,
+            informative_nulls: None,
+            compress_opts: crate::CompressOptionsLite::default(),
+            row_filter: None,
+            ..opts.clone()
+        };
+        let zone_rows = zone_rows.unwrap_or(DEFAULT_ZONE_ROWS).max(1);
+        let iter =
+            crate::readstat_batch_iter(path, Some(read_opts), format, None, None, Some(zone_rows))?;
+
+        let mut columns: Option<Vec<(String, StatKind)>> = None;
+        let mut zones = Vec::new();
+        let mut next_row = 0u64;
+        for batch in iter {
+            let df = batch?;
+            if df.height() == 0 {
+                continue;
+            }
+            let columns = columns.get_or_insert_with(|| {
+                df.get_columns()
+                    .iter()
+                    .map(|c| (c.name().to_string(), StatKind::of(c.dtype())))
+                    .collect()
+            });
+            let stats = columns
+                .iter()
+                .zip(df.get_columns())
+                .map(|((_, kind), col)| column_stats(col.as_materialized_series(), *kind))
+                .collect::<PolarsResult<Vec<_>>>()?;
+            zones.push(Zone {
+                first_row: next_row,
+                rows: df.height() as u64,
+                columns: stats,
+            });
+            next_row += df.height() as u64;
+        }
+
+        Ok(Self {
+            file_len,
+            modified_ns,
+            missing_string_as_null: opts.missing_string_as_null.unwrap_or(true),
+            value_labels_as_strings: opts.value_labels_as_strings.unwrap_or(true),
+            row_count: next_row,
+            columns: columns.unwrap_or_default(),
+            zones,
+        })
+    }
+
+    /// Default sidecar location: `<file>.zmap` next to the data file.
+    pub fn sidecar_path(path: &Path) -> PathBuf {
+        let mut name = path.as_os_str().to_os_string();
+        name.push(".zmap");
+        PathBuf::from(name)
+    }
+
+    /// Number of zones.
+    pub fn zone_count(&self) -> usize {
+        self.zones.len()
+    }
+
+    /// Total rows covered by the map.
+    pub fn row_count(&self) -> u64 {
+        self.row_count
+    }
+
+    /// True if this map was built from the file at `path` as it is now, with
+    /// options that decode values the same way as `opts`.
+    pub fn matches(&self, path: &Path, opts: &ScanOptions) -> bool {
+        match file_stamp(path) {
+            Ok((file_len, modified_ns)) => {
+                file_len == self.file_len
+                    && modified_ns == self.modified_ns
+                    && opts.missing_string_as_null.unwrap_or(true) == self.missing_string_as_null
+                    && opts.value_labels_as_strings.unwrap_or(true) == self.value_labels_as_strings
+            }
+            Err(_) => false,
+        }
+    }
+
+    /// `(offset, len)` row ranges that may hold rows passing `filter`, with
+    /// adjacent zones merged. Every row passing `filter` is inside a range.
+    pub fn candidate_ranges(&self, filter: &RowFilter) -> Vec<(usize, usize)> {
+        self.ranges_for(filter, None)
+    }
+
+    /// `candidate_ranges` restricted to terms on columns whose type in `schema`
+    /// still matches the recorded statistics.
+    fn ranges_for(&self, filter: &RowFilter, schema: Option<&Schema>) -> Vec<(usize, usize)> {
+        let terms: Vec<(usize, FilterTest)> = filter
+            .terms()
+            .into_iter()
+            .filter_map(|(name, test)| {
+                let idx = self.columns.iter().position(|(n, _)| n == name)?;
+                let kind = self.columns[idx].1;
+                if let Some(schema) = schema {
+                    if StatKind::of(schema.get(name)?) != kind {
+                        return None;
+                    }
+                }
+                let usable = match kind {
+                    StatKind::Num => test.is_numeric(),
+                    StatKind::Num32 => test.f32_exact(),
+                    StatKind::Str => !test.is_numeric(),
+                    StatKind::None => false,
+                };
+                usable.then_some((idx, test))
+            })
+            .collect();
+
+        let mut ranges: Vec<(usize, usize)> = Vec::new();
+        for zone in &self.zones {
+            let keep = terms
+                .iter()
+                .all(|(idx, test)| zone_may_match(&zone.columns[*idx], zone.rows, test));
+            if !keep {
+                continue;
+            }
+            let (start, len) = (zone.first_row as usize, zone.rows as usize);
+            match ranges.last_mut() {
+                Some((s, l)) if *s + *l == start => *l += len,
+                _ => ranges.push((start, len)),
+            }
+        }
+        ranges
+    }
+
+    /// Write the map to `path`.
+    pub fn save(&self, path: &Path) -> PolarsResult<()> {
+        let mut out = BufWriter::new(File::create(path)?);
+        out.write_all(MAGIC)?;
+        for v in [
+            self.file_len,
+            self.modified_ns,
+            self.row_count,
+            self.columns.len() as u64,
+            self.zones.len() as u64,
+        ] {
+            out.write_all(&v.to_le_bytes())?;
+        }
+        out.write_all(&[
+            self.missing_string_as_null as u8,
+            self.value_labels_as_strings as u8,
+        ])?;
+        for (name, kind) in &self.columns {
+            write_str(&mut out, name)?;
+            out.write_all(&[kind.tag()])?;
+        }
+        for zone in &self.zones {
+            out.write_all(&zone.first_row.to_le_bytes())?;
+            out.write_all(&zone.rows.to_le_bytes())?;
+            for stats in &zone.columns {
+                out.write_all(&stats.null_count.to_le_bytes())?;
+                let tag = match &stats.bounds {
+                    Bounds::Unknown => 0u8,
+                    Bounds::Empty => 1,
+                    Bounds::Num(..) => 2,
+                    Bounds::Str(..) => 3,
+                };
+                out.write_all(&[tag, stats.has_nan as u8])?;
+                match &stats.bounds {
+                    Bounds::Num(lo, hi) => {
+                        out.write_all(&lo.to_le_bytes())?;
+                        out.write_all(&hi.to_le_bytes())?;
+                    }
+                    Bounds::Str(lo, hi) => {
+                        write_str(&mut out, lo)?;
+                        write_str(&mut out, hi)?;
+                    }
+                    Bounds::Unknown | Bounds::Empty => {}
+                }
+            }
+        }
+        out.flush()?;
+        Ok(())
+    }
+
+    /// Read a map previously written by `save`.
+    pub fn load(path: &Path) -> PolarsResult<Self> {
+        let mut input = BufReader::new(File::open(path)?);
+        let mut magic = [0u8; 8];
+        input.read_exact(&mut magic)?;
+        if &magic != MAGIC {
+            polars_bail!(ComputeError: "{} is not a zone map", path.display());
+        }
+        let file_len = read_u64(&mut input)?;
+        let modified_ns = read_u64(&mut input)?;
+        let row_count = read_u64(&mut input)?;
+        let n_columns = read_u64(&mut input)? as usize;
+        let n_zones = read_u64(&mut input)? as usize;
+        let mut flags = [0u8; 2];
+        input.read_exact(&mut flags)?;
+
+        let mut columns = Vec::with_capacity(n_columns.min(1 << 16));
+        for _ in 0..n_columns {
+            let name = read_str(&mut input)?;
+            let mut tag = [0u8; 1];
+            input.read_exact(&mut tag)?;
+            columns.push((name, StatKind::from_tag(tag[0])?));
+        }
+        let mut zones = Vec::with_capacity(n_zones.min(1 << 20));
+        for _ in 0..n_zones {
+            let first_row = read_u64(&mut input)?;
+            let rows = read_u64(&mut input)?;
+            let mut stats = Vec::with_capacity(n_columns);
+            for _ in 0..n_columns {
+                let null_count = read_u64(&mut input)?;
+                let mut tag = [0u8; 2];
+                input.read_exact(&mut tag)?;
+                let bounds = match tag[0] {
+                    0 => Bounds::Unknown,
+                    1 => Bounds::Empty,
+                    2 => Bounds::Num(
+                        f64::from_bits(read_u64(&mut input)?),
+                        f64::from_bits(read_u64(&mut input)?),
+                    ),
+                    3 => Bounds::Str(read_str(&mut input)?, read_str(&mut input)?),
+                    other => polars_bail!(ComputeError: "invalid bounds tag {other} in zone map"),
+                };
+                stats.push(ColumnStats {
+                    null_count,
+                    has_nan: tag[1] != 0,
+                    bounds,
+                });
+            }
+            zones.push(Zone {
+                first_row,
+                rows,
+                columns: stats,
+            });
+        }
+        Ok(Self {
+            file_len,
+            modified_ns,
+            missing_string_as_null: flags[0] != 0,
+            value_labels_as_strings: flags[1] != 0,
+            row_count,
+            columns,
+            zones,
+        })
+    }
+}
+
+/// Build the zone map of `path` and save it as its sidecar
+/// ([`ZoneMap::sidecar_path`]), where `readstat_scan` picks it up.
+pub fn readstat_build_zone_map(
+    path: impl AsRef<Path>,
+    opts: Option<ScanOptions>,
+    format: Option<ReadStatFormat>,
+    zone_rows: Option<usize>,
+) -> PolarsResult<ZoneMap> {
+    let path = path.as_ref();
+    let zones = ZoneMap::build(path, opts, format, zone_rows)?;
+    zones.save(&ZoneMap::sidecar_path(path))?;
+    Ok(zones)
+}
+
+/// The sidecar map of `path`, if there is one that is valid for `opts`.
+pub(crate) fn load_sidecar(path: &Path, opts: &ScanOptions) -> Option<ZoneMap> {
+    let sidecar = ZoneMap::sidecar_path(path);
+    if !sidecar.exists() {
+        return None;
+    }
+    ZoneMap::load(&sidecar)
+        .ok()
+        .filter(|zones| zones.matches(path, opts))
+}
+
+fn column_stats(s: &Series, kind: StatKind) -> PolarsResult<ColumnStats> {
+    let null_count = s.null_count() as u64;
+    let mut has_nan = false;
+    let bounds = match kind {
+        StatKind::Num | StatKind::Num32 => {
+            let values = s.cast(&DataType::Float64)?;
+            let mut bounds: Option<(f64, f64)> = None;
+            for v in values.f64()?.into_iter().flatten() {
+                if v.is_nan() {
+                    has_nan = true;
+                    continue;
+                }
+                bounds = Some(match bounds {
+                    Some((lo, hi)) => (lo.min(v), hi.max(v)),
+                    None => (v, v),
+                });
+            }
+            bounds.map_or(Bounds::Empty, |(lo, hi)| Bounds::Num(lo, hi))
+        }
+        StatKind::Str => {
+            let mut bounds: Option<(&str, &str)> = None;
+            for v in s.str()?.into_iter().flatten() {
+                bounds = Some(match bounds {
+                    Some((lo, hi)) => (lo.min(v), hi.max(v)),
+                    None => (v, v),
+                });
+            }
+            match bounds {
+                None => Bounds::Empty,
+                Some((lo, hi)) if lo.len() <= MAX_STR_BOUND && hi.len() <= MAX_STR_BOUND => {
+                    Bounds::Str(lo.to_string(), hi.to_string())
+                }
+                Some(_) => Bounds::Unknown,
+            }
+        }
+        StatKind::None => Bounds::Unknown,
+    };
+    Ok(ColumnStats {
+        null_count,
+        has_nan,
+        bounds,
+    })
+}
+
+/// False only when no row of the zone can pass `test`.
+fn zone_may_match(stats: &ColumnStats, rows: u64, test: &FilterTest) -> bool {
+    if stats.null_count >= rows {
+        // Comparisons against null are false.
+        return false;
+    }
+    match (&stats.bounds, test) {
+        (Bounds::Unknown, _) => true,
+        // Filter literals are never NaN (`RowFilter::terms` drops such terms).
+        (Bounds::Empty, FilterTest::Num { op, .. }) => stats.has_nan && op.passes_nan(),
+        (Bounds::Empty, _) => false,
+        (Bounds::Num(lo, hi), FilterTest::Num { op, value }) => {
+            (stats.has_nan && op.passes_nan()) || range_may_match(*op, value, lo, hi)
+        }
+        (Bounds::Num(lo, hi), FilterTest::NumIn(values)) => {
+            values.iter().any(|v| lo <= v && v <= hi)
+        }
+        (Bounds::Str(lo, hi), FilterTest::Str { op, value }) => {
+            range_may_match(*op, value.as_str(), lo.as_str(), hi.as_str())
+        }
+        (Bounds::Str(lo, hi), FilterTest::StrIn(values)) => values
+            .iter()
+            .any(|v| lo.as_str() <= v.as_str() && v.as_str() <= hi.as_str()),
+        _ => true,
+    }
+}
+
+/// Can some value in `[lo, hi]` satisfy `v <op> value`?
+fn range_may_match<T: PartialOrd + ?Sized>(op: FilterOp, value: &T, lo: &T, hi: &T) -> bool {
+    match op {
+        FilterOp::Eq => lo <= value && value <= hi,
+        FilterOp::NotEq => !(lo == value && hi == value),
+        FilterOp::Lt => lo < value,
+        FilterOp::LtEq => lo <= value,
+        FilterOp::Gt => hi > value,
+        FilterOp::GtEq => hi >= value,
+    }
+}
+
+/// Scan that reads only the zones of `zones` that can pass the predicate.
+pub(crate) struct ZoneMapScan {
+    path: PathBuf,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+    zones: ZoneMap,
+    /// The format's own scan, for reads the zones cannot narrow.
+    inner: Arc<dyn AnonymousScan>,
+}
+
+impl ZoneMapScan {
+    pub(crate) fn new(
+        path: PathBuf,
+        opts: ScanOptions,
+        format: ReadStatFormat,
+        zones: ZoneMap,
+    ) -> PolarsResult<Self> {
+        let inner = crate::format_anonymous_scan(&path, opts.clone(), format)?;
+        Ok(Self {
+            path,
+            opts,
+            format,
+            zones,
+            inner,
+        })
+    }
+}
+
+impl AnonymousScan for ZoneMapScan {
+    fn as_any(&self) -> &dyn std::any::Any {
+        self
+    }
+
+    fn scan(&self, args: AnonymousScanArgs) -> PolarsResult<DataFrame> {
+        let predicate = args.predicate.as_ref();
+        // Without a term to test zones against, every zone is read: the format's
+        // own scan does that in one pass.
+        let Some(row_filter) = predicate
+            .and_then(RowFilter::from_expr)
+            .filter(|filter| !filter.terms().is_empty())
+        else {
+            return self.inner.scan(args);
+        };
+        let extra_columns = predicate
+            .map(|p| {
+                crate::row_filter::predicate_extra_columns(p, args.with_columns.as_deref(), |n| {
+                    self.opts.informative_nulls.is_none()
+                        && args.schema.contains(n)
+                        && self.opts.row_index_name.as_deref() != Some(n)
+                })
+            })
+            .unwrap_or_default();
+        let cols = args.with_columns.as_ref().map(|c| {
+            c.iter()
+                .chain(extra_columns.iter())
+                .map(|s| s.to_string())
+                .collect::<Vec<_>>()
+        });
+        let ranges = self
+            .zones
+            .ranges_for(&row_filter, Some(args.schema.as_ref()));
+
+        let read_opts = ScanOptions {
+            row_filter: Some(row_filter),
+            compress_opts: crate::CompressOptionsLite::default(),
+            ..self.opts.clone()
+        };
+        // The residual predicate still runs on the assembled rows, so they are
+        // compressed after it rather than while assembling.
+        let mut out = crate::frame_assembly::FrameAssembler::new(0);
+        let mut read_any = false;
+        for (offset, len) in ranges {
+            let iter = crate::readstat_stream::readstat_batch_iter_range(
+                &self.path,
+                Some(read_opts.clone()),
+                Some(self.format),
+                cols.clone(),
+                offset,
+                Some(len),
+                None,
+            )?;
+            for df in iter {
+                out.push(df?)?;
+                read_any = true;
+            }
+        }
+        let df = if read_any {
+            out.finish()?
+        } else {
+            // Every zone was skipped: an empty frame of the projected columns.
+            let schema: Schema = match &cols {
+                Some(cols) => args
+                    .schema
+                    .iter()
+                    .filter(|(name, _)| cols.iter().any(|c| c == name.as_str()))
+                    .map(|(name, dtype)| (name.clone(), dtype.clone()))
+                    .collect(),
+                None => args.schema.as_ref().clone(),
+            };
+            DataFrame::empty_with_schema(&schema)
+        };
+        let mut df = crate::row_filter::apply_residual_predicate(df, predicate, &extra_columns)?;
+        if let Some(n) = args.n_rows {
+            df = df.head(Some(n));
+        }
+        if self.opts.compress_opts.enabled {
+            crate::compress_df_if_enabled(&df, &self.opts.compress_opts)
+                .map_err(|e| PolarsError::ComputeError(e.into()))
+        } else {
+            Ok(df)
+        }
+    }
+
+    fn schema(&self, n_rows: Option<usize>) -> PolarsResult<SchemaRef> {
+        self.inner.schema(n_rows)
+    }
+
+    fn allows_predicate_pushdown(&self) -> bool {
+        true
+    }
+}
+
+/// Lazy scan of `path` that skips zones using `zones`.
+pub(crate) fn scan_with_zone_map(
+    path: &Path,
+    opts: ScanOptions,
+    format: ReadStatFormat,
+    zones: ZoneMap,
+) -> PolarsResult<LazyFrame> {
+    let scan = ZoneMapScan::new(path.to_path_buf(), opts, format, zones)?;
+    LazyFrame::anonymous_scan(Arc::new(scan), Default::default())
+}
+
+fn file_stamp(path: &Path) -> PolarsResult<(u64, u64)> {
+    let meta = std::fs::metadata(path)?;
+    let modified_ns = meta
+        .modified()
+        .ok()
+        .and_then(|t| t.duration_since(std::time::UNIX_EPOCH).ok())
+        .map(|d| d.as_nanos() as u64)
+        .unwrap_or(0);
+    Ok((meta.len(), modified_ns))
+}
+
+fn write_str<W: Write>(out: &mut W, s: &str) -> PolarsResult<()> {
+    out.write_all(&(s.len() as u32).to_le_bytes())?;
+    out.write_all(s.as_bytes())?;
+    Ok(())
+}
+
+fn read_str<R: Read>(reader: &mut R) -> PolarsResult<String> {
+    let mut len = [0u8; 4];
+    reader.read_exact(&mut len)?;
+    let mut buf = vec![0u8; u32::from_le_bytes(len) as usize];
+    reader.read_exact(&mut buf)?;
+    String::from_utf8(buf).map_err(|e| PolarsError::ComputeError(e.to_string().into()))
+}
+
+fn read_u64<R: Read>(reader: &mut R) -> PolarsResult<u64> {
+    let mut buf = [0u8; 8];
+    reader.read_exact(&mut buf)?;
+    Ok(u64::from_le_bytes(buf))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn stats(null_count: u64, bounds: Bounds) -> ColumnStats {
+        ColumnStats {
+            null_count,
+            has_nan: false,
+            bounds,
+        }
+    }
+
+    #[test]
+    fn test_zone_may_match_numeric() {
+        let s = stats(0, Bounds::Num(10.0, 20.0));
+        let num = |op, value| FilterTest::Num { op, value };
+        assert!(zone_may_match(&s, 5, &num(FilterOp::Eq, 15.0)));
+        assert!(!zone_may_match(&s, 5, &num(FilterOp::Eq, 25.0)));
+        assert!(!zone_may_match(&s, 5, &num(FilterOp::Lt, 10.0)));
+        assert!(zone_may_match(&s, 5, &num(FilterOp::LtEq, 10.0)));
+        assert!(!zone_may_match(&s, 5, &num(FilterOp::Gt, 20.0)));
+        assert!(zone_may_match(&s, 5, &num(FilterOp::NotEq, 15.0)));
+        assert!(!zone_may_match(
+            &stats(0, Bounds::Num(3.0, 3.0)),
+            5,
+            &num(FilterOp::NotEq, 3.0)
+        ));
+        assert!(!zone_may_match(
+            &stats(5, Bounds::Empty),
+            5,
+            &num(FilterOp::NotEq, 3.0)
+        ));
+        assert!(zone_may_match(&s, 5, &FilterTest::NumIn(vec![1.0, 12.0])));
+        assert!(!zone_may_match(&s, 5, &FilterTest::NumIn(vec![1.0, 21.0])));
+    }
+
+    #[test]
+    fn test_zone_may_match_string() {
+        let s = stats(1, Bounds::Str("CA".to_string(), "NY".to_string()));
+        let eq = |v: &str| FilterTest::Str {
+            op: FilterOp::Eq,
+            value: v.to_string(),
+        };
+        assert!(zone_may_match(&s, 5, &eq("MA")));
+        assert!(!zone_may_match(&s, 5, &eq("TX")));
+        assert!(zone_may_match(&stats(0, Bounds::Unknown), 5, &eq("TX")));
+    }
+
+    #[test]
+    fn test_zone_may_match_keeps_nan_rows() {
+        // Whenever a row of the zone passes the comparison as Polars evaluates it,
+        // the zone must be kept.
+        let zones = [
+            vec![Some(2.0), None, Some(f64::NAN), Some(-1.0)],
+            vec![Some(f64::NAN), None, Some(f64::NAN)],
+            vec![Some(2.0), Some(-1.0)],
+        ];
+        let ops = [
+            FilterOp::Eq,
+            FilterOp::NotEq,
+            FilterOp::Lt,
+            FilterOp::LtEq,
+            FilterOp::Gt,
+            FilterOp::GtEq,
+        ];
+        for values in zones {
+            let s = Series::new("x".into(), &values);
+            let stats = column_stats(&s, StatKind::Num).unwrap();
+            let df = DataFrame::new_infer_height(vec![s.into_column()]).unwrap();
+            for value in [-5.0, 0.0, 2.0, 5.0] {
+                for op in ops {
+                    let (x, v) = (col("x"), lit(value));
+                    let expr = match op {
+                        FilterOp::Eq => x.eq(v),
+                        FilterOp::NotEq => x.neq(v),
+                        FilterOp::Lt => x.lt(v),
+                        FilterOp::LtEq => x.lt_eq(v),
+                        FilterOp::Gt => x.gt(v),
+                        FilterOp::GtEq => x.gt_eq(v),
+                    };
+                    let passing = df.clone().lazy().filter(expr).collect().unwrap().height();
+                    let test = FilterTest::Num { op, value };
+                    assert!(
+                        passing == 0 || zone_may_match(&stats, values.len() as u64, &test),
+                        "{values:?} {op:?} {value}"
+                    );
+                }
+            }
+        }
+        let nan_zone = column_stats(
+            &Series::new("x".into(), &[Some(1.0), Some(f64::NAN)]),
+            StatKind::Num,
+        )
+        .unwrap();
+        let gt = FilterTest::Num {
+            op: FilterOp::Gt,
+            value: 5.0,
+        };
+        assert!(zone_may_match(&nan_zone, 2, &gt));
+        assert!(!zone_may_match(&stats(0, Bounds::Num(1.0, 1.0)), 2, &gt));
+    }
+
+    #[test]
+    fn test_column_stats_skip_nan_and_null() {
+        let s = Series::new("x".into(), &[Some(2.0), None, Some(f64::NAN), Some(-1.0)]);
+        let stats = column_stats(&s, StatKind::Num).unwrap();
+        assert_eq!(stats.null_count, 1);
+        assert!(stats.has_nan);
+        assert_eq!(stats.bounds, Bounds::Num(-1.0, 2.0));
+    }
+}
@@ -1,9 +1,15 @@
 use polars_arrow::ffi::ArrowArrayStreamReader;
-use polars_readstat_rs::sas::arrow_output::read_to_arrow_stream_ffi;
+use polars_readstat_rs::sas::arrow_output::{
+    read_to_arrow_stream_ffi, read_to_arrow_stream_ffi_with_budget,
+};
 use std::path::Path;
 
 fn count_rows_via_ffi(path: &Path, batch_size: usize) -> usize {
     let ptr = read_to_arrow_stream_ffi(path, None, true, None, 0, None).expect("stream");
+    count_stream_rows(ptr)
+}
+
+fn count_stream_rows(ptr: *mut polars_arrow::ffi::ArrowArrayStream) -> usize {
     let boxed = unsafe { Box::from_raw(ptr) };
     let mut reader = unsafe { ArrowArrayStreamReader::try_new(boxed).expect("reader") };
     let mut total = 0;
@@ -30,6 +36,10 @@ fn test_arrow_stream_row_count() {
             "batch_size={batch_size}: got {got} rows, expected {expected}"
         );
     }
+
+    let ptr = read_to_arrow_stream_ffi_with_budget(&path, None, true, None, 0, None, Some(1 << 20))
+        .expect("stream");
+    assert_eq!(count_stream_rows(ptr), expected);
 }
 
 #[test]
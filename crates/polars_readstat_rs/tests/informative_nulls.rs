@@ -8,9 +8,9 @@
 use polars::prelude::*;
 use polars_readstat_rs::{
     scan_dta, scan_sas7bdat, scan_sav, InformativeNullColumns, InformativeNullMode,
-    InformativeNullOpts, ScanOptions,
+    InformativeNullOpts, ScanOptions, SpssCompression, SpssWriter, StataWriter,
 };
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 
 fn test_data(format: &str, file: &str) -> PathBuf {
     PathBuf::from(env!("CARGO_MANIFEST_DIR"))
@@ -253,8 +253,134 @@ fn test_stata_informative_nulls_indicators_are_string_type() -> PolarsResult<()>
     Ok(())
 }
 
+/// Scan options for an informative-null read with `threads` workers and small batches.
+fn threaded_opts(threads: usize) -> ScanOptions {
+    ScanOptions {
+        threads: Some(threads),
+        chunk_size: Some(256),
+        preserve_order: Some(true),
+        row_index_name: Some("row".to_string()),
+        informative_nulls: Some(InformativeNullOpts::new(InformativeNullColumns::All)),
+        value_labels_as_strings: Some(false),
+        ..Default::default()
+    }
+}
+
+#[test]
+fn test_stata_parallel_informative_nulls_match_serial() -> PolarsResult<()> {
+    let n = 3000i32;
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| (i % 7 != 0).then(|| i as f64 + 0.5))
+        .collect();
+    let df = df!("id" => (0..n).collect::<Vec<i32>>(), "value" => value)?;
+    let path = std::env::temp_dir().join(format!(
+        "polars_readstat_parallel_info_nulls_{}.dta",
+        std::process::id()
+    ));
+    StataWriter::new(&path).write_df(&df).unwrap();
+
+    // Turn every system missing double into `.a`.
+    let mut bytes = std::fs::read(&path).unwrap();
+    let sysmiss = 0x7fe0_0000_0000_0000u64.to_le_bytes();
+    let dot_a = 0x7fe0_0000_0000_0001u64.to_le_bytes();
+    let mut patched = 0;
+    let mut i = 0;
+    while i + 8 <= bytes.len() {
+        if bytes[i..i + 8] == sysmiss {
+            bytes[i..i + 8].copy_from_slice(&dot_a);
+            patched += 1;
+            i += 8;
+        } else {
+            i += 1;
+        }
+    }
+    assert_eq!(patched, df.column("value")?.null_count());
+    std::fs::write(&path, &bytes).unwrap();
+
+    let serial = scan_dta(&path, threaded_opts(1))?.collect()?;
+    let parallel = scan_dta(&path, threaded_opts(4))?.collect()?;
+    let _ = std::fs::remove_file(&path);
+
+    assert!(serial.equals_missing(&parallel));
+    let indicator = parallel.column("value_null")?;
+    assert_eq!(indicator.dtype(), &DataType::String);
+    assert_eq!(indicator.len() - indicator.null_count(), patched);
+    assert_eq!(indicator.str()?.get(7), Some(".a"));
+    assert_eq!(indicator.str()?.get(8), None);
+    Ok(())
+}
+
 // ───────────────────────────── SPSS ────────────────────────────────────────
 
+/// Declare `missing` a discrete missing value of the numeric variable `name` by
+/// rewriting its dictionary record; `SpssWriter` does not write declared missings.
+fn declare_spss_missing(path: &Path, name: &str, missing: f64) {
+    let mut bytes = std::fs::read(path).unwrap();
+    let int_at =
+        |bytes: &[u8], at: usize| i32::from_le_bytes(bytes[at..at + 4].try_into().unwrap());
+    // Variable records follow the 176-byte file header.
+    let mut pos = 176;
+    loop {
+        assert_eq!(int_at(&bytes, pos), 2, "no variable record for {name}");
+        let short_name = String::from_utf8_lossy(&bytes[pos + 24..pos + 32]).into_owned();
+        let mut end = pos + 32;
+        if int_at(&bytes, pos + 8) == 1 {
+            end += 4 + (int_at(&bytes, end) as usize).div_ceil(4) * 4;
+        }
+        end += int_at(&bytes, pos + 12).unsigned_abs() as usize * 8;
+        if short_name.trim_end().eq_ignore_ascii_case(name) {
+            bytes[pos + 12..pos + 16].copy_from_slice(&1i32.to_le_bytes());
+            bytes.splice(end..end, missing.to_le_bytes());
+            break;
+        }
+        pos = end;
+    }
+    std::fs::write(path, bytes).unwrap();
+}
+
+#[test]
+fn test_spss_parallel_informative_nulls_match_serial() -> PolarsResult<()> {
+    let n = 3000usize;
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| match i {
+            _ if i % 5 == 0 => None,
+            _ if i % 7 == 0 => Some(-99.0),
+            _ => Some(i as f64 * 0.25),
+        })
+        .collect();
+    let names: Vec<String> = (0..n).map(|i| format!("n{i}")).collect();
+    let df = df!("value" => value, "name" => names)?;
+    let path = std::env::temp_dir().join(format!(
+        "polars_readstat_parallel_info_nulls_{}.sav",
+        std::process::id()
+    ));
+    // Bytecode compression makes the parallel workers start at row checkpoints.
+    SpssWriter::new(&path)
+        .with_compression(SpssCompression::Bytecode)
+        .write_df(&df)
+        .unwrap();
+    declare_spss_missing(&path, "value", -99.0);
+
+    let serial = scan_sav(&path, threaded_opts(1))?.collect()?;
+    let parallel = scan_sav(&path, threaded_opts(4))?.collect()?;
+    let _ = std::fs::remove_file(&path);
+
+    assert_eq!(parallel.height(), n);
+    assert!(serial.equals_missing(&parallel));
+    let declared = (0..n).filter(|i| i % 5 != 0 && i % 7 == 0).count();
+    assert_eq!(parallel.column("value")?.null_count(), n / 5 + declared);
+    let indicator = parallel.column("value_null")?;
+    assert_eq!(indicator.dtype(), &DataType::String);
+    assert_eq!(indicator.len() - indicator.null_count(), declared);
+    let indicator = indicator.str()?;
+    assert_eq!(indicator.get(7), Some("-99"));
+    assert_eq!(indicator.get(2996), Some("-99"));
+    // System missing and valid values have no indicator.
+    assert_eq!(indicator.get(35), None);
+    assert_eq!(indicator.get(8), None);
+    Ok(())
+}
+
 #[test]
 fn test_spss_informative_nulls_schema() -> PolarsResult<()> {
     let path = test_data("spss", "missing_test.sav");
@@ -0,0 +1,56 @@
+use polars::prelude::*;
+use polars_readstat_rs::{readstat_batch_iter, ScanOptions};
+use std::path::PathBuf;
+
+fn fixtures() -> Vec<PathBuf> {
+    let root = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests");
+    vec![
+        root.join("sas/data/data_poe/cps.sas7bdat"),
+        root.join("sas/data/test.sas7bdat"),
+        root.join("stata/data/sample.dta"),
+        root.join("spss/data/sample.sav"),
+    ]
+}
+
+/// Stack every batch, also returning the largest batch height seen.
+fn collect(path: &std::path::Path, memory_budget: Option<usize>) -> (DataFrame, usize) {
+    let opts = ScanOptions {
+        threads: Some(2),
+        preserve_order: Some(true),
+        memory_budget,
+        ..Default::default()
+    };
+    let iter = readstat_batch_iter(path, Some(opts), None, None, None, None).expect("iter");
+    let mut out: Option<DataFrame> = None;
+    let mut max_height = 0;
+    for df in iter {
+        let df = df.expect("batch");
+        max_height = max_height.max(df.height());
+        if let Some(acc) = out.as_mut() {
+            acc.vstack_mut(&df).expect("vstack");
+        } else {
+            out = Some(df);
+        }
+    }
+    (out.unwrap_or_else(DataFrame::empty), max_height)
+}
+
+#[test]
+fn test_memory_budget_matches_unbounded_read() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let (expected, _) = collect(&path, None);
+        // Small enough that every file is split into many batches.
+        let (got, max_height) = collect(&path, Some(64 * 1024));
+        assert!(
+            expected.equals_missing(&got),
+            "budgeted read differs for {}",
+            path.display()
+        );
+        if expected.height() > 100_000 {
+            assert!(max_height < expected.height(), "{}", path.display());
+        }
+    }
+}
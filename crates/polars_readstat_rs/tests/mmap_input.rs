@@ -0,0 +1,132 @@
+use polars::prelude::*;
+use polars_readstat_rs::{readstat_batch_iter, ScanOptions};
+use std::path::PathBuf;
+
+fn fixtures() -> Vec<PathBuf> {
+    let root = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests");
+    vec![
+        // Uncompressed, including MIX pages
+        root.join("sas/data/data_poe/cps.sas7bdat"),
+        root.join("sas/data/data_AHS2013/owner.sas7bdat"),
+        // RDC / RLE
+        root.join("sas/data/test.sas7bdat"),
+        root.join("sas/data/data_pandas/test2.sas7bdat"),
+        root.join("stata/data/sample.dta"),
+        root.join("stata/data/missing_test.dta"),
+        root.join("spss/data/sample.sav"),
+        root.join("spss/data/missing_test.sav"),
+    ]
+}
+
+fn collect(path: &std::path::Path, threads: usize, use_mmap: bool) -> DataFrame {
+    collect_opts(
+        path,
+        ScanOptions {
+            threads: Some(threads),
+            chunk_size: Some(1024),
+            preserve_order: Some(true),
+            use_mmap: Some(use_mmap),
+            ..Default::default()
+        },
+    )
+}
+
+fn collect_opts(path: &std::path::Path, opts: ScanOptions) -> DataFrame {
+    let iter = readstat_batch_iter(path, Some(opts), None, None, None, Some(1024)).expect("iter");
+    let mut out: Option<DataFrame> = None;
+    for df in iter {
+        let df = df.expect("batch");
+        if let Some(acc) = out.as_mut() {
+            acc.vstack_mut(&df).expect("vstack");
+        } else {
+            out = Some(df);
+        }
+    }
+    out.unwrap_or_else(DataFrame::empty)
+}
+
+/// Reading through the memory map must produce exactly what buffered reads produce,
+/// serially and with parallel workers.
+#[test]
+fn test_mmap_matches_buffered() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        for threads in [1usize, 4] {
+            let buffered = collect(&path, threads, false);
+            let mapped = collect(&path, threads, true);
+            assert!(
+                buffered.equals_missing(&mapped),
+                "{}: threads={threads}: mmap read differs from buffered read",
+                path.display()
+            );
+        }
+    }
+}
+
+/// Row-limited reads stop partway through the mapping.
+#[test]
+fn test_mmap_row_limited_read() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let opts = |use_mmap| ScanOptions {
+            threads: Some(2),
+            preserve_order: Some(true),
+            use_mmap: Some(use_mmap),
+            ..Default::default()
+        };
+        let read = |use_mmap| {
+            let mut out: Option<DataFrame> = None;
+            let iter =
+                readstat_batch_iter(&path, Some(opts(use_mmap)), None, None, Some(37), Some(8))
+                    .expect("iter");
+            for df in iter {
+                let df = df.expect("batch");
+                match out.as_mut() {
+                    Some(acc) => {
+                        acc.vstack_mut(&df).expect("vstack");
+                    }
+                    None => out = Some(df),
+                }
+            }
+            out.unwrap_or_else(DataFrame::empty)
+        };
+        assert!(
+            read(false).equals_missing(&read(true)),
+            "{}: row-limited mmap read differs",
+            path.display()
+        );
+    }
+}
+
+/// The read-ahead range backend produces what buffered reads produce. The small
+/// window keeps several range requests in flight even on the small fixtures.
+#[test]
+fn test_read_ahead_matches_buffered() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        for threads in [1usize, 4] {
+            let buffered = collect(&path, threads, false);
+            let ranged = collect_opts(
+                &path,
+                ScanOptions {
+                    threads: Some(threads),
+                    chunk_size: Some(1024),
+                    preserve_order: Some(true),
+                    read_ahead: Some(1024 * 1024),
+                    ..Default::default()
+                },
+            );
+            assert!(
+                buffered.equals_missing(&ranged),
+                "{}: threads={threads}: read-ahead read differs from buffered read",
+                path.display()
+            );
+        }
+    }
+}
@@ -0,0 +1,162 @@
+use polars::prelude::*;
+use polars_readstat_rs::{
+    readstat_batch_iter_many, readstat_glob, readstat_scan, readstat_scan_many, MultiScanOptions,
+    ScanOptions,
+};
+use std::path::PathBuf;
+
+fn data(path: &str) -> PathBuf {
+    PathBuf::from(env!("CARGO_MANIFEST_DIR"))
+        .join("tests")
+        .join(path)
+}
+
+fn scan_opts() -> ScanOptions {
+    ScanOptions {
+        threads: Some(2),
+        preserve_order: Some(true),
+        ..Default::default()
+    }
+}
+
+#[test]
+fn test_scan_many_matches_concatenated_scans() {
+    let paths = [
+        data("stata/data/sample.dta"),
+        data("stata/data/missing_test.dta"),
+        data("sas/data/test.sas7bdat"),
+    ];
+    if paths.iter().any(|p| !p.exists()) {
+        return;
+    }
+    let multi = MultiScanOptions {
+        source_column: Some("source".to_string()),
+    };
+    let df = readstat_scan_many(&paths, Some(scan_opts()), None, Some(multi))
+        .expect("scan")
+        .collect()
+        .expect("collect");
+
+    let mut offset = 0;
+    for path in &paths {
+        let single = readstat_scan(path, Some(scan_opts()), None)
+            .expect("scan")
+            .collect()
+            .expect("collect");
+        let part = df.slice(offset as i64, single.height());
+        // Every row of this part comes from `path`.
+        let source = part.column("source").unwrap().str().unwrap().clone();
+        let path_str = path.to_string_lossy();
+        assert!(source.into_iter().all(|s| s == Some(path_str.as_ref())));
+        // The file's own columns read back unchanged (up to the unified dtype).
+        for col in single.columns() {
+            let got = part.column(col.name()).unwrap();
+            let expected = col.cast(got.dtype()).unwrap();
+            assert!(
+                got.as_materialized_series()
+                    .equals_missing(expected.as_materialized_series()),
+                "{}: {}",
+                path.display(),
+                col.name()
+            );
+        }
+        offset += single.height();
+    }
+    assert_eq!(df.height(), offset);
+}
+
+#[test]
+fn test_batch_iter_many_row_index_and_projection() {
+    let paths = [data("spss/data/sample.sav"), data("spss/data/sample.sav")];
+    if !paths[0].exists() {
+        return;
+    }
+    let single = readstat_scan(&paths[0], Some(scan_opts()), None)
+        .expect("scan")
+        .collect()
+        .expect("collect");
+    let first = single.get_column_names()[0].to_string();
+
+    let opts = ScanOptions {
+        row_index_name: Some("row".to_string()),
+        ..scan_opts()
+    };
+    let iter = readstat_batch_iter_many(
+        &paths,
+        Some(opts),
+        None,
+        Some(vec![first.clone()]),
+        None,
+        Some(3),
+        None,
+    )
+    .expect("iter");
+    let mut heights = 0;
+    let mut rows: Vec<u32> = Vec::new();
+    for batch in iter {
+        let batch = batch.expect("batch");
+        assert_eq!(batch.width(), 2);
+        heights += batch.height();
+        let idx = batch
+            .column("row")
+            .unwrap()
+            .cast(&DataType::UInt32)
+            .unwrap();
+        rows.extend(idx.u32().unwrap().into_no_null_iter());
+    }
+    assert_eq!(heights, 2 * single.height());
+    assert_eq!(rows, (0..heights as u32).collect::<Vec<_>>());
+}
+
+/// A filter on a multi-file scan with a row index keeps each row's position in
+/// the whole dataset.
+#[test]
+fn test_filtered_scan_many_keeps_row_index() {
+    let paths = [data("stata/data/sample.dta"), data("stata/data/sample.dta")];
+    if !paths[0].exists() {
+        return;
+    }
+    let opts = ScanOptions {
+        row_index_name: Some("row".to_string()),
+        ..scan_opts()
+    };
+    let full = readstat_scan_many(&paths, Some(opts.clone()), None, None)
+        .expect("scan")
+        .collect()
+        .expect("collect");
+    let Some((name, median)) = full.get_columns().iter().find_map(|col| {
+        let median = col.f64().ok()?.median()?;
+        Some((col.name().to_string(), median))
+    }) else {
+        return;
+    };
+    let predicate = col(name.as_str()).gt_eq(lit(median));
+    let expected = full
+        .lazy()
+        .filter(predicate.clone())
+        .collect()
+        .expect("post filter");
+    let pushed = readstat_scan_many(&paths, Some(opts), None, None)
+        .expect("scan")
+        .filter(predicate)
+        .collect()
+        .expect("pushed filter");
+    assert!(expected.height() > 0);
+    assert!(
+        expected.equals_missing(&pushed),
+        "filter on {name} moved row indices"
+    );
+}
+
+#[test]
+fn test_glob_expands_sorted_matches() {
+    let dir = data("stata/data");
+    if !dir.join("sample.dta").exists() {
+        return;
+    }
+    let pattern = format!("{}/stata-compat-1*.dta", dir.display());
+    let paths = readstat_glob(&pattern).expect("glob");
+    assert!(!paths.is_empty());
+    assert!(paths.windows(2).all(|w| w[0] < w[1]));
+    assert!(readstat_glob(&format!("{}/no_such_*.dta", dir.display())).is_err());
+}
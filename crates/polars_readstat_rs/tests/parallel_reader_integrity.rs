@@ -147,6 +147,27 @@ fn test_parallel_compressed_integrity() {
     }
 }
 
+/// The compressed pipeline deals page groups round-robin to workers; output must
+/// still come back in file order, row for row.
+#[test]
+fn test_pipelined_compressed_preserves_order() {
+    let files = [
+        base().join("test.sas7bdat"),
+        base().join("data_pandas/test2.sas7bdat"),
+        base().join("data_AHS2013/rmov.sas7bdat"),
+    ];
+    for path in &files {
+        if !path.exists() {
+            continue;
+        }
+        let baseline = collect_sas(path, 1, 65536);
+        for threads in [2usize, 3, 8] {
+            let df = collect_sas(path, threads, 1024);
+            assert_same_df(&baseline, &df);
+        }
+    }
+}
+
 /// Test just the large 400MB file with multi-threading (row count + checksum only).
 #[test]
 fn test_large_file_parallel_integrity() {
@@ -0,0 +1,171 @@
+use polars::prelude::*;
+use polars_readstat_rs::{
+    readstat_batch_iter, readstat_scan, FilterOp, FilterValue, RowFilter, ScanOptions,
+};
+use std::path::PathBuf;
+
+fn fixtures() -> Vec<PathBuf> {
+    let root = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests");
+    vec![
+        root.join("sas/data/test.sas7bdat"),
+        root.join("sas/data/data_pandas/test2.sas7bdat"),
+        root.join("sas/data/data_poe/cps.sas7bdat"),
+        root.join("stata/data/sample.dta"),
+        root.join("stata/data/missing_test.dta"),
+        root.join("spss/data/sample.sav"),
+        root.join("spss/data/missing_test.sav"),
+    ]
+}
+
+/// First Float64 column with at least two distinct non-null values, and its median.
+fn pick_numeric(df: &DataFrame) -> Option<(String, f64)> {
+    for col in df.get_columns() {
+        let Ok(ca) = col.f64() else {
+            continue;
+        };
+        if ca.n_unique().unwrap_or(0) < 3 {
+            continue;
+        }
+        if let Some(median) = ca.median() {
+            return Some((col.name().to_string(), median));
+        }
+    }
+    None
+}
+
+fn collect_iter(path: &std::path::Path, opts: ScanOptions) -> DataFrame {
+    let iter = readstat_batch_iter(path, Some(opts), None, None, None, Some(64)).expect("iter");
+    let mut out: Option<DataFrame> = None;
+    for df in iter {
+        let df = df.expect("batch");
+        if let Some(acc) = out.as_mut() {
+            acc.vstack_mut(&df).expect("vstack");
+        } else {
+            out = Some(df);
+        }
+    }
+    out.unwrap_or_else(DataFrame::empty)
+}
+
+/// A lazy filter pushed into the reader must return exactly what filtering the
+/// full frame returns.
+#[test]
+fn test_scan_filter_matches_post_filter() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let full = readstat_scan(&path, None, None)
+            .expect("scan")
+            .collect()
+            .expect("collect");
+        let Some((name, median)) = pick_numeric(&full) else {
+            continue;
+        };
+        let predicate = col(name.as_str()).gt_eq(lit(median));
+        let expected = full
+            .clone()
+            .lazy()
+            .filter(predicate.clone())
+            .collect()
+            .expect("post filter");
+        let pushed = readstat_scan(&path, None, None)
+            .expect("scan")
+            .filter(predicate)
+            .collect()
+            .expect("pushed filter");
+        assert!(
+            expected.equals_missing(&pushed),
+            "{}: pushed filter on {name} differs",
+            path.display()
+        );
+    }
+}
+
+/// `is_in` against a literal list is pushed as an is-in row filter.
+#[test]
+fn test_scan_is_in_matches_post_filter() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let full = readstat_scan(&path, None, None)
+            .expect("scan")
+            .collect()
+            .expect("collect");
+        let Some((name, _)) = pick_numeric(&full) else {
+            continue;
+        };
+        let values: Vec<f64> = full
+            .column(&name)
+            .expect("column")
+            .f64()
+            .expect("f64")
+            .into_iter()
+            .flatten()
+            .step_by(3)
+            .take(4)
+            .collect();
+        let list = lit(Series::new("".into(), values)).implode();
+        let predicate = col(name.as_str()).is_in(list, false);
+        assert!(RowFilter::from_expr(&predicate).is_some());
+        let expected = full
+            .clone()
+            .lazy()
+            .filter(predicate.clone())
+            .collect()
+            .expect("post filter");
+        let pushed = readstat_scan(&path, None, None)
+            .expect("scan")
+            .filter(predicate)
+            .collect()
+            .expect("pushed filter");
+        assert!(expected.height() > 0);
+        assert!(
+            expected.equals_missing(&pushed),
+            "{}: pushed is_in on {name} differs",
+            path.display()
+        );
+    }
+}
+
+/// The batch iterator honours `ScanOptions::row_filter` directly, across thread
+/// counts, and never drops a row that satisfies the filter.
+#[test]
+fn test_batch_iter_row_filter() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let full = collect_iter(&path, ScanOptions::default());
+        let Some((name, median)) = pick_numeric(&full) else {
+            continue;
+        };
+        let expected = full
+            .lazy()
+            .filter(col(name.as_str()).lt(lit(median)))
+            .collect()
+            .expect("post filter");
+        for threads in [1usize, 4] {
+            let opts = ScanOptions {
+                threads: Some(threads),
+                row_filter: Some(RowFilter::compare(
+                    name.as_str(),
+                    FilterOp::Lt,
+                    FilterValue::Num(median),
+                )),
+                ..Default::default()
+            };
+            let filtered = collect_iter(&path, opts)
+                .lazy()
+                .filter(col(name.as_str()).lt(lit(median)))
+                .collect()
+                .expect("residual filter");
+            assert!(
+                expected.equals_missing(&filtered),
+                "{}: threads={threads} row_filter on {name} differs",
+                path.display()
+            );
+        }
+    }
+}
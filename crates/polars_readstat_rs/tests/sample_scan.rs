@@ -0,0 +1,240 @@
+use polars::prelude::*;
+use polars_readstat_rs::{
+    readstat_batch_iter, readstat_scan, SampleMode, SampleOptions, Sas7bdatReader, ScanOptions,
+    SpssCompression, SpssWriter, StataWriter,
+};
+use std::path::PathBuf;
+use std::time::{SystemTime, UNIX_EPOCH};
+
+fn temp_path(prefix: &str, ext: &str) -> PathBuf {
+    let mut path = std::env::temp_dir();
+    let nanos = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap()
+        .as_nanos();
+    let pid = std::process::id();
+    path.push(format!("{prefix}_{pid}_{nanos}.{ext}"));
+    path
+}
+
+fn test_df(n: i32) -> DataFrame {
+    let id: Vec<i32> = (0..n).collect();
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| (i % 9 != 0).then(|| i as f64 * 0.5))
+        .collect();
+    let name: Vec<String> = (0..n).map(|i| format!("r{i}")).collect();
+    df!("id" => id, "value" => value, "name" => name).unwrap()
+}
+
+fn sample_opts(sample: SampleOptions) -> ScanOptions {
+    ScanOptions {
+        threads: Some(2),
+        row_index_name: Some("row".to_string()),
+        sample: Some(sample),
+        ..Default::default()
+    }
+}
+
+/// Row positions of a sample, checked against the values written at them.
+fn sampled_rows(out: &DataFrame) -> Vec<u32> {
+    let rows: Vec<u32> = out
+        .column("row")
+        .unwrap()
+        .cast(&DataType::UInt32)
+        .unwrap()
+        .u32()
+        .unwrap()
+        .into_no_null_iter()
+        .collect();
+    let ids: Vec<f64> = out
+        .column("id")
+        .unwrap()
+        .cast(&DataType::Float64)
+        .unwrap()
+        .f64()
+        .unwrap()
+        .into_no_null_iter()
+        .collect();
+    let names = out.column("name").unwrap().str().unwrap();
+    for (i, (&row, &id)) in rows.iter().zip(&ids).enumerate() {
+        assert_eq!(id, row as f64);
+        assert_eq!(names.get(i), Some(format!("r{row}").as_str()));
+    }
+    assert!(
+        rows.windows(2).all(|w| w[0] < w[1]),
+        "sample is in file order"
+    );
+    rows
+}
+
+#[test]
+fn test_stata_row_sample_is_exact_and_seeded() {
+    let path = temp_path("sample_rows", "dta");
+    StataWriter::new(&path).write_df(&test_df(20_000)).unwrap();
+
+    let sample = SampleOptions::fraction(0.01)
+        .with_mode(SampleMode::Rows)
+        .with_seed(42);
+    let first = readstat_scan(&path, Some(sample_opts(sample.clone())), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    let again = readstat_scan(&path, Some(sample_opts(sample.clone())), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    let other = readstat_scan(&path, Some(sample_opts(sample.with_seed(7))), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    let _ = std::fs::remove_file(&path);
+
+    assert_eq!(first.height(), 200);
+    assert_eq!(other.height(), 200);
+    let rows = sampled_rows(&first);
+    assert_eq!(rows, sampled_rows(&again));
+    assert_ne!(rows, sampled_rows(&other));
+}
+
+#[test]
+fn test_block_sample_keeps_whole_blocks() {
+    let path = temp_path("sample_blocks", "sav");
+    SpssWriter::new(&path).write_df(&test_df(10_000)).unwrap();
+
+    let sample = SampleOptions::rows(2500).with_block_rows(500).with_seed(3);
+    let out = readstat_scan(&path, Some(sample_opts(sample.clone())), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+
+    // The streaming reader returns the same rows.
+    let batches = readstat_batch_iter(
+        &path,
+        Some(sample_opts(sample)),
+        None,
+        None,
+        None,
+        Some(300),
+    )
+    .unwrap()
+    .collect::<PolarsResult<Vec<_>>>()
+    .unwrap();
+    let _ = std::fs::remove_file(&path);
+
+    assert_eq!(out.height(), 2500);
+    let rows = sampled_rows(&out);
+    for block in rows.chunks(500) {
+        assert_eq!(block[0] % 500, 0);
+        assert_eq!(block[499], block[0] + 499);
+    }
+    let streamed: Vec<u32> = batches.iter().flat_map(sampled_rows).collect();
+    assert_eq!(streamed, rows);
+}
+
+#[test]
+fn test_compressed_spss_sample_matches_uncompressed() {
+    let df = test_df(5000);
+    let plain = temp_path("sample_plain", "sav");
+    let bytecode = temp_path("sample_bytecode", "sav");
+    let zsav = temp_path("sample_zlib", "zsav");
+    SpssWriter::new(&plain).write_df(&df).unwrap();
+    SpssWriter::new(&bytecode)
+        .with_compression(SpssCompression::Bytecode)
+        .write_df(&df)
+        .unwrap();
+    SpssWriter::new(&zsav).write_df(&df).unwrap();
+
+    // Short gaps split the sample into many ranges, so bytecode reads start at
+    // checkpoints and zsav reads at the first sampled row.
+    let sample = SampleOptions::fraction(0.1)
+        .with_mode(SampleMode::Rows)
+        .with_block_rows(50)
+        .with_seed(11);
+    let read = |path: &PathBuf| {
+        readstat_scan(path, Some(sample_opts(sample.clone())), None)
+            .unwrap()
+            .select([col("row"), col("id"), col("name")])
+            .collect()
+            .unwrap()
+    };
+    let expected = read(&plain);
+    let from_bytecode = read(&bytecode);
+    let from_zsav = read(&zsav);
+    for path in [&plain, &bytecode, &zsav] {
+        let _ = std::fs::remove_file(path);
+    }
+
+    assert_eq!(expected.height(), 500);
+    sampled_rows(&expected);
+    assert!(expected.equals_missing(&from_bytecode));
+    assert!(expected.equals_missing(&from_zsav));
+}
+
+#[test]
+fn test_sas_sample_matches_full_read() {
+    let path = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/sas/data/test.sas7bdat");
+    let opts = |sample| ScanOptions {
+        threads: Some(2),
+        row_index_name: Some("row".to_string()),
+        sample,
+        ..Default::default()
+    };
+    let full = readstat_scan(&path, Some(opts(None)), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+
+    for sample in [
+        SampleOptions::fraction(0.05)
+            .with_mode(SampleMode::Rows)
+            .with_block_rows(20)
+            .with_seed(5),
+        SampleOptions::fraction(0.2)
+            .with_block_rows(25)
+            .with_seed(9),
+    ] {
+        let out = readstat_scan(&path, Some(opts(Some(sample))), None)
+            .unwrap()
+            .collect()
+            .unwrap();
+        assert!(out.height() > 0);
+        let rows = out.column("row").unwrap().cast(&IDX_DTYPE).unwrap();
+        let expected = full.take(rows.idx().unwrap()).unwrap();
+        assert!(expected.equals_missing(&out));
+    }
+    // The ranges were read through a page index kept with the shared reader.
+    let reader = Sas7bdatReader::open_cached(&path).unwrap();
+    assert!(reader.page_index().is_some());
+}
+
+#[test]
+fn test_sample_limits_and_errors() {
+    let path = temp_path("sample_limits", "dta");
+    StataWriter::new(&path).write_df(&test_df(1000)).unwrap();
+
+    let head = readstat_scan(&path, Some(sample_opts(SampleOptions::fraction(0.5))), None)
+        .unwrap()
+        .limit(10)
+        .collect()
+        .unwrap();
+    assert_eq!(head.height(), 10);
+
+    let empty = readstat_scan(&path, Some(sample_opts(SampleOptions::rows(0))), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    assert_eq!(empty.height(), 0);
+    assert_eq!(empty.width(), 4);
+
+    let bad = readstat_scan(&path, Some(sample_opts(SampleOptions::fraction(2.0))), None)
+        .unwrap()
+        .collect();
+    assert!(bad.is_err());
+    let _ = std::fs::remove_file(&path);
+
+    let por = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/spss/data/sample.por");
+    let err = readstat_scan(&por, Some(sample_opts(SampleOptions::fraction(0.5))), None)
+        .unwrap()
+        .collect();
+    assert!(err.is_err());
+}
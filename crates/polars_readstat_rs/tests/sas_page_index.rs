@@ -0,0 +1,160 @@
+use polars::prelude::*;
+use polars_readstat_rs::{Sas7bdatReader, SasPageIndex};
+use std::path::PathBuf;
+
+fn fixtures() -> Vec<PathBuf> {
+    let root = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/sas/data");
+    vec![
+        // Uncompressed, including MIX pages
+        root.join("data_poe/cps.sas7bdat"),
+        root.join("data_AHS2013/owner.sas7bdat"),
+        // RDC / RLE
+        root.join("test.sas7bdat"),
+        root.join("data_pandas/test2.sas7bdat"),
+    ]
+}
+
+fn temp_index_path(name: &str) -> PathBuf {
+    std::env::temp_dir().join(format!(
+        "polars_readstat_{}_{}.pidx",
+        name,
+        std::process::id()
+    ))
+}
+
+#[test]
+fn test_page_index_covers_every_row() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let reader = Sas7bdatReader::open(&path).expect("open");
+        let index = reader.build_page_index().expect("build");
+        let row_count = reader.metadata().row_count;
+        assert_eq!(index.row_count() as usize, row_count);
+
+        let mut next_row = 0u64;
+        for entry in index.entries() {
+            assert_eq!(entry.first_row, next_row, "{}", path.display());
+            next_row += entry.row_count as u64;
+        }
+        assert_eq!(next_row as usize, row_count, "{}", path.display());
+
+        for row in [0, row_count / 2, row_count.saturating_sub(1)] {
+            let entry = index.locate(row).expect("locate");
+            assert!(entry.first_row as usize <= row);
+            assert!(row < (entry.first_row + entry.row_count as u64) as usize);
+        }
+        assert!(index.locate(row_count).is_none());
+    }
+}
+
+#[test]
+fn test_page_index_sidecar_roundtrip() {
+    let path = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/sas/data/test.sas7bdat");
+    if !path.exists() {
+        return;
+    }
+    let sidecar = temp_index_path("roundtrip");
+    let _ = std::fs::remove_file(&sidecar);
+
+    let reader = Sas7bdatReader::open(&path)
+        .expect("open")
+        .with_page_index_file(&sidecar)
+        .expect("index");
+    assert!(reader.page_index().is_some());
+    assert!(sidecar.exists());
+
+    let loaded = SasPageIndex::load(&sidecar).expect("load");
+    assert_eq!(loaded.entries(), reader.page_index().unwrap().entries());
+    let _ = std::fs::remove_file(&sidecar);
+}
+
+/// Offset reads that seek through the index must match offset reads that walk
+/// the pages, serially and in parallel.
+#[test]
+fn test_page_index_offset_reads_match() {
+    for path in fixtures() {
+        if !path.exists() {
+            continue;
+        }
+        let plain = Sas7bdatReader::open(&path).expect("open");
+        let indexed = Sas7bdatReader::open(&path).expect("open");
+        let index = indexed.build_page_index().expect("build");
+        let indexed = indexed.with_page_index(index);
+        assert!(indexed.page_index().is_some());
+
+        let row_count = plain.metadata().row_count;
+        for offset in [1usize, row_count / 3, row_count.saturating_sub(5)] {
+            for threads in [1usize, 4] {
+                let read = |reader: &Sas7bdatReader| -> DataFrame {
+                    reader
+                        .read()
+                        .with_offset(offset)
+                        .with_limit(50)
+                        .with_n_threads(threads)
+                        .finish()
+                        .expect("read")
+                };
+                let expected = read(&plain);
+                let got = read(&indexed);
+                assert!(
+                    expected.equals_missing(&got),
+                    "{}: offset={offset} threads={threads}",
+                    path.display()
+                );
+            }
+        }
+    }
+}
+
+/// A `<file>.pidx` sidecar next to the data file is picked up by every open, so
+/// scans use it without the caller attaching it.
+#[test]
+fn test_sidecar_next_to_file_is_loaded_on_open() {
+    let src = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/sas/data/test.sas7bdat");
+    if !src.exists() {
+        return;
+    }
+    let path = std::env::temp_dir().join(format!(
+        "polars_readstat_sidecar_{}.sas7bdat",
+        std::process::id()
+    ));
+    std::fs::copy(&src, &path).expect("copy");
+    let sidecar = SasPageIndex::sidecar_path(&path);
+    let _ = std::fs::remove_file(&sidecar);
+    assert!(Sas7bdatReader::open(&path)
+        .expect("open")
+        .page_index()
+        .is_none());
+
+    let index = Sas7bdatReader::open(&path)
+        .expect("open")
+        .build_page_index()
+        .expect("build");
+    index.save(&sidecar).expect("save");
+    let reader = Sas7bdatReader::open(&path).expect("open");
+    assert_eq!(
+        reader.page_index().map(|i| i.entries().len()),
+        Some(index.entries().len())
+    );
+
+    let rows = reader.metadata().row_count;
+    let offset = rows / 2;
+    let expected = Sas7bdatReader::open(&src)
+        .expect("open")
+        .read()
+        .with_offset(offset)
+        .with_limit(20)
+        .finish()
+        .expect("read");
+    let got = polars_readstat_rs::readstat_scan(&path, None, None)
+        .expect("scan")
+        .slice(offset as i64, 20)
+        .collect()
+        .expect("collect");
+    assert!(expected.equals_missing(&got));
+
+    let _ = std::fs::remove_file(&sidecar);
+    let _ = std::fs::remove_file(&path);
+}
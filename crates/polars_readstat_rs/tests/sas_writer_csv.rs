@@ -179,3 +179,65 @@ fn test_sas_writer_numeric_lengths() {
     let _ = fs::remove_file(&sas_path);
     let _ = fs::remove_dir_all(&out_dir);
 }
+
+#[test]
+fn test_sas_writer_streaming_matches_write_df() {
+    let df = DataFrame::new_infer_height(vec![
+        Series::new("id".into(), &[1i32, 2, 3, 4, 5]).into_column(),
+        Series::new("name".into(), &["a", "bbb", "cc", "dddddd", "e"]).into_column(),
+        Series::new("day".into(), &[0i32, 1, 2, 3, 4])
+            .cast(&DataType::Date)
+            .unwrap()
+            .into_column(),
+    ])
+    .unwrap();
+
+    let whole_dir = temp_dir("sas_writer_whole");
+    let (whole_csv, whole_sas) = SasWriter::new(&whole_dir)
+        .with_dataset_name("demo")
+        .write_df(&df)
+        .unwrap();
+    let stream_dir = temp_dir("sas_writer_stream");
+    let batches = vec![df.slice(0, 2), df.slice(2, 0), df.slice(2, 3)];
+    let (stream_csv, stream_sas) = SasWriter::new(&stream_dir)
+        .with_dataset_name("demo")
+        .write_batches_streaming(batches)
+        .unwrap();
+
+    assert_eq!(
+        fs::read_to_string(&whole_csv).unwrap(),
+        fs::read_to_string(&stream_csv).unwrap()
+    );
+    // The widest string is in the last batch.
+    let sas = fs::read_to_string(&stream_sas).unwrap();
+    assert!(sas.contains("length name $6;"), "got:\n{sas}");
+    assert_eq!(
+        fs::read_to_string(&whole_sas).unwrap(),
+        sas.replace(
+            &stream_dir.display().to_string(),
+            &whole_dir.display().to_string()
+        )
+    );
+
+    let empty: Vec<DataFrame> = Vec::new();
+    assert!(SasWriter::new(&stream_dir)
+        .write_batches_streaming(empty)
+        .is_err());
+
+    // No batches with a schema: a header-only CSV and a script for its columns.
+    let empty_dir = temp_dir("sas_writer_empty");
+    let (empty_csv, empty_sas) = SasWriter::new(&empty_dir)
+        .with_dataset_name("demo")
+        .write_batches_streaming_with_schema(Vec::<DataFrame>::new(), &df.schema())
+        .unwrap();
+    let header = fs::read_to_string(&whole_csv).unwrap();
+    let header = header.lines().next().unwrap();
+    assert_eq!(fs::read_to_string(&empty_csv).unwrap().trim_end(), header);
+    let sas = fs::read_to_string(&empty_sas).unwrap();
+    assert!(sas.contains("data demo;"), "got:\n{sas}");
+    assert!(sas.contains("length name $1;"), "got:\n{sas}");
+
+    let _ = fs::remove_dir_all(&whole_dir);
+    let _ = fs::remove_dir_all(&stream_dir);
+    let _ = fs::remove_dir_all(&empty_dir);
+}
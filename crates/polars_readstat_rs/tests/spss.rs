@@ -12,3 +12,6 @@ mod spss_value_labels;
 
 #[path = "spss/spss_long_string_value_labels.rs"]
 mod spss_long_string_value_labels;
+
+#[path = "spss/spss_por_scan.rs"]
+mod spss_por_scan;
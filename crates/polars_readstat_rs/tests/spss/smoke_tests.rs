@@ -62,6 +62,67 @@ fn test_read_zsav_file() {
     assert!(df.width() > 0);
 }
 
+#[test]
+fn test_read_zsav_parallel_inflate_matches_serial() {
+    let path = test_data_path("sample.zsav");
+    let read = |threads: usize, n_rows: Option<usize>| {
+        let opts = polars_readstat_rs::ScanOptions {
+            threads: Some(threads),
+            ..Default::default()
+        };
+        let iter =
+            polars_readstat_rs::readstat_batch_iter(&path, Some(opts), None, None, n_rows, Some(7))
+                .expect("iter");
+        let mut out: Option<DataFrame> = None;
+        for df in iter {
+            let df = df.expect("batch");
+            match out.as_mut() {
+                Some(acc) => {
+                    acc.vstack_mut(&df).expect("vstack");
+                }
+                None => out = Some(df),
+            }
+        }
+        out.expect("rows")
+    };
+    for n_rows in [None, Some(3)] {
+        let serial = read(1, n_rows);
+        let parallel = read(4, n_rows);
+        assert!(serial.equals_missing(&parallel), "n_rows={n_rows:?}");
+    }
+}
+
+/// Parallel reads of bytecode-compressed files start each worker at a row
+/// checkpoint; they must match a single sequential pass.
+#[test]
+fn test_read_compressed_parallel_matches_serial() {
+    for name in ["sample_large.sav", "tegulu.sav", "test_width.sav"] {
+        let path = test_data_path(name);
+        if !path.exists() {
+            continue;
+        }
+        let reader = SpssReader::open(&path).expect("open");
+        if reader.compression() != 1 {
+            continue;
+        }
+        let rows = reader.metadata().row_count as usize;
+        for offset in [0, rows / 3] {
+            let read = |threads: usize| {
+                reader
+                    .read()
+                    .with_offset(offset)
+                    .with_n_threads(threads)
+                    .with_chunk_size(256)
+                    .finish()
+                    .expect("read")
+            };
+            let serial = read(1);
+            let parallel = read(4);
+            assert!(serial.equals_missing(&parallel), "{name}: offset={offset}");
+        }
+    }
+}
+
 #[test]
 fn test_read_value_labels_as_strings() {
     let path = test_data_path("ordered_category.sav");
@@ -0,0 +1,132 @@
+use polars::prelude::*;
+use polars_readstat_rs::{
+    read_por, readstat_batch_iter, readstat_scan, write_por, PorWriteOptions, ScanOptions,
+};
+use std::fs;
+use std::path::PathBuf;
+use std::time::{SystemTime, UNIX_EPOCH};
+
+fn temp_path(prefix: &str, ext: &str) -> PathBuf {
+    let mut path = std::env::temp_dir();
+    let nanos = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap()
+        .as_nanos();
+    let pid = std::process::id();
+    path.push(format!("{prefix}_{pid}_{nanos}.{ext}"));
+    path
+}
+
+fn keep_strings() -> ScanOptions {
+    ScanOptions {
+        missing_string_as_null: Some(false),
+        ..Default::default()
+    }
+}
+
+fn assert_frames_equal(got: &DataFrame, want: &DataFrame) {
+    assert_eq!(got.schema(), want.schema());
+    assert_eq!(got.height(), want.height());
+    for (g, w) in got.columns().iter().zip(want.columns()) {
+        assert!(
+            g.as_materialized_series()
+                .equals_missing(w.as_materialized_series()),
+            "column {} differs",
+            g.name()
+        );
+    }
+}
+
+#[test]
+fn test_por_scan_streams_projects_and_limits() {
+    let n = 20_001usize;
+    let df = DataFrame::new_infer_height(vec![
+        Series::new("ID".into(), (0..n).map(|i| i as f64).collect::<Vec<_>>()).into_column(),
+        Series::new(
+            "SCORE".into(),
+            (0..n)
+                .map(|i| (i % 7 != 0).then(|| i as f64 * -0.5))
+                .collect::<Vec<_>>(),
+        )
+        .into_column(),
+        Series::new(
+            "NAME".into(),
+            (0..n).map(|i| format!("name {i}")).collect::<Vec<_>>(),
+        )
+        .into_column(),
+    ])
+    .unwrap();
+    let path = temp_path("por_scan", "por");
+    write_por(&df, &path, PorWriteOptions::default()).unwrap();
+
+    let (_, full) = read_por(&path).unwrap();
+    assert_frames_equal(&full, &df);
+
+    let scanned = readstat_scan(&path, Some(keep_strings()), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    assert_frames_equal(&scanned, &df);
+
+    let batches = readstat_batch_iter(
+        &path,
+        Some(keep_strings()),
+        None,
+        Some(vec!["NAME".to_string(), "ID".to_string()]),
+        Some(5_000),
+        Some(1_024),
+    )
+    .unwrap()
+    .collect::<PolarsResult<Vec<_>>>()
+    .unwrap();
+    assert!(batches.iter().all(|b| b.height() <= 1_024));
+    let mut streamed = batches[0].clone();
+    for b in &batches[1..] {
+        streamed.vstack_mut(b).unwrap();
+    }
+    assert_frames_equal(
+        &streamed,
+        &df.select(["ID", "NAME"]).unwrap().head(Some(5_000)),
+    );
+
+    let limited = readstat_scan(&path, None, None)
+        .unwrap()
+        .select([col("SCORE")])
+        .limit(9)
+        .collect()
+        .unwrap();
+    assert_frames_equal(&limited, &df.select(["SCORE"]).unwrap().head(Some(9)));
+
+    let missing = readstat_batch_iter(
+        &path,
+        None,
+        None,
+        Some(vec!["NOPE".to_string()]),
+        None,
+        None,
+    );
+    assert!(missing.is_err());
+
+    let _ = fs::remove_file(&path);
+}
+
+#[test]
+fn test_por_sample_scan_matches_read_por() {
+    let path = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/spss/data/sample.por");
+    let (_, full) = read_por(&path).unwrap();
+    assert!(full.height() > 0);
+
+    let scanned = readstat_scan(&path, Some(keep_strings()), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    assert_frames_equal(&scanned, &full);
+
+    let last = full.get_column_names_owned().last().unwrap().to_string();
+    let projected = readstat_scan(&path, Some(keep_strings()), None)
+        .unwrap()
+        .select([col(last.as_str())])
+        .collect()
+        .unwrap();
+    assert_frames_equal(&projected, &full.select([last.as_str()]).unwrap());
+}
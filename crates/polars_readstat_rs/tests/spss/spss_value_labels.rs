@@ -1,7 +1,7 @@
 use polars::prelude::*;
 use polars_readstat_rs::{
-    SpssReader, SpssValueLabelKey, SpssValueLabelMap, SpssValueLabels, SpssVariableLabels,
-    SpssWriter,
+    readstat_batch_iter, readstat_scan, ScanOptions, SpssReader, SpssValueLabelKey,
+    SpssValueLabelMap, SpssValueLabels, SpssVariableLabels, SpssWriter,
 };
 use std::collections::HashMap;
 use std::fs;
@@ -69,3 +69,110 @@ fn test_spss_value_and_variable_labels() {
 
     let _ = fs::remove_file(&path);
 }
+
+#[test]
+fn test_spss_value_labels_as_categorical() {
+    let df = DataFrame::new_infer_height(vec![
+        Series::new("status".into(), &[2i32, 1, 4, 2]).into_column()
+    ])
+    .unwrap();
+
+    let mut map: SpssValueLabelMap = HashMap::new();
+    map.insert(SpssValueLabelKey::from_f64(1.0), "one".to_string());
+    map.insert(SpssValueLabelKey::from_f64(2.0), "two".to_string());
+    let mut labels: SpssValueLabels = HashMap::new();
+    labels.insert("status".to_string(), map);
+
+    let path = temp_path("spss_labels_categorical", "sav");
+    SpssWriter::new(&path)
+        .with_value_labels(labels)
+        .write_df(&df)
+        .unwrap();
+
+    let reader = SpssReader::open(&path).unwrap();
+    let col_name = reader.metadata().variables[0].name.clone();
+    let out = reader
+        .read()
+        .value_labels_as_categorical(true)
+        .finish()
+        .unwrap();
+    let status = out.column(&col_name).unwrap();
+    assert!(matches!(status.dtype(), DataType::Categorical(_, _)));
+    // Unlabelled values read as their number, as with value_labels_as_strings.
+    let text = status.cast(&DataType::String).unwrap();
+    let vals: Vec<Option<&str>> = text.str().unwrap().into_iter().collect();
+    assert_eq!(vals, vec![Some("two"), Some("one"), Some("4"), Some("two")]);
+
+    let opts = ScanOptions {
+        value_labels_as_categorical: Some(true),
+        ..Default::default()
+    };
+    let mut lf = readstat_scan(&path, Some(opts), None).unwrap();
+    let schema = lf.collect_schema().unwrap();
+    assert_eq!(schema.get(col_name.as_str()), Some(status.dtype()));
+
+    let _ = fs::remove_file(&path);
+}
+
+#[test]
+fn test_spss_categorical_keeps_unlabelled_values_across_batches() {
+    let n = 5_000i32;
+    let status: Vec<Option<f64>> = (0..n)
+        .map(|i| (i % 11 != 0).then_some((i % 7) as f64 + if i % 5 == 0 { 0.5 } else { 0.0 }))
+        .collect();
+    let df = DataFrame::new_infer_height(vec![Series::new("status".into(), &status).into_column()])
+        .unwrap();
+    let mut map: SpssValueLabelMap = HashMap::new();
+    map.insert(SpssValueLabelKey::from_f64(1.0), "one".to_string());
+    map.insert(SpssValueLabelKey::from_f64(2.0), "two".to_string());
+    let mut labels: SpssValueLabels = HashMap::new();
+    labels.insert("status".to_string(), map);
+    let path = temp_path("spss_labels_categorical_batches", "sav");
+    SpssWriter::new(&path)
+        .with_value_labels(labels)
+        .write_df(&df)
+        .unwrap();
+
+    let opts = |as_categorical| ScanOptions {
+        threads: Some(2),
+        preserve_order: Some(true),
+        value_labels_as_strings: Some(true),
+        value_labels_as_categorical: Some(as_categorical),
+        ..Default::default()
+    };
+    let col_name = SpssReader::open(&path).unwrap().metadata().variables[0]
+        .name
+        .clone();
+    let batches = readstat_batch_iter(&path, Some(opts(true)), None, None, None, Some(700))
+        .unwrap()
+        .collect::<PolarsResult<Vec<_>>>()
+        .unwrap();
+    assert!(batches.len() > 1);
+    let mut text = Vec::new();
+    for batch in &batches {
+        let status = batch.column(&col_name).unwrap();
+        assert!(matches!(status.dtype(), DataType::Categorical(_, _)));
+        let status = status.cast(&DataType::String).unwrap();
+        let status = status.str().unwrap();
+        text.extend(status.into_iter().map(|v| v.map(str::to_string)));
+    }
+
+    let strings = readstat_scan(&path, Some(opts(false)), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    let expected: Vec<Option<String>> = strings
+        .column(&col_name)
+        .unwrap()
+        .str()
+        .unwrap()
+        .into_iter()
+        .map(|v| v.map(str::to_string))
+        .collect();
+    assert_eq!(text, expected);
+    assert_eq!(text[3].as_deref(), Some("3"));
+    assert_eq!(text[5].as_deref(), Some("5.5"));
+    assert_eq!(text[0], None);
+
+    let _ = fs::remove_file(&path);
+}
@@ -71,3 +71,92 @@ fn test_strl_with_null_bytes_roundtrip() {
 
     let _ = fs::remove_file(&path);
 }
+
+/// strLs are fetched per cell, so offsets, projections and the mmap backend must
+/// all resolve the same (v, o) references as a full read.
+#[test]
+fn test_strl_projected_and_offset_reads() {
+    let values: Vec<String> = (0..40)
+        .map(|i| format!("{i}:{}", "x".repeat(2100 + (i % 3))))
+        .collect();
+    let ids: Vec<i32> = (0..40).collect();
+    let df = DataFrame::new_infer_height(vec![
+        Series::new("id".into(), &ids).into_column(),
+        Series::new("long_str".into(), &values).into_column(),
+    ])
+    .unwrap();
+
+    let path = temp_path("stata_strl_projected", "dta");
+    StataWriter::new(&path).write_df(&df).unwrap();
+    let reader = StataReader::open(&path).unwrap();
+
+    let full = reader.read().finish().unwrap();
+    assert!(full.equals_missing(&df));
+
+    for use_mmap in [false, true] {
+        let got = reader
+            .read()
+            .with_columns(vec!["long_str".to_string()])
+            .with_offset(7)
+            .with_limit(20)
+            .use_mmap(use_mmap)
+            .finish()
+            .unwrap();
+        let expected = df.select(["long_str"]).unwrap().slice(7, 20);
+        assert!(got.equals_missing(&expected), "use_mmap={use_mmap}");
+    }
+
+    let ids_only = reader
+        .read()
+        .with_columns(vec!["id".to_string()])
+        .finish()
+        .unwrap();
+    assert!(ids_only.equals_missing(&df.select(["id"]).unwrap()));
+
+    let _ = fs::remove_file(&path);
+}
+
+/// Without a mapping strLs are read through read-ahead windows; values spread over
+/// several windows, two strL columns and a value larger than a window must all
+/// come back intact.
+#[test]
+fn test_strl_windowed_reads_match_mmap() {
+    let n = 600;
+    let first: Vec<String> = (0..n)
+        .map(|i| match i {
+            300 => "w".repeat(400_000),
+            _ => format!("{i}:{}", "a".repeat(2050 + (i % 7))),
+        })
+        .collect();
+    let second: Vec<String> = (0..n)
+        .map(|i| format!("{}:{i}", "b".repeat(2200 + (i % 5))))
+        .collect();
+    let df = DataFrame::new_infer_height(vec![
+        Series::new("first".into(), &first).into_column(),
+        Series::new("second".into(), &second).into_column(),
+    ])
+    .unwrap();
+
+    let path = temp_path("stata_strl_windowed", "dta");
+    StataWriter::new(&path).write_df(&df).unwrap();
+    let reader = StataReader::open(&path).unwrap();
+
+    for (offset, limit) in [(0, n), (250, 100), (590, 10)] {
+        let expected = df.slice(offset as i64, limit);
+        for use_mmap in [false, true] {
+            let got = reader
+                .read()
+                .with_offset(offset)
+                .with_limit(limit)
+                .use_mmap(use_mmap)
+                .finish()
+                .unwrap();
+            assert!(
+                got.equals_missing(&expected),
+                "offset={offset} use_mmap={use_mmap}"
+            );
+        }
+    }
+
+    let _ = fs::remove_file(&path);
+}
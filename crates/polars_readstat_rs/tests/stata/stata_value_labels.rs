@@ -1,6 +1,7 @@
 use polars::prelude::*;
 use polars_readstat_rs::{
-    stata, StataReader, StataWriter, ValueLabelMap, ValueLabels, VariableLabels,
+    readstat_batch_iter, readstat_scan, stata, ScanOptions, StataReader, StataWriter,
+    ValueLabelMap, ValueLabels, VariableLabels,
 };
 use serde_json::Value;
 use std::collections::{BTreeMap, HashMap};
@@ -88,3 +89,109 @@ fn test_stata_value_labels_roundtrip() {
 
     let _ = fs::remove_file(&path);
 }
+
+#[test]
+fn test_stata_value_labels_as_categorical() {
+    let df = DataFrame::new_infer_height(vec![
+        Series::new("status".into(), &[2i32, 1, 4, 2]).into_column()
+    ])
+    .unwrap();
+
+    let mut mapping: ValueLabelMap = BTreeMap::new();
+    mapping.insert(1, "one".to_string());
+    mapping.insert(2, "two".to_string());
+    let mut labels: ValueLabels = HashMap::new();
+    labels.insert("status".to_string(), mapping);
+
+    let path = temp_path("stata_value_labels_categorical", "dta");
+    StataWriter::new(&path)
+        .with_value_labels(labels)
+        .write_df(&df)
+        .unwrap();
+
+    let reader = StataReader::open(&path).unwrap();
+    let out = reader
+        .read()
+        .value_labels_as_categorical(true)
+        .finish()
+        .unwrap();
+    let status = out.column("status").unwrap();
+    assert!(matches!(status.dtype(), DataType::Categorical(_, _)));
+    // Unlabelled values read as their number, as with value_labels_as_strings.
+    let text = status.cast(&DataType::String).unwrap();
+    let values: Vec<Option<&str>> = text.str().unwrap().into_iter().collect();
+    assert_eq!(values, [Some("two"), Some("one"), Some("4"), Some("two")]);
+
+    let opts = ScanOptions {
+        value_labels_as_categorical: Some(true),
+        ..Default::default()
+    };
+    let mut lf = readstat_scan(&path, Some(opts), None).unwrap();
+    let schema = lf.collect_schema().unwrap();
+    assert_eq!(schema.get("status"), Some(status.dtype()));
+    let scanned = lf.collect().unwrap();
+    assert!(scanned
+        .column("status")
+        .unwrap()
+        .as_materialized_series()
+        .equals_missing(status.as_materialized_series()));
+
+    let _ = fs::remove_file(&path);
+}
+
+#[test]
+fn test_stata_categorical_keeps_unlabelled_values_across_batches() {
+    let n = 5_000i32;
+    let status: Vec<Option<i32>> = (0..n).map(|i| (i % 11 != 0).then_some(i % 7)).collect();
+    let df = DataFrame::new_infer_height(vec![Series::new("status".into(), &status).into_column()])
+        .unwrap();
+    let mut mapping: ValueLabelMap = BTreeMap::new();
+    mapping.insert(1, "one".to_string());
+    mapping.insert(2, "two".to_string());
+    let mut labels: ValueLabels = HashMap::new();
+    labels.insert("status".to_string(), mapping);
+    let path = temp_path("stata_value_labels_categorical_batches", "dta");
+    StataWriter::new(&path)
+        .with_value_labels(labels)
+        .write_df(&df)
+        .unwrap();
+
+    let opts = |as_categorical| ScanOptions {
+        threads: Some(2),
+        preserve_order: Some(true),
+        value_labels_as_strings: Some(true),
+        value_labels_as_categorical: Some(as_categorical),
+        ..Default::default()
+    };
+    let batches = readstat_batch_iter(&path, Some(opts(true)), None, None, None, Some(700))
+        .unwrap()
+        .collect::<PolarsResult<Vec<_>>>()
+        .unwrap();
+    assert!(batches.len() > 1);
+    let mut text = Vec::new();
+    for batch in &batches {
+        let status = batch.column("status").unwrap();
+        assert!(matches!(status.dtype(), DataType::Categorical(_, _)));
+        let status = status.cast(&DataType::String).unwrap();
+        let status = status.str().unwrap();
+        text.extend(status.into_iter().map(|v| v.map(str::to_string)));
+    }
+
+    let strings = readstat_scan(&path, Some(opts(false)), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    let expected: Vec<Option<String>> = strings
+        .column("status")
+        .unwrap()
+        .str()
+        .unwrap()
+        .into_iter()
+        .map(|v| v.map(str::to_string))
+        .collect();
+    assert_eq!(text, expected);
+    assert_eq!(text[3].as_deref(), Some("3"));
+    assert_eq!(text[0], None);
+
+    let _ = fs::remove_file(&path);
+}
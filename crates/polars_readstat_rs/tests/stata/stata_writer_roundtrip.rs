@@ -248,10 +248,20 @@ fn test_stata_streaming_batches_patch_header_and_map() {
 }
 
 #[test]
-fn test_stata_streaming_batches_rejects_strl_without_prepass() {
+fn test_stata_streaming_batches_with_strl_match_write_df() {
+    let long = "x".repeat(3_000);
+    let n = 10_000usize;
+    let ids: Vec<i32> = (0..n as i32).collect();
+    let txt: Vec<Option<String>> = (0..n)
+        .map(|i| match i % 5 {
+            0 => None,
+            1 => Some(format!("{long}{i}")),
+            _ => Some(format!("row {i}")),
+        })
+        .collect();
     let original = DataFrame::new_infer_height(vec![
-        Series::new("id".into(), &[1i64, 2]).into_column(),
-        Series::new("txt".into(), &["a", "b"]).into_column(),
+        Series::new("id".into(), &ids).into_column(),
+        Series::new("txt".into(), &txt).into_column(),
     ])
     .unwrap();
     let mut schema = schema_from_df(&original);
@@ -260,13 +270,37 @@ fn test_stata_streaming_batches_rejects_strl_without_prepass() {
             col.string_width_bytes = Some(3_000);
         }
     }
+    let batches = vec![
+        original.slice(0, 4_500),
+        original.slice(4_500, 1),
+        original.slice(4_501, 5_499),
+    ];
 
-    let out_path = temp_dta_path();
-    let err = StataWriter::new(&out_path)
-        .write_batches_streaming(vec![original], schema)
-        .unwrap_err();
-    assert!(err.to_string().contains("strL"), "unexpected error: {err}");
-    let _ = std::fs::remove_file(&out_path);
+    let streamed_path = temp_dta_path();
+    StataWriter::new(&streamed_path)
+        .with_n_threads(3)
+        .write_batches_streaming(batches, schema)
+        .unwrap();
+    let df_path = temp_dta_path();
+    StataWriter::new(&df_path).write_df(&original).unwrap();
+
+    // The strLs were spilled next to the output and the spill file is gone.
+    let spill_prefix = format!(
+        "{}.strls",
+        streamed_path.file_name().unwrap().to_string_lossy()
+    );
+    let leftover = std::fs::read_dir(streamed_path.parent().unwrap())
+        .unwrap()
+        .filter_map(|e| e.ok())
+        .any(|e| e.file_name().to_string_lossy().starts_with(&spill_prefix));
+    assert!(!leftover);
+
+    let read = |path: &PathBuf| StataReader::open(path).unwrap().read().finish().unwrap();
+    let streamed = read(&streamed_path);
+    assert_df_equal(&original, &streamed).unwrap();
+    assert_df_equal(&read(&df_path), &streamed).unwrap();
+    let _ = std::fs::remove_file(&streamed_path);
+    let _ = std::fs::remove_file(&df_path);
 }
 
 fn report_out_of_range(df: &DataFrame) {
@@ -0,0 +1,154 @@
+use polars::prelude::*;
+use polars_readstat_rs::{
+    readstat_scan, readstat_sink_ipc, readstat_sink_parquet, ScanOptions, StataWriter,
+    TranscodeOptions, ValueLabelMap, ValueLabels, VariableLabels,
+};
+use std::collections::{BTreeMap, HashMap};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+fn temp_path(prefix: &str, ext: &str) -> std::path::PathBuf {
+    let mut path = std::env::temp_dir();
+    let nanos = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap()
+        .as_nanos();
+    let pid = std::process::id();
+    path.push(format!("{prefix}_{pid}_{nanos}.{ext}"));
+    path
+}
+
+fn write_labelled_file(n: i32) -> std::path::PathBuf {
+    let status: Vec<i32> = (0..n).map(|i| i % 3 + 1).collect();
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| (i % 11 != 0).then(|| i as f64 / 4.0))
+        .collect();
+    let name: Vec<String> = (0..n).map(|i| format!("row {i}")).collect();
+    let df = df!("status" => status, "value" => value, "name" => name).unwrap();
+
+    let mut mapping: ValueLabelMap = BTreeMap::new();
+    mapping.insert(1, "one".to_string());
+    mapping.insert(2, "two".to_string());
+    mapping.insert(3, "three".to_string());
+    let mut labels: ValueLabels = HashMap::new();
+    labels.insert("status".to_string(), mapping);
+
+    let path = temp_path("transcode_src", "dta");
+    StataWriter::new(&path)
+        .with_value_labels(labels)
+        .with_variable_labels(VariableLabels::from([(
+            "value".to_string(),
+            "Measured value".to_string(),
+        )]))
+        .write_df(&df)
+        .unwrap();
+    path
+}
+
+fn scan_opts() -> ScanOptions {
+    ScanOptions {
+        threads: Some(2),
+        preserve_order: Some(true),
+        ..Default::default()
+    }
+}
+
+#[test]
+fn test_sink_parquet_matches_scan() {
+    let src = write_labelled_file(25_000);
+    let out = temp_path("transcode_out", "parquet");
+    let sink = TranscodeOptions {
+        row_group_size: Some(4096),
+        carry_labels: true,
+        ..Default::default()
+    };
+    let rows =
+        readstat_sink_parquet(&src, &out, Some(scan_opts()), None, None, None, sink).unwrap();
+    assert_eq!(rows, 25_000);
+
+    let expected = readstat_scan(&src, Some(scan_opts()), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    let written = LazyFrame::scan_parquet(out.to_str().unwrap().into(), Default::default())
+        .unwrap()
+        .collect()
+        .unwrap();
+    assert!(expected.equals_missing(&written));
+
+    // Labels travel as JSON in the footer's key-value metadata.
+    let bytes = std::fs::read(&out).unwrap();
+    let has = |needle: &str| bytes.windows(needle.len()).any(|w| w == needle.as_bytes());
+    assert!(has("readstat:variable_labels"));
+    assert!(has("Measured value"));
+    assert!(has("readstat:value_labels"));
+    assert!(has("three"));
+
+    let _ = std::fs::remove_file(&src);
+    let _ = std::fs::remove_file(&out);
+}
+
+#[test]
+fn test_sink_ipc_projects_and_limits() {
+    let src = write_labelled_file(5000);
+    let out = temp_path("transcode_out", "arrow");
+    let rows = readstat_sink_ipc(
+        &src,
+        &out,
+        Some(scan_opts()),
+        None,
+        Some(vec!["name".to_string(), "status".to_string()]),
+        Some(1234),
+        TranscodeOptions {
+            row_group_size: Some(500),
+            ..Default::default()
+        },
+    )
+    .unwrap();
+    assert_eq!(rows, 1234);
+
+    let expected = readstat_scan(&src, Some(scan_opts()), None)
+        .unwrap()
+        .select([col("status"), col("name")])
+        .limit(1234)
+        .collect()
+        .unwrap();
+    let written = IpcReader::new(std::fs::File::open(&out).unwrap())
+        .finish()
+        .unwrap();
+    let written = written.select(["status", "name"]).unwrap();
+    assert!(expected.equals_missing(&written));
+
+    let _ = std::fs::remove_file(&src);
+    let _ = std::fs::remove_file(&out);
+}
+
+#[test]
+fn test_sink_rejects_compress_and_keeps_empty_schema() {
+    let src = write_labelled_file(100);
+    let out = temp_path("transcode_out", "parquet");
+    let mut opts = scan_opts();
+    opts.compress_opts.enabled = true;
+    let err = readstat_sink_parquet(&src, &out, Some(opts), None, None, None, Default::default());
+    assert!(err.is_err());
+
+    let rows = readstat_sink_parquet(
+        &src,
+        &out,
+        Some(scan_opts()),
+        None,
+        None,
+        Some(0),
+        Default::default(),
+    )
+    .unwrap();
+    assert_eq!(rows, 0);
+    let written = LazyFrame::scan_parquet(out.to_str().unwrap().into(), Default::default())
+        .unwrap()
+        .collect()
+        .unwrap();
+    assert_eq!(written.height(), 0);
+    assert_eq!(written.width(), 3);
+
+    let _ = std::fs::remove_file(&src);
+    let _ = std::fs::remove_file(&out);
+}
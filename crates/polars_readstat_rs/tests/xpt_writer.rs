@@ -0,0 +1,120 @@
+use polars::prelude::*;
+use polars_readstat_rs::{readstat_scan, ScanOptions, XptStorageWidths, XptWriter};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+fn temp_path(prefix: &str, ext: &str) -> std::path::PathBuf {
+    let mut path = std::env::temp_dir();
+    let nanos = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap()
+        .as_nanos();
+    let pid = std::process::id();
+    path.push(format!("{prefix}_{pid}_{nanos}.{ext}"));
+    path
+}
+
+fn read_back(path: &std::path::Path) -> DataFrame {
+    readstat_scan(path, None, None).unwrap().collect().unwrap()
+}
+
+#[test]
+fn test_xpt_streaming_matches_write_df() {
+    let n = 5_000usize;
+    let id: Vec<i32> = (0..n as i32).collect();
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| {
+            if i % 9 == 0 {
+                None
+            } else {
+                Some(i as f64 * 0.25)
+            }
+        })
+        .collect();
+    let code: Vec<Option<String>> = (0..n)
+        .map(|i| (i % 4 != 0).then(|| "x".repeat(i % 12)))
+        .collect();
+    let df = df!("id" => id, "value" => value, "code" => code).unwrap();
+
+    let whole_path = temp_path("xpt_whole", "xpt");
+    XptWriter::new(&whole_path).write_df(&df).unwrap();
+    let expected = read_back(&whole_path);
+
+    for version in [5u8, 8] {
+        let stream_path = temp_path("xpt_stream", "xpt");
+        let batches = (0..n)
+            .step_by(1_234)
+            .map(|start| df.slice(start as i64, 1_234));
+        XptWriter::new(&stream_path)
+            .with_version(version)
+            .with_storage_widths(XptStorageWidths::from([("code".to_string(), 11)]))
+            .write_batches_streaming(batches, df.schema())
+            .unwrap();
+        let got = read_back(&stream_path);
+        assert_eq!(got.height(), expected.height());
+        for name in ["id", "value", "code"] {
+            assert!(
+                got.column(name)
+                    .unwrap()
+                    .as_materialized_series()
+                    .equals_missing(expected.column(name).unwrap().as_materialized_series()),
+                "v{version} {name}"
+            );
+        }
+        let _ = std::fs::remove_file(&stream_path);
+    }
+
+    // Character widths are required up front, and values may not exceed them.
+    let path = temp_path("xpt_stream_width", "xpt");
+    assert!(XptWriter::new(&path)
+        .write_batches_streaming([df.clone()], df.schema())
+        .is_err());
+    assert!(XptWriter::new(&path)
+        .with_storage_widths(XptStorageWidths::from([("code".to_string(), 4)]))
+        .write_batches_streaming([df.clone()], df.schema())
+        .is_err());
+    let _ = std::fs::remove_file(&path);
+    let _ = std::fs::remove_file(&whole_path);
+}
+
+#[test]
+fn test_xpt_parallel_and_projected_reads_match_serial() {
+    let n = 20_001usize;
+    let id: Vec<i32> = (0..n as i32).collect();
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| (i % 7 != 0).then(|| i as f64 / 3.0 - 1_000.0))
+        .collect();
+    let code: Vec<Option<String>> = (0..n)
+        .map(|i| (i % 5 != 0).then(|| format!("c{}", i % 97)))
+        .collect();
+    let df = df!("id" => id, "value" => value, "code" => code)
+        .unwrap()
+        .lazy()
+        .with_column(col("id").cast(DataType::Date).alias("day"))
+        .collect()
+        .unwrap();
+    let path = temp_path("xpt_parallel", "xpt");
+    // 28-byte rows: the last record is padded with more than a blank row.
+    XptWriter::new(&path)
+        .with_storage_widths(XptStorageWidths::from([("code".to_string(), 4)]))
+        .write_df(&df)
+        .unwrap();
+
+    let read = |threads: usize| {
+        let opts = ScanOptions {
+            threads: Some(threads),
+            chunk_size: Some(777),
+            preserve_order: Some(true),
+            ..Default::default()
+        };
+        readstat_scan(&path, Some(opts), None).unwrap()
+    };
+    let serial = read(1).collect().unwrap();
+    assert_eq!(serial.height(), n);
+    let parallel = read(4).collect().unwrap();
+    assert!(parallel.equals_missing(&serial));
+
+    // Fields are located by their offset in the full row, not in the projection.
+    let projected = read(4).select([col("day"), col("code")]).collect().unwrap();
+    assert!(projected.equals_missing(&serial.select(["day", "code"]).unwrap()));
+    let _ = std::fs::remove_file(&path);
+}
@@ -0,0 +1,161 @@
+use polars::prelude::*;
+use polars_readstat_rs::{
+    readstat_build_zone_map, readstat_scan, FilterOp, FilterValue, RowFilter, ScanOptions,
+    StataWriter, ZoneMap,
+};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+fn temp_path(prefix: &str, ext: &str) -> std::path::PathBuf {
+    let mut path = std::env::temp_dir();
+    let nanos = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap()
+        .as_nanos();
+    let pid = std::process::id();
+    path.push(format!("{prefix}_{pid}_{nanos}.{ext}"));
+    path
+}
+
+fn scan_opts() -> ScanOptions {
+    ScanOptions {
+        threads: Some(2),
+        preserve_order: Some(true),
+        ..Default::default()
+    }
+}
+
+fn write_sorted_file() -> (std::path::PathBuf, DataFrame) {
+    let n = 10_000i32;
+    let year: Vec<i32> = (0..n).collect();
+    let state: Vec<&str> = (0..n)
+        .map(|i| if i < n / 2 { "AK" } else { "WY" })
+        .collect();
+    let value: Vec<Option<f64>> = (0..n)
+        .map(|i| {
+            if i % 7 == 0 {
+                None
+            } else {
+                Some(i as f64 / 2.0)
+            }
+        })
+        .collect();
+    let df = df!("year" => year, "state" => state, "value" => value).unwrap();
+    let path = temp_path("zone_map", "dta");
+    StataWriter::new(&path).write_df(&df).unwrap();
+    (path, df)
+}
+
+#[test]
+fn test_zone_map_ranges_and_filtered_scan() {
+    let (path, df) = write_sorted_file();
+    let zones = readstat_build_zone_map(&path, Some(scan_opts()), None, Some(1000)).unwrap();
+    assert_eq!(zones.zone_count(), 10);
+    assert_eq!(zones.row_count(), df.height() as u64);
+
+    let late = RowFilter::compare("year", FilterOp::GtEq, FilterValue::Num(9500.0));
+    assert_eq!(zones.candidate_ranges(&late), vec![(9000, 1000)]);
+    let coast = RowFilter::compare("state", FilterOp::Eq, FilterValue::Str("WY".into()));
+    assert_eq!(zones.candidate_ranges(&coast), vec![(5000, 5000)]);
+    let none = RowFilter::compare("year", FilterOp::Lt, FilterValue::Num(0.0));
+    assert!(zones.candidate_ranges(&none).is_empty());
+
+    let reloaded = ZoneMap::load(&ZoneMap::sidecar_path(&path)).unwrap();
+    assert_eq!(reloaded.candidate_ranges(&late), vec![(9000, 1000)]);
+
+    let opts = ScanOptions {
+        row_index_name: Some("row".to_string()),
+        ..scan_opts()
+    };
+    let got = readstat_scan(&path, Some(opts), None)
+        .unwrap()
+        .filter(col("year").gt_eq(lit(9500)).and(col("value").is_not_null()))
+        .select([col("row"), col("value")])
+        .collect()
+        .unwrap();
+    let expected = df
+        .clone()
+        .lazy()
+        .with_row_index("row", None)
+        .filter(col("year").gt_eq(lit(9500)).and(col("value").is_not_null()))
+        .select([col("row"), col("value")])
+        .collect()
+        .unwrap();
+    assert_eq!(got.height(), expected.height());
+    for name in ["row", "value"] {
+        let g = got.column(name).unwrap();
+        let e = expected.column(name).unwrap().cast(g.dtype()).unwrap();
+        assert!(
+            g.as_materialized_series()
+                .equals_missing(e.as_materialized_series()),
+            "{name}"
+        );
+    }
+
+    // Every zone skipped: an empty frame with the projected schema.
+    let empty = readstat_scan(&path, Some(scan_opts()), None)
+        .unwrap()
+        .filter(col("year").lt(lit(0)))
+        .select([col("state")])
+        .collect()
+        .unwrap();
+    assert_eq!(empty.height(), 0);
+    assert_eq!(empty.get_column_names(), vec!["state"]);
+
+    let _ = std::fs::remove_file(ZoneMap::sidecar_path(&path));
+    let _ = std::fs::remove_file(&path);
+}
+
+#[test]
+fn test_zone_map_ignored_once_file_changes() {
+    let (path, _) = write_sorted_file();
+    readstat_build_zone_map(&path, Some(scan_opts()), None, Some(1000)).unwrap();
+    let sidecar = ZoneMap::sidecar_path(&path);
+
+    // Rewrite with different contents; the stale sidecar must not drop rows.
+    let df =
+        df!("year" => [9600i32, 1, 2], "state" => ["AK", "AK", "AK"], "value" => [1.0, 2.0, 3.0])
+            .unwrap();
+    StataWriter::new(&path).write_df(&df).unwrap();
+    let zones = ZoneMap::load(&sidecar).unwrap();
+    assert!(!zones.matches(&path, &scan_opts()));
+
+    let got = readstat_scan(&path, Some(scan_opts()), None)
+        .unwrap()
+        .filter(col("year").gt_eq(lit(9500)))
+        .collect()
+        .unwrap();
+    assert_eq!(got.height(), 1);
+
+    let _ = std::fs::remove_file(&sidecar);
+    let _ = std::fs::remove_file(&path);
+}
+
+#[test]
+fn test_unfiltered_scan_with_zone_map_is_one_chunk() {
+    let (path, df) = write_sorted_file();
+    readstat_build_zone_map(&path, Some(scan_opts()), None, Some(1000)).unwrap();
+
+    // Small batches, so a read assembled by stacking them would have many chunks.
+    let opts = ScanOptions {
+        chunk_size: Some(500),
+        ..scan_opts()
+    };
+    let got = readstat_scan(&path, Some(opts), None)
+        .unwrap()
+        .collect()
+        .unwrap();
+    assert_eq!(got.height(), df.height());
+    for col in got.columns() {
+        assert_eq!(col.as_materialized_series().n_chunks(), 1, "{}", col.name());
+        let expected = df.column(col.name()).unwrap().cast(col.dtype()).unwrap();
+        assert!(
+            col.as_materialized_series()
+                .equals_missing(expected.as_materialized_series()),
+            "{}",
+            col.name()
+        );
+    }
+
+    let _ = std::fs::remove_file(ZoneMap::sidecar_path(&path));
+    let _ = std::fs::remove_file(&path);
+}
@@ -6,7 +6,10 @@ from dataclasses import dataclass
 from polars.io.plugins import register_io_source
 from polars_readstat.polars_readstat_bindings import (
     PyPolarsReadstat,
+    ReadProfiler,
     sink_stata,
+    sink_xpt,
+    sink_sas_csv_import,
     write_sas_csv_import as _write_sas_csv_import_rs,
     write_stata as _write_stata_rs,
     write_spss as _write_spss_rs,
@@ -16,9 +19,10 @@ from polars_readstat.polars_readstat_bindings import (
     write_xpt_from_df_rs as _write_xpt_from_df_rs,
     write_por as _write_por_rs,
     write_por_from_df_rs as _write_por_from_df_rs,
-    scan_por_rs as _scan_por_rs,
     por_metadata_json_rs as _por_metadata_json_rs,
     read_sas7bcat_rs as _read_sas7bcat_rs,
+    sink_readstat_rs as _sink_readstat_rs,
+    build_sas_page_index_rs as _build_sas_page_index_rs,
 )
 import warnings
 
@@ -133,12 +137,14 @@ class ScanReadstat:
         )
 
     def _get_schema(self) -> None:
-        if self.path.lower().endswith(".por"):
-            self._schema, self._metadata = _por_schema_and_metadata(self.path)
-            return
         src = self._make_src()
+        # The schema always comes from the native source so it reflects the
+        # compress and row index options its batches apply.
         self._schema = src.schema()
-        self._metadata = src.get_metadata()
+        if self.path.lower().endswith(".por"):
+            self._metadata = _por_metadata(self.path)
+        else:
+            self._metadata = src.get_metadata()
 
     def _validation_check(self, path: str) -> None:
         valid_files = [".sas7bdat", ".dta", ".sav", ".zsav", ".xpt", ".xpt5", ".xpt8", ".por"]
@@ -383,6 +389,18 @@ def _normalize_informative_null_opts(
     )
 
 
+def build_sas_page_index(path: Any) -> None:
+    """
+    Write a page index for a ``.sas7bdat`` file next to it (``<file>.pidx``).
+
+    The index maps rows to pages, so later reads that start past the first row
+    (``slice``, ``n_rows`` windows, parallel starts) seek straight to the pages
+    they need instead of walking the file from the first page. It is picked up automatically and
+    ignored once the data file changes.
+    """
+    _build_sas_page_index_rs(str(path))
+
+
 def read_sas7bcat(path: Any) -> dict[str, dict[float | str, str]]:
     """
     Read a SAS format catalog (``.sas7bcat``) and return its value-label mappings.
@@ -402,38 +420,9 @@ def read_sas7bcat(path: Any) -> dict[str, dict[float | str, str]]:
     return _read_sas7bcat_rs(str(path))
 
 
-_POR_FORMAT_CLASS: dict[int, str] = {
-    20: "Date", 23: "Date", 24: "Date", 38: "Date", 39: "Date",
-    21: "Time", 25: "Time",
-    22: "DateTime", 41: "DateTime",
-}
-
-def _por_dtype_from_var(var: dict) -> pl.PolarsDataType:
-    if var.get("type") == "Str":
-        return pl.String
-    ft = int(var.get("format_type", 0))
-    # Some SPSS writers shift date/time codes by 82
-    if ft > 82:
-        ft -= 82
-    cls = _POR_FORMAT_CLASS.get(ft)
-    if cls == "Date":
-        return pl.Date
-    if cls == "DateTime":
-        return pl.Datetime("ms")
-    if cls == "Time":
-        return pl.Time
-    return pl.Float64
-
-
-def _por_schema_and_metadata(path: str) -> tuple[pl.Schema, dict]:
+def _por_metadata(path: str) -> dict:
     import json
-    raw = _por_metadata_json_rs(path)
-    meta = json.loads(raw)
-    schema = pl.Schema({
-        v["name"]: _por_dtype_from_var(v)
-        for v in meta.get("variables", [])
-    })
-    return schema, meta
+    return json.loads(_por_metadata_json_rs(path))
 
 
 def _normalize_catalog(
@@ -507,6 +496,7 @@ def scan_readstat(
     batch_size: int | None = None,
     informative_nulls: "InformativeNullOpts | dict | None" = None,
     catalog: "CatalogInput" = None,
+    profiler: ReadProfiler | None = None,
 ) -> pl.LazyFrame:
     """
     Scans a ReadStat file (SAS, SPSS, Stata) into a Polars LazyFrame.
@@ -538,6 +528,9 @@ def scan_readstat(
         when the schema inferred from the header differs from data in the file body.
     batch_size : int, optional
         Number of rows per batch used by the scan source.
+    profiler : ReadProfiler, optional
+        Collects per-stage timings and byte/row counts for every read of this
+        scan; call ``profiler.report()`` after collecting.
     """
     path = str(path)
     compress = _normalize_compress_opts(compress)
@@ -545,9 +538,6 @@ def scan_readstat(
     preserve_order_opts = _normalize_preserve_order_opts(preserve_order)
     catalog = _normalize_catalog(catalog)
 
-    if path.lower().endswith(".por"):
-        return _scan_por_rs(path).lazy()
-
     if reader is None:
         reader = ScanReadstat(
             path=path,
@@ -650,9 +640,14 @@ def scan_readstat(
             compress=compress.to_dict() if compress is not None else None,
             informative_nulls=informative_nulls.to_dict() if informative_nulls is not None else None,
             row_index_name=row_index_name,
+            profiler=profiler,
         )
         if with_columns is not None:
             src.set_with_columns(with_columns)
+        if predicate is not None and "dynamic_pred" not in str(predicate):
+            # Let the reader skip rows it can rule out while decoding; the
+            # filter below still applies the full predicate.
+            src.set_predicate(predicate)
 
         while (out := src.next()) is not None:
             if predicate is not None and "dynamic_pred" not in str(predicate):
@@ -688,6 +683,7 @@ def read_readstat(
     schema_overrides: Dict[Any, Any] | None = None,
     batch_size: int | None = None,
     informative_nulls: "InformativeNullOpts | dict | None" = None,
+    profiler: ReadProfiler | None = None,
 ) -> pl.DataFrame:
     lf = scan_readstat(
         path,
@@ -699,12 +695,132 @@ def read_readstat(
         schema_overrides=schema_overrides,
         batch_size=batch_size,
         informative_nulls=informative_nulls,
+        profiler=profiler,
     )
     if columns is not None:
         lf = lf.select(columns)
     return lf.collect()
 
 
+def sink_parquet(
+    path: Any,
+    output: Any,
+    *,
+    threads: int | None = None,
+    missing_string_as_null: bool = False,
+    value_labels_as_strings: bool = False,
+    preserve_order: bool = True,
+    columns: list[str] | None = None,
+    n_rows: int | None = None,
+    row_group_size: int | None = None,
+    compression: str | None = None,
+    carry_labels: bool = False,
+    memory_budget: int | None = None,
+    informative_nulls: "InformativeNullOpts | dict | None" = None,
+    row_index_name: str | None = None,
+    profiler: ReadProfiler | None = None,
+) -> int:
+    """
+    Convert a ReadStat file (SAS, SPSS, Stata) to Parquet without loading it.
+
+    Batches are decoded on the reader's worker threads and written as they
+    arrive, so memory use is a few batches regardless of file size. Returns the
+    number of rows written.
+
+    Parameters
+    ----------
+    path : str or Path
+        Input file.
+    output : str or Path
+        Parquet file to write.
+    columns : list of str, optional
+        Columns to write (default: all).
+    n_rows : int, optional
+        Stop after this many rows.
+    row_group_size : int, optional
+        Rows per row group and per decoded batch (default 100,000).
+    compression : str, optional
+        ``"zstd"`` (default), ``"snappy"``, ``"lz4"``, ``"gzip"`` or
+        ``"uncompressed"``.
+    carry_labels : bool, optional
+        Store variable labels and value labels as JSON in the Parquet key-value
+        metadata (keys ``readstat:variable_labels`` and ``readstat:value_labels``).
+    memory_budget : int, optional
+        Upper bound in bytes on decoded data held at once; lowers the batch
+        (and row group) size when needed.
+
+    The remaining options are as for :func:`scan_readstat`.
+    """
+    return _sink_readstat(
+        path,
+        output,
+        "parquet",
+        threads=threads,
+        missing_string_as_null=missing_string_as_null,
+        value_labels_as_strings=value_labels_as_strings,
+        preserve_order=preserve_order,
+        columns=columns,
+        n_rows=n_rows,
+        row_group_size=row_group_size,
+        compression=compression,
+        carry_labels=carry_labels,
+        memory_budget=memory_budget,
+        informative_nulls=informative_nulls,
+        row_index_name=row_index_name,
+        profiler=profiler,
+    )
+
+
+def sink_ipc(
+    path: Any,
+    output: Any,
+    *,
+    threads: int | None = None,
+    missing_string_as_null: bool = False,
+    value_labels_as_strings: bool = False,
+    preserve_order: bool = True,
+    columns: list[str] | None = None,
+    n_rows: int | None = None,
+    row_group_size: int | None = None,
+    memory_budget: int | None = None,
+    informative_nulls: "InformativeNullOpts | dict | None" = None,
+    row_index_name: str | None = None,
+    profiler: ReadProfiler | None = None,
+) -> int:
+    """
+    Convert a ReadStat file (SAS, SPSS, Stata) to an Arrow IPC file without
+    loading it. ``row_group_size`` sets the rows per record batch; the other
+    options are as for :func:`sink_parquet`. Returns the number of rows written.
+    """
+    return _sink_readstat(
+        path,
+        output,
+        "ipc",
+        threads=threads,
+        missing_string_as_null=missing_string_as_null,
+        value_labels_as_strings=value_labels_as_strings,
+        preserve_order=preserve_order,
+        columns=columns,
+        n_rows=n_rows,
+        row_group_size=row_group_size,
+        memory_budget=memory_budget,
+        informative_nulls=informative_nulls,
+        row_index_name=row_index_name,
+        profiler=profiler,
+    )
+
+
+def _sink_readstat(path: Any, output: Any, file_type: str, **kwargs: Any) -> int:
+    informative_nulls = _normalize_informative_null_opts(kwargs.pop("informative_nulls"))
+    return _sink_readstat_rs(
+        str(path),
+        str(output),
+        file_type,
+        informative_nulls=informative_nulls.to_dict() if informative_nulls is not None else None,
+        **kwargs,
+    )
+
+
 def write_readstat(
     df: pl.DataFrame | pl.LazyFrame,
     path: Any,
@@ -0,0 +1,57 @@
+from __future__ import annotations
+
+import json
+from pathlib import Path
+
+import polars as pl
+import pytest
+
+import polars_readstat as _prs
+
+if not hasattr(_prs, "sink_parquet"):
+    pytest.skip("sink_parquet not available", allow_module_level=True)
+
+
+def _write_source(package_module, tmp_path: Path) -> Path:
+    df = pl.DataFrame(
+        {
+            "id": list(range(1000)),
+            "status": [i % 3 + 1 for i in range(1000)],
+            "name": [f"row {i}" for i in range(1000)],
+        }
+    )
+    path = tmp_path / "source.dta"
+    package_module.write_readstat(
+        df,
+        str(path),
+        value_labels={"status": {1: "one", 2: "two", 3: "three"}},
+        variable_labels={"name": "Row name"},
+    )
+    return path
+
+
+def test_sink_parquet_roundtrip_with_labels(package_module, tmp_path: Path) -> None:
+    src = _write_source(package_module, tmp_path)
+    out = tmp_path / "out.parquet"
+
+    rows = package_module.sink_parquet(src, out, row_group_size=128, carry_labels=True)
+
+    assert rows == 1000
+    expected = package_module.read_readstat(str(src), preserve_order=True)
+    written = pl.read_parquet(out)
+    assert written.equals(expected)
+    metadata = pl.read_parquet_metadata(out)
+    assert json.loads(metadata["readstat:variable_labels"]) == {"name": "Row name"}
+    assert "status" in json.loads(metadata["readstat:value_labels"])
+
+
+def test_sink_ipc_columns_and_limit(package_module, tmp_path: Path) -> None:
+    src = _write_source(package_module, tmp_path)
+    out = tmp_path / "out.arrow"
+
+    rows = package_module.sink_ipc(src, out, columns=["id", "name"], n_rows=300)
+
+    assert rows == 300
+    written = pl.read_ipc(out)
+    assert written["id"].to_list() == list(range(300))
+    assert written["name"].to_list()[:2] == ["row 0", "row 1"]
@@ -335,6 +335,35 @@ def test_por_write_roundtrip(tmp_path: Path) -> None:
     assert_frame_equal(rt_names.to_frame(), orig_names.to_frame(), check_dtypes=False)
 
 
+@pytest.mark.parametrize(
+    "scan_kwargs",
+    [
+        {"compress": True},
+        {"preserve_order": {"mode": "row_index", "row_index_name": "__row_idx"}},
+        {"compress": True, "preserve_order": {"mode": "sort", "row_index_name": "__row_idx"}},
+    ],
+)
+def test_por_scan_schema_matches_batches(tmp_path: Path, scan_kwargs: dict) -> None:
+    """The declared .por schema reflects compress and the row index column."""
+    df = pl.DataFrame({
+        "ID": [1.0, 2.0, 3.0, None],
+        "SCORE": [1.5, -2.25, 0.0, 100.0],
+        "NAME": ["Alice", "Bob", "Charlie", "Dan"],
+    })
+    out = tmp_path / "schema.por"
+    prs.write_por(df, str(out))
+
+    lf = prs.scan_readstat(str(out), **scan_kwargs)
+    collected = lf.collect()
+
+    assert lf.collect_schema() == collected.schema
+    if "compress" in scan_kwargs:
+        assert collected.schema["ID"] != pl.Float64
+    if scan_kwargs.get("preserve_order", {}).get("mode") == "row_index":
+        assert collected["__row_idx"].sort().to_list() == [0, 1, 2, 3]
+    assert collected.height == df.height
+
+
 def test_por_write_bad_extension(tmp_path: Path) -> None:
     """write_por rejects paths that don't end in .por."""
     df = pl.DataFrame({"x": [1.0]})
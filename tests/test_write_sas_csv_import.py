@@ -71,6 +71,22 @@ def test_write_sas_csv_import_outputs_bundle(
     assert "Numeric Label" in sas_text
 
 
+def test_sink_sas_csv_import_with_no_rows_writes_header_and_script(
+    package_module,
+    tmp_path: Path,
+) -> None:
+    lf = pl.LazyFrame({"num": [1, 2], "name": ["a", "bb"]}).filter(pl.col("num") > 5)
+    out_stem = tmp_path / "empty"
+
+    package_module.sink_sas_csv_import(lf, str(out_stem), dataset_name="demo")
+
+    csv_text = out_stem.with_suffix(".csv").read_text(encoding="utf-8")
+    assert csv_text.strip() == "num,name"
+    sas_text = out_stem.with_suffix(".sas").read_text(encoding="utf-8")
+    assert "data demo;" in sas_text
+    assert "length name $1;" in sas_text
+
+
 def test_write_readstat_sas_points_to_explicit_api(
     package_module,
     tmp_path: Path,